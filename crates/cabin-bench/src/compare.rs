@@ -0,0 +1,196 @@
+//! Sample statistics and baseline comparison.
+//!
+//! A benchmark changed when its mean moved by more than the noise
+//! threshold *and* the move is large next to the run-to-run spread:
+//! with at least two samples on both sides, the difference of means
+//! must exceed twice its standard error (roughly a 95% two-sided
+//! z-test).  Single-sample benchmarks have no spread to measure, so
+//! only the threshold applies to them.
+
+use serde::{Deserialize, Serialize};
+
+use crate::BenchResult;
+
+/// Default `--noise-threshold`, in percent of the baseline mean.
+pub const DEFAULT_NOISE_THRESHOLD: f64 = 5.0;
+
+/// Summary statistics over one benchmark's samples.
+#[derive(Debug, Clone, Copy, PartialEq, Serialize, Deserialize)]
+pub struct Stats {
+    /// Mean nanoseconds per iteration.
+    pub mean: f64,
+    /// Sample standard deviation (`0` for a single sample).
+    pub stddev: f64,
+    /// Number of samples.
+    pub samples: usize,
+}
+
+impl Stats {
+    /// Statistics over `samples`, or `None` when there are none.
+    pub fn of(samples: &[f64]) -> Option<Self> {
+        if samples.is_empty() {
+            return None;
+        }
+        let n = count_as_f64(samples.len());
+        let mean = samples.iter().sum::<f64>() / n;
+        let stddev = if samples.len() < 2 {
+            0.0
+        } else {
+            let squares: f64 = samples.iter().map(|s| (s - mean).powi(2)).sum();
+            (squares / (n - 1.0)).sqrt()
+        };
+        Some(Self {
+            mean,
+            stddev,
+            samples: samples.len(),
+        })
+    }
+
+    fn standard_error_squared(self) -> f64 {
+        self.stddev.powi(2) / count_as_f64(self.samples)
+    }
+}
+
+/// Sample counts are tiny; saturating at `u32::MAX` keeps the
+/// conversion lossless for every realistic run.
+fn count_as_f64(n: usize) -> f64 {
+    f64::from(u32::try_from(n).unwrap_or(u32::MAX))
+}
+
+/// How a benchmark moved against its baseline.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Verdict {
+    /// Slower beyond the noise threshold.
+    Regressed,
+    /// Faster beyond the noise threshold.
+    Improved,
+    /// Within noise, or not compared (no baseline given).
+    Unchanged,
+    /// Absent from the given baseline.
+    New,
+}
+
+/// One benchmark compared with its baseline.
+#[derive(Debug, Clone, PartialEq)]
+pub struct Comparison {
+    /// Current statistics.
+    pub current: Stats,
+    /// Baseline statistics; `None` without a baseline or for a new
+    /// benchmark.
+    pub baseline: Option<Stats>,
+    /// Relative change of the mean in percent (positive = slower).
+    pub change_percent: f64,
+    /// Classification under the noise threshold.
+    pub verdict: Verdict,
+}
+
+/// Compare `current` with the same-keyed entry of `baseline`.
+/// `noise_threshold` is in percent.  Without a baseline the result
+/// only carries `current`'s statistics.  Returns `None` when
+/// `current` carries no samples.
+pub fn compare(
+    current: &BenchResult,
+    baseline: Option<&[BenchResult]>,
+    noise_threshold: f64,
+) -> Option<Comparison> {
+    let stats = Stats::of(&current.samples)?;
+    let Some(baseline) = baseline else {
+        return Some(Comparison {
+            current: stats,
+            baseline: None,
+            change_percent: 0.0,
+            verdict: Verdict::Unchanged,
+        });
+    };
+    let Some(base) = baseline
+        .iter()
+        .find(|b| b.key() == current.key())
+        .and_then(|b| Stats::of(&b.samples))
+    else {
+        return Some(Comparison {
+            current: stats,
+            baseline: None,
+            change_percent: 0.0,
+            verdict: Verdict::New,
+        });
+    };
+    let delta = stats.mean - base.mean;
+    let change_percent = if base.mean > 0.0 {
+        delta / base.mean * 100.0
+    } else {
+        0.0
+    };
+    let beyond_threshold = change_percent.abs() > noise_threshold;
+    let beyond_spread = if stats.samples < 2 || base.samples < 2 {
+        true
+    } else {
+        delta.abs() > 2.0 * (stats.standard_error_squared() + base.standard_error_squared()).sqrt()
+    };
+    let verdict = match (beyond_threshold && beyond_spread, delta > 0.0) {
+        (false, _) => Verdict::Unchanged,
+        (true, true) => Verdict::Regressed,
+        (true, false) => Verdict::Improved,
+    };
+    Some(Comparison {
+        current: stats,
+        baseline: Some(base),
+        change_percent,
+        verdict,
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn result(name: &str, samples: &[f64]) -> BenchResult {
+        BenchResult {
+            package: "demo".into(),
+            target: "micro".into(),
+            name: name.into(),
+            samples: samples.to_vec(),
+        }
+    }
+
+    #[test]
+    fn stats_use_the_sample_standard_deviation() {
+        let stats = Stats::of(&[2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0]).unwrap();
+        assert!((stats.mean - 5.0).abs() < 1e-9);
+        assert!((stats.stddev - 2.138_089_935).abs() < 1e-6);
+        assert_eq!(stats.samples, 8);
+        assert!(Stats::of(&[3.0]).unwrap().stddev.abs() < 1e-12);
+        assert_eq!(Stats::of(&[]), None);
+    }
+
+    #[test]
+    fn verdict_requires_both_threshold_and_spread() {
+        let baseline = vec![result("sort", &[100.0, 101.0, 99.0, 100.0])];
+        let classify = |samples: &[f64]| {
+            compare(&result("sort", samples), Some(&baseline), 5.0)
+                .unwrap()
+                .verdict
+        };
+        // 10% slower with tight spread: a regression.
+        assert_eq!(classify(&[110.0, 111.0, 109.0, 110.0]), Verdict::Regressed);
+        // 10% faster: an improvement.
+        assert_eq!(classify(&[90.0, 91.0, 89.0, 90.0]), Verdict::Improved);
+        // Under the threshold: noise.
+        assert_eq!(classify(&[102.0, 103.0, 101.0, 102.0]), Verdict::Unchanged);
+        // Over the threshold, but the samples are all over the place.
+        assert_eq!(classify(&[40.0, 180.0, 60.0, 160.0]), Verdict::Unchanged);
+        // Single samples: only the threshold applies.
+        assert_eq!(classify(&[120.0]), Verdict::Regressed);
+        assert_eq!(
+            compare(&result("other", &[1.0]), Some(&baseline), 5.0)
+                .unwrap()
+                .verdict,
+            Verdict::New
+        );
+        assert_eq!(
+            compare(&result("sort", &[500.0]), None, 5.0)
+                .unwrap()
+                .verdict,
+            Verdict::Unchanged
+        );
+    }
+}
@@ -0,0 +1,477 @@
+//! Benchmark runner for Cabin's `bench` targets.
+//!
+//! `cabin bench` mirrors `cabin test`: the CLI builds the selected
+//! `bench` targets through the ordinary build pipeline (with the
+//! `release` profile unless told otherwise) and plans them with
+//! [`cabin_test::plan_executables_of_kind`].  This crate then:
+//!
+//! 1. runs each benchmark executable to completion, one at a time
+//!    so concurrent work does not skew the numbers ([`run_benches`]);
+//! 2. reads its samples from Google Benchmark's JSON report or from
+//!    `cabin-bench <name> <nanoseconds>` lines on stdout;
+//! 3. stores the run as a [`BenchReport`] and compares it against a
+//!    saved baseline ([`compare`]), classifying each benchmark as
+//!    regressed / improved / unchanged under a noise threshold.
+//!
+//! Crate boundary: like `cabin-test`, this crate does not parse
+//! manifests, plan builds, or invoke Ninja.
+
+use std::ffi::OsString;
+use std::fmt::Write as _;
+use std::fs;
+use std::io::{self, BufRead, BufReader, Write};
+use std::path::{Path, PathBuf};
+use std::process::{Command, Stdio};
+
+use cabin_report::ReportError;
+use cabin_test::{TestExecutable, TestPlan};
+use serde::{Deserialize, Serialize};
+use thiserror::Error;
+
+mod compare;
+mod parse;
+
+pub use compare::{Comparison, DEFAULT_NOISE_THRESHOLD, Stats, Verdict, compare};
+
+/// Environment variable naming the file Google Benchmark writes
+/// its report to.  Binaries built on other harnesses ignore it.
+pub const BENCHMARK_OUT: &str = "BENCHMARK_OUT";
+/// Format of the [`BENCHMARK_OUT`] report; always `json`.
+pub const BENCHMARK_OUT_FORMAT: &str = "BENCHMARK_OUT_FORMAT";
+
+/// Layout version of a stored [`BenchReport`].
+const REPORT_VERSION: u32 = 1;
+
+/// Samples of one benchmark of one `bench` executable.
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct BenchResult {
+    /// Workspace package the `bench` target belongs to.
+    pub package: String,
+    /// Manifest-declared `bench` target name.
+    pub target: String,
+    /// Benchmark name as reported by the executable.
+    pub name: String,
+    /// Nanoseconds per iteration, one entry per repetition.
+    pub samples: Vec<f64>,
+}
+
+impl BenchResult {
+    fn key(&self) -> (&str, &str, &str) {
+        (&self.package, &self.target, &self.name)
+    }
+}
+
+/// Every benchmark of one `cabin bench` run, in plan order.
+#[derive(Debug, Clone, Default, PartialEq, Serialize, Deserialize)]
+pub struct BenchReport {
+    /// Benchmark results.
+    pub benchmarks: Vec<BenchResult>,
+}
+
+/// Options for [`run_benches`].
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct BenchRunOptions {
+    /// Extra arguments passed to every benchmark executable (for
+    /// example `--benchmark_filter=...` or `--benchmark_repetitions=10`).
+    pub args: Vec<OsString>,
+    /// Directory that receives each executable's Google Benchmark
+    /// report as `<package>/<target>.json`.
+    pub output_dir: PathBuf,
+}
+
+/// Run every executable in `plan`, in order, and collect its samples.
+///
+/// Each executable runs in its package's manifest directory with
+/// its `CABIN_*` env overlay, plus [`BENCHMARK_OUT`] /
+/// [`BENCHMARK_OUT_FORMAT`] pointing Google Benchmark at a JSON
+/// report.  Its stdout is forwarded to `echo` line by line; stderr
+/// is inherited.  When the report exists after the run its
+/// `iteration` entries are the samples; otherwise stdout is read
+/// for `cabin-bench <name> <nanoseconds>` lines.
+///
+/// # Errors
+/// Returns [`BenchRunError`]: `Spawn` / `Wait` / `OutputIo` when the
+/// process cannot be started, awaited or read, `Failed` when it
+/// exits non-zero, `Parse` for an unreadable JSON report,
+/// `NoResults` when it reported no samples in either format,
+/// `ReportIo` when the report directory cannot be prepared, and
+/// `EchoIo` when writing to `echo` fails.
+///
+/// # Panics
+///
+/// Panics if a spawned child does not expose stdout after the
+/// runner configured it as piped.
+pub fn run_benches<W: Write>(
+    plan: &TestPlan,
+    options: &BenchRunOptions,
+    echo: &mut W,
+) -> Result<BenchReport, BenchRunError> {
+    let mut report = BenchReport::default();
+    for executable in plan.executables() {
+        for (name, samples) in run_one(executable, options, echo)? {
+            report.benchmarks.push(BenchResult {
+                package: executable.package.clone(),
+                target: executable.target.clone(),
+                name,
+                samples,
+            });
+        }
+    }
+    Ok(report)
+}
+
+fn run_one<W: Write>(
+    executable: &TestExecutable,
+    options: &BenchRunOptions,
+    echo: &mut W,
+) -> Result<parse::Samples, BenchRunError> {
+    let json_path = options
+        .output_dir
+        .join(&executable.package)
+        .join(format!("{}.json", executable.target));
+    // A report left by an earlier run must not pass for this one's.
+    match fs::remove_file(&json_path) {
+        Ok(()) => {}
+        Err(e) if e.kind() == io::ErrorKind::NotFound => {}
+        Err(source) => {
+            return Err(BenchRunError::ReportIo {
+                path: json_path,
+                source,
+            });
+        }
+    }
+    if let Some(parent) = json_path.parent() {
+        fs::create_dir_all(parent).map_err(|source| BenchRunError::ReportIo {
+            path: parent.to_path_buf(),
+            source,
+        })?;
+    }
+
+    let mut command = Command::new(&executable.executable);
+    command
+        .current_dir(&executable.working_dir)
+        .envs(&executable.env)
+        .env(BENCHMARK_OUT, &json_path)
+        .env(BENCHMARK_OUT_FORMAT, "json")
+        .env_remove(cabin_env::CABIN_REGISTRY_TOKEN)
+        .args(&options.args)
+        .stdout(Stdio::piped())
+        .stderr(Stdio::inherit());
+    let mut child = command.spawn().map_err(|source| BenchRunError::Spawn {
+        package: executable.package.clone(),
+        target: executable.target.clone(),
+        executable: executable.executable.clone(),
+        source,
+    })?;
+
+    let mut stdout = String::new();
+    let mut reader = BufReader::new(child.stdout.take().expect("stdout is piped"));
+    let mut line = Vec::new();
+    loop {
+        line.clear();
+        let read = reader
+            .read_until(b'\n', &mut line)
+            .map_err(BenchRunError::OutputIo)?;
+        if read == 0 {
+            break;
+        }
+        echo.write_all(&line).map_err(BenchRunError::EchoIo)?;
+        stdout.push_str(&String::from_utf8_lossy(&line));
+    }
+    let status = child.wait().map_err(|source| BenchRunError::Wait {
+        package: executable.package.clone(),
+        target: executable.target.clone(),
+        source,
+    })?;
+    if !status.success() {
+        return Err(BenchRunError::Failed {
+            package: executable.package.clone(),
+            target: executable.target.clone(),
+            code: status.code(),
+        });
+    }
+
+    let samples = match fs::read(&json_path) {
+        Ok(json) => {
+            parse::parse_google_benchmark(&json).map_err(|source| BenchRunError::Parse {
+                path: json_path.clone(),
+                source,
+            })?
+        }
+        Err(_) => parse::parse_lines(&stdout),
+    };
+    if samples.is_empty() {
+        return Err(BenchRunError::NoResults {
+            package: executable.package.clone(),
+            target: executable.target.clone(),
+        });
+    }
+    Ok(samples)
+}
+
+/// Path of the stored baseline `name` under `bench_dir`.
+///
+/// # Errors
+/// Returns [`BenchRunError::Report`] when `name` is not a valid
+/// baseline name ([`cabin_report::baseline_path`]).
+pub fn baseline_path(bench_dir: &Path, name: &str) -> Result<PathBuf, BenchRunError> {
+    Ok(cabin_report::baseline_path(bench_dir, name)?)
+}
+
+/// Write `report` to `path` ([`cabin_report::save`]).
+///
+/// # Errors
+/// Returns [`BenchRunError::Report`] when the report cannot be
+/// encoded or written.
+pub fn save_report(path: &Path, report: &BenchReport) -> Result<(), BenchRunError> {
+    Ok(cabin_report::save(path, REPORT_VERSION, report)?)
+}
+
+/// Read a report written by [`save_report`].
+///
+/// # Errors
+/// Returns [`BenchRunError::Report`] when the file cannot be read,
+/// is not a report, or was written by a different Cabin version.
+pub fn load_report(path: &Path) -> Result<BenchReport, BenchRunError> {
+    Ok(cabin_report::load(path, REPORT_VERSION)?)
+}
+
+/// Render one benchmark's line of the `cabin bench` summary:
+/// `bench <pkg>:<target> <name> ... <mean>/iter (± <stddev>, N samples)`
+/// plus, when compared against a baseline, the change and verdict.
+pub fn render_result_line(result: &BenchResult, comparison: &Comparison) -> String {
+    let stats = comparison.current;
+    let mut line = format!(
+        "bench {}:{} {} ... {}/iter (± {}, {} sample{})",
+        result.package,
+        result.target,
+        result.name,
+        format_nanos(stats.mean),
+        format_nanos(stats.stddev),
+        stats.samples,
+        if stats.samples == 1 { "" } else { "s" },
+    );
+    if comparison.baseline.is_some() {
+        let verdict = match comparison.verdict {
+            Verdict::Regressed => "regressed",
+            Verdict::Improved => "improved",
+            Verdict::Unchanged | Verdict::New => "within noise",
+        };
+        let _ = write!(line, " [{:+.2}%, {verdict}]", comparison.change_percent);
+    } else if comparison.verdict == Verdict::New {
+        line.push_str(" [new]");
+    }
+    line
+}
+
+/// Format a duration in nanoseconds with a unit that keeps the
+/// number readable.
+fn format_nanos(nanos: f64) -> String {
+    if nanos >= 1e9 {
+        format!("{:.2} s", nanos / 1e9)
+    } else if nanos >= 1e6 {
+        format!("{:.2} ms", nanos / 1e6)
+    } else if nanos >= 1e3 {
+        format!("{:.2} us", nanos / 1e3)
+    } else {
+        format!("{nanos:.2} ns")
+    }
+}
+
+fn exit_label(code: Option<i32>) -> String {
+    match code {
+        Some(code) => format!("exit {code}"),
+        None => "terminated by signal".to_owned(),
+    }
+}
+
+/// Errors produced while running benchmarks or handling reports.
+#[derive(Debug, Error)]
+pub enum BenchRunError {
+    /// The OS could not start the benchmark executable.
+    #[error("failed to start bench target `{package}:{target}` ({}): {source}", .executable.display())]
+    Spawn {
+        package: String,
+        target: String,
+        executable: PathBuf,
+        #[source]
+        source: io::Error,
+    },
+    /// Waiting for the benchmark executable failed.
+    #[error("failed to wait for bench target `{package}:{target}`: {source}")]
+    Wait {
+        package: String,
+        target: String,
+        #[source]
+        source: io::Error,
+    },
+    /// Reading the executable's stdout failed.
+    #[error("failed to read benchmark output: {0}")]
+    OutputIo(#[source] io::Error),
+    /// Forwarding the executable's stdout failed.
+    #[error("failed to write benchmark output: {0}")]
+    EchoIo(#[source] io::Error),
+    /// The benchmark executable exited unsuccessfully.
+    #[error("bench target `{package}:{target}` failed ({})", exit_label(.code.to_owned()))]
+    Failed {
+        package: String,
+        target: String,
+        code: Option<i32>,
+    },
+    /// The executable reported no samples in either format.
+    #[error(
+        "bench target `{package}:{target}` reported no results; use Google Benchmark or print `cabin-bench <name> <nanoseconds>` lines to stdout"
+    )]
+    NoResults { package: String, target: String },
+    /// A Google Benchmark JSON report could not be parsed.
+    #[error("failed to parse benchmark report {}: {source}", .path.display())]
+    Parse {
+        path: PathBuf,
+        #[source]
+        source: serde_json::Error,
+    },
+    /// A run's JSON report file or its directory could not be
+    /// prepared.
+    #[error("failed to access benchmark report {}: {source}", .path.display())]
+    ReportIo {
+        path: PathBuf,
+        #[source]
+        source: io::Error,
+    },
+    /// A stored report or baseline could not be saved or loaded.
+    #[error(transparent)]
+    Report(#[from] ReportError),
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::collections::BTreeMap;
+
+    #[cfg(unix)]
+    fn bench_plan(dir: &Path, script: &str) -> TestPlan {
+        use std::os::unix::fs::PermissionsExt;
+        let exe = dir.join("micro");
+        fs::write(&exe, script).unwrap();
+        fs::set_permissions(&exe, fs::Permissions::from_mode(0o755)).unwrap();
+        TestPlan::new(vec![TestExecutable {
+            package: "demo".into(),
+            target: "micro".into(),
+            executable: exe,
+            working_dir: dir.to_path_buf(),
+            env: BTreeMap::new(),
+            data: Vec::new(),
+            harness: None,
+        }])
+    }
+
+    #[test]
+    #[cfg(unix)]
+    fn run_benches_reads_line_format_and_google_benchmark_reports() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let options = BenchRunOptions {
+            args: Vec::new(),
+            output_dir: dir.path().join("out"),
+        };
+
+        let plan = bench_plan(
+            dir.path(),
+            "#!/bin/sh\necho warming up\necho 'cabin-bench lookup 10'\necho 'cabin-bench lookup 12'\n",
+        );
+        let mut echo = Vec::new();
+        let report = run_benches(&plan, &options, &mut echo).unwrap();
+        assert_eq!(report.benchmarks.len(), 1);
+        assert_eq!(report.benchmarks[0].name, "lookup");
+        assert_eq!(report.benchmarks[0].samples.len(), 2);
+        assert!(String::from_utf8(echo).unwrap().starts_with("warming up\n"));
+
+        let plan = bench_plan(
+            dir.path(),
+            r#"#!/bin/sh
+cat > "$BENCHMARK_OUT" <<'EOF'
+{"benchmarks": [{"name": "BM_Insert", "run_type": "iteration", "real_time": 2, "time_unit": "ms"}]}
+EOF
+echo 'cabin-bench ignored_when_json_exists 1'
+"#,
+        );
+        let report = run_benches(&plan, &options, &mut Vec::new()).unwrap();
+        assert_eq!(
+            report.benchmarks,
+            vec![BenchResult {
+                package: "demo".into(),
+                target: "micro".into(),
+                name: "BM_Insert".into(),
+                samples: vec![2e6],
+            }]
+        );
+    }
+
+    #[test]
+    #[cfg(unix)]
+    fn run_benches_rejects_failures_and_silent_binaries() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let options = BenchRunOptions {
+            args: Vec::new(),
+            output_dir: dir.path().join("out"),
+        };
+        let plan = bench_plan(dir.path(), "#!/bin/sh\nexit 3\n");
+        assert!(matches!(
+            run_benches(&plan, &options, &mut Vec::new()),
+            Err(BenchRunError::Failed { code: Some(3), .. })
+        ));
+        let plan = bench_plan(dir.path(), "#!/bin/sh\necho nothing to see\n");
+        assert!(matches!(
+            run_benches(&plan, &options, &mut Vec::new()),
+            Err(BenchRunError::NoResults { .. })
+        ));
+    }
+
+    #[test]
+    fn reports_round_trip_through_baseline_files() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let path = baseline_path(dir.path(), "main").unwrap();
+        assert_eq!(path, dir.path().join("baselines/main.json"));
+        let report = BenchReport {
+            benchmarks: vec![BenchResult {
+                package: "demo".into(),
+                target: "micro".into(),
+                name: "BM_Sort/64".into(),
+                samples: vec![1.5, 2.5],
+            }],
+        };
+        save_report(&path, &report).unwrap();
+        assert_eq!(load_report(&path).unwrap(), report);
+
+        for bad in ["", "../escape", ".hidden", "a/b"] {
+            assert!(matches!(
+                baseline_path(dir.path(), bad),
+                Err(BenchRunError::Report(
+                    ReportError::InvalidBaselineName { .. }
+                ))
+            ));
+        }
+    }
+
+    #[test]
+    fn result_line_shows_stats_and_baseline_verdict() {
+        let result = BenchResult {
+            package: "demo".into(),
+            target: "micro".into(),
+            name: "lookup".into(),
+            samples: vec![1100.0, 1100.0],
+        };
+        let baseline = vec![BenchResult {
+            samples: vec![1000.0],
+            ..result.clone()
+        }];
+        let comparison = compare(&result, Some(&baseline), DEFAULT_NOISE_THRESHOLD).unwrap();
+        assert_eq!(
+            render_result_line(&result, &comparison),
+            "bench demo:micro lookup ... 1.10 us/iter (± 0.00 ns, 2 samples) [+10.00%, regressed]"
+        );
+        let comparison = compare(&result, Some(&[]), DEFAULT_NOISE_THRESHOLD).unwrap();
+        assert!(render_result_line(&result, &comparison).ends_with(" [new]"));
+        let comparison = compare(&result, None, DEFAULT_NOISE_THRESHOLD).unwrap();
+        assert!(render_result_line(&result, &comparison).ends_with("2 samples)"));
+    }
+}
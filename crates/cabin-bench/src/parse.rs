@@ -0,0 +1,154 @@
+//! Readers for the two result formats `cabin bench` understands.
+//!
+//! - **Google Benchmark JSON**, written by the binary to the file
+//!   named in `BENCHMARK_OUT`.  Every `iteration` entry is one
+//!   sample of its `run_name`; aggregates (`mean`, `stddev`, ...)
+//!   are skipped because Cabin computes its own from the samples.
+//! - **Line format**, for hand-rolled harnesses: every stdout line
+//!   of the form `cabin-bench <name> <nanoseconds>` is one sample
+//!   of `<name>`.  Other lines are ignored, so the format can be
+//!   mixed into ordinary progress output.
+
+use std::collections::BTreeMap;
+
+use serde::Deserialize;
+
+/// Prefix of a line-format sample.
+pub(crate) const LINE_PREFIX: &str = "cabin-bench";
+
+/// Samples (nanoseconds per iteration) keyed by benchmark name, in
+/// first-seen order.
+pub(crate) type Samples = Vec<(String, Vec<f64>)>;
+
+#[derive(Deserialize)]
+struct GoogleBenchmarkReport {
+    benchmarks: Vec<GoogleBenchmarkEntry>,
+}
+
+#[derive(Deserialize)]
+struct GoogleBenchmarkEntry {
+    name: String,
+    #[serde(default)]
+    run_name: Option<String>,
+    #[serde(default)]
+    run_type: Option<String>,
+    #[serde(default)]
+    error_occurred: bool,
+    real_time: f64,
+    #[serde(default)]
+    time_unit: Option<String>,
+}
+
+/// Parse a Google Benchmark JSON report.
+pub(crate) fn parse_google_benchmark(json: &[u8]) -> Result<Samples, serde_json::Error> {
+    let report: GoogleBenchmarkReport = serde_json::from_slice(json)?;
+    let mut samples = SampleSet::default();
+    for entry in report.benchmarks {
+        if entry.error_occurred || entry.run_type.as_deref().is_some_and(|t| t != "iteration") {
+            continue;
+        }
+        let scale = match entry.time_unit.as_deref() {
+            Some("s") => 1e9,
+            Some("ms") => 1e6,
+            Some("us") => 1e3,
+            _ => 1.0,
+        };
+        samples.push(
+            entry.run_name.unwrap_or(entry.name),
+            entry.real_time * scale,
+        );
+    }
+    Ok(samples.into_vec())
+}
+
+/// Collect line-format samples from a benchmark's stdout.
+pub(crate) fn parse_lines(stdout: &str) -> Samples {
+    let mut samples = SampleSet::default();
+    for line in stdout.lines() {
+        let mut fields = line.split_whitespace();
+        if fields.next() != Some(LINE_PREFIX) {
+            continue;
+        }
+        let (Some(name), Some(value), None) = (fields.next(), fields.next(), fields.next()) else {
+            continue;
+        };
+        if let Ok(nanos) = value.parse::<f64>()
+            && nanos.is_finite()
+            && nanos >= 0.0
+        {
+            samples.push(name.to_owned(), nanos);
+        }
+    }
+    samples.into_vec()
+}
+
+/// Insertion-ordered accumulator behind both parsers.
+#[derive(Default)]
+struct SampleSet {
+    index: BTreeMap<String, usize>,
+    samples: Samples,
+}
+
+impl SampleSet {
+    fn push(&mut self, name: String, nanos: f64) {
+        let slot = *self.index.entry(name.clone()).or_insert_with(|| {
+            self.samples.push((name, Vec::new()));
+            self.samples.len() - 1
+        });
+        self.samples[slot].1.push(nanos);
+    }
+
+    fn into_vec(self) -> Samples {
+        self.samples
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn google_benchmark_iterations_become_samples_in_nanoseconds() {
+        let json = br#"{
+            "context": {"library_build_type": "release"},
+            "benchmarks": [
+                {"name": "BM_Sort/64/repeats:2", "run_name": "BM_Sort/64", "run_type": "iteration",
+                 "real_time": 1.5, "cpu_time": 1.4, "time_unit": "us"},
+                {"name": "BM_Sort/64/repeats:2", "run_name": "BM_Sort/64", "run_type": "iteration",
+                 "real_time": 2.5, "cpu_time": 2.4, "time_unit": "us"},
+                {"name": "BM_Sort/64_mean", "run_name": "BM_Sort/64", "run_type": "aggregate",
+                 "real_time": 2.0, "cpu_time": 1.9, "time_unit": "us"},
+                {"name": "BM_Broken", "run_type": "iteration", "error_occurred": true,
+                 "real_time": 0.0, "time_unit": "ns"},
+                {"name": "BM_Old", "real_time": 30.0}
+            ]
+        }"#;
+        assert_eq!(
+            parse_google_benchmark(json).unwrap(),
+            vec![
+                ("BM_Sort/64".to_owned(), vec![1500.0, 2500.0]),
+                ("BM_Old".to_owned(), vec![30.0]),
+            ]
+        );
+        assert!(parse_google_benchmark(b"not json").is_err());
+    }
+
+    #[test]
+    fn line_format_ignores_everything_but_well_formed_sample_lines() {
+        let stdout = "warming up\n\
+                      cabin-bench parse_small 120.5\n\
+                      cabin-bench parse_large 9000\n\
+                      cabin-bench parse_small 119.5\n\
+                      cabin-bench missing_value\n\
+                      cabin-bench too many fields\n\
+                      cabin-bench negative -1\n\
+                      cabin-benchmark parse_small 1\n";
+        assert_eq!(
+            parse_lines(stdout),
+            vec![
+                ("parse_small".to_owned(), vec![120.5, 119.5]),
+                ("parse_large".to_owned(), vec![9000.0]),
+            ]
+        );
+    }
+}
@@ -0,0 +1,553 @@
+//! Binary size attribution for `cabin bloat`.
+//!
+//! The CLI builds the selected executables with linker maps turned
+//! on ([`cabin_build::with_linker_maps`]).  This crate then:
+//!
+//! 1. reads each executable's GNU or LLD map ([`analyze_map`]);
+//! 2. charges every input section to the package and target that
+//!    produced its object or archive, using the planner's
+//!    [`cabin_build::BuildGraph::artifact_owners`], and splits it
+//!    further across the symbols the map lists inside it;
+//! 3. buckets the bytes by the output section they landed in (text,
+//!    data, debug info, other) and stores the result as a
+//!    [`BloatReport`] that a later run can diff against.
+//!
+//! Files the planner did not produce (the C++ runtime, system
+//! archives, crt objects) are charged to [`EXTERNAL_PACKAGE`];
+//! sections the linker synthesized are charged to
+//! [`LINKER_PACKAGE`].
+//!
+//! Crate boundary: this crate does not plan builds or invoke Ninja.
+
+use std::collections::BTreeMap;
+use std::fs;
+use std::io;
+use std::path::{Path, PathBuf};
+
+use cabin_build::ArtifactOwner;
+use cabin_report::ReportError;
+use camino::{Utf8Path, Utf8PathBuf};
+use serde::{Deserialize, Serialize};
+use thiserror::Error;
+
+mod map;
+mod render;
+
+pub use render::{format_size, render_executable};
+
+use map::{InputFile, InputSection};
+
+/// Package charged for input files no planned target produced.
+pub const EXTERNAL_PACKAGE: &str = "[external]";
+/// Package charged for sections the linker synthesized.
+pub const LINKER_PACKAGE: &str = "[linker]";
+
+/// Layout version of a stored [`BloatReport`].
+const REPORT_VERSION: u32 = 1;
+
+/// Bytes of one attribution row, by the kind of output section they
+/// were placed in.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq, Serialize, Deserialize)]
+pub struct Sizes {
+    /// Executable code (`.text`, `.init`, `.plt`, ...).
+    pub text: u64,
+    /// Loaded data, initialized or not (`.rodata`, `.data`, `.bss`,
+    /// unwind tables, ...).
+    pub data: u64,
+    /// Debug information (`.debug_*`), not loaded at run time.
+    pub debug: u64,
+    /// Everything else (notes, symbol versioning, comments, ...).
+    pub other: u64,
+}
+
+impl Sizes {
+    /// All bytes of the row.
+    #[must_use]
+    pub fn total(self) -> u64 {
+        self.loaded()
+            .saturating_add(self.debug)
+            .saturating_add(self.other)
+    }
+
+    /// Text plus data: the bytes that cost memory at run time.
+    #[must_use]
+    pub fn loaded(self) -> u64 {
+        self.text.saturating_add(self.data)
+    }
+
+    fn add(&mut self, other: Self) {
+        self.text = self.text.saturating_add(other.text);
+        self.data = self.data.saturating_add(other.data);
+        self.debug = self.debug.saturating_add(other.debug);
+        self.other = self.other.saturating_add(other.other);
+    }
+
+    fn of(output_section: &str, bytes: u64) -> Self {
+        let mut sizes = Self::default();
+        let slot = match classify_section(output_section) {
+            SectionKind::Text => &mut sizes.text,
+            SectionKind::Data => &mut sizes.data,
+            SectionKind::Debug => &mut sizes.debug,
+            SectionKind::Other => &mut sizes.other,
+        };
+        *slot = bytes;
+        sizes
+    }
+}
+
+enum SectionKind {
+    Text,
+    Data,
+    Debug,
+    Other,
+}
+
+fn classify_section(name: &str) -> SectionKind {
+    let is = |prefix: &str| name == prefix || name.starts_with(&format!("{prefix}."));
+    if name.starts_with(".debug") || name.starts_with(".zdebug") || name.starts_with(".stab") {
+        SectionKind::Debug
+    } else if is(".text") || is(".init") || is(".fini") || name.starts_with(".plt") || is(".iplt") {
+        SectionKind::Text
+    } else if is(".rodata")
+        || is(".data")
+        || is(".bss")
+        || is(".tdata")
+        || is(".tbss")
+        || name.starts_with(".data.rel.ro")
+        || name.starts_with(".init_array")
+        || name.starts_with(".fini_array")
+        || name.starts_with(".got")
+        || name.starts_with(".eh_frame")
+        || is(".gcc_except_table")
+        || is(".ctors")
+        || is(".dtors")
+    {
+        SectionKind::Data
+    } else {
+        SectionKind::Other
+    }
+}
+
+/// Bytes charged to one symbol of one target.
+#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
+pub struct SymbolSize {
+    /// Package that produced the bytes, or [`EXTERNAL_PACKAGE`] /
+    /// [`LINKER_PACKAGE`].
+    pub package: String,
+    /// Target that produced the bytes; for external files, the
+    /// object or archive file name.
+    pub target: String,
+    /// Symbol name as the map prints it, or `[<section>]` for bytes
+    /// no listed symbol covers.
+    pub symbol: String,
+    /// Bytes by section kind.
+    pub sizes: Sizes,
+}
+
+/// Attribution of one linked executable.
+#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
+pub struct ExecutableBloat {
+    /// Workspace package the executable belongs to.
+    pub package: String,
+    /// Manifest-declared executable target name.
+    pub target: String,
+    /// Every attributed symbol, largest loaded size first.
+    pub symbols: Vec<SymbolSize>,
+}
+
+impl ExecutableBloat {
+    /// Sum over every symbol.
+    #[must_use]
+    pub fn totals(&self) -> Sizes {
+        let mut totals = Sizes::default();
+        for symbol in &self.symbols {
+            totals.add(symbol.sizes);
+        }
+        totals
+    }
+
+    /// Sizes rolled up per package.
+    #[must_use]
+    pub fn by_package(&self) -> BTreeMap<String, Sizes> {
+        self.rollup(|s| s.package.clone())
+    }
+
+    /// Sizes rolled up per `<package>:<target>`.
+    #[must_use]
+    pub fn by_target(&self) -> BTreeMap<String, Sizes> {
+        self.rollup(|s| format!("{}:{}", s.package, s.target))
+    }
+
+    /// Sizes per `<symbol> (<package>:<target>)`.
+    #[must_use]
+    pub fn by_symbol(&self) -> BTreeMap<String, Sizes> {
+        self.rollup(|s| format!("{} ({}:{})", s.symbol, s.package, s.target))
+    }
+
+    fn rollup(&self, key: impl Fn(&SymbolSize) -> String) -> BTreeMap<String, Sizes> {
+        let mut rows: BTreeMap<String, Sizes> = BTreeMap::new();
+        for symbol in &self.symbols {
+            rows.entry(key(symbol)).or_default().add(symbol.sizes);
+        }
+        rows
+    }
+}
+
+/// Every executable of one `cabin bloat` run, in plan order.
+#[derive(Debug, Clone, Default, PartialEq, Eq, Serialize, Deserialize)]
+pub struct BloatReport {
+    /// Per-executable attribution.
+    pub executables: Vec<ExecutableBloat>,
+}
+
+impl BloatReport {
+    /// The entry for `package:target`, if the report has one.
+    #[must_use]
+    pub fn executable(&self, package: &str, target: &str) -> Option<&ExecutableBloat> {
+        self.executables
+            .iter()
+            .find(|e| e.package == package && e.target == target)
+    }
+}
+
+/// Read the linker map at `map_path`, written while linking
+/// `executable`, and attribute its bytes through `owners`.
+///
+/// # Errors
+/// Returns [`BloatError::MapIo`] when the map cannot be read and
+/// [`BloatError::UnrecognizedMap`] when it is neither a GNU nor an
+/// LLD map.
+pub fn analyze_map(
+    executable: &ArtifactOwner,
+    map_path: &Utf8Path,
+    owners: &BTreeMap<Utf8PathBuf, ArtifactOwner>,
+) -> Result<ExecutableBloat, BloatError> {
+    let text = fs::read_to_string(map_path).map_err(|source| BloatError::MapIo {
+        path: map_path.to_owned(),
+        source,
+    })?;
+    let sections = map::parse(&text).ok_or_else(|| BloatError::UnrecognizedMap {
+        path: map_path.to_owned(),
+    })?;
+    Ok(attribute(executable, &sections, owners))
+}
+
+fn attribute(
+    executable: &ArtifactOwner,
+    sections: &[InputSection],
+    owners: &BTreeMap<Utf8PathBuf, ArtifactOwner>,
+) -> ExecutableBloat {
+    let mut rows: BTreeMap<(String, String, String), Sizes> = BTreeMap::new();
+    for section in sections {
+        let (package, target) = owner_of(&section.file, owners);
+        for (symbol, bytes) in split_by_symbol(section) {
+            rows.entry((package.clone(), target.clone(), symbol))
+                .or_default()
+                .add(Sizes::of(&section.output_section, bytes));
+        }
+    }
+    let mut symbols: Vec<SymbolSize> = rows
+        .into_iter()
+        .map(|((package, target, symbol), sizes)| SymbolSize {
+            package,
+            target,
+            symbol,
+            sizes,
+        })
+        .collect();
+    symbols.sort_by(|a, b| {
+        (b.sizes.loaded(), b.sizes.total())
+            .cmp(&(a.sizes.loaded(), a.sizes.total()))
+            .then_with(|| {
+                (&a.package, &a.target, &a.symbol).cmp(&(&b.package, &b.target, &b.symbol))
+            })
+    });
+    ExecutableBloat {
+        package: executable.package.clone(),
+        target: executable.target.clone(),
+        symbols,
+    }
+}
+
+/// `(package, target)` charged for bytes from `file`.  Archive
+/// members resolve through their archive first, so a thin archive's
+/// member objects still land on the library target.
+fn owner_of(file: &InputFile, owners: &BTreeMap<Utf8PathBuf, ArtifactOwner>) -> (String, String) {
+    let lookup = |path: &str| owners.get(Utf8Path::new(path));
+    let (found, fallback) = match file {
+        InputFile::Object(path) => (lookup(path), path.as_str()),
+        InputFile::Member { archive, member } => {
+            (lookup(archive).or_else(|| lookup(member)), archive.as_str())
+        }
+        InputFile::Linker => return (LINKER_PACKAGE.to_owned(), "synthesized".to_owned()),
+    };
+    match found {
+        Some(owner) => (owner.package.clone(), owner.target.clone()),
+        None => (
+            EXTERNAL_PACKAGE.to_owned(),
+            Utf8Path::new(fallback)
+                .file_name()
+                .unwrap_or(fallback)
+                .to_owned(),
+        ),
+    }
+}
+
+/// Split an input section across the symbols listed inside it.  A
+/// symbol owns the bytes up to the next distinct address; bytes
+/// before the first symbol, or a section without symbols, are
+/// charged to `[<section name>]`.
+fn split_by_symbol(section: &InputSection) -> Vec<(String, u64)> {
+    let end = section.address.saturating_add(section.size);
+    let mut symbols: Vec<&(u64, String)> = section
+        .symbols
+        .iter()
+        .filter(|(address, _)| (section.address..end).contains(address))
+        .collect();
+    // Aliases share an address; the first one the map lists wins.
+    symbols.sort_by_key(|(address, _)| *address);
+    symbols.dedup_by_key(|(address, _)| *address);
+
+    let mut out = Vec::with_capacity(symbols.len() + 1);
+    let lead = symbols
+        .first()
+        .map_or(section.size, |(address, _)| address - section.address);
+    if lead > 0 {
+        out.push((format!("[{}]", section.name), lead));
+    }
+    for (i, (address, name)) in symbols.iter().enumerate() {
+        let next = symbols.get(i + 1).map_or(end, |(next, _)| *next);
+        out.push((name.clone(), next - address));
+    }
+    out
+}
+
+/// Path of the stored baseline `name` under `bloat_dir`.
+///
+/// # Errors
+/// Returns [`BloatError::Report`] when `name` is not a valid
+/// baseline name ([`cabin_report::baseline_path`]).
+pub fn baseline_path(bloat_dir: &Path, name: &str) -> Result<PathBuf, BloatError> {
+    Ok(cabin_report::baseline_path(bloat_dir, name)?)
+}
+
+/// Write `report` to `path` ([`cabin_report::save`]).
+///
+/// # Errors
+/// Returns [`BloatError::Report`] when the report cannot be encoded
+/// or written.
+pub fn save_report(path: &Path, report: &BloatReport) -> Result<(), BloatError> {
+    Ok(cabin_report::save(path, REPORT_VERSION, report)?)
+}
+
+/// Read a report written by [`save_report`].
+///
+/// # Errors
+/// Returns [`BloatError::Report`] when the file cannot be read, is
+/// not a report, or was written by a different Cabin version.
+pub fn load_report(path: &Path) -> Result<BloatReport, BloatError> {
+    Ok(cabin_report::load(path, REPORT_VERSION)?)
+}
+
+/// Errors produced while reading linker maps or handling reports.
+#[derive(Debug, Error)]
+pub enum BloatError {
+    /// A linker map could not be read.
+    #[error("failed to read linker map {path}: {source}")]
+    MapIo {
+        path: Utf8PathBuf,
+        #[source]
+        source: io::Error,
+    },
+    /// A linker map is in neither the GNU nor the LLD layout.
+    #[error(
+        "linker map {path} is not in a recognized layout; `cabin bloat` reads GNU ld, gold, mold and LLD maps"
+    )]
+    UnrecognizedMap { path: Utf8PathBuf },
+    /// A stored report or baseline could not be saved or loaded.
+    #[error(transparent)]
+    Report(#[from] ReportError),
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn owner(package: &str, target: &str) -> ArtifactOwner {
+        ArtifactOwner {
+            package: package.to_owned(),
+            target: target.to_owned(),
+        }
+    }
+
+    fn section(
+        output: &str,
+        name: &str,
+        file: InputFile,
+        address: u64,
+        size: u64,
+        symbols: &[(u64, &str)],
+    ) -> InputSection {
+        InputSection {
+            output_section: output.to_owned(),
+            name: name.to_owned(),
+            file,
+            address,
+            size,
+            symbols: symbols.iter().map(|(a, s)| (*a, (*s).to_owned())).collect(),
+        }
+    }
+
+    #[test]
+    fn symbols_own_the_bytes_up_to_the_next_address() {
+        let text = section(
+            ".text",
+            ".text",
+            InputFile::Linker,
+            0x1000,
+            0x40,
+            &[(0x1030, "late"), (0x1010, "early"), (0x1010, "alias")],
+        );
+        assert_eq!(
+            split_by_symbol(&text),
+            vec![
+                ("[.text]".to_owned(), 0x10),
+                ("early".to_owned(), 0x20),
+                ("late".to_owned(), 0x10),
+            ]
+        );
+        let bare = section(".rodata", ".rodata.str1.1", InputFile::Linker, 0, 7, &[]);
+        assert_eq!(
+            split_by_symbol(&bare),
+            vec![("[.rodata.str1.1]".to_owned(), 7)]
+        );
+    }
+
+    #[test]
+    fn bytes_are_charged_to_the_planned_target_or_the_external_file() {
+        let owners = BTreeMap::from([
+            (Utf8PathBuf::from("/b/app.o"), owner("demo", "app")),
+            (Utf8PathBuf::from("/b/libgreet.a"), owner("demo", "greet")),
+        ]);
+        let sections = vec![
+            section(
+                ".text",
+                ".text.main",
+                InputFile::Object("/b/app.o".to_owned()),
+                0x1000,
+                0x20,
+                &[(0x1000, "main")],
+            ),
+            section(
+                ".text",
+                ".text._Z5hellov",
+                InputFile::Member {
+                    archive: "/b/libgreet.a".to_owned(),
+                    member: "greet.o".to_owned(),
+                },
+                0x1020,
+                0x10,
+                &[(0x1020, "hello()")],
+            ),
+            section(
+                ".rodata",
+                ".rodata",
+                InputFile::Object("/b/app.o".to_owned()),
+                0x2000,
+                0x8,
+                &[],
+            ),
+            section(
+                ".debug_info",
+                ".debug_info",
+                InputFile::Object("/b/app.o".to_owned()),
+                0,
+                0x100,
+                &[],
+            ),
+            section(
+                ".text",
+                ".text",
+                InputFile::Member {
+                    archive: "/usr/lib/libc_nonshared.a".to_owned(),
+                    member: "atexit.o".to_owned(),
+                },
+                0x1030,
+                0x4,
+                &[(0x1030, "atexit")],
+            ),
+            section(".comment", ".comment", InputFile::Linker, 0, 0x2a, &[]),
+        ];
+        let bloat = attribute(&owner("demo", "app"), &sections, &owners);
+
+        assert_eq!(bloat.symbols[0].symbol, "main");
+        assert_eq!(
+            bloat.totals(),
+            Sizes {
+                text: 0x34,
+                data: 0x8,
+                debug: 0x100,
+                other: 0x2a,
+            }
+        );
+        let targets = bloat.by_target();
+        assert_eq!(targets["demo:app"].loaded(), 0x28);
+        assert_eq!(targets["demo:app"].debug, 0x100);
+        assert_eq!(targets["demo:greet"].text, 0x10);
+        assert_eq!(targets["[external]:libc_nonshared.a"].text, 0x4);
+        assert_eq!(targets["[linker]:synthesized"].other, 0x2a);
+        let packages = bloat.by_package();
+        assert_eq!(packages["demo"].text, 0x30);
+        assert_eq!(packages.len(), 3);
+    }
+
+    #[test]
+    fn output_sections_are_bucketed_by_kind() {
+        assert_eq!(Sizes::of(".text", 1).text, 1);
+        assert_eq!(Sizes::of(".plt.sec", 1).text, 1);
+        assert_eq!(Sizes::of(".rodata", 1).data, 1);
+        assert_eq!(Sizes::of(".data.rel.ro", 1).data, 1);
+        assert_eq!(Sizes::of(".eh_frame_hdr", 1).data, 1);
+        assert_eq!(Sizes::of(".tbss", 1).data, 1);
+        assert_eq!(Sizes::of(".debug_line", 1).debug, 1);
+        assert_eq!(Sizes::of(".note.gnu.build-id", 1).other, 1);
+        assert_eq!(Sizes::of(".textual", 1).other, 1);
+    }
+
+    #[test]
+    fn reports_round_trip_and_reject_bad_baseline_names() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let report = BloatReport {
+            executables: vec![ExecutableBloat {
+                package: "demo".into(),
+                target: "app".into(),
+                symbols: vec![SymbolSize {
+                    package: "demo".into(),
+                    target: "app".into(),
+                    symbol: "main".into(),
+                    sizes: Sizes {
+                        text: 32,
+                        ..Sizes::default()
+                    },
+                }],
+            }],
+        };
+        let path = baseline_path(dir.path(), "main").unwrap();
+        save_report(&path, &report).unwrap();
+        assert_eq!(load_report(&path).unwrap(), report);
+        assert!(report.executable("demo", "app").is_some());
+        assert!(report.executable("demo", "other").is_none());
+
+        fs::write(&path, r#"{"version": 99, "executables": []}"#).unwrap();
+        assert!(matches!(
+            load_report(&path),
+            Err(BloatError::Report(ReportError::Version { found: 99, .. }))
+        ));
+        for bad in ["", ".hidden", "../escape", "a/b"] {
+            assert!(matches!(
+                baseline_path(dir.path(), bad),
+                Err(BloatError::Report(ReportError::InvalidBaselineName { .. }))
+            ));
+        }
+    }
+}
@@ -0,0 +1,369 @@
+//! Linker-map readers.
+//!
+//! Two layouts are understood, which between them cover the ELF
+//! linkers a GCC/Clang driver picks on Linux and the BSDs:
+//!
+//! - **GNU** (`ld.bfd`, `gold`, `mold`): the `Linker script and
+//!   memory map` section, where an output section starts in column
+//!   0, each input section is indented by one space and followed by
+//!   its address, size and contributing file, and symbol lines carry
+//!   an address and a name.  Long section names wrap their numbers
+//!   onto the next line.
+//! - **LLD**: a fixed-column table (`VMA LMA Size Align Out In
+//!   Symbol`) where the indentation of the text column says whether
+//!   a row is an output section, an input section or a symbol.
+//!
+//! Apple `ld64` and MSVC `link` maps use unrelated layouts and are
+//! rejected as unrecognized.
+
+/// Where an input section came from.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub(crate) enum InputFile {
+    /// A plain object file on the link line.
+    Object(String),
+    /// A member pulled out of a static archive.
+    Member { archive: String, member: String },
+    /// Synthesized by the linker (`<internal>`, linker-script
+    /// assignments, stubs).
+    Linker,
+}
+
+/// One input section placed in the output.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub(crate) struct InputSection {
+    /// Output section it was placed in (`.text`, `.debug_info`, ...).
+    pub(crate) output_section: String,
+    /// Input section name (`.text._ZN5greet5helloEv`, `.rodata`, ...).
+    pub(crate) name: String,
+    pub(crate) file: InputFile,
+    pub(crate) address: u64,
+    pub(crate) size: u64,
+    /// Symbols the map lists inside the section, as
+    /// `(address, name)` in map order.
+    pub(crate) symbols: Vec<(u64, String)>,
+}
+
+/// Parse a linker map, or `None` when it is in neither layout.
+pub(crate) fn parse(text: &str) -> Option<Vec<InputSection>> {
+    let first = text.lines().find(|line| !line.trim().is_empty())?;
+    if first.contains(" Out ") && first.trim_end().ends_with("Symbol") {
+        parse_lld(first, text)
+    } else if text.contains("Linker script and memory map") {
+        Some(parse_gnu(text))
+    } else {
+        None
+    }
+}
+
+fn parse_gnu(text: &str) -> Vec<InputSection> {
+    let mut sections: Vec<InputSection> = Vec::new();
+    let mut output: Option<String> = None;
+    // An input section whose name was too long to share a line with
+    // its address and size.
+    let mut pending: Option<String> = None;
+    let body = text
+        .split_once("Linker script and memory map")
+        .map_or("", |(_, body)| body);
+    for line in body.lines() {
+        if line.trim().is_empty() {
+            continue;
+        }
+        let fields: Vec<&str> = line.split_whitespace().collect();
+        if !line.starts_with(' ') {
+            // Column 0: an output section header, or a linker-script
+            // statement (`LOAD`, `OUTPUT(...)`, `/DISCARD/`).
+            output = line.starts_with('.').then(|| fields[0].to_owned());
+            pending = None;
+            continue;
+        }
+        let Some(current) = output.as_deref() else {
+            continue;
+        };
+        let indented_once = !line[1..].starts_with(' ');
+        if indented_once {
+            pending = None;
+            // ` *(.text .text.*)` patterns and ` *fill*` padding.
+            if fields[0].starts_with('*') {
+                continue;
+            }
+            match fields.as_slice() {
+                [name] => pending = Some((*name).to_owned()),
+                [name, address, size, file @ ..] => {
+                    push_gnu(&mut sections, current, name, address, size, file);
+                }
+                _ => {}
+            }
+            continue;
+        }
+        match fields.as_slice() {
+            [address, size, file @ ..] if pending.is_some() && parse_hex(size).is_some() => {
+                let name = pending.take().unwrap_or_default();
+                push_gnu(&mut sections, current, &name, address, size, file);
+            }
+            [address, ..] => {
+                // Symbol names may be demangled (`greet::hello()`), so
+                // the name is the rest of the line, spaces included.
+                let name = line.trim_start()[address.len()..].trim();
+                if let (Some(address), Some(last)) = (parse_hex(address), sections.last_mut())
+                    && last.output_section == current
+                    && is_symbol_name(name)
+                {
+                    last.symbols.push((address, name.to_owned()));
+                }
+            }
+            _ => {}
+        }
+    }
+    sections
+}
+
+fn push_gnu(
+    sections: &mut Vec<InputSection>,
+    output: &str,
+    name: &str,
+    address: &str,
+    size: &str,
+    file: &[&str],
+) {
+    let (Some(address), Some(size)) = (parse_hex(address), parse_hex(size)) else {
+        return;
+    };
+    if size == 0 {
+        return;
+    }
+    let file = file.join(" ");
+    sections.push(InputSection {
+        output_section: output.to_owned(),
+        name: name.to_owned(),
+        file: if file.is_empty() {
+            InputFile::Linker
+        } else {
+            classify_file(&file)
+        },
+        address,
+        size,
+        symbols: Vec::new(),
+    });
+}
+
+fn parse_lld(header: &str, text: &str) -> Option<Vec<InputSection>> {
+    let out_col = header.find(" Out ")? + 1;
+    let in_col = header.find(" In ")? + 1;
+    let symbol_col = header.find("Symbol")?;
+    // Newer LLD prints `VMA LMA Size Align`; older releases print
+    // `Address Size Align`.
+    let size_field = if header.contains("LMA") { 2 } else { 1 };
+    let mut sections: Vec<InputSection> = Vec::new();
+    let mut output: Option<String> = None;
+    for line in text.lines().skip_while(|line| *line != header).skip(1) {
+        if line.len() <= out_col || !line.is_char_boundary(out_col) {
+            continue;
+        }
+        let (numbers, rest) = line.split_at(out_col);
+        let numbers: Vec<&str> = numbers.split_whitespace().collect();
+        let (Some(address), Some(size)) = (
+            numbers
+                .first()
+                .and_then(|n| u64::from_str_radix(n, 16).ok()),
+            numbers
+                .get(size_field)
+                .and_then(|n| u64::from_str_radix(n, 16).ok()),
+        ) else {
+            continue;
+        };
+        let indent = out_col + (rest.len() - rest.trim_start().len());
+        let text = rest.trim();
+        if indent < in_col {
+            output = Some(text.to_owned());
+        } else if indent < symbol_col {
+            let Some(current) = output.as_deref() else {
+                continue;
+            };
+            if size == 0 {
+                continue;
+            }
+            // `<file>:(<section>)`; the file may itself contain `:`.
+            let Some((file, name)) = text
+                .rsplit_once(":(")
+                .and_then(|(file, rest)| Some((file, rest.strip_suffix(')')?)))
+            else {
+                continue;
+            };
+            sections.push(InputSection {
+                output_section: current.to_owned(),
+                name: name.to_owned(),
+                file: if file.starts_with('<') {
+                    InputFile::Linker
+                } else {
+                    classify_file(file)
+                },
+                address,
+                size,
+                symbols: Vec::new(),
+            });
+        } else if let Some(last) = sections.last_mut()
+            && output.as_deref() == Some(last.output_section.as_str())
+            && is_symbol_name(text)
+        {
+            last.symbols.push((address, text.to_owned()));
+        }
+    }
+    Some(sections)
+}
+
+/// Split `archive(member)` into its parts; anything else is an
+/// object path.
+fn classify_file(file: &str) -> InputFile {
+    if let Some(open) = file.rfind('(')
+        && let Some(member) = file[open + 1..].strip_suffix(')')
+        && open > 0
+    {
+        return InputFile::Member {
+            archive: file[..open].to_owned(),
+            member: member.to_owned(),
+        };
+    }
+    InputFile::Object(file.to_owned())
+}
+
+fn parse_hex(field: &str) -> Option<u64> {
+    u64::from_str_radix(field.strip_prefix("0x")?, 16).ok()
+}
+
+/// Linker-script assignments (`_edata = .`), `PROVIDE (...)` lines,
+/// GNU's `(size before relaxing)` notes and wrapped section sizes
+/// share the symbol column but are not symbols.
+fn is_symbol_name(name: &str) -> bool {
+    !name.is_empty()
+        && !name.starts_with("0x")
+        && !name.starts_with('(')
+        && !name.starts_with("PROVIDE")
+        && !name.starts_with("[!provide]")
+        && !name.contains(" = ")
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const GNU_MAP: &str = "\
+Archive member included to satisfy reference by file (symbol)
+
+/b/libgreet.a(greet.o)        /b/main.o (_ZN5greet5helloEv)
+
+Discarded input sections
+
+ .text          0x0000000000000000        0x0 /b/unused.o
+
+Memory Configuration
+
+Name             Origin             Length             Attributes
+*default*        0x0000000000000000 0xffffffffffffffff
+
+Linker script and memory map
+
+LOAD /usr/lib/crt1.o
+LOAD /b/main.o
+                0x0000000000400000                PROVIDE (__executable_start = SEGMENT_START (\"text-segment\", 0x400000))
+
+.text           0x0000000000401000      0x140
+ *(.text.unlikely .text.*_unlikely .text.unlikely.*)
+ .text          0x0000000000401000       0x30 /usr/lib/crt1.o
+                0x0000000000401000                _start
+ .text          0x0000000000401030       0x40 /b/main.o
+                0x0000000000000048                (size before relaxing)
+                0x0000000000401030                main
+                0x0000000000401050                helper(int)
+ *fill*         0x0000000000401070       0x10
+ .text._ZN5greet5helloEv
+                0x0000000000401080       0xc0 /b/libgreet.a(greet.o)
+                0x0000000000401080                _ZN5greet5helloEv
+
+.rodata         0x0000000000402000       0x20
+ .rodata        0x0000000000402000       0x20 /b/main.o
+
+.debug_info     0x0000000000000000      0x200
+ .debug_info    0x0000000000000000      0x200 /b/main.o
+                0x0000000000404018                _edata = .
+";
+
+    const LLD_MAP: &str = "
+             VMA              LMA     Size Align Out     In      Symbol
+          200000           200000       1c     1 .interp
+          200000           200000       1c     1         <internal>:(.interp)
+          201000           201000      100    16 .text
+          201000           201000       30     4         /usr/lib/crt1.o:(.text)
+          201000           201000        0     1                 _start
+          201030           201030       40    16         /b/main.o:(.text)
+          201030           201030        0     1                 main
+          201050           201050        0     1                 helper
+          201080           201080       c0    16         /b/libgreet.a(greet.o):(.text._ZN5greet5helloEv)
+          201080           201080        0     1                 _ZN5greet5helloEv
+               0                0      200     1 .debug_info
+               0                0      200     1         /b/main.o:(.debug_info)
+";
+
+    fn summary(sections: &[InputSection]) -> Vec<(String, String, u64, usize)> {
+        sections
+            .iter()
+            .map(|s| {
+                let file = match &s.file {
+                    InputFile::Object(path) => path.clone(),
+                    InputFile::Member { archive, member } => format!("{archive}[{member}]"),
+                    InputFile::Linker => "<linker>".to_owned(),
+                };
+                (s.output_section.clone(), file, s.size, s.symbols.len())
+            })
+            .collect()
+    }
+
+    #[test]
+    fn gnu_maps_yield_input_sections_with_their_symbols() {
+        let sections = parse(GNU_MAP).unwrap();
+        assert_eq!(
+            summary(&sections),
+            vec![
+                (".text".into(), "/usr/lib/crt1.o".into(), 0x30, 1),
+                (".text".into(), "/b/main.o".into(), 0x40, 2),
+                (".text".into(), "/b/libgreet.a[greet.o]".into(), 0xc0, 1),
+                (".rodata".into(), "/b/main.o".into(), 0x20, 0),
+                (".debug_info".into(), "/b/main.o".into(), 0x200, 0),
+            ]
+        );
+        // The wrapped section keeps its name; discarded sections and
+        // script assignments are not mistaken for contributions.
+        assert_eq!(sections[2].name, ".text._ZN5greet5helloEv");
+        assert_eq!(
+            sections[1].symbols,
+            vec![
+                (0x0040_1030, "main".into()),
+                (0x0040_1050, "helper(int)".into())
+            ]
+        );
+    }
+
+    #[test]
+    fn lld_maps_yield_the_same_contributions() {
+        let sections = parse(LLD_MAP).unwrap();
+        assert_eq!(
+            summary(&sections),
+            vec![
+                (".interp".into(), "<linker>".into(), 0x1c, 0),
+                (".text".into(), "/usr/lib/crt1.o".into(), 0x30, 1),
+                (".text".into(), "/b/main.o".into(), 0x40, 2),
+                (".text".into(), "/b/libgreet.a[greet.o]".into(), 0xc0, 1),
+                (".debug_info".into(), "/b/main.o".into(), 0x200, 0),
+            ]
+        );
+        assert_eq!(sections[3].name, ".text._ZN5greet5helloEv");
+    }
+
+    #[test]
+    fn other_layouts_are_unrecognized() {
+        assert_eq!(parse(""), None);
+        assert_eq!(
+            parse("# Path: /b/app\n# Arch: arm64\n# Object files:\n[  0] linker synthesized\n"),
+            None
+        );
+    }
+}
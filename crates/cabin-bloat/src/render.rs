@@ -0,0 +1,271 @@
+//! Text rendering of a `cabin bloat` report.
+//!
+//! Each executable prints a header with its totals, then a table
+//! per package, per target and per symbol.  Against a baseline the
+//! tables switch to deltas: only changed rows are listed, largest
+//! move first.
+
+use std::collections::{BTreeMap, BTreeSet};
+use std::fmt::Write as _;
+
+use crate::{BloatReport, ExecutableBloat, Sizes};
+
+/// Render `current` for the `cabin bloat` summary.  `top` bounds
+/// every table.  With a `baseline` report the tables show the change
+/// against the same executable in it, or mark the executable new.
+#[must_use]
+pub fn render_executable(
+    current: &ExecutableBloat,
+    baseline: Option<&BloatReport>,
+    top: usize,
+) -> String {
+    let previous = baseline.and_then(|b| b.executable(&current.package, &current.target));
+    let totals = current.totals();
+    let mut out = format!("bloat {}:{}: ", current.package, current.target);
+    let columns = [
+        ("text", totals.text, previous.map(|p| p.totals().text)),
+        ("data", totals.data, previous.map(|p| p.totals().data)),
+        ("debug", totals.debug, previous.map(|p| p.totals().debug)),
+        ("other", totals.other, previous.map(|p| p.totals().other)),
+    ];
+    for (i, (label, now, before)) in columns.into_iter().enumerate() {
+        let sep = if i == 0 { "" } else { ", " };
+        let _ = write!(out, "{sep}{label} {}", format_size(now));
+        if let Some(before) = before {
+            let _ = write!(out, " ({})", format_delta(now, before));
+        }
+    }
+    if baseline.is_some() && previous.is_none() {
+        out.push_str(" [new]");
+    }
+    out.push('\n');
+
+    let tables = [
+        (
+            "package",
+            current.by_package(),
+            previous.map(ExecutableBloat::by_package),
+        ),
+        (
+            "target",
+            current.by_target(),
+            previous.map(ExecutableBloat::by_target),
+        ),
+        (
+            "symbol",
+            current.by_symbol(),
+            previous.map(ExecutableBloat::by_symbol),
+        ),
+    ];
+    for (heading, rows, before) in tables {
+        out.push('\n');
+        match before {
+            Some(before) => render_delta_table(&mut out, heading, &rows, &before, top),
+            None => render_table(&mut out, heading, &rows, top),
+        }
+    }
+    out
+}
+
+fn render_table(out: &mut String, heading: &str, rows: &BTreeMap<String, Sizes>, top: usize) {
+    let mut rows: Vec<(&String, &Sizes)> = rows
+        .iter()
+        .filter(|(_, sizes)| heading != "symbol" || sizes.loaded() > 0)
+        .collect();
+    rows.sort_by(|(a_name, a), (b_name, b)| {
+        (b.loaded(), b.total())
+            .cmp(&(a.loaded(), a.total()))
+            .then_with(|| a_name.cmp(b_name))
+    });
+    let _ = writeln!(
+        out,
+        "{:>12} {:>12} {:>12}  {heading}",
+        "text", "data", "debug"
+    );
+    for (name, sizes) in rows.iter().take(top) {
+        let _ = writeln!(
+            out,
+            "{:>12} {:>12} {:>12}  {name}",
+            format_size(sizes.text),
+            format_size(sizes.data),
+            format_size(sizes.debug),
+        );
+    }
+    push_elided(out, rows.len(), top);
+}
+
+fn render_delta_table(
+    out: &mut String,
+    heading: &str,
+    rows: &BTreeMap<String, Sizes>,
+    before: &BTreeMap<String, Sizes>,
+    top: usize,
+) {
+    let names: BTreeSet<&String> = rows.keys().chain(before.keys()).collect();
+    let mut changed: Vec<(&String, Sizes, Sizes)> = names
+        .into_iter()
+        .map(|name| {
+            let now = rows.get(name).copied().unwrap_or_default();
+            let then = before.get(name).copied().unwrap_or_default();
+            (name, now, then)
+        })
+        .filter(|(_, now, then)| now != then)
+        .collect();
+    changed.sort_by(|(a_name, a_now, a_then), (b_name, b_now, b_then)| {
+        let moved = |now: &Sizes, then: &Sizes| {
+            (
+                now.loaded().abs_diff(then.loaded()),
+                now.total().abs_diff(then.total()),
+            )
+        };
+        moved(b_now, b_then)
+            .cmp(&moved(a_now, a_then))
+            .then_with(|| a_name.cmp(b_name))
+    });
+    let _ = writeln!(
+        out,
+        "{:>12} {:>12} {:>12}  {heading}",
+        "text", "data", "debug"
+    );
+    if changed.is_empty() {
+        let _ = writeln!(out, "{:>12}  no changes", "");
+        return;
+    }
+    for (name, now, then) in changed.iter().take(top) {
+        let _ = writeln!(
+            out,
+            "{:>12} {:>12} {:>12}  {name}",
+            format_delta(now.text, then.text),
+            format_delta(now.data, then.data),
+            format_delta(now.debug, then.debug),
+        );
+    }
+    push_elided(out, changed.len(), top);
+}
+
+fn push_elided(out: &mut String, rows: usize, top: usize) {
+    if rows > top {
+        let _ = writeln!(out, "{:>12}  ... and {} more", "", rows - top);
+    }
+}
+
+/// Format a byte count with a binary unit that keeps the number
+/// readable (`512 B`, `1.50 KiB`, `3.25 MiB`).
+#[must_use]
+pub fn format_size(bytes: u64) -> String {
+    const KIB: u64 = 1024;
+    const MIB: u64 = KIB * 1024;
+    const GIB: u64 = MIB * 1024;
+    // Integer arithmetic keeps every byte count exact; two decimals
+    // are truncated, not rounded.
+    let scaled =
+        |unit: u64, name: &str| format!("{}.{:02} {name}", bytes / unit, bytes % unit * 100 / unit);
+    if bytes >= GIB {
+        scaled(GIB, "GiB")
+    } else if bytes >= MIB {
+        scaled(MIB, "MiB")
+    } else if bytes >= KIB {
+        scaled(KIB, "KiB")
+    } else {
+        format!("{bytes} B")
+    }
+}
+
+fn format_delta(now: u64, before: u64) -> String {
+    if now >= before {
+        format!("+{}", format_size(now - before))
+    } else {
+        format!("-{}", format_size(before - now))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::SymbolSize;
+
+    fn symbol(target: &str, name: &str, text: u64, debug: u64) -> SymbolSize {
+        SymbolSize {
+            package: "demo".into(),
+            target: target.into(),
+            symbol: name.into(),
+            sizes: Sizes {
+                text,
+                debug,
+                ..Sizes::default()
+            },
+        }
+    }
+
+    fn app(symbols: Vec<SymbolSize>) -> ExecutableBloat {
+        ExecutableBloat {
+            package: "demo".into(),
+            target: "app".into(),
+            symbols,
+        }
+    }
+
+    #[test]
+    fn sizes_use_binary_units_without_rounding_up() {
+        assert_eq!(format_size(0), "0 B");
+        assert_eq!(format_size(1023), "1023 B");
+        assert_eq!(format_size(1536), "1.50 KiB");
+        assert_eq!(format_size(1024 * 1024 - 1), "1023.99 KiB");
+        assert_eq!(format_size(3 * 1024 * 1024 + 256 * 1024), "3.25 MiB");
+        assert_eq!(format_delta(10, 4), "+6 B");
+        assert_eq!(format_delta(4, 10), "-6 B");
+    }
+
+    #[test]
+    fn tables_rank_by_loaded_size_and_honour_top() {
+        let current = app(vec![
+            symbol("app", "main", 64, 0),
+            symbol("greet", "hello()", 512, 0),
+            symbol("greet", "[.debug_info]", 0, 4096),
+            symbol("app", "tiny", 8, 0),
+        ]);
+        let rendered = render_executable(&current, None, 2);
+        assert!(
+            rendered
+                .starts_with("bloat demo:app: text 584 B, data 0 B, debug 4.00 KiB, other 0 B\n"),
+            "{rendered}"
+        );
+        let symbols = rendered.split("  symbol\n").nth(1).unwrap();
+        let lines: Vec<&str> = symbols.lines().collect();
+        assert!(lines[0].ends_with("hello() (demo:greet)"), "{rendered}");
+        assert!(lines[1].ends_with("main (demo:app)"), "{rendered}");
+        // Debug-only rows never make the symbol table.
+        assert!(lines[2].ends_with("... and 1 more"), "{rendered}");
+        assert!(rendered.contains("  demo:greet\n"), "{rendered}");
+    }
+
+    #[test]
+    fn baseline_tables_list_only_changed_rows() {
+        let before = BloatReport {
+            executables: vec![app(vec![
+                symbol("app", "main", 64, 0),
+                symbol("greet", "hello()", 512, 0),
+            ])],
+        };
+        let current = app(vec![
+            symbol("app", "main", 64, 0),
+            symbol("greet", "hello()", 1024, 0),
+            symbol("greet", "added()", 16, 0),
+        ]);
+        let rendered = render_executable(&current, Some(&before), 10);
+        assert!(
+            rendered.starts_with("bloat demo:app: text 1.07 KiB (+528 B), data 0 B (+0 B),"),
+            "{rendered}"
+        );
+        let symbols = rendered.split("  symbol\n").nth(1).unwrap();
+        let lines: Vec<&str> = symbols.lines().collect();
+        assert_eq!(lines.len(), 2, "{rendered}");
+        assert!(lines[0].trim_start().starts_with("+512 B"), "{rendered}");
+        assert!(lines[1].ends_with("added() (demo:greet)"), "{rendered}");
+
+        let unchanged = render_executable(&before.executables[0], Some(&before), 10);
+        assert!(unchanged.contains("no changes"), "{unchanged}");
+        let other = BloatReport::default();
+        assert!(render_executable(&current, Some(&other), 10).contains("[new]"));
+    }
+}
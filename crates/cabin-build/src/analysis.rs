@@ -0,0 +1,468 @@
+//! Build-graph cost model for `cabin build --analyze`.
+//!
+//! [`analyze`] weighs every action of a planned [`BuildGraph`] with a
+//! caller-supplied duration - in practice the last recorded run from
+//! Ninja's log - and answers how many cores the build can use:
+//!
+//! - the *total work*, the sum of every action's duration, is the
+//!   single-job build time;
+//! - the *critical path*, the heaviest dependency chain, is the build
+//!   time with unlimited jobs;
+//! - the *speedup curve* replays the graph under a list scheduler for
+//!   1, 2, … jobs, always starting the ready action with the longest
+//!   remaining chain first, until adding a job no longer shortens the
+//!   build.
+//!
+//! Actions without a recorded duration are charged the median of the
+//! recorded durations of the same kind and flagged as estimated, so a
+//! partially stale history still yields a usable model.
+
+use std::cmp::Reverse;
+use std::collections::{BTreeMap, BinaryHeap, HashMap};
+use std::time::Duration;
+
+use camino::{Utf8Path, Utf8PathBuf};
+
+use cabin_driver::{BuildAction, CompileMode};
+
+use crate::graph::{ArtifactOwner, BuildGraph};
+
+/// Most jobs the speedup curve is replayed for.
+pub const MAX_ANALYZED_JOBS: usize = 256;
+
+/// The cost model of one planned build.
+#[derive(Debug, Clone, PartialEq)]
+pub struct BuildAnalysis {
+    /// Every action, in graph order, with its charged duration.
+    pub actions: Vec<ActionCost>,
+    /// Sum of every action's duration: the one-job build time.
+    pub total_work: Duration,
+    /// Length of the heaviest dependency chain: the build time with
+    /// unlimited jobs.
+    pub critical_path: Duration,
+    /// Indices into [`Self::actions`] of the critical path, first
+    /// action first.
+    pub critical_actions: Vec<usize>,
+    /// Replayed build time for 1, 2, … jobs, ending at the first job
+    /// count that reaches the critical path (or at
+    /// [`MAX_ANALYZED_JOBS`]).
+    pub speedup: Vec<SpeedupPoint>,
+}
+
+/// One action of the analyzed graph.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ActionCost {
+    /// `compile`, `check`, `archive` or `link`.
+    pub kind: &'static str,
+    /// The action's primary output, as the backend names it.
+    pub output: Utf8PathBuf,
+    /// Package and target that own the output, when the planner
+    /// recorded one.
+    pub owner: Option<ArtifactOwner>,
+    /// Charged duration.
+    pub duration: Duration,
+    /// Whether `duration` is an estimate rather than a recorded run.
+    pub estimated: bool,
+}
+
+/// Replayed build time at one job count.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct SpeedupPoint {
+    /// Parallel job slots.
+    pub jobs: usize,
+    /// Replayed build time with that many slots.
+    pub makespan: Duration,
+}
+
+impl BuildAnalysis {
+    /// Average parallelism, `total_work / critical_path`: the job
+    /// count beyond which extra cores cannot help on average.
+    #[must_use]
+    pub fn parallelism(&self) -> f64 {
+        ratio(self.total_work, self.critical_path)
+    }
+
+    /// Number of actions charged an estimated duration.
+    #[must_use]
+    pub fn estimated(&self) -> usize {
+        self.actions.iter().filter(|a| a.estimated).count()
+    }
+}
+
+impl SpeedupPoint {
+    /// Speedup over a one-job build of `total_work`.
+    #[must_use]
+    pub fn speedup(&self, total_work: Duration) -> f64 {
+        ratio(total_work, self.makespan)
+    }
+}
+
+fn ratio(numerator: Duration, denominator: Duration) -> f64 {
+    if denominator.is_zero() {
+        1.0
+    } else {
+        numerator.as_secs_f64() / denominator.as_secs_f64()
+    }
+}
+
+/// Build the cost model of `graph`, charging each action
+/// `recorded(output)` when it returns a duration.
+#[must_use]
+pub fn analyze(
+    graph: &BuildGraph,
+    recorded: impl Fn(&Utf8Path) -> Option<Duration>,
+) -> BuildAnalysis {
+    let mut actions: Vec<ActionCost> = graph
+        .actions
+        .iter()
+        .map(|action| {
+            let (kind, output) = kind_and_output(action);
+            let duration = recorded(output);
+            ActionCost {
+                kind,
+                output: output.to_owned(),
+                owner: owner_of(graph, action),
+                duration: duration.unwrap_or_default(),
+                estimated: duration.is_none(),
+            }
+        })
+        .collect();
+    charge_estimates(&mut actions);
+
+    let deps = dependencies(graph);
+    let durations: Vec<Duration> = actions.iter().map(|a| a.duration).collect();
+    let (critical_path, critical_actions) = critical_path(&deps, &durations);
+    let total_work: Duration = durations.iter().sum();
+
+    let tails = tails(&deps, &durations);
+    let mut speedup = Vec::new();
+    for jobs in 1..=MAX_ANALYZED_JOBS.min(durations.len().max(1)) {
+        let makespan = replay(&deps, &durations, &tails, jobs);
+        speedup.push(SpeedupPoint { jobs, makespan });
+        if makespan <= critical_path {
+            break;
+        }
+    }
+
+    BuildAnalysis {
+        actions,
+        total_work,
+        critical_path,
+        critical_actions,
+        speedup,
+    }
+}
+
+fn kind_and_output(action: &BuildAction) -> (&'static str, &Utf8Path) {
+    match action {
+        BuildAction::Compile(compile) => match &compile.mode {
+            CompileMode::Object => ("compile", &compile.object),
+            CompileMode::SyntaxOnly { stamp } => ("check", stamp),
+        },
+        BuildAction::Archive(archive) => ("archive", &archive.output),
+        BuildAction::Link(link) => ("link", &link.output),
+    }
+}
+
+fn owner_of(graph: &BuildGraph, action: &BuildAction) -> Option<ArtifactOwner> {
+    // A syntax-only compile keeps its would-be object path, which is
+    // what the planner recorded the owner under.
+    let key = match action {
+        BuildAction::Compile(compile) => &compile.object,
+        BuildAction::Archive(archive) => &archive.output,
+        BuildAction::Link(link) => &link.output,
+    };
+    graph.artifact_owners.get(key).cloned()
+}
+
+/// Charge every unrecorded action the median recorded duration of its
+/// kind, falling back to the median over every kind.
+fn charge_estimates(actions: &mut [ActionCost]) {
+    let mut by_kind: BTreeMap<&'static str, Vec<Duration>> = BTreeMap::new();
+    let mut all: Vec<Duration> = Vec::new();
+    for action in actions.iter().filter(|a| !a.estimated) {
+        by_kind
+            .entry(action.kind)
+            .or_default()
+            .push(action.duration);
+        all.push(action.duration);
+    }
+    let fallback = median(&mut all);
+    let medians: BTreeMap<&'static str, Duration> = by_kind
+        .into_iter()
+        .map(|(kind, mut samples)| (kind, median(&mut samples)))
+        .collect();
+    for action in actions.iter_mut().filter(|a| a.estimated) {
+        action.duration = medians.get(action.kind).copied().unwrap_or(fallback);
+    }
+}
+
+fn median(samples: &mut [Duration]) -> Duration {
+    samples.sort_unstable();
+    samples.get(samples.len() / 2).copied().unwrap_or_default()
+}
+
+/// For each action, the indices of the earlier actions producing one
+/// of its inputs.
+fn dependencies(graph: &BuildGraph) -> Vec<Vec<usize>> {
+    let mut producer: HashMap<&Utf8Path, usize> = HashMap::new();
+    for (at, action) in graph.actions.iter().enumerate() {
+        let (_, output) = kind_and_output(action);
+        producer.insert(output, at);
+        if let BuildAction::Link(link) = action
+            && let Some(map) = &link.map_file
+        {
+            producer.insert(map, at);
+        }
+    }
+    graph
+        .actions
+        .iter()
+        .enumerate()
+        .map(|(at, action)| {
+            let inputs: Vec<&Utf8PathBuf> = match action {
+                BuildAction::Compile(compile) => std::iter::once(&compile.source)
+                    .chain(&compile.implicit_inputs)
+                    .collect(),
+                BuildAction::Archive(archive) => archive.inputs.iter().collect(),
+                BuildAction::Link(link) => {
+                    link.inputs.iter().chain(&link.implicit_inputs).collect()
+                }
+            };
+            let mut deps: Vec<usize> = inputs
+                .into_iter()
+                .filter_map(|input| producer.get(input.as_path()).copied())
+                // The graph is topologically ordered; anything else
+                // would be a cycle and is ignored.
+                .filter(|&dep| dep < at)
+                .collect();
+            deps.sort_unstable();
+            deps.dedup();
+            deps
+        })
+        .collect()
+}
+
+/// The heaviest chain through the graph, as its length and its
+/// action indices in execution order.
+fn critical_path(deps: &[Vec<usize>], durations: &[Duration]) -> (Duration, Vec<usize>) {
+    let mut finish: Vec<Duration> = Vec::with_capacity(durations.len());
+    let mut via: Vec<Option<usize>> = Vec::with_capacity(durations.len());
+    for (at, duration) in durations.iter().enumerate() {
+        let heaviest = deps[at].iter().copied().max_by_key(|&dep| finish[dep]);
+        finish.push(heaviest.map_or(Duration::ZERO, |dep| finish[dep]) + *duration);
+        via.push(heaviest);
+    }
+    let Some((last, length)) = finish
+        .iter()
+        .copied()
+        .enumerate()
+        .max_by_key(|&(_, length)| length)
+    else {
+        return (Duration::ZERO, Vec::new());
+    };
+    let mut chain = vec![last];
+    while let Some(prev) = via[*chain.last().expect("chain starts non-empty")] {
+        chain.push(prev);
+    }
+    chain.reverse();
+    (length, chain)
+}
+
+/// Each action's duration plus its heaviest chain of dependents - the
+/// scheduling priority of [`replay`].
+fn tails(deps: &[Vec<usize>], durations: &[Duration]) -> Vec<Duration> {
+    let mut tails: Vec<Duration> = durations.to_vec();
+    for at in (0..durations.len()).rev() {
+        for &dep in &deps[at] {
+            tails[dep] = tails[dep].max(durations[dep] + tails[at]);
+        }
+    }
+    tails
+}
+
+/// Simulated build time with `jobs` workers.  Whenever a worker is
+/// free, the ready action with the longest tail starts.
+fn replay(
+    deps: &[Vec<usize>],
+    durations: &[Duration],
+    tails: &[Duration],
+    jobs: usize,
+) -> Duration {
+    let mut dependents: Vec<Vec<usize>> = vec![Vec::new(); durations.len()];
+    let mut waiting: Vec<usize> = deps.iter().map(Vec::len).collect();
+    for (at, list) in deps.iter().enumerate() {
+        for &dep in list {
+            dependents[dep].push(at);
+        }
+    }
+    let mut ready: BinaryHeap<(Duration, Reverse<usize>)> = waiting
+        .iter()
+        .enumerate()
+        .filter(|&(_, &n)| n == 0)
+        .map(|(at, _)| (tails[at], Reverse(at)))
+        .collect();
+    let mut running: BinaryHeap<Reverse<(Duration, usize)>> = BinaryHeap::new();
+    let mut now = Duration::ZERO;
+    loop {
+        while running.len() < jobs
+            && let Some((_, Reverse(at))) = ready.pop()
+        {
+            running.push(Reverse((now + durations[at], at)));
+        }
+        let Some(Reverse((done, at))) = running.pop() else {
+            return now;
+        };
+        now = done;
+        for &next in &dependents[at] {
+            waiting[next] -= 1;
+            if waiting[next] == 0 {
+                ready.push((tails[next], Reverse(next)));
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::collections::BTreeSet;
+
+    use cabin_core::{CxxStandard, LanguageStandard, OptLevel, TargetArch};
+    use cabin_driver::{
+        ArchiveAction, ArchiveResponseFile, CompileAction, CompileArguments, Dialect, LinkAction,
+    };
+
+    fn compile(name: &str) -> BuildAction {
+        BuildAction::Compile(CompileAction {
+            standard: LanguageStandard::Cxx(CxxStandard::Cxx17),
+            gnu_extensions: false,
+            source: Utf8PathBuf::from(format!("/src/{name}.cc")),
+            object: Utf8PathBuf::from(format!("/b/{name}.o")),
+            mode: CompileMode::Object,
+            implicit_inputs: Vec::new(),
+            depfile: None,
+            compiler: Utf8PathBuf::from("c++"),
+            compiler_wrapper: None,
+            arguments: CompileArguments {
+                opt_level: OptLevel::O0,
+                debug_info: false,
+                define_ndebug: false,
+                target_cpu: None,
+                target_arch: TargetArch::X86_64,
+                include_dirs: Vec::new(),
+                system_include_dirs: Vec::new(),
+                defines: Vec::new(),
+                extra_flags: Vec::new(),
+            },
+            description: format!("CXX {name}.o"),
+        })
+    }
+
+    /// Four 1s compiles archived (1s) into a library that a 2s link
+    /// consumes together with a fifth, 3s, compile.
+    fn graph() -> (BuildGraph, BTreeMap<Utf8PathBuf, Duration>) {
+        let mut actions: Vec<BuildAction> = ["a", "b", "c", "d", "main"]
+            .into_iter()
+            .map(compile)
+            .collect();
+        actions.push(BuildAction::Archive(ArchiveAction {
+            archiver: Utf8PathBuf::from("ar"),
+            output: Utf8PathBuf::from("/b/libx.a"),
+            inputs: ["a", "b", "c", "d"]
+                .iter()
+                .map(|n| Utf8PathBuf::from(format!("/b/{n}.o")))
+                .collect(),
+            thin: false,
+            response_file: ArchiveResponseFile::Unsupported,
+            description: "AR libx.a".to_owned(),
+        }));
+        actions.push(BuildAction::Link(LinkAction {
+            linker: Utf8PathBuf::from("c++"),
+            output: Utf8PathBuf::from("/b/app"),
+            inputs: vec![
+                Utf8PathBuf::from("/b/main.o"),
+                Utf8PathBuf::from("/b/libx.a"),
+            ],
+            implicit_inputs: Vec::new(),
+            arguments: Vec::new(),
+            link_libs: Vec::new(),
+            map_file: None,
+            description: "LINK app".to_owned(),
+        }));
+        let secs = |s: u64| Duration::from_secs(s);
+        let history = BTreeMap::from([
+            (Utf8PathBuf::from("/b/a.o"), secs(1)),
+            (Utf8PathBuf::from("/b/b.o"), secs(1)),
+            (Utf8PathBuf::from("/b/c.o"), secs(1)),
+            (Utf8PathBuf::from("/b/main.o"), secs(3)),
+            (Utf8PathBuf::from("/b/libx.a"), secs(1)),
+            (Utf8PathBuf::from("/b/app"), secs(2)),
+        ]);
+        let graph = BuildGraph {
+            actions,
+            dialect: Dialect::GnuLike,
+            default_outputs: vec![Utf8PathBuf::from("/b/app")],
+            planned_packages: BTreeSet::new(),
+            compile_commands: Vec::new(),
+            standard_violations: Vec::new(),
+            standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::from([(
+                Utf8PathBuf::from("/b/main.o"),
+                ArtifactOwner {
+                    package: "app".to_owned(),
+                    target: "app".to_owned(),
+                },
+            )]),
+        };
+        (graph, history)
+    }
+
+    #[test]
+    fn critical_path_work_and_speedup_curve() {
+        let (graph, history) = graph();
+        let analysis = analyze(&graph, |output| history.get(output).copied());
+
+        // `d.o` has no history and is charged the 1s compile median.
+        assert_eq!(analysis.estimated(), 1);
+        assert_eq!(analysis.actions[3].duration, Duration::from_secs(1));
+        assert_eq!(analysis.total_work, Duration::from_secs(10));
+        // main.o (3s) -> app (2s) beats any x.o -> libx.a -> app chain.
+        assert_eq!(analysis.critical_path, Duration::from_secs(5));
+        let chain: Vec<&str> = analysis
+            .critical_actions
+            .iter()
+            .map(|&at| analysis.actions[at].output.as_str())
+            .collect();
+        assert_eq!(chain, ["/b/main.o", "/b/app"]);
+        assert_eq!(
+            analysis.actions[4]
+                .owner
+                .as_ref()
+                .map(|o| o.target.as_str()),
+            Some("app")
+        );
+
+        let makespans: Vec<(usize, u64)> = analysis
+            .speedup
+            .iter()
+            .map(|p| (p.jobs, p.makespan.as_secs()))
+            .collect();
+        // One job does all the work.  Two jobs start main.o (longest
+        // tail) beside the 1s compiles, which then serialize into
+        // the archive; three reach the 5s critical path and end the
+        // curve.
+        assert_eq!(makespans, [(1, 10), (2, 7), (3, 5)]);
+        assert!((analysis.parallelism() - 2.0).abs() < f64::EPSILON);
+    }
+
+    #[test]
+    fn empty_graph_is_empty_model() {
+        let (mut graph, _) = graph();
+        graph.actions.clear();
+        let analysis = analyze(&graph, |_| None);
+        assert_eq!(analysis.critical_path, Duration::ZERO);
+        assert!(analysis.critical_actions.is_empty());
+        assert_eq!(analysis.speedup.len(), 1);
+    }
+}
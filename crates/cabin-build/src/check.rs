@@ -6,12 +6,19 @@
 //! [`CompileMode`] to [`CompileMode::SyntaxOnly`] semantically, and
 //! the dialect lowering (`cabin-ninja` via [`cabin_driver::lower()`])
 //! renders it through the `c_check` / `cxx_check` rules.
+//!
+//! A build can also satisfy a later check: [`compile_fingerprint`]
+//! identifies the arguments a translation unit compiles with in either
+//! mode, and [`without_satisfied_checks`] drops the checks whose
+//! object the caller found up to date under the same fingerprint.
 
+use std::collections::{BTreeMap, BTreeSet};
 use std::path::PathBuf;
 
 use camino::{Utf8Path, Utf8PathBuf};
+use sha2::{Digest, Sha256};
 
-use cabin_driver::{BuildAction, CompileMode};
+use cabin_driver::{BuildAction, CompileAction, CompileMode, Dialect};
 
 use crate::graph::BuildGraph;
 
@@ -91,19 +98,115 @@ pub fn into_check_graph(graph: BuildGraph, selected_pkg_dirs: &[PathBuf]) -> Bui
         // resolved dependency graph, not planned compiles, so the
         // check rewrite's compile pruning does not apply to them.
         standard_compat_violations: graph.standard_compat_violations,
+        // Provenance stays complete; it is only consulted for
+        // artifacts a graph actually produces.
+        artifact_owners: graph.artifact_owners,
     }
 }
 
+/// Fingerprint of the arguments `compile` runs with, taken in
+/// [`CompileMode::Object`] form so a build's compile and a check's
+/// syntax-only compile of the same translation unit agree exactly when
+/// everything but the mode does.  The compiler wrapper is left out: a
+/// launcher such as `ccache` does not change what the compiler sees.
+#[must_use]
+pub fn compile_fingerprint(dialect: Dialect, compile: &CompileAction) -> String {
+    let mut object_mode = compile.clone();
+    object_mode.mode = CompileMode::Object;
+    let argv = cabin_driver::compile_argv(dialect, &object_mode).join("\0");
+    cabin_core::hash::hex_digest(&Sha256::digest(argv))
+}
+
+/// The object compiles a Ninja run of `graph` performs: every
+/// [`CompileMode::Object`] compile reachable from the default outputs
+/// through action inputs.
+#[must_use]
+pub fn default_compiles(graph: &BuildGraph) -> Vec<&CompileAction> {
+    let producer: BTreeMap<&Utf8Path, &BuildAction> = graph
+        .actions
+        .iter()
+        .map(|action| {
+            let output = match action {
+                BuildAction::Compile(compile) => compile.object.as_path(),
+                BuildAction::Archive(archive) => archive.output.as_path(),
+                BuildAction::Link(link) => link.output.as_path(),
+            };
+            (output, action)
+        })
+        .collect();
+    let mut seen = BTreeSet::new();
+    let mut pending: Vec<&Utf8Path> = graph
+        .default_outputs
+        .iter()
+        .map(Utf8PathBuf::as_path)
+        .collect();
+    let mut compiles = Vec::new();
+    while let Some(output) = pending.pop() {
+        let Some(action) = producer.get(output).copied() else {
+            continue;
+        };
+        if !seen.insert(output) {
+            continue;
+        }
+        match action {
+            BuildAction::Compile(compile) => {
+                if compile.mode == CompileMode::Object {
+                    compiles.push(compile);
+                }
+            }
+            BuildAction::Archive(archive) => {
+                pending.extend(archive.inputs.iter().map(Utf8PathBuf::as_path));
+            }
+            BuildAction::Link(link) => {
+                pending.extend(
+                    link.inputs
+                        .iter()
+                        .chain(&link.implicit_inputs)
+                        .map(Utf8PathBuf::as_path),
+                );
+            }
+        }
+    }
+    compiles
+}
+
+/// Drop from a check graph every syntax-only compile `satisfied`
+/// accepts, along with its stamp's default target.  `cabin check`
+/// accepts the compiles whose object a previous build left up to date
+/// under the same [`compile_fingerprint`]: that build already compiled
+/// exactly what the check would, so there is nothing left to report.
+#[must_use]
+pub fn without_satisfied_checks(
+    mut graph: BuildGraph,
+    mut satisfied: impl FnMut(&CompileAction) -> bool,
+) -> BuildGraph {
+    let mut dropped = BTreeSet::new();
+    graph.actions.retain(|action| match action {
+        BuildAction::Compile(compile) => match &compile.mode {
+            CompileMode::SyntaxOnly { stamp } if satisfied(compile) => {
+                dropped.insert(stamp.clone());
+                false
+            }
+            _ => true,
+        },
+        _ => true,
+    });
+    graph
+        .default_outputs
+        .retain(|output| !dropped.contains(output));
+    graph
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
     use crate::graph::CompileCommand;
-    use cabin_core::{OptLevel, SourceLanguage};
+    use cabin_core::{OptLevel, SourceLanguage, TargetArch};
     use cabin_driver::{
-        ArchiveAction, CompileAction, CompileArguments, Dialect, LinkAction, LoweredActionKind,
-        lower,
+        ArchiveAction, ArchiveResponseFile, CompileAction, CompileArguments, Dialect, LinkAction,
+        LoweredActionKind, lower,
     };
-    use std::collections::BTreeSet;
+    use std::collections::{BTreeMap, BTreeSet};
 
     fn compile(language: SourceLanguage, object: &str) -> BuildAction {
         let depfile = format!("{object}.d");
@@ -127,6 +230,8 @@ mod tests {
                 opt_level: OptLevel::O0,
                 debug_info: false,
                 define_ndebug: false,
+                target_cpu: None,
+                target_arch: TargetArch::X86_64,
                 include_dirs: vec![],
                 system_include_dirs: vec![],
                 defines: vec![],
@@ -141,6 +246,8 @@ mod tests {
             archiver: Utf8PathBuf::from("/usr/bin/ar"),
             output: Utf8PathBuf::from(lib),
             inputs: vec![Utf8PathBuf::from(object_input)],
+            thin: false,
+            response_file: ArchiveResponseFile::Unsupported,
             description: format!("AR {lib}"),
         })
     }
@@ -153,6 +260,7 @@ mod tests {
             implicit_inputs: vec![],
             arguments: vec![],
             link_libs: vec![],
+            map_file: None,
             description: format!("LINK {exe}"),
         })
     }
@@ -167,6 +275,7 @@ mod tests {
             compile_commands: Vec::<CompileCommand>::new(),
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         };
         let out = into_check_graph(graph, &[PathBuf::from("/b/dev/packages/app")]);
@@ -234,6 +343,7 @@ mod tests {
             compile_commands: Vec::<CompileCommand>::new(),
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         };
         let out = into_check_graph(graph, &[PathBuf::from("/b/dev/packages/app")]);
@@ -257,6 +367,7 @@ mod tests {
             compile_commands: Vec::<CompileCommand>::new(),
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         };
         let out = into_check_graph(graph, &[PathBuf::from("/b/dev/packages/app")]);
@@ -284,6 +395,7 @@ mod tests {
             compile_commands: Vec::<CompileCommand>::new(),
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         };
         let out = into_check_graph(graph, &[PathBuf::from("/b/dev/packages/app")]);
@@ -309,6 +421,7 @@ mod tests {
             compile_commands: Vec::<CompileCommand>::new(),
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         };
         let out = into_check_graph(graph, &[PathBuf::from("/b/dev/packages/app")]);
@@ -341,6 +454,7 @@ mod tests {
             compile_commands: vec![cc.clone()],
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         };
         let out = into_check_graph(graph, &[]);
@@ -369,6 +483,7 @@ mod tests {
                 violation("/abs/build/dev/packages/app/app/exotic.o"),
             ],
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         };
         let selected = vec![PathBuf::from("/abs/build/dev/packages/app")];
@@ -383,4 +498,97 @@ mod tests {
         );
         assert!(crate::validate_planned_standards(&checked).is_err());
     }
+
+    /// The build's object compile and the check's syntax-only compile
+    /// of one translation unit share a fingerprint; any argument
+    /// change moves it, a compiler wrapper does not.
+    #[test]
+    fn fingerprint_ignores_mode_and_wrapper_but_not_arguments() {
+        let object = "/b/dev/packages/app/obj/app/src/a.cc.o";
+        let BuildAction::Compile(build) = compile(SourceLanguage::Cxx, object) else {
+            unreachable!("compile builds a compile action");
+        };
+        let graph = BuildGraph {
+            dialect: Dialect::GnuLike,
+            actions: vec![BuildAction::Compile(build.clone())],
+            default_outputs: vec![],
+            compile_commands: Vec::<CompileCommand>::new(),
+            standard_violations: Vec::new(),
+            standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
+            planned_packages: BTreeSet::default(),
+        };
+        let checked = into_check_graph(graph, &[PathBuf::from("/b/dev/packages/app")]);
+        let BuildAction::Compile(check) = &checked.actions[0] else {
+            panic!("expected a compile action");
+        };
+        let fingerprint = compile_fingerprint(Dialect::GnuLike, &build);
+        assert_eq!(compile_fingerprint(Dialect::GnuLike, check), fingerprint);
+
+        let mut wrapped = build.clone();
+        wrapped.compiler_wrapper = Some(Utf8PathBuf::from("/usr/local/bin/ccache"));
+        assert_eq!(compile_fingerprint(Dialect::GnuLike, &wrapped), fingerprint);
+
+        let mut defined = build;
+        defined.arguments.defines.push("FOO".to_owned());
+        assert_ne!(compile_fingerprint(Dialect::GnuLike, &defined), fingerprint);
+    }
+
+    #[test]
+    fn drops_satisfied_checks_and_their_stamps() {
+        let kept = "/b/dev/packages/app/obj/app/src/a.cc.o";
+        let satisfied = "/b/dev/packages/app/obj/app/src/b.cc.o";
+        let graph = BuildGraph {
+            dialect: Dialect::GnuLike,
+            actions: vec![
+                compile(SourceLanguage::Cxx, kept),
+                compile(SourceLanguage::Cxx, satisfied),
+            ],
+            default_outputs: vec![],
+            compile_commands: Vec::<CompileCommand>::new(),
+            standard_violations: Vec::new(),
+            standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
+            planned_packages: BTreeSet::default(),
+        };
+        let checked = into_check_graph(graph, &[PathBuf::from("/b/dev/packages/app")]);
+        let out = without_satisfied_checks(checked, |c| c.object == satisfied);
+        assert_eq!(out.actions.len(), 1);
+        assert_eq!(
+            out.default_outputs,
+            vec![Utf8PathBuf::from(format!("{kept}.check"))]
+        );
+    }
+
+    #[test]
+    fn default_compiles_follow_inputs_from_the_default_outputs() {
+        let linked = "/b/dev/packages/app/obj/app/src/a.cc.o";
+        let archived = "/b/dev/packages/app/obj/lib/src/l.cc.o";
+        let orphan = "/b/dev/packages/app/obj/other/src/o.cc.o";
+        let graph = BuildGraph {
+            dialect: Dialect::GnuLike,
+            actions: vec![
+                compile(SourceLanguage::Cxx, linked),
+                compile(SourceLanguage::Cxx, archived),
+                compile(SourceLanguage::Cxx, orphan),
+                archive(archived, "/b/dev/packages/app/liblib.a"),
+                link(linked, "/b/dev/packages/app/app"),
+            ],
+            default_outputs: vec![
+                Utf8PathBuf::from("/b/dev/packages/app/app"),
+                Utf8PathBuf::from("/b/dev/packages/app/liblib.a"),
+            ],
+            compile_commands: Vec::<CompileCommand>::new(),
+            standard_violations: Vec::new(),
+            standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
+            planned_packages: BTreeSet::default(),
+        };
+        let mut objects: Vec<&str> = default_compiles(&graph)
+            .into_iter()
+            .map(|c| c.object.as_str())
+            .collect();
+        objects.sort_unstable();
+        assert_eq!(objects, [linked, archived]);
+    }
 }
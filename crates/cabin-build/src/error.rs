@@ -57,7 +57,7 @@ pub enum BuildError {
     /// did not activate dev-deps for the owning package (`cabin
     /// test` activates them for the selected packages only).
     #[error(
-        "dependency {dep:?} is declared under `[dev-dependencies]` of package {package:?} but is not active here; dev dependencies link only into `test` / `example` targets, and only `cabin test` activates them for the selected packages"
+        "dependency {dep:?} is declared under `[dev-dependencies]` of package {package:?} but is not active here; dev dependencies link only into `test` / `example` / `bench` targets, and only `cabin test` and `cabin bench` activate them for the selected packages"
     )]
     DevDependencyNotActive { dep: String, package: String },
 
@@ -1,3 +1,5 @@
+use std::collections::BTreeMap;
+
 use cabin_core::StandardFlagConflict;
 use camino::Utf8PathBuf;
 
@@ -51,6 +53,21 @@ pub struct BuildGraph {
     /// rewrite carries them through unchanged (they describe
     /// resolved edges, not planned compiles).
     pub standard_compat_violations: Vec<StandardCompatViolation>,
+    /// Planner provenance of every object, static archive and
+    /// executable the graph produces: the package and target whose
+    /// action writes it.  Lets post-build analysis (`cabin bloat`)
+    /// attribute a linker-map input back to the manifest target it
+    /// came from without re-deriving the output layout.
+    pub artifact_owners: BTreeMap<Utf8PathBuf, ArtifactOwner>,
+}
+
+/// Package and target that own a planned artifact.
+#[derive(Debug, Clone, PartialEq, Eq, PartialOrd, Ord)]
+pub struct ArtifactOwner {
+    /// Full package name.
+    pub package: String,
+    /// Manifest-declared target name.
+    pub target: String,
 }
 
 /// One standards problem recorded against a planned compile.  Each
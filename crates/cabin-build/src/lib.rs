@@ -18,11 +18,13 @@
     clippy::default_trait_access
 )]
 
+pub mod analysis;
 pub mod check;
 pub mod clean;
 pub mod error;
 pub mod graph;
 pub mod link_diagnostics;
+pub mod linker_map;
 pub mod planner;
 pub mod standard_compat;
 pub mod validate;
@@ -32,12 +34,19 @@ pub mod validate;
 // public surface (`BuildGraph`, `PlanRequest`) so consumers keep one
 // import path.  The lowering itself (`cabin_driver::lower`) is a
 // backend concern, consumed directly by `cabin-ninja`.
+pub use analysis::{ActionCost, BuildAnalysis, SpeedupPoint, analyze};
 pub use cabin_driver::{
-    ArchiveAction, BuildAction, CompileAction, CompileArguments, CompileMode, Dialect, LinkAction,
+    ArchiveAction, ArchiveResponseFile, BuildAction, CompileAction, CompileArguments, CompileMode,
+    Dialect, LinkAction,
+};
+pub use check::{
+    compile_fingerprint, default_compiles, into_check_graph, without_satisfied_checks,
 };
-pub use check::into_check_graph;
 pub use error::{BuildError, FeatureGateFix};
-pub use graph::{BuildGraph, CompileCommand, InterfaceViolationKind, StandardViolation};
+pub use graph::{
+    ArtifactOwner, BuildGraph, CompileCommand, InterfaceViolationKind, StandardViolation,
+};
+pub use linker_map::{linker_map_path, with_linker_maps};
 pub use planner::{
     ManifestTargetSelector, PlanRequest, plan, select_targets_of_kind,
     selector_required_features_met,
@@ -46,7 +55,8 @@ pub use standard_compat::{
     ClashingBound, DeclScope, DeclSite, EdgeRequirement, RequirementOrigin, StandardCompatViolation,
 };
 pub use validate::{
-    RequestedStandards, collect_requested_standards, msvc_external_includes_supported,
-    requested_standards_of, validate_planned_standards, validate_toolchain_for_backend,
-    validate_toolchain_standards,
+    RequestedStandards, archive_response_files, collect_requested_standards,
+    msvc_external_includes_supported, plans_archives, requested_standards_of,
+    thin_archives_supported, validate_planned_standards, validate_target_cpu,
+    validate_toolchain_for_backend, validate_toolchain_standards,
 };
@@ -0,0 +1,81 @@
+//! Opt-in linker maps.
+//!
+//! An ordinary build never asks the linker for a map.  `cabin
+//! bloat` rewrites its planned graph with [`with_linker_maps`] so
+//! every executable link also writes `<executable>.map`, which it
+//! then reads back together with [`crate::BuildGraph::artifact_owners`]
+//! to attribute output bytes to packages and targets.
+
+use camino::{Utf8Path, Utf8PathBuf};
+
+use cabin_driver::BuildAction;
+
+use crate::graph::BuildGraph;
+
+/// Linker map written beside `executable`.
+#[must_use]
+pub fn linker_map_path(executable: &Utf8Path) -> Utf8PathBuf {
+    Utf8PathBuf::from(format!("{executable}.map"))
+}
+
+/// Request a linker map from every link action in `graph`.  Compile
+/// and archive actions are untouched, so only the links re-run when
+/// a build switches maps on or off.
+#[must_use]
+pub fn with_linker_maps(mut graph: BuildGraph) -> BuildGraph {
+    for action in &mut graph.actions {
+        if let BuildAction::Link(link) = action {
+            link.map_file = Some(linker_map_path(&link.output));
+        }
+    }
+    graph
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::collections::{BTreeMap, BTreeSet};
+
+    use cabin_driver::{ArchiveAction, ArchiveResponseFile, Dialect, LinkAction};
+
+    #[test]
+    fn only_links_gain_a_map_beside_their_output() {
+        let graph = BuildGraph {
+            actions: vec![
+                BuildAction::Archive(ArchiveAction {
+                    archiver: Utf8PathBuf::from("ar"),
+                    output: Utf8PathBuf::from("/b/libgreet.a"),
+                    inputs: vec![Utf8PathBuf::from("/b/greet.o")],
+                    thin: false,
+                    response_file: ArchiveResponseFile::Unsupported,
+                    description: "AR /b/libgreet.a".to_owned(),
+                }),
+                BuildAction::Link(LinkAction {
+                    linker: Utf8PathBuf::from("c++"),
+                    output: Utf8PathBuf::from("/b/hello"),
+                    inputs: vec![Utf8PathBuf::from("/b/libgreet.a")],
+                    implicit_inputs: vec![],
+                    arguments: vec![],
+                    link_libs: vec![],
+                    map_file: None,
+                    description: "LINK /b/hello".to_owned(),
+                }),
+            ],
+            dialect: Dialect::GnuLike,
+            default_outputs: vec![Utf8PathBuf::from("/b/hello")],
+            planned_packages: BTreeSet::default(),
+            compile_commands: Vec::new(),
+            standard_violations: Vec::new(),
+            standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
+        };
+        let original = graph.clone();
+        let mapped = with_linker_maps(graph);
+        assert_eq!(mapped.actions[0], original.actions[0]);
+        let BuildAction::Link(link) = &mapped.actions[1] else {
+            panic!("expected the link to survive");
+        };
+        assert_eq!(link.map_file, Some(Utf8PathBuf::from("/b/hello.map")));
+        assert_eq!(mapped.default_outputs, original.default_outputs);
+    }
+}
@@ -1,5 +1,7 @@
 use crate::error::BuildError;
-use crate::graph::{BuildGraph, CompileCommand, InterfaceViolationKind, StandardViolation};
+use crate::graph::{
+    ArtifactOwner, BuildGraph, CompileCommand, InterfaceViolationKind, StandardViolation,
+};
 use cabin_core::{
     InterfaceStandardSource, LanguageStandard, Package, ResolvedCompilerWrapper,
     ResolvedLanguageStandards, ResolvedProfile, ResolvedProfileFlags, ResolvedToolchain,
@@ -7,12 +9,12 @@ use cabin_core::{
     link_driver_language,
 };
 use cabin_driver::{
-    ArchiveAction, BuildAction, CompileAction, CompileArguments, CompileMode, Dialect, LinkAction,
-    compile_argv,
+    ArchiveAction, ArchiveResponseFile, BuildAction, CompileAction, CompileArguments, CompileMode,
+    Dialect, LinkAction, compile_argv,
 };
 use cabin_workspace::PackageGraph;
 use camino::Utf8PathBuf;
-use std::collections::{BTreeSet, HashMap, HashSet};
+use std::collections::{BTreeMap, BTreeSet, HashMap, HashSet};
 use std::path::PathBuf;
 
 mod lowering;
@@ -122,6 +124,21 @@ pub struct PlanRequest<'a> {
     /// switch an old `cl` would reject.  Ignored by the GCC/Clang
     /// dialect, where `-isystem` is part of the base command line.
     pub msvc_external_includes: bool,
+    /// Whether static libraries are written as thin archives.  The
+    /// CLI sets it from [`ResolvedProfile::thin_archives`] gated on
+    /// [`crate::thin_archives_supported`]; the MSVC dialect ignores
+    /// it.  Thin archives live under a `thin/` sub-directory so
+    /// toggling the setting never asks the archiver to convert an
+    /// existing archive in place, which `ar` refuses to do.
+    pub thin_archives: bool,
+    /// How the archiver reads `@file` response files, letting a
+    /// library with a very long object list archive through one.
+    /// The CLI sets it from [`crate::archive_response_files`].
+    pub archive_response_files: ArchiveResponseFile,
+    /// Architecture family of the detected C++ compiler
+    /// ([`cabin_core::CompilerIdentity::arch`]).  Decides how the
+    /// GCC/Clang dialect spells a named `target-cpu`.
+    pub target_arch: cabin_core::TargetArch,
     /// Per-package enabled feature names from the cross-package
     /// feature resolver, keyed by `graph.packages` index.  Gates
     /// targets that declare `required-features`: default
@@ -315,7 +332,9 @@ fn resolve_dependencies(
     // Post-resolution standard-compatibility check (spec D13 over
     // every resolved edge).  When the caller opts out (`cabin
     // tidy`), the planner's output is byte-for-byte what it was
-    // before the pass existed.
+    // before the pass existed.  The pass is not persisted across
+    // invocations: it is linear in targets and edges, and hashing
+    // its inputs for a cache key costs more than composing them.
     let standard_compat_violations = if req.standard_compat {
         crate::standard_compat::edge_violations(&topo, &resolved_deps, req)?
     } else {
@@ -369,6 +388,7 @@ fn emit_actions(
     // plus their reachable sets).  Drives the interface-standard
     // compatibility check.
     let mut transitive_deps: HashMap<TargetId, Vec<TargetId>> = HashMap::new();
+    let mut artifact_owners: BTreeMap<Utf8PathBuf, ArtifactOwner> = BTreeMap::new();
 
     for tid in &topo {
         let target = lookup_target(tid, req.graph)?;
@@ -523,6 +543,17 @@ fn emit_actions(
             &req.graph.packages[tid.0].package.language,
             target,
         );
+        // `[profile.<name>.package.<spec>]` overrides narrow the
+        // profile's opt-level / debug / assertions per package;
+        // `"*"` matches only packages outside the primary set.
+        let codegen = req.profile.codegen_for(
+            &pkg.package.name,
+            req.graph.primary_packages.contains(&tid.0),
+        );
+        let owner = ArtifactOwner {
+            package: pkg.package.name.as_str().to_owned(),
+            target: target.name.as_str().to_owned(),
+        };
         let mut objects: Vec<Utf8PathBuf> = Vec::with_capacity(prepared.len());
         for ps in &prepared {
             let depfile = depfile_path(&ps.object);
@@ -632,9 +663,11 @@ fn emit_actions(
                 compiler: dispatch.driver.to_path_buf(),
                 compiler_wrapper,
                 arguments: CompileArguments {
-                    opt_level: req.profile.opt_level,
-                    debug_info: req.profile.debug,
-                    define_ndebug: !req.profile.assertions,
+                    opt_level: codegen.opt_level,
+                    debug_info: codegen.debug,
+                    define_ndebug: !codegen.assertions,
+                    target_cpu: req.profile.target_cpu.clone(),
+                    target_arch: req.target_arch,
                     include_dirs: include_dirs.clone(),
                     system_include_dirs: system_include_dirs.clone(),
                     defines: defines.clone(),
@@ -656,6 +689,7 @@ fn emit_actions(
                     output: ps.object.clone(),
                 });
             }
+            artifact_owners.insert(ps.object.clone(), owner.clone());
             objects.push(ps.object.clone());
             actions.push(BuildAction::Compile(compile));
         }
@@ -676,19 +710,28 @@ fn emit_actions(
 
         match target.kind {
             TargetKind::Library => {
-                let lib_path =
-                    pkg_build_dir.join(req.dialect.static_library_name(target.name.as_str()));
+                let thin = req.thin_archives && req.dialect == Dialect::GnuLike;
+                let lib_dir = if thin {
+                    pkg_build_dir.join("thin")
+                } else {
+                    pkg_build_dir.clone()
+                };
+                let lib_path = lib_dir.join(req.dialect.static_library_name(target.name.as_str()));
                 actions.push(BuildAction::Archive(ArchiveAction {
                     archiver: req.toolchain.ar.path().to_path_buf(),
                     output: lib_path.clone(),
                     inputs: objects,
+                    thin,
+                    response_file: req.archive_response_files,
                     description: format!("AR {lib_path}"),
                 }));
+                artifact_owners.insert(lib_path.clone(), owner);
                 output_for_target.insert(tid.clone(), lib_path);
             }
             // Every executable kind takes the same link path:
             // `executable` (production binaries), `test`
-            // (run by `cabin test`), and `example`.  The build
+            // (run by `cabin test`), `bench` (run by `cabin bench`),
+            // and `example`.  The build
             // planner does not distinguish between them here because
             // the link/compile semantics are identical; the kind
             // difference is only consulted when deciding *which*
@@ -699,7 +742,7 @@ fn emit_actions(
             // drives the link with the C compiler, while one that
             // mixes in any `.cc` / `.cpp` source - directly or
             // transitively - drives the link with the C++ compiler.
-            TargetKind::Executable | TargetKind::Test | TargetKind::Example => {
+            TargetKind::Executable | TargetKind::Test | TargetKind::Example | TargetKind::Bench => {
                 let exe_path =
                     pkg_build_dir.join(req.dialect.executable_name(target.name.as_str()));
                 let lib_paths =
@@ -754,8 +797,10 @@ fn emit_actions(
                     implicit_inputs: Vec::new(),
                     arguments: link_arguments,
                     link_libs,
+                    map_file: None,
                     description: format!("LINK {exe_path}"),
                 }));
+                artifact_owners.insert(exe_path.clone(), owner);
                 output_for_target.insert(tid.clone(), exe_path);
             }
             TargetKind::HeaderOnly => {
@@ -783,6 +828,7 @@ fn emit_actions(
         compile_commands,
         standard_violations,
         standard_compat_violations,
+        artifact_owners,
     })
 }
 
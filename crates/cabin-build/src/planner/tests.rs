@@ -8,7 +8,8 @@ use super::lowering::promote_dir;
 use super::*;
 use cabin_core::{
     Dependency, DependencySource, Package, PackageName, ProfileDefinition, ProfileName,
-    ProfileSelection, ResolvedProfile, Target as CoreTarget, TargetName, resolve_profile,
+    ProfileSelection, ResolvedProfile, Target as CoreTarget, TargetArch, TargetName,
+    resolve_profile,
 };
 use cabin_workspace::{PackageGraph, PackageKind, WorkspacePackage};
 use camino::Utf8PathBuf;
@@ -134,6 +135,8 @@ fn target(name: &str, kind: TargetKind, sources: &[&str], deps: &[&str]) -> Core
             .collect(),
         required_features: Vec::new(),
         language: language_for_sources(sources),
+        data: Vec::new(),
+        harness: None,
     }
 }
 
@@ -156,6 +159,8 @@ fn target_with_includes(
             .collect(),
         required_features: Vec::new(),
         language: language_for_sources(sources),
+        data: Vec::new(),
+        harness: None,
     }
 }
 
@@ -234,6 +239,9 @@ fn plan_request<'a>(
         compiler_wrapper: None,
         dialect: Dialect::GnuLike,
         msvc_external_includes: true,
+        thin_archives: false,
+        archive_response_files: ArchiveResponseFile::Unsupported,
+        target_arch: TargetArch::X86_64,
         enabled_features: None,
         standard_compat: false,
     }
@@ -517,6 +525,50 @@ fn plans_library_then_executable_within_one_package() {
     );
 }
 
+#[test]
+fn thin_archives_land_in_a_separate_directory_and_feed_the_link() {
+    let package = Package::new(
+        pkg_name("multi"),
+        version(),
+        vec![
+            target("greet", TargetKind::Library, &["src/greet.cc"], &[]),
+            target(
+                "hello",
+                TargetKind::Executable,
+                &["src/main.cc"],
+                &["greet"],
+            ),
+        ],
+        Vec::new(),
+    )
+    .unwrap();
+    let graph = single_package_graph(package, "/abs/proj");
+    let tc = toolchain();
+    let thin_lib = Utf8PathBuf::from("/abs/proj/build/dev/packages/multi/thin/libgreet.a");
+
+    let mut req = plan_request(&graph, &tc, "/abs/proj/build");
+    req.thin_archives = true;
+    let bg = plan(&req).unwrap();
+    let BuildAction::Archive(archive) = &bg.actions[1] else {
+        panic!("expected an archive action at index 1");
+    };
+    assert!(archive.thin);
+    assert_eq!(archive.output, thin_lib);
+    assert!(link_action(&bg).inputs.contains(&thin_lib));
+
+    // The MSVC dialect has no thin archives: the request is ignored.
+    req.dialect = Dialect::Msvc;
+    let bg = plan(&req).unwrap();
+    let BuildAction::Archive(archive) = &bg.actions[1] else {
+        panic!("expected an archive action at index 1");
+    };
+    assert!(!archive.thin);
+    assert_eq!(
+        archive.output,
+        Utf8PathBuf::from("/abs/proj/build/dev/packages/multi/greet.lib")
+    );
+}
+
 #[test]
 fn cross_package_path_dep_links_library() {
     // greet at /abs/greet, app at /abs/app depending on greet.
@@ -580,6 +632,123 @@ fn cross_package_path_dep_links_library() {
     assert!(app_compile.arguments.system_include_dirs.is_empty());
 }
 
+#[test]
+fn package_overrides_apply_per_compile() {
+    use cabin_core::{OptLevel, ProfilePackageOverride, ProfilePackageSelector};
+    let lib = |name: &str| {
+        Package::new(
+            pkg_name(name),
+            version(),
+            vec![target(name, TargetKind::Library, &["src/lib.cc"], &[])],
+            Vec::new(),
+        )
+        .unwrap()
+    };
+    let app_proj = Package::new(
+        pkg_name("app"),
+        version(),
+        vec![target(
+            "app",
+            TargetKind::Executable,
+            &["src/main.cc"],
+            &["zlib", "json"],
+        )],
+        vec![dep("zlib", "../zlib"), dep("json", "../json")],
+    )
+    .unwrap();
+    let graph = graph_with(
+        vec![
+            make_pkg("zlib", "/abs/zlib", lib("zlib"), vec![]),
+            make_pkg("json", "/abs/json", lib("json"), vec![]),
+            make_pkg("app", "/abs/app", app_proj, vec![0, 1]),
+        ],
+        vec![2],
+        Some(2),
+    );
+    let tc = toolchain();
+    let mut req = plan_request(&graph, &tc, "/abs/build");
+    req.profile.package_overrides = BTreeMap::from([
+        (
+            ProfilePackageSelector::Dependencies,
+            ProfilePackageOverride {
+                opt_level: Some(OptLevel::O2),
+                debug: Some(false),
+                assertions: None,
+            },
+        ),
+        (
+            ProfilePackageSelector::Package(pkg_name("json")),
+            ProfilePackageOverride {
+                opt_level: Some(OptLevel::O3),
+                ..Default::default()
+            },
+        ),
+    ]);
+    let bg = plan(&req).unwrap();
+    let args_for = |package: &str| {
+        compile_actions(&bg)
+            .into_iter()
+            .find(|c| {
+                c.object
+                    .as_str()
+                    .replace('\\', "/")
+                    .contains(&format!("/{package}/"))
+            })
+            .map(|c| c.arguments.clone())
+            .expect("compile action present")
+    };
+
+    // `"*"` optimizes the dependency but keeps dev's assertions.
+    let zlib = args_for("zlib");
+    assert_eq!(zlib.opt_level, OptLevel::O2);
+    assert!(!zlib.debug_info);
+    assert!(!zlib.define_ndebug);
+    // A named override wins over `"*"` field by field.
+    let json = args_for("json");
+    assert_eq!(json.opt_level, OptLevel::O3);
+    assert!(!json.debug_info);
+    // The primary package never matches `"*"`.
+    let app = args_for("app");
+    assert_eq!(app.opt_level, OptLevel::O0);
+    assert!(app.debug_info);
+}
+
+#[test]
+fn artifact_owners_record_the_target_behind_every_output() {
+    let package = Package::new(
+        pkg_name("multi"),
+        version(),
+        vec![
+            target("greet", TargetKind::Library, &["src/greet.cc"], &[]),
+            target(
+                "hello",
+                TargetKind::Executable,
+                &["src/main.cc"],
+                &["greet"],
+            ),
+        ],
+        Vec::new(),
+    )
+    .unwrap();
+    let graph = single_package_graph(package, "/abs/proj");
+    let tc = toolchain();
+    let bg = plan(&plan_request(&graph, &tc, "/abs/proj/build")).unwrap();
+
+    let owner_of = |path: &Utf8Path| {
+        let owner = &bg.artifact_owners[path];
+        format!("{}:{}", owner.package, owner.target)
+    };
+    let link = link_action(&bg);
+    assert_eq!(owner_of(&link.output), "multi:hello");
+    let [object, library] = link.inputs.as_slice() else {
+        panic!("expected one object and one archive: {:?}", link.inputs);
+    };
+    assert_eq!(owner_of(object), "multi:hello");
+    assert_eq!(owner_of(library), "multi:greet");
+    // Two objects, one archive, one executable.
+    assert_eq!(bg.artifact_owners.len(), 4);
+}
+
 #[test]
 fn bare_dep_shorthand_requires_same_name_target() {
     // `deps = ["greet"]` is shorthand for `greet:greet` - pure name
@@ -4120,3 +4289,30 @@ fn standard_compat_violations_are_toolchain_independent() {
         "violations must not depend on the resolved toolchain or dialect"
     );
 }
+
+/// The pass reads no profile input, which is what lets a
+/// multi-profile `cabin build` run it once and share the result:
+/// the same graph yields identical violations under `dev` and
+/// `release`.
+#[test]
+fn standard_compat_violations_are_profile_independent() {
+    let graph = app_dep_graph(
+        cxx_app_package(&["lib"], vec![dep("lib", "../lib")]),
+        cxx_lib_package(
+            "lib",
+            CxxStandard::Cxx20,
+            Some(interface_req(CxxStandard::Cxx20)),
+            &[],
+        ),
+        "lib",
+    );
+    let tc = toolchain_with_cc();
+    let mut req = plan_request(&graph, &tc, "/abs/app/build");
+    req.standard_compat = true;
+    let dev = plan(&req).unwrap().standard_compat_violations;
+    req.profile = release_profile();
+    let release = plan(&req).unwrap().standard_compat_violations;
+
+    assert!(!dev.is_empty(), "the fixture violates C++");
+    assert_eq!(dev, release, "violations must not depend on the profile");
+}
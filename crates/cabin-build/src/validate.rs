@@ -21,10 +21,11 @@ use std::hash::BuildHasher;
 
 use cabin_core::{
     ArchiverKind, CStandard, CxxStandard, ResolvedLanguageStandards, ResolvedToolchain,
-    SourceLanguage, ToolchainDetectionReport, classify_source, effective_c, effective_cxx,
-    validate_ar_for_backend, validate_c_standards, validate_cc_for_backend,
+    SourceLanguage, TargetCpu, TargetKind, ToolchainDetectionReport, classify_source, effective_c,
+    effective_cxx, validate_ar_for_backend, validate_c_standards, validate_cc_for_backend,
     validate_cxx_for_backend, validate_cxx_standards,
 };
+use cabin_driver::ArchiveResponseFile;
 use cabin_workspace::PackageGraph;
 
 use crate::error::BuildError;
@@ -130,6 +131,20 @@ pub fn collect_requested_standards<S: BuildHasher>(
     out
 }
 
+/// Pre-plan check for whether the selected closure can emit an
+/// archive action: any selected package declaring a `library` target
+/// (the only kind the planner archives).  Over-approximates like
+/// [`collect_requested_standards`], so a header-only or
+/// executable-only selection never needs the archiver probed.
+#[must_use]
+pub fn plans_archives(graph: &PackageGraph, selected: &BTreeSet<usize>) -> bool {
+    selected
+        .iter()
+        .filter_map(|&idx| graph.packages.get(idx))
+        .flat_map(|pkg| &pkg.package.targets)
+        .any(|target| target.kind == TargetKind::Library)
+}
+
 /// Validate that every populated tool in `report` can execute the
 /// command shapes emitted by the current backend.  Returns the
 /// first problem encountered so users see one actionable error,
@@ -149,7 +164,8 @@ pub fn collect_requested_standards<S: BuildHasher>(
 /// belong to the *same* dialect: Cabin emits one command-line
 /// dialect per build, so an MSVC compiler paired with a GNU `ar`
 /// (or the reverse) is rejected rather than left to fail
-/// mid-build.
+/// mid-build.  A report without an archiver (`cabin check` never
+/// archives, so detection skipped it) validates the compiler only.
 ///
 /// `toolchain` is the matching [`ResolvedToolchain`] - we use it
 /// to recover the user-visible spec strings (`clang++`,
@@ -167,14 +183,17 @@ pub fn validate_toolchain_for_backend(
 ) -> Result<(), BuildError> {
     let cxx_spec = toolchain.cxx.spec.display();
     validate_cxx_for_backend(&cxx_spec, &report.cxx.identity, &report.cxx.capabilities)?;
+    let Some(ar) = report.ar.as_ref() else {
+        return Ok(());
+    };
     let ar_spec = toolchain.ar.spec.display();
-    validate_ar_for_backend(&ar_spec, &report.ar.identity, &report.ar.capabilities)?;
+    validate_ar_for_backend(&ar_spec, &ar.identity, &ar.capabilities)?;
 
     // Both tools individually run; now require them to share a
     // dialect.  The C++ compiler picks it (MSVC `cl` vs GCC/Clang)
     // and the archiver must match.
     let cxx_is_msvc = report.cxx.identity.kind.speaks_msvc_dialect();
-    let ar_is_msvc = report.ar.identity.kind == ArchiverKind::Lib;
+    let ar_is_msvc = ar.identity.kind == ArchiverKind::Lib;
     if cxx_is_msvc != ar_is_msvc {
         return Err(BuildError::MixedToolchainDialects {
             detail: format!(
@@ -241,6 +260,34 @@ pub fn validate_toolchain_standards(
     Ok(())
 }
 
+/// Validate that every compiler the plan runs can target the
+/// profile's `target-cpu`.  Scoped like
+/// [`validate_toolchain_standards`]: the C compiler only weighs in
+/// when a C compile was planned.  `None` (no `target-cpu`) always
+/// passes.
+///
+/// # Errors
+/// Returns [`BuildError::UnsupportedToolchain`] wrapping
+/// [`cabin_core::ToolDetectionError::LacksTargetCpu`] for the first
+/// compiler that cannot target `cpu`.
+pub fn validate_target_cpu(
+    toolchain: &ResolvedToolchain,
+    report: &ToolchainDetectionReport,
+    requested: &RequestedStandards,
+    cpu: Option<&TargetCpu>,
+) -> Result<(), BuildError> {
+    let Some(cpu) = cpu else {
+        return Ok(());
+    };
+    cabin_core::validate_target_cpu(&toolchain.cxx.spec.display(), &report.cxx.identity, cpu)?;
+    if requested.has_c_sources()
+        && let (Some(cc_tool), Some(cc_detection)) = (toolchain.cc.as_ref(), report.cc.as_ref())
+    {
+        cabin_core::validate_target_cpu(&cc_tool.spec.display(), &cc_detection.identity, cpu)?;
+    }
+    Ok(())
+}
+
 /// Surface the first standards violation the planner recorded that
 /// survived into the final graph (after the `cabin check` rewrite,
 /// when applicable): an MSVC no-stable-flag compile or an
@@ -328,6 +375,42 @@ pub fn msvc_external_includes_supported(
     cxx_ok && cc_ok
 }
 
+/// Whether the detected archiver can write thin archives
+/// (`ar_thin`) and the link step can read them: the C++ compiler
+/// must target ELF, since `ld64` rejects thin archives even when
+/// `llvm-ar` writes them on macOS.  `false` when the archiver was
+/// not probed, so a profile's `thin-archives` request quietly falls
+/// back to classic archives instead of failing the build.  The
+/// planner consults the answer through
+/// [`crate::PlanRequest::thin_archives`].
+#[must_use]
+pub fn thin_archives_supported(report: &ToolchainDetectionReport) -> bool {
+    report.cxx.identity.targets_elf()
+        && report
+            .ar
+            .as_ref()
+            .is_some_and(|ar| ar.capabilities.ar_thin.supported)
+}
+
+/// How the detected archiver reads `@file` response files, from its
+/// `ar_response_file` capability.  `llvm-ar` is singled out because
+/// it needs `--rsp-quoting=posix` to read the GNU-quoted file on a
+/// Windows host.  [`ArchiveResponseFile::Unsupported`] when the
+/// archiver was not probed, so archive command lines stay inline.
+#[must_use]
+pub fn archive_response_files(report: &ToolchainDetectionReport) -> ArchiveResponseFile {
+    match report.ar.as_ref() {
+        Some(ar) if ar.capabilities.ar_response_file.supported => {
+            if ar.identity.kind == ArchiverKind::LlvmAr {
+                ArchiveResponseFile::LlvmAr
+            } else {
+                ArchiveResponseFile::Dialect
+            }
+        }
+        _ => ArchiveResponseFile::Unsupported,
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -382,11 +465,11 @@ mod tests {
                 capabilities: cxx_caps,
             },
             cc: None,
-            ar: ToolDetection {
+            ar: Some(ToolDetection {
                 path: Utf8PathBuf::from("/bin/ar"),
                 identity: ar,
                 capabilities: ar_caps,
-            },
+            }),
         }
     }
 
@@ -430,6 +513,131 @@ mod tests {
         validate_toolchain_for_backend(&toolchain, &report).unwrap();
     }
 
+    #[test]
+    fn thin_archives_follow_the_archiver_capability() {
+        let clang = || CompilerIdentity {
+            kind: CompilerKind::Clang,
+            version: CompilerVersion::parse("17.0.6"),
+            target: Some("x86_64-unknown-linux-gnu".into()),
+            raw_version_line: "clang version 17.0.6".into(),
+        };
+        let gnu_ar = report_for(
+            clang(),
+            ArchiverIdentity {
+                kind: ArchiverKind::Ar,
+                version: CompilerVersion::parse("2.40"),
+                raw_version_line: "GNU ar (GNU Binutils) 2.40".into(),
+            },
+        );
+        assert!(thin_archives_supported(&gnu_ar));
+        let bsd_ar = report_for(
+            clang(),
+            ArchiverIdentity {
+                kind: ArchiverKind::Ar,
+                version: None,
+                raw_version_line: String::new(),
+            },
+        );
+        assert!(!thin_archives_supported(&bsd_ar));
+        let mut unprobed = gnu_ar;
+        unprobed.ar = None;
+        assert!(!thin_archives_supported(&unprobed));
+    }
+
+    #[test]
+    fn thin_archives_fall_back_to_classic_on_mach_o() {
+        let llvm_ar = || ArchiverIdentity {
+            kind: ArchiverKind::LlvmAr,
+            version: CompilerVersion::parse("17.0.6"),
+            raw_version_line: "LLVM version 17.0.6".into(),
+        };
+        let clang_for = |triple: &str| CompilerIdentity {
+            kind: CompilerKind::Clang,
+            version: CompilerVersion::parse("17.0.6"),
+            target: Some(triple.into()),
+            raw_version_line: "clang version 17.0.6".into(),
+        };
+        // `llvm-ar` writes thin archives everywhere, but only an ELF
+        // link step reads them; `ld64` on macOS does not.
+        let linux = report_for(clang_for("x86_64-unknown-linux-gnu"), llvm_ar());
+        assert!(thin_archives_supported(&linux));
+        let macos = report_for(clang_for("arm64-apple-darwin23.4.0"), llvm_ar());
+        assert!(macos.ar.as_ref().unwrap().capabilities.ar_thin.supported);
+        assert!(!thin_archives_supported(&macos));
+    }
+
+    #[test]
+    fn response_files_follow_the_archiver_capability() {
+        let clang = || CompilerIdentity {
+            kind: CompilerKind::Clang,
+            version: CompilerVersion::parse("17.0.6"),
+            target: None,
+            raw_version_line: "clang version 17.0.6".into(),
+        };
+        let archiver = |kind, raw: &str| ArchiverIdentity {
+            kind,
+            version: None,
+            raw_version_line: raw.into(),
+        };
+        let mode =
+            |kind, raw: &str| archive_response_files(&report_for(clang(), archiver(kind, raw)));
+        assert_eq!(
+            mode(ArchiverKind::Ar, "GNU ar (GNU Binutils)"),
+            ArchiveResponseFile::Dialect
+        );
+        assert_eq!(
+            mode(ArchiverKind::Lib, "Microsoft Library Manager"),
+            ArchiveResponseFile::Dialect
+        );
+        // `llvm-ar` is told which quoting to read.
+        assert_eq!(
+            mode(ArchiverKind::LlvmAr, "LLVM version 17.0.6"),
+            ArchiveResponseFile::LlvmAr
+        );
+        assert_eq!(mode(ArchiverKind::Ar, ""), ArchiveResponseFile::Unsupported);
+        let mut unprobed = report_for(clang(), archiver(ArchiverKind::Ar, "GNU ar"));
+        unprobed.ar = None;
+        assert_eq!(
+            archive_response_files(&unprobed),
+            ArchiveResponseFile::Unsupported
+        );
+    }
+
+    #[test]
+    fn target_cpu_is_checked_against_the_compiler() {
+        let gnu_ar = ArchiverIdentity {
+            kind: ArchiverKind::Ar,
+            version: CompilerVersion::parse("2.40"),
+            raw_version_line: "GNU ar".into(),
+        };
+        let gcc = |version: &str| {
+            report_for(
+                CompilerIdentity {
+                    kind: CompilerKind::Gcc,
+                    version: CompilerVersion::parse(version),
+                    target: Some("x86_64-pc-linux-gnu".into()),
+                    raw_version_line: format!("g++ (GCC) {version}"),
+                },
+                gnu_ar.clone(),
+            )
+        };
+        let toolchain = make_toolchain("g++", "ar");
+        let v3 = cabin_core::TargetCpu::parse("x86-64-v3").unwrap();
+        let cxx_only = requested_defaults(false);
+        validate_target_cpu(&toolchain, &gcc("13.2.0"), &cxx_only, Some(&v3)).unwrap();
+        validate_target_cpu(&toolchain, &gcc("9.4.0"), &cxx_only, None).unwrap();
+        let err = validate_target_cpu(&toolchain, &gcc("9.4.0"), &cxx_only, Some(&v3)).unwrap_err();
+        assert!(
+            matches!(
+                err,
+                BuildError::UnsupportedToolchain(
+                    cabin_core::ToolDetectionError::LacksTargetCpu { .. }
+                )
+            ),
+            "{err:?}"
+        );
+    }
+
     #[test]
     fn msvc_external_includes_follow_the_cl_version() {
         let lib = || ArchiverIdentity {
@@ -513,6 +721,27 @@ mod tests {
         );
     }
 
+    #[test]
+    fn unprobed_archiver_skips_archiver_checks() {
+        // `cabin check` never archives, so detection leaves the
+        // archiver unprobed; the mixed-dialect pairing above is
+        // not an error when nothing will run the archiver.
+        let clang_cl = CompilerIdentity {
+            kind: CompilerKind::ClangCl,
+            version: CompilerVersion::parse("17.0.6"),
+            target: None,
+            raw_version_line: "clang version 17.0.6".into(),
+        };
+        let gnu_ar = ArchiverIdentity {
+            kind: ArchiverKind::Ar,
+            version: CompilerVersion::parse("2.40"),
+            raw_version_line: "GNU ar".into(),
+        };
+        let mut report = report_for(clang_cl, gnu_ar);
+        report.ar = None;
+        validate_toolchain_for_backend(&make_toolchain("clang-cl", "ar"), &report).unwrap();
+    }
+
     #[test]
     fn rejects_mixed_dialect_toolchain() {
         // A GCC/Clang compiler with an MSVC archiver runs each tool
@@ -629,6 +858,8 @@ mod tests {
                     cxx_standard: Some(StandardDeclaration::Declared(CxxStandard::Cxx17)),
                     ..Default::default()
                 },
+                data: Vec::new(),
+                harness: None,
             };
             let package = Package::new(
                 PackageName::new(name).unwrap(),
@@ -683,6 +914,63 @@ mod tests {
         assert!(both.has_c_sources());
     }
 
+    #[test]
+    fn archiver_is_needed_only_when_a_library_is_selected() {
+        use cabin_core::{Package, PackageName, Target, TargetName};
+        use cabin_workspace::{PackageKind, WorkspacePackage};
+
+        fn pkg(name: &str, kind: TargetKind, sources: &[&str]) -> WorkspacePackage {
+            let target = Target {
+                name: TargetName::new(name).unwrap(),
+                kind,
+                sources: sources.iter().map(Utf8PathBuf::from).collect(),
+                include_dirs: Vec::new(),
+                defines: Vec::new(),
+                deps: Vec::new(),
+                required_features: Vec::new(),
+                language: cabin_core::LanguageStandardSettings::default(),
+                data: Vec::new(),
+                harness: None,
+            };
+            let package = Package::new(
+                PackageName::new(name).unwrap(),
+                semver::Version::parse("0.1.0").unwrap(),
+                vec![target],
+                Vec::new(),
+            )
+            .unwrap();
+            let dir = std::path::PathBuf::from("/tmp").join(name);
+            WorkspacePackage {
+                package,
+                manifest_path: dir.join("cabin.toml"),
+                manifest_dir: dir,
+                deps: Vec::new(),
+                kind: PackageKind::Local,
+                is_port: false,
+            }
+        }
+
+        let graph = PackageGraph {
+            root_manifest_path: std::path::PathBuf::from("/tmp/cabin.toml"),
+            root_dir: std::path::PathBuf::from("/tmp"),
+            is_workspace_root: true,
+            root_package: None,
+            root_settings: Default::default(),
+            primary_packages: vec![0, 1, 2],
+            default_members: vec![0, 1, 2],
+            excluded_members: Vec::new(),
+            packages: vec![
+                pkg("headers", TargetKind::HeaderOnly, &[]),
+                pkg("app", TargetKind::Executable, &["main.cc"]),
+                pkg("core", TargetKind::Library, &["core.cc"]),
+            ],
+        };
+
+        assert!(!plans_archives(&graph, &BTreeSet::from([0usize, 1usize])));
+        assert!(plans_archives(&graph, &BTreeSet::from([1usize, 2usize])));
+        assert!(!plans_archives(&graph, &BTreeSet::new()));
+    }
+
     #[test]
     fn requested_standards_skip_dev_only_targets_unless_activated() {
         use cabin_core::{
@@ -703,6 +991,8 @@ mod tests {
                 cxx_standard: Some(StandardDeclaration::Declared(CxxStandard::Cxx20)),
                 ..Default::default()
             },
+            data: Vec::new(),
+            harness: None,
         };
         let package = Package::new(
             PackageName::new("demo").unwrap(),
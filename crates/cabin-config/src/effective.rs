@@ -113,6 +113,11 @@ impl EffectivePathSetting {
 pub struct EffectiveBuild {
     pub profile: Option<EffectiveProfile>,
     pub jobs: Option<EffectiveBuildJobs>,
+    /// `[build.remote-execution]` from the highest-priority file that
+    /// declared the table.  The table is replaced whole, never merged
+    /// key by key, so an endpoint is never paired with another
+    /// file's instance name.
+    pub remote_execution: Option<SourcedValue<cabin_core::RemoteExecutionSettings>>,
 }
 
 #[derive(Debug, Clone, PartialEq, Eq)]
@@ -235,6 +240,10 @@ fn apply_parsed(
             source,
         });
     }
+    if let Some(remote_execution) = &parsed.build.remote_execution {
+        effective.build.remote_execution =
+            Some(SourcedValue::new(remote_execution.clone(), source));
+    }
     if let Some(incompatible_standards) = parsed.resolver.incompatible_standards {
         effective.resolver.incompatible_standards =
             Some(SourcedValue::new(incompatible_standards, source));
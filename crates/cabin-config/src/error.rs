@@ -137,6 +137,12 @@ pub enum ConfigParseError {
         value: String,
     },
 
+    /// `[build.remote-execution]` carried an invalid endpoint or
+    /// platform property.  Wraps the typed error returned by
+    /// [`cabin_core::RemoteExecutionSettings::new`].
+    #[error("config key {0}")]
+    InvalidRemoteExecution(cabin_core::RemoteExecutionError),
+
     /// `[target.'cfg(...)']` (or any other target-conditioned
     /// table) appeared in a config file.  Target-conditioned config
     /// is not supported; the equivalent feature
@@ -85,6 +85,7 @@ pub struct ParsedBuild {
     pub profile: Option<String>,
     pub compiler_wrapper: Option<CompilerWrapperRequest>,
     pub jobs: Option<cabin_core::BuildJobs>,
+    pub remote_execution: Option<cabin_core::RemoteExecutionSettings>,
 }
 
 #[derive(Debug, Default, Clone, PartialEq, Eq)]
@@ -243,10 +244,23 @@ fn parsed_build_from_raw(raw: RawBuild) -> Result<ParsedBuild, ConfigParseError>
         Some(value) => Some(parsed_build_jobs(value)?),
         None => None,
     };
+    let remote_execution = match raw.remote_execution {
+        Some(raw) => Some(
+            cabin_core::RemoteExecutionSettings::new(
+                &raw.endpoint,
+                raw.instance.as_deref(),
+                raw.cas_endpoint.as_deref(),
+                raw.platform,
+            )
+            .map_err(ConfigParseError::InvalidRemoteExecution)?,
+        ),
+        None => None,
+    };
     Ok(ParsedBuild {
         profile,
         compiler_wrapper,
         jobs,
+        remote_execution,
     })
 }
 
@@ -1078,6 +1092,35 @@ mod tests {
         assert!(matches!(err, ConfigParseError::Toml(_)));
     }
 
+    #[test]
+    fn build_remote_execution_table_parses() {
+        let parsed = parse_config_str(
+            "[build.remote-execution]\n\
+             endpoint = \"grpc://farm.example:8980\"\n\
+             instance = \"main\"\n\
+             platform = { OSFamily = \"linux\" }\n",
+        )
+        .unwrap();
+        let remote = parsed.build.remote_execution.expect("table parsed");
+        assert_eq!(remote.endpoint, "grpc://farm.example:8980");
+        assert_eq!(remote.instance.as_deref(), Some("main"));
+        assert_eq!(remote.cas_endpoint, None);
+        assert_eq!(remote.platform["OSFamily"], "linux");
+    }
+
+    #[test]
+    fn build_remote_execution_rejects_bad_endpoints_and_keys() {
+        let err =
+            parse_config_str("[build.remote-execution]\nendpoint = \"farm:8980\"\n").unwrap_err();
+        assert!(matches!(err, ConfigParseError::InvalidRemoteExecution(_)));
+        assert!(err.to_string().contains("build.remote-execution.endpoint"));
+        let err = parse_config_str(
+            "[build.remote-execution]\nendpoint = \"grpc://farm\"\nhost = \"x\"\n",
+        )
+        .unwrap_err();
+        assert!(matches!(err, ConfigParseError::Toml(_)));
+    }
+
     #[test]
     fn build_jobs_missing_yields_none() {
         let parsed = parse_config_str("[build]\nprofile = \"dev\"\n").unwrap();
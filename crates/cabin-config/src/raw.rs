@@ -114,6 +114,24 @@ pub(crate) struct RawBuild {
     /// [`cabin_core::BuildJobs`] validator.
     #[serde(default)]
     pub(crate) jobs: Option<i64>,
+    /// `[build.remote-execution]` - where the REAPI compile
+    /// launcher sends compile actions.  Validated into
+    /// [`cabin_core::RemoteExecutionSettings`] in `parse.rs`.
+    #[serde(default, rename = "remote-execution")]
+    pub(crate) remote_execution: Option<RawRemoteExecution>,
+}
+
+/// Shape of `[build.remote-execution]` in a config file.
+#[derive(Debug, Deserialize)]
+#[serde(deny_unknown_fields)]
+pub(crate) struct RawRemoteExecution {
+    pub(crate) endpoint: String,
+    #[serde(default)]
+    pub(crate) instance: Option<String>,
+    #[serde(default, rename = "cas-endpoint")]
+    pub(crate) cas_endpoint: Option<String>,
+    #[serde(default)]
+    pub(crate) platform: BTreeMap<String, String>,
 }
 
 /// Shape of `[resolver]` in a config file.  Holds the standard-aware
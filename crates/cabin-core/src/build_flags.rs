@@ -510,6 +510,9 @@ mod tests {
                 debug: None,
                 opt_level: None,
                 assertions: None,
+                thin_archives: None,
+                target_cpu: None,
+                package: BTreeMap::new(),
                 build: Some(ProfileFlags {
                     ldflags: ldflags.iter().map(|flag| (*flag).to_owned()).collect(),
                     ..Default::default()
@@ -832,6 +835,9 @@ mod tests {
                 debug: None,
                 opt_level: None,
                 assertions: None,
+                thin_archives: None,
+                target_cpu: None,
+                package: BTreeMap::new(),
                 build: Some(prof),
             },
         )]);
@@ -939,6 +945,9 @@ mod tests {
                 debug: None,
                 opt_level: None,
                 assertions: None,
+                thin_archives: None,
+                target_cpu: None,
+                package: BTreeMap::new(),
                 build: Some(prof),
             },
         )]);
@@ -979,6 +988,9 @@ mod tests {
                 debug: None,
                 opt_level: None,
                 assertions: None,
+                thin_archives: None,
+                target_cpu: None,
+                package: BTreeMap::new(),
                 build: Some(ProfileFlags {
                     cxxflags: vec!["-O2".into()],
                     ldflags: vec!["-s".into()],
@@ -6,6 +6,7 @@ use super::identity::{
     ArchiverIdentity, ArchiverKind, CompilerIdentity, CompilerKind, CompilerVersion,
 };
 use crate::language_standard::{CStandard, CxxStandard};
+use crate::target_cpu::{TargetArch, TargetCpu, X86Level};
 
 /// Where one capability decision came from.  Recorded so
 /// `cabin metadata` can show whether Cabin trusted the version
@@ -82,6 +83,12 @@ pub struct CompilerCapabilities {
 pub struct ArchiverCapabilities {
     /// Accepts the `crs` mode flags (the planner's archive form).
     pub ar_crs: Capability,
+    /// Can write a thin archive that references member objects in
+    /// place (`ar crsT` / `llvm-ar --thin`).
+    pub ar_thin: Capability,
+    /// Reads `@file` response files, so a long input list can move
+    /// out of the command line.
+    pub ar_response_file: Capability,
     /// Produces a `.a` static library archive.
     pub static_library_output: Capability,
 }
@@ -271,6 +278,39 @@ pub fn cxx_standard_capability(identity: &CompilerIdentity, standard: CxxStandar
     }
 }
 
+/// Whether `identity` can target `cpu` ([`TargetCpu::gnu_flag`] on
+/// the GNU dialect, `/arch:` on MSVC).  The x86-64 levels need an
+/// x86-64 target, and their names arrived in GCC 11 and Clang 12
+/// (Apple clang 13); `native` and the `x86-64` baseline predate
+/// every supported release.  A named CPU is assumed supported: the
+/// compiler owns its CPU table and rejects an unknown name itself.
+/// On the MSVC dialect only the levels [`TargetCpu::msvc_flag`]
+/// spells are supported.
+#[must_use]
+pub fn target_cpu_capability(identity: &CompilerIdentity, cpu: &TargetCpu) -> Capability {
+    if matches!(cpu, TargetCpu::X86_64(_)) && identity.arch() != TargetArch::X86_64 {
+        return Capability::unsupported_from(CapabilitySource::Unsupported);
+    }
+    let version = identity.version.as_ref();
+    let always = Capability::supported_from(CapabilitySource::Version);
+    let named = Capability::supported_from(CapabilitySource::AssumedDefault);
+    let level_gate = |major| match cpu {
+        TargetCpu::Native | TargetCpu::X86_64(X86Level::V1) => always,
+        TargetCpu::X86_64(_) => version_gated_capability(version, major, 0),
+        TargetCpu::Named(_) => named,
+    };
+    match identity.kind {
+        CompilerKind::Gcc => level_gate(11),
+        CompilerKind::Clang => level_gate(12),
+        CompilerKind::AppleClang => level_gate(13),
+        CompilerKind::ClangCl | CompilerKind::Msvc => match cpu.msvc_flag() {
+            Some(_) => always,
+            None => Capability::unsupported_from(CapabilitySource::Unsupported),
+        },
+        CompilerKind::Unknown => Capability::unsupported_from(CapabilitySource::AssumedDefault),
+    }
+}
+
 /// Human-readable reason for an unsupported standard capability,
 /// used by the validation errors: either the compiler has no stable
 /// flag for the standard at any version, or the detected version
@@ -297,6 +337,36 @@ pub fn derive_ar_capabilities(identity: &ArchiverIdentity) -> ArchiverCapabiliti
     } else {
         Capability::unsupported_from(CapabilitySource::AssumedDefault)
     };
+    // `llvm-ar` and GNU `ar` both spell thin archives as the `T`
+    // modifier.  BSD / Apple `ar` also classify as `Ar` but give `T`
+    // a different meaning, so only a GNU banner counts for `Ar`.
+    // This is the archiver's side only: the linker must read thin
+    // archives too, which `ld64` does not, so callers also require
+    // [`CompilerIdentity::targets_elf`].
+    let gnu_banner = identity
+        .raw_version_line
+        .to_ascii_lowercase()
+        .contains("gnu");
+    let ar_thin = match identity.kind {
+        ArchiverKind::LlvmAr => Capability::supported_from(CapabilitySource::Version),
+        ArchiverKind::Ar if gnu_banner => Capability::supported_from(CapabilitySource::Version),
+        ArchiverKind::Lib => Capability::unsupported_from(CapabilitySource::Unsupported),
+        ArchiverKind::Ar | ArchiverKind::Unknown => {
+            Capability::unsupported_from(CapabilitySource::AssumedDefault)
+        }
+    };
+    // `lib.exe`, `llvm-ar` and GNU `ar` read `@file` response files;
+    // BSD / Apple `ar` take `@file` as a member name, and again only
+    // the GNU banner tells GNU `ar` apart from them.
+    let ar_response_file = match identity.kind {
+        ArchiverKind::LlvmAr | ArchiverKind::Lib => {
+            Capability::supported_from(CapabilitySource::Version)
+        }
+        ArchiverKind::Ar if gnu_banner => Capability::supported_from(CapabilitySource::Version),
+        ArchiverKind::Ar | ArchiverKind::Unknown => {
+            Capability::unsupported_from(CapabilitySource::AssumedDefault)
+        }
+    };
     // Honest across both dialects: `ar` / `llvm-ar` archive via
     // `ar crs`, `lib.exe` via `lib /OUT:`.  The `ar_crs` capability
     // above stays GNU-specific (`lib.exe` does not accept `crs`),
@@ -308,6 +378,8 @@ pub fn derive_ar_capabilities(identity: &ArchiverIdentity) -> ArchiverCapabiliti
     };
     ArchiverCapabilities {
         ar_crs,
+        ar_thin,
+        ar_response_file,
         static_library_output,
     }
 }
@@ -4,6 +4,8 @@ use std::fmt;
 
 use serde::{Deserialize, Serialize};
 
+use crate::target_cpu::TargetArch;
+
 /// Recognized C/C++ compiler family.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash, Serialize, Deserialize)]
 #[serde(rename_all = "kebab-case")]
@@ -241,6 +243,59 @@ impl CompilerIdentity {
         }
     }
 
+    /// Architecture component of the reported target triple
+    /// (`x86_64`, `aarch64`, `arm64`, …), or the host's when the
+    /// compiler printed none.
+    #[must_use]
+    pub fn target_arch(&self) -> &str {
+        self.target
+            .as_deref()
+            .and_then(|triple| triple.split('-').next())
+            .unwrap_or(std::env::consts::ARCH)
+    }
+
+    /// Architecture family of [`Self::target_arch`].
+    #[must_use]
+    pub fn arch(&self) -> TargetArch {
+        TargetArch::from_triple_arch(self.target_arch())
+    }
+
+    /// Whether this compiler emits ELF objects, linked by a
+    /// GNU-ld-compatible linker (GNU ld, gold, lld, mold) - the only
+    /// linkers that read thin archives.  Decided from the reported
+    /// target triple; a compiler that printed none (GCC's `--version`
+    /// never does) is taken to target the host, since Cabin does not
+    /// cross-compile.  Mach-O (`ld64`) and COFF targets are not ELF.
+    #[must_use]
+    pub fn targets_elf(&self) -> bool {
+        const ELF_SYSTEMS: [&str; 8] = [
+            "linux",
+            "freebsd",
+            "netbsd",
+            "openbsd",
+            "dragonfly",
+            "solaris",
+            "illumos",
+            "elf",
+        ];
+        match self.target.as_deref() {
+            Some(triple) => triple
+                .split('-')
+                .skip(1)
+                .any(|part| ELF_SYSTEMS.iter().any(|os| part.starts_with(os))),
+            None => cfg!(any(
+                target_os = "linux",
+                target_os = "android",
+                target_os = "freebsd",
+                target_os = "netbsd",
+                target_os = "openbsd",
+                target_os = "dragonfly",
+                target_os = "solaris",
+                target_os = "illumos",
+            )),
+        }
+    }
+
     /// Compact JSON view used by `cabin metadata`.
     pub fn as_json(&self) -> serde_json::Value {
         identity_json(
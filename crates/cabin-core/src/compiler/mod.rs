@@ -23,7 +23,7 @@ mod validation;
 pub use capabilities::{
     ArchiverCapabilities, Capability, CapabilitySource, CompilerCapabilities,
     c_standard_capability, cxx_standard_capability, derive_ar_capabilities,
-    derive_cxx_capabilities, standard_support_detail,
+    derive_cxx_capabilities, standard_support_detail, target_cpu_capability,
 };
 pub use identity::{
     ArchiverIdentity, ArchiverKind, CompilerIdentity, CompilerKind, CompilerVersion,
@@ -32,5 +32,5 @@ pub use parsing::{parse_ar_version_output, parse_cxx_version_output};
 pub use report::{ToolDetection, ToolchainDetectionReport};
 pub use validation::{
     ToolDetectionError, validate_ar_for_backend, validate_c_standards, validate_cc_for_backend,
-    validate_cxx_for_backend, validate_cxx_standards,
+    validate_cxx_for_backend, validate_cxx_standards, validate_target_cpu,
 };
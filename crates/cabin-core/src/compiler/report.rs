@@ -7,14 +7,21 @@ use super::identity::{ArchiverIdentity, CompilerIdentity};
 
 /// Whole-toolchain detection report.  The CLI builds one per
 /// invocation that needs detection (build / metadata) and threads
-/// it into the planner and the metadata view.
+/// it into the planner and the metadata view.  The C++ compiler is
+/// always detected; the C compiler and the archiver are only
+/// probed when the invocation can use them, so a report for a
+/// C++-only build or a `cabin check` may omit them.
 #[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
 pub struct ToolchainDetectionReport {
     pub cxx: ToolDetection<CompilerIdentity, CompilerCapabilities>,
     /// Optional because `ResolvedToolchain.cc` is itself optional.
     #[serde(default, skip_serializing_if = "Option::is_none")]
     pub cc: Option<ToolDetection<CompilerIdentity, CompilerCapabilities>>,
-    pub ar: ToolDetection<ArchiverIdentity, ArchiverCapabilities>,
+    /// `None` when the invocation never archives (`cabin check`,
+    /// `cabin tidy`, or a build whose selected packages have no
+    /// library target), so the archiver was not probed.
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub ar: Option<ToolDetection<ArchiverIdentity, ArchiverCapabilities>>,
 }
 
 impl ToolchainDetectionReport {
@@ -22,8 +29,8 @@ impl ToolchainDetectionReport {
     /// and any tooling that wants to inspect detection results
     /// without re-deriving them.  Each tool block carries
     /// `path` / `identity` / `capabilities`; absent tools (a
-    /// missing C compiler) are omitted entirely so the JSON
-    /// shape stays stable.
+    /// missing or unprobed C compiler or archiver) are omitted
+    /// entirely so the JSON shape stays stable.
     pub fn as_json(&self) -> serde_json::Value {
         let mut obj = serde_json::Map::new();
         obj.insert(
@@ -44,14 +51,16 @@ impl ToolchainDetectionReport {
                 }),
             );
         }
-        obj.insert(
-            "ar".to_owned(),
-            serde_json::json!({
-                "path": self.ar.path.as_str().to_owned(),
-                "identity": self.ar.identity.as_json(),
-                "capabilities": ar_capabilities_as_json(&self.ar.capabilities),
-            }),
-        );
+        if let Some(ar) = &self.ar {
+            obj.insert(
+                "ar".to_owned(),
+                serde_json::json!({
+                    "path": ar.path.as_str().to_owned(),
+                    "identity": ar.identity.as_json(),
+                    "capabilities": ar_capabilities_as_json(&ar.capabilities),
+                }),
+            );
+        }
         serde_json::Value::Object(obj)
     }
 }
@@ -91,10 +100,14 @@ pub(crate) fn cxx_capabilities_as_json(caps: &CompilerCapabilities) -> serde_jso
 pub(crate) fn ar_capabilities_as_json(caps: &ArchiverCapabilities) -> serde_json::Value {
     let ArchiverCapabilities {
         ar_crs,
+        ar_thin,
+        ar_response_file,
         static_library_output,
     } = caps;
-    let mut entries: [(&'static str, &Capability); 2] = [
+    let mut entries: [(&'static str, &Capability); 4] = [
         ("ar_crs", ar_crs),
+        ("ar_thin", ar_thin),
+        ("ar_response_file", ar_response_file),
         ("static_library_output", static_library_output),
     ];
     capabilities_to_json(&mut entries)
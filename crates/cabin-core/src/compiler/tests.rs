@@ -136,6 +136,67 @@ fn gcc_standard_capabilities_are_version_gated_per_standard() {
     assert_eq!(cap.source, CapabilitySource::AssumedDefault);
 }
 
+#[test]
+fn target_cpu_gates_levels_by_version_and_msvc_spelling() {
+    use crate::target_cpu::TargetCpu;
+    let make = |kind: CompilerKind, v: &str| CompilerIdentity {
+        kind,
+        version: CompilerVersion::parse(v),
+        target: Some("x86_64-pc-linux-gnu".to_owned()),
+        raw_version_line: format!("{kind} {v}"),
+    };
+    let cpu = |raw: &str| TargetCpu::parse(raw).unwrap();
+    let v3 = cpu("x86-64-v3");
+    // Level names: GCC 11, Clang 12.
+    assert!(target_cpu_capability(&make(CompilerKind::Gcc, "11.1.0"), &v3).supported);
+    assert!(!target_cpu_capability(&make(CompilerKind::Gcc, "10.5.0"), &v3).supported);
+    assert!(target_cpu_capability(&make(CompilerKind::Clang, "12.0.0"), &v3).supported);
+    assert!(!target_cpu_capability(&make(CompilerKind::Clang, "11.1.0"), &v3).supported);
+    // `native` and the baseline are always spelled.
+    let old_gcc = make(CompilerKind::Gcc, "7.5.0");
+    assert!(target_cpu_capability(&old_gcc, &cpu("native")).supported);
+    assert!(target_cpu_capability(&old_gcc, &cpu("x86-64")).supported);
+    let named = target_cpu_capability(&old_gcc, &cpu("skylake"));
+    assert!(named.supported);
+    assert_eq!(named.source, CapabilitySource::AssumedDefault);
+    // MSVC: only the levels with an `/arch:` value.
+    let cl = make(CompilerKind::Msvc, "19.38.33135");
+    assert!(target_cpu_capability(&cl, &v3).supported);
+    assert!(target_cpu_capability(&cl, &cpu("x86-64-v4")).supported);
+    for unspellable in ["x86-64-v2", "native", "skylake"] {
+        let cap = target_cpu_capability(&cl, &cpu(unspellable));
+        assert!(!cap.supported, "{unspellable}");
+        assert_eq!(cap.source, CapabilitySource::Unsupported);
+    }
+    assert!(matches!(
+        validate_target_cpu("cl", &cl, &cpu("native")),
+        Err(ToolDetectionError::LacksTargetCpu { .. })
+    ));
+    // The levels name x86-64 CPUs: any other target rejects them,
+    // while `native` and named CPUs stay the compiler's call.
+    let arm_gcc = CompilerIdentity {
+        target: Some("aarch64-linux-gnu".to_owned()),
+        ..make(CompilerKind::Gcc, "13.2.0")
+    };
+    for level in ["x86-64", "x86-64-v3"] {
+        let cap = target_cpu_capability(&arm_gcc, &cpu(level));
+        assert!(!cap.supported, "{level}");
+        assert_eq!(cap.source, CapabilitySource::Unsupported);
+    }
+    assert!(target_cpu_capability(&arm_gcc, &cpu("native")).supported);
+    assert!(target_cpu_capability(&arm_gcc, &cpu("cortex-a76")).supported);
+    let apple = CompilerIdentity {
+        target: Some("arm64-apple-darwin23.4.0".to_owned()),
+        ..make(CompilerKind::AppleClang, "15.0.0")
+    };
+    let Err(ToolDetectionError::LacksTargetCpu { detail, .. }) =
+        validate_target_cpu("c++", &apple, &v3)
+    else {
+        panic!("x86-64-v3 must be rejected for an arm64 target");
+    };
+    assert!(detail.contains("`arm64`"), "{detail}");
+}
+
 #[test]
 fn clang_and_apple_clang_standard_gates_follow_the_audited_table() {
     let make = |kind: CompilerKind, v: &str| CompilerIdentity {
@@ -268,9 +329,79 @@ fn ar_capabilities_recognize_gnu_ar() {
     };
     let caps = derive_ar_capabilities(&id);
     assert!(caps.ar_crs.supported);
+    assert!(caps.ar_thin.supported);
+    assert!(caps.ar_response_file.supported);
     assert!(caps.static_library_output.supported);
 }
 
+#[test]
+fn response_files_need_a_gnu_llvm_or_msvc_archiver() {
+    let caps = |kind, raw: &str| {
+        derive_ar_capabilities(&ArchiverIdentity {
+            kind,
+            version: None,
+            raw_version_line: raw.into(),
+        })
+        .ar_response_file
+    };
+    assert!(caps(ArchiverKind::Ar, "GNU ar (GNU Binutils) 2.40").supported);
+    assert!(caps(ArchiverKind::LlvmAr, "LLVM version 17.0.6").supported);
+    assert!(caps(ArchiverKind::Lib, "Microsoft Library Manager").supported);
+    // BSD / Apple `ar` would archive `@file` as a member.
+    let bsd = caps(ArchiverKind::Ar, "");
+    assert!(!bsd.supported);
+    assert_eq!(bsd.source, CapabilitySource::AssumedDefault);
+    assert!(!caps(ArchiverKind::Unknown, "").supported);
+}
+
+#[test]
+fn elf_targets_are_recognized_from_the_triple() {
+    let with_target = |triple: &str| CompilerIdentity {
+        kind: CompilerKind::Clang,
+        version: CompilerVersion::parse("17.0.6"),
+        target: Some(triple.to_owned()),
+        raw_version_line: "clang version 17.0.6".into(),
+    };
+    for triple in [
+        "x86_64-unknown-linux-gnu",
+        "aarch64-linux-android",
+        "x86_64-unknown-freebsd14.0",
+        "riscv64-unknown-elf",
+    ] {
+        assert!(with_target(triple).targets_elf(), "{triple}");
+    }
+    for triple in [
+        "arm64-apple-darwin22.5.0",
+        "x86_64-apple-macosx14.0.0",
+        "x86_64-pc-windows-msvc",
+        "x86_64-w64-windows-gnu",
+    ] {
+        assert!(!with_target(triple).targets_elf(), "{triple}");
+    }
+    // No reported triple: the host decides.
+    let host = CompilerIdentity::unknown("g++ (GCC) 13.2.0");
+    if cfg!(target_os = "linux") {
+        assert!(host.targets_elf());
+    } else if cfg!(any(target_os = "macos", windows)) {
+        assert!(!host.targets_elf());
+    }
+}
+
+#[test]
+fn bsd_ar_does_not_claim_thin_archives() {
+    // BSD / Apple `ar` classify as `Ar` by basename, but their `T`
+    // modifier does not mean "thin", so the capability stays off.
+    let id = ArchiverIdentity {
+        kind: ArchiverKind::Ar,
+        version: None,
+        raw_version_line: String::new(),
+    };
+    let caps = derive_ar_capabilities(&id);
+    assert!(caps.ar_crs.supported);
+    assert!(!caps.ar_thin.supported);
+    assert_eq!(caps.ar_thin.source, CapabilitySource::AssumedDefault);
+}
+
 #[test]
 fn msvc_lib_archives_without_ar_crs() {
     // `lib.exe` rejects GNU `crs` mode flags.  It still produces
@@ -284,6 +415,7 @@ fn msvc_lib_archives_without_ar_crs() {
     let caps = derive_ar_capabilities(&id);
     assert!(!caps.ar_crs.supported);
     assert_eq!(caps.ar_crs.source, CapabilitySource::Unsupported);
+    assert!(!caps.ar_thin.supported);
     assert!(caps.static_library_output.supported);
 }
 
@@ -925,6 +1057,14 @@ fn snapshot_gnu_ar_identity_and_capabilities() {
       "supported": true,
       "source": "version"
     },
+    "ar_response_file": {
+      "supported": true,
+      "source": "version"
+    },
+    "ar_thin": {
+      "supported": true,
+      "source": "version"
+    },
     "static_library_output": {
       "supported": true,
       "source": "version"
@@ -950,6 +1090,14 @@ fn snapshot_msvc_lib_archiver_produces_static_library_without_ar_crs() {
       "supported": false,
       "source": "unsupported"
     },
+    "ar_response_file": {
+      "supported": true,
+      "source": "version"
+    },
+    "ar_thin": {
+      "supported": false,
+      "source": "unsupported"
+    },
     "static_library_output": {
       "supported": true,
       "source": "version"
@@ -977,11 +1125,11 @@ fn snapshot_full_detection_report_for_clang_plus_gnu_ar() {
             capabilities: cxx_caps,
         },
         cc: None,
-        ar: ToolDetection {
+        ar: Some(ToolDetection {
             path: camino::Utf8PathBuf::from("/usr/bin/ar"),
             identity: ar_id,
             capabilities: ar_caps,
-        },
+        }),
     };
     let actual = pretty(&report.as_json());
     let expected = r#"{
@@ -1024,6 +1172,14 @@ fn snapshot_full_detection_report_for_clang_plus_gnu_ar() {
         "supported": true,
         "source": "version"
       },
+      "ar_response_file": {
+        "supported": true,
+        "source": "version"
+      },
+      "ar_thin": {
+        "supported": true,
+        "source": "version"
+      },
       "static_library_output": {
         "supported": true,
         "source": "version"
@@ -5,11 +5,12 @@ use std::collections::BTreeSet;
 use thiserror::Error;
 
 use super::capabilities::{
-    ArchiverCapabilities, CompilerCapabilities, c_standard_capability, cxx_standard_capability,
-    standard_support_detail,
+    ArchiverCapabilities, CapabilitySource, CompilerCapabilities, c_standard_capability,
+    cxx_standard_capability, standard_support_detail, target_cpu_capability,
 };
 use super::identity::{ArchiverIdentity, ArchiverKind, CompilerIdentity, CompilerKind};
 use crate::language_standard::{CStandard, CxxStandard};
+use crate::target_cpu::{TargetArch, TargetCpu};
 
 /// Errors produced while validating a detection report against
 /// the current C++ backend's required capability set.
@@ -61,6 +62,14 @@ pub enum ToolDetectionError {
         detail: String,
     },
 
+    #[error("selected compiler `{spec}` ({kind}) cannot target CPU `{cpu}`: {detail}")]
+    LacksTargetCpu {
+        spec: String,
+        kind: CompilerKind,
+        cpu: String,
+        detail: String,
+    },
+
     #[error("selected archiver `{spec}` is not supported by the static-library backend")]
     UnsupportedArchiver { spec: String },
 
@@ -172,6 +181,46 @@ pub fn validate_c_standards(
     Ok(())
 }
 
+/// Validate that a compiler can target the profile's `target-cpu`.
+///
+/// # Errors
+/// Returns [`ToolDetectionError::LacksTargetCpu`] when
+/// [`target_cpu_capability`] reports the CPU unsupported, with a
+/// wrong-architecture, version or no-spelling detail.
+pub fn validate_target_cpu(
+    spec_display: &str,
+    identity: &CompilerIdentity,
+    cpu: &TargetCpu,
+) -> Result<(), ToolDetectionError> {
+    let capability = target_cpu_capability(identity, cpu);
+    if capability.supported {
+        return Ok(());
+    }
+    let detail = match capability.source {
+        CapabilitySource::Unsupported
+            if matches!(cpu, TargetCpu::X86_64(_)) && identity.arch() != TargetArch::X86_64 =>
+        {
+            format!(
+                "the compiler targets `{}`, and the x86-64 levels only apply to x86-64 targets",
+                identity.target_arch()
+            )
+        }
+        CapabilitySource::Unsupported => format!(
+            "{} has no `/arch:` spelling for it; the MSVC dialect supports `x86-64`, `x86-64-v3`, and `x86-64-v4`",
+            identity.kind
+        ),
+        CapabilitySource::Version | CapabilitySource::AssumedDefault => {
+            "the detected compiler version predates support for this CPU name".to_owned()
+        }
+    };
+    Err(ToolDetectionError::LacksTargetCpu {
+        spec: spec_display.to_owned(),
+        kind: identity.kind,
+        cpu: cpu.to_string(),
+        detail,
+    })
+}
+
 /// Validate that the resolved C compiler supports the C-side
 /// command shape the active backend emits.  An MSVC compiler
 /// drives the `cl.exe` backend; every other recognized compiler
@@ -19,8 +19,10 @@
 //! the [`ConditionKey`] enum. `feature = "..."` evaluates against
 //! the owning package's enabled-feature set, and the compiler
 //! keys - `cc`, `cxx`, `cc_version`, `cxx_version` - evaluate
-//! against the *detected* toolchain; both are accepted on profile
-//! flag tables only (the manifest layer rejects them elsewhere).
+//! against the *detected* toolchain, and `target_feature` evaluates
+//! against the instruction-set features the selected profile's
+//! `target-cpu` implies; all three are accepted on profile flag
+//! tables only (the manifest layer rejects them elsewhere).
 //! Any other key is rejected at parse time so manifests do not
 //! silently rely on a future detection layer.
 //!
@@ -78,6 +80,13 @@ pub enum Condition {
     /// version ⇒ `false`.  The raw requirement string is preserved
     /// verbatim so `Display` round-trips byte-identically.
     CompilerVersionReq { slot: CompilerSlot, req: String },
+    /// `target_feature = "<feature>"`.  Matches when the selected
+    /// profile's `target-cpu` implies the feature
+    /// ([`crate::TargetCpu::target_features`]); a profile without a
+    /// `target-cpu` implies none.  Like the compiler leaves it is
+    /// accepted on profile flag tables only: the profile is not
+    /// known when dependencies or the toolchain are selected.
+    TargetFeature(String),
     /// `all(<conditions>)`.  Empty `all()` is rejected at parse
     /// time.
     All(Vec<Condition>),
@@ -147,6 +156,7 @@ impl Condition {
         match self {
             Condition::KeyValue { key, value } => key.lookup(ctx.platform) == value,
             Condition::Feature(name) => ctx.features.contains(name),
+            Condition::TargetFeature(name) => ctx.target_features.contains(name),
             Condition::CompilerFamily { slot, family } => {
                 let detected = ctx
                     .identity(*slot)
@@ -179,7 +189,8 @@ impl Condition {
             Condition::Feature(_) => true,
             Condition::KeyValue { .. }
             | Condition::CompilerFamily { .. }
-            | Condition::CompilerVersionReq { .. } => false,
+            | Condition::CompilerVersionReq { .. }
+            | Condition::TargetFeature(_) => false,
             Condition::All(items) | Condition::Any(items) => {
                 items.iter().any(Condition::references_feature)
             }
@@ -195,13 +206,51 @@ impl Condition {
     pub fn references_compiler(&self) -> bool {
         match self {
             Condition::CompilerFamily { .. } | Condition::CompilerVersionReq { .. } => true,
-            Condition::KeyValue { .. } | Condition::Feature(_) => false,
+            Condition::KeyValue { .. } | Condition::Feature(_) | Condition::TargetFeature(_) => {
+                false
+            }
             Condition::All(items) | Condition::Any(items) => {
                 items.iter().any(Condition::references_compiler)
             }
             Condition::Not(inner) => inner.references_compiler(),
         }
     }
+
+    /// Whether this condition references any
+    /// `target_feature = "..."` leaf.  Used by the manifest and
+    /// index layers to reject it wherever the profile's
+    /// `target-cpu` is not yet known.
+    pub fn references_target_feature(&self) -> bool {
+        match self {
+            Condition::TargetFeature(_) => true,
+            Condition::KeyValue { .. }
+            | Condition::Feature(_)
+            | Condition::CompilerFamily { .. }
+            | Condition::CompilerVersionReq { .. } => false,
+            Condition::All(items) | Condition::Any(items) => {
+                items.iter().any(Condition::references_target_feature)
+            }
+            Condition::Not(inner) => inner.references_target_feature(),
+        }
+    }
+
+    /// Whether this condition references a compiler leaf for
+    /// `slot`.  Used to decide whether the C compiler must be
+    /// detected even when no C source is compiled: a `cc = "..."`
+    /// layer on a C++-only package still gates its flags.
+    pub fn references_compiler_slot(&self, slot: CompilerSlot) -> bool {
+        match self {
+            Condition::CompilerFamily { slot: leaf, .. }
+            | Condition::CompilerVersionReq { slot: leaf, .. } => *leaf == slot,
+            Condition::KeyValue { .. } | Condition::Feature(_) | Condition::TargetFeature(_) => {
+                false
+            }
+            Condition::All(items) | Condition::Any(items) => {
+                items.iter().any(|item| item.references_compiler_slot(slot))
+            }
+            Condition::Not(inner) => inner.references_compiler_slot(slot),
+        }
+    }
 }
 
 impl fmt::Display for Condition {
@@ -211,6 +260,7 @@ impl fmt::Display for Condition {
         match self {
             Condition::KeyValue { key, value } => write!(f, "{} = \"{}\"", key.as_str(), value),
             Condition::Feature(name) => write!(f, "feature = \"{name}\""),
+            Condition::TargetFeature(name) => write!(f, "target_feature = \"{name}\""),
             Condition::CompilerFamily { slot, family } => {
                 write!(f, "{} = \"{}\"", slot.family_key(), family.as_key())
             }
@@ -445,6 +495,10 @@ pub struct ConditionContext<'a> {
     pub cc: Option<&'a crate::compiler::CompilerIdentity>,
     /// Detected C++ compiler identity, when detection has run.
     pub cxx: Option<&'a crate::compiler::CompilerIdentity>,
+    /// Instruction-set features the selected profile's `target-cpu`
+    /// implies.  Empty unless attached with
+    /// [`Self::with_target_features`].
+    pub target_features: &'a BTreeSet<String>,
 }
 
 static EMPTY_FEATURES: BTreeSet<String> = BTreeSet::new();
@@ -460,6 +514,7 @@ impl<'a> ConditionContext<'a> {
             features: &EMPTY_FEATURES,
             cc: None,
             cxx: None,
+            target_features: &EMPTY_FEATURES,
         }
     }
 
@@ -471,6 +526,7 @@ impl<'a> ConditionContext<'a> {
             features,
             cc: None,
             cxx: None,
+            target_features: &EMPTY_FEATURES,
         }
     }
 
@@ -486,6 +542,14 @@ impl<'a> ConditionContext<'a> {
         self
     }
 
+    /// Attach the selected profile's target features
+    /// (flag-resolution path).
+    #[must_use]
+    pub fn with_target_features(mut self, target_features: &'a BTreeSet<String>) -> Self {
+        self.target_features = target_features;
+        self
+    }
+
     /// Detected identity for `slot`, when available.
     pub fn identity(&self, slot: CompilerSlot) -> Option<&'a crate::compiler::CompilerIdentity> {
         match slot {
@@ -509,7 +573,7 @@ pub enum ConditionParseError {
     UnbalancedParens(String),
 
     #[error(
-        "unsupported target cfg key {key:?}; supported keys are os, arch, family, env, abi, target, cc, cxx, cc_version, cxx_version, and feature"
+        "unsupported target cfg key {key:?}; supported keys are os, arch, family, env, abi, target, cc, cxx, cc_version, cxx_version, target_feature, and feature"
     )]
     UnsupportedKey { key: String },
 
@@ -685,6 +749,8 @@ impl<'a> Parser<'a> {
         }
         if key == "feature" {
             Ok(Condition::Feature(value))
+        } else if key == "target_feature" {
+            Ok(Condition::TargetFeature(value))
         } else {
             let key =
                 ConditionKey::from_str(key).map_err(|()| ConditionParseError::UnsupportedKey {
@@ -993,6 +1059,44 @@ mod tests {
         }
     }
 
+    #[test]
+    fn target_feature_evaluates_against_the_attached_set() {
+        let platform = linux_x86_64();
+        let cond = Condition::parse_cfg(r#"cfg(target_feature = "avx2")"#).unwrap();
+        assert_eq!(cond, Condition::TargetFeature("avx2".to_owned()));
+        assert_eq!(cond.to_string(), r#"target_feature = "avx2""#);
+        assert!(cond.references_target_feature());
+        assert!(!cond.references_compiler() && !cond.references_feature());
+        // No target CPU attached: no feature matches.
+        assert!(!cond.evaluate(&ConditionContext::platform_only(&platform)));
+        let features = crate::TargetCpu::parse("x86-64-v3")
+            .unwrap()
+            .target_features();
+        let ctx = ConditionContext::platform_only(&platform).with_target_features(&features);
+        assert!(cond.evaluate(&ctx));
+        let v4_only = Condition::parse_cfg(r#"cfg(target_feature = "avx512f")"#).unwrap();
+        assert!(!v4_only.evaluate(&ctx));
+    }
+
+    #[test]
+    fn references_compiler_slot_distinguishes_cc_from_cxx() {
+        for (raw, cc, cxx) in [
+            (r#"cxx = "clang""#, false, true),
+            (r#"cc_version = ">=12""#, true, false),
+            (r#"any(os = "linux", not(cc = "msvc"))"#, true, false),
+            (r#"all(cc = "gcc", cxx = "gcc")"#, true, true),
+            (r#"feature = "simd""#, false, false),
+        ] {
+            let cond = Condition::parse_inner(raw).unwrap();
+            assert_eq!(cond.references_compiler_slot(CompilerSlot::Cc), cc, "{raw}");
+            assert_eq!(
+                cond.references_compiler_slot(CompilerSlot::Cxx),
+                cxx,
+                "{raw}"
+            );
+        }
+    }
+
     fn linux_x86_64() -> TargetPlatform {
         TargetPlatform {
             os: "linux".into(),
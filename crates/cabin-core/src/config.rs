@@ -598,6 +598,54 @@ fn bool_bytes(b: bool) -> &'static [u8] {
     if b { b"true" } else { b"false" }
 }
 
+/// Per-package configurations carry the profile already narrowed by
+/// `ResolvedProfile::for_package`, so the override table is usually
+/// empty here; hashing it only when present keeps fingerprints of
+/// profiles without overrides unchanged.
+fn hash_package_overrides(hasher: &mut Sha256, profile: &ResolvedProfile) {
+    if profile.package_overrides.is_empty() {
+        return;
+    }
+    hasher.update(b"package-overrides\n");
+    for (selector, layer) in &profile.package_overrides {
+        hasher.update(selector.to_string().as_bytes());
+        hasher.update(b":");
+        if let Some(opt_level) = layer.opt_level {
+            hasher.update(b" opt-level=");
+            hasher.update(opt_level.as_str().as_bytes());
+        }
+        if let Some(debug) = layer.debug {
+            hasher.update(b" debug=");
+            hasher.update(bool_bytes(debug));
+        }
+        if let Some(assertions) = layer.assertions {
+            hasher.update(b" assertions=");
+            hasher.update(bool_bytes(assertions));
+        }
+        hasher.update(b"\n");
+    }
+}
+
+/// Hashed only when set, so profiles without a `target-cpu` keep
+/// their fingerprints.  `native` also hashes the features it
+/// resolved to on this host: the same profile built on two
+/// machines with different CPUs must not share cached objects.
+fn hash_target_cpu(hasher: &mut Sha256, profile: &ResolvedProfile) {
+    let Some(cpu) = profile.target_cpu.as_ref() else {
+        return;
+    };
+    hasher.update(b"target-cpu=");
+    hasher.update(cpu.as_str().as_bytes());
+    hasher.update(b"\n");
+    if *cpu == crate::TargetCpu::Native {
+        for feature in cpu.target_features() {
+            hasher.update(b"target-feature=");
+            hasher.update(feature.as_bytes());
+            hasher.update(b"\n");
+        }
+    }
+}
+
 fn compute_fingerprint(
     features: &BTreeSet<String>,
     profile: &ResolvedProfile,
@@ -626,6 +674,11 @@ fn compute_fingerprint(
     hasher.update(b"assertions=");
     hasher.update(bool_bytes(profile.assertions));
     hasher.update(b"\n");
+    hasher.update(b"thin-archives=");
+    hasher.update(bool_bytes(profile.thin_archives));
+    hasher.update(b"\n");
+    hash_target_cpu(&mut hasher, profile);
+    hash_package_overrides(&mut hasher, profile);
     hasher.update(b"toolchain\n");
     for (kind, spec) in &toolchain.tools {
         hasher.update(kind.as_bytes());
@@ -1062,6 +1115,31 @@ mod tests {
         .unwrap()
     }
 
+    #[test]
+    fn fingerprint_differs_across_target_cpus() {
+        let with_cpu = |cpu: Option<&str>| {
+            let mut profile = dev();
+            profile.target_cpu = cpu.map(|raw| crate::TargetCpu::parse(raw).unwrap());
+            BuildConfiguration::resolve(BuildConfigurationInput {
+                package: "demo",
+                features: &Features::default(),
+                request: &SelectionRequest::default(),
+                profile,
+                toolchain: ToolchainSummary::default(),
+                build_flags: ResolvedProfileFlags::default(),
+                language: LanguageStandardsSummary::default(),
+            })
+            .unwrap()
+            .fingerprint
+        };
+        let unset = with_cpu(None);
+        let v2 = with_cpu(Some("x86-64-v2"));
+        let v3 = with_cpu(Some("x86-64-v3"));
+        assert_ne!(unset, v2);
+        assert_ne!(v2, v3);
+        assert_ne!(v3, with_cpu(Some("native")));
+    }
+
     #[test]
     fn fingerprint_differs_when_package_cxx_standard_changes() {
         use crate::language_standard::{CxxStandard, LanguageStandardSource, ResolvedStandard};
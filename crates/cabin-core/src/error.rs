@@ -86,4 +86,9 @@ pub enum ValidationError {
         "target {target:?} requires unknown feature {feature:?}; `required-features` entries must name features declared in this package's `[features]` table"
     )]
     UnknownRequiredFeature { target: String, feature: String },
+
+    #[error(
+        "target CPU {0:?} is not valid; a target CPU is `native`, an x86-64 level such as `x86-64-v3`, or a CPU name of ASCII letters, ASCII digits, `-`, `_`, `.`, and `+` starting with a letter or digit"
+    )]
+    InvalidTargetCpu(String),
 }
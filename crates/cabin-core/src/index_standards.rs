@@ -397,6 +397,8 @@ mod tests {
             deps: Vec::new(),
             required_features: Vec::new(),
             language,
+            data: Vec::new(),
+            harness: None,
         }
     }
 
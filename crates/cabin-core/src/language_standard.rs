@@ -1346,6 +1346,8 @@ mod tests {
             deps: Vec::new(),
             required_features: Vec::new(),
             language,
+            data: Vec::new(),
+            harness: None,
         }
     }
 
@@ -2190,6 +2192,8 @@ mod tests {
                         gnu_extensions: Some(true),
                         ..Default::default()
                     },
+                    data: Vec::new(),
+                    harness: None,
                 },
             ],
             Vec::new(),
@@ -28,9 +28,11 @@ pub mod patch;
 pub mod process;
 pub mod profile;
 pub mod registry;
+pub mod remote_execution;
 pub mod source_language;
 pub mod source_replacement;
 pub mod standard_compatibility;
+pub mod target_cpu;
 pub mod term_color;
 pub mod term_verbosity;
 pub mod toolchain;
@@ -46,9 +48,9 @@ pub use compiler::{
     CompilerCapabilities, CompilerIdentity, CompilerKind, CompilerVersion, ToolDetection,
     ToolDetectionError, ToolchainDetectionReport, c_standard_capability, cxx_standard_capability,
     derive_ar_capabilities, derive_cxx_capabilities, parse_ar_version_output,
-    parse_cxx_version_output, standard_support_detail, validate_ar_for_backend,
-    validate_c_standards, validate_cc_for_backend, validate_cxx_for_backend,
-    validate_cxx_standards,
+    parse_cxx_version_output, standard_support_detail, target_cpu_capability,
+    validate_ar_for_backend, validate_c_standards, validate_cc_for_backend,
+    validate_cxx_for_backend, validate_cxx_standards, validate_target_cpu,
 };
 pub use compiler_wrapper::{
     CompilerWrapperIdentity, CompilerWrapperKind, CompilerWrapperParseError,
@@ -77,19 +79,23 @@ pub use language_standard::{
     resolve_language_standards,
 };
 pub use model::{
-    Dependency, DependencyKind, DependencySource, Package, PackageConfigInput, PackageName,
-    PortDepSource, SystemDependency, Target, TargetDep, TargetKind, TargetName,
-    WorkspaceDepRequirements, is_path_safe_package_name, is_valid_package_scope,
+    CustomTestHarness, Dependency, DependencyKind, DependencySource, Package, PackageConfigInput,
+    PackageName, PortDepSource, SystemDependency, Target, TargetDep, TargetKind, TargetName,
+    TestHarness, WorkspaceDepRequirements, is_path_safe_package_name, is_valid_package_scope,
 };
 pub use patch::{
     PatchManifestSettings, PatchProvenance, PatchSource, PatchSourceKind, PatchValidationError,
 };
 pub use process::{ExitStatusKind, exit_status_kind};
 pub use profile::{
-    BuiltinProfile, InvalidProfileName, OptLevel, ProfileDefaults, ProfileDefinition, ProfileName,
+    BuiltinProfile, InvalidProfileName, OptLevel, PackageCodegen, ProfileDefaults,
+    ProfileDefinition, ProfileName, ProfilePackageOverride, ProfilePackageSelector,
     ProfileResolutionError, ProfileSelection, ProfileSource, ResolvedProfile,
     available_profile_names, resolve_profile,
 };
+pub use remote_execution::{
+    REMOTE_EXECUTION_LAUNCHER, RemoteExecutionError, RemoteExecutionSettings,
+};
 pub use source_language::{SourceLanguage, classify_source, link_driver_language};
 pub use source_replacement::{
     SourceLocator, SourceReplacementEntry, SourceReplacementError, SourceReplacementResolution,
@@ -98,6 +104,7 @@ pub use source_replacement::{
 pub use standard_compatibility::{
     BoundedRange, IncompatibleStandards, Requirement, UnknownIncompatibleStandards,
 };
+pub use target_cpu::{TargetArch, TargetCpu, X86Level};
 pub use term_color::{ColorChoice, ColorEnvError, InvalidColorChoice};
 pub use term_verbosity::{InvalidVerbosityCombination, Verbosity, VerbosityEnvError};
 pub use toolchain::{
@@ -363,6 +363,11 @@ pub enum TargetKind {
     /// selected target.
     #[serde(rename = "example")]
     Example,
+    /// A benchmark executable.  Built (with the `release` profile
+    /// by default) and run by `cabin bench`.  Excluded from the
+    /// default `cabin build` selection.
+    #[serde(rename = "bench")]
+    Bench,
 }
 
 impl TargetKind {
@@ -373,6 +378,7 @@ impl TargetKind {
             Self::Executable => "executable",
             Self::Test => "test",
             Self::Example => "example",
+            Self::Bench => "bench",
         }
     }
 
@@ -385,13 +391,17 @@ impl TargetKind {
             Self::Executable,
             Self::Test,
             Self::Example,
+            Self::Bench,
         ]
     }
 
     /// Whether this kind produces an executable (linked binary).
     /// Library kinds return `false`.
     pub const fn produces_executable(self) -> bool {
-        matches!(self, Self::Executable | Self::Test | Self::Example)
+        matches!(
+            self,
+            Self::Executable | Self::Test | Self::Example | Self::Bench
+        )
     }
 
     /// Whether this kind produces a static-archive library (`lib<name>.a`).
@@ -414,10 +424,10 @@ impl TargetKind {
     }
 
     /// Whether ordinary `cabin build` selects this kind by default.
-    /// Dev-only kinds (`test` / `example`) are excluded
+    /// Dev-only kinds (`test` / `example` / `bench`) are excluded
     /// from the default set: tests are built by `cabin test`,
-    /// and examples only reach the build graph as a
-    /// transitive dep of another selected target.
+    /// benchmarks by `cabin bench`, and examples only reach the
+    /// build graph as a transitive dep of another selected target.
     ///
     /// Header-only libraries are included so the dependency
     /// closure walk reaches them; the planner emits no compile or
@@ -431,9 +441,9 @@ impl TargetKind {
     /// that exists to support workspace development but is not part
     /// of the package's public surface.  Production callers use this
     /// to decide whether dev-dependencies should be activated and
-    /// whether the target may be run by `cabin test`.
+    /// whether the target may be run by `cabin test` / `cabin bench`.
     pub const fn is_dev_only(self) -> bool {
-        matches!(self, Self::Test | Self::Example)
+        matches!(self, Self::Test | Self::Example | Self::Bench)
     }
 
     /// Whether `cabin test` runs this kind after building it.  Today
@@ -617,6 +627,48 @@ pub struct Target {
     /// executable-like targets.
     #[serde(default, skip_serializing_if = "LanguageStandardSettings::is_empty")]
     pub language: LanguageStandardSettings,
+    /// Files and directories, relative to the package root, that a
+    /// `test` target reads at run time.  Their contents key the
+    /// `cabin test` result cache next to the executable itself.
+    /// The manifest parser rejects it on every other kind.
+    #[serde(default, skip_serializing_if = "Vec::is_empty")]
+    pub data: Vec<Utf8PathBuf>,
+    /// In-binary test-case harness of a `test` target.  When set,
+    /// `cabin test` enumerates the binary's cases and runs them as
+    /// filtered sub-invocations across worker processes; `None`
+    /// runs the executable as one unit.  The manifest parser
+    /// rejects it on every other kind.
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub harness: Option<TestHarness>,
+}
+
+/// How `cabin test` lists and selects the cases inside one test
+/// binary (`harness = "gtest"`, `"catch2"`, or a `{ list, filter }`
+/// table on a `test` target).
+#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
+#[serde(rename_all = "kebab-case")]
+pub enum TestHarness {
+    /// Google Test: `--gtest_list_tests` / `--gtest_filter`.
+    Gtest,
+    /// Catch2 v3: `--list-tests --verbosity quiet` / test-spec
+    /// arguments.
+    Catch2,
+    /// Any other framework, described by its listing arguments and
+    /// filter argument template.
+    Custom(CustomTestHarness),
+}
+
+/// A manifest-described test harness.
+#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
+pub struct CustomTestHarness {
+    /// Arguments that make the binary print one case name per line
+    /// on stdout and exit `0` without running anything.
+    pub list: Vec<String>,
+    /// Argument selecting a batch of cases; every `{}` is replaced
+    /// by the batch's case names joined with `separator`.
+    pub filter: String,
+    /// Joins case names inside `filter`.
+    pub separator: String,
 }
 
 impl Target {
@@ -1251,6 +1303,8 @@ mod tests {
             deps: deps.iter().map(|d| TargetDep::from(*d)).collect(),
             required_features: Vec::new(),
             language: LanguageStandardSettings::default(),
+            data: Vec::new(),
+            harness: None,
         }
     }
 
@@ -1885,7 +1939,7 @@ mod tests {
         }
         // The dev-only kinds: `cabin build` ignores them; `cabin
         // test` runs `test` only.
-        for kind in [TargetKind::Test, TargetKind::Example] {
+        for kind in [TargetKind::Test, TargetKind::Example, TargetKind::Bench] {
             assert!(
                 !kind.is_default_buildable(),
                 "{kind} must NOT be default-buildable"
@@ -1895,6 +1949,7 @@ mod tests {
         }
         assert!(TargetKind::Test.is_test());
         assert!(!TargetKind::Example.is_test());
+        assert!(!TargetKind::Bench.is_test());
     }
 
     #[test]
@@ -1904,6 +1959,7 @@ mod tests {
         assert!(TargetKind::Executable.produces_executable());
         assert!(TargetKind::Test.produces_executable());
         assert!(TargetKind::Example.produces_executable());
+        assert!(TargetKind::Bench.produces_executable());
     }
 
     #[test]
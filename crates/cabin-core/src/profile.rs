@@ -9,6 +9,17 @@
 //! - `release` - optimized builds.  Debug info off, full
 //!   optimization, assertions off.
 //!
+//! Both built-ins archive static libraries the classic way; a
+//! profile opts into thin archives with `thin-archives = true`.
+//! Neither sets a `target-cpu`, so compiles target the compiler's
+//! default CPU until a profile names one.
+//!
+//! `[profile.<name>.package.<spec>]` tables override `opt-level`,
+//! `debug`, and `assertions` for some packages only: `"*"` matches
+//! every package outside the workspace, a package name matches that
+//! package and wins over `"*"`.  The usual use is optimizing heavy
+//! dependencies in `dev` while first-party code stays debuggable.
+//!
 //! Manifests may declare additional `[profile.<name>]` tables to
 //! override the built-in defaults or to add custom presets that
 //! `inherit` from one of the built-ins.  Resolution merges
@@ -27,6 +38,10 @@ use std::fmt;
 use serde::{Deserialize, Serialize};
 use thiserror::Error;
 
+use crate::error::ValidationError;
+use crate::model::PackageName;
+use crate::target_cpu::TargetCpu;
+
 /// One of the two profiles Cabin always provides without any
 /// manifest declaration.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
@@ -57,11 +72,13 @@ impl BuiltinProfile {
                 debug: true,
                 opt_level: OptLevel::O0,
                 assertions: true,
+                thin_archives: false,
             },
             BuiltinProfile::Release => ProfileDefaults {
                 debug: false,
                 opt_level: OptLevel::O3,
                 assertions: false,
+                thin_archives: false,
             },
         }
     }
@@ -89,6 +106,7 @@ pub struct ProfileDefaults {
     pub debug: bool,
     pub opt_level: OptLevel,
     pub assertions: bool,
+    pub thin_archives: bool,
 }
 
 /// Semantic optimization level.  Mirrors the GCC / Clang `-O`
@@ -327,12 +345,118 @@ pub struct ProfileDefinition {
     pub opt_level: Option<OptLevel>,
     #[serde(default, skip_serializing_if = "Option::is_none")]
     pub assertions: Option<bool>,
+    /// Archive static libraries as thin archives that reference
+    /// their member objects instead of copying them.  Only honoured
+    /// when the detected archiver supports it.
+    #[serde(
+        default,
+        rename = "thin-archives",
+        skip_serializing_if = "Option::is_none"
+    )]
+    pub thin_archives: Option<bool>,
+    /// CPU / ISA level every compile targets.  Unset leaves the
+    /// compiler's default.
+    #[serde(
+        default,
+        rename = "target-cpu",
+        skip_serializing_if = "Option::is_none"
+    )]
+    pub target_cpu: Option<TargetCpu>,
     /// Per-profile flag overrides for `[profile.<name>]` - defines,
     /// include directories, and extra compile / link arguments that
     /// apply when this profile is selected.  `None` when the profile
     /// has no flag overrides.
     #[serde(default, skip_serializing_if = "Option::is_none")]
     pub build: Option<crate::build_flags::ProfileFlags>,
+    /// `[profile.<name>.package.<spec>]` overrides, keyed by the
+    /// packages they select.
+    #[serde(default, skip_serializing_if = "BTreeMap::is_empty")]
+    pub package: BTreeMap<ProfilePackageSelector, ProfilePackageOverride>,
+}
+
+/// Which packages a `[profile.<name>.package.<spec>]` table
+/// applies to.
+#[derive(Debug, Clone, PartialEq, Eq, PartialOrd, Ord, Hash, Serialize, Deserialize)]
+#[serde(try_from = "String", into = "String")]
+pub enum ProfilePackageSelector {
+    /// `"*"` - every package that is not a workspace member (or,
+    /// outside a workspace, not the root package).
+    Dependencies,
+    /// One package by name.  Takes precedence over `"*"`.
+    Package(PackageName),
+}
+
+impl ProfilePackageSelector {
+    /// Parse the table key: `"*"` or a package name.
+    ///
+    /// # Errors
+    /// Returns the [`ValidationError`] [`PackageName::new`] reports
+    /// when `raw` is neither `"*"` nor a valid package name.
+    pub fn parse(raw: &str) -> Result<Self, ValidationError> {
+        if raw == "*" {
+            return Ok(Self::Dependencies);
+        }
+        PackageName::new(raw).map(Self::Package)
+    }
+}
+
+impl fmt::Display for ProfilePackageSelector {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Self::Dependencies => f.write_str("*"),
+            Self::Package(name) => f.write_str(name.as_str()),
+        }
+    }
+}
+
+impl TryFrom<String> for ProfilePackageSelector {
+    type Error = ValidationError;
+    fn try_from(value: String) -> Result<Self, Self::Error> {
+        Self::parse(&value)
+    }
+}
+
+impl From<ProfilePackageSelector> for String {
+    fn from(selector: ProfilePackageSelector) -> Self {
+        selector.to_string()
+    }
+}
+
+/// One `[profile.<name>.package.<spec>]` table.  Only the
+/// code-generation scalars can vary per package; flags, archive
+/// shape and the output directory stay profile-wide.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq, Serialize, Deserialize)]
+pub struct ProfilePackageOverride {
+    #[serde(default, rename = "opt-level", skip_serializing_if = "Option::is_none")]
+    pub opt_level: Option<OptLevel>,
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub debug: Option<bool>,
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub assertions: Option<bool>,
+}
+
+impl ProfilePackageOverride {
+    /// Overlay `layer` on `self`; fields `layer` sets win.
+    fn merge(&mut self, layer: ProfilePackageOverride) {
+        if layer.opt_level.is_some() {
+            self.opt_level = layer.opt_level;
+        }
+        if layer.debug.is_some() {
+            self.debug = layer.debug;
+        }
+        if layer.assertions.is_some() {
+            self.assertions = layer.assertions;
+        }
+    }
+}
+
+/// The code-generation settings one package compiles with: the
+/// profile's scalars after any matching package override.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct PackageCodegen {
+    pub opt_level: OptLevel,
+    pub debug: bool,
+    pub assertions: bool,
 }
 
 /// User-facing profile selection (one CLI invocation picks at
@@ -392,6 +516,15 @@ pub struct ResolvedProfile {
     pub debug: bool,
     pub opt_level: OptLevel,
     pub assertions: bool,
+    /// Requested thin static archives.  The planner still falls
+    /// back to classic archives when the archiver cannot produce
+    /// them.
+    pub thin_archives: bool,
+    /// CPU / ISA level every compile targets; `None` leaves the
+    /// compiler's default.  The leaf-most profile in
+    /// `inherits_chain` that sets it wins.
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    pub target_cpu: Option<TargetCpu>,
     pub source: ProfileSource,
     /// Chain of profile names walked by inheritance, root first.
     /// For built-ins this is `[name]`; for a custom profile that
@@ -419,18 +552,69 @@ pub struct ResolvedProfile {
     /// here.
     #[serde(skip)]
     pub build: Option<crate::build_flags::ProfileFlags>,
+    /// Per-package overrides merged root-first across
+    /// `inherits_chain`.  Read through [`Self::codegen_for`].
+    #[serde(default, skip_serializing_if = "BTreeMap::is_empty")]
+    pub package_overrides: BTreeMap<ProfilePackageSelector, ProfilePackageOverride>,
 }
 
 impl ResolvedProfile {
+    /// The settings `package` compiles with.  `member` is whether
+    /// the package belongs to the workspace (or is the root
+    /// package); only non-members match `"*"`.  A named override
+    /// is layered over the `"*"` one, so its fields win where both
+    /// are set.
+    pub fn codegen_for(&self, package: &PackageName, member: bool) -> PackageCodegen {
+        let mut merged = ProfilePackageOverride::default();
+        if !member
+            && let Some(all) = self
+                .package_overrides
+                .get(&ProfilePackageSelector::Dependencies)
+        {
+            merged.merge(*all);
+        }
+        if let Some(named) = self
+            .package_overrides
+            .get(&ProfilePackageSelector::Package(package.clone()))
+        {
+            merged.merge(*named);
+        }
+        PackageCodegen {
+            opt_level: merged.opt_level.unwrap_or(self.opt_level),
+            debug: merged.debug.unwrap_or(self.debug),
+            assertions: merged.assertions.unwrap_or(self.assertions),
+        }
+    }
+
+    /// This profile as `package` sees it: the scalars replaced by
+    /// [`Self::codegen_for`] and the override table dropped, so a
+    /// per-package build configuration fingerprints exactly the
+    /// settings its compiles use.
+    #[must_use]
+    pub fn for_package(&self, package: &PackageName, member: bool) -> ResolvedProfile {
+        let codegen = self.codegen_for(package, member);
+        ResolvedProfile {
+            debug: codegen.debug,
+            opt_level: codegen.opt_level,
+            assertions: codegen.assertions,
+            package_overrides: BTreeMap::new(),
+            ..self.clone()
+        }
+    }
+
     /// Compact JSON view used by `cabin metadata` and by
     /// `CABIN_BUILD_CONFIGURATION_JSON`.  Field order matches the
-    /// struct declaration order so the on-disk shape is stable.
+    /// struct declaration order so the on-disk shape is stable;
+    /// `package_overrides` is only present when the profile has
+    /// some.
     pub fn as_json(&self) -> serde_json::Value {
-        serde_json::json!({
+        let mut json = serde_json::json!({
             "name": self.name.as_str(),
             "debug": self.debug,
             "opt_level": self.opt_level.as_str(),
             "assertions": self.assertions,
+            "thin_archives": self.thin_archives,
+            "target_cpu": self.target_cpu.as_ref().map(TargetCpu::as_str),
             "source": match self.source {
                 ProfileSource::Builtin => "builtin",
                 ProfileSource::BuiltinOverridden => "builtin-overridden",
@@ -441,7 +625,28 @@ impl ResolvedProfile {
                 .iter()
                 .map(ProfileName::as_str)
                 .collect::<Vec<_>>(),
-        })
+        });
+        if !self.package_overrides.is_empty() {
+            let overrides: serde_json::Map<String, serde_json::Value> = self
+                .package_overrides
+                .iter()
+                .map(|(selector, layer)| {
+                    let mut fields = serde_json::Map::new();
+                    if let Some(opt_level) = layer.opt_level {
+                        fields.insert("opt_level".to_owned(), opt_level.as_str().into());
+                    }
+                    if let Some(debug) = layer.debug {
+                        fields.insert("debug".to_owned(), debug.into());
+                    }
+                    if let Some(assertions) = layer.assertions {
+                        fields.insert("assertions".to_owned(), assertions.into());
+                    }
+                    (selector.to_string(), fields.into())
+                })
+                .collect();
+            json["package_overrides"] = overrides.into();
+        }
+        json
     }
 
     /// Compute the language-neutral compile flags this profile
@@ -524,8 +729,12 @@ fn display_chain(chain: &[String]) -> String {
 ///
 /// Merge semantics across the inherits chain:
 ///
-/// - **Scalar fields** (`opt-level`, `debug`, `assertions`) use
+/// - **Scalar fields** (`opt-level`, `debug`, `assertions`,
+///   `thin-archives`) use
 ///   **replacement** - root first, child later, later wins.
+/// - **Package overrides** merge per selector with the same
+///   field-wise replacement, so a child profile can change one
+///   field of its parent's `[package."*"]` table and keep the rest.
 /// - **Array fields** in
 ///   [`ProfileDefinition::build`] (`cflags`, `cxxflags`,
 ///   `ldflags`, `defines`, `include-dirs`) use **append**:
@@ -620,6 +829,7 @@ pub fn resolve_profile(
     let mut debug = defaults.debug;
     let mut opt_level = defaults.opt_level;
     let mut assertions = defaults.assertions;
+    let mut thin_archives = defaults.thin_archives;
     // Per-profile flag arrays merge with **append** semantics
     // across the inherits chain - root → selected.  Scalars
     // above use replacement (later wins); arrays here use
@@ -637,6 +847,9 @@ pub fn resolve_profile(
             if let Some(a) = def.assertions {
                 assertions = a;
             }
+            if let Some(t) = def.thin_archives {
+                thin_archives = t;
+            }
             if let Some(layer) = def.build.as_ref() {
                 let acc =
                     merged_build.get_or_insert_with(crate::build_flags::ProfileFlags::default);
@@ -660,12 +873,34 @@ pub fn resolve_profile(
         debug,
         opt_level,
         assertions,
+        thin_archives,
+        target_cpu: chain
+            .iter()
+            .rev()
+            .filter_map(|step| definitions.get(step))
+            .find_map(|def| def.target_cpu.clone()),
         source,
-        inherits_chain: chain,
         build: merged_build,
+        package_overrides: merge_package_overrides(&chain, definitions),
+        inherits_chain: chain,
     })
 }
 
+/// Fold every `[profile.<name>.package.<spec>]` table along `chain`
+/// (root first), field by field per selector.
+fn merge_package_overrides(
+    chain: &[ProfileName],
+    definitions: &BTreeMap<ProfileName, ProfileDefinition>,
+) -> BTreeMap<ProfilePackageSelector, ProfilePackageOverride> {
+    let mut merged: BTreeMap<ProfilePackageSelector, ProfilePackageOverride> = BTreeMap::new();
+    for def in chain.iter().filter_map(|step| definitions.get(step)) {
+        for (selector, layer) in &def.package {
+            merged.entry(selector.clone()).or_default().merge(*layer);
+        }
+    }
+    merged
+}
+
 /// Whole-table validation: every custom profile declares
 /// `inherits`, no built-in declares it, and inherits-targets are
 /// known.  Cycles are caught in [`resolve_profile`] when the chain
@@ -738,7 +973,10 @@ mod tests {
             debug,
             opt_level: opt,
             assertions,
+            thin_archives: None,
+            target_cpu: None,
             build: None,
+            package: BTreeMap::new(),
         };
         (profile_name, def)
     }
@@ -858,7 +1096,10 @@ mod tests {
             debug,
             opt_level: opt,
             assertions,
+            thin_archives: None,
+            target_cpu: None,
             build,
+            package: BTreeMap::new(),
         };
         (profile_name, def)
     }
@@ -890,6 +1131,23 @@ mod tests {
         assert_eq!(build.cxxflags, vec!["-O3".to_owned(), "-pg".to_owned()]);
     }
 
+    #[test]
+    fn target_cpu_is_inherited_and_the_leaf_wins() {
+        let cpu = |raw: &str| Some(TargetCpu::parse(raw).unwrap());
+        let (release, mut release_def) = def_full("release", None, None, None, None, None);
+        release_def.target_cpu = cpu("x86-64-v3");
+        let fleet = def_full("fleet", Some("release"), None, None, None, None);
+        let (native, mut native_def) = def_full("local", Some("fleet"), None, None, None, None);
+        native_def.target_cpu = cpu("native");
+        let d = defs(vec![(release, release_def), fleet, (native, native_def)]);
+        let pick = |n: &str| resolve_profile(&ProfileSelection::from_name(name(n)), &d).unwrap();
+        assert_eq!(pick("fleet").target_cpu, cpu("x86-64-v3"));
+        assert_eq!(pick("local").target_cpu, cpu("native"));
+        assert_eq!(pick("fleet").as_json()["target_cpu"], "x86-64-v3");
+        assert!(pick("dev").target_cpu.is_none());
+        assert!(pick("dev").as_json()["target_cpu"].is_null());
+    }
+
     #[test]
     fn parent_build_inherited_when_leaf_has_no_build() {
         let d = defs(vec![
@@ -986,6 +1244,114 @@ mod tests {
         );
     }
 
+    fn with_packages(
+        (profile_name, mut def): (ProfileName, ProfileDefinition),
+        overrides: &[(&str, ProfilePackageOverride)],
+    ) -> (ProfileName, ProfileDefinition) {
+        def.package = overrides
+            .iter()
+            .map(|(spec, layer)| (ProfilePackageSelector::parse(spec).unwrap(), *layer))
+            .collect();
+        (profile_name, def)
+    }
+
+    fn pkg(s: &str) -> PackageName {
+        PackageName::new(s).unwrap()
+    }
+
+    #[test]
+    fn package_overrides_merge_field_wise_across_inheritance() {
+        let d = defs(vec![
+            with_packages(
+                def("dev", None, None, None, None),
+                &[(
+                    "*",
+                    ProfilePackageOverride {
+                        opt_level: Some(OptLevel::O2),
+                        debug: Some(false),
+                        assertions: None,
+                    },
+                )],
+            ),
+            with_packages(
+                def("dev-fast", Some("dev"), None, None, None),
+                &[(
+                    "*",
+                    ProfilePackageOverride {
+                        opt_level: Some(OptLevel::O3),
+                        ..Default::default()
+                    },
+                )],
+            ),
+        ]);
+        let r = resolve_profile(&ProfileSelection::from_name(name("dev-fast")), &d).unwrap();
+        let codegen = r.codegen_for(&pkg("zlib"), false);
+        assert_eq!(
+            codegen.opt_level,
+            OptLevel::O3,
+            "leaf opt-level replaces parent"
+        );
+        assert!(!codegen.debug, "parent debug survives the leaf layer");
+        assert!(codegen.assertions, "unset fields fall back to the profile");
+    }
+
+    #[test]
+    fn named_package_override_beats_star_and_star_skips_members() {
+        let d = defs(vec![with_packages(
+            def("dev", None, None, None, None),
+            &[
+                (
+                    "*",
+                    ProfilePackageOverride {
+                        opt_level: Some(OptLevel::O2),
+                        debug: Some(false),
+                        assertions: None,
+                    },
+                ),
+                (
+                    "fmt",
+                    ProfilePackageOverride {
+                        opt_level: Some(OptLevel::S),
+                        ..Default::default()
+                    },
+                ),
+            ],
+        )]);
+        let r = resolve_profile(&ProfileSelection::default_dev(), &d).unwrap();
+        let fmt = r.codegen_for(&pkg("fmt"), false);
+        assert_eq!((fmt.opt_level, fmt.debug), (OptLevel::S, false));
+        // Members never match `"*"`, but a named override still
+        // applies to them.
+        let app = r.codegen_for(&pkg("app"), true);
+        assert_eq!((app.opt_level, app.debug), (OptLevel::O0, true));
+        let member_fmt = r.codegen_for(&pkg("fmt"), true);
+        assert_eq!(
+            (member_fmt.opt_level, member_fmt.debug),
+            (OptLevel::S, true)
+        );
+
+        let narrowed = r.for_package(&pkg("zlib"), false);
+        assert_eq!(narrowed.opt_level, OptLevel::O2);
+        assert!(!narrowed.debug);
+        assert!(narrowed.package_overrides.is_empty());
+        assert_eq!(narrowed.as_json()["opt_level"], "2");
+        assert_eq!(r.as_json()["package_overrides"]["fmt"]["opt_level"], "s");
+    }
+
+    #[test]
+    fn package_selector_parses_star_and_package_names() {
+        assert_eq!(
+            ProfilePackageSelector::parse("*").unwrap(),
+            ProfilePackageSelector::Dependencies
+        );
+        assert_eq!(
+            ProfilePackageSelector::parse("fmt").unwrap(),
+            ProfilePackageSelector::Package(pkg("fmt"))
+        );
+        assert!(ProfilePackageSelector::parse("two words").is_err());
+        assert_eq!(ProfilePackageSelector::Dependencies.to_string(), "*");
+    }
+
     #[test]
     fn unknown_profile_selection_errors() {
         let err = resolve_profile(
@@ -1102,9 +1468,12 @@ mod tests {
             debug: true,
             opt_level: OptLevel::O0,
             assertions: true,
+            thin_archives: false,
+            target_cpu: None,
             source: ProfileSource::Builtin,
             inherits_chain: vec![name("dev")],
             build: None,
+            package_overrides: BTreeMap::new(),
         };
         assert_eq!(r.compile_flags(), vec!["-O0", "-g"]);
 
@@ -1113,9 +1482,12 @@ mod tests {
             debug: false,
             opt_level: OptLevel::O3,
             assertions: false,
+            thin_archives: false,
+            target_cpu: None,
             source: ProfileSource::Builtin,
             inherits_chain: vec![name("release")],
             build: None,
+            package_overrides: BTreeMap::new(),
         };
         assert_eq!(r.compile_flags(), vec!["-O3", "-DNDEBUG"]);
     }
@@ -1127,9 +1499,12 @@ mod tests {
             debug: true,
             opt_level: OptLevel::O2,
             assertions: false,
+            thin_archives: false,
+            target_cpu: None,
             source: ProfileSource::Builtin,
             inherits_chain: vec![name("dev")],
             build: None,
+            package_overrides: BTreeMap::new(),
         };
         assert_eq!(r.compile_flags(), vec!["-O2", "-g", "-DNDEBUG"]);
     }
@@ -0,0 +1,200 @@
+//! Typed model for remote execution of compile actions.
+//!
+//! Cabin does not speak the Remote Execution API (REAPI) itself.
+//! Compile actions reach a REAPI cluster (Buildbarn, Buildfarm,
+//! and similar) through a REAPI compile launcher in the
+//! compiler-wrapper slot - [`REMOTE_EXECUTION_LAUNCHER`] - which
+//! uploads the source, every header the compiler's dependency
+//! output names, and the argv to the CAS, runs the action remotely,
+//! and downloads its outputs.  Archive and link steps never pass
+//! through the wrapper, so they stay local.
+//!
+//! This module owns the validated `[build.remote-execution]`
+//! settings and the launcher environment derived from them.  Config
+//! parsing lives in `cabin-config`; handing the environment to the
+//! build backend lives in `cabin`.
+
+use std::collections::BTreeMap;
+
+use camino::Utf8Path;
+use thiserror::Error;
+
+/// Compiler-wrapper kind remote execution runs compiles through.
+pub const REMOTE_EXECUTION_LAUNCHER: &str = "recc";
+
+/// URL schemes a REAPI endpoint may use.
+const ENDPOINT_SCHEMES: [&str; 5] = ["grpc://", "grpcs://", "http://", "https://", "unix:"];
+
+/// Validated `[build.remote-execution]` settings.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct RemoteExecutionSettings {
+    /// Execution service endpoint (`grpc://host:port`, `unix:path`).
+    pub endpoint: String,
+    /// REAPI instance name; the server's default instance when
+    /// `None`.
+    pub instance: Option<String>,
+    /// Separate CAS / action-cache endpoint; the execution endpoint
+    /// serves both when `None`.
+    pub cas_endpoint: Option<String>,
+    /// Platform properties every action requests, e.g. the worker
+    /// container image that pins the remote toolchain.
+    pub platform: BTreeMap<String, String>,
+}
+
+impl RemoteExecutionSettings {
+    /// Validate raw settings.
+    ///
+    /// # Errors
+    /// Returns [`RemoteExecutionError`] when an endpoint is empty or
+    /// not a `grpc://`, `grpcs://`, `http://`, `https://` or `unix:`
+    /// URL, or when a platform property name is empty.
+    pub fn new(
+        endpoint: &str,
+        instance: Option<&str>,
+        cas_endpoint: Option<&str>,
+        platform: BTreeMap<String, String>,
+    ) -> Result<Self, RemoteExecutionError> {
+        let endpoint = validate_endpoint("endpoint", endpoint)?;
+        let cas_endpoint = cas_endpoint
+            .map(|value| validate_endpoint("cas-endpoint", value))
+            .transpose()?;
+        if platform.keys().any(|name| name.trim().is_empty()) {
+            return Err(RemoteExecutionError::EmptyPlatformProperty);
+        }
+        Ok(Self {
+            endpoint,
+            instance: instance
+                .map(str::trim)
+                .filter(|name| !name.is_empty())
+                .map(str::to_owned),
+            cas_endpoint,
+            platform,
+        })
+    }
+
+    /// Environment the [`REMOTE_EXECUTION_LAUNCHER`] reads, for the
+    /// build backend to pass to every compile it spawns.
+    ///
+    /// `project_root` is the workspace root: the launcher rewrites
+    /// paths under it to relative ones, so two checkouts of the same
+    /// tree produce the same action digests and share cache hits.
+    /// Headers outside it (registry sources in Cabin's cache, system
+    /// headers) are uploaded too, since a worker cannot be assumed to
+    /// have them.
+    pub fn launcher_env(&self, project_root: &Utf8Path) -> BTreeMap<String, String> {
+        let mut env = BTreeMap::new();
+        env.insert("RECC_SERVER".to_owned(), self.endpoint.clone());
+        if let Some(cas) = &self.cas_endpoint {
+            env.insert("RECC_CAS_SERVER".to_owned(), cas.clone());
+            env.insert("RECC_ACTION_CACHE_SERVER".to_owned(), cas.clone());
+        }
+        if let Some(instance) = &self.instance {
+            env.insert("RECC_INSTANCE".to_owned(), instance.clone());
+        }
+        env.insert("RECC_PROJECT_ROOT".to_owned(), project_root.to_string());
+        env.insert("RECC_DEPS_GLOBAL_PATHS".to_owned(), "1".to_owned());
+        for (name, value) in &self.platform {
+            env.insert(format!("RECC_REMOTE_PLATFORM_{name}"), value.clone());
+        }
+        env
+    }
+}
+
+fn validate_endpoint(key: &'static str, raw: &str) -> Result<String, RemoteExecutionError> {
+    let trimmed = raw.trim();
+    if trimmed.is_empty() {
+        return Err(RemoteExecutionError::EmptyEndpoint { key });
+    }
+    if !ENDPOINT_SCHEMES
+        .iter()
+        .any(|scheme| trimmed.starts_with(scheme))
+    {
+        return Err(RemoteExecutionError::UnsupportedEndpoint {
+            key,
+            endpoint: trimmed.to_owned(),
+        });
+    }
+    Ok(trimmed.to_owned())
+}
+
+/// Errors produced by [`RemoteExecutionSettings::new`].
+#[derive(Debug, Clone, PartialEq, Eq, Error)]
+pub enum RemoteExecutionError {
+    #[error("`build.remote-execution.{key}` must be a non-empty URL")]
+    EmptyEndpoint { key: &'static str },
+    #[error(
+        "`build.remote-execution.{key}` must be a `grpc://`, `grpcs://`, `http://`, `https://` or `unix:` URL, got `{endpoint}`"
+    )]
+    UnsupportedEndpoint { key: &'static str, endpoint: String },
+    #[error("`build.remote-execution.platform` property names must be non-empty")]
+    EmptyPlatformProperty,
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn endpoints_are_trimmed_and_scheme_checked() {
+        let settings = RemoteExecutionSettings::new(
+            " grpc://farm.example:8980 ",
+            Some(" "),
+            None,
+            BTreeMap::new(),
+        )
+        .unwrap();
+        assert_eq!(settings.endpoint, "grpc://farm.example:8980");
+        assert_eq!(settings.instance, None);
+
+        assert_eq!(
+            RemoteExecutionSettings::new("", None, None, BTreeMap::new()),
+            Err(RemoteExecutionError::EmptyEndpoint { key: "endpoint" })
+        );
+        assert!(matches!(
+            RemoteExecutionSettings::new(
+                "grpc://farm:8980",
+                None,
+                Some("farm:8981"),
+                BTreeMap::new()
+            ),
+            Err(RemoteExecutionError::UnsupportedEndpoint {
+                key: "cas-endpoint",
+                ..
+            })
+        ));
+        assert_eq!(
+            RemoteExecutionSettings::new(
+                "unix:/run/farm.sock",
+                None,
+                None,
+                BTreeMap::from([(String::new(), "x".to_owned())])
+            ),
+            Err(RemoteExecutionError::EmptyPlatformProperty)
+        );
+    }
+
+    #[test]
+    fn launcher_env_carries_every_setting() {
+        let settings = RemoteExecutionSettings::new(
+            "grpcs://farm.example:443",
+            Some("main"),
+            Some("grpcs://cas.example:443"),
+            BTreeMap::from([("container-image".to_owned(), "docker://cc:12".to_owned())]),
+        )
+        .unwrap();
+        let env = settings.launcher_env(Utf8Path::new("/work/repo"));
+        let expected: BTreeMap<String, String> = [
+            ("RECC_SERVER", "grpcs://farm.example:443"),
+            ("RECC_CAS_SERVER", "grpcs://cas.example:443"),
+            ("RECC_ACTION_CACHE_SERVER", "grpcs://cas.example:443"),
+            ("RECC_INSTANCE", "main"),
+            ("RECC_PROJECT_ROOT", "/work/repo"),
+            ("RECC_DEPS_GLOBAL_PATHS", "1"),
+            ("RECC_REMOTE_PLATFORM_container-image", "docker://cc:12"),
+        ]
+        .into_iter()
+        .map(|(k, v)| (k.to_owned(), v.to_owned()))
+        .collect();
+        assert_eq!(env, expected);
+    }
+}
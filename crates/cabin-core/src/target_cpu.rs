@@ -0,0 +1,348 @@
+//! Typed target-CPU / ISA-level selection.
+//!
+//! A profile's `target-cpu` names the instruction set every compile
+//! may assume.  It is a typed setting rather than a raw `-march=` in
+//! `cxxflags` so that each dialect spells it (`-march=x86-64-v3` vs
+//! `/arch:AVX2`), the detected compiler is checked for support, and
+//! the choice is part of every build-configuration fingerprint.
+//!
+//! The x86-64 micro-architecture levels (`x86-64`, `x86-64-v2`, …)
+//! are modelled explicitly because they carry a fixed, documented
+//! feature set that `cfg(target_feature = "...")` conditions can
+//! evaluate against.  `native` resolves its features on the host;
+//! any other CPU name is passed through to the compiler, which owns
+//! the list of CPUs it knows, and implies no features Cabin can
+//! name.
+
+use std::collections::BTreeSet;
+use std::fmt;
+
+use serde::{Deserialize, Serialize};
+
+use crate::error::ValidationError;
+
+/// The CPU a profile targets.
+#[derive(Debug, Clone, PartialEq, Eq, PartialOrd, Ord, Hash, Serialize, Deserialize)]
+#[serde(try_from = "String", into = "String")]
+pub enum TargetCpu {
+    /// `native` - whatever the build host supports.
+    Native,
+    /// One of the x86-64 psABI micro-architecture levels.
+    X86_64(X86Level),
+    /// Any other CPU name (`skylake`, `znver4`, `apple-m1`, …),
+    /// passed to the compiler verbatim.
+    Named(String),
+}
+
+/// Architecture family a compiler targets, as far as spelling and
+/// checking a [`TargetCpu`] goes.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum TargetArch {
+    /// 64-bit x86, the only family the x86-64 levels apply to.
+    X86_64,
+    /// 32-bit x86.
+    X86,
+    /// Any other architecture (`aarch64`, `arm`, `riscv64`, …).
+    Other,
+}
+
+impl TargetArch {
+    /// Family of a target triple's architecture component (`x86_64`,
+    /// `i686`, `arm64`, …).
+    pub fn from_triple_arch(arch: &str) -> Self {
+        match arch {
+            "x86_64" | "x86_64h" | "amd64" => TargetArch::X86_64,
+            "x86" | "i386" | "i486" | "i586" | "i686" => TargetArch::X86,
+            _ => TargetArch::Other,
+        }
+    }
+
+    /// Family of the build host, for plans made without a detected
+    /// compiler.
+    pub fn host() -> Self {
+        Self::from_triple_arch(std::env::consts::ARCH)
+    }
+
+    /// Whether GCC and Clang select a CPU with `-march=` here.
+    pub const fn is_x86(self) -> bool {
+        matches!(self, TargetArch::X86_64 | TargetArch::X86)
+    }
+}
+
+/// x86-64 psABI micro-architecture level.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub enum X86Level {
+    /// `x86-64`: the baseline every x86-64 CPU implements.
+    V1,
+    /// `x86-64-v2`: adds SSE3 through SSE4.2 and POPCNT.
+    V2,
+    /// `x86-64-v3`: adds AVX, AVX2, BMI1/2, FMA and friends.
+    V3,
+    /// `x86-64-v4`: adds the common AVX-512 subsets.
+    V4,
+}
+
+impl X86Level {
+    pub const fn as_str(self) -> &'static str {
+        match self {
+            X86Level::V1 => "x86-64",
+            X86Level::V2 => "x86-64-v2",
+            X86Level::V3 => "x86-64-v3",
+            X86Level::V4 => "x86-64-v4",
+        }
+    }
+
+    /// Features this level adds on top of the level below it,
+    /// spelled as `cfg(target_feature = "...")` values.
+    const fn added_features(self) -> &'static [&'static str] {
+        match self {
+            X86Level::V1 => &["fxsr", "sse", "sse2"],
+            X86Level::V2 => &["cmpxchg16b", "popcnt", "sse3", "sse4.1", "sse4.2", "ssse3"],
+            X86Level::V3 => &[
+                "avx", "avx2", "bmi1", "bmi2", "f16c", "fma", "lzcnt", "movbe", "xsave",
+            ],
+            X86Level::V4 => &["avx512bw", "avx512cd", "avx512dq", "avx512f", "avx512vl"],
+        }
+    }
+
+    /// Every feature the level guarantees, including those of the
+    /// levels below it.
+    pub fn features(self) -> BTreeSet<&'static str> {
+        [X86Level::V1, X86Level::V2, X86Level::V3, X86Level::V4]
+            .into_iter()
+            .filter(|level| *level <= self)
+            .flat_map(|level| level.added_features().iter().copied())
+            .collect()
+    }
+}
+
+impl TargetCpu {
+    /// Parse a `target-cpu` value.
+    ///
+    /// # Errors
+    /// Returns [`ValidationError::InvalidTargetCpu`] when the value
+    /// is empty or contains anything but ASCII alphanumerics, `-`,
+    /// `_`, `.` and `+` - a CPU name is spliced into a compiler
+    /// flag, so it must not smuggle in a second argument.
+    pub fn parse(raw: &str) -> Result<Self, ValidationError> {
+        let valid = raw
+            .chars()
+            .next()
+            .is_some_and(|c| c.is_ascii_alphanumeric())
+            && raw
+                .chars()
+                .all(|c| c.is_ascii_alphanumeric() || matches!(c, '-' | '_' | '.' | '+'));
+        if !valid {
+            return Err(ValidationError::InvalidTargetCpu(raw.to_owned()));
+        }
+        Ok(match raw {
+            "native" => TargetCpu::Native,
+            "x86-64" => TargetCpu::X86_64(X86Level::V1),
+            "x86-64-v2" => TargetCpu::X86_64(X86Level::V2),
+            "x86-64-v3" => TargetCpu::X86_64(X86Level::V3),
+            "x86-64-v4" => TargetCpu::X86_64(X86Level::V4),
+            other => TargetCpu::Named(other.to_owned()),
+        })
+    }
+
+    pub fn as_str(&self) -> &str {
+        match self {
+            TargetCpu::Native => "native",
+            TargetCpu::X86_64(level) => level.as_str(),
+            TargetCpu::Named(name) => name,
+        }
+    }
+
+    /// GCC / Clang spelling.  On x86 every CPU is selected with
+    /// `-march=<cpu>`.  Elsewhere `-march=` takes an ISA revision
+    /// (`armv8.2-a+crc`, `rv64gc`), so a CPU name (`apple-m1`,
+    /// `cortex-a76`) is selected with `-mcpu=<cpu>` - which GCC's x86
+    /// back end would instead read as a deprecated `-mtune=`.
+    /// `native` stays `-march=native`, accepted on every target.
+    pub fn gnu_flag(&self, arch: TargetArch) -> String {
+        let option = match self {
+            TargetCpu::Named(name) if !arch.is_x86() && !names_isa_revision(name) => "-mcpu",
+            TargetCpu::Native | TargetCpu::X86_64(_) | TargetCpu::Named(_) => "-march",
+        };
+        format!("{option}={}", self.as_str())
+    }
+
+    /// MSVC-dialect spelling, when one exists.  `cl` and `clang-cl`
+    /// select an instruction-set extension rather than a CPU, so
+    /// only the levels whose feature set matches an `/arch:` value
+    /// map: `x86-64` → `/arch:SSE2`, `x86-64-v3` → `/arch:AVX2`,
+    /// `x86-64-v4` → `/arch:AVX512`.  `native`, `x86-64-v2` and
+    /// named CPUs have no faithful spelling.
+    pub fn msvc_flag(&self) -> Option<&'static str> {
+        match self {
+            TargetCpu::X86_64(X86Level::V1) => Some("/arch:SSE2"),
+            TargetCpu::X86_64(X86Level::V3) => Some("/arch:AVX2"),
+            TargetCpu::X86_64(X86Level::V4) => Some("/arch:AVX512"),
+            TargetCpu::X86_64(X86Level::V2) | TargetCpu::Native | TargetCpu::Named(_) => None,
+        }
+    }
+
+    /// The features `cfg(target_feature = "...")` sees for this
+    /// CPU: the level's fixed set, the build host's detected set
+    /// for `native`, and nothing for a named CPU.
+    pub fn target_features(&self) -> BTreeSet<String> {
+        match self {
+            TargetCpu::X86_64(level) => level.features().into_iter().map(str::to_owned).collect(),
+            TargetCpu::Native => host_features(),
+            TargetCpu::Named(_) => BTreeSet::new(),
+        }
+    }
+}
+
+/// Whether a non-x86 `target-cpu` name is an ISA revision for
+/// `-march=` (Arm `armv8.2-a`, RISC-V `rv64gc`) rather than a CPU.
+fn names_isa_revision(name: &str) -> bool {
+    ["armv", "rv32", "rv64"]
+        .iter()
+        .any(|prefix| name.starts_with(prefix))
+}
+
+/// Features of the x86-64 levels the build host implements.  Only
+/// names that also appear in a level's set are probed, so `native`
+/// and an explicit level agree on vocabulary.
+#[cfg(target_arch = "x86_64")]
+fn host_features() -> BTreeSet<String> {
+    use std::arch::is_x86_feature_detected;
+    // The macro only takes literals, and has no probe for `fxsr`,
+    // which every x86-64 CPU implements.
+    let detected = [
+        ("sse", is_x86_feature_detected!("sse")),
+        ("sse2", is_x86_feature_detected!("sse2")),
+        ("cmpxchg16b", is_x86_feature_detected!("cmpxchg16b")),
+        ("popcnt", is_x86_feature_detected!("popcnt")),
+        ("sse3", is_x86_feature_detected!("sse3")),
+        ("sse4.1", is_x86_feature_detected!("sse4.1")),
+        ("sse4.2", is_x86_feature_detected!("sse4.2")),
+        ("ssse3", is_x86_feature_detected!("ssse3")),
+        ("avx", is_x86_feature_detected!("avx")),
+        ("avx2", is_x86_feature_detected!("avx2")),
+        ("bmi1", is_x86_feature_detected!("bmi1")),
+        ("bmi2", is_x86_feature_detected!("bmi2")),
+        ("f16c", is_x86_feature_detected!("f16c")),
+        ("fma", is_x86_feature_detected!("fma")),
+        ("lzcnt", is_x86_feature_detected!("lzcnt")),
+        ("movbe", is_x86_feature_detected!("movbe")),
+        ("xsave", is_x86_feature_detected!("xsave")),
+        ("avx512bw", is_x86_feature_detected!("avx512bw")),
+        ("avx512cd", is_x86_feature_detected!("avx512cd")),
+        ("avx512dq", is_x86_feature_detected!("avx512dq")),
+        ("avx512f", is_x86_feature_detected!("avx512f")),
+        ("avx512vl", is_x86_feature_detected!("avx512vl")),
+    ];
+    std::iter::once("fxsr")
+        .chain(
+            detected
+                .into_iter()
+                .filter(|(_, on)| *on)
+                .map(|(name, _)| name),
+        )
+        .map(str::to_owned)
+        .collect()
+}
+
+#[cfg(not(target_arch = "x86_64"))]
+fn host_features() -> BTreeSet<String> {
+    BTreeSet::new()
+}
+
+impl fmt::Display for TargetCpu {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.write_str(self.as_str())
+    }
+}
+
+impl TryFrom<String> for TargetCpu {
+    type Error = ValidationError;
+
+    fn try_from(raw: String) -> Result<Self, Self::Error> {
+        TargetCpu::parse(&raw)
+    }
+}
+
+impl From<TargetCpu> for String {
+    fn from(cpu: TargetCpu) -> Self {
+        cpu.as_str().to_owned()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn parses_levels_native_and_named_cpus() {
+        assert_eq!(TargetCpu::parse("native").unwrap(), TargetCpu::Native);
+        assert_eq!(
+            TargetCpu::parse("x86-64-v3").unwrap(),
+            TargetCpu::X86_64(X86Level::V3)
+        );
+        assert_eq!(
+            TargetCpu::parse("znver4").unwrap(),
+            TargetCpu::Named("znver4".to_owned())
+        );
+        for cpu in ["native", "x86-64", "x86-64-v4", "apple-m1", "armv8.2-a+crc"] {
+            assert_eq!(TargetCpu::parse(cpu).unwrap().as_str(), cpu);
+        }
+        for bad in ["", "-march", "sky lake", "x86;rm", "cpu\"x"] {
+            assert!(TargetCpu::parse(bad).is_err(), "{bad:?}");
+        }
+    }
+
+    #[test]
+    fn levels_accumulate_the_features_below_them() {
+        let v2 = X86Level::V2.features();
+        let v3 = X86Level::V3.features();
+        assert!(v2.contains("sse2") && v2.contains("sse4.2"));
+        assert!(!v2.contains("avx2"));
+        assert!(v3.is_superset(&v2) && v3.contains("avx2") && v3.contains("fma"));
+        assert!(!v3.contains("avx512f"));
+        assert!(X86Level::V4.features().is_superset(&v3));
+    }
+
+    #[test]
+    fn dialect_spellings() {
+        let v3 = TargetCpu::X86_64(X86Level::V3);
+        assert_eq!(v3.gnu_flag(TargetArch::X86_64), "-march=x86-64-v3");
+        assert_eq!(v3.msvc_flag(), Some("/arch:AVX2"));
+        assert_eq!(
+            TargetCpu::Native.gnu_flag(TargetArch::X86_64),
+            "-march=native"
+        );
+        assert_eq!(
+            TargetCpu::Native.gnu_flag(TargetArch::Other),
+            "-march=native"
+        );
+        // Named CPUs: `-march=` on x86, `-mcpu=` elsewhere, unless
+        // the name is an ISA revision.
+        let cpu = |raw: &str| TargetCpu::parse(raw).unwrap();
+        assert_eq!(
+            cpu("skylake").gnu_flag(TargetArch::X86_64),
+            "-march=skylake"
+        );
+        assert_eq!(
+            cpu("apple-m1").gnu_flag(TargetArch::Other),
+            "-mcpu=apple-m1"
+        );
+        assert_eq!(
+            cpu("cortex-a76").gnu_flag(TargetArch::Other),
+            "-mcpu=cortex-a76"
+        );
+        assert_eq!(
+            cpu("armv8.2-a+crc").gnu_flag(TargetArch::Other),
+            "-march=armv8.2-a+crc"
+        );
+        assert_eq!(cpu("rv64gc").gnu_flag(TargetArch::Other), "-march=rv64gc");
+        assert_eq!(TargetCpu::Native.msvc_flag(), None);
+        assert_eq!(TargetCpu::X86_64(X86Level::V2).msvc_flag(), None);
+        assert!(
+            TargetCpu::Named("skylake".to_owned())
+                .target_features()
+                .is_empty()
+        );
+    }
+}
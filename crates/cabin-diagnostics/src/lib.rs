@@ -105,6 +105,12 @@ pub mod code {
     /// `cabin test` failed before any test could run (planning,
     /// environment, or invocation failure).
     pub const TEST_ERROR: &str = "cabin::test::error";
+    /// `cabin bench` could not run a benchmark or read / write a
+    /// benchmark report.
+    pub const BENCH_ERROR: &str = "cabin::bench::error";
+    /// `cabin bloat` could not read a linker map or read / write a
+    /// size report.
+    pub const BLOAT_ERROR: &str = "cabin::bloat::error";
     /// `cabin explain` could not load or render the requested
     /// diagnostic.
     pub const EXPLAIN_ERROR: &str = "cabin::explain::error";
@@ -10,7 +10,7 @@
 
 use camino::Utf8PathBuf;
 
-use cabin_core::{LanguageStandard, OptLevel};
+use cabin_core::{LanguageStandard, OptLevel, TargetArch, TargetCpu};
 
 /// A single semantic build step: compile a translation unit, archive
 /// objects into a static library, or link an executable.
@@ -105,6 +105,13 @@ pub struct CompileArguments {
     pub debug_info: bool,
     /// Define `NDEBUG` (assertions disabled in the active profile).
     pub define_ndebug: bool,
+    /// CPU / ISA level the active profile targets (`-march=<cpu>` /
+    /// `/arch:<ext>`); `None` leaves the compiler's default.
+    pub target_cpu: Option<TargetCpu>,
+    /// Architecture family the compiler targets, which picks the GNU
+    /// spelling of a named [`Self::target_cpu`] (`-march=` vs
+    /// `-mcpu=`, see [`TargetCpu::gnu_flag`]).
+    pub target_arch: TargetArch,
     /// Include search directories.  Spelled `-I <dir>` / `/I <dir>`.
     pub include_dirs: Vec<Utf8PathBuf>,
     /// Include search directories marked as *system* search paths,
@@ -134,10 +141,31 @@ pub struct ArchiveAction {
     pub output: Utf8PathBuf,
     /// Object files to archive, in order.
     pub inputs: Vec<Utf8PathBuf>,
+    /// Write a thin archive that references `inputs` in place
+    /// instead of copying them.  Lowered only for the GCC/Clang
+    /// dialect; `lib.exe` has no thin form and ignores it.
+    pub thin: bool,
+    /// How the archiver reads `@file` response files, so lowering
+    /// may move a long input list into one.
+    pub response_file: ArchiveResponseFile,
     /// Human-readable description (`AR libfoo.a`).
     pub description: String,
 }
 
+/// How an archiver reads `@file` response files.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ArchiveResponseFile {
+    /// No response files (BSD / Apple `ar`): the input list always
+    /// stays inline.
+    Unsupported,
+    /// Read with the dialect's own quoting: GNU `ar`, `lib.exe`.
+    Dialect,
+    /// `llvm-ar`, which splits a response file with the host's rules
+    /// (Windows quoting on a Windows host) unless the command pins
+    /// `--rsp-quoting=posix`.
+    LlvmAr,
+}
+
 /// Link objects and static archives into an executable.
 #[derive(Debug, Clone, PartialEq, Eq)]
 pub struct LinkAction {
@@ -160,6 +188,14 @@ pub struct LinkAction {
     /// line.  Kept separate from `arguments` (raw `ldflags`) precisely so
     /// the dialect layer owns the spelling rather than the planner.
     pub link_libs: Vec<String>,
+    /// Linker map to write, recording which input section (and so
+    /// which object or archive member) landed where in the output
+    /// and at what size.  `None` for an ordinary build; `cabin
+    /// bloat` requests one per executable.  Lowered as `-Xlinker
+    /// -Map -Xlinker <file>` for GNU-like drivers (GNU `ld`, `gold`,
+    /// `lld`, `mold`) and `/link /MAP:<file>` for MSVC, and declared
+    /// as a second output of the link.
+    pub map_file: Option<Utf8PathBuf>,
     /// Human-readable description (`LINK app`).
     pub description: String,
 }
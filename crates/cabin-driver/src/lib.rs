@@ -34,7 +34,10 @@ pub mod dialect;
 pub mod lower;
 
 pub use action::{
-    ArchiveAction, BuildAction, CompileAction, CompileArguments, CompileMode, LinkAction,
+    ArchiveAction, ArchiveResponseFile, BuildAction, CompileAction, CompileArguments, CompileMode,
+    LinkAction,
 };
 pub use dialect::{Dialect, NinjaDeps};
-pub use lower::{LoweredAction, LoweredActionKind, compile_argv, lower};
+pub use lower::{
+    LoweredAction, LoweredActionKind, RESPONSE_FILE_THRESHOLD, ResponseFile, compile_argv, lower,
+};
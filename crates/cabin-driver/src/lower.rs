@@ -7,13 +7,15 @@
 //! the IR, and the Ninja writer never spell a flag themselves - they
 //! call [`lower()`] (or [`compile_argv`] for the compilation database).
 
-use camino::Utf8PathBuf;
+use camino::{Utf8Path, Utf8PathBuf};
 
 #[cfg(test)]
 use cabin_core::{CStandard, CxxStandard};
 use cabin_core::{LanguageStandard, OptLevel, SourceLanguage};
 
-use crate::action::{ArchiveAction, BuildAction, CompileAction, CompileMode, LinkAction};
+use crate::action::{
+    ArchiveAction, ArchiveResponseFile, BuildAction, CompileAction, CompileMode, LinkAction,
+};
 use crate::dialect::Dialect;
 
 /// A fully-lowered action: the backend artifact the Ninja writer
@@ -39,10 +41,32 @@ pub struct LoweredAction {
     pub depfile: Option<Utf8PathBuf>,
     /// Argv-style command, ready to be shell-quoted by the backend.
     pub command: Vec<String>,
+    /// Response file `command` names as `@<path>`, when the input
+    /// list was moved out of the command line.
+    pub rspfile: Option<ResponseFile>,
     /// Short, human-readable description for build output.
     pub description: String,
 }
 
+/// A response file an archive or link command reads its inputs from.
+/// The backend writes it before running the command (Ninja's
+/// `rspfile` / `rspfile_content`).
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ResponseFile {
+    /// Where the file is written: next to the action's output.
+    pub path: Utf8PathBuf,
+    /// File body: the moved arguments, quoted for the dialect's
+    /// response-file parser and separated by spaces.
+    pub content: String,
+}
+
+/// Combined length, in bytes, of an archive or link input list past
+/// which it moves into a response file.  Windows caps a whole
+/// command line at 32 KiB; staying well under that leaves room for
+/// the flags while keeping every ordinary target's command line
+/// inline and unchanged.
+pub const RESPONSE_FILE_THRESHOLD: usize = 8 * 1024;
+
 /// Categorization of a lowered action.  A closed set; new variants
 /// require explicit handling by every backend.
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -126,6 +150,7 @@ fn lower_compile(dialect: Dialect, compile: &CompileAction) -> LoweredAction {
         outputs,
         depfile,
         command,
+        rspfile: None,
         description: compile.description.clone(),
     }
 }
@@ -148,10 +173,10 @@ fn gnu_std_flag(standard: LanguageStandard, gnu_extensions: bool) -> String {
 
 /// GNU/Clang compile argv.  The layout is fixed so it reproduces the
 /// historic command lines byte-for-byte: driver, standard, profile
-/// (`-O<n>` / `-g` / `-DNDEBUG`), the `-MD -MF <depfile>` (plus
-/// `-MT <stamp>` in syntax-only mode) dependency block, defines,
-/// includes, system includes, escape-hatch flags, and the
-/// mode-specific tail.
+/// (`-O<n>` / `-g` / `-DNDEBUG` / `-march=` or `-mcpu=`), the
+/// `-MD -MF <depfile>` (plus `-MT <stamp>` in syntax-only mode)
+/// dependency block, defines, includes, system includes,
+/// escape-hatch flags, and the mode-specific tail.
 fn compile_argv_gnu(compile: &CompileAction) -> Vec<String> {
     let args = &compile.arguments;
     let mut out: Vec<String> = Vec::new();
@@ -164,6 +189,9 @@ fn compile_argv_gnu(compile: &CompileAction) -> Vec<String> {
     if args.define_ndebug {
         out.push("-DNDEBUG".to_owned());
     }
+    if let Some(cpu) = &args.target_cpu {
+        out.push(cpu.gnu_flag(args.target_arch));
+    }
     if let Some(depfile) = &compile.depfile {
         // `-MD`, not `-MMD`: `-MMD` omits headers found through
         // system include dirs, so an edit under an `-isystem` path
@@ -210,32 +238,43 @@ fn compile_argv_gnu(compile: &CompileAction) -> Vec<String> {
     out
 }
 
-fn lower_archive_gnu(archive: &ArchiveAction) -> Vec<String> {
+fn lower_archive_gnu(archive: &ArchiveAction, inputs: Vec<String>, rsp: bool) -> Vec<String> {
     // GNU `ar` archives with the `crs` mode flags (create, replace,
-    // write index): `ar crs <lib> <obj>...`.
-    let mut command = vec![
-        archive.archiver.to_string(),
-        "crs".to_owned(),
-        archive.output.to_string(),
-    ];
-    for input in &archive.inputs {
-        command.push(input.to_string());
+    // write index): `ar crs <lib> <obj>...`.  The `T` modifier makes
+    // it a thin archive; GNU `ar` and `llvm-ar` both accept it.
+    let mode = if archive.thin { "crsT" } else { "crs" };
+    let mut command = vec![archive.archiver.to_string()];
+    // The response file is quoted the GNU way; pin `llvm-ar` to that
+    // rather than its host default, Windows quoting on Windows.
+    if rsp && archive.response_file == ArchiveResponseFile::LlvmAr {
+        command.push("--rsp-quoting=posix".to_owned());
     }
+    command.push(mode.to_owned());
+    command.push(archive.output.to_string());
+    command.extend(inputs);
     command
 }
 
-fn lower_link_gnu(link: &LinkAction) -> Vec<String> {
+fn lower_link_gnu(link: &LinkAction, inputs: Vec<String>) -> Vec<String> {
     // `<driver> <inputs...> <ldflags...> -l<lib>... -o <exe>`.
     // System libraries follow the archives so a static library's
     // dependencies resolve left-to-right under GNU `ld`.
     let mut command = vec![link.linker.to_string()];
-    for input in &link.inputs {
-        command.push(input.to_string());
-    }
+    command.extend(inputs);
     command.extend(link.arguments.iter().cloned());
     for lib in &link.link_libs {
         command.push(format!("-l{lib}"));
     }
+    // `-Xlinker` passes the path as its own argument, so a path
+    // containing `,` survives (`-Wl,-Map,<path>` would split it).
+    if let Some(map) = &link.map_file {
+        command.extend([
+            "-Xlinker".to_owned(),
+            "-Map".to_owned(),
+            "-Xlinker".to_owned(),
+            map.to_string(),
+        ]);
+    }
     command.push("-o".to_owned());
     command.push(link.output.to_string());
     command
@@ -282,10 +321,10 @@ fn msvc_opt_flag(opt: OptLevel) -> &'static str {
 /// spellings: `/std:` standard, `/utf-8` source/execution charset,
 /// `/EHsc` for C++ exceptions, `/O` optimization, `/Z7` debug info
 /// (embedded in the object so parallel compiles never contend on a
-/// shared PDB), `/showIncludes` for dependency discovery (no
-/// Makefile depfile), `/D` defines, `/I` includes, escape-hatch
-/// flags, and the mode-specific tail (`/c /Tp<src> /Fo<obj>` or
-/// `/Tp<src> /Zs`, with `/Tc` for C).
+/// shared PDB), `/arch:` for the target CPU, `/showIncludes` for
+/// dependency discovery (no Makefile depfile), `/D` defines, `/I`
+/// includes, escape-hatch flags, and the mode-specific tail
+/// (`/c /Tp<src> /Fo<obj>` or `/Tp<src> /Zs`, with `/Tc` for C).
 fn compile_argv_msvc(compile: &CompileAction) -> Vec<String> {
     debug_assert!(
         !compile.gnu_extensions,
@@ -312,6 +351,14 @@ fn compile_argv_msvc(compile: &CompileAction) -> Vec<String> {
     if args.define_ndebug {
         out.push("/DNDEBUG".to_owned());
     }
+    if let Some(cpu) = &args.target_cpu {
+        let flag = cpu.msvc_flag();
+        debug_assert!(
+            flag.is_some(),
+            "toolchain validation rejects a target CPU the MSVC dialect cannot spell"
+        );
+        out.extend(flag.map(str::to_owned));
+    }
     // `/showIncludes` drives Ninja's `deps = msvc`.  Emitted whenever
     // the planner asked for dependency tracking, matching the GNU
     // dialect's `-MD -MF` condition.
@@ -357,37 +404,37 @@ fn compile_argv_msvc(compile: &CompileAction) -> Vec<String> {
     out
 }
 
-fn lower_archive_msvc(archive: &ArchiveAction) -> Vec<String> {
-    // `lib /nologo /OUT:<lib> <obj>...`.
+fn lower_archive_msvc(archive: &ArchiveAction, inputs: Vec<String>) -> Vec<String> {
+    // `lib /nologo /OUT:<lib> <obj>...`.  `lib.exe` has no thin
+    // archive form, so `archive.thin` is ignored here.
     let mut command = vec![
         archive.archiver.to_string(),
         "/nologo".to_owned(),
         format!("/OUT:{}", archive.output),
     ];
-    for input in &archive.inputs {
-        command.push(input.to_string());
-    }
+    command.extend(inputs);
     command
 }
 
-fn lower_link_msvc(link: &LinkAction) -> Vec<String> {
+fn lower_link_msvc(link: &LinkAction, inputs: Vec<String>) -> Vec<String> {
     // `<driver> /nologo <inputs...> <lib>.lib... /Fe<exe> [/link <ldflags...>]`.
     // cl.exe consumes object and `.lib` inputs positionally and
     // forwards `/link` options to the linker, so system libraries are
     // spelled `<name>.lib` and passed as positional inputs after the
     // archives rather than as GNU `-l<name>` flags.
     let mut command = vec![link.linker.to_string(), "/nologo".to_owned()];
-    for input in &link.inputs {
-        command.push(input.to_string());
-    }
+    command.extend(inputs);
     for lib in &link.link_libs {
         command.push(format!("{lib}.lib"));
     }
     command.push(format!("/Fe{}", link.output));
-    if !link.arguments.is_empty() {
+    if !link.arguments.is_empty() || link.map_file.is_some() {
         command.push("/link".to_owned());
         command.extend(link.arguments.iter().cloned());
     }
+    if let Some(map) = &link.map_file {
+        command.push(format!("/MAP:{map}"));
+    }
     command
 }
 
@@ -396,9 +443,15 @@ fn lower_link_msvc(link: &LinkAction) -> Vec<String> {
 // ---------------------------------------------------------------
 
 fn lower_archive(dialect: Dialect, archive: &ArchiveAction) -> LoweredAction {
+    let (inputs, rspfile) = spell_inputs(
+        dialect,
+        &archive.inputs,
+        &archive.output,
+        archive.response_file != ArchiveResponseFile::Unsupported,
+    );
     let command = match dialect {
-        Dialect::GnuLike => lower_archive_gnu(archive),
-        Dialect::Msvc => lower_archive_msvc(archive),
+        Dialect::GnuLike => lower_archive_gnu(archive, inputs, rspfile.is_some()),
+        Dialect::Msvc => lower_archive_msvc(archive, inputs),
     };
     LoweredAction {
         kind: LoweredActionKind::ArchiveStaticLibrary,
@@ -407,26 +460,112 @@ fn lower_archive(dialect: Dialect, archive: &ArchiveAction) -> LoweredAction {
         outputs: vec![archive.output.clone()],
         depfile: None,
         command,
+        rspfile,
         description: archive.description.clone(),
     }
 }
 
 fn lower_link(dialect: Dialect, link: &LinkAction) -> LoweredAction {
+    // Every link driver Cabin drives - `gcc`, `clang`, `cl` and
+    // `clang-cl` - expands `@file` arguments itself.
+    let (inputs, rspfile) = spell_inputs(dialect, &link.inputs, &link.output, true);
     let command = match dialect {
-        Dialect::GnuLike => lower_link_gnu(link),
-        Dialect::Msvc => lower_link_msvc(link),
+        Dialect::GnuLike => lower_link_gnu(link, inputs),
+        Dialect::Msvc => lower_link_msvc(link, inputs),
     };
+    let mut outputs = vec![link.output.clone()];
+    outputs.extend(link.map_file.clone());
     LoweredAction {
         kind: LoweredActionKind::LinkExecutable,
         inputs: link.inputs.clone(),
         implicit_inputs: link.implicit_inputs.clone(),
-        outputs: vec![link.output.clone()],
+        outputs,
         depfile: None,
         command,
+        rspfile,
         description: link.description.clone(),
     }
 }
 
+/// Spell an archive or link input list for the command line: inline
+/// when it is short or `tool_reads_rsp` is false, otherwise as a
+/// single `@<output>.rsp` argument naming a [`ResponseFile`] that
+/// holds the list.  The decision depends only on the list itself,
+/// so the same graph always lowers to the same command.
+fn spell_inputs(
+    dialect: Dialect,
+    inputs: &[Utf8PathBuf],
+    output: &Utf8Path,
+    tool_reads_rsp: bool,
+) -> (Vec<String>, Option<ResponseFile>) {
+    let inline: Vec<String> = inputs.iter().map(ToString::to_string).collect();
+    let length: usize = inline.iter().map(|input| input.len() + 1).sum();
+    if !tool_reads_rsp || length <= RESPONSE_FILE_THRESHOLD {
+        return (inline, None);
+    }
+    let path = Utf8PathBuf::from(format!("{output}.rsp"));
+    let mut content = String::with_capacity(length * 2);
+    for input in &inline {
+        if !content.is_empty() {
+            content.push(' ');
+        }
+        match dialect {
+            Dialect::GnuLike => gnu_rsp_quote(input, &mut content),
+            Dialect::Msvc => msvc_rsp_quote(input, &mut content),
+        }
+    }
+    (
+        vec![format!("@{path}")],
+        Some(ResponseFile { path, content }),
+    )
+}
+
+/// Quote one argument for a GCC / Clang / `ar` response file.  Both
+/// libiberty and LLVM split the file on whitespace and treat a
+/// backslash as escaping the next character anywhere - inside quotes
+/// too - so escaping whitespace, quotes and backslashes individually
+/// is the one spelling both read back verbatim, including a MinGW
+/// path such as `C:\build\a.o`.
+fn gnu_rsp_quote(arg: &str, out: &mut String) {
+    for c in arg.chars() {
+        if c.is_whitespace() || matches!(c, '\\' | '\'' | '"') {
+            out.push('\\');
+        }
+        out.push(c);
+    }
+}
+
+/// Quote one argument for a `cl` / `link` / `lib` response file,
+/// which those tools split with the command-line rules of
+/// `CommandLineToArgvW`: verbatim unless it holds a space, tab or
+/// double quote, otherwise double-quoted with backslashes doubled
+/// only where they precede a quote.
+fn msvc_rsp_quote(arg: &str, out: &mut String) {
+    if !arg.is_empty() && !arg.contains([' ', '\t', '"']) {
+        out.push_str(arg);
+        return;
+    }
+    out.push('"');
+    let mut backslashes = 0usize;
+    for c in arg.chars() {
+        match c {
+            '\\' => backslashes += 1,
+            '"' => {
+                out.extend(std::iter::repeat_n('\\', backslashes * 2 + 1));
+                out.push('"');
+                backslashes = 0;
+            }
+            other => {
+                out.extend(std::iter::repeat_n('\\', backslashes));
+                backslashes = 0;
+                out.push(other);
+            }
+        }
+    }
+    out.extend(std::iter::repeat_n('\\', backslashes * 2));
+    out.push('"');
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -454,6 +593,8 @@ mod tests {
                 opt_level: OptLevel::O0,
                 debug_info: false,
                 define_ndebug: false,
+                target_cpu: None,
+                target_arch: cabin_core::TargetArch::X86_64,
                 include_dirs: vec![Utf8PathBuf::from("/abs/include")],
                 system_include_dirs: vec![Utf8PathBuf::from("/abs/dep/include")],
                 defines: strs(&["FOO=1"]),
@@ -667,6 +808,8 @@ mod tests {
                 Utf8PathBuf::from("/abs/build/a.o"),
                 Utf8PathBuf::from("/abs/build/b.o"),
             ],
+            thin: false,
+            response_file: ArchiveResponseFile::Unsupported,
             description: "AR /abs/build/libfoo.a".to_owned(),
         });
         let lowered = lower(Dialect::GnuLike, &action);
@@ -683,6 +826,161 @@ mod tests {
         );
     }
 
+    #[test]
+    fn thin_archive_adds_t_modifier_only_for_gnu_dialect() {
+        let archive = |archiver: &str, output: &str, input: &str| ArchiveAction {
+            archiver: Utf8PathBuf::from(archiver),
+            output: Utf8PathBuf::from(output),
+            inputs: vec![Utf8PathBuf::from(input)],
+            thin: true,
+            response_file: ArchiveResponseFile::Unsupported,
+            description: format!("AR {output}"),
+        };
+        let gnu = lower(
+            Dialect::GnuLike,
+            &BuildAction::Archive(archive("/usr/bin/llvm-ar", "/b/libfoo.a", "/b/a.o")),
+        );
+        assert_eq!(
+            gnu.command,
+            strs(&["/usr/bin/llvm-ar", "crsT", "/b/libfoo.a", "/b/a.o"])
+        );
+        let msvc = lower(
+            Dialect::Msvc,
+            &BuildAction::Archive(archive("lib.exe", "C:/b/foo.lib", "C:/b/a.obj")),
+        );
+        assert_eq!(
+            msvc.command,
+            strs(&["lib.exe", "/nologo", "/OUT:C:/b/foo.lib", "C:/b/a.obj"])
+        );
+    }
+
+    /// `count` inputs long enough to cross [`RESPONSE_FILE_THRESHOLD`],
+    /// each under a directory with a space in its name.
+    fn many_objects(prefix: &str, count: usize) -> Vec<Utf8PathBuf> {
+        (0..count)
+            .map(|i| Utf8PathBuf::from(format!("{prefix}/my objs/object_{i:04}.o")))
+            .collect()
+    }
+
+    #[test]
+    fn long_archive_input_lists_move_into_a_response_file() {
+        let mut archive = ArchiveAction {
+            archiver: Utf8PathBuf::from("/usr/bin/ar"),
+            output: Utf8PathBuf::from("/abs/build/libbig.a"),
+            inputs: many_objects("/abs/build", 400),
+            thin: false,
+            response_file: ArchiveResponseFile::Dialect,
+            description: "AR /abs/build/libbig.a".to_owned(),
+        };
+        let lowered = lower(Dialect::GnuLike, &BuildAction::Archive(archive.clone()));
+        assert_eq!(
+            lowered.command,
+            strs(&[
+                "/usr/bin/ar",
+                "crs",
+                "/abs/build/libbig.a",
+                "@/abs/build/libbig.a.rsp",
+            ])
+        );
+        // Ninja still sees every input as an edge dependency.
+        assert_eq!(lowered.inputs, archive.inputs);
+        let rsp = lowered.rspfile.expect("input list crosses the threshold");
+        assert_eq!(rsp.path, Utf8PathBuf::from("/abs/build/libbig.a.rsp"));
+        assert!(
+            rsp.content.starts_with(
+                "/abs/build/my\\ objs/object_0000.o /abs/build/my\\ objs/object_0001.o "
+            )
+        );
+
+        // `llvm-ar` is told to read the GNU quoting, which a Windows
+        // host would otherwise parse with its own rules.
+        archive.response_file = ArchiveResponseFile::LlvmAr;
+        let llvm = lower(Dialect::GnuLike, &BuildAction::Archive(archive.clone()));
+        assert_eq!(
+            llvm.command[1..3],
+            strs(&["--rsp-quoting=posix", "crs"])[..]
+        );
+        assert_eq!(llvm.rspfile.as_ref(), Some(&rsp));
+        // ... but only when a response file is in play.
+        let mut short = archive.clone();
+        short.inputs.truncate(2);
+        let short = lower(Dialect::GnuLike, &BuildAction::Archive(short));
+        assert_eq!(short.command[1], "crs");
+
+        // An archiver that cannot read response files keeps the
+        // inputs inline however long the list gets.
+        archive.response_file = ArchiveResponseFile::Unsupported;
+        let inline = lower(Dialect::GnuLike, &BuildAction::Archive(archive));
+        assert!(inline.rspfile.is_none());
+        assert_eq!(inline.command.len(), 3 + 400);
+    }
+
+    #[test]
+    fn long_msvc_link_input_lists_move_into_a_response_file() {
+        let link = LinkAction {
+            linker: Utf8PathBuf::from("cl.exe"),
+            output: Utf8PathBuf::from("C:/b/app.exe"),
+            inputs: many_objects("C:/b", 400),
+            implicit_inputs: vec![],
+            arguments: vec![],
+            link_libs: strs(&["ws2_32"]),
+            map_file: None,
+            description: "LINK C:/b/app.exe".to_owned(),
+        };
+        let lowered = lower(Dialect::Msvc, &BuildAction::Link(link));
+        assert_eq!(
+            lowered.command,
+            strs(&[
+                "cl.exe",
+                "/nologo",
+                "@C:/b/app.exe.rsp",
+                "ws2_32.lib",
+                "/FeC:/b/app.exe",
+            ])
+        );
+        let rsp = lowered.rspfile.expect("input list crosses the threshold");
+        assert!(rsp.content.starts_with("\"C:/b/my objs/object_0000.o\" "));
+    }
+
+    #[test]
+    fn short_input_lists_stay_inline() {
+        let lowered = lower(
+            Dialect::GnuLike,
+            &BuildAction::Link(LinkAction {
+                linker: Utf8PathBuf::from("/usr/bin/g++"),
+                output: Utf8PathBuf::from("/abs/build/app"),
+                inputs: many_objects("/abs/build", 8),
+                implicit_inputs: vec![],
+                arguments: vec![],
+                link_libs: vec![],
+                map_file: None,
+                description: "LINK /abs/build/app".to_owned(),
+            }),
+        );
+        assert!(lowered.rspfile.is_none());
+        assert_eq!(lowered.command[1], "/abs/build/my objs/object_0000.o");
+    }
+
+    #[test]
+    fn response_file_quoting_round_trips_per_dialect() {
+        let gnu = |arg: &str| {
+            let mut out = String::new();
+            gnu_rsp_quote(arg, &mut out);
+            out
+        };
+        assert_eq!(gnu("/b/a.o"), "/b/a.o");
+        assert_eq!(gnu("C:\\b\\a b.o"), "C:\\\\b\\\\a\\ b.o");
+        assert_eq!(gnu("it's\"q\""), "it\\'s\\\"q\\\"");
+        let msvc = |arg: &str| {
+            let mut out = String::new();
+            msvc_rsp_quote(arg, &mut out);
+            out
+        };
+        assert_eq!(msvc("C:\\b\\a.obj"), "C:\\b\\a.obj");
+        assert_eq!(msvc("C:\\my dir\\"), "\"C:\\my dir\\\\\"");
+        assert_eq!(msvc("a\"b"), "\"a\\\"b\"");
+    }
+
     #[test]
     fn gnu_link_lowers_to_driver_inputs_ldflags_output() {
         let action = BuildAction::Link(LinkAction {
@@ -695,6 +993,7 @@ mod tests {
             implicit_inputs: vec![],
             arguments: strs(&["-Wl,--as-needed"]),
             link_libs: vec![],
+            map_file: None,
             description: "LINK /abs/build/app".to_owned(),
         });
         let lowered = lower(Dialect::GnuLike, &action);
@@ -733,6 +1032,8 @@ mod tests {
                 opt_level: OptLevel::O2,
                 debug_info: true,
                 define_ndebug: true,
+                target_cpu: None,
+                target_arch: cabin_core::TargetArch::X86_64,
                 include_dirs: vec![Utf8PathBuf::from("C:/include")],
                 system_include_dirs: vec![Utf8PathBuf::from("C:/dep/include")],
                 defines: strs(&["FOO=1"]),
@@ -842,6 +1143,33 @@ mod tests {
         assert!(!c.command.iter().any(|a| a == "/TpC:/src/main.cc"));
     }
 
+    #[test]
+    fn target_cpu_lowers_per_dialect() {
+        let v3 = cabin_core::TargetCpu::parse("x86-64-v3").unwrap();
+        let mut gnu = cxx_compile(CompileMode::Object);
+        gnu.arguments.define_ndebug = true;
+        gnu.arguments.target_cpu = Some(v3.clone());
+        let lowered = lower(Dialect::GnuLike, &BuildAction::Compile(gnu));
+        assert_eq!(
+            &lowered.command[2..5],
+            &strs(&["-O0", "-DNDEBUG", "-march=x86-64-v3"])[..]
+        );
+
+        // A named CPU is `-mcpu=` off x86.
+        let mut arm = cxx_compile(CompileMode::Object);
+        arm.arguments.target_cpu = Some(cabin_core::TargetCpu::parse("apple-m1").unwrap());
+        arm.arguments.target_arch = cabin_core::TargetArch::Other;
+        let lowered = lower(Dialect::GnuLike, &BuildAction::Compile(arm));
+        assert!(lowered.command.iter().any(|a| a == "-mcpu=apple-m1"));
+        assert!(!lowered.command.iter().any(|a| a.starts_with("-march")));
+
+        let mut msvc = msvc_cxx_compile(CompileMode::Object);
+        msvc.arguments.target_cpu = Some(v3);
+        let lowered = lower(Dialect::Msvc, &BuildAction::Compile(msvc));
+        assert!(lowered.command.iter().any(|a| a == "/arch:AVX2"));
+        assert!(!lowered.command.iter().any(|a| a.starts_with("-march")));
+    }
+
     #[test]
     fn msvc_debug_off_omits_z7_and_opt_maps_o3_to_o2() {
         let mut c = msvc_cxx_compile(CompileMode::Object);
@@ -863,6 +1191,8 @@ mod tests {
                 Utf8PathBuf::from("C:/build/a.obj"),
                 Utf8PathBuf::from("C:/build/b.obj"),
             ],
+            thin: false,
+            response_file: ArchiveResponseFile::Unsupported,
             description: "AR C:/build/foo.lib".to_owned(),
         });
         let lowered = lower(Dialect::Msvc, &action);
@@ -890,6 +1220,7 @@ mod tests {
             implicit_inputs: vec![],
             arguments: strs(&["/SUBSYSTEM:CONSOLE"]),
             link_libs: vec![],
+            map_file: None,
             description: "LINK C:/build/app.exe".to_owned(),
         });
         let lowered = lower(Dialect::Msvc, &action);
@@ -907,6 +1238,59 @@ mod tests {
         );
     }
 
+    #[test]
+    fn link_map_is_spelled_per_dialect_and_declared_as_an_output() {
+        let link = |output: &str, map: &str| {
+            BuildAction::Link(LinkAction {
+                linker: Utf8PathBuf::from("c++"),
+                output: Utf8PathBuf::from(output),
+                inputs: vec![Utf8PathBuf::from("main.o")],
+                implicit_inputs: vec![],
+                arguments: vec![],
+                link_libs: vec![],
+                map_file: Some(Utf8PathBuf::from(map)),
+                description: format!("LINK {output}"),
+            })
+        };
+        let gnu = lower(Dialect::GnuLike, &link("/b/app", "/b/a,b/app.map"));
+        assert_eq!(
+            gnu.command,
+            strs(&[
+                "c++",
+                "main.o",
+                "-Xlinker",
+                "-Map",
+                "-Xlinker",
+                "/b/a,b/app.map",
+                "-o",
+                "/b/app",
+            ])
+        );
+        assert_eq!(
+            gnu.outputs,
+            vec![
+                Utf8PathBuf::from("/b/app"),
+                Utf8PathBuf::from("/b/a,b/app.map")
+            ]
+        );
+
+        // Without ldflags the `/link` separator still has to open the
+        // linker-option block for `/MAP`.
+        let msvc = lower(Dialect::Msvc, &link("C:/b/app.exe", "C:/b/app.exe.map"));
+        assert_eq!(
+            msvc.command,
+            strs(&[
+                "c++",
+                "/nologo",
+                "main.o",
+                "/FeC:/b/app.exe",
+                "/link",
+                "/MAP:C:/b/app.exe.map",
+            ])
+        );
+        assert_eq!(msvc.outputs.len(), 2);
+    }
+
     #[test]
     fn msvc_link_without_ldflags_omits_link_separator() {
         let action = BuildAction::Link(LinkAction {
@@ -916,6 +1300,7 @@ mod tests {
             implicit_inputs: vec![],
             arguments: vec![],
             link_libs: vec![],
+            map_file: None,
             description: "LINK C:/build/app.exe".to_owned(),
         });
         let lowered = lower(Dialect::Msvc, &action);
@@ -945,6 +1330,7 @@ mod tests {
             implicit_inputs: vec![],
             arguments: vec![],
             link_libs: strs(&["pthread", "m"]),
+            map_file: None,
             description: "LINK /abs/build/app".to_owned(),
         });
         let lowered = lower(Dialect::GnuLike, &action);
@@ -974,6 +1360,7 @@ mod tests {
             implicit_inputs: vec![],
             arguments: vec![],
             link_libs: strs(&["user32"]),
+            map_file: None,
             description: "LINK C:/build/app.exe".to_owned(),
         });
         let lowered = lower(Dialect::Msvc, &action);
@@ -492,14 +492,14 @@ pub struct TargetExplanation {
     #[serde(skip_serializing_if = "Vec::is_empty")]
     pub required_features: Vec<String>,
     /// `true` for every kind that produces a Ninja action
-    /// (`library`, `executable`, `test`, `example`). `header-only`
+    /// (`library`, `executable`, `test`, `example`, `bench`). `header-only`
     /// is the only buildable=false kind. `is_test` and
     /// `is_dev_only` further classify whether the target reaches
     /// the default `cabin build` selection.
     pub is_buildable: bool,
     /// `true` for `test` only.
     pub is_test: bool,
-    /// `true` for the dev-only kinds (`test`, `example`).
+    /// `true` for the dev-only kinds (`test`, `example`, `bench`).
     pub is_dev_only: bool,
 }
 
@@ -1342,6 +1342,8 @@ mod tests {
             deps: Vec::new(),
             required_features: Vec::new(),
             language: cabin_core::LanguageStandardSettings::default(),
+            data: Vec::new(),
+            harness: None,
         };
         graph.packages[2].package.targets.push(target);
         let exp = explain_target(&graph, &[2], "util").unwrap();
@@ -1366,6 +1368,8 @@ mod tests {
             deps: Vec::new(),
             required_features: Vec::new(),
             language: cabin_core::LanguageStandardSettings::default(),
+            data: Vec::new(),
+            harness: None,
         };
         graph.packages[1].package.targets.push(lib_target);
         let err = explain_target(&graph, &[1], "missing").unwrap_err();
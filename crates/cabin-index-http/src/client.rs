@@ -139,6 +139,10 @@ impl HttpClient {
     /// [`RegistryAuth`]'s origin / cleartext rules allow it for this
     /// URL, the request carries `Authorization: Bearer <token>`.
     ///
+    /// The request never advertises a content coding, so the body is
+    /// returned exactly as served; metadata reads that want
+    /// compression go through [`HttpClient::get_metadata`].
+    ///
     /// # Errors
     /// Returns [`IndexHttpError::PackageNotFound`] on a 404, and
     /// [`IndexHttpError::ServerError`] on a 3xx (redirects are not
@@ -157,6 +161,39 @@ impl HttpClient {
     /// when the body exceeds the 64 MiB cap, or on a `ureq` transport
     /// error.
     pub fn get_bytes(&self, url: &str, package: &str) -> Result<Vec<u8>, IndexHttpError> {
+        self.get(url, package, false)
+    }
+
+    /// [`HttpClient::get_bytes`] for index metadata (`config.json` and
+    /// the per-package documents): the request advertises
+    /// `Accept-Encoding: gzip` and a `Content-Encoding: gzip` response
+    /// is inflated transparently.  Package documents with long version
+    /// histories compress by an order of magnitude, which is what
+    /// matters on slow links.
+    ///
+    /// The body cap applies to the *decompressed* bytes, so a small
+    /// compressed response cannot inflate past it.  Artifact downloads
+    /// never take this path: archives are already compressed and their
+    /// checksums are over the bytes as served.
+    ///
+    /// # Errors
+    /// Same as [`HttpClient::get_bytes`], plus
+    /// [`IndexHttpError::Transport`] when the response declares a
+    /// content coding other than `gzip` / `identity` or the gzip
+    /// stream is corrupt.
+    pub fn get_metadata(&self, url: &str, package: &str) -> Result<Vec<u8>, IndexHttpError> {
+        self.get(url, package, true)
+    }
+
+    /// Shared request path of [`HttpClient::get_bytes`] and
+    /// [`HttpClient::get_metadata`]; `negotiate_gzip` decides whether
+    /// the request advertises (and the response may use) gzip.
+    fn get(
+        &self,
+        url: &str,
+        package: &str,
+        negotiate_gzip: bool,
+    ) -> Result<Vec<u8>, IndexHttpError> {
         // The auth decision is per request URL, not per client: the
         // token is only ever sent to the exact origin it is stored
         // under, and never in cleartext beyond loopback.
@@ -168,6 +205,9 @@ impl HttpClient {
         if let Some(auth) = auth {
             request = request.set("Authorization", &format!("Bearer {}", auth.token.expose()));
         }
+        if negotiate_gzip {
+            request = request.set("Accept-Encoding", "gzip");
+        }
         match request.call() {
             Ok(response) => {
                 // `.redirects(0)` on the agent means redirects are not
@@ -182,21 +222,19 @@ impl HttpClient {
                         status,
                     });
                 }
-                let mut reader = response.into_reader().take(self.max_body_bytes as u64 + 1);
-                let mut body = Vec::new();
-                reader
-                    .read_to_end(&mut body)
-                    .map_err(|err| IndexHttpError::Transport {
-                        name: package.to_owned(),
-                        message: err.to_string(),
-                    })?;
-                if body.len() > self.max_body_bytes {
-                    return Err(IndexHttpError::Transport {
-                        name: package.to_owned(),
-                        message: format!("response body exceeded {} bytes", self.max_body_bytes),
-                    });
-                }
-                Ok(body)
+                let coding = if negotiate_gzip {
+                    ContentCoding::of(response.header("Content-Encoding")).map_err(|coding| {
+                        IndexHttpError::Transport {
+                            name: package.to_owned(),
+                            message: format!("unsupported Content-Encoding `{coding}`"),
+                        }
+                    })?
+                } else {
+                    // Nothing was advertised, so the body is taken as
+                    // served - exactly the pre-negotiation behavior.
+                    ContentCoding::Identity
+                };
+                self.read_capped_body(response.into_reader(), coding, package)
             }
             Err(ureq::Error::Status(404, _)) => Err(IndexHttpError::PackageNotFound {
                 name: package.to_owned(),
@@ -267,6 +305,41 @@ impl HttpClient {
         }
     }
 
+    /// Read a success body, inflating it first when `coding` says so.
+    /// The cap is enforced on the bytes the caller receives - after
+    /// decompression - by reading one byte past it and refusing what
+    /// overflows, so a compression bomb is cut off at the cap rather
+    /// than inflated in full.
+    fn read_capped_body(
+        &self,
+        reader: impl Read,
+        coding: ContentCoding,
+        package: &str,
+    ) -> Result<Vec<u8>, IndexHttpError> {
+        let limit = self.max_body_bytes as u64 + 1;
+        let mut body = Vec::new();
+        let read = match coding {
+            ContentCoding::Identity => reader.take(limit).read_to_end(&mut body),
+            // The compressed side is capped too: a stream of empty
+            // deflate blocks inflates to nothing, so the output cap
+            // alone would never stop it.
+            ContentCoding::Gzip => flate2::read::GzDecoder::new(reader.take(limit))
+                .take(limit)
+                .read_to_end(&mut body),
+        };
+        read.map_err(|err| IndexHttpError::Transport {
+            name: package.to_owned(),
+            message: err.to_string(),
+        })?;
+        if body.len() > self.max_body_bytes {
+            return Err(IndexHttpError::Transport {
+                name: package.to_owned(),
+                message: format!("response body exceeded {} bytes", self.max_body_bytes),
+            });
+        }
+        Ok(body)
+    }
+
     /// `GET` `url` and return the raw response body.  Used by the CLI
     /// to download artifacts; checksum verification happens later in
     /// `cabin-artifact`.
@@ -291,6 +364,35 @@ impl HttpClient {
     }
 }
 
+/// The content codings a metadata read understands.  Only gzip is
+/// negotiated: it is what static hosts and the Workers runtime emit for
+/// JSON, and `flate2` already ships in the client.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+enum ContentCoding {
+    Identity,
+    Gzip,
+}
+
+impl ContentCoding {
+    /// Classify a `Content-Encoding` header value.  A missing or empty
+    /// header and `identity` mean the body is served as-is; `gzip`
+    /// (and its legacy `x-gzip` alias) means inflate.  Anything else -
+    /// including a stacked `gzip, br` - is returned as the error so the
+    /// caller can name it: the client never advertised it.
+    fn of(header: Option<&str>) -> Result<Self, String> {
+        let Some(value) = header.map(str::trim) else {
+            return Ok(Self::Identity);
+        };
+        if value.is_empty() || value.eq_ignore_ascii_case("identity") {
+            Ok(Self::Identity)
+        } else if value.eq_ignore_ascii_case("gzip") || value.eq_ignore_ascii_case("x-gzip") {
+            Ok(Self::Gzip)
+        } else {
+            Err(value.to_owned())
+        }
+    }
+}
+
 /// Serde shape of the registry's error envelope
 /// (`docs/remote-registry.md`, "Error envelope").  Only the
 /// machine-readable `code` is read here - the rendered message is the
@@ -580,6 +682,143 @@ mod tests {
         }
     }
 
+    // -----------------------------------------------------------------
+    // Compressed metadata reads
+    // -----------------------------------------------------------------
+
+    fn gzip(body: &[u8]) -> Vec<u8> {
+        use std::io::Write;
+        let mut encoder = flate2::write::GzEncoder::new(Vec::new(), flate2::Compression::default());
+        encoder.write_all(body).expect("gzip into memory");
+        encoder.finish().expect("finish gzip stream")
+    }
+
+    /// Server that answers every request with `body`, gzip-compressed
+    /// (and labelled `Content-Encoding: gzip`) only when the request
+    /// advertised gzip; `/wrong-coding` always claims `br`.
+    fn encoding_server(body: &'static [u8]) -> (Arc<tiny_http::Server>, String, JoinHandle<()>) {
+        let server =
+            Arc::new(tiny_http::Server::http("127.0.0.1:0").expect("bind tiny_http on loopback"));
+        let addr = server.server_addr().to_ip().expect("loopback addr");
+        let url = format!("http://{addr}");
+        let server_for_thread = Arc::clone(&server);
+        let thread = std::thread::spawn(move || {
+            while let Ok(req) = server_for_thread.recv() {
+                let accepts_gzip = req
+                    .headers()
+                    .iter()
+                    .any(|h| h.field.equiv("Accept-Encoding") && h.value.as_str().contains("gzip"));
+                let coding = if req.url() == "/wrong-coding" {
+                    Some("br")
+                } else if accepts_gzip {
+                    Some("gzip")
+                } else {
+                    None
+                };
+                let payload = if coding == Some("gzip") {
+                    gzip(body)
+                } else {
+                    body.to_vec()
+                };
+                let mut response = tiny_http::Response::from_data(payload);
+                if let Some(coding) = coding {
+                    response.add_header(
+                        tiny_http::Header::from_bytes(&b"Content-Encoding"[..], coding.as_bytes())
+                            .expect("header"),
+                    );
+                }
+                let _ = req.respond(response);
+            }
+        });
+        (server, url, thread)
+    }
+
+    #[test]
+    fn get_metadata_negotiates_and_inflates_gzip() {
+        const DOC: &[u8] = br#"{"schema":1,"name":"fmt","versions":{}}"#;
+        let (server, url, thread) = encoding_server(DOC);
+
+        let body = HttpClient::new()
+            .get_metadata(&format!("{url}/packages/fmt.json"), "fmt")
+            .expect("gzip metadata decodes");
+        assert_eq!(body, DOC);
+
+        // Downloads and plain reads never advertise a coding, so the
+        // bytes arrive exactly as served.
+        let body = HttpClient::new()
+            .get_bytes(&format!("{url}/packages/fmt.json"), "fmt")
+            .expect("identity read succeeds");
+        assert_eq!(body, DOC);
+
+        server.unblock();
+        let _ = thread.join();
+    }
+
+    /// The cap is over the decompressed bytes: a body that compresses
+    /// far below the cap but inflates past it is refused.
+    #[test]
+    fn get_metadata_caps_the_decompressed_body() {
+        static DOC: [u8; 4096] = [b' '; 4096];
+        let (server, url, thread) = encoding_server(&DOC);
+        let client = HttpClient {
+            agent: ureq::AgentBuilder::new()
+                .timeout(DEFAULT_TIMEOUT)
+                .redirects(0)
+                .build(),
+            max_body_bytes: 1024,
+            auth: None,
+        };
+        assert!(
+            gzip(&DOC).len() < 1024,
+            "fixture must compress below the cap"
+        );
+
+        let result = client.get_metadata(&format!("{url}/packages/fmt.json"), "fmt");
+
+        match result {
+            Err(IndexHttpError::Transport { name, message }) => {
+                assert_eq!(name, "fmt");
+                assert!(message.contains("exceeded 1024 bytes"), "{message}");
+            }
+            other => panic!("expected Transport error, got {other:?}"),
+        }
+        server.unblock();
+        let _ = thread.join();
+    }
+
+    #[test]
+    fn get_metadata_rejects_an_unadvertised_coding() {
+        let (server, url, thread) = encoding_server(b"{}");
+
+        let result = HttpClient::new().get_metadata(&format!("{url}/wrong-coding"), "fmt");
+
+        match result {
+            Err(IndexHttpError::Transport { message, .. }) => {
+                assert!(message.contains("Content-Encoding `br`"), "{message}");
+            }
+            other => panic!("expected Transport error, got {other:?}"),
+        }
+        server.unblock();
+        let _ = thread.join();
+    }
+
+    #[test]
+    fn content_coding_classifies_header_values() {
+        assert_eq!(ContentCoding::of(None), Ok(ContentCoding::Identity));
+        assert_eq!(ContentCoding::of(Some("")), Ok(ContentCoding::Identity));
+        assert_eq!(
+            ContentCoding::of(Some("identity")),
+            Ok(ContentCoding::Identity)
+        );
+        assert_eq!(ContentCoding::of(Some(" GZIP ")), Ok(ContentCoding::Gzip));
+        assert_eq!(ContentCoding::of(Some("x-gzip")), Ok(ContentCoding::Gzip));
+        assert_eq!(
+            ContentCoding::of(Some("gzip, br")),
+            Err("gzip, br".to_owned())
+        );
+        assert_eq!(ContentCoding::of(Some("zstd")), Err("zstd".to_owned()));
+    }
+
     // -----------------------------------------------------------------
     // Authenticated reads (`-Z remote-registry` client plumbing)
     // -----------------------------------------------------------------
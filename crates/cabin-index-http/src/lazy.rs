@@ -0,0 +1,285 @@
+//! On-demand sparse HTTP index for the resolver.
+//!
+//! [`HttpIndex::load_package_index`] walks every version of every
+//! reachable package up front, because any non-yanked version might
+//! be selected.  For packages with long histories that pulls in
+//! packages only ancient versions depended on.  [`LazyHttpIndex`]
+//! instead implements [`IndexSource`]: each `<name>.json` is fetched
+//! the first time the resolver asks for it and memoized, and the
+//! resolver's [`IndexSource::prefetch`] hints - the dependencies of
+//! the version it just chose - are fetched in parallel.  Traffic then
+//! tracks the solution rather than the history.
+
+use std::collections::BTreeMap;
+use std::sync::{Arc, Mutex, PoisonError};
+
+use cabin_core::PackageName;
+use cabin_index::{IndexEntry, IndexSource, PackageIndex};
+
+use crate::error::IndexHttpError;
+use crate::source::HttpIndex;
+
+/// Most metadata requests one prefetch keeps in flight.
+const MAX_PARALLEL_FETCHES: usize = 8;
+
+/// Memoizing, fetch-on-first-use view of an [`HttpIndex`].
+#[derive(Debug)]
+pub struct LazyHttpIndex {
+    index: HttpIndex,
+    fetched: Mutex<BTreeMap<PackageName, Arc<IndexEntry>>>,
+}
+
+impl LazyHttpIndex {
+    /// Wrap `index`; nothing is fetched until the first lookup.
+    pub fn new(index: HttpIndex) -> Self {
+        Self {
+            index,
+            fetched: Mutex::new(BTreeMap::new()),
+        }
+    }
+
+    /// The packages fetched so far, in the [`PackageIndex`] shape the
+    /// lockfile and fetch-plan layers read.  After a resolve this
+    /// holds every resolved package.
+    pub fn into_package_index(self) -> PackageIndex {
+        let fetched = self
+            .fetched
+            .into_inner()
+            .unwrap_or_else(PoisonError::into_inner);
+        PackageIndex {
+            root: self.index.root(),
+            packages: fetched
+                .into_iter()
+                .map(|(name, entry)| {
+                    (
+                        name,
+                        Arc::try_unwrap(entry).unwrap_or_else(|shared| (*shared).clone()),
+                    )
+                })
+                .collect(),
+        }
+    }
+
+    fn cached(&self, name: &PackageName) -> Option<Arc<IndexEntry>> {
+        self.fetched
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+            .get(name)
+            .cloned()
+    }
+
+    fn insert(&self, name: PackageName, entry: IndexEntry) -> Arc<IndexEntry> {
+        let entry = Arc::new(entry);
+        self.fetched
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+            .insert(name, Arc::clone(&entry));
+        entry
+    }
+}
+
+impl IndexSource for LazyHttpIndex {
+    type Entry<'s> = Arc<IndexEntry>;
+    type Error = IndexHttpError;
+
+    /// Fetch `name` on first use; later calls return the memoized
+    /// entry.  A package the registry does not serve is an error, as
+    /// it is for [`HttpIndex::load_package_index`].
+    fn package(&self, name: &PackageName) -> Result<Option<Arc<IndexEntry>>, IndexHttpError> {
+        if let Some(entry) = self.cached(name) {
+            return Ok(Some(entry));
+        }
+        let entry = self.index.fetch_package(name)?;
+        Ok(Some(self.insert(name.clone(), entry)))
+    }
+
+    /// Fetch the not-yet-loaded `names` on up to
+    /// `MAX_PARALLEL_FETCHES` threads and memoize the successes.
+    /// Failures are dropped; the resolver's own lookup retries the
+    /// fetch and reports the error.
+    fn prefetch(&self, names: &[&PackageName]) {
+        let mut pending: Vec<&PackageName> = names
+            .iter()
+            .copied()
+            .filter(|name| self.cached(name).is_none())
+            .collect();
+        pending.sort_unstable();
+        pending.dedup();
+        // A single miss gains nothing from a thread; the lookup that
+        // follows fetches it.
+        if pending.len() < 2 {
+            return;
+        }
+        let workers = MAX_PARALLEL_FETCHES.min(pending.len());
+        let queue = Mutex::new(pending.into_iter());
+        std::thread::scope(|scope| {
+            for _ in 0..workers {
+                scope.spawn(|| {
+                    loop {
+                        let next = queue.lock().unwrap_or_else(PoisonError::into_inner).next();
+                        let Some(name) = next else {
+                            break;
+                        };
+                        if let Ok(entry) = self.index.fetch_package(name) {
+                            self.insert(name.clone(), entry);
+                        }
+                    }
+                });
+            }
+        });
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::client::HttpClient;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+
+    const CONFIG: &str = r#"{
+        "schema": 1,
+        "kind": "file-registry",
+        "packages": "packages",
+        "artifacts": "artifacts"
+    }"#;
+
+    /// Static registry serving `config.json` plus one document per
+    /// `(name, body)` pair, counting package-document requests.
+    struct CountingRegistry {
+        server: Arc<tiny_http::Server>,
+        threads: Vec<std::thread::JoinHandle<()>>,
+        requests: Arc<AtomicUsize>,
+        url: String,
+    }
+
+    impl CountingRegistry {
+        fn start(packages: &[(&str, &str)]) -> Self {
+            let server = Arc::new(
+                tiny_http::Server::http("127.0.0.1:0").expect("bind tiny_http on loopback"),
+            );
+            let addr = server.server_addr().to_ip().expect("loopback addr");
+            let routes: Arc<BTreeMap<String, String>> = Arc::new(
+                packages
+                    .iter()
+                    .map(|(name, body)| (format!("/packages/{name}.json"), (*body).to_owned()))
+                    .collect(),
+            );
+            let requests = Arc::new(AtomicUsize::new(0));
+            // Several workers so parallel prefetches are really
+            // served concurrently.
+            let threads = (0..4)
+                .map(|_| {
+                    let server = Arc::clone(&server);
+                    let routes = Arc::clone(&routes);
+                    let requests = Arc::clone(&requests);
+                    std::thread::spawn(move || {
+                        while let Ok(req) = server.recv() {
+                            let path = req.url().to_string();
+                            if path == "/config.json" {
+                                let _ = req.respond(tiny_http::Response::from_string(CONFIG));
+                                continue;
+                            }
+                            requests.fetch_add(1, Ordering::SeqCst);
+                            let response = match routes.get(&path) {
+                                Some(body) => tiny_http::Response::from_string(body.clone()),
+                                None => tiny_http::Response::from_string("").with_status_code(404),
+                            };
+                            let _ = req.respond(response);
+                        }
+                    })
+                })
+                .collect();
+            Self {
+                server,
+                threads,
+                requests,
+                url: format!("http://{addr}/"),
+            }
+        }
+
+        fn lazy_index(&self) -> LazyHttpIndex {
+            LazyHttpIndex::new(HttpIndex::open(&self.url, HttpClient::new()).unwrap())
+        }
+    }
+
+    impl Drop for CountingRegistry {
+        fn drop(&mut self) {
+            for _ in &self.threads {
+                self.server.unblock();
+            }
+            for handle in self.threads.drain(..) {
+                let _ = handle.join();
+            }
+        }
+    }
+
+    fn name(s: &str) -> PackageName {
+        PackageName::new(s).unwrap()
+    }
+
+    fn document(package: &str) -> String {
+        format!(
+            r#"{{ "schema": 1, "name": "{package}", "versions": {{ "1.0.0": {{ "dependencies": {{}} }} }} }}"#
+        )
+    }
+
+    #[test]
+    fn package_is_fetched_once_and_memoized() {
+        let fmt = document("fmt");
+        let registry = CountingRegistry::start(&[("fmt", &fmt)]);
+        let index = registry.lazy_index();
+        for _ in 0..3 {
+            let entry = index.package(&name("fmt")).unwrap().unwrap();
+            assert_eq!(entry.name, name("fmt"));
+        }
+        assert_eq!(registry.requests.load(Ordering::SeqCst), 1);
+        let loaded = index.into_package_index();
+        assert_eq!(loaded.packages.keys().collect::<Vec<_>>(), [&name("fmt")]);
+    }
+
+    /// Only the packages asked about are fetched: a package the
+    /// registry serves but nobody looks up costs no request, which is
+    /// the point of the lazy source over the eager closure walk.
+    #[test]
+    fn unrequested_packages_are_never_fetched() {
+        let (fmt, legacy) = (document("fmt"), document("legacy"));
+        let registry = CountingRegistry::start(&[("fmt", &fmt), ("legacy", &legacy)]);
+        let index = registry.lazy_index();
+        index.package(&name("fmt")).unwrap();
+        assert_eq!(registry.requests.load(Ordering::SeqCst), 1);
+        assert!(
+            !index
+                .into_package_index()
+                .packages
+                .contains_key(&name("legacy"))
+        );
+    }
+
+    #[test]
+    fn prefetch_loads_every_hint_and_skips_failures() {
+        let docs: Vec<(String, String)> = ["a", "b", "c"]
+            .iter()
+            .map(|pkg| ((*pkg).to_owned(), document(pkg)))
+            .collect();
+        let routes: Vec<(&str, &str)> = docs
+            .iter()
+            .map(|(pkg, body)| (pkg.as_str(), body.as_str()))
+            .collect();
+        let registry = CountingRegistry::start(&routes);
+        let index = registry.lazy_index();
+        let (a, b, c, ghost) = (name("a"), name("b"), name("c"), name("ghost"));
+        index.prefetch(&[&a, &b, &c, &ghost, &a]);
+        // One request per distinct name, the duplicate folded.
+        assert_eq!(registry.requests.load(Ordering::SeqCst), 4);
+
+        // Prefetched entries are served from memory...
+        index.package(&b).unwrap();
+        assert_eq!(registry.requests.load(Ordering::SeqCst), 4);
+        // ...and a failed prefetch is retried and reported on lookup.
+        assert!(matches!(
+            index.package(&ghost),
+            Err(IndexHttpError::PackageNotFound { .. })
+        ));
+        assert_eq!(registry.requests.load(Ordering::SeqCst), 5);
+    }
+}
@@ -27,17 +27,23 @@
 //!   `http` beyond loopback hosts;
 //! - it never honors redirects to alternate registries, never
 //!   persists a metadata cache;
+//! - it negotiates gzip for metadata reads only
+//!   ([`HttpClient::get_metadata`]), capping the decompressed body;
 //! - it produces the same [`cabin_index::IndexEntry`] / [`cabin_index::PackageIndex`]
 //!   shape as the local file index, so the resolver and lockfile
-//!   layers stay HTTP-free.
+//!   layers stay HTTP-free; [`LazyHttpIndex`] serves the resolver
+//!   through [`cabin_index::IndexSource`], fetching each document
+//!   only when the solve reaches it.
 //!
 //! HTTP publish, server-side functionality, OCI / GHCR, package
 //! upload, authentication, and ownership are out of scope.
 
 pub mod client;
 pub mod error;
+pub mod lazy;
 pub mod source;
 
 pub use client::{HttpClient, RegistryAuth, fetch_login_url};
 pub use error::IndexHttpError;
+pub use lazy::LazyHttpIndex;
 pub use source::HttpIndex;
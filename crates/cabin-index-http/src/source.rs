@@ -64,7 +64,7 @@ impl HttpIndex {
     /// [`IndexHttpError::InvalidConfig`] when `config.json` is not
     /// valid JSON or its `schema`/`kind`/`packages`/`artifacts` fail
     /// validation.  Propagates the fetch errors of
-    /// [`HttpClient::get_bytes`].
+    /// [`HttpClient::get_metadata`].
     ///
     /// Opens with every experimental feature disabled, so a
     /// `config.json` that carries a remote-registry field
@@ -97,7 +97,7 @@ impl HttpIndex {
                 message: format!("cannot append config.json: {err}"),
             })?;
 
-        let body = client.get_bytes(config_url.as_str(), "config")?;
+        let body = client.get_metadata(config_url.as_str(), "config")?;
         let raw: RawRegistryConfig =
             serde_json::from_slice(&body).map_err(|err| IndexHttpError::InvalidConfig {
                 base_url: base.to_string(),
@@ -140,7 +140,7 @@ impl HttpIndex {
     /// [`IndexHttpError::InvalidMetadata`] when the body is not valid
     /// UTF-8, fails to parse, or declares a mismatched name;
     /// [`IndexHttpError::Index`] wraps any other parse error.
-    /// Propagates the fetch errors of [`HttpClient::get_bytes`].
+    /// Propagates the fetch errors of [`HttpClient::get_metadata`].
     pub fn fetch_package(&self, name: &PackageName) -> Result<IndexEntry, IndexHttpError> {
         // Defense-in-depth at the URL boundary.
         // `PackageName::new` already rejects unsafe names, but
@@ -149,7 +149,9 @@ impl HttpIndex {
         // the configured packages directory through this fetch.
         ensure_path_safe(name.as_str())?;
         let package_url = self.package_url(name.as_str())?;
-        let body = self.client.get_bytes(package_url.as_str(), name.as_str())?;
+        let body = self
+            .client
+            .get_metadata(package_url.as_str(), name.as_str())?;
         let body_str =
             std::str::from_utf8(&body).map_err(|err| IndexHttpError::InvalidMetadata {
                 name: name.as_str().to_owned(),
@@ -185,7 +187,9 @@ impl HttpIndex {
     /// The walker only fetches packages that are reachable from
     /// `roots`; a sparse HTTP registry can hold thousands of
     /// packages, but a single `cabin resolve` run only ever
-    /// references the closure of its declared dependencies.
+    /// references the closure of its declared dependencies.  The
+    /// resolver reads through [`crate::LazyHttpIndex`] instead, which
+    /// fetches only the packages the solve actually reaches.
     ///
     /// # Errors
     /// Returns [`IndexHttpError::UnsafePackageName`] when any root or
@@ -248,12 +252,17 @@ impl HttpIndex {
             packages.insert(name, entry);
         }
         Ok(PackageIndex {
-            // Use the base URL string as the displayable root.
-            root: std::path::PathBuf::from(self.base.as_str()),
+            root: self.root(),
             packages,
         })
     }
 
+    /// The displayable [`PackageIndex::root`] of an index assembled
+    /// from this source: the base URL string.
+    pub(crate) fn root(&self) -> std::path::PathBuf {
+        std::path::PathBuf::from(self.base.as_str())
+    }
+
     fn package_url(&self, name: &str) -> Result<url::Url, IndexHttpError> {
         // A scoped name's `/` nests the document one directory deeper
         // (`packages/<scope>/<name>.json`), mirroring the file-registry
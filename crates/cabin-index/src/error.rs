@@ -63,6 +63,16 @@ pub enum IndexError {
         condition: String,
     },
 
+    #[error(
+        "invalid index entry for package {package:?} version {version}: dependency {dep:?} declares a `target_feature`-conditioned `target` ({condition:?}); target features follow the consumer's build profile, so index dependency gates must stay platform-only"
+    )]
+    TargetFeatureConditionedDependency {
+        package: String,
+        version: String,
+        dep: String,
+        condition: String,
+    },
+
     #[error(
         "invalid index entry for package {package:?} version {version}: dependency {dep:?} has invalid requirement {requirement:?} ({source})"
     )]
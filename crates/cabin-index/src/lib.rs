@@ -8,12 +8,16 @@
 //! archives.
 //!
 //! This crate owns that format.  It loads the JSON files,
-//! validates them, and exposes a typed [`PackageIndex`].
+//! validates them, and exposes a typed [`PackageIndex`].  The
+//! [`IndexSource`] trait is the per-package view the resolver reads,
+//! implemented here for the in-memory index and by `cabin-index-http`
+//! for the sparse HTTP index.
 //! Resolution against the index lives in `cabin-resolver`.
 
 pub mod error;
 pub mod loader;
 pub mod model;
+pub mod source;
 
 pub use error::IndexError;
 pub use loader::{SourceContext, load_index, load_index_with_features, parse_package_entry};
@@ -21,6 +25,7 @@ pub use model::{
     IndexEntry, IndexPackageDependency, IndexSystemDependency, PackageIndex, SourceLocation,
     VersionMetadata,
 };
+pub use source::IndexSource;
 // Re-exported so index consumers (the resolver's preference mode and
 // publish lints) can name the standard-metadata types reachable on
 // `VersionMetadata::standards` without depending on `cabin-core`
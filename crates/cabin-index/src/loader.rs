@@ -310,8 +310,9 @@ fn load_package_file(path: &Path, scope: Option<&str>) -> Result<IndexEntry, Ind
 /// [`IndexError::InvalidVersion`] for a non-SemVer version,
 /// [`IndexError::InvalidRequirement`] for an unparsable dependency
 /// requirement, and [`IndexError::CompilerConditionedDependency`]
-/// when a dependency or system-dependency `target` references the
-/// compiler.  It also propagates the source-artifact errors
+/// or [`IndexError::TargetFeatureConditionedDependency`] when a
+/// dependency or system-dependency `target` references the compiler
+/// or a target feature.  It also propagates the source-artifact errors
 /// ([`IndexError::UnsupportedSourceType`],
 /// [`IndexError::UnsupportedSourceFormat`],
 /// [`IndexError::MissingSourcePath`], and any error returned by the
@@ -436,7 +437,7 @@ fn parse_kinded_dependencies(
         // the manifest layer rejects them.  Reject hand-authored
         // entries here so an index can never gate resolver / prefetch
         // edges on the local compiler.
-        reject_compiler_condition(package, version, &dep_name, condition.as_ref())?;
+        reject_non_platform_condition(package, version, &dep_name, condition.as_ref())?;
         deps.insert(
             dep_name_validated,
             IndexPackageDependency {
@@ -466,7 +467,7 @@ fn parse_system_dependencies(
         // Same platform-only invariant as package dependencies:
         // system-dependency activation never sees toolchain
         // detection, so a compiler-conditioned gate is rejected.
-        reject_compiler_condition(package, version, &sys_name, raw_sys.target.as_ref())?;
+        reject_non_platform_condition(package, version, &sys_name, raw_sys.target.as_ref())?;
         deps.insert(
             validated,
             IndexSystemDependency {
@@ -480,22 +481,24 @@ fn parse_system_dependencies(
 }
 
 /// Reject a compiler-referencing (`cc` / `cxx` / `cc_version` /
-/// `cxx_version`) `target` condition on an index dependency entry.
+/// `cxx_version`) or `target_feature` `target` condition on an
+/// index dependency entry.
 /// Index gates are evaluated with a platform-only context - no
 /// toolchain detection runs before resolution - so a compiler leaf
 /// would evaluate against family `unknown` and could activate edges
 /// for nonsense reasons.  The manifest layer already rejects these on
 /// dependency tables, so only hand-authored index entries can carry
 /// them; refuse to load such an entry.
-fn reject_compiler_condition(
+fn reject_non_platform_condition(
     package: &str,
     version: &str,
     dep: &str,
     condition: Option<&Condition>,
 ) -> Result<(), IndexError> {
-    if let Some(cond) = condition
-        && cond.references_compiler()
-    {
+    let Some(cond) = condition else {
+        return Ok(());
+    };
+    if cond.references_compiler() {
         return Err(IndexError::CompilerConditionedDependency {
             package: package.to_owned(),
             version: version.to_owned(),
@@ -503,6 +506,14 @@ fn reject_compiler_condition(
             condition: cond.to_string(),
         });
     }
+    if cond.references_target_feature() {
+        return Err(IndexError::TargetFeatureConditionedDependency {
+            package: package.to_owned(),
+            version: version.to_owned(),
+            dep: dep.to_owned(),
+            condition: cond.to_string(),
+        });
+    }
     Ok(())
 }
 
@@ -991,6 +1002,34 @@ mod tests {
         }
     }
 
+    #[test]
+    fn target_feature_conditioned_dependency_target_is_rejected() {
+        let dir = TempDir::new().unwrap();
+        dir.child("simd.json")
+            .write_str(
+                r#"{
+                "schema": 1,
+                "name": "simd",
+                "versions": {
+                    "1.0.0": {
+                        "dependencies": {
+                            "avx-kernels": { "version": "^1", "target": "target_feature = \"avx2\"" }
+                        }
+                    }
+                }
+            }"#,
+            )
+            .unwrap();
+        let err = load_index(dir.path()).unwrap_err();
+        match err {
+            IndexError::TargetFeatureConditionedDependency { dep, condition, .. } => {
+                assert_eq!(dep, "avx-kernels");
+                assert_eq!(condition, r#"target_feature = "avx2""#);
+            }
+            other => panic!("expected TargetFeatureConditionedDependency, got {other:?}"),
+        }
+    }
+
     #[test]
     fn name_filename_mismatch_errors() {
         let dir = TempDir::new().unwrap();
@@ -0,0 +1,54 @@
+//! Per-package access to an index, for consumers that only need the
+//! packages they actually ask about.
+//!
+//! The resolver reads the index one package at a time.  A local
+//! [`PackageIndex`] is already fully in memory, but a remote index
+//! can serve each package document on demand, so the resolver is
+//! written against [`IndexSource`] rather than a loaded
+//! [`PackageIndex`] and the remote implementation fetches only the
+//! packages the solve reaches.
+
+use std::convert::Infallible;
+use std::ops::Deref;
+
+use cabin_core::PackageName;
+
+use crate::model::{IndexEntry, PackageIndex};
+
+/// A source of [`IndexEntry`] documents, looked up by package name.
+pub trait IndexSource {
+    /// Handle to a loaded entry: a plain borrow for in-memory
+    /// indexes, a shared pointer for sources that load lazily.
+    type Entry<'s>: Deref<Target = IndexEntry>
+    where
+        Self: 's;
+
+    /// Error raised when a package's document cannot be loaded.
+    type Error: std::error::Error + Send + Sync + 'static;
+
+    /// The entry for `name`, or `None` when the index has no such
+    /// package.
+    ///
+    /// # Errors
+    /// Returns [`Self::Error`] when the entry exists but cannot be
+    /// loaded.
+    fn package(&self, name: &PackageName) -> Result<Option<Self::Entry<'_>>, Self::Error>;
+
+    /// Hint that `names` are likely to be asked for next, so a lazy
+    /// source can load them together.  Purely an optimization: a
+    /// failure here must not be reported, since the later
+    /// [`Self::package`] call for the same name reports it.  The
+    /// default does nothing.
+    fn prefetch(&self, names: &[&PackageName]) {
+        let _ = names;
+    }
+}
+
+impl IndexSource for PackageIndex {
+    type Entry<'s> = &'s IndexEntry;
+    type Error = Infallible;
+
+    fn package(&self, name: &PackageName) -> Result<Option<&IndexEntry>, Infallible> {
+        Ok(self.packages.get(name))
+    }
+}
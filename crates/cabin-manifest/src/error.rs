@@ -98,6 +98,25 @@ pub enum ManifestError {
     )]
     HeaderOnlyDeclaresSources { target: String },
 
+    #[error(
+        "target {target:?} is `{kind}`; `{field}` describes how `cabin test` runs a `test` target and only applies there"
+    )]
+    TestOnlyField {
+        target: String,
+        kind: String,
+        field: &'static str,
+    },
+
+    #[error(
+        "unknown test harness {value:?} for target {target:?} (expected `\"gtest\"`, `\"catch2\"`, or a `{{ list = [...], filter = \"...{{}}...\" }}` table)"
+    )]
+    UnknownTestHarness { target: String, value: String },
+
+    #[error(
+        "test harness of target {target:?} has a `filter` without a `{{}}` placeholder for the selected case names"
+    )]
+    TestHarnessFilterWithoutPlaceholder { target: String },
+
     // -----------------------------------------------------------------
     // Dependency-kind errors.
     // -----------------------------------------------------------------
@@ -133,6 +152,14 @@ pub enum ManifestError {
         table: &'static str,
     },
 
+    #[error(
+        "`cfg(target_feature = ...)` in `[target.{condition:?}]` may only gate a `.profile` flag table, not the `{table}` table; target features come from the selected profile's `target-cpu`, which is not known when dependencies or the toolchain are selected"
+    )]
+    TargetFeatureConditionNotAllowedHere {
+        condition: String,
+        table: &'static str,
+    },
+
     #[error(
         "optional dependencies are not supported in {section}; declared optional dependency: {name:?}",
         section = kind.manifest_section(),
@@ -182,6 +209,23 @@ pub enum ManifestError {
     )]
     InvalidInheritedProfileName { profile: String, value: String },
 
+    #[error("`[profile.{profile}]` has an invalid `target-cpu`: {source}")]
+    InvalidProfileTargetCpu {
+        profile: String,
+        #[source]
+        source: ValidationError,
+    },
+
+    #[error(
+        "`[profile.{profile}.package.{spec:?}]` must name a package or be `\"*\"` for every dependency: {source}"
+    )]
+    InvalidProfilePackageSpec {
+        profile: String,
+        spec: String,
+        #[source]
+        source: ValidationError,
+    },
+
     #[error(
         "`inherits` is not allowed in {table}; profile inheritance must be defined by `[profile.{profile}]`"
     )]
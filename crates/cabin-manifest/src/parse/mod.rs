@@ -317,21 +317,23 @@ fn parsed_from_raw(raw: RawManifest) -> Result<ParsedManifest, ManifestError> {
 }
 
 /// Reject `cfg(feature = ...)` on conditional tables that cannot honor
-/// it.  Feature and compiler conditions are only meaningful on flag
-/// (`.profile`) tables: feature resolution walks the dependency
-/// graph, so a feature gating a dependency would be circular;
-/// compiler identity comes from toolchain detection, which has not
-/// run when dependencies or the toolchain itself are selected (and
-/// gating the toolchain on the detected compiler would be circular
-/// outright). Called before the package / workspace-root split so it
-/// applies to both.
+/// it.  Feature, compiler, and target-feature conditions are only
+/// meaningful on flag (`.profile`) tables: feature resolution walks
+/// the dependency graph, so a feature gating a dependency would be
+/// circular; compiler identity comes from toolchain detection, which
+/// has not run when dependencies or the toolchain itself are selected
+/// (and gating the toolchain on the detected compiler would be
+/// circular outright); target features follow the selected profile,
+/// which dependency resolution does not see. Called before the
+/// package / workspace-root split so it applies to both.
 fn reject_unsupported_target_conditions(
     conditional_targets: &[RawConditionalTarget],
 ) -> Result<(), ManifestError> {
     for cond_target in conditional_targets {
         let references_feature = cond_target.condition.references_feature();
         let references_compiler = cond_target.condition.references_compiler();
-        if !references_feature && !references_compiler {
+        let references_target_feature = cond_target.condition.references_target_feature();
+        if !references_feature && !references_compiler && !references_target_feature {
             continue;
         }
         let table: &'static str = if !cond_target.deps.is_empty() {
@@ -347,7 +349,10 @@ fn reject_unsupported_target_conditions(
         if references_feature {
             return Err(ManifestError::FeatureConditionNotAllowedHere { condition, table });
         }
-        return Err(ManifestError::CompilerConditionNotAllowedHere { condition, table });
+        if references_compiler {
+            return Err(ManifestError::CompilerConditionNotAllowedHere { condition, table });
+        }
+        return Err(ManifestError::TargetFeatureConditionNotAllowedHere { condition, table });
     }
     Ok(())
 }
@@ -26,6 +26,19 @@ pub(super) fn profiles_from_raw(
             })
             .transpose()?;
         let build = profile_flags_from_overrides(&raw_profile)?;
+        let package = package_overrides_from_raw(&pname, raw_profile.package.as_ref())?;
+        let target_cpu = raw_profile
+            .target_cpu
+            .as_deref()
+            .map(|raw| {
+                cabin_core::TargetCpu::parse(raw).map_err(|source| {
+                    ManifestError::InvalidProfileTargetCpu {
+                        profile: pname.as_str().to_owned(),
+                        source,
+                    }
+                })
+            })
+            .transpose()?;
         out.insert(
             pname.clone(),
             cabin_core::ProfileDefinition {
@@ -34,7 +47,41 @@ pub(super) fn profiles_from_raw(
                 debug: raw_profile.debug,
                 opt_level: raw_profile.opt_level,
                 assertions: raw_profile.assertions,
+                thin_archives: raw_profile.thin_archives,
+                target_cpu,
                 build,
+                package,
+            },
+        );
+    }
+    Ok(out)
+}
+
+/// Validate the `[profile.<name>.package.<spec>]` keys: `"*"` or a
+/// package name.  A named package need not be in the dependency
+/// graph; an override for a package that is never built is inert.
+fn package_overrides_from_raw(
+    profile: &cabin_core::ProfileName,
+    raw: Option<&BTreeMap<String, crate::raw::RawProfilePackage>>,
+) -> Result<
+    BTreeMap<cabin_core::ProfilePackageSelector, cabin_core::ProfilePackageOverride>,
+    ManifestError,
+> {
+    let mut out = BTreeMap::new();
+    for (spec, layer) in raw.into_iter().flatten() {
+        let selector = cabin_core::ProfilePackageSelector::parse(spec).map_err(|source| {
+            ManifestError::InvalidProfilePackageSpec {
+                profile: profile.as_str().to_owned(),
+                spec: spec.clone(),
+                source,
+            }
+        })?;
+        out.insert(
+            selector,
+            cabin_core::ProfilePackageOverride {
+                opt_level: layer.opt_level,
+                debug: layer.debug,
+                assertions: layer.assertions,
             },
         );
     }
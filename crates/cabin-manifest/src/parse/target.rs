@@ -1,6 +1,6 @@
 use crate::error::ManifestError;
-use crate::raw::{RawDependency, RawStandardField, RawTarget};
-use cabin_core::{Condition, Target, TargetKind, TargetName};
+use crate::raw::{RawDependency, RawStandardField, RawTarget, RawTestHarness};
+use cabin_core::{Condition, CustomTestHarness, Target, TargetKind, TargetName, TestHarness};
 use serde::Deserialize;
 use std::collections::BTreeMap;
 
@@ -17,6 +17,8 @@ pub(super) fn target_from_raw(name: String, raw: RawTarget) -> Result<Target, Ma
         interface_c_standard,
         interface_cxx_standard,
         gnu_extensions,
+        data,
+        harness,
     } = raw;
 
     let target_name = TargetName::new(name.clone())?;
@@ -71,6 +73,26 @@ pub(super) fn target_from_raw(name: String, raw: RawTarget) -> Result<Target, Ma
         }
     }
 
+    if kind != TargetKind::Test {
+        let offending = if !data.is_empty() {
+            Some("data")
+        } else if harness.is_some() {
+            Some("harness")
+        } else {
+            None
+        };
+        if let Some(field) = offending {
+            return Err(ManifestError::TestOnlyField {
+                target: name,
+                kind: kind.as_str().to_owned(),
+                field,
+            });
+        }
+    }
+    let harness = harness
+        .map(|raw| test_harness_from_raw(&name, raw))
+        .transpose()?;
+
     Ok(Target {
         name: target_name,
         kind,
@@ -80,9 +102,39 @@ pub(super) fn target_from_raw(name: String, raw: RawTarget) -> Result<Target, Ma
         deps,
         required_features,
         language,
+        data,
+        harness,
     })
 }
 
+fn test_harness_from_raw(
+    target_name: &str,
+    raw: RawTestHarness,
+) -> Result<TestHarness, ManifestError> {
+    match raw {
+        RawTestHarness::Named(name) => match name.as_str() {
+            "gtest" => Ok(TestHarness::Gtest),
+            "catch2" => Ok(TestHarness::Catch2),
+            _ => Err(ManifestError::UnknownTestHarness {
+                target: target_name.to_owned(),
+                value: name,
+            }),
+        },
+        RawTestHarness::Custom(custom) => {
+            if !custom.filter.contains("{}") {
+                return Err(ManifestError::TestHarnessFilterWithoutPlaceholder {
+                    target: target_name.to_owned(),
+                });
+            }
+            Ok(TestHarness::Custom(CustomTestHarness {
+                list: custom.list,
+                filter: custom.filter,
+                separator: custom.separator.unwrap_or_else(|| ",".to_owned()),
+            }))
+        }
+    }
+}
+
 /// Raw shape of one `[target.'cfg(...)'.<...>]` entry, after we
 /// have decided the entry is a target-conditional dep table
 /// (i.e. the outer name is a `cfg(...)` expression).  Captured
@@ -206,7 +258,8 @@ fn validate_named_overlay_fields(
                     profile: profile.as_str().to_owned(),
                 });
             }
-            "debug" | "opt-level" | "assertions" | "toolchain" => {
+            "debug" | "opt-level" | "assertions" | "thin-archives" | "target-cpu" | "package"
+            | "toolchain" => {
                 return Err(ManifestError::NamedTargetProfileField {
                     table,
                     field: field.clone(),
@@ -253,6 +306,7 @@ pub(super) fn parse_target_kind(
         "executable" => Ok(TargetKind::Executable),
         "test" => Ok(TargetKind::Test),
         "example" => Ok(TargetKind::Example),
+        "bench" => Ok(TargetKind::Bench),
         other => Err(ManifestError::UnknownTargetType {
             target: target_name.to_owned(),
             value: other.to_owned(),
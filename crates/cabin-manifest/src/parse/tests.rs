@@ -907,6 +907,10 @@ fn parses_all_supported_target_kinds() {
             [target.e]
             type = "header-only"
             include-dirs = ["include"]
+
+            [target.f]
+            type = "bench"
+            sources = ["benches/g.cc"]
         "#;
     let package = parse_project(manifest);
     let kinds: Vec<TargetKind> = package.targets.iter().map(|t| t.kind).collect();
@@ -918,6 +922,7 @@ fn parses_all_supported_target_kinds() {
             TargetKind::Test,
             TargetKind::Example,
             TargetKind::HeaderOnly,
+            TargetKind::Bench,
         ]
     );
 }
@@ -1702,6 +1707,138 @@ fn target_required_features_reject_undeclared_feature() {
     }
 }
 
+#[test]
+fn test_target_harness_parses_named_and_custom_forms() {
+    let manifest = r#"
+            [package]
+            name = "demo"
+            version = "0.1.0"
+            cxx-standard = "c++17"
+
+            [target.unit_gtest]
+            type = "test"
+            sources = ["tests/gtest.cc"]
+            harness = "gtest"
+
+            [target.unit_doctest]
+            type = "test"
+            sources = ["tests/doctest.cc"]
+            harness = { list = ["--list-test-cases", "--no-intro"], filter = "--test-case={}" }
+        "#;
+    let package = parse_project(manifest);
+    let harness = |name: &str| {
+        package
+            .targets
+            .iter()
+            .find(|t| t.name.as_str() == name)
+            .unwrap()
+            .harness
+            .clone()
+    };
+    assert_eq!(harness("unit_gtest"), Some(cabin_core::TestHarness::Gtest));
+    assert_eq!(
+        harness("unit_doctest"),
+        Some(cabin_core::TestHarness::Custom(
+            cabin_core::CustomTestHarness {
+                list: vec!["--list-test-cases".into(), "--no-intro".into()],
+                filter: "--test-case={}".into(),
+                separator: ",".into(),
+            }
+        ))
+    );
+}
+
+#[test]
+fn test_target_data_parses_and_is_rejected_on_other_kinds() {
+    let manifest = r#"
+            [package]
+            name = "demo"
+            version = "0.1.0"
+            cxx-standard = "c++17"
+
+            [target.unit]
+            type = "test"
+            sources = ["tests/unit.cc"]
+            data = ["tests/fixtures", "tests/golden.txt"]
+        "#;
+    let package = parse_project(manifest);
+    assert_eq!(
+        package.targets[0].data,
+        vec![
+            Utf8PathBuf::from("tests/fixtures"),
+            Utf8PathBuf::from("tests/golden.txt")
+        ]
+    );
+
+    let on_library = r#"
+            [package]
+            name = "demo"
+            version = "0.1.0"
+            cxx-standard = "c++17"
+
+            [target.demo]
+            type = "library"
+            sources = ["src/lib.cc"]
+            data = ["fixtures"]
+        "#;
+    assert!(matches!(
+        parse_project_err(on_library),
+        ManifestError::TestOnlyField { field, .. } if field == "data"
+    ));
+}
+
+#[test]
+fn harness_is_rejected_outside_test_targets_and_validated() {
+    let on_executable = r#"
+            [package]
+            name = "demo"
+            version = "0.1.0"
+            cxx-standard = "c++17"
+
+            [target.app]
+            type = "executable"
+            sources = ["src/main.cc"]
+            harness = "gtest"
+        "#;
+    assert!(matches!(
+        parse_project_err(on_executable),
+        ManifestError::TestOnlyField { target, kind, field }
+            if target == "app" && kind == "executable" && field == "harness"
+    ));
+
+    let unknown = r#"
+            [package]
+            name = "demo"
+            version = "0.1.0"
+            cxx-standard = "c++17"
+
+            [target.unit]
+            type = "test"
+            sources = ["tests/unit.cc"]
+            harness = "boost"
+        "#;
+    assert!(matches!(
+        parse_project_err(unknown),
+        ManifestError::UnknownTestHarness { value, .. } if value == "boost"
+    ));
+
+    let no_placeholder = r#"
+            [package]
+            name = "demo"
+            version = "0.1.0"
+            cxx-standard = "c++17"
+
+            [target.unit]
+            type = "test"
+            sources = ["tests/unit.cc"]
+            harness = { list = ["--list"], filter = "--run" }
+        "#;
+    assert!(matches!(
+        parse_project_err(no_placeholder),
+        ManifestError::TestHarnessFilterWithoutPlaceholder { target } if target == "unit"
+    ));
+}
+
 #[test]
 fn features_cycle_errors() {
     let manifest = r#"
@@ -2178,6 +2315,40 @@ fn manifest_without_profile_tables_round_trips() {
     assert!(package.profiles.is_empty());
 }
 
+#[test]
+fn profile_target_cpu_is_parsed_and_validated() {
+    let package = parse_project(
+        r#"
+            [package]
+            name = "app"
+            version = "0.1.0"
+
+            [profile.release]
+            target-cpu = "x86-64-v3"
+        "#,
+    );
+    let release = cabin_core::ProfileName::new("release").unwrap();
+    assert_eq!(
+        package.profiles[&release].target_cpu,
+        Some(cabin_core::TargetCpu::X86_64(cabin_core::X86Level::V3))
+    );
+
+    let err = parse_project_err(
+        r#"
+            [package]
+            name = "app"
+            version = "0.1.0"
+
+            [profile.release]
+            target-cpu = "skylake -fplugin=evil.so"
+        "#,
+    );
+    assert!(
+        matches!(err, ManifestError::InvalidProfileTargetCpu { ref profile, .. } if profile == "release"),
+        "{err:?}"
+    );
+}
+
 #[test]
 fn dev_override_is_parsed() {
     let package = parse_project(
@@ -2189,6 +2360,7 @@ fn dev_override_is_parsed() {
             [profile.dev]
             opt-level = 1
             assertions = false
+            thin-archives = true
         "#,
     );
     let dev_name = cabin_core::ProfileName::new("dev").unwrap();
@@ -2196,9 +2368,74 @@ fn dev_override_is_parsed() {
     assert!(dev.inherits.is_none());
     assert_eq!(dev.opt_level, Some(cabin_core::OptLevel::O1));
     assert_eq!(dev.assertions, Some(false));
+    assert_eq!(dev.thin_archives, Some(true));
     assert!(dev.debug.is_none());
 }
 
+#[test]
+fn profile_package_overrides_are_parsed() {
+    use cabin_core::{OptLevel, ProfilePackageSelector};
+    let package = parse_project(
+        r#"
+            [package]
+            name = "app"
+            version = "0.1.0"
+
+            [profile.dev.package."*"]
+            opt-level = 2
+
+            [profile.dev.package.zlib]
+            opt-level = 3
+            debug = false
+            assertions = false
+        "#,
+    );
+    let dev = &package.profiles[&cabin_core::ProfileName::new("dev").unwrap()];
+    let all = &dev.package[&ProfilePackageSelector::Dependencies];
+    assert_eq!(all.opt_level, Some(OptLevel::O2));
+    assert!(all.debug.is_none());
+    let zlib = &dev.package
+        [&ProfilePackageSelector::Package(cabin_core::PackageName::new("zlib").unwrap())];
+    assert_eq!(zlib.opt_level, Some(OptLevel::O3));
+    assert_eq!(zlib.debug, Some(false));
+    assert_eq!(zlib.assertions, Some(false));
+}
+
+#[test]
+fn profile_package_override_rejects_invalid_spec_and_fields() {
+    let err = parse_project_err(
+        r#"
+            [package]
+            name = "app"
+            version = "0.1.0"
+
+            [profile.dev.package."not a package"]
+            opt-level = 2
+        "#,
+    );
+    match err {
+        ManifestError::InvalidProfilePackageSpec { profile, spec, .. } => {
+            assert_eq!(profile, "dev");
+            assert_eq!(spec, "not a package");
+        }
+        other => panic!("expected InvalidProfilePackageSpec, got {other:?}"),
+    }
+
+    // Flags, inheritance and archive shape stay profile-wide.
+    let err = parse_manifest_str(
+        r#"
+            [package]
+            name = "app"
+            version = "0.1.0"
+
+            [profile.dev.package."*"]
+            cxxflags = ["-O2"]
+        "#,
+    )
+    .unwrap_err();
+    assert!(err.to_string().contains("cxxflags"), "{err}");
+}
+
 #[test]
 fn release_override_is_parsed_with_string_opt_level() {
     let package = parse_project(
@@ -2466,6 +2703,16 @@ fn target_named_profile_overlay_rejects_definition_and_unknown_fields() {
             "`assertions` is not allowed",
             "may only contain array flag fields",
         ),
+        (
+            "thin-archives = true",
+            "`thin-archives` is not allowed",
+            "may only contain array flag fields",
+        ),
+        (
+            r#"target-cpu = "native""#,
+            "`target-cpu` is not allowed",
+            "may only contain array flag fields",
+        ),
         (
             r#"toolchain = { cxx = "clang++" }"#,
             "`toolchain` is not allowed",
@@ -2597,6 +2844,42 @@ fn compiler_cfg_on_dependency_table_is_rejected() {
     }
 }
 
+#[test]
+fn target_feature_cfg_is_a_profile_table_only_condition() {
+    let package = parse_project(
+        r#"
+            [package]
+            name = "app"
+            version = "0.1.0"
+
+            [target.'cfg(target_feature = "avx2")'.profile]
+            defines = ["HAVE_AVX2"]
+        "#,
+    );
+    assert!(
+        package.build.conditional[0]
+            .condition
+            .references_target_feature()
+    );
+
+    let err = parse_project_err(
+        r#"
+            [package]
+            name = "app"
+            version = "0.1.0"
+
+            [target.'cfg(target_feature = "avx2")'.dependencies]
+            simd = { path = "../simd" }
+        "#,
+    );
+    match err {
+        ManifestError::TargetFeatureConditionNotAllowedHere { table, .. } => {
+            assert_eq!(table, "dependencies");
+        }
+        other => panic!("expected TargetFeatureConditionNotAllowedHere, got {other:?}"),
+    }
+}
+
 #[test]
 fn compiler_cfg_on_dev_dependency_table_is_rejected() {
     let manifest = r#"
@@ -178,6 +178,11 @@ pub(crate) struct RawProfile {
     pub(crate) opt_level: Option<cabin_core::OptLevel>,
     #[serde(default)]
     pub(crate) assertions: Option<bool>,
+    #[serde(default, rename = "thin-archives")]
+    pub(crate) thin_archives: Option<bool>,
+    /// Validated into a [`cabin_core::TargetCpu`] by the parser.
+    #[serde(default, rename = "target-cpu")]
+    pub(crate) target_cpu: Option<String>,
     #[serde(default)]
     pub(crate) defines: Option<Vec<String>>,
     #[serde(default, rename = "include-dirs")]
@@ -190,6 +195,23 @@ pub(crate) struct RawProfile {
     pub(crate) ldflags: Option<Vec<String>>,
     #[serde(default, rename = "link-libs")]
     pub(crate) link_libs: Option<Vec<String>>,
+    /// `[profile.<name>.package.<spec>]` tables, keyed by `"*"` or
+    /// a package name.  The keys are validated by the parser.
+    #[serde(default)]
+    pub(crate) package: Option<BTreeMap<String, RawProfilePackage>>,
+}
+
+/// One `[profile.<name>.package.<spec>]` table.  Only the
+/// code-generation scalars may vary per package.
+#[derive(Debug, Deserialize)]
+#[serde(deny_unknown_fields)]
+pub(crate) struct RawProfilePackage {
+    #[serde(default, rename = "opt-level")]
+    pub(crate) opt_level: Option<cabin_core::OptLevel>,
+    #[serde(default)]
+    pub(crate) debug: Option<bool>,
+    #[serde(default)]
+    pub(crate) assertions: Option<bool>,
 }
 
 #[derive(Debug, Deserialize)]
@@ -253,6 +275,66 @@ pub(crate) struct RawTarget {
     /// `false`).
     #[serde(default, rename = "gnu-extensions")]
     pub(crate) gnu_extensions: Option<bool>,
+    /// Run-time data inputs; `test` targets only.
+    #[serde(default)]
+    pub(crate) data: Vec<Utf8PathBuf>,
+    /// In-binary test-case harness; `test` targets only.
+    #[serde(default)]
+    pub(crate) harness: Option<RawTestHarness>,
+}
+
+/// `harness` on a `test` target: a built-in harness name
+/// (`"gtest"` / `"catch2"`) or a `{ list, filter, separator }`
+/// table describing any other framework.
+#[derive(Debug)]
+pub(crate) enum RawTestHarness {
+    Named(String),
+    Custom(RawCustomTestHarness),
+}
+
+// Hand-rolled for the same reason as `RawDependency`: keep the
+// table's own `deny_unknown_fields` diagnostics.
+impl<'de> Deserialize<'de> for RawTestHarness {
+    fn deserialize<D>(deserializer: D) -> Result<Self, D::Error>
+    where
+        D: Deserializer<'de>,
+    {
+        struct RawTestHarnessVisitor;
+
+        impl<'de> Visitor<'de> for RawTestHarnessVisitor {
+            type Value = RawTestHarness;
+
+            fn expecting(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+                f.write_str("a harness name or a `{ list, filter }` table")
+            }
+
+            fn visit_str<E>(self, v: &str) -> Result<Self::Value, E>
+            where
+                E: serde::de::Error,
+            {
+                Ok(RawTestHarness::Named(v.to_owned()))
+            }
+
+            fn visit_map<M>(self, map: M) -> Result<Self::Value, M::Error>
+            where
+                M: MapAccess<'de>,
+            {
+                RawCustomTestHarness::deserialize(MapAccessDeserializer::new(map))
+                    .map(RawTestHarness::Custom)
+            }
+        }
+
+        deserializer.deserialize_any(RawTestHarnessVisitor)
+    }
+}
+
+#[derive(Debug, Deserialize)]
+#[serde(deny_unknown_fields)]
+pub(crate) struct RawCustomTestHarness {
+    pub(crate) list: Vec<String>,
+    pub(crate) filter: String,
+    #[serde(default)]
+    pub(crate) separator: Option<String>,
 }
 
 /// Cabin package dependency entry, e.g. one row of
@@ -63,7 +63,7 @@ mod tests {
     use super::*;
     use cabin_build::{BuildGraph, CompileCommand, Dialect};
     use camino::Utf8PathBuf;
-    use std::collections::BTreeSet;
+    use std::collections::{BTreeMap, BTreeSet};
 
     fn graph_with_single_compile() -> BuildGraph {
         BuildGraph {
@@ -72,6 +72,7 @@ mod tests {
             default_outputs: Vec::new(),
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
             compile_commands: vec![CompileCommand {
                 directory: Utf8PathBuf::from("/abs/build"),
@@ -121,6 +122,7 @@ mod tests {
             compile_commands: Vec::new(),
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         };
         let body = render_compile_commands(&graph).unwrap();
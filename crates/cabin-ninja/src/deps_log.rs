@@ -0,0 +1,229 @@
+//! Reader for Ninja's `.ninja_deps` log.
+//!
+//! With `deps = gcc` / `deps = msvc` Ninja folds every compile's
+//! discovered headers into one binary log and deletes the depfile, so
+//! the log is the only record of which translation unit includes which
+//! header.  `cabin tidy --changed` reads it to widen a changed-header
+//! set to the sources that include those headers, and `cabin check`
+//! to tell whether a build left an object up to date.
+//!
+//! The format is Ninja's (versions 3 and 4): a `# ninjadeps\n`
+//! signature and a 32-bit version, then length-prefixed records.  A
+//! path record interns a node name under the next id; a deps record
+//! (high bit of the length set) lists an output id, its mtime, and its
+//! input ids.  A later deps record for the same output supersedes the
+//! earlier one.  Like Ninja, the reader stops at a truncated trailing
+//! record instead of failing.
+
+use std::collections::BTreeMap;
+use std::path::{Path, PathBuf};
+
+use crate::error::NinjaError;
+
+const SIGNATURE: &[u8] = b"# ninjadeps\n";
+const DEPS_RECORD_BIT: u32 = 0x8000_0000;
+
+/// The dependency records of one `.ninja_deps` log.
+#[derive(Debug, Default)]
+pub struct DepsLog {
+    nodes: Vec<PathBuf>,
+    deps: BTreeMap<u32, Vec<u32>>,
+}
+
+impl DepsLog {
+    /// Read the log at `path`.  Relative node names are resolved
+    /// against the log's directory, which is Ninja's working
+    /// directory.  Returns `Ok(None)` when no log exists yet - no
+    /// build has run in that directory.
+    ///
+    /// # Errors
+    /// Returns [`NinjaError::Io`] when the file exists but cannot be
+    /// read, and [`NinjaError::DepsLog`] when it is not a deps log of
+    /// a version this reader understands.
+    pub fn read(path: &Path) -> Result<Option<Self>, NinjaError> {
+        let bytes = match std::fs::read(path) {
+            Ok(bytes) => bytes,
+            Err(err) if err.kind() == std::io::ErrorKind::NotFound => return Ok(None),
+            Err(source) => {
+                return Err(NinjaError::Io {
+                    path: path.to_path_buf(),
+                    source,
+                });
+            }
+        };
+        let base = path.parent().unwrap_or(Path::new(""));
+        Self::parse(&bytes, base)
+            .map(Some)
+            .map_err(|reason| NinjaError::DepsLog {
+                path: path.to_path_buf(),
+                reason,
+            })
+    }
+
+    fn parse(bytes: &[u8], base: &Path) -> Result<Self, String> {
+        let rest = bytes
+            .strip_prefix(SIGNATURE)
+            .ok_or_else(|| "missing `# ninjadeps` signature".to_owned())?;
+        let (version, mut rest) = split_u32(rest).ok_or_else(|| "missing version".to_owned())?;
+        // Version 4 widened the mtime to 64 bits and appended a
+        // checksum to path records.
+        let (mtime_words, checksummed) = match version {
+            3 => (1, false),
+            4 => (2, true),
+            other => return Err(format!("unsupported version {other}")),
+        };
+
+        let mut log = DepsLog::default();
+        while let Some((header, body)) = split_u32(rest) {
+            let size = (header & !DEPS_RECORD_BIT) as usize;
+            let Some(record) = body.get(..size) else {
+                break;
+            };
+            rest = &body[size..];
+            if header & DEPS_RECORD_BIT == 0 {
+                let name = if checksummed {
+                    &record[..size.saturating_sub(4)]
+                } else {
+                    record
+                };
+                // Names are NUL-padded to a four-byte boundary.
+                let end = name.iter().rposition(|&b| b != 0).map_or(0, |at| at + 1);
+                let name = String::from_utf8_lossy(&name[..end]);
+                log.nodes.push(base.join(name.as_ref()));
+            } else {
+                let mut words = record
+                    .chunks_exact(4)
+                    .map(|word| u32::from_le_bytes([word[0], word[1], word[2], word[3]]));
+                let Some(output) = words.next() else {
+                    continue;
+                };
+                let inputs: Vec<u32> = words.skip(mtime_words).collect();
+                log.deps.insert(output, inputs);
+            }
+        }
+        Ok(log)
+    }
+
+    /// The outputs whose recorded inputs include a path `touched`
+    /// accepts.  `touched` is asked once per distinct node, so a
+    /// caller may canonicalize inside it.  Outputs rather than
+    /// inputs are reported because only the `gcc` deps style records
+    /// the source file itself; `/showIncludes` lists headers alone.
+    pub fn outputs_touching(&self, mut touched: impl FnMut(&Path) -> bool) -> Vec<&Path> {
+        let hit: Vec<bool> = self.nodes.iter().map(|node| touched(node)).collect();
+        let is_hit = |id: &u32| hit.get(*id as usize).copied().unwrap_or(false);
+        self.deps
+            .iter()
+            .filter(|(_, inputs)| inputs.iter().any(is_hit))
+            .filter_map(|(output, _)| self.nodes.get(*output as usize))
+            .map(PathBuf::as_path)
+            .collect()
+    }
+
+    /// Every recorded output with its inputs, for a caller that looks
+    /// up many outputs: one pass over the log instead of a scan per
+    /// output.
+    #[must_use]
+    pub fn inputs_by_output(&self) -> BTreeMap<&Path, Vec<&Path>> {
+        self.deps
+            .iter()
+            .filter_map(|(output, inputs)| {
+                let output = self.nodes.get(*output as usize)?;
+                let inputs = inputs
+                    .iter()
+                    .filter_map(|id| self.nodes.get(*id as usize))
+                    .map(PathBuf::as_path)
+                    .collect();
+                Some((output.as_path(), inputs))
+            })
+            .collect()
+    }
+}
+
+fn split_u32(bytes: &[u8]) -> Option<(u32, &[u8])> {
+    let (word, rest) = bytes.split_first_chunk::<4>()?;
+    Some((u32::from_le_bytes(*word), rest))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// Encode a version-4 log: `nodes` as path records, then one deps
+    /// record per `(output, inputs)` pair.
+    fn encode(nodes: &[&str], deps: &[(u32, &[u32])]) -> Vec<u8> {
+        let mut out = SIGNATURE.to_vec();
+        out.extend(4u32.to_le_bytes());
+        for (id, node) in nodes.iter().enumerate() {
+            let mut name = node.as_bytes().to_vec();
+            name.resize(name.len().div_ceil(4) * 4, 0);
+            let size = u32::try_from(name.len() + 4).unwrap();
+            out.extend(size.to_le_bytes());
+            out.extend(name);
+            out.extend((!u32::try_from(id).unwrap()).to_le_bytes());
+        }
+        for (output, inputs) in deps {
+            let size = u32::try_from(4 * (3 + inputs.len())).unwrap();
+            out.extend((size | DEPS_RECORD_BIT).to_le_bytes());
+            out.extend(output.to_le_bytes());
+            out.extend([7u8, 0, 0, 0, 0, 0, 0, 0]);
+            for input in *inputs {
+                out.extend(input.to_le_bytes());
+            }
+        }
+        out
+    }
+
+    #[test]
+    fn finds_the_outputs_that_include_a_touched_header() {
+        let bytes = encode(
+            &[
+                "a.o",
+                "/src/a.cc",
+                "/src/util.h",
+                "b.o",
+                "/src/b.cc",
+                "/src/other.h",
+            ],
+            &[(0, &[1, 2]), (3, &[4, 5])],
+        );
+        let log = DepsLog::parse(&bytes, Path::new("/build")).unwrap();
+        // Relative names resolve against the log's directory.
+        assert_eq!(
+            log.outputs_touching(|p| p == Path::new("/src/util.h")),
+            [Path::new("/build/a.o")]
+        );
+        assert_eq!(log.outputs_touching(|p| p.starts_with("/src")).len(), 2);
+    }
+
+    #[test]
+    fn later_records_supersede_and_truncated_tails_are_ignored() {
+        let mut bytes = encode(
+            &["a.o", "/src/a.cc", "/src/old.h", "/src/new.h"],
+            &[(0, &[1, 2]), (0, &[1, 3])],
+        );
+        // Half of a further record, as an interrupted Ninja leaves it.
+        bytes.extend([40u8, 0, 0, 0, b'x']);
+        let log = DepsLog::parse(&bytes, Path::new("/build")).unwrap();
+        assert!(
+            log.outputs_touching(|p| p == Path::new("/src/old.h"))
+                .is_empty()
+        );
+        assert_eq!(
+            log.outputs_touching(|p| p == Path::new("/src/new.h")),
+            [Path::new("/build/a.o")]
+        );
+        assert_eq!(
+            log.inputs_by_output()[Path::new("/build/a.o")],
+            [Path::new("/src/a.cc"), Path::new("/src/new.h")]
+        );
+    }
+
+    #[test]
+    fn rejects_foreign_files() {
+        assert!(DepsLog::parse(b"not a deps log", Path::new("/")).is_err());
+        let mut v9 = SIGNATURE.to_vec();
+        v9.extend(9u32.to_le_bytes());
+        assert!(DepsLog::parse(&v9, Path::new("/")).is_err());
+    }
+}
@@ -3,7 +3,7 @@ use std::path::PathBuf;
 use thiserror::Error;
 
 /// Errors produced while serializing a [`cabin_build::BuildGraph`] as Ninja
-/// or as `compile_commands.json`.
+/// or as `compile_commands.json`, or while reading a `.ninja_deps` / `.ninja_log` file.
 #[derive(Debug, Error)]
 pub enum NinjaError {
     #[error("failed to write {path}: {source}", path = path.display())]
@@ -13,6 +13,14 @@ pub enum NinjaError {
         source: std::io::Error,
     },
 
+    /// A `.ninja_deps` log was present but not readable as one.
+    #[error("failed to read Ninja deps log {path}: {reason}", path = path.display())]
+    DepsLog { path: PathBuf, reason: String },
+
+    /// A `.ninja_log` was present but not readable as one.
+    #[error("failed to read Ninja log {path}: {reason}", path = path.display())]
+    NinjaLog { path: PathBuf, reason: String },
+
     #[error("failed to serialize compile_commands.json: {0}")]
     Json(#[from] serde_json::Error),
 
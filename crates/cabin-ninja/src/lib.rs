@@ -3,15 +3,25 @@
 //! This crate consumes a [`cabin_build::BuildGraph`] and writes:
 //!
 //! - `build.ninja` describing the same actions in Ninja's syntax;
+//! - a top-level file that `subninja`s several profiles' `build.ninja`
+//!   so one Ninja process builds them together;
 //! - `compile_commands.json`, the Clang JSON Compilation Database.
 //!
+//! It also reads back the `.ninja_deps` and `.ninja_log` files a
+//! previous build left, for tools that need the recorded header
+//! dependencies or action durations.
+//!
 //! Ninja-specific concerns (rule layout, escaping, depfile wiring) live
 //! here.  The build planner stays Ninja-agnostic.
 
 pub mod compile_commands;
+pub mod deps_log;
 pub mod error;
+pub mod ninja_log;
 pub mod writer;
 
 pub use compile_commands::write_compile_commands;
+pub use deps_log::DepsLog;
 pub use error::NinjaError;
-pub use writer::write_build_ninja;
+pub use ninja_log::NinjaLog;
+pub use writer::{write_build_ninja, write_multi_profile_ninja};
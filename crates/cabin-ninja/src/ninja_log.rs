@@ -0,0 +1,133 @@
+//! Reader for Ninja's `.ninja_log`.
+//!
+//! Ninja appends one line per finished edge output -
+//! `start\tend\tmtime\toutput\thash`, times in milliseconds since the
+//! build started - under a `# ninja log vN` header.  An output rebuilt
+//! several times appears several times; the last line is the current
+//! one.  `cabin build --analyze` reads the per-output durations as the
+//! cost of each planned action.
+
+use std::collections::BTreeMap;
+use std::path::{Path, PathBuf};
+use std::time::Duration;
+
+use crate::error::NinjaError;
+
+const HEADER_PREFIX: &str = "# ninja log v";
+/// Oldest layout with the five-column shape read here (Ninja 1.6).
+const MIN_VERSION: u32 = 5;
+
+/// Most recent recorded duration of every output in one `.ninja_log`.
+#[derive(Debug, Default)]
+pub struct NinjaLog {
+    durations: BTreeMap<PathBuf, Duration>,
+}
+
+impl NinjaLog {
+    /// Read the log at `path`.  Relative outputs are resolved against
+    /// the log's directory, which is Ninja's working directory.
+    /// Returns `Ok(None)` when no build has run there yet.
+    ///
+    /// # Errors
+    /// Returns [`NinjaError::Io`] when the file exists but cannot be
+    /// read, and [`NinjaError::NinjaLog`] when its header is not a
+    /// Ninja log of a version this reader understands.
+    pub fn read(path: &Path) -> Result<Option<Self>, NinjaError> {
+        let text = match std::fs::read(path) {
+            Ok(bytes) => String::from_utf8_lossy(&bytes).into_owned(),
+            Err(err) if err.kind() == std::io::ErrorKind::NotFound => return Ok(None),
+            Err(source) => {
+                return Err(NinjaError::Io {
+                    path: path.to_path_buf(),
+                    source,
+                });
+            }
+        };
+        let base = path.parent().unwrap_or(Path::new(""));
+        Self::parse(&text, base)
+            .map(Some)
+            .map_err(|reason| NinjaError::NinjaLog {
+                path: path.to_path_buf(),
+                reason,
+            })
+    }
+
+    fn parse(text: &str, base: &Path) -> Result<Self, String> {
+        let mut lines = text.lines();
+        let header = lines.next().unwrap_or_default();
+        let version: u32 = header
+            .strip_prefix(HEADER_PREFIX)
+            .and_then(|v| v.trim().parse().ok())
+            .ok_or_else(|| format!("unrecognized header {header:?}"))?;
+        if version < MIN_VERSION {
+            return Err(format!("unsupported version {version}"));
+        }
+        let mut log = NinjaLog::default();
+        for line in lines {
+            // Ninja skips lines it cannot parse (an interrupted
+            // append leaves a partial one); so does this reader.
+            let mut fields = line.split('\t');
+            let (Some(start), Some(end), Some(_mtime), Some(output)) =
+                (fields.next(), fields.next(), fields.next(), fields.next())
+            else {
+                continue;
+            };
+            let (Ok(start), Ok(end)) = (start.parse::<u64>(), end.parse::<u64>()) else {
+                continue;
+            };
+            log.durations.insert(
+                base.join(output),
+                Duration::from_millis(end.saturating_sub(start)),
+            );
+        }
+        Ok(log)
+    }
+
+    /// The last recorded duration of the edge that wrote `output`.
+    #[must_use]
+    pub fn duration(&self, output: &Path) -> Option<Duration> {
+        self.durations.get(output).copied()
+    }
+
+    /// Whether the log records no output at all.
+    #[must_use]
+    pub fn is_empty(&self) -> bool {
+        self.durations.is_empty()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn last_entry_per_output_wins_and_relative_outputs_resolve() {
+        let text = "# ninja log v6\n\
+                    0\t120\t1\t/b/a.o\tdeadbeef\n\
+                    5\t45\t1\tapp\tfeedface\n\
+                    200\t230\t2\t/b/a.o\tdeadbeef\n\
+                    garbage line\n\
+                    7\t";
+        let log = NinjaLog::parse(text, Path::new("/b")).unwrap();
+        assert_eq!(
+            log.duration(Path::new("/b/a.o")),
+            Some(Duration::from_millis(30))
+        );
+        assert_eq!(
+            log.duration(Path::new("/b/app")),
+            Some(Duration::from_millis(40))
+        );
+        assert_eq!(log.duration(Path::new("/b/missing.o")), None);
+    }
+
+    #[test]
+    fn rejects_foreign_and_ancient_logs() {
+        assert!(NinjaLog::parse("not a log\n", Path::new("/")).is_err());
+        assert!(NinjaLog::parse("# ninja log v4\n", Path::new("/")).is_err());
+        assert!(
+            NinjaLog::parse("# ninja log v5\n", Path::new("/"))
+                .unwrap()
+                .is_empty()
+        );
+    }
+}
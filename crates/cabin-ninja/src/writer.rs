@@ -1,5 +1,5 @@
 use std::fmt::Write as _;
-use std::path::Path;
+use std::path::{Path, PathBuf};
 
 use cabin_build::BuildGraph;
 use cabin_driver::{Dialect, LoweredAction, LoweredActionKind, NinjaDeps, lower};
@@ -34,6 +34,44 @@ pub fn write_build_ninja(
     atomically_write(path, body.as_bytes())
 }
 
+/// Write a top-level Ninja file to `path` that `subninja`s every
+/// per-profile `build.ninja` in `profile_files`, so one Ninja
+/// process schedules all profiles' actions under a single `-j`.
+///
+/// Each profile file keeps its own rules (a `subninja` opens a new
+/// rule scope) and `default` targets; every planner-emitted path is
+/// absolute, so the combined file can live anywhere.
+///
+/// # Errors
+/// Propagates rendering failures from [`render_multi_profile_ninja`]
+/// and returns [`NinjaError::Io`] when the atomic write fails.
+pub fn write_multi_profile_ninja(path: &Path, profile_files: &[PathBuf]) -> Result<(), NinjaError> {
+    let body = render_multi_profile_ninja(profile_files)?;
+    atomically_write(path, body.as_bytes())
+}
+
+/// Render the combined multi-profile Ninja file written by
+/// [`write_multi_profile_ninja`].
+///
+/// # Errors
+/// Returns [`NinjaError::NonUtf8Path`] when a profile file path is not
+/// UTF-8 and [`NinjaError::PathHasNewline`] when it contains a newline
+/// or carriage return.
+pub fn render_multi_profile_ninja(profile_files: &[PathBuf]) -> Result<String, NinjaError> {
+    let mut out = String::new();
+    out.push_str("# Generated by cabin. Do not edit by hand.\n");
+    out.push_str("ninja_required_version = 1.10\n\n");
+    for file in profile_files {
+        let file_str = file
+            .to_str()
+            .ok_or_else(|| NinjaError::NonUtf8Path(file.clone()))?;
+        out.push_str("subninja ");
+        out.push_str(&escape_path(file_str)?);
+        out.push('\n');
+    }
+    Ok(out)
+}
+
 /// Atomically replace `path` with `body`, tagging any IO error
 /// with `path` so callers can point users at the destination
 /// that failed.
@@ -103,12 +141,19 @@ pub fn render_build_ninja(
     out.push_str(&deps);
     out.push_str("  description = $description\n\n");
 
+    // Archive and link edges whose input list outgrew
+    // `RESPONSE_FILE_THRESHOLD` bind `rspfile` / `rspfile_content`;
+    // Ninja writes the file before the command runs.  On every other
+    // edge both expand empty and no file is written.  Ninja folds the
+    // content into the command hash, so an edited list still relinks.
     out.push_str("rule cxx_archive\n");
     out.push_str("  command = $command\n");
+    out.push_str(RSPFILE_LINES);
     out.push_str("  description = $description\n\n");
 
     out.push_str("rule link_executable\n");
     out.push_str("  command = $command\n");
+    out.push_str(RSPFILE_LINES);
     out.push_str("  description = $description\n\n");
 
     for action in &graph.actions {
@@ -128,6 +173,9 @@ pub fn render_build_ninja(
     Ok(out)
 }
 
+/// Rule lines forwarding an edge's response file, if it binds one.
+const RSPFILE_LINES: &str = "  rspfile = $rspfile\n  rspfile_content = $rspfile_content\n";
+
 /// The `depfile` / `deps` (and, for MSVC, `msvc_deps_prefix`) lines a
 /// compile or check rule needs for header-dependency discovery in
 /// `dialect`.  Returned with trailing newlines, ready to splice into a
@@ -221,6 +269,10 @@ fn write_edge(out: &mut String, action: &LoweredAction) -> Result<(), NinjaError
     if let Some(depfile) = &action.depfile {
         write_var(out, "depfile", depfile.as_str())?;
     }
+    if let Some(rspfile) = &action.rspfile {
+        write_var(out, "rspfile", rspfile.path.as_str())?;
+        write_var(out, "rspfile_content", &rspfile.content)?;
+    }
     write_var(out, "description", &action.description)?;
     out.push('\n');
 
@@ -386,12 +438,12 @@ fn windows_quote_arg(arg: &str, out: &mut String) {
 mod tests {
     use super::*;
     use cabin_build::{
-        ArchiveAction, BuildAction, BuildGraph, CompileAction, CompileArguments, CompileCommand,
-        CompileMode, LinkAction,
+        ArchiveAction, ArchiveResponseFile, BuildAction, BuildGraph, CompileAction,
+        CompileArguments, CompileCommand, CompileMode, LinkAction,
     };
-    use cabin_core::OptLevel;
+    use cabin_core::{OptLevel, TargetArch};
     use camino::Utf8PathBuf;
-    use std::collections::BTreeSet;
+    use std::collections::{BTreeMap, BTreeSet};
 
     // These fixtures are *semantic* actions; the writer lowers them to
     // concrete commands as it renders, so the assertions below check
@@ -412,6 +464,8 @@ mod tests {
                 opt_level: OptLevel::O0,
                 debug_info: false,
                 define_ndebug: false,
+                target_cpu: None,
+                target_arch: TargetArch::X86_64,
                 include_dirs: vec![],
                 system_include_dirs: vec![],
                 defines: vec![],
@@ -437,6 +491,8 @@ mod tests {
             archiver: Utf8PathBuf::from("/usr/bin/ar"),
             output: Utf8PathBuf::from("/abs/build/libfoo.a"),
             inputs: vec![Utf8PathBuf::from("/abs/build/main.o")],
+            thin: false,
+            response_file: ArchiveResponseFile::Unsupported,
             description: "AR /abs/build/libfoo.a".into(),
         })
     }
@@ -449,6 +505,7 @@ mod tests {
             implicit_inputs: vec![],
             arguments: vec![],
             link_libs: vec![],
+            map_file: None,
             description: "LINK /abs/build/hello".into(),
         })
     }
@@ -470,6 +527,8 @@ mod tests {
                 opt_level: OptLevel::O0,
                 debug_info: false,
                 define_ndebug: false,
+                target_cpu: None,
+                target_arch: TargetArch::X86_64,
                 include_dirs: vec![],
                 system_include_dirs: vec![],
                 defines: vec![],
@@ -487,6 +546,7 @@ mod tests {
             compile_commands: Vec::<CompileCommand>::new(),
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         }
     }
@@ -516,6 +576,27 @@ mod tests {
         assert!(body.contains("rule link_executable"));
     }
 
+    #[test]
+    fn multi_profile_file_subninjas_each_profile_in_order() {
+        let body = render_multi_profile_ninja(&[
+            PathBuf::from("/abs/build/dev/build.ninja"),
+            PathBuf::from("/abs/my build/release/build.ninja"),
+        ])
+        .unwrap();
+        assert!(body.starts_with("# Generated by cabin."));
+        let subninjas: Vec<&str> = body
+            .lines()
+            .filter(|line| line.starts_with("subninja "))
+            .collect();
+        assert_eq!(
+            subninjas,
+            vec![
+                "subninja /abs/build/dev/build.ninja",
+                "subninja /abs/my$ build/release/build.ninja",
+            ]
+        );
+    }
+
     #[test]
     fn includes_default_targets() {
         let body = render(&graph_with(
@@ -543,6 +624,7 @@ mod tests {
             compile_commands: Vec::<CompileCommand>::new(),
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         }
     }
@@ -612,6 +694,30 @@ mod tests {
         assert!(body.contains("build /abs/build/libfoo.a: cxx_archive /abs/build/main.o"));
     }
 
+    #[test]
+    fn long_archive_edge_binds_a_response_file() {
+        let BuildAction::Archive(mut archive) = archive_action() else {
+            unreachable!("archive_action builds an archive");
+        };
+        archive.response_file = ArchiveResponseFile::Dialect;
+        archive.inputs = (0..1000)
+            .map(|i| Utf8PathBuf::from(format!("/abs/build/obj_{i}.o")))
+            .collect();
+        let body = render(&graph_with(vec![BuildAction::Archive(archive)], vec![])).unwrap();
+        assert!(body.contains("  rspfile = $rspfile\n  rspfile_content = $rspfile_content\n"));
+        assert!(
+            body.contains(
+                "command = /usr/bin/ar crs /abs/build/libfoo.a @/abs/build/libfoo.a.rsp\n"
+            )
+        );
+        assert!(body.contains("  rspfile = /abs/build/libfoo.a.rsp\n"));
+        assert!(body.contains("  rspfile_content = /abs/build/obj_0.o /abs/build/obj_1.o "));
+
+        // A short list leaves both variables unbound on the edge.
+        let short = render(&graph_with(vec![archive_action()], vec![])).unwrap();
+        assert!(!short.contains("  rspfile = /"));
+    }
+
     #[test]
     fn renders_syntax_check_rule_and_edge() {
         let body = render(&graph_with(vec![syntax_check_action()], vec![])).unwrap();
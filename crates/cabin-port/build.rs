@@ -7,12 +7,21 @@
 //! edits to `src/builtin.rs` are required.  The generated table is
 //! written to `$OUT_DIR/builtin_generated.rs` and `include!`d by
 //! `src/builtin.rs`.
+//!
+//! `port.toml` is parsed here, not at run time: each entry carries its
+//! recipe fields and its parsed `SemVer` version as typed constants,
+//! so looking a port up never touches TOML.  Only the overlay
+//! `cabin.toml` is embedded as text, for the step that writes it into
+//! the prepared source tree.
 
 use std::env;
 use std::fmt::Write as _;
 use std::fs;
 use std::path::{Path, PathBuf};
 
+use semver::Version;
+use toml::{Table, Value};
+
 fn main() {
     // cabinpkg-port embeds the foundation-port recipes from the
     // crate-local `ports/` directory.  The recipes are committed here as
@@ -60,35 +69,203 @@ fn main() {
 
             println!("cargo:rerun-if-changed={}", port_toml.display());
             println!("cargo:rerun-if-changed={}", overlay_toml.display());
-            entries.push((name.clone(), version, port_toml, overlay_toml));
+            let text = fs::read_to_string(&port_toml)
+                .unwrap_or_else(|err| panic!("read {}: {err}", port_toml.display()));
+            let recipe = Recipe::parse(&text, &port_toml);
+            assert!(
+                recipe.name == name && recipe.version.to_string() == version,
+                "{}: [port] declares {} {} but the recipe lives in ports/{name}/{version}/",
+                port_toml.display(),
+                recipe.name,
+                recipe.version,
+            );
+            entries.push((recipe, overlay_toml));
         }
     }
 
-    // Deterministic order so `iter()` is stable across builds.
-    entries.sort_by(|a, b| a.0.cmp(&b.0).then_with(|| a.1.cmp(&b.1)));
+    // Sorted by `(name, version)`: `iter()` is stable across builds,
+    // and `lookup` binary-searches the name and walks its versions
+    // from the highest down.
+    entries.sort_by(|(a, _), (b, _)| a.name.cmp(&b.name).then_with(|| a.version.cmp(&b.version)));
 
     let mut out = String::new();
     out.push_str("// @generated by build.rs from the ports/ directory. Do not edit.\n");
-    out.push_str("const BUILTIN: &[BuiltinPort] = &[\n");
-    for (name, version, port_toml, overlay_toml) in &entries {
+    out.push_str("static BUILTIN: &[BuiltinPort] = &[\n");
+    for (recipe, overlay_toml) in &entries {
+        recipe.write_entry(&mut out, overlay_toml);
+    }
+    out.push_str("];\n");
+
+    let out_path = PathBuf::from(env::var("OUT_DIR").unwrap()).join("builtin_generated.rs");
+    fs::write(&out_path, out).expect("write generated builtin table");
+}
+
+/// The `port.toml` fields of one recipe.  Shape checks mirror the
+/// runtime parser's serde structs (unknown keys and wrong types are
+/// rejected); value checks - URLs, checksums, safe paths - stay in
+/// `src/parse.rs`, which validates every entry on use.
+struct Recipe {
+    name: String,
+    version: Version,
+    description: Option<String>,
+    license: Option<String>,
+    homepage: Option<String>,
+    upstream: Option<String>,
+    source_type: String,
+    url: Option<String>,
+    sha256: Option<String>,
+    strip_prefix: Option<String>,
+    overlay_manifest: String,
+    copies: Vec<(String, String)>,
+}
+
+impl Recipe {
+    fn parse(text: &str, path: &Path) -> Self {
+        let doc: Table = text
+            .parse()
+            .unwrap_or_else(|err| fail(path, &format!("{err}")));
+        let root = Fields::new(path, &doc, "", &["port", "source", "overlay", "copy"]);
+        let port = root.table(
+            "port",
+            &[
+                "name",
+                "version",
+                "description",
+                "license",
+                "homepage",
+                "upstream",
+            ],
+        );
+        let source = root.table("source", &["type", "url", "sha256", "strip_prefix"]);
+        let overlay = root.table("overlay", &["manifest"]);
+
+        let version = port.string("version");
+        let version = Version::parse(&version)
+            .unwrap_or_else(|err| fail(path, &format!("[port].version `{version}`: {err}")));
+        if !version.pre.is_empty() || !version.build.is_empty() {
+            fail(
+                path,
+                "bundled port versions must be plain MAJOR.MINOR.PATCH",
+            );
+        }
+        let copies = match doc.get("copy") {
+            None => Vec::new(),
+            Some(Value::Array(steps)) => steps
+                .iter()
+                .map(|step| {
+                    let Value::Table(step) = step else {
+                        fail(path, "[[copy]] entries must be tables");
+                    };
+                    let step = Fields::new(path, step, "copy", &["from", "to"]);
+                    (step.string("from"), step.string("to"))
+                })
+                .collect(),
+            Some(_) => fail(path, "`copy` must be an array of tables"),
+        };
+        Self {
+            name: port.string("name"),
+            version,
+            description: port.optional("description"),
+            license: port.optional("license"),
+            homepage: port.optional("homepage"),
+            upstream: port.optional("upstream"),
+            source_type: source.string("type"),
+            url: source.optional("url"),
+            sha256: source.optional("sha256"),
+            strip_prefix: source.optional("strip_prefix"),
+            overlay_manifest: overlay.string("manifest"),
+            copies,
+        }
+    }
+
+    /// Append this recipe's `BuiltinPort { .. }` literal to `out`.
+    /// `{:?}` renders every string as a valid Rust string literal.
+    fn write_entry(&self, out: &mut String, overlay_toml: &Path) {
+        let mut copies = String::new();
+        for (from, to) in &self.copies {
+            write!(copies, "BuiltinCopy {{ from: {from:?}, to: {to:?} }}, ").unwrap();
+        }
         write!(
             out,
             "    BuiltinPort {{\n        \
-             name: \"{name}\",\n        \
+             name: {name:?},\n        \
              version: \"{version}\",\n        \
-             port_toml: include_str!(\"{port}\"),\n        \
+             parsed_version: Version::new({major}, {minor}, {patch}),\n        \
+             recipe: BuiltinRecipe {{\n            \
+             description: {description:?},\n            \
+             license: {license:?},\n            \
+             homepage: {homepage:?},\n            \
+             upstream: {upstream:?},\n            \
+             source_type: {source_type:?},\n            \
+             url: {url:?},\n            \
+             sha256: {sha256:?},\n            \
+             strip_prefix: {strip_prefix:?},\n            \
+             overlay_manifest: {overlay_manifest:?},\n            \
+             copies: &[{copies}],\n        }},\n        \
              overlay_toml: include_str!(\"{overlay}\"),\n    }},\n",
-            name = escape(name),
-            version = escape(version),
-            port = escape(&port_toml.to_string_lossy()),
+            name = self.name,
+            version = self.version,
+            major = self.version.major,
+            minor = self.version.minor,
+            patch = self.version.patch,
+            description = self.description,
+            license = self.license,
+            homepage = self.homepage,
+            upstream = self.upstream,
+            source_type = self.source_type,
+            url = self.url,
+            sha256 = self.sha256,
+            strip_prefix = self.strip_prefix,
+            overlay_manifest = self.overlay_manifest,
             overlay = escape(&overlay_toml.to_string_lossy()),
         )
         .unwrap();
     }
-    out.push_str("];\n");
+}
 
-    let out_path = PathBuf::from(env::var("OUT_DIR").unwrap()).join("builtin_generated.rs");
-    fs::write(&out_path, out).expect("write generated builtin table");
+/// One `port.toml` table whose keys were checked against the
+/// fields the runtime parser accepts.
+struct Fields<'a> {
+    path: &'a Path,
+    table: &'a Table,
+    name: &'a str,
+}
+
+impl<'a> Fields<'a> {
+    fn new(path: &'a Path, table: &'a Table, name: &'a str, allowed: &[&str]) -> Self {
+        if let Some(key) = table.keys().find(|key| !allowed.contains(&key.as_str())) {
+            fail(path, &format!("unknown key `{key}` in [{name}]"));
+        }
+        Self { path, table, name }
+    }
+
+    fn table(&self, key: &'a str, allowed: &[&str]) -> Fields<'a> {
+        match self.table.get(key) {
+            Some(Value::Table(table)) => Fields::new(self.path, table, key, allowed),
+            Some(_) => fail(self.path, &format!("`{key}` must be a table")),
+            None => fail(self.path, &format!("missing [{key}] table")),
+        }
+    }
+
+    fn optional(&self, key: &str) -> Option<String> {
+        match self.table.get(key) {
+            None => None,
+            Some(Value::String(value)) => Some(value.clone()),
+            Some(_) => fail(
+                self.path,
+                &format!("[{}].{key} must be a string", self.name),
+            ),
+        }
+    }
+
+    fn string(&self, key: &str) -> String {
+        self.optional(key)
+            .unwrap_or_else(|| fail(self.path, &format!("missing [{}].{key}", self.name)))
+    }
+}
+
+fn fail(path: &Path, message: &str) -> ! {
+    panic!("invalid foundation port {}: {message}", path.display())
 }
 
 /// Immediate child directories of `dir`, sorted by path.  Returns an
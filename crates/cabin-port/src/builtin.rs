@@ -1,59 +1,115 @@
 //! Foundation-port recipes shipped inside the cabin binary.
 //!
 //! The `BUILTIN` table is generated at compile time by `build.rs`,
-//! which scans the repository's `ports/` directory and embeds the
-//! `port.toml` and overlay `cabin.toml` of every
-//! `ports/<name>/<version>/` recipe via `include_str!`.  Adding or
-//! removing a recipe directory therefore bundles or retires that
-//! port automatically - there is nothing to edit in this file.
+//! which scans the repository's `ports/` directory, parses the
+//! `port.toml` of every `ports/<name>/<version>/` recipe into a typed
+//! [`BuiltinRecipe`], and embeds the overlay `cabin.toml` via
+//! `include_str!`.  Adding or removing a recipe directory therefore
+//! bundles or retires that port automatically - there is nothing to
+//! edit in this file.
 //!
-//! The on-disk recipe stays the source of truth: the embedded text
-//! uses `include_str!` for the same files, and each entry's `name`
-//! and `version` come from the `<name>`/`<version>` directory names.
-//! The module maintains a triple-source-of-truth invariant: for every
-//! entry the on-disk directory names, the `BuiltinPort` fields, and
-//! the `[port].name`/`[port].version` parsed from the embedded
-//! `port.toml` must all agree.  A unit test
-//! (`dir_name_matches_port_toml_and_builtin_fields`) asserts this so
-//! the sources cannot drift.
+//! Nothing here parses TOML at run time: lookups compare the
+//! pre-parsed [`BuiltinPort::parsed_version`], and
+//! [`BuiltinPort::descriptor`] validates the pre-parsed fields
+//! through the same checks as [`crate::parse_port_str`].  The overlay
+//! text is only read when a port is materialized.
+//!
+//! The on-disk recipe stays the source of truth.  `build.rs` refuses
+//! a recipe whose `[port].name`/`[port].version` disagree with its
+//! `<name>`/`<version>` directory names, and a unit test
+//! (`dir_name_matches_port_toml_and_builtin_fields`) asserts that
+//! every entry's descriptor equals the one parsed from the on-disk
+//! `port.toml`, so the sources cannot drift.
+
+use std::path::Path;
 
 use semver::{Version, VersionReq};
 
+use crate::error::PortError;
+use crate::model::PortDescriptor;
+
 /// One bundled foundation-port recipe.
-#[derive(Debug, Clone, Copy)]
+#[derive(Debug, Clone)]
 pub struct BuiltinPort {
     /// Package name the recipe identifies.  Matches the
-    /// `[port].name` in the embedded `port.toml`.  Used as the
-    /// lookup key in `lookup`.
+    /// `[port].name` in `ports/<name>/<version>/port.toml`.  Used as
+    /// the lookup key in `lookup`.
     pub name: &'static str,
     /// `SemVer` version string.  Equal to the parent directory of
-    /// the embedded recipe (e.g. `ports/<name>/<version>/`) and
-    /// to `port_toml`'s `[port].version`.  Pinned by a unit test
-    /// in this module so the three sources of truth can't drift.
+    /// the recipe (e.g. `ports/<name>/<version>/`) and to its
+    /// `[port].version`.
     pub version: &'static str,
-    /// Embedded contents of `ports/<name>/<version>/port.toml`.
-    pub port_toml: &'static str,
+    /// `version`, parsed by `build.rs`.
+    pub parsed_version: Version,
+    /// The remaining `port.toml` fields.
+    pub recipe: BuiltinRecipe,
     /// Embedded contents of `ports/<name>/<version>/cabin.toml` (overlay).
     pub overlay_toml: &'static str,
 }
 
+/// `port.toml` fields of a bundled recipe, extracted by `build.rs`
+/// and not yet validated.  Mirrors the file's layout; see
+/// [`crate::parse_port_str`] for the meaning of each field.
+#[derive(Debug, Clone, Copy)]
+pub struct BuiltinRecipe {
+    pub description: Option<&'static str>,
+    pub license: Option<&'static str>,
+    pub homepage: Option<&'static str>,
+    pub upstream: Option<&'static str>,
+    /// `[source].type`.
+    pub source_type: &'static str,
+    pub url: Option<&'static str>,
+    pub sha256: Option<&'static str>,
+    pub strip_prefix: Option<&'static str>,
+    /// `[overlay].manifest`.
+    pub overlay_manifest: &'static str,
+    /// `[[copy]]` steps, in declaration order.
+    pub copies: &'static [BuiltinCopy],
+}
+
+/// One `[[copy]]` step of a bundled recipe.
+#[derive(Debug, Clone, Copy)]
+pub struct BuiltinCopy {
+    pub from: &'static str,
+    pub to: &'static str,
+}
+
+impl BuiltinPort {
+    /// The recipe as a [`PortDescriptor`], validated exactly as the
+    /// on-disk `port.toml` would be by [`crate::parse_port_str`].
+    ///
+    /// # Errors
+    /// Returns the [`PortError`] `parse_port_str` would return for
+    /// the same fields; diagnostics name `<builtin:NAME>/port.toml`.
+    pub fn descriptor(&self) -> Result<PortDescriptor, PortError> {
+        let path = format!("<builtin:{}>/port.toml", self.name);
+        crate::parse::descriptor_from_builtin(self, Path::new(&path))
+    }
+}
+
 // Curated set of recipes embedded in the `cabin` binary, generated at
 // compile time from the `ports/` directory by `build.rs` and sorted by
-// `(name, version)` so `iter()` is deterministic.  Defines
-// `const BUILTIN: &[BuiltinPort]`.
+// `(name, version)` so `iter()` is deterministic and every name's
+// versions form one ascending run.  Defines
+// `static BUILTIN: &[BuiltinPort]`.
 include!(concat!(env!("OUT_DIR"), "/builtin_generated.rs"));
 
+/// Every bundled version of `name`, lowest first.  Empty when `name`
+/// is not bundled.
+pub fn versions(name: &str) -> &'static [BuiltinPort] {
+    let start = BUILTIN.partition_point(|p| p.name < name);
+    let len = BUILTIN[start..].partition_point(|p| p.name == name);
+    &BUILTIN[start..start + len]
+}
+
 /// Resolve a bundled recipe by name + version requirement.
-/// Returns the highest-versioned entry whose `version` parses
-/// and satisfies `req`.  Returns `None` when no entry matches.
+/// Returns the highest-versioned entry whose version satisfies
+/// `req`.  Returns `None` when no entry matches.
 pub fn lookup(name: &str, req: &VersionReq) -> Option<&'static BuiltinPort> {
-    BUILTIN
+    versions(name)
         .iter()
-        .filter(|p| p.name == name)
-        .filter_map(|p| Version::parse(p.version).ok().map(|v| (p, v)))
-        .filter(|(_, v)| req.matches(v))
-        .max_by(|(_, a), (_, b)| a.cmp(b))
-        .map(|(p, _)| p)
+        .rev()
+        .find(|p| req.matches(&p.parsed_version))
 }
 
 /// Iterate the bundled recipes in `name` order.
@@ -106,31 +162,45 @@ mod tests {
     }
 
     #[test]
-    fn embedded_port_toml_parses() {
+    fn builtin_descriptor_validates() {
         let entry = lookup("zlib", &any()).unwrap();
-        let descriptor =
-            crate::parse_port_str(entry.port_toml, Path::new("<builtin:zlib>/port.toml"))
-                .expect("embedded port.toml parses");
+        let descriptor = entry.descriptor().expect("bundled zlib recipe validates");
         assert_eq!(descriptor.name.as_str(), "zlib");
         assert_eq!(descriptor.version.to_string(), "1.3.1");
     }
 
+    #[test]
+    fn versions_are_a_sorted_run_per_name() {
+        assert!(versions("zilb").is_empty());
+        for entry in iter() {
+            let run = versions(entry.name);
+            assert!(run.iter().all(|p| p.name == entry.name));
+            assert!(
+                run.windows(2)
+                    .all(|pair| pair[0].parsed_version < pair[1].parsed_version)
+            );
+            assert_eq!(entry.parsed_version.to_string(), entry.version);
+        }
+    }
+
     #[test]
     fn dir_name_matches_port_toml_and_builtin_fields() {
         // Triple-source invariant: every BUILTIN entry's name/version must
         // equal both the on-disk directory names AND the [port].name /
-        // [port].version parsed out of the embedded port.toml.
+        // [port].version parsed out of the on-disk port.toml, and the
+        // fields build.rs extracted must describe the same recipe.
         let ports = ports_dir();
         for entry in iter() {
             let port_toml_path = ports.join(entry.name).join(entry.version).join("port.toml");
-            let port_toml_on_disk = std::fs::read_to_string(&port_toml_path)
+            let descriptor = crate::load_port(&port_toml_path)
                 .unwrap_or_else(|e| panic!("missing recipe at {port_toml_path:?}: {e}"));
             assert_eq!(
-                entry.port_toml, port_toml_on_disk,
-                "embedded port.toml drifted from on-disk for {} {}",
-                entry.name, entry.version
+                entry.descriptor().unwrap(),
+                descriptor,
+                "pre-parsed recipe drifted from on-disk port.toml for {} {}",
+                entry.name,
+                entry.version
             );
-            let descriptor = crate::parse_port_str(entry.port_toml, &port_toml_path).unwrap();
             assert_eq!(
                 descriptor.name.as_str(),
                 entry.name,
@@ -12,6 +12,7 @@ use semver::Version;
 use serde::Deserialize;
 use url::Url;
 
+use crate::builtin::BuiltinPort;
 use crate::error::PortError;
 use crate::model::{
     ArchiveSource, CopyStep, OverlayManifest, PortChecksum, PortDescriptor, PortMetadata,
@@ -103,6 +104,51 @@ pub fn parse_port_str(text: &str, path: &Path) -> Result<PortDescriptor, PortErr
         path: path.to_path_buf(),
         source,
     })?;
+    descriptor_from_raw(raw, path)
+}
+
+/// Validate a bundled recipe's pre-parsed fields.  `build.rs` has
+/// already checked the TOML shape, so this runs the same value checks
+/// as [`parse_port_str`] without re-reading any TOML.
+pub(crate) fn descriptor_from_builtin(
+    port: &BuiltinPort,
+    path: &Path,
+) -> Result<PortDescriptor, PortError> {
+    let owned = |value: Option<&str>| value.map(str::to_owned);
+    let recipe = &port.recipe;
+    descriptor_from_raw(
+        RawPort {
+            port: RawPortIdentity {
+                name: port.name.to_owned(),
+                version: port.version.to_owned(),
+                description: owned(recipe.description),
+                license: owned(recipe.license),
+                homepage: owned(recipe.homepage),
+                upstream: owned(recipe.upstream),
+            },
+            source: RawSource {
+                kind: recipe.source_type.to_owned(),
+                url: owned(recipe.url),
+                sha256: owned(recipe.sha256),
+                strip_prefix: owned(recipe.strip_prefix),
+            },
+            overlay: RawOverlay {
+                manifest: recipe.overlay_manifest.to_owned(),
+            },
+            copy: recipe
+                .copies
+                .iter()
+                .map(|step| RawCopy {
+                    from: step.from.to_owned(),
+                    to: step.to.to_owned(),
+                })
+                .collect(),
+        },
+        path,
+    )
+}
+
+fn descriptor_from_raw(raw: RawPort, path: &Path) -> Result<PortDescriptor, PortError> {
     let RawPort {
         port,
         source,
@@ -90,6 +90,19 @@ pub fn render(index: &PackageIndex, path: &Path) -> Result<String, RegistryError
     Ok(body)
 }
 
+/// Gzip-compress a rendered index document for its precompressed
+/// `.json.gz` sibling.  The gzip header carries no file name and a
+/// zero mtime, so the bytes depend only on `body`.
+pub(crate) fn compress(body: &str) -> Vec<u8> {
+    use std::io::Write;
+    let mut encoder = flate2::write::GzEncoder::new(Vec::new(), flate2::Compression::best());
+    // Writing into a `Vec` cannot fail.
+    encoder
+        .write_all(body.as_bytes())
+        .expect("in-memory gzip write");
+    encoder.finish().expect("in-memory gzip finish")
+}
+
 /// Read the already-published versions and their declared
 /// standard-compatibility tables for `name` from the file registry at
 /// `registry_dir` - the PL3 publish-lint baseline.
@@ -213,6 +213,18 @@ impl FileRegistry {
         path.join(format!("{}.json", name.base_name()))
     }
 
+    /// Absolute path of the precompressed sibling of
+    /// [`FileRegistry::package_index_path`]: the same document,
+    /// gzip-compressed, as `<name>.json.gz`.  Static hosts configured
+    /// to serve precompressed files (nginx `gzip_static`, Caddy
+    /// `precompressed gzip`) answer a gzip-accepting client with it;
+    /// the local loader only reads `.json` files and ignores it.
+    pub fn compressed_package_index_path(&self, name: &PackageName) -> PathBuf {
+        let mut path = self.package_index_path(name).into_os_string();
+        path.push(".gz");
+        PathBuf::from(path)
+    }
+
     /// Absolute path of the per-package artifact directory for
     /// `name`.
     pub fn artifact_dir_for(&self, name: &PackageName) -> PathBuf {
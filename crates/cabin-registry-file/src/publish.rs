@@ -5,7 +5,7 @@ use cabin_package::{PackageMetadata, StagedPackage};
 
 use crate::atomic::atomically_write;
 use crate::error::RegistryError;
-use crate::index::{insert_version, read_optional, render};
+use crate::index::{compress, insert_version, read_optional, render};
 use crate::layout::FileRegistry;
 use crate::lock::RegistryLock;
 
@@ -152,14 +152,20 @@ fn publish_locked(
 
     // Phase 2: update the index.  If anything goes wrong, undo the
     // artifact placement so the registry never carries an orphaned
-    // file.
+    // file.  The precompressed `.json.gz` sibling lands first: should
+    // the `.json` write then fail, the sibling is removed again so a
+    // static host never serves a document the plain file disagrees
+    // with (without the sibling it falls back to the `.json`).
+    let compressed_path = registry.compressed_package_index_path(&request.staged.name);
     let write_index = || -> Result<(), RegistryError> {
         let existing = read_optional(&plan.package_index_path)?;
         let new_index = insert_version(existing, &metadata)?;
         let body = render(&new_index, &plan.package_index_path)?;
+        atomically_write(&compressed_path, &compress(&body))?;
         atomically_write(&plan.package_index_path, body.as_bytes())
     };
     if let Err(err) = write_index() {
+        let _ = fs::remove_file(&compressed_path);
         // If the rollback itself fails the registry is left with an
         // orphaned artifact; surface that now (with the remedy)
         // instead of letting the *next* publish fail with a bare
@@ -335,6 +341,19 @@ mod tests {
         assert!(outcome.registry_initialized);
         assert!(outcome.artifact_path.is_file());
         assert!(outcome.package_index_path.is_file());
+        // The precompressed sibling inflates to the plain document.
+        let mut compressed = outcome.package_index_path.clone().into_os_string();
+        compressed.push(".gz");
+        let mut inflated = String::new();
+        std::io::Read::read_to_string(
+            &mut flate2::read::GzDecoder::new(std::fs::File::open(compressed).unwrap()),
+            &mut inflated,
+        )
+        .unwrap();
+        assert_eq!(
+            inflated,
+            std::fs::read_to_string(&outcome.package_index_path).unwrap()
+        );
         // Lock file removed on success.
         registry_dir
             .child(".cabin-registry.lock")
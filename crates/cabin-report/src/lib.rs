@@ -0,0 +1,185 @@
+//! Versioned JSON reports and named baselines.
+//!
+//! `cabin bench` and `cabin bloat` both keep the report of their
+//! last run (`latest.json`) and any number of named baselines
+//! (`baselines/<name>.json`) under a per-command directory, and
+//! compare a new run against one of them.  This crate owns that
+//! storage: baseline-name validation, the `version` field every
+//! stored report carries, and atomic writes.  What a report holds,
+//! and how two of them compare, stays with the command's crate.
+
+use std::fs;
+use std::io;
+use std::path::{Path, PathBuf};
+
+use serde::de::DeserializeOwned;
+use serde::{Deserialize, Serialize};
+use thiserror::Error;
+
+/// Path of the stored baseline `name` under `dir`.
+///
+/// # Errors
+/// Returns [`ReportError::InvalidBaselineName`] unless `name` is a
+/// non-empty run of ASCII letters, digits, `-`, `_` and `.` that
+/// does not start with `.`, so it always names a file directly
+/// inside `<dir>/baselines`.
+pub fn baseline_path(dir: &Path, name: &str) -> Result<PathBuf, ReportError> {
+    let valid = !name.is_empty()
+        && !name.starts_with('.')
+        && name
+            .chars()
+            .all(|c| c.is_ascii_alphanumeric() || matches!(c, '-' | '_' | '.'));
+    if !valid {
+        return Err(ReportError::InvalidBaselineName {
+            name: name.to_owned(),
+        });
+    }
+    Ok(dir.join("baselines").join(format!("{name}.json")))
+}
+
+/// On-disk form of a report: its layout `version` beside the
+/// report's own fields.
+#[derive(Serialize)]
+struct Stored<'a, T> {
+    version: u32,
+    #[serde(flatten)]
+    report: &'a T,
+}
+
+#[derive(Deserialize)]
+struct StoredVersion {
+    version: u32,
+}
+
+/// Write `report` to `path` as JSON tagged with layout `version`,
+/// creating parent directories.  The file is replaced atomically,
+/// so an interrupted run never leaves a torn baseline behind.
+///
+/// # Errors
+/// Returns [`ReportError::Io`] when the file cannot be written and
+/// [`ReportError::Parse`] when the report cannot be encoded.
+pub fn save<T: Serialize>(path: &Path, version: u32, report: &T) -> Result<(), ReportError> {
+    let io_error = |source| ReportError::Io {
+        path: path.to_path_buf(),
+        source,
+    };
+    if let Some(parent) = path.parent() {
+        fs::create_dir_all(parent).map_err(io_error)?;
+    }
+    let mut json = serde_json::to_vec_pretty(&Stored { version, report }).map_err(|source| {
+        ReportError::Parse {
+            path: path.to_path_buf(),
+            source,
+        }
+    })?;
+    json.push(b'\n');
+    cabin_fs::write_atomic(path, json).map_err(io_error)
+}
+
+/// Read a report written by [`save`] with layout `version`.
+///
+/// # Errors
+/// Returns [`ReportError::Io`] when the file cannot be read,
+/// [`ReportError::Parse`] when it is not a report, and
+/// [`ReportError::Version`] when it was written in another layout.
+pub fn load<T: DeserializeOwned>(path: &Path, version: u32) -> Result<T, ReportError> {
+    let json = fs::read(path).map_err(|source| ReportError::Io {
+        path: path.to_path_buf(),
+        source,
+    })?;
+    let parse_error = |source| ReportError::Parse {
+        path: path.to_path_buf(),
+        source,
+    };
+    // Check the version before the fields, so a report from another
+    // layout is reported as such rather than as malformed.
+    let stored: StoredVersion = serde_json::from_slice(&json).map_err(parse_error)?;
+    if stored.version != version {
+        return Err(ReportError::Version {
+            path: path.to_path_buf(),
+            found: stored.version,
+        });
+    }
+    serde_json::from_slice(&json).map_err(parse_error)
+}
+
+/// Errors produced while storing or reading reports.
+#[derive(Debug, Error)]
+pub enum ReportError {
+    /// A report could not be parsed (or encoded).
+    #[error("failed to parse report {}: {source}", .path.display())]
+    Parse {
+        path: PathBuf,
+        #[source]
+        source: serde_json::Error,
+    },
+    /// A stored report was written in another layout.
+    #[error("report {} has layout version {found}; re-save it with this version of cabin", .path.display())]
+    Version { path: PathBuf, found: u32 },
+    /// A report or report directory could not be read or written.
+    #[error("failed to access report {}: {source}", .path.display())]
+    Io {
+        path: PathBuf,
+        #[source]
+        source: io::Error,
+    },
+    /// A baseline name would not name a plain file.
+    #[error(
+        "invalid baseline name {name:?}; use ASCII letters, digits, `-`, `_` and `.` (not leading)"
+    )]
+    InvalidBaselineName { name: String },
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[derive(Debug, PartialEq, Serialize, Deserialize)]
+    struct Report {
+        rows: Vec<u64>,
+    }
+
+    #[test]
+    fn baseline_names_stay_inside_the_baselines_dir() {
+        let dir = Path::new("/b/bench");
+        assert_eq!(
+            baseline_path(dir, "main-1.2_x").unwrap(),
+            dir.join("baselines").join("main-1.2_x.json")
+        );
+        for bad in ["", ".hidden", "../up", "a/b", "a b"] {
+            assert!(
+                matches!(
+                    baseline_path(dir, bad),
+                    Err(ReportError::InvalidBaselineName { .. })
+                ),
+                "{bad:?} must be rejected"
+            );
+        }
+    }
+
+    #[test]
+    fn reports_round_trip_and_check_their_version() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let path = dir.path().join("baselines/main.json");
+        let report = Report { rows: vec![1, 2] };
+        save(&path, 1, &report).unwrap();
+
+        let json = fs::read_to_string(&path).unwrap();
+        assert!(json.contains("\"version\": 1"), "{json}");
+        assert_eq!(load::<Report>(&path, 1).unwrap(), report);
+        assert!(matches!(
+            load::<Report>(&path, 2),
+            Err(ReportError::Version { found: 1, .. })
+        ));
+        assert!(matches!(
+            load::<Report>(&dir.path().join("missing.json"), 1),
+            Err(ReportError::Io { .. })
+        ));
+
+        fs::write(&path, "{\"version\": 1, \"rows\": \"nope\"}").unwrap();
+        assert!(matches!(
+            load::<Report>(&path, 1),
+            Err(ReportError::Parse { .. })
+        ));
+    }
+}
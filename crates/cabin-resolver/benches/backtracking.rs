@@ -0,0 +1,212 @@
+//! Resolver benchmarks over synthetic indexes that make `PubGrub`
+//! backtrack through long version histories.
+//!
+//!   cargo bench -p cabinpkg-resolver                 every scenario
+//!   cargo bench -p cabinpkg-resolver -- pinned-chain only matching names
+//!
+//! Under `cargo test` (no `--bench` flag) each scenario is solved once
+//! as a smoke test, so the fixtures stay solvable as the resolver
+//! changes.
+
+use std::collections::BTreeMap;
+use std::path::PathBuf;
+use std::time::{Duration, Instant};
+
+use cabin_core::PackageName;
+use cabin_index::{
+    IndexEntry, IndexPackageDependency, PackageIndex, StandardsMetadata, VersionMetadata,
+};
+use cabin_resolver::{ResolveInput, resolve_packages};
+use semver::{Version, VersionReq};
+
+/// A named resolve: the index, the root requirements, and the version
+/// the solve must settle on for its pivot package.
+struct Scenario {
+    name: &'static str,
+    index: PackageIndex,
+    root: BTreeMap<PackageName, VersionReq>,
+    expect: (&'static str, Version),
+}
+
+fn name(s: &str) -> PackageName {
+    PackageName::new(s).unwrap()
+}
+
+fn meta(deps: &[(&str, String)]) -> VersionMetadata {
+    VersionMetadata {
+        dependencies: deps
+            .iter()
+            .map(|(dep, req)| {
+                (
+                    name(dep),
+                    IndexPackageDependency {
+                        req: VersionReq::parse(req).unwrap(),
+                        optional: false,
+                        features: Vec::new(),
+                        default_features: true,
+                        condition: None,
+                    },
+                )
+            })
+            .collect(),
+        dev_dependencies: BTreeMap::new(),
+        system_dependencies: BTreeMap::new(),
+        yanked: false,
+        checksum: None,
+        source: None,
+        features: None,
+        profiles: None,
+        toolchain: None,
+        build: None,
+        compiler_wrapper: None,
+        language: None,
+        standards: StandardsMetadata::default(),
+    }
+}
+
+fn index(entries: Vec<(&str, BTreeMap<Version, VersionMetadata>)>) -> PackageIndex {
+    PackageIndex {
+        root: PathBuf::from("/bench/index"),
+        packages: entries
+            .into_iter()
+            .map(|(pkg, versions)| {
+                (
+                    name(pkg),
+                    IndexEntry {
+                        name: name(pkg),
+                        versions,
+                    },
+                )
+            })
+            .collect(),
+    }
+}
+
+fn roots(reqs: &[(&str, &str)]) -> BTreeMap<PackageName, VersionReq> {
+    reqs.iter()
+        .map(|(pkg, req)| (name(pkg), VersionReq::parse(req).unwrap()))
+        .collect()
+}
+
+/// `app` needs `log ^1`.  Every `app` release except the first pins
+/// its own `core` release, and every `core` release but the first
+/// needs `log <1`.  No range generalizes across releases, so `PubGrub`
+/// rejects the `n` newest `app` releases one at a time, re-counting
+/// the candidates of every pending package after each step.
+fn pinned_chain(n: u64) -> Scenario {
+    let app = (0..=n)
+        .map(|i| {
+            (
+                Version::new(1, i, 0),
+                meta(&[("core", format!("=1.{i}.0"))]),
+            )
+        })
+        .collect();
+    let core = (0..=n)
+        .map(|i| {
+            let log = if i == 0 { "^1" } else { "<1" };
+            (Version::new(1, i, 0), meta(&[("log", log.to_owned())]))
+        })
+        .collect();
+    let log = [Version::new(0, 9, 0), Version::new(1, 0, 0)]
+        .into_iter()
+        .map(|v| (v, meta(&[])))
+        .collect();
+    Scenario {
+        name: "pinned-chain",
+        index: index(vec![("app", app), ("core", core), ("log", log)]),
+        root: roots(&[("app", "*"), ("log", "^1")]),
+        expect: ("app", Version::new(1, 0, 0)),
+    }
+}
+
+/// `k` libraries with `n` releases each.  Every release of every
+/// library depends on all the others with a wide range, so each
+/// decision re-prioritizes packages with thousands of candidates and
+/// re-reads the same dependency edges; `top` then forces the oldest
+/// `lib0`, which forces backtracking across the rest.
+fn wide_history(k: usize, n: u64) -> Scenario {
+    let libs: Vec<String> = (0..k).map(|i| format!("lib{i}")).collect();
+    let mut entries: Vec<(&str, BTreeMap<Version, VersionMetadata>)> = libs
+        .iter()
+        .enumerate()
+        .map(|(at, lib)| {
+            let versions = (0..n)
+                .map(|minor| {
+                    let deps: Vec<(&str, String)> = libs
+                        .iter()
+                        .enumerate()
+                        .filter(|(other, _)| *other != at)
+                        .map(|(_, other)| (other.as_str(), format!(">=1.{}.0, <2", minor / 2)))
+                        .collect();
+                    (Version::new(1, minor, 0), meta(&deps))
+                })
+                .collect();
+            (lib.as_str(), versions)
+        })
+        .collect();
+    entries.push((
+        "top",
+        BTreeMap::from([(
+            Version::new(1, 0, 0),
+            meta(&[("lib0", "=1.0.0".to_owned())]),
+        )]),
+    ));
+    let mut root: Vec<(&str, &str)> = libs.iter().map(|lib| (lib.as_str(), "^1")).collect();
+    root.push(("top", "^1"));
+    Scenario {
+        name: "wide-history",
+        index: index(entries),
+        root: roots(&root),
+        expect: ("lib0", Version::new(1, 0, 0)),
+    }
+}
+
+fn solve(scenario: &Scenario) {
+    let input = ResolveInput::new(name("root"), Version::new(0, 1, 0), scenario.root.clone());
+    let output = resolve_packages(&input, &scenario.index).unwrap();
+    let (pkg, version) = &scenario.expect;
+    let chosen = output
+        .packages
+        .iter()
+        .find(|p| p.name.as_str() == *pkg)
+        .map(|p| &p.version);
+    assert_eq!(chosen, Some(version), "{}: unexpected {pkg}", scenario.name);
+}
+
+fn main() {
+    let args: Vec<String> = std::env::args().skip(1).collect();
+    let timed = args.iter().any(|arg| arg == "--bench");
+    let filters: Vec<&String> = args.iter().filter(|arg| !arg.starts_with("--")).collect();
+
+    for scenario in [pinned_chain(400), wide_history(6, 400)] {
+        if !filters.is_empty() && !filters.iter().any(|f| scenario.name.contains(f.as_str())) {
+            continue;
+        }
+        if !timed {
+            solve(&scenario);
+            println!("{}: ok", scenario.name);
+            continue;
+        }
+        solve(&scenario);
+        let mut samples: Vec<Duration> = Vec::new();
+        let started = Instant::now();
+        while samples.len() < 5
+            || (started.elapsed() < Duration::from_secs(3) && samples.len() < 100)
+        {
+            let start = Instant::now();
+            solve(&scenario);
+            samples.push(start.elapsed());
+        }
+        samples.sort_unstable();
+        let total: Duration = samples.iter().sum();
+        let runs = u32::try_from(samples.len()).unwrap_or(u32::MAX);
+        println!(
+            "{:<16} median {:>9.2?}  mean {:>9.2?}  min {:>9.2?}  ({runs} runs)",
+            scenario.name,
+            samples[samples.len() / 2],
+            total / runs,
+            samples[0],
+        );
+    }
+}
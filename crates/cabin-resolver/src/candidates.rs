@@ -0,0 +1,247 @@
+//! Per-package version tables the provider builds once per resolve.
+//!
+//! `PubGrub` asks about the same packages over and over - every
+//! decision re-prioritizes every pending package, and backtracking
+//! re-chooses versions and re-reads dependencies already seen.  A
+//! [`VersionTable`] keeps a package's versions in one ascending
+//! array, so counting or walking the candidates inside a range is a
+//! binary search per range segment rather than a scan of every
+//! version, and memoizes each version's dependency edges so
+//! [`req_to_range`] runs once per edge.
+
+use std::cell::OnceCell;
+use std::ops::{Bound, Range};
+use std::rc::Rc;
+
+use cabin_core::{PackageName, TargetPlatform};
+use cabin_index::{IndexEntry, VersionMetadata};
+use pubgrub::Ranges;
+use semver::{Version, VersionReq};
+
+use crate::provider::StandardTier;
+use crate::range::req_to_range;
+
+/// One package's versions, in ascending order, with the per-version
+/// facts candidate selection reads.
+pub(crate) struct VersionTable {
+    versions: Vec<Version>,
+    yanked: Vec<bool>,
+    tiers: Vec<StandardTier>,
+    edges: Vec<OnceCell<Rc<[DependencyEdge]>>>,
+}
+
+/// An active dependency edge of one version, converted to a `PubGrub`
+/// range.
+pub(crate) struct DependencyEdge {
+    pub(crate) name: PackageName,
+    pub(crate) req: VersionReq,
+    /// The converted range, or the requirement text [`req_to_range`]
+    /// could not translate.
+    pub(crate) range: Result<Ranges<Version>, String>,
+}
+
+impl VersionTable {
+    /// Tabulate `entry`, classifying each version with `tier`.
+    pub(crate) fn new(entry: &IndexEntry, tier: impl Fn(&VersionMetadata) -> StandardTier) -> Self {
+        let len = entry.versions.len();
+        let mut table = Self {
+            versions: Vec::with_capacity(len),
+            yanked: Vec::with_capacity(len),
+            tiers: Vec::with_capacity(len),
+            edges: Vec::with_capacity(len),
+        };
+        // `BTreeMap` iteration is already ascending.
+        for (version, meta) in &entry.versions {
+            table.versions.push(version.clone());
+            table.yanked.push(meta.yanked);
+            table.tiers.push(tier(meta));
+            table.edges.push(OnceCell::new());
+        }
+        table
+    }
+
+    pub(crate) fn version(&self, at: usize) -> &Version {
+        &self.versions[at]
+    }
+
+    pub(crate) fn is_yanked(&self, at: usize) -> bool {
+        self.yanked[at]
+    }
+
+    pub(crate) fn tier(&self, at: usize) -> StandardTier {
+        self.tiers[at]
+    }
+
+    /// Position of `version` in the table.
+    pub(crate) fn position(&self, version: &Version) -> Option<usize> {
+        self.versions.binary_search(version).ok()
+    }
+
+    /// Number of versions inside `range`.
+    pub(crate) fn count_in(&self, range: &Ranges<Version>) -> usize {
+        range
+            .iter()
+            .map(|(lower, upper)| self.run(lower, upper).len())
+            .sum()
+    }
+
+    /// Positions of the versions inside `range`, as one ascending run
+    /// per range segment.
+    pub(crate) fn runs_in(&self, range: &Ranges<Version>) -> Vec<Range<usize>> {
+        range
+            .iter()
+            .map(|(lower, upper)| self.run(lower, upper))
+            .filter(|run| !run.is_empty())
+            .collect()
+    }
+
+    fn run(&self, lower: &Bound<Version>, upper: &Bound<Version>) -> Range<usize> {
+        let start = self.versions.partition_point(|v| match lower {
+            Bound::Included(bound) => v < bound,
+            Bound::Excluded(bound) => v <= bound,
+            Bound::Unbounded => false,
+        });
+        let end = self.versions.partition_point(|v| match upper {
+            Bound::Included(bound) => v <= bound,
+            Bound::Excluded(bound) => v < bound,
+            Bound::Unbounded => true,
+        });
+        start..end.max(start)
+    }
+
+    /// The dependency edges of the version at `at` that take part in
+    /// resolution on `platform`, built from `meta` on first use.
+    ///
+    /// Optional deps (until a feature enables them, matching
+    /// `cabin-workspace::patch`'s conservative default) and
+    /// `cfg(...)`-gated deps whose predicate fails on `platform` are
+    /// left out.
+    pub(crate) fn edges(
+        &self,
+        at: usize,
+        meta: &VersionMetadata,
+        platform: &TargetPlatform,
+    ) -> Rc<[DependencyEdge]> {
+        Rc::clone(self.edges[at].get_or_init(|| {
+            meta.dependencies
+                .iter()
+                .filter(|(_, dep)| dep.is_active_for(platform))
+                .map(|(name, dep)| DependencyEdge {
+                    name: name.clone(),
+                    req: dep.req.clone(),
+                    range: req_to_range(&dep.req).map_err(|err| err.requirement),
+                })
+                .collect()
+        }))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::collections::BTreeMap;
+
+    use cabin_index::IndexPackageDependency;
+
+    use super::*;
+
+    fn version(s: &str) -> Version {
+        Version::parse(s).unwrap()
+    }
+
+    fn meta(deps: &[&str]) -> VersionMetadata {
+        VersionMetadata {
+            dependencies: deps
+                .iter()
+                .map(|dep| {
+                    (
+                        PackageName::new(*dep).unwrap(),
+                        IndexPackageDependency {
+                            req: VersionReq::parse("^1").unwrap(),
+                            optional: false,
+                            features: Vec::new(),
+                            default_features: true,
+                            condition: None,
+                        },
+                    )
+                })
+                .collect(),
+            dev_dependencies: BTreeMap::new(),
+            system_dependencies: BTreeMap::new(),
+            yanked: false,
+            checksum: None,
+            source: None,
+            features: None,
+            profiles: None,
+            toolchain: None,
+            build: None,
+            compiler_wrapper: None,
+            language: None,
+            standards: cabin_index::StandardsMetadata::default(),
+        }
+    }
+
+    fn table(versions: &[&str]) -> VersionTable {
+        let entry = IndexEntry {
+            name: PackageName::new("fmt").unwrap(),
+            versions: versions.iter().map(|v| (version(v), meta(&[]))).collect(),
+        };
+        VersionTable::new(&entry, |_| StandardTier::Undeclared)
+    }
+
+    /// Bisected counting agrees with a linear `contains` scan across
+    /// inclusive, exclusive, unbounded and multi-segment ranges.
+    #[test]
+    fn bisected_count_matches_linear_scan() {
+        let all = [
+            "0.9.0",
+            "1.0.0",
+            "1.0.1-rc.1",
+            "1.0.1",
+            "1.5.0",
+            "2.0.0",
+            "3.1.4",
+        ];
+        let table = table(&all);
+        let ranges = [
+            Ranges::full(),
+            Ranges::empty(),
+            Ranges::singleton(version("1.5.0")),
+            Ranges::singleton(version("1.2.0")),
+            Ranges::between(version("1.0.0"), version("2.0.0")),
+            Ranges::higher_than(version("1.0.1")),
+            Ranges::strictly_higher_than(version("1.0.1")),
+            Ranges::strictly_lower_than(version("1.0.1")),
+            Ranges::lower_than(version("1.0.1")),
+            Ranges::between(version("0.1.0"), version("1.0.0"))
+                .union(&Ranges::between(version("1.5.0"), version("9.0.0"))),
+        ];
+        for range in &ranges {
+            let linear: Vec<&str> = all
+                .iter()
+                .copied()
+                .filter(|v| range.contains(&version(v)))
+                .collect();
+            assert_eq!(table.count_in(range), linear.len(), "{range}");
+            let bisected: Vec<String> = table
+                .runs_in(range)
+                .into_iter()
+                .flatten()
+                .map(|at| table.version(at).to_string())
+                .collect();
+            assert_eq!(bisected, linear, "{range}");
+        }
+    }
+
+    #[test]
+    fn edges_are_built_once_per_version() {
+        let table = table(&["1.0.0"]);
+        let platform = TargetPlatform::current();
+        let first = table.edges(0, &meta(&["dep"]), &platform);
+        assert_eq!(first.len(), 1);
+        assert_eq!(first[0].name.as_str(), "dep");
+        // Later calls never read their metadata again: the memoized
+        // edges are shared, not rebuilt.
+        let second = table.edges(0, &meta(&[]), &platform);
+        assert!(Rc::ptr_eq(&first, &second));
+    }
+}
@@ -124,6 +124,32 @@ pub enum ResolveError {
         package: String,
         requirement: String,
     },
+
+    #[error("failed to load package {package:?} from the index")]
+    #[diagnostic(
+        code(cabin::resolver::error),
+        help(
+            "check that the configured registry is reachable and serves this package, then retry"
+        )
+    )]
+    IndexUnavailable {
+        package: String,
+        #[source]
+        source: Box<dyn std::error::Error + Send + Sync>,
+    },
+}
+
+impl ResolveError {
+    /// Wrap an [`cabin_index::IndexSource`] load failure for `package`.
+    pub(crate) fn index_unavailable(
+        package: &PackageName,
+        source: impl std::error::Error + Send + Sync + 'static,
+    ) -> Self {
+        Self::IndexUnavailable {
+            package: package.as_str().to_owned(),
+            source: Box::new(source),
+        }
+    }
 }
 /// One constraint observed by the resolver, carrying the requirement and
 /// the package that imposed it.  Surfaced inside
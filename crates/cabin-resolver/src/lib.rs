@@ -1,7 +1,9 @@
 //! Local dependency resolver for Cabin.
 //!
-//! Wraps `PubGrub` as the solving engine over a local
-//! [`cabin_index::PackageIndex`].  The public surface is intentionally
+//! Wraps `PubGrub` as the solving engine over any
+//! [`cabin_index::IndexSource`]: a loaded
+//! [`cabin_index::PackageIndex`], or a source that loads each package
+//! only when the solve first reaches it.  The public surface is intentionally
 //! Cabin-native ([`ResolveInput`], [`ResolveOutput`], [`ResolveError`]);
 //! `PubGrub` is an implementation detail and does not appear in the
 //! crate's public types.
@@ -11,8 +13,9 @@
 //! * `preflight` - root-dependency checks that emit Cabin's
 //!   targeted error variants before `PubGrub` runs.
 //! * `provider` - the `PubGrub` `DependencyProvider`
-//!   implementation, candidate selection, and dependency-edge
-//!   filtering.
+//!   implementation and candidate selection.
+//! * `candidates` - per-package version tables the provider bisects,
+//!   with memoized dependency-edge filtering and range conversion.
 //! * `locked` - shared locked-version metadata validation
 //!   plus the locked-mode-only constraint recorder.
 //! * `explanation` - `PubGrub` no-solution → Cabin
@@ -22,6 +25,7 @@
 //! * `range` - `semver::VersionReq` → `PubGrub`
 //!   `Ranges<semver::Version>` translation.
 
+mod candidates;
 pub mod error;
 mod explanation;
 pub mod input;
@@ -37,7 +41,7 @@ use cabin_core::standard_compatibility::{
     ConsumerStandards, EffectiveRequirements, edge_compatible,
 };
 use cabin_core::{IncompatibleStandards, PackageName, Requirement, SourceLanguage, TargetPlatform};
-use cabin_index::PackageIndex;
+use cabin_index::IndexSource;
 use pubgrub::{PubGrubError, Ranges};
 use semver::{Version, VersionReq};
 
@@ -66,7 +70,12 @@ use crate::range::req_to_range;
 /// `PubGrub` reports no solution it returns [`ResolveError::Conflict`]; any
 /// provider-side [`ResolveError`] surfaced while choosing versions,
 /// retrieving dependencies, or cancelling is bubbled back unchanged.
-pub fn resolve(input: &ResolveInput, index: &PackageIndex) -> Result<ResolveOutput, ResolveError> {
+/// A package `index` fails to load surfaces as
+/// [`ResolveError::IndexUnavailable`].
+pub fn resolve<S: IndexSource + ?Sized>(
+    input: &ResolveInput,
+    index: &S,
+) -> Result<ResolveOutput, ResolveError> {
     let mut output = resolve_once(input, index)?;
     output.held_back = held_back_report(input, index, &output.packages);
     Ok(output)
@@ -84,9 +93,9 @@ pub fn resolve(input: &ResolveInput, index: &PackageIndex) -> Result<ResolveOutp
 ///
 /// # Errors
 /// Same as [`resolve`].
-pub fn resolve_packages(
+pub fn resolve_packages<S: IndexSource + ?Sized>(
     input: &ResolveInput,
-    index: &PackageIndex,
+    index: &S,
 ) -> Result<ResolveOutput, ResolveError> {
     resolve_once(input, index)
 }
@@ -94,7 +103,10 @@ pub fn resolve_packages(
 /// Resolve `input` once under its own mode, without computing the
 /// standard hold-back report (which needs a second, `Allow`-mode
 /// resolution to diff against - see [`held_back_report`]).
-fn resolve_once(input: &ResolveInput, index: &PackageIndex) -> Result<ResolveOutput, ResolveError> {
+fn resolve_once<S: IndexSource + ?Sized>(
+    input: &ResolveInput,
+    index: &S,
+) -> Result<ResolveOutput, ResolveError> {
     let platform = TargetPlatform::current();
     let locked = effective_locked(input);
 
@@ -158,9 +170,9 @@ fn resolve_once(input: &ResolveInput, index: &PackageIndex) -> Result<ResolveOut
 /// standard (nothing can be incompatible).  On the `Fallback`-success
 /// path the `Allow` resolution cannot fail - solvability is identical -
 /// but a defensive error yields an empty report rather than aborting.
-fn held_back_report(
+fn held_back_report<S: IndexSource + ?Sized>(
     input: &ResolveInput,
-    index: &PackageIndex,
+    index: &S,
     fallback_packages: &[ResolvedPackage],
 ) -> Vec<HeldBack> {
     if input.incompatible_standards != IncompatibleStandards::Fallback {
@@ -205,9 +217,15 @@ fn held_back_report(
         // version is *itself* standard-incompatible because nothing in
         // range satisfies the consumer.  Report its own unmet
         // requirement, with no compatible alternative to name.
-        let selected_advertised = index
-            .package(&package.name)
-            .and_then(|entry| entry.versions.get(&package.version))
+        // Every package here was loaded by the solve, so a lookup
+        // failure is not expected; it only drops the package from the
+        // report.
+        let Ok(Some(entry)) = index.package(&package.name) else {
+            continue;
+        };
+        let selected_advertised = entry
+            .versions
+            .get(&package.version)
             .map(|meta| meta.standards.version_wide_join());
         if let Some(advertised) = selected_advertised
             && !edge_compatible(consumer, advertised)
@@ -241,14 +259,10 @@ fn held_back_report(
         if !admissible_under(&package.name, newest, input, index, fallback_packages) {
             continue;
         }
-        let Some(standards) = index
-            .package(&package.name)
-            .and_then(|entry| entry.versions.get(newest))
-            .map(|meta| &meta.standards)
-        else {
+        let Some(meta) = entry.versions.get(newest) else {
             continue;
         };
-        let advertised = standards.version_wide_join();
+        let advertised = meta.standards.version_wide_join();
         let blocked_by = if edge_compatible(consumer, advertised) {
             // The newer version is compatible, so the only reason
             // fallback passed it over is that it is undeclared and a
@@ -283,11 +297,11 @@ fn held_back_report(
 /// active dependency edge the resolved packages place on `package` -
 /// under the same numeric-range *and* pre-release rules the provider
 /// applies when selecting.
-fn admissible_under(
+fn admissible_under<S: IndexSource + ?Sized>(
     package: &PackageName,
     version: &Version,
     input: &ResolveInput,
-    index: &PackageIndex,
+    index: &S,
     solution: &[ResolvedPackage],
 ) -> bool {
     let platform = TargetPlatform::current();
@@ -305,10 +319,10 @@ fn admissible_under(
         if resolved.source == ResolvedSource::Root {
             continue;
         }
-        let Some(meta) = index
-            .package(&resolved.name)
-            .and_then(|entry| entry.versions.get(&resolved.version))
-        else {
+        let Ok(Some(entry)) = index.package(&resolved.name) else {
+            continue;
+        };
+        let Some(meta) = entry.versions.get(&resolved.version) else {
             continue;
         };
         let Some(dep) = meta.dependencies.get(package) else {
@@ -2224,4 +2238,87 @@ mod tests {
             "fmt v1.0.0 (available: v2.0.0, requires interface c++11..c++14)"
         );
     }
+
+    /// An [`IndexSource`] over an in-memory index that records which
+    /// packages the resolver loads and which it hints at.
+    struct RecordingSource {
+        index: PackageIndex,
+        loaded: std::cell::RefCell<std::collections::BTreeSet<String>>,
+        prefetched: std::cell::RefCell<std::collections::BTreeSet<String>>,
+    }
+
+    impl IndexSource for RecordingSource {
+        type Entry<'s> = &'s IndexEntry;
+        type Error = std::convert::Infallible;
+
+        fn package(
+            &self,
+            name: &PackageName,
+        ) -> Result<Option<&IndexEntry>, std::convert::Infallible> {
+            self.loaded.borrow_mut().insert(name.as_str().to_owned());
+            Ok(self.index.packages.get(name))
+        }
+
+        fn prefetch(&self, names: &[&PackageName]) {
+            let mut prefetched = self.prefetched.borrow_mut();
+            prefetched.extend(names.iter().map(|name| name.as_str().to_owned()));
+        }
+    }
+
+    #[test]
+    fn resolve_loads_only_packages_the_solve_reaches() {
+        // `legacy` is reachable only through a version of `lib` the
+        // solve never picks, so it must never be loaded.
+        let source = RecordingSource {
+            index: build_index(vec![
+                entry(
+                    "lib",
+                    vec![
+                        ("1.0.0", vec![("legacy", "^1")], false),
+                        ("2.0.0", vec![("fmt", "^10")], false),
+                    ],
+                ),
+                entry("fmt", vec![("10.2.1", vec![], false)]),
+                entry("legacy", vec![("1.0.0", vec![], false)]),
+            ]),
+            loaded: std::cell::RefCell::default(),
+            prefetched: std::cell::RefCell::default(),
+        };
+        let out = resolve(&make_input(vec![("lib", "*")]), &source).unwrap();
+        let names: Vec<&str> = out.packages.iter().map(|p| p.name.as_str()).collect();
+        assert_eq!(names, ["app", "fmt", "lib"]);
+        assert_eq!(
+            source.loaded.borrow().iter().collect::<Vec<_>>(),
+            ["fmt", "lib"]
+        );
+        // The root dependencies and the chosen version's dependencies
+        // are both hinted before they are looked up.
+        assert_eq!(
+            source.prefetched.borrow().iter().collect::<Vec<_>>(),
+            ["fmt", "lib"]
+        );
+    }
+
+    /// A load failure aborts the resolve with the package named,
+    /// rather than being mistaken for an unknown package.
+    #[test]
+    fn index_load_failure_surfaces_as_index_unavailable() {
+        struct Failing;
+        impl IndexSource for Failing {
+            type Entry<'s> = &'s IndexEntry;
+            type Error = std::io::Error;
+
+            fn package(&self, _: &PackageName) -> Result<Option<&IndexEntry>, std::io::Error> {
+                Err(std::io::Error::other("connection reset"))
+            }
+        }
+        let err = resolve(&make_input(vec![("fmt", "*")]), &Failing).unwrap_err();
+        match err {
+            ResolveError::IndexUnavailable { package, source } => {
+                assert_eq!(package, "fmt");
+                assert_eq!(source.to_string(), "connection reset");
+            }
+            other => panic!("expected IndexUnavailable, got {other:?}"),
+        }
+    }
 }
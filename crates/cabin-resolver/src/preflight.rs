@@ -22,7 +22,7 @@
 use std::collections::BTreeMap;
 
 use cabin_core::PackageName;
-use cabin_index::{IndexEntry, PackageIndex};
+use cabin_index::{IndexEntry, IndexSource};
 use semver::{Version, VersionReq};
 
 use crate::error::{ResolveError, ResolverConstraint};
@@ -51,13 +51,17 @@ pub(crate) fn effective_locked(input: &ResolveInput) -> BTreeMap<PackageName, Lo
 /// locked-mode constraint recorder, so a later
 /// `LockedVersionViolatesConstraint` on a package the root also
 /// depends on names the root requirement that imposed it.
-pub(crate) fn preflight_root_dependencies(
+pub(crate) fn preflight_root_dependencies<S: IndexSource + ?Sized>(
     input: &ResolveInput,
-    index: &PackageIndex,
+    index: &S,
     locked: &BTreeMap<PackageName, LockedVersion>,
 ) -> Result<BTreeMap<PackageName, Vec<ResolverConstraint>>, ResolveError> {
     let mut constraints: BTreeMap<PackageName, Vec<ResolverConstraint>> = BTreeMap::new();
 
+    // Every root dependency is looked up below, so a lazy source may
+    // as well load them together.
+    index.prefetch(&input.root_dependencies.keys().collect::<Vec<_>>());
+
     for (name, req) in &input.root_dependencies {
         constraints
             .entry(name.clone())
@@ -69,17 +73,18 @@ pub(crate) fn preflight_root_dependencies(
 
         let entry = index
             .package(name)
+            .map_err(|err| ResolveError::index_unavailable(name, err))?
             .ok_or_else(|| ResolveError::UnknownPackage(name.as_str().to_owned()))?;
 
         if matches!(input.mode, ResolveMode::Locked) {
             let locked_entry = locked
                 .get(name)
                 .ok_or_else(|| ResolveError::LockfileMissingPackage(name.as_str().to_owned()))?;
-            validate_locked_root_dependency(&input.root_name, name, locked_entry, entry, req)?;
+            validate_locked_root_dependency(&input.root_name, name, locked_entry, &entry, req)?;
             continue;
         }
 
-        check_root_candidates(name, entry, req, &constraints)?;
+        check_root_candidates(name, &entry, req, &constraints)?;
     }
 
     Ok(constraints)
@@ -38,25 +38,40 @@
 //! requirement.  The recorder is held as
 //! `Option<LockedConstraintRecorder>` and constructed only in
 //! `Locked` mode - see [`crate::locked`] for the invariant.
+//!
+//! ## Lazy index access
+//!
+//! The provider reads packages through [`IndexSource`], so a lazy
+//! source loads a package the first time `PubGrub` asks about it.
+//! Once a version's dependencies are known, their names are handed
+//! to [`IndexSource::prefetch`]: `PubGrub` prioritizes every newly
+//! added package straight away, so the next lookups are exactly
+//! those names and a lazy source can load them together.
+//!
+//! Each package the solve touches is tabulated once into a
+//! [`VersionTable`]; candidate counting and selection bisect it, and
+//! each version's dependency ranges are converted once.
 
+use std::cell::RefCell;
 use std::cmp::Reverse;
-use std::collections::BTreeMap;
+use std::collections::{BTreeMap, HashMap};
 use std::ops::Bound;
+use std::rc::Rc;
 
 use cabin_core::standard_compatibility::{ConsumerStandards, edge_compatible};
 use cabin_core::{
     IncompatibleStandards, PackageName, Requirement, StandardsMetadata, TargetPlatform,
 };
-use cabin_index::{IndexEntry, PackageIndex};
+use cabin_index::{IndexEntry, IndexSource};
 use pubgrub::{
     Dependencies, DependencyConstraints, DependencyProvider, PackageResolutionStatistics, Ranges,
 };
 use semver::Version;
 
+use crate::candidates::VersionTable;
 use crate::error::{ResolveError, ResolverConstraint};
 use crate::input::{LockedVersion, ResolveInput, ResolveMode};
 use crate::locked::{LockedConstraintRecorder, validate_locked_metadata};
-use crate::range::req_to_range;
 
 /// The three preference tiers of
 /// `docs/design/standard-compatibility/preference-mode.md` section 1,
@@ -65,7 +80,7 @@ use crate::range::req_to_range;
 /// compatibility), which is preferred to a declared-but-incompatible
 /// one.  The derived `Ord` is exactly that preference order.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord)]
-enum StandardTier {
+pub(crate) enum StandardTier {
     /// Declares an interface requirement the consumer satisfies.
     DeclaredCompatible,
     /// Declares nothing relevant to the consumer's languages
@@ -83,8 +98,8 @@ enum StandardTier {
 /// preflight-collected root constraints; outside `Locked` mode
 /// the recorder is absent because backtracking would invalidate
 /// it (see [`crate::locked`]).
-pub(crate) struct Provider<'a> {
-    index: &'a PackageIndex,
+pub(crate) struct Provider<'a, S: IndexSource + ?Sized> {
+    index: &'a S,
     root_name: PackageName,
     root_version: Version,
     root_dependencies: Vec<(PackageName, Ranges<Version>)>,
@@ -98,12 +113,14 @@ pub(crate) struct Provider<'a> {
     /// The workspace consumer's effective compile levels, checked
     /// against candidate declared requirements for tier ordering.
     consumer_standards: ConsumerStandards,
+    /// Every package tabulated so far this resolve.
+    tables: RefCell<HashMap<PackageName, Rc<VersionTable>>>,
 }
 
-impl<'a> Provider<'a> {
+impl<'a, S: IndexSource + ?Sized> Provider<'a, S> {
     pub(crate) fn new(
         input: &ResolveInput,
-        index: &'a PackageIndex,
+        index: &'a S,
         locked: BTreeMap<PackageName, LockedVersion>,
         platform: TargetPlatform,
         root_constraints: BTreeMap<PackageName, Vec<ResolverConstraint>>,
@@ -124,15 +141,50 @@ impl<'a> Provider<'a> {
             locked_constraints,
             incompatible_standards: input.incompatible_standards,
             consumer_standards: input.consumer_standards,
+            tables: RefCell::default(),
         }
     }
 
     fn is_root(&self, package: &PackageName) -> bool {
         package == &self.root_name
     }
+
+    /// Look `package` up in the index, surfacing a load failure as
+    /// [`ResolveError::IndexUnavailable`].
+    fn entry(&self, package: &PackageName) -> Result<Option<S::Entry<'a>>, ResolveError> {
+        self.index
+            .package(package)
+            .map_err(|err| ResolveError::index_unavailable(package, err))
+    }
+
+    /// The [`VersionTable`] of `package`, loading the package from the
+    /// index if it has not been tabulated yet.
+    fn table(&self, package: &PackageName) -> Result<Option<Rc<VersionTable>>, ResolveError> {
+        if let Some(table) = self.tables.borrow().get(package) {
+            return Ok(Some(Rc::clone(table)));
+        }
+        Ok(self
+            .entry(package)?
+            .map(|entry| self.tabulate(package, &entry)))
+    }
+
+    /// The [`VersionTable`] of `package`, built from `entry` and
+    /// memoized the first time it is needed.
+    fn tabulate(&self, package: &PackageName, entry: &IndexEntry) -> Rc<VersionTable> {
+        if let Some(table) = self.tables.borrow().get(package) {
+            return Rc::clone(table);
+        }
+        let table = Rc::new(VersionTable::new(entry, |meta| {
+            classify(self.consumer_standards, &meta.standards)
+        }));
+        self.tables
+            .borrow_mut()
+            .insert(package.clone(), Rc::clone(&table));
+        table
+    }
 }
 
-impl DependencyProvider for Provider<'_> {
+impl<S: IndexSource + ?Sized> DependencyProvider for Provider<'_, S> {
     type P = PackageName;
     type V = Version;
     type VS = Ranges<Version>;
@@ -160,15 +212,17 @@ impl DependencyProvider for Provider<'_> {
         // abort resolution before `PubGrub` could try that
         // alternative.  Root-level unknowns are caught in
         // preflight where the error is unambiguous.
-        let Some(entry) = self.index.package(package) else {
-            return Ok(None);
-        };
-
         if let Some(recorder) = &self.locked_constraints {
-            return self.choose_locked_candidate(package, recorder, entry, range);
+            let Some(entry) = self.entry(package)? else {
+                return Ok(None);
+            };
+            return self.choose_locked_candidate(package, recorder, &entry, range);
         }
 
-        Ok(self.choose_compatible_candidate(package, entry, range))
+        let Some(table) = self.table(package)? else {
+            return Ok(None);
+        };
+        Ok(self.choose_compatible_candidate(package, &table, range))
     }
 
     fn prioritize(
@@ -179,9 +233,12 @@ impl DependencyProvider for Provider<'_> {
     ) -> Self::Priority {
         let count = if self.is_root(package) {
             usize::from(range.contains(&self.root_version))
-        } else if let Some(entry) = self.index.package(package) {
-            entry.versions.keys().filter(|v| range.contains(v)).count()
+        } else if let Ok(Some(table)) = self.table(package) {
+            table.count_in(range)
         } else {
+            // A package that failed to load ranks like an unknown one:
+            // it is decided first, and `choose_version` retries the
+            // load and reports the error.
             0
         };
         if count == 0 {
@@ -202,26 +259,22 @@ impl DependencyProvider for Provider<'_> {
         }
 
         let entry = self
-            .index
-            .package(package)
+            .entry(package)?
             .ok_or_else(|| ResolveError::UnknownPackage(package.as_str().to_owned()))?;
-        let Some(meta) = entry.versions.get(version) else {
+        let table = self.tabulate(package, &entry);
+        let (Some(meta), Some(at)) = (entry.versions.get(version), table.position(version)) else {
             return Ok(Dependencies::Unavailable(format!(
                 "{package} {version} is not present in the index"
             )));
         };
 
-        let mut deps: Vec<(PackageName, Ranges<Version>)> = Vec::new();
-        for (dep_name, dep_entry) in &meta.dependencies {
-            // Skip edges that do not participate in resolution on
-            // this host: optional deps (until a feature enables them,
-            // matching cabin-workspace::patch's conservative default)
-            // and `cfg(...)`-gated deps whose predicate fails here.
-            if !dep_entry.is_active_for(&self.platform) {
-                continue;
-            }
+        // Only edges that participate in resolution on this host; see
+        // [`VersionTable::edges`].
+        let edges = table.edges(at, meta, &self.platform);
+        let mut deps: Vec<(PackageName, Ranges<Version>)> = Vec::with_capacity(edges.len());
+        for edge in edges.iter() {
             if let Some(recorder) = &self.locked_constraints {
-                recorder.record(dep_name, package.clone(), dep_entry.req.clone());
+                recorder.record(&edge.name, package.clone(), edge.req.clone());
             }
             // An unsupported requirement syntax on a transitive
             // dep is a backtrackable miss, not a fatal error:
@@ -231,25 +284,27 @@ impl DependencyProvider for Provider<'_> {
             // `PubGrub` could try that alternative.  The root
             // path catches unsupported syntax up front, where
             // the error names the user-authored requirement.
-            let range = match req_to_range(&dep_entry.req) {
-                Ok(range) => range,
-                Err(err) => {
+            let range = match &edge.range {
+                Ok(range) => range.clone(),
+                Err(requirement) => {
                     return Ok(Dependencies::Unavailable(format!(
-                        "{package} {version} declares an unsupported version requirement for {dep_name}: {}",
-                        err.requirement,
+                        "{package} {version} declares an unsupported version requirement for {}: {requirement}",
+                        edge.name,
                     )));
                 }
             };
-            deps.push((dep_name.clone(), range));
+            deps.push((edge.name.clone(), range));
         }
+        self.index
+            .prefetch(&deps.iter().map(|(name, _)| name).collect::<Vec<_>>());
         Ok(Dependencies::Available(DependencyConstraints::from_iter(
             deps,
         )))
     }
 }
 
-impl Provider<'_> {
-    /// Pick a version of `entry` inside `range`, preferring the
+impl<S: IndexSource + ?Sized> Provider<'_, S> {
+    /// Pick a version of `package` from its `table` inside `range`, preferring the
     /// lockfile entry when it qualifies and otherwise applying the
     /// standard-preference ordering of
     /// `docs/design/standard-compatibility/preference-mode.md`.
@@ -267,64 +322,54 @@ impl Provider<'_> {
     fn choose_compatible_candidate(
         &self,
         package: &PackageName,
-        entry: &IndexEntry,
+        table: &VersionTable,
         range: &Ranges<Version>,
     ) -> Option<Version> {
-        let mut candidates: Vec<&Version> = entry
-            .versions
-            .iter()
-            .filter(|(v, meta)| range.contains(*v) && !meta.yanked)
-            .map(|(v, _)| v)
-            .collect();
-        if candidates.is_empty() {
-            return None;
-        }
-
-        candidates.retain(|v| candidate_admits_prerelease(range, v));
-        if candidates.is_empty() {
-            return None;
-        }
+        let admissible = |at: usize| {
+            !table.is_yanked(at) && candidate_admits_prerelease(range, table.version(at))
+        };
 
         // Lockfile stability wins (preference-mode.md rule 4): a locked
         // version that still qualifies is kept regardless of standards,
         // and never counts as a hold-back - metadata alone never churns
         // a lockfile.
         if let Some(locked) = self.locked.get(package)
-            && candidates.contains(&&locked.version)
+            && range.contains(&locked.version)
+            && table.position(&locked.version).is_some_and(admissible)
         {
             return Some(locked.version.clone());
         }
 
+        let mut newest_first = table
+            .runs_in(range)
+            .into_iter()
+            .rev()
+            .flat_map(Iterator::rev)
+            .filter(|&at| admissible(at));
+
         if self.incompatible_standards == IncompatibleStandards::Allow {
             // The pure-semver pick: the newest admissible version, i.e.
             // exactly what every pre-preference-mode release selects.
-            return candidates.into_iter().max().cloned();
+            return newest_first.next().map(|at| table.version(at).clone());
         }
 
         // Fallback: order by tier (best first), newest-first within a
         // tier.  Never filters, so the worst case is the newest of the
         // worst tier - the same version `Allow` selects.  Hold-back
         // reporting is not computed here; it is the diff against the
-        // `Allow` solution (see [`crate::held_back_report`]).
-        candidates
-            .into_iter()
-            .min_by(|a, b| {
-                self.tier(entry, a)
-                    .cmp(&self.tier(entry, b))
-                    .then_with(|| b.cmp(a))
-            })
-            .cloned()
-    }
-
-    /// Classify a candidate version into its [`StandardTier`] against
-    /// the consumer standards (preference-mode.md section 1).
-    fn tier(&self, entry: &IndexEntry, version: &Version) -> StandardTier {
-        entry
-            .versions
-            .get(version)
-            .map_or(StandardTier::Undeclared, |meta| {
-                classify(self.consumer_standards, &meta.standards)
-            })
+        // `Allow` solution (see [`crate::held_back_report`]).  Walking
+        // newest-first, the first candidate of a tier is the one that
+        // tier would pick, and nothing outranks the best tier.
+        let mut best: Option<usize> = None;
+        for at in newest_first {
+            if best.is_none_or(|best| table.tier(at) < table.tier(best)) {
+                best = Some(at);
+                if table.tier(at) == StandardTier::DeclaredCompatible {
+                    break;
+                }
+            }
+        }
+        best.map(|at| table.version(at).clone())
     }
 
     /// Pick the locked version for `package` in `Locked` mode,
@@ -413,9 +458,9 @@ pub(crate) fn candidate_admits_prerelease(range: &Ranges<Version>, candidate: &V
 /// version is admissible against a requirement only when one of
 /// its comparators names the same triple with a non-empty `pre`
 /// field.  Because the range bounds come from those comparators
-/// (via [`req_to_range`]), checking the bounds is equivalent in
-/// practice and avoids carrying the original [`VersionReq`] set
-/// alongside the range.
+/// (via [`crate::range::req_to_range`]), checking the bounds is
+/// equivalent in practice and avoids carrying the original
+/// [`VersionReq`] set alongside the range.
 fn range_admits_prerelease_of(range: &Ranges<Version>, candidate: &Version) -> bool {
     let matches = |bound: &Bound<Version>| match bound {
         Bound::Included(v) | Bound::Excluded(v) => {
@@ -0,0 +1,128 @@
+//! Git-aware change scoping for `cabin fmt --changed` / `--since`.
+//!
+//! A pre-commit hook or a PR job only needs the files the change
+//! touched, not the whole tree.  [`changed_paths`] asks `git` for
+//! that set; callers intersect it with [`crate::discover_sources`]'
+//! result, so every exclusion, ignore, and selection rule still
+//! applies and scoping can only ever narrow the file list.
+
+use std::collections::BTreeSet;
+use std::path::{Path, PathBuf};
+use std::process::Command;
+
+use crate::SourceDiscoveryError;
+
+/// Which change set [`changed_paths`] reports.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub enum ChangeScope {
+    /// Everything not yet committed: staged and unstaged edits
+    /// relative to `HEAD`, plus untracked files that are not
+    /// ignored.  The pre-commit shape.
+    Uncommitted,
+    /// Only what is staged in the index relative to `HEAD` (or to
+    /// the empty tree before the first commit).  Unstaged edits and
+    /// untracked files are left out, so a hook that checks what is
+    /// about to be committed ignores unrelated work in progress.
+    Staged,
+    /// Everything changed since the merge base of the named
+    /// revision and `HEAD`, including uncommitted and untracked
+    /// files.  The PR shape: `--since origin/main` reports what
+    /// the branch changed, not what `main` gained meanwhile.
+    Since(String),
+}
+
+/// Absolute, canonicalized paths of the files `scope` covers in the
+/// git work tree containing `dir`.  Deleted files are included (they
+/// no longer canonicalize, so they keep their joined spelling): a
+/// deleted header still names the translation units that included
+/// it.
+///
+/// # Errors
+/// Returns [`SourceDiscoveryError::Git`] when `git` cannot be
+/// spawned, `dir` is not inside a work tree, or the revision in
+/// [`ChangeScope::Since`] does not resolve.
+pub fn changed_paths(
+    dir: &Path,
+    scope: &ChangeScope,
+) -> Result<BTreeSet<PathBuf>, SourceDiscoveryError> {
+    let toplevel = git(dir, &["rev-parse", "--show-toplevel"])?;
+    let toplevel = cabin_fs::canonicalize_or_input(String::from_utf8_lossy(&toplevel).trim_end());
+
+    // Rename detection would report only the new name; with it off
+    // the old name shows up as a deletion, which is what header
+    // dependents need.
+    let diff = |against: &str| {
+        git(
+            &toplevel,
+            &["diff", "--name-only", "-z", "--no-renames", against, "--"],
+        )
+    };
+    let list_untracked = || {
+        git(
+            &toplevel,
+            &["ls-files", "-z", "--others", "--exclude-standard"],
+        )
+    };
+    let (tracked, untracked) = match scope {
+        ChangeScope::Uncommitted => (diff("HEAD")?, list_untracked()?),
+        // `--cached` alone compares the index against `HEAD`, or
+        // against the empty tree before the first commit.
+        ChangeScope::Staged => (diff("--cached")?, Vec::new()),
+        ChangeScope::Since(rev) => {
+            let base = git(&toplevel, &["merge-base", rev, "HEAD"])?;
+            let base = String::from_utf8_lossy(&base).trim_end().to_owned();
+            (diff(&base)?, list_untracked()?)
+        }
+    };
+
+    Ok(split_name_list(&tracked)
+        .chain(split_name_list(&untracked))
+        .map(|rel| cabin_fs::canonicalize_or_input(toplevel.join(rel)))
+        .collect())
+}
+
+/// Run `git <args>` in `dir` and return its stdout.
+fn git(dir: &Path, args: &[&str]) -> Result<Vec<u8>, SourceDiscoveryError> {
+    let rendered = format!("git {}", args.join(" "));
+    let output = Command::new("git")
+        .arg("-C")
+        .arg(dir)
+        .args(args)
+        .output()
+        .map_err(|err| SourceDiscoveryError::Git {
+            command: rendered.clone(),
+            detail: err.to_string(),
+        })?;
+    if !output.status.success() {
+        return Err(SourceDiscoveryError::Git {
+            command: rendered,
+            detail: String::from_utf8_lossy(&output.stderr).trim().to_owned(),
+        });
+    }
+    Ok(output.stdout)
+}
+
+/// Split `git ... -z` output into work-tree-relative paths.  Git
+/// writes paths as raw bytes; a name that is not UTF-8 cannot be a
+/// path `discover_sources` reports on every platform, so it is
+/// converted lossily and simply fails to match.
+fn split_name_list(raw: &[u8]) -> impl Iterator<Item = PathBuf> + '_ {
+    raw.split(|&b| b == 0)
+        .filter(|name| !name.is_empty())
+        .map(|name| PathBuf::from(String::from_utf8_lossy(name).into_owned()))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn name_list_splits_on_nul_and_skips_the_terminator() {
+        let names: Vec<PathBuf> = split_name_list(b"src/a b.cc\0include/x.h\0").collect();
+        assert_eq!(
+            names,
+            [PathBuf::from("src/a b.cc"), PathBuf::from("include/x.h")]
+        );
+        assert_eq!(split_name_list(b"").count(), 0);
+    }
+}
@@ -24,6 +24,9 @@
 //!
 //! Only files whose extension matches the recognized C/C++
 //! source or header set (`RECOGNIZED_EXTENSIONS`) are returned.
+//!
+//! [`changed_paths`] supplies the git change set `--changed` /
+//! `--since` narrow the walked files to.
 
 #![deny(missing_docs)]
 use std::collections::BTreeSet;
@@ -32,6 +35,10 @@ use std::path::{Path, PathBuf};
 use ignore::WalkBuilder;
 use thiserror::Error;
 
+mod changed;
+
+pub use changed::{ChangeScope, changed_paths};
+
 /// Input shape for [`discover_sources`].
 ///
 /// The request mirrors the shared CLI surface for `cabin fmt`
@@ -104,6 +111,17 @@ pub enum SourceDiscoveryError {
     /// verbatim.
     #[error("source discovery failed: {0}")]
     Walk(#[from] ignore::Error),
+
+    /// A `git` query behind [`changed_paths`] failed: `git` is not
+    /// installed, the tree is not a git work tree, or the requested
+    /// revision does not resolve.
+    #[error("`{command}` failed: {detail}")]
+    Git {
+        /// The git command line, without the `-C <dir>` prefix.
+        command: String,
+        /// Git's stderr, or the spawn error.
+        detail: String,
+    },
 }
 
 /// Canonicalize exclusion paths into a set, collapsing the
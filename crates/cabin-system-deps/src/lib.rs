@@ -20,13 +20,15 @@
 //! `cabin test` / `cabin tidy` / `cabin metadata` invocation when
 //! the selected workspace declares at least one system dependency;
 //! a workspace with no system dependencies never spawns
-//! `pkg-config`.
+//! `pkg-config`.  The whole set is probed concurrently through
+//! [`probe_system_dependencies`].
 
 #![deny(missing_docs)]
 
 use std::collections::{BTreeMap, BTreeSet};
 use std::ffi::{OsStr, OsString};
 use std::process::Command;
+use std::sync::atomic::{AtomicUsize, Ordering};
 
 use camino::Utf8PathBuf;
 
@@ -499,6 +501,75 @@ pub fn probe_system_dependency(
     })
 }
 
+/// Upper bound on concurrent [`probe_system_dependency`] calls made
+/// by [`probe_system_dependencies`].  Each probe spawns up to four
+/// short-lived `pkg-config` processes in sequence, so a small pool
+/// turns a cold workspace's probes into roughly one round without
+/// flooding the host with children.
+pub const PROBE_CONCURRENCY: usize = 8;
+
+/// Probe a set of system dependencies concurrently.
+///
+/// Runs [`probe_system_dependency`] for every request on a scoped
+/// pool of at most [`PROBE_CONCURRENCY`] threads (never more than
+/// the host's available parallelism or the request count) and
+/// returns one result per request, in request order, so callers
+/// keep their deterministic flag-merge and error order.  Each
+/// module still gets its own `pkg-config` invocations: batching
+/// several modules into one `--cflags` call would merge and
+/// dedup their output and lose the per-package attribution that
+/// `--exists` failures (package missing vs. version mismatch)
+/// depend on.  A single request runs on the calling thread.
+///
+/// # Panics
+/// Re-raises a panic from a probe thread on the calling thread.
+pub fn probe_system_dependencies(
+    requests: &[SystemDependencyProbeRequest<'_>],
+) -> Vec<Result<SystemDependencyResolution, PkgConfigError>> {
+    let workers = std::thread::available_parallelism()
+        .map_or(1, std::num::NonZeroUsize::get)
+        .min(PROBE_CONCURRENCY)
+        .min(requests.len());
+    if workers <= 1 {
+        return requests.iter().map(probe_system_dependency).collect();
+    }
+    let next = AtomicUsize::new(0);
+    let mut slots: Vec<Option<Result<SystemDependencyResolution, PkgConfigError>>> =
+        std::iter::repeat_with(|| None)
+            .take(requests.len())
+            .collect();
+    std::thread::scope(|scope| {
+        let handles: Vec<_> = (0..workers)
+            .map(|_| {
+                scope.spawn(|| {
+                    let mut done = Vec::new();
+                    loop {
+                        let idx = next.fetch_add(1, Ordering::Relaxed);
+                        let Some(req) = requests.get(idx) else {
+                            break done;
+                        };
+                        done.push((idx, probe_system_dependency(req)));
+                    }
+                })
+            })
+            .collect();
+        for handle in handles {
+            // A probe never panics short of a bug; re-raise it on
+            // the caller's thread rather than dropping results.
+            let done = handle
+                .join()
+                .unwrap_or_else(|payload| std::panic::resume_unwind(payload));
+            for (idx, result) in done {
+                slots[idx] = Some(result);
+            }
+        }
+    });
+    slots
+        .into_iter()
+        .map(|slot| slot.expect("every request index is claimed exactly once"))
+        .collect()
+}
+
 /// Classify `--cflags` tokens into the typed flag buckets: `-I`
 /// directories split into the plain and system include lists (see
 /// [`SystemDependencyFlags`]), everything else passed through as
@@ -17,7 +17,7 @@ use assert_fs::TempDir;
 use assert_fs::prelude::*;
 use cabin_system_deps::{
     PkgConfigError, PkgConfigTool, SystemDependencyProbeRequest, SystemDependencyResolution,
-    probe_system_dependency,
+    probe_system_dependencies, probe_system_dependency,
 };
 
 fn fake_pkg_config_path() -> PathBuf {
@@ -247,3 +247,61 @@ fn probe_returns_executable_not_found_for_missing_binary() {
         other => panic!("unexpected error: {other:?}"),
     }
 }
+
+#[test]
+fn batch_probe_keeps_request_order_and_per_dependency_errors() {
+    let h = Harness::new();
+    for (name, version) in [("alpha", "1.0.0"), ("gamma", "2.4.0"), ("delta", "0.9.0")] {
+        write_fixture(
+            &h.temp,
+            name,
+            &format!(
+                r#"{{
+                    "version": "{version}",
+                    "cflags": "",
+                    "libs": "-l{name}"
+                }}"#
+            ),
+        );
+    }
+    let specs = [
+        ("alpha", ""),
+        ("missing", ""),
+        ("gamma", "^3"),
+        ("delta", ">=0.9"),
+    ];
+    let requests: Vec<SystemDependencyProbeRequest<'_>> = specs
+        .iter()
+        .map(
+            |&(name, version_requirement)| SystemDependencyProbeRequest {
+                name,
+                version_requirement,
+                tool: &h.tool,
+            },
+        )
+        .collect();
+    let results = probe_system_dependencies(&requests);
+    assert_eq!(results.len(), specs.len());
+
+    let alpha = results[0].as_ref().unwrap();
+    assert_eq!(alpha.name, "alpha");
+    assert_eq!(alpha.flags.ldflags, vec!["-lalpha".to_owned()]);
+    match &results[1] {
+        Err(PkgConfigError::PackageNotFound { name, .. }) => assert_eq!(name, "missing"),
+        other => panic!("unexpected result: {other:?}"),
+    }
+    // A failing neighbor never leaks into another module's outcome:
+    // the mismatch is still classified against `gamma`'s own
+    // installed version.
+    match &results[2] {
+        Err(PkgConfigError::VersionMismatch {
+            name, installed, ..
+        }) => {
+            assert_eq!(name, "gamma");
+            assert_eq!(installed.as_deref(), Some("2.4.0"));
+        }
+        other => panic!("unexpected result: {other:?}"),
+    }
+    let delta = results[3].as_ref().unwrap();
+    assert_eq!(delta.version.as_deref(), Some("0.9.0"));
+}
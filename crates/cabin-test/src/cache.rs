@@ -0,0 +1,316 @@
+//! Test result cache.
+//!
+//! A passing run of a test executable is recorded under a key
+//! derived from everything the run observably depends on: the
+//! executable's bytes, its working directory, its `CABIN_*` env
+//! overlay, its declared `data` inputs, and the arguments the
+//! runner would pass (the case harness).  A later run with the same
+//! key replays the recorded verdict and captured output instead of
+//! executing the binary.
+//!
+//! Each executable owns one entry, `<package>/<target>`, holding the
+//! key it was recorded under.  Storing a new run replaces it, so a
+//! relinked binary's stale result is overwritten rather than left
+//! behind beside the new one.
+//!
+//! Failures are never recorded, so a failing (or flaky) test is
+//! re-checked on every run.  The cache is an optimization, not a
+//! correctness input: any unreadable or malformed entry is a miss,
+//! and failing to write one does not fail the run.
+
+use std::fmt::Write as _;
+use std::fs;
+use std::io;
+use std::path::{Path, PathBuf};
+
+use cabin_core::hash::hash_reader;
+
+use crate::{CapturedOutput, TestExecutable, TestRunStatus};
+
+/// First line of every entry; bump when the layout changes.
+const ENTRY_HEADER: &str = "cabin-test-result 2";
+
+/// A recorded run, as replayed on a cache hit.
+#[derive(Debug, PartialEq, Eq)]
+pub(crate) struct CachedRun {
+    pub(crate) status: TestRunStatus,
+    pub(crate) stdout: CapturedOutput,
+    pub(crate) stderr: CapturedOutput,
+}
+
+/// Cache key of `executable`, or `None` when the executable itself
+/// cannot be read (the run then proceeds uncached and reports the
+/// real problem).
+#[allow(clippy::unnecessary_debug_formatting)] // quoted, so no path can forge another key line
+pub(crate) fn cache_key(executable: &TestExecutable) -> Option<String> {
+    let mut material = String::new();
+    let _ = writeln!(material, "{ENTRY_HEADER}");
+    let binary = hash_reader(fs::File::open(&executable.executable).ok()?).ok()?;
+    let _ = writeln!(material, "executable {binary}");
+    let _ = writeln!(material, "working-dir {:?}", executable.working_dir);
+    let _ = writeln!(material, "harness {:?}", executable.harness);
+    for (key, value) in &executable.env {
+        let _ = writeln!(material, "env {key:?}={value:?}");
+    }
+    for declared in &executable.data {
+        let mut files = Vec::new();
+        collect_files(declared, &mut files);
+        if files.is_empty() {
+            let _ = writeln!(material, "data {declared:?} missing");
+        }
+        for file in files {
+            let digest = fs::File::open(&file)
+                .and_then(hash_reader)
+                .unwrap_or_else(|_| "unreadable".to_owned());
+            let _ = writeln!(material, "data {file:?} {digest}");
+        }
+    }
+    hash_reader(material.as_bytes()).ok()
+}
+
+/// Every regular file at or below `path`, in sorted order.  A
+/// missing path contributes nothing.
+fn collect_files(path: &Path, files: &mut Vec<PathBuf>) {
+    let Ok(metadata) = fs::metadata(path) else {
+        return;
+    };
+    if metadata.is_file() {
+        files.push(path.to_path_buf());
+        return;
+    }
+    let Ok(entries) = fs::read_dir(path) else {
+        return;
+    };
+    let mut children: Vec<PathBuf> = entries.filter_map(|e| e.ok().map(|e| e.path())).collect();
+    children.sort();
+    for child in children {
+        collect_files(&child, files);
+    }
+}
+
+/// The one entry `executable` owns in `dir`.
+fn entry_path(dir: &Path, executable: &TestExecutable) -> PathBuf {
+    dir.join(&executable.package).join(&executable.target)
+}
+
+/// Look up `executable`'s entry in `dir`; a hit only when it was
+/// recorded under `key`.
+pub(crate) fn load(dir: &Path, executable: &TestExecutable, key: &str) -> Option<CachedRun> {
+    let bytes = fs::read(entry_path(dir, executable)).ok()?;
+    let mut rest = bytes.as_slice();
+    if next_line(&mut rest)? != ENTRY_HEADER {
+        return None;
+    }
+    if next_line(&mut rest)?.strip_prefix("key ")? != key {
+        return None;
+    }
+    let status = match next_line(&mut rest)?.strip_prefix("status ")? {
+        "passed" => TestRunStatus::Passed,
+        "signal" => TestRunStatus::Failed { code: None },
+        code => TestRunStatus::Failed {
+            code: Some(code.parse().ok()?),
+        },
+    };
+    let stdout = read_output(&mut rest, "stdout")?;
+    let stderr = read_output(&mut rest, "stderr")?;
+    rest.is_empty().then_some(CachedRun {
+        status,
+        stdout,
+        stderr,
+    })
+}
+
+/// Record a run of `executable` under `key` in `dir`, replacing
+/// whatever run the executable had recorded before.  The entry is
+/// written to a temporary file and renamed into place so a
+/// concurrent reader never sees a torn entry.
+pub(crate) fn store(
+    dir: &Path,
+    executable: &TestExecutable,
+    key: &str,
+    status: TestRunStatus,
+    stdout: &CapturedOutput,
+    stderr: &CapturedOutput,
+) -> io::Result<()> {
+    let mut entry = format!("{ENTRY_HEADER}\nkey {key}\n").into_bytes();
+    entry.extend_from_slice(
+        match status {
+            TestRunStatus::Passed => "status passed\n".to_owned(),
+            TestRunStatus::Failed { code: None } => "status signal\n".to_owned(),
+            TestRunStatus::Failed { code: Some(code) } => format!("status {code}\n"),
+        }
+        .as_bytes(),
+    );
+    write_output(&mut entry, "stdout", stdout);
+    write_output(&mut entry, "stderr", stderr);
+    let path = entry_path(dir, executable);
+    if let Some(parent) = path.parent() {
+        fs::create_dir_all(parent)?;
+    }
+    let staging = path.with_file_name(format!("{}.tmp", executable.target));
+    fs::write(&staging, entry)?;
+    fs::rename(&staging, path)
+}
+
+fn write_output(entry: &mut Vec<u8>, label: &str, output: &CapturedOutput) {
+    entry.extend_from_slice(
+        format!(
+            "{label} {} {} {}\n",
+            output.total_len,
+            output.head.len(),
+            output.tail.len()
+        )
+        .as_bytes(),
+    );
+    entry.extend_from_slice(&output.head);
+    entry.extend_from_slice(&output.tail);
+}
+
+fn read_output(rest: &mut &[u8], label: &str) -> Option<CapturedOutput> {
+    let line = next_line(rest)?;
+    let mut fields = line.strip_prefix(label)?.split_whitespace();
+    let total_len: u64 = fields.next()?.parse().ok()?;
+    let head_len: usize = fields.next()?.parse().ok()?;
+    let tail_len: usize = fields.next()?.parse().ok()?;
+    if rest.len() < head_len + tail_len {
+        return None;
+    }
+    let (head, after_head) = rest.split_at(head_len);
+    let (tail, after_tail) = after_head.split_at(tail_len);
+    *rest = after_tail;
+    Some(CapturedOutput {
+        head: head.to_vec(),
+        tail: tail.to_vec(),
+        total_len,
+        spool_path: None,
+    })
+}
+
+/// Split the next `\n`-terminated UTF-8 line off `rest`.
+fn next_line<'a>(rest: &mut &'a [u8]) -> Option<&'a str> {
+    let end = rest.iter().position(|b| *b == b'\n')?;
+    let line = std::str::from_utf8(&rest[..end]).ok()?;
+    *rest = &rest[end + 1..];
+    Some(line)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::collections::BTreeMap;
+
+    fn executable(dir: &Path) -> TestExecutable {
+        let binary = dir.join("unit_test");
+        fs::write(&binary, b"binary v1").unwrap();
+        fs::create_dir_all(dir.join("fixtures/nested")).unwrap();
+        fs::write(dir.join("fixtures/nested/input.txt"), b"fixture v1").unwrap();
+        TestExecutable {
+            package: "demo".into(),
+            target: "unit_test".into(),
+            executable: binary,
+            working_dir: dir.to_path_buf(),
+            env: BTreeMap::from([("CABIN_PROFILE".to_owned(), "dev".into())]),
+            data: vec![dir.join("fixtures")],
+            harness: None,
+        }
+    }
+
+    #[test]
+    fn key_tracks_binary_env_and_declared_data() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let exe = executable(dir.path());
+        let base = cache_key(&exe).unwrap();
+        assert_eq!(cache_key(&exe).unwrap(), base, "keys are deterministic");
+
+        fs::write(dir.path().join("fixtures/nested/input.txt"), b"fixture v2").unwrap();
+        let data_changed = cache_key(&exe).unwrap();
+        assert_ne!(data_changed, base);
+
+        let mut env_changed = exe.clone();
+        env_changed
+            .env
+            .insert("CABIN_PROFILE".to_owned(), "release".into());
+        assert_ne!(cache_key(&env_changed).unwrap(), data_changed);
+
+        fs::write(&exe.executable, b"binary v2").unwrap();
+        assert_ne!(cache_key(&exe).unwrap(), data_changed);
+
+        // An unreadable executable is uncacheable rather than an error.
+        fs::remove_file(&exe.executable).unwrap();
+        assert_eq!(cache_key(&exe), None);
+    }
+
+    fn passed(dir: &Path, exe: &TestExecutable, key: &str) {
+        store(
+            dir,
+            exe,
+            key,
+            TestRunStatus::Passed,
+            &CapturedOutput::default(),
+            &CapturedOutput::default(),
+        )
+        .unwrap();
+    }
+
+    #[test]
+    fn entries_round_trip_and_reject_corruption() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let cache = dir.path().join("test-cache");
+        let exe = executable(dir.path());
+        let stdout = CapturedOutput {
+            head: b"head\n".to_vec(),
+            tail: b"tail\n".to_vec(),
+            total_len: 42,
+            spool_path: None,
+        };
+        store(
+            &cache,
+            &exe,
+            "abc",
+            TestRunStatus::Passed,
+            &stdout,
+            &CapturedOutput::default(),
+        )
+        .unwrap();
+        assert_eq!(
+            load(&cache, &exe, "abc"),
+            Some(CachedRun {
+                status: TestRunStatus::Passed,
+                stdout,
+                stderr: CapturedOutput::default(),
+            })
+        );
+        assert_eq!(load(&cache, &exe, "other"), None);
+
+        fs::write(
+            cache.join("demo/unit_test"),
+            b"cabin-test-result 2\nkey abc\nstatus passed\nstdout 9 9 0\nshort",
+        )
+        .unwrap();
+        assert_eq!(load(&cache, &exe, "abc"), None);
+    }
+
+    #[test]
+    fn storing_replaces_the_executables_previous_entry() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let cache = dir.path().join("test-cache");
+        let exe = executable(dir.path());
+        let mut other = exe.clone();
+        other.target = "other_test".into();
+
+        passed(&cache, &exe, "v1");
+        passed(&cache, &other, "w1");
+        // A relinked binary records under a new key ...
+        passed(&cache, &exe, "v2");
+        assert!(load(&cache, &exe, "v2").is_some());
+        // ... and its stale entry is gone, not kept beside it.
+        assert_eq!(load(&cache, &exe, "v1"), None);
+        let entries: Vec<_> = fs::read_dir(cache.join("demo"))
+            .unwrap()
+            .map(|entry| entry.unwrap().file_name())
+            .collect();
+        assert_eq!(entries.len(), 2, "one entry per executable: {entries:?}");
+        // Other executables keep theirs.
+        assert!(load(&cache, &other, "w1").is_some());
+    }
+}
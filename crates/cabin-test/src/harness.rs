@@ -0,0 +1,455 @@
+//! In-binary test-case harnesses: listing the cases inside a test
+//! binary, selecting a batch of them on its command line, reading
+//! per-case timings back out of its output, and splitting a case
+//! list into batches that balance across worker processes.
+//!
+//! Everything here is harness-specific text handling; process
+//! management stays in the crate root.
+
+use std::collections::BTreeMap;
+use std::fs;
+use std::io;
+use std::path::Path;
+use std::time::Duration;
+
+use cabin_core::TestHarness;
+
+/// Upper bound on the bytes of case names packed into one batch's
+/// filter argument.  Well under Linux's 128 KiB per-argument limit
+/// and Windows' 32 KiB command line, so a binary with thousands of
+/// cases is split into more batches rather than failing to spawn.
+pub(crate) const MAX_FILTER_BYTES: usize = 16 * 1024;
+
+/// Estimated cost of a case with no recorded timing when nothing
+/// else about its executable is known.
+const DEFAULT_CASE_COST: Duration = Duration::from_millis(1);
+
+/// Arguments that make a test binary print its case list.
+pub(crate) fn list_args(harness: &TestHarness) -> Vec<String> {
+    match harness {
+        TestHarness::Gtest => vec!["--gtest_list_tests".to_owned()],
+        TestHarness::Catch2 => vec![
+            "--list-tests".to_owned(),
+            "--verbosity".to_owned(),
+            "quiet".to_owned(),
+        ],
+        TestHarness::Custom(custom) => custom.list.clone(),
+    }
+}
+
+/// Parse the stdout of a [`list_args`] invocation into full case
+/// names, in listing order.
+pub(crate) fn parse_case_list(harness: &TestHarness, listing: &str) -> Vec<String> {
+    match harness {
+        TestHarness::Gtest => parse_gtest_list(listing),
+        TestHarness::Catch2 | TestHarness::Custom(_) => listing
+            .lines()
+            .map(str::trim)
+            .filter(|line| !line.is_empty())
+            .map(str::to_owned)
+            .collect(),
+    }
+}
+
+/// `--gtest_list_tests` prints each suite as an unindented
+/// `Suite.` line followed by its indented case names, optionally
+/// annotated with `# GetParam() = ...` / `# TypeParam = ...`.
+/// Unindented lines that are not suite headers (a `main()` banner,
+/// for instance) are ignored.
+fn parse_gtest_list(listing: &str) -> Vec<String> {
+    let mut suite: Option<&str> = None;
+    let mut cases = Vec::new();
+    for line in listing.lines() {
+        let entry = line.split_once('#').map_or(line, |(name, _)| name);
+        if entry.starts_with([' ', '\t']) {
+            let case = entry.trim();
+            if let Some(suite) = suite
+                && !case.is_empty()
+            {
+                cases.push(format!("{suite}{case}"));
+            }
+        } else {
+            suite = Some(entry.trim_end()).filter(|s| s.len() > 1 && s.ends_with('.'));
+        }
+    }
+    cases
+}
+
+/// Arguments that run exactly `cases`.  Catch2 additionally gets
+/// `--durations yes` so its output carries per-case timings.
+pub(crate) fn filter_args(harness: &TestHarness, cases: &[String]) -> Vec<String> {
+    match harness {
+        TestHarness::Gtest => vec![format!("--gtest_filter={}", cases.join(":"))],
+        TestHarness::Catch2 => {
+            let specs: Vec<String> = cases.iter().map(|c| escape_catch2_spec(c)).collect();
+            vec![specs.join(","), "--durations".to_owned(), "yes".to_owned()]
+        }
+        TestHarness::Custom(custom) => {
+            vec![custom.filter.replace("{}", &cases.join(&custom.separator))]
+        }
+    }
+}
+
+/// Bytes `case` contributes to its batch's filter argument,
+/// separator included.
+fn filter_cost(harness: &TestHarness, case: &str) -> usize {
+    match harness {
+        TestHarness::Gtest => case.len() + 1,
+        TestHarness::Catch2 => escape_catch2_spec(case).len() + 1,
+        TestHarness::Custom(custom) => case.len() + custom.separator.len(),
+    }
+}
+
+/// Escape the characters Catch2's test-spec parser treats
+/// specially so a listed name matches only itself.
+fn escape_catch2_spec(case: &str) -> String {
+    let mut spec = String::with_capacity(case.len());
+    for ch in case.chars() {
+        if matches!(ch, '\\' | ',' | '[' | ']' | '*' | '~' | '"') {
+            spec.push('\\');
+        }
+        spec.push(ch);
+    }
+    spec
+}
+
+/// Extract `(case, duration)` from one line of a filtered run's
+/// stdout: gtest's `[       OK ] Suite.Case (12 ms)` /
+/// `[  FAILED  ] Suite.Case (12 ms)` result lines and Catch2's
+/// `0.012 s: case name` durations.  Custom harnesses report none;
+/// their cases are timed by batch.
+pub(crate) fn parse_case_timing(harness: &TestHarness, line: &str) -> Option<(String, Duration)> {
+    match harness {
+        TestHarness::Gtest => {
+            let rest = line
+                .strip_prefix("[       OK ] ")
+                .or_else(|| line.strip_prefix("[  FAILED  ] "))?;
+            let (case, millis) = rest.strip_suffix(" ms)")?.rsplit_once(" (")?;
+            Some((case.to_owned(), Duration::from_millis(millis.parse().ok()?)))
+        }
+        TestHarness::Catch2 => {
+            let (secs, case) = line.split_once(" s: ")?;
+            let secs: f64 = secs.trim().parse().ok()?;
+            Duration::try_from_secs_f64(secs)
+                .ok()
+                .map(|d| (case.to_owned(), d))
+        }
+        TestHarness::Custom(_) => None,
+    }
+}
+
+/// Split `cases` into batches for `workers` worker processes.
+///
+/// Cases are dealt longest-estimate-first onto `workers` bins,
+/// each case going to the currently lightest bin, so the bins
+/// finish at roughly the same time; a bin whose filter would
+/// exceed [`MAX_FILTER_BYTES`] is cut into several batches.
+/// Batches come back heaviest first: workers pulling from the
+/// front start the long batches early and the short ones fill
+/// the tail.  Estimates come from `timings`; unrecorded cases
+/// cost the mean of the recorded ones.
+pub(crate) fn partition(
+    harness: &TestHarness,
+    cases: Vec<String>,
+    timings: Option<&BTreeMap<String, Duration>>,
+    workers: usize,
+) -> Vec<Vec<String>> {
+    let known: Vec<Duration> = timings
+        .map(|t| cases.iter().filter_map(|c| t.get(c).copied()).collect())
+        .unwrap_or_default();
+    let fallback = match u32::try_from(known.len()) {
+        Ok(n) if n > 0 => known.iter().sum::<Duration>() / n,
+        _ => DEFAULT_CASE_COST,
+    };
+    let mut estimated: Vec<(Duration, String)> = cases
+        .into_iter()
+        .map(|case| {
+            let cost = timings
+                .and_then(|t| t.get(&case).copied())
+                .unwrap_or(fallback);
+            (cost, case)
+        })
+        .collect();
+    estimated.sort_by(|a, b| b.0.cmp(&a.0).then_with(|| a.1.cmp(&b.1)));
+
+    let mut bins: Vec<(Duration, Vec<(Duration, String)>)> =
+        vec![(Duration::ZERO, Vec::new()); workers.clamp(1, estimated.len().max(1))];
+    for (cost, case) in estimated {
+        let lightest = bins
+            .iter_mut()
+            .min_by_key(|(load, _)| *load)
+            .expect("at least one bin");
+        lightest.0 += cost;
+        lightest.1.push((cost, case));
+    }
+
+    let mut batches: Vec<(Duration, Vec<String>)> = Vec::new();
+    for (_, bin) in bins {
+        let mut batch: (Duration, Vec<String>) = (Duration::ZERO, Vec::new());
+        let mut bytes = 0;
+        for (cost, case) in bin {
+            let case_bytes = filter_cost(harness, &case);
+            if !batch.1.is_empty() && bytes + case_bytes > MAX_FILTER_BYTES {
+                batches.push(std::mem::take(&mut batch));
+                bytes = 0;
+            }
+            bytes += case_bytes;
+            batch.0 += cost;
+            batch.1.push(case);
+        }
+        if !batch.1.is_empty() {
+            batches.push(batch);
+        }
+    }
+    batches.sort_by(|a, b| b.0.cmp(&a.0));
+    batches.into_iter().map(|(_, cases)| cases).collect()
+}
+
+/// Splits a byte stream into lines for [`parse_case_timing`].
+/// Lines longer than [`MAX_SCANNED_LINE`] are truncated, which at
+/// worst loses one timing.
+#[derive(Debug, Default)]
+pub(crate) struct LineScanner {
+    partial: Vec<u8>,
+}
+
+/// Longest line prefix [`LineScanner`] buffers.
+const MAX_SCANNED_LINE: usize = 4096;
+
+impl LineScanner {
+    /// Feed `bytes`, calling `on_line` for every completed UTF-8
+    /// line (without its `\n` / `\r\n` terminator).
+    pub(crate) fn feed(&mut self, bytes: &[u8], mut on_line: impl FnMut(&str)) {
+        for chunk in bytes.split_inclusive(|b| *b == b'\n') {
+            let (content, complete) = match chunk.strip_suffix(b"\n") {
+                Some(content) => (content, true),
+                None => (chunk, false),
+            };
+            let room = MAX_SCANNED_LINE.saturating_sub(self.partial.len());
+            self.partial
+                .extend_from_slice(&content[..content.len().min(room)]);
+            if complete {
+                if let Ok(line) = std::str::from_utf8(&self.partial) {
+                    on_line(line.strip_suffix('\r').unwrap_or(line));
+                }
+                self.partial.clear();
+            }
+        }
+    }
+}
+
+/// Recorded per-case durations of harnessed test executables,
+/// keyed by `<package>:<target>` and case name.
+///
+/// Persisted as one `<key>\t<micros>\t<case>` line per case.  The
+/// file is a scheduling hint, not a correctness input: a missing
+/// or unreadable file loads as empty and malformed lines are
+/// skipped.
+#[derive(Debug, Default, PartialEq, Eq)]
+pub(crate) struct CaseTimings {
+    by_executable: BTreeMap<String, BTreeMap<String, Duration>>,
+}
+
+impl CaseTimings {
+    pub(crate) fn load(path: &Path) -> Self {
+        let mut timings = Self::default();
+        let Ok(text) = fs::read_to_string(path) else {
+            return timings;
+        };
+        for line in text.lines() {
+            let mut fields = line.splitn(3, '\t');
+            let (Some(key), Some(micros), Some(case)) =
+                (fields.next(), fields.next(), fields.next())
+            else {
+                continue;
+            };
+            let Ok(micros) = micros.parse() else {
+                continue;
+            };
+            timings
+                .by_executable
+                .entry(key.to_owned())
+                .or_default()
+                .insert(case.to_owned(), Duration::from_micros(micros));
+        }
+        timings
+    }
+
+    pub(crate) fn save(&self, path: &Path) -> io::Result<()> {
+        use std::fmt::Write as _;
+
+        let mut text = String::new();
+        for (key, cases) in &self.by_executable {
+            for (case, duration) in cases {
+                let _ = writeln!(text, "{key}\t{}\t{case}", duration.as_micros());
+            }
+        }
+        if let Some(parent) = path.parent() {
+            fs::create_dir_all(parent)?;
+        }
+        fs::write(path, text)
+    }
+
+    pub(crate) fn get(&self, key: &str) -> Option<&BTreeMap<String, Duration>> {
+        self.by_executable.get(key)
+    }
+
+    /// Replace `key`'s timings with `cases`, dropping cases the
+    /// executable no longer has.  Names that cannot round-trip
+    /// through the line format are not recorded.
+    pub(crate) fn replace(&mut self, key: &str, mut cases: BTreeMap<String, Duration>) {
+        cases.retain(|case, _| !case.contains(['\t', '\n', '\r']));
+        self.by_executable.insert(key.to_owned(), cases);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use cabin_core::CustomTestHarness;
+
+    fn custom() -> TestHarness {
+        TestHarness::Custom(CustomTestHarness {
+            list: vec!["--list-test-cases".into()],
+            filter: "--test-case={}".into(),
+            separator: ",".into(),
+        })
+    }
+
+    #[test]
+    fn gtest_listing_joins_suites_and_strips_param_annotations() {
+        let listing = "Running main() from gtest_main.cc\n\
+                       Math.\n  \
+                         Adds\n  \
+                         Subtracts\n\
+                       Sizes/Param.\n  \
+                         Holds/0  # GetParam() = 1\n  \
+                         Holds/1  # GetParam() = 2\n";
+        assert_eq!(
+            parse_case_list(&TestHarness::Gtest, listing),
+            vec![
+                "Math.Adds",
+                "Math.Subtracts",
+                "Sizes/Param.Holds/0",
+                "Sizes/Param.Holds/1"
+            ]
+        );
+    }
+
+    #[test]
+    fn filter_args_select_exactly_the_batch() {
+        let cases = vec!["a, b [x]".to_owned(), "plain".to_owned()];
+        assert_eq!(
+            filter_args(&TestHarness::Gtest, &cases),
+            vec!["--gtest_filter=a, b [x]:plain"]
+        );
+        assert_eq!(
+            filter_args(&TestHarness::Catch2, &cases),
+            vec![r"a\, b \[x\],plain", "--durations", "yes"]
+        );
+        assert_eq!(
+            filter_args(&custom(), &cases),
+            vec!["--test-case=a, b [x],plain"]
+        );
+    }
+
+    #[test]
+    fn case_timings_are_read_from_gtest_and_catch2_output() {
+        assert_eq!(
+            parse_case_timing(&TestHarness::Gtest, "[       OK ] Math.Adds (12 ms)"),
+            Some(("Math.Adds".to_owned(), Duration::from_millis(12)))
+        );
+        assert_eq!(
+            parse_case_timing(&TestHarness::Gtest, "[  FAILED  ] Math.Sub (3 ms)"),
+            Some(("Math.Sub".to_owned(), Duration::from_millis(3)))
+        );
+        // The end-of-run failure recap carries no duration.
+        assert_eq!(
+            parse_case_timing(&TestHarness::Gtest, "[  FAILED  ] Math.Sub"),
+            None
+        );
+        assert_eq!(
+            parse_case_timing(&TestHarness::Catch2, "0.250 s: vectors can be sized"),
+            Some((
+                "vectors can be sized".to_owned(),
+                Duration::from_millis(250)
+            ))
+        );
+        assert_eq!(parse_case_timing(&custom(), "0.250 s: x"), None);
+    }
+
+    #[test]
+    fn partition_balances_recorded_costs_across_workers() {
+        let timings: BTreeMap<String, Duration> = [
+            ("slow".to_owned(), Duration::from_secs(6)),
+            ("mid".to_owned(), Duration::from_secs(3)),
+            ("a".to_owned(), Duration::from_secs(1)),
+            ("b".to_owned(), Duration::from_secs(1)),
+            ("c".to_owned(), Duration::from_secs(1)),
+        ]
+        .into_iter()
+        .collect();
+        let cases = ["a", "b", "c", "mid", "slow", "new"]
+            .map(str::to_owned)
+            .to_vec();
+        let batches = partition(&TestHarness::Gtest, cases, Some(&timings), 2);
+        // `new` is unrecorded and costs the 2.4s mean of the
+        // recorded cases: 3+2.4+1+1 = 7.4s runs beside 6+1 = 7s.
+        assert_eq!(
+            batches,
+            vec![vec!["mid", "new", "a", "c"], vec!["slow", "b"]]
+        );
+    }
+
+    #[test]
+    fn partition_without_timings_deals_cases_evenly() {
+        let cases: Vec<String> = (0..5).map(|i| format!("case{i}")).collect();
+        let batches = partition(&TestHarness::Gtest, cases, None, 8);
+        assert_eq!(batches.len(), 5);
+        assert!(batches.iter().all(|b| b.len() == 1));
+    }
+
+    #[test]
+    fn partition_cuts_batches_that_outgrow_the_filter_budget() {
+        let long = "x".repeat(MAX_FILTER_BYTES / 2);
+        let cases: Vec<String> = (0..4).map(|i| format!("{long}{i}")).collect();
+        let batches = partition(&TestHarness::Gtest, cases, None, 1);
+        assert_eq!(batches.len(), 4);
+    }
+
+    #[test]
+    fn line_scanner_reassembles_lines_across_chunks() {
+        let mut scanner = LineScanner::default();
+        let mut lines = Vec::new();
+        scanner.feed(b"[       OK ] A.", |l| lines.push(l.to_owned()));
+        scanner.feed(b"b (1 ms)\r\nnext\npartial", |l| lines.push(l.to_owned()));
+        assert_eq!(lines, vec!["[       OK ] A.b (1 ms)", "next"]);
+    }
+
+    #[test]
+    fn case_timings_round_trip_and_drop_unencodable_names() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let path = dir.path().join("case-timings.tsv");
+        let mut timings = CaseTimings::default();
+        timings.replace(
+            "demo:unit",
+            [
+                ("Math.Adds".to_owned(), Duration::from_micros(1500)),
+                ("bad\tname".to_owned(), Duration::from_micros(1)),
+            ]
+            .into_iter()
+            .collect(),
+        );
+        timings.save(&path).unwrap();
+        let loaded = CaseTimings::load(&path);
+        assert_eq!(loaded, timings);
+        assert_eq!(
+            loaded.get("demo:unit").unwrap().keys().collect::<Vec<_>>(),
+            vec!["Math.Adds"]
+        );
+        assert_eq!(
+            CaseTimings::load(&dir.path().join("missing")),
+            CaseTimings::default()
+        );
+    }
+}
@@ -1,5 +1,4 @@
-//! Test plan + sequential test runner for Cabin's `test`
-//! targets.
+//! Test plan + test runner for Cabin's `test` targets.
 //!
 //! `cabin test` is intentionally a thin layer on top of the
 //! existing build pipeline:
@@ -9,9 +8,13 @@
 //!    machinery is invented here.
 //! 2. This crate turns the resulting [`cabin_build::BuildGraph`]
 //!    into a deterministic [`TestPlan`].
-//! 3. [`run_tests`] executes the plan sequentially, captures
-//!    stdout / stderr from each test executable, and produces a
-//!    [`TestSummary`] describing what passed and what failed.
+//! 3. [`run_tests`] executes the plan one executable at a time -
+//!    splitting an executable with a declared case harness into
+//!    filtered batches on concurrent worker processes - captures
+//!    stdout / stderr from each test executable (bounded in memory,
+//!    spilling the rest to disk - see [`CaptureOptions`]), and
+//!    produces a [`TestSummary`] describing what passed and what
+//!    failed.
 //!
 //! Crate boundary: this crate does not parse manifests, build
 //! dependency graphs, generate Ninja, or know about config /
@@ -19,20 +22,27 @@
 //! finished `BuildGraph` plus the per-package CWD policy to
 //! [`plan_tests`] / [`run_tests`].
 
-use std::collections::{BTreeMap, BTreeSet};
+use std::collections::{BTreeMap, BTreeSet, VecDeque};
 use std::ffi::OsString;
-use std::io::{self, Read, Write};
+use std::fs;
+use std::io::{self, BufWriter, Read, Write};
 use std::path::{Path, PathBuf};
-use std::process::{Command, ExitStatus, Stdio};
+use std::process::{Child, Command, ExitStatus, Stdio};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
 use std::sync::mpsc;
 use std::thread;
 use std::time::{Duration, Instant};
 
 use cabin_build::{BuildGraph, Dialect};
-use cabin_core::TargetKind;
+use cabin_core::{TargetKind, TestHarness};
 use cabin_workspace::{PackageGraph, WorkspacePackage};
 use thiserror::Error;
 
+mod cache;
+mod harness;
+
+use harness::{CaseTimings, LineScanner};
+
 /// One executable in a [`TestPlan`].
 #[derive(Debug, Clone, PartialEq, Eq)]
 pub struct TestExecutable {
@@ -54,6 +64,13 @@ pub struct TestExecutable {
     /// that do not populate the overlay see the inherited
     /// environment unchanged.
     pub env: BTreeMap<String, OsString>,
+    /// Absolute paths of the target's declared `data` inputs:
+    /// files or directories the test reads at run time.  Their
+    /// contents are part of the executable's test-cache key.
+    pub data: Vec<PathBuf>,
+    /// The target's declared in-binary case harness, which lets
+    /// [`run_tests`] split the executable across worker processes.
+    pub harness: Option<TestHarness>,
 }
 
 /// A finalized, ordered list of `test` executables to run.
@@ -68,6 +85,18 @@ pub struct TestPlan {
 }
 
 impl TestPlan {
+    /// A plan of `executables`, run in the given order.  Callers
+    /// that want the deterministic package / target order build
+    /// the plan with [`plan_tests`] instead.
+    pub fn new(executables: Vec<TestExecutable>) -> Self {
+        Self { executables }
+    }
+
+    /// The executables, in run order.
+    pub fn executables(&self) -> &[TestExecutable] {
+        &self.executables
+    }
+
     /// Number of executables to run.
     pub fn len(&self) -> usize {
         self.executables.len()
@@ -112,6 +141,23 @@ pub fn plan_tests(
     package_graph: &PackageGraph,
     build_graph: &BuildGraph,
     selected_packages: Option<&[usize]>,
+) -> TestPlan {
+    plan_executables_of_kind(
+        package_graph,
+        build_graph,
+        selected_packages,
+        TargetKind::Test,
+    )
+}
+
+/// [`plan_tests`] for an arbitrary executable-producing `kind`.
+/// `cabin bench` plans its `bench` targets through this so both
+/// runners agree on which linked binary belongs to which target.
+pub fn plan_executables_of_kind(
+    package_graph: &PackageGraph,
+    build_graph: &BuildGraph,
+    selected_packages: Option<&[usize]>,
+    kind: TargetKind,
 ) -> TestPlan {
     // `default_outputs` are UTF-8 build-graph paths; borrow each as a
     // native `&Path` for the filesystem comparison below.
@@ -130,7 +176,7 @@ pub fn plan_tests(
     for idx in pkg_indices {
         let package = &package_graph.packages[idx];
         for target in &package.package.targets {
-            if target.kind != TargetKind::Test {
+            if target.kind != kind {
                 continue;
             }
             // Skip tests the planner was not asked to build.
@@ -148,6 +194,12 @@ pub fn plan_tests(
                 executable: exe.to_path_buf(),
                 working_dir: package.manifest_dir.clone(),
                 env: BTreeMap::new(),
+                data: target
+                    .data
+                    .iter()
+                    .map(|path| package.manifest_dir.join(path))
+                    .collect(),
+                harness: target.harness.clone(),
             });
         }
     }
@@ -194,10 +246,200 @@ pub struct TestRunResult {
     pub executable: TestExecutable,
     /// Outcome classification (passed / failed).
     pub status: TestRunStatus,
-    /// Captured stdout, in order of arrival.
-    pub stdout: Vec<u8>,
-    /// Captured stderr, in order of arrival.
-    pub stderr: Vec<u8>,
+    /// Captured stdout, bounded per [`CaptureOptions`].
+    pub stdout: CapturedOutput,
+    /// Captured stderr, bounded per [`CaptureOptions`].
+    pub stderr: CapturedOutput,
+    /// Whether the verdict and output were replayed from the test
+    /// cache (see [`TestRunOptions::cache_dir`]) instead of
+    /// running the executable.
+    pub cached: bool,
+}
+
+/// Default per-stream in-memory capture budget: 1 MiB.  Output
+/// beyond it keeps only a head and a tail in memory.
+pub const DEFAULT_CAPTURE_LIMIT: usize = 1024 * 1024;
+
+/// How [`run_tests`] retains each executable's stdout / stderr.
+///
+/// Every chunk is still forwarded to the [`TestOutputSink`] as it
+/// arrives; these options only bound what the returned
+/// [`TestSummary`] keeps alive.  Up to `memory_limit` bytes per
+/// stream are held in memory verbatim.  Past that, the runner
+/// keeps the first and last `memory_limit / 2` bytes and, when
+/// `spool_dir` is set, writes the complete stream to
+/// `<spool_dir>/<package>/<target>.stdout` (resp. `.stderr`).
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct CaptureOptions {
+    /// Bytes per stream held in memory before the runner
+    /// switches to head / tail retention.
+    pub memory_limit: usize,
+    /// Directory for complete copies of streams that exceed
+    /// `memory_limit`.  `None` drops the middle of such streams.
+    pub spool_dir: Option<PathBuf>,
+}
+
+impl Default for CaptureOptions {
+    fn default() -> Self {
+        Self {
+            memory_limit: DEFAULT_CAPTURE_LIMIT,
+            spool_dir: None,
+        }
+    }
+}
+
+/// One captured output stream of a test executable.
+///
+/// Streams that fit the [`CaptureOptions::memory_limit`] are held
+/// whole (`head` followed by `tail`, nothing omitted).  Larger
+/// streams keep only their first and last bytes; the complete
+/// stream is then available at [`CapturedOutput::spool_path`]
+/// when a spool directory was configured.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct CapturedOutput {
+    head: Vec<u8>,
+    tail: Vec<u8>,
+    total_len: u64,
+    spool_path: Option<PathBuf>,
+}
+
+impl CapturedOutput {
+    /// Leading bytes of the stream held in memory.
+    pub fn head(&self) -> &[u8] {
+        &self.head
+    }
+
+    /// Trailing bytes of the stream held in memory.  Contiguous
+    /// with [`CapturedOutput::head`] unless the stream is
+    /// truncated.
+    pub fn tail(&self) -> &[u8] {
+        &self.tail
+    }
+
+    /// Number of bytes the executable wrote to the stream.
+    pub fn total_len(&self) -> u64 {
+        self.total_len
+    }
+
+    /// `true` when the executable wrote nothing to the stream.
+    pub fn is_empty(&self) -> bool {
+        self.total_len == 0
+    }
+
+    /// `true` when bytes between the head and the tail were not
+    /// kept in memory.
+    pub fn is_truncated(&self) -> bool {
+        self.omitted_len() > 0
+    }
+
+    /// Number of bytes between the head and the tail that are not
+    /// held in memory.
+    pub fn omitted_len(&self) -> u64 {
+        self.total_len - (self.head.len() + self.tail.len()) as u64
+    }
+
+    /// File holding the complete stream, when the stream exceeded
+    /// the in-memory budget and a spool directory was configured.
+    pub fn spool_path(&self) -> Option<&Path> {
+        self.spool_path.as_deref()
+    }
+
+    /// The in-memory bytes, head followed by tail.  This is the
+    /// complete stream unless [`CapturedOutput::is_truncated`].
+    pub fn to_vec(&self) -> Vec<u8> {
+        let mut bytes = Vec::with_capacity(self.head.len() + self.tail.len());
+        bytes.extend_from_slice(&self.head);
+        bytes.extend_from_slice(&self.tail);
+        bytes
+    }
+}
+
+/// Accumulates one stream while the executable runs, enforcing the
+/// [`CaptureOptions`] budget.  The spool file is opened lazily the
+/// first time the stream outgrows memory, seeded with everything
+/// held so far, so a spooled file is always the complete stream.
+struct CaptureBuffer {
+    head_cap: usize,
+    tail_cap: usize,
+    head: Vec<u8>,
+    tail: VecDeque<u8>,
+    total_len: u64,
+    spool_path: Option<PathBuf>,
+    spool: Option<BufWriter<fs::File>>,
+}
+
+impl CaptureBuffer {
+    fn new(memory_limit: usize, spool_path: Option<PathBuf>) -> Self {
+        let head_cap = memory_limit / 2;
+        Self {
+            head_cap,
+            tail_cap: memory_limit - head_cap,
+            head: Vec::new(),
+            tail: VecDeque::new(),
+            total_len: 0,
+            spool_path,
+            spool: None,
+        }
+    }
+
+    fn push(&mut self, bytes: &[u8]) -> io::Result<()> {
+        let total_len = self.total_len + bytes.len() as u64;
+        let limit = (self.head_cap + self.tail_cap) as u64;
+        if self.spool.is_none()
+            && total_len > limit
+            && let Some(path) = &self.spool_path
+        {
+            if let Some(parent) = path.parent() {
+                fs::create_dir_all(parent)?;
+            }
+            let mut spool = BufWriter::new(fs::File::create(path)?);
+            spool.write_all(&self.head)?;
+            let (front, back) = self.tail.as_slices();
+            spool.write_all(front)?;
+            spool.write_all(back)?;
+            self.spool = Some(spool);
+        }
+        if let Some(spool) = &mut self.spool {
+            spool.write_all(bytes)?;
+        }
+        self.total_len = total_len;
+
+        let to_head = (self.head_cap - self.head.len()).min(bytes.len());
+        self.head.extend_from_slice(&bytes[..to_head]);
+        let rest = &bytes[to_head..];
+        if rest.len() >= self.tail_cap {
+            self.tail.clear();
+            self.tail.extend(&rest[rest.len() - self.tail_cap..]);
+        } else {
+            self.tail.extend(rest);
+            let excess = self.tail.len().saturating_sub(self.tail_cap);
+            self.tail.drain(..excess);
+        }
+        Ok(())
+    }
+
+    fn finish(self) -> io::Result<CapturedOutput> {
+        let spooled = match self.spool {
+            Some(mut spool) => {
+                spool.flush()?;
+                true
+            }
+            None => false,
+        };
+        Ok(CapturedOutput {
+            head: self.head,
+            tail: self.tail.into(),
+            total_len: self.total_len,
+            spool_path: self.spool_path.filter(|_| spooled),
+        })
+    }
+}
+
+/// Spool file for one stream of `executable` under `spool_dir`.
+fn spool_path(spool_dir: &Path, executable: &TestExecutable, stream: OutputStream) -> PathBuf {
+    spool_dir
+        .join(&executable.package)
+        .join(format!("{}.{}", executable.target, stream.label()))
 }
 
 /// Outcome of one test executable.
@@ -267,7 +509,7 @@ impl TestSummary {
 
 /// Sink for test executable output.  The runner forwards stdout /
 /// stderr chunks to this sink while each process is still
-/// running, and also keeps a full captured copy in
+/// running, and also keeps a bounded captured copy in
 /// [`TestRunResult`].
 pub trait TestOutputSink {
     /// Called zero or more times per executable with stdout bytes.
@@ -345,17 +587,59 @@ impl<W1: Write, W2: Write> TestOutputSink for StreamingSink<W1, W2> {
     }
 }
 
-/// Run every executable in `plan` sequentially in the order
-/// produced by [`plan_tests`].  Each test runs to completion
-/// before the next starts; the runner does not introduce
-/// parallelism in this release.  The returned [`TestSummary`]
-/// preserves the plan's order so output stays deterministic.
+/// Options for [`run_tests`].
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct TestRunOptions {
+    /// How much of each executable's output the summary retains.
+    pub capture: CaptureOptions,
+    /// Worker processes one harnessed executable's cases are split
+    /// across (see [`TestExecutable::harness`]).  `1` runs every
+    /// executable as a single process.
+    pub test_threads: usize,
+    /// File recording per-case durations of harnessed executables.
+    /// Read to balance the case split, rewritten after the run.
+    /// `None` splits cases evenly and records nothing.
+    pub case_timings: Option<PathBuf>,
+    /// Directory of the test result cache.  An executable whose
+    /// binary, env overlay, working directory, declared `data`
+    /// inputs and harness all match an earlier passing run is not
+    /// executed; the recorded verdict and output are replayed
+    /// instead.  Failures are never cached.  `None` runs every
+    /// executable.
+    pub cache_dir: Option<PathBuf>,
+}
+
+impl Default for TestRunOptions {
+    fn default() -> Self {
+        Self {
+            capture: CaptureOptions::default(),
+            test_threads: 1,
+            case_timings: None,
+            cache_dir: None,
+        }
+    }
+}
+
+/// Run every executable in `plan` in the order produced by
+/// [`plan_tests`].  Each executable runs to completion before the
+/// next starts, and the returned [`TestSummary`] preserves the
+/// plan's order so output stays deterministic.
+///
+/// An executable with a [`TestExecutable::harness`] is split when
+/// `options.test_threads > 1`: the runner lists its cases, deals
+/// them into filtered batches balanced by the recorded per-case
+/// timings, runs the batches on up to `test_threads` concurrent
+/// processes, and merges them back into one [`TestRunResult`] that
+/// fails if any batch failed.  An executable whose listing fails
+/// or yields fewer than two cases runs whole.
 ///
 /// A test executable's stdout / stderr are forwarded to `sink`
-/// while the process is running and also captured to memory for
-/// the returned summary.  Streaming sinks (see [`StreamingSink`])
+/// while the process is running and also captured for the
+/// returned summary within the `options.capture` budget (see
+/// [`CaptureOptions`]).  Streaming sinks (see [`StreamingSink`])
 /// write a header for each non-empty output chunk so multi-test
-/// runs are easy to read.
+/// runs are easy to read; the chunks of concurrent batches
+/// interleave.
 ///
 /// # Panics
 ///
@@ -365,91 +649,391 @@ impl<W1: Write, W2: Write> TestOutputSink for StreamingSink<W1, W2> {
 /// # Errors
 /// Returns [`TestRunError`]: `Spawn` if a test executable cannot be
 /// started, `Wait` if waiting on a running child fails, `OutputIo`
-/// if reading the child's stdout/stderr fails, and `SinkIo` if
-/// forwarding captured output to `sink` fails (propagated from the
-/// sink's `write_stdout` / `write_stderr`).
+/// if reading the child's stdout/stderr fails, `SpoolIo` if writing
+/// or clearing a spool file fails, and `SinkIo` if forwarding
+/// captured output to `sink` fails (propagated from the sink's
+/// `write_stdout` / `write_stderr`).
 pub fn run_tests<S: TestOutputSink>(
     plan: &TestPlan,
+    options: &TestRunOptions,
     sink: &mut S,
 ) -> Result<TestSummary, TestRunError> {
     let started = Instant::now();
+    let capture = &options.capture;
+    let mut timings = options.case_timings.as_deref().map(CaseTimings::load);
+    let mut timings_changed = false;
     let mut results: Vec<TestRunResult> = Vec::with_capacity(plan.executables.len());
     for executable in &plan.executables {
-        let mut command = Command::new(&executable.executable);
-        command.current_dir(&executable.working_dir);
-        command.stdout(Stdio::piped()).stderr(Stdio::piped());
-        // Tests inherit the user's PATH plus whatever Cabin's
-        // own caller has set, with the per-executable env
-        // overlay applied on top so the orchestration layer can
-        // surface deterministic CABIN_* values without forcing
-        // every test fixture to re-derive them.
-        for (key, value) in &executable.env {
-            command.env(key, value);
+        let cache_key = options
+            .cache_dir
+            .as_ref()
+            .and_then(|_| cache::cache_key(executable));
+        let hit = options
+            .cache_dir
+            .as_deref()
+            .zip(cache_key.as_deref())
+            .and_then(|(dir, key)| cache::load(dir, executable, key));
+        if let Some(hit) = hit {
+            let result = replay_cached(executable, hit, sink)?;
+            sink.test_finished(&result).map_err(TestRunError::SinkIo)?;
+            results.push(result);
+            continue;
         }
-        // The registry credential is Cabin's input, not the test's:
-        // scrub it so arbitrary test code can never read the token.
-        command.env_remove(cabin_env::CABIN_REGISTRY_TOKEN);
-        // Retry on `ETXTBSY`: a sibling thread that forks while we
-        // are mid-`write`/`chmod` of another executable can leave a
-        // writable fd to this file briefly inherited in its
-        // not-yet-`execve`d child, which makes our own `execve`
-        // race-fail.  The window clears within milliseconds.
-        let mut child = retry_on_etxtbsy(SPAWN_RETRY_ATTEMPTS, SPAWN_RETRY_BASE_DELAY, || {
-            command.spawn()
-        })
-        .map_err(|source| TestRunError::Spawn {
-            package: executable.package.clone(),
-            target: executable.target.clone(),
-            executable: executable.executable.clone(),
-            source,
-        })?;
-
-        let stdout = child
-            .stdout
-            .take()
-            .expect("stdout is piped before child spawn");
-        let stderr = child
-            .stderr
-            .take()
-            .expect("stderr is piped before child spawn");
-        let (tx, rx) = mpsc::channel();
-        let stdout_thread = spawn_output_reader(OutputStream::Stdout, stdout, tx.clone());
-        let stderr_thread = spawn_output_reader(OutputStream::Stderr, stderr, tx);
-
-        let mut stdout = Vec::new();
-        let mut stderr = Vec::new();
-        let output_result = forward_output_events(executable, sink, rx, &mut stdout, &mut stderr);
-        if let Err(err) = output_result {
-            let _ = child.kill();
-            let _ = child.wait();
-            let _ = stdout_thread.join();
-            let _ = stderr_thread.join();
-            return Err(err);
+
+        // A spool file left by an earlier run would outlive this
+        // run's (possibly smaller) output; clear it up front so a
+        // spool path in the summary always belongs to this run.
+        let stdout_spool = capture
+            .spool_dir
+            .as_deref()
+            .map(|dir| spool_path(dir, executable, OutputStream::Stdout));
+        let stderr_spool = capture
+            .spool_dir
+            .as_deref()
+            .map(|dir| spool_path(dir, executable, OutputStream::Stderr));
+        for path in [&stdout_spool, &stderr_spool].into_iter().flatten() {
+            remove_stale_spool(path)?;
         }
-        let status = child.wait().map_err(|source| TestRunError::Wait {
-            package: executable.package.clone(),
-            target: executable.target.clone(),
-            executable: executable.executable.clone(),
-            source,
-        })?;
-        let _ = stdout_thread.join();
-        let _ = stderr_thread.join();
+        let mut stdout = CaptureBuffer::new(capture.memory_limit, stdout_spool);
+        let mut stderr = CaptureBuffer::new(capture.memory_limit, stderr_spool);
+
+        let cases = match &executable.harness {
+            Some(harness) if options.test_threads > 1 => list_cases(executable, harness)?
+                .filter(|cases| cases.len() > 1)
+                .map(|cases| (harness, cases)),
+            _ => None,
+        };
+        let status = match cases {
+            Some((harness, cases)) => {
+                let key = format!("{}:{}", executable.package, executable.target);
+                let recorded = timings.as_ref().and_then(|t| t.get(&key));
+                let batches = harness::partition(harness, cases, recorded, options.test_threads);
+                let split = ShardedRun {
+                    executable,
+                    harness,
+                    batches: &batches,
+                    workers: options.test_threads,
+                };
+                let (status, case_times) = split.run(sink, &mut stdout, &mut stderr)?;
+                if let Some(timings) = &mut timings {
+                    timings.replace(&key, case_times);
+                    timings_changed = true;
+                }
+                status
+            }
+            None => run_whole(executable, sink, &mut stdout, &mut stderr)?,
+        };
 
         let result = TestRunResult {
             executable: executable.clone(),
-            status: TestRunStatus::from_status(status),
-            stdout,
-            stderr,
+            status,
+            stdout: finish_capture(stdout)?,
+            stderr: finish_capture(stderr)?,
+            cached: false,
         };
+        // Like the timings file, the cache is best-effort: an entry
+        // that cannot be written only costs the next run a re-run.
+        if let (Some(dir), Some(key)) = (&options.cache_dir, &cache_key)
+            && result.status == TestRunStatus::Passed
+        {
+            let _ = cache::store(
+                dir,
+                executable,
+                key,
+                result.status,
+                &result.stdout,
+                &result.stderr,
+            );
+        }
         sink.test_finished(&result).map_err(TestRunError::SinkIo)?;
         results.push(result);
     }
+    // The timings file only steers future case splits; failing to
+    // rewrite it must not fail a run whose tests all finished.
+    if let (Some(timings), Some(path)) = (&timings, &options.case_timings)
+        && timings_changed
+    {
+        let _ = timings.save(path);
+    }
     Ok(TestSummary {
         results,
         elapsed: started.elapsed(),
     })
 }
 
+/// Forward a cached run's output to `sink` as if the executable had
+/// just produced it, and wrap it up as a [`TestRunResult`].
+fn replay_cached<S: TestOutputSink>(
+    executable: &TestExecutable,
+    hit: cache::CachedRun,
+    sink: &mut S,
+) -> Result<TestRunResult, TestRunError> {
+    for (output, stream) in [
+        (&hit.stdout, OutputStream::Stdout),
+        (&hit.stderr, OutputStream::Stderr),
+    ] {
+        let mut chunks = vec![output.head().to_vec()];
+        if output.is_truncated() {
+            chunks.push(format!("\n... {} bytes omitted ...\n", output.omitted_len()).into_bytes());
+            chunks.push(output.tail().to_vec());
+        }
+        for chunk in chunks.iter().filter(|chunk| !chunk.is_empty()) {
+            match stream {
+                OutputStream::Stdout => sink.write_stdout(executable, chunk),
+                OutputStream::Stderr => sink.write_stderr(executable, chunk),
+            }
+            .map_err(TestRunError::SinkIo)?;
+        }
+    }
+    Ok(TestRunResult {
+        executable: executable.clone(),
+        status: hit.status,
+        stdout: hit.stdout,
+        stderr: hit.stderr,
+        cached: true,
+    })
+}
+
+/// Base command for one invocation of `executable`.
+fn test_command(executable: &TestExecutable) -> Command {
+    let mut command = Command::new(&executable.executable);
+    command.current_dir(&executable.working_dir);
+    // Tests inherit the user's PATH plus whatever Cabin's
+    // own caller has set, with the per-executable env
+    // overlay applied on top so the orchestration layer can
+    // surface deterministic CABIN_* values without forcing
+    // every test fixture to re-derive them.
+    for (key, value) in &executable.env {
+        command.env(key, value);
+    }
+    // The registry credential is Cabin's input, not the test's:
+    // scrub it so arbitrary test code can never read the token.
+    command.env_remove(cabin_env::CABIN_REGISTRY_TOKEN);
+    command
+}
+
+/// Spawn `command` with piped stdout / stderr.
+fn spawn_test(executable: &TestExecutable, command: &mut Command) -> Result<Child, TestRunError> {
+    command.stdout(Stdio::piped()).stderr(Stdio::piped());
+    // Retry on `ETXTBSY`: a sibling thread that forks while we
+    // are mid-`write`/`chmod` of another executable can leave a
+    // writable fd to this file briefly inherited in its
+    // not-yet-`execve`d child, which makes our own `execve`
+    // race-fail.  The window clears within milliseconds.
+    retry_on_etxtbsy(SPAWN_RETRY_ATTEMPTS, SPAWN_RETRY_BASE_DELAY, || {
+        command.spawn()
+    })
+    .map_err(|source| TestRunError::Spawn {
+        package: executable.package.clone(),
+        target: executable.target.clone(),
+        executable: executable.executable.clone(),
+        source,
+    })
+}
+
+fn wait_error(executable: &TestExecutable, source: io::Error) -> TestRunError {
+    TestRunError::Wait {
+        package: executable.package.clone(),
+        target: executable.target.clone(),
+        executable: executable.executable.clone(),
+        source,
+    }
+}
+
+/// Run `executable` as a single process.
+fn run_whole<S: TestOutputSink>(
+    executable: &TestExecutable,
+    sink: &mut S,
+    stdout: &mut CaptureBuffer,
+    stderr: &mut CaptureBuffer,
+) -> Result<TestRunStatus, TestRunError> {
+    let mut child = spawn_test(executable, &mut test_command(executable))?;
+    let (tx, rx) = mpsc::channel();
+    let readers = spawn_output_readers(&mut child, 0, &tx);
+    drop(tx);
+
+    let output_result = forward_output_events(executable, sink, rx, stdout, stderr, |_| {});
+    if let Err(err) = output_result {
+        let _ = child.kill();
+        let _ = child.wait();
+        for reader in readers {
+            let _ = reader.join();
+        }
+        return Err(err);
+    }
+    let status = child
+        .wait()
+        .map_err(|source| wait_error(executable, source))?;
+    for reader in readers {
+        let _ = reader.join();
+    }
+    Ok(TestRunStatus::from_status(status))
+}
+
+/// List the cases of a harnessed executable.  `None` when the
+/// listing invocation exits non-zero: the executable then runs
+/// whole, which surfaces whatever is wrong with it as an ordinary
+/// test failure.
+fn list_cases(
+    executable: &TestExecutable,
+    harness: &TestHarness,
+) -> Result<Option<Vec<String>>, TestRunError> {
+    let mut command = test_command(executable);
+    command.args(harness::list_args(harness));
+    let output = retry_on_etxtbsy(SPAWN_RETRY_ATTEMPTS, SPAWN_RETRY_BASE_DELAY, || {
+        command.output()
+    })
+    .map_err(|source| TestRunError::Spawn {
+        package: executable.package.clone(),
+        target: executable.target.clone(),
+        executable: executable.executable.clone(),
+        source,
+    })?;
+    if !output.status.success() {
+        return Ok(None);
+    }
+    let listing = String::from_utf8_lossy(&output.stdout);
+    Ok(Some(harness::parse_case_list(harness, &listing)))
+}
+
+/// One harnessed executable split into filtered batches.
+struct ShardedRun<'a> {
+    executable: &'a TestExecutable,
+    harness: &'a TestHarness,
+    batches: &'a [Vec<String>],
+    workers: usize,
+}
+
+/// How one batch process ended.
+struct ShardOutcome {
+    index: usize,
+    elapsed: Duration,
+    exit: Result<ExitStatus, TestRunError>,
+}
+
+impl ShardedRun<'_> {
+    /// Run every batch on a scoped pool of `workers` threads, each
+    /// driving one batch process at a time, while this thread
+    /// forwards their output to `sink`.  Returns the merged status
+    /// (the first failing batch's, in batch order) and a duration
+    /// per case: the one the harness printed, else an even share of
+    /// its batch's wall time.
+    fn run<S: TestOutputSink>(
+        &self,
+        sink: &mut S,
+        stdout: &mut CaptureBuffer,
+        stderr: &mut CaptureBuffer,
+    ) -> Result<(TestRunStatus, BTreeMap<String, Duration>), TestRunError> {
+        let next = AtomicUsize::new(0);
+        let abort = AtomicBool::new(false);
+        let mut scanners: BTreeMap<usize, LineScanner> = BTreeMap::new();
+        let mut printed: BTreeMap<String, Duration> = BTreeMap::new();
+        let (tx, rx) = mpsc::channel();
+        let (forwarded, mut shards) = thread::scope(|scope| {
+            let handles: Vec<_> = (0..self.workers.min(self.batches.len()))
+                .map(|_| {
+                    let tx = tx.clone();
+                    let (next, abort) = (&next, &abort);
+                    scope.spawn(move || self.drive_batches(next, abort, &tx))
+                })
+                .collect();
+            drop(tx);
+            let forwarded =
+                forward_output_events(self.executable, sink, rx, stdout, stderr, |event| {
+                    if matches!(event.stream, OutputStream::Stdout) {
+                        let scanner = scanners.entry(event.shard).or_default();
+                        scanner.feed(&event.bytes, |line| {
+                            if let Some((case, took)) =
+                                harness::parse_case_timing(self.harness, line)
+                            {
+                                printed.insert(case, took);
+                            }
+                        });
+                    }
+                });
+            if forwarded.is_err() {
+                abort.store(true, Ordering::Relaxed);
+            }
+            let mut shards = Vec::new();
+            for handle in handles {
+                // A worker never panics short of a bug; re-raise it
+                // on the caller's thread rather than dropping results.
+                shards.extend(
+                    handle
+                        .join()
+                        .unwrap_or_else(|payload| std::panic::resume_unwind(payload)),
+                );
+            }
+            (forwarded, shards)
+        });
+        forwarded?;
+
+        shards.sort_by_key(|shard| shard.index);
+        let mut status = TestRunStatus::Passed;
+        let mut case_times = BTreeMap::new();
+        for shard in shards {
+            let exit = shard.exit?;
+            if status.is_success() {
+                status = TestRunStatus::from_status(exit);
+            }
+            let cases = &self.batches[shard.index];
+            let share = shard.elapsed / u32::try_from(cases.len()).unwrap_or(u32::MAX);
+            for case in cases {
+                let took = printed.get(case).copied().unwrap_or(share);
+                case_times.insert(case.clone(), took);
+            }
+        }
+        Ok((status, case_times))
+    }
+
+    /// Worker loop: claim the next unstarted batch and run it to
+    /// completion until none remain or the run is aborted.
+    fn drive_batches(
+        &self,
+        next: &AtomicUsize,
+        abort: &AtomicBool,
+        tx: &mpsc::Sender<Result<OutputEvent, io::Error>>,
+    ) -> Vec<ShardOutcome> {
+        let mut done = Vec::new();
+        while !abort.load(Ordering::Relaxed) {
+            let index = next.fetch_add(1, Ordering::Relaxed);
+            let Some(cases) = self.batches.get(index) else {
+                break;
+            };
+            let started = Instant::now();
+            let exit = self.run_batch(index, cases, tx);
+            if exit.is_err() {
+                abort.store(true, Ordering::Relaxed);
+            }
+            done.push(ShardOutcome {
+                index,
+                elapsed: started.elapsed(),
+                exit,
+            });
+        }
+        done
+    }
+
+    fn run_batch(
+        &self,
+        index: usize,
+        cases: &[String],
+        tx: &mpsc::Sender<Result<OutputEvent, io::Error>>,
+    ) -> Result<ExitStatus, TestRunError> {
+        let mut command = test_command(self.executable);
+        command.args(harness::filter_args(self.harness, cases));
+        let mut child = spawn_test(self.executable, &mut command)?;
+        let readers = spawn_output_readers(&mut child, index, tx);
+        let status = child
+            .wait()
+            .map_err(|source| wait_error(self.executable, source));
+        for reader in readers {
+            let _ = reader.join();
+        }
+        status
+    }
+}
+
 /// Total spawn attempts before an `ETXTBSY` failure is surfaced.
 const SPAWN_RETRY_ATTEMPTS: u32 = 8;
 /// Backoff before the first spawn retry; doubles on each retry, so
@@ -486,12 +1070,45 @@ enum OutputStream {
     Stderr,
 }
 
+impl OutputStream {
+    const fn label(self) -> &'static str {
+        match self {
+            Self::Stdout => "stdout",
+            Self::Stderr => "stderr",
+        }
+    }
+}
+
 struct OutputEvent {
+    /// Batch that produced the bytes; always `0` for an executable
+    /// that runs whole.
+    shard: usize,
     stream: OutputStream,
     bytes: Vec<u8>,
 }
 
+/// Start the stdout / stderr reader threads of `child`.
+fn spawn_output_readers(
+    child: &mut Child,
+    shard: usize,
+    tx: &mpsc::Sender<Result<OutputEvent, io::Error>>,
+) -> [thread::JoinHandle<()>; 2] {
+    let stdout = child
+        .stdout
+        .take()
+        .expect("stdout is piped before child spawn");
+    let stderr = child
+        .stderr
+        .take()
+        .expect("stderr is piped before child spawn");
+    [
+        spawn_output_reader(shard, OutputStream::Stdout, stdout, tx.clone()),
+        spawn_output_reader(shard, OutputStream::Stderr, stderr, tx.clone()),
+    ]
+}
+
 fn spawn_output_reader<R: Read + Send + 'static>(
+    shard: usize,
     stream: OutputStream,
     mut reader: R,
     tx: mpsc::Sender<Result<OutputEvent, io::Error>>,
@@ -504,6 +1121,7 @@ fn spawn_output_reader<R: Read + Send + 'static>(
                 Ok(n) => {
                     if tx
                         .send(Ok(OutputEvent {
+                            shard,
                             stream,
                             bytes: buf[..n].to_vec(),
                         }))
@@ -521,37 +1139,73 @@ fn spawn_output_reader<R: Read + Send + 'static>(
     })
 }
 
+/// Forward every output event to `sink` and the capture buffers
+/// until all senders hang up, letting `observe` inspect each event
+/// first.
 fn forward_output_events<S: TestOutputSink>(
     executable: &TestExecutable,
     sink: &mut S,
     rx: mpsc::Receiver<Result<OutputEvent, io::Error>>,
-    stdout: &mut Vec<u8>,
-    stderr: &mut Vec<u8>,
+    stdout: &mut CaptureBuffer,
+    stderr: &mut CaptureBuffer,
+    mut observe: impl FnMut(&OutputEvent),
 ) -> Result<(), TestRunError> {
     for event in rx {
         let event = event.map_err(TestRunError::OutputIo)?;
-        match event.stream {
+        observe(&event);
+        let capture = match event.stream {
             OutputStream::Stdout => {
                 sink.write_stdout(executable, &event.bytes)
                     .map_err(TestRunError::SinkIo)?;
-                stdout.extend_from_slice(&event.bytes);
+                &mut *stdout
             }
             OutputStream::Stderr => {
                 sink.write_stderr(executable, &event.bytes)
                     .map_err(TestRunError::SinkIo)?;
-                stderr.extend_from_slice(&event.bytes);
+                &mut *stderr
             }
-        }
+        };
+        capture
+            .push(&event.bytes)
+            .map_err(|source| spool_error(capture, source))?;
     }
     Ok(())
 }
 
+fn remove_stale_spool(path: &Path) -> Result<(), TestRunError> {
+    match fs::remove_file(path) {
+        Ok(()) => Ok(()),
+        Err(err) if err.kind() == io::ErrorKind::NotFound => Ok(()),
+        Err(source) => Err(TestRunError::SpoolIo {
+            path: path.to_path_buf(),
+            source,
+        }),
+    }
+}
+
+fn finish_capture(capture: CaptureBuffer) -> Result<CapturedOutput, TestRunError> {
+    let path = capture.spool_path.clone().unwrap_or_default();
+    capture
+        .finish()
+        .map_err(|source| TestRunError::SpoolIo { path, source })
+}
+
+/// Only the spool file can fail a [`CaptureBuffer::push`], so its
+/// errors are attributed to the buffer's spool path.
+fn spool_error(capture: &CaptureBuffer, source: io::Error) -> TestRunError {
+    TestRunError::SpoolIo {
+        path: capture.spool_path.clone().unwrap_or_default(),
+        source,
+    }
+}
+
 /// Format the `cargo test`-shaped one-line summary:
 /// `test result: ok.  P passed; F failed; 0 ignored; 0 measured;
 /// FO filtered out; finished in T.TTs`.  Centralized here so the
 /// CLI does not invent its own format.
 ///
-/// Cabin has no ignore or benchmark mechanism, so the `ignored`
+/// Cabin has no ignore mechanism and `cabin test` runs no
+/// benchmarks (`cabin bench` does), so the `ignored`
 /// and `measured` fields render as constant zeros to keep the
 /// line shaped exactly like `cargo test`'s. `filtered_out` is
 /// the number of `test` targets the invocation deselected (via
@@ -571,6 +1225,12 @@ pub fn render_summary_line(summary: &TestSummary, filtered_out: usize) -> String
 /// (only when something failed) followed by the summary line,
 /// each preceded by a blank line.  The returned string carries no
 /// trailing newline; callers terminate it themselves.
+///
+/// Output already streamed live is not repeated, except for failed
+/// tests whose output outgrew the capture budget: that output has
+/// likely scrolled far out of view, so its retained head and tail
+/// are replayed ahead of the recap together with the omitted byte
+/// count and the spool file holding the complete stream.
 pub fn render_epilogue(summary: &TestSummary, filtered_out: usize) -> String {
     // Writing into a `String` is infallible, so the `writeln!`
     // results below are safely discarded.
@@ -582,6 +1242,28 @@ pub fn render_epilogue(summary: &TestSummary, filtered_out: usize) -> String {
         .iter()
         .filter(|r| !r.status.is_success())
         .collect();
+    let truncated: Vec<(&TestRunResult, &str, &CapturedOutput)> = failed
+        .iter()
+        .flat_map(|r| [(*r, "stdout", &r.stdout), (*r, "stderr", &r.stderr)])
+        .filter(|(_, _, output)| output.is_truncated())
+        .collect();
+    if !truncated.is_empty() {
+        out.push_str("\nfailures:\n");
+        for (result, label, output) in truncated {
+            let _ = writeln!(
+                out,
+                "\n---- {label}: {}:{} (truncated) ----",
+                result.executable.package, result.executable.target
+            );
+            push_lossy_line(&mut out, output.head());
+            let _ = write!(out, "... {} bytes omitted", output.omitted_len());
+            if let Some(path) = output.spool_path() {
+                let _ = write!(out, "; full output in {}", path.display());
+            }
+            out.push_str(" ...\n");
+            push_lossy_line(&mut out, output.tail());
+        }
+    }
     if !failed.is_empty() {
         out.push_str("\nfailures:\n");
         for result in failed {
@@ -597,10 +1279,22 @@ pub fn render_epilogue(summary: &TestSummary, filtered_out: usize) -> String {
     out
 }
 
+/// Append `bytes` to `out` as (lossy) UTF-8, terminated by a
+/// newline.  A no-op for empty `bytes`.
+fn push_lossy_line(out: &mut String, bytes: &[u8]) {
+    if !bytes.is_empty() {
+        out.push_str(&String::from_utf8_lossy(bytes));
+        if !bytes.ends_with(b"\n") {
+            out.push('\n');
+        }
+    }
+}
+
 /// Render the per-test result line emitted after each executable
 /// finishes.
 pub fn render_result_line(result: &TestRunResult) -> String {
     let label = match result.status {
+        TestRunStatus::Passed if result.cached => "ok (cached)".to_owned(),
         TestRunStatus::Passed => "ok".to_owned(),
         TestRunStatus::Failed { code: Some(c) } => format!("FAILED (exit {c})"),
         TestRunStatus::Failed { code: None } => "FAILED (terminated by signal)".to_owned(),
@@ -636,6 +1330,14 @@ pub enum TestRunError {
     /// Reading stdout / stderr from the child process failed.
     #[error("failed to read captured test output: {0}")]
     OutputIo(#[source] io::Error),
+    /// Writing a spool file for oversized output, or clearing a
+    /// stale one from an earlier run, failed.
+    #[error("failed to spool captured test output to {}: {source}", .path.display())]
+    SpoolIo {
+        path: PathBuf,
+        #[source]
+        source: io::Error,
+    },
     /// Writing captured stdout / stderr to the sink failed.  The
     /// runner stops at the first failure rather than continuing
     /// silently.
@@ -679,6 +1381,8 @@ mod tests {
                     executable: PathBuf::from("/tmp/x"),
                     working_dir: PathBuf::from("/tmp"),
                     env: BTreeMap::new(),
+                    data: Vec::new(),
+                    harness: None,
                 },
                 TestExecutable {
                     package: "alpha".into(),
@@ -686,6 +1390,8 @@ mod tests {
                     executable: PathBuf::from("/tmp/x"),
                     working_dir: PathBuf::from("/tmp"),
                     env: BTreeMap::new(),
+                    data: Vec::new(),
+                    harness: None,
                 },
             ],
         };
@@ -699,8 +1405,9 @@ mod tests {
                 .map(|e| TestRunResult {
                     executable: e.clone(),
                     status: TestRunStatus::Passed,
-                    stdout: Vec::new(),
-                    stderr: Vec::new(),
+                    stdout: CapturedOutput::default(),
+                    stderr: CapturedOutput::default(),
+                    cached: false,
                 })
                 .collect(),
             elapsed: Duration::ZERO,
@@ -756,10 +1463,13 @@ mod tests {
                 executable: PathBuf::from("/tmp/x"),
                 working_dir: PathBuf::from("/tmp"),
                 env: BTreeMap::new(),
+                data: Vec::new(),
+                harness: None,
             },
             status,
-            stdout: Vec::new(),
-            stderr: Vec::new(),
+            stdout: CapturedOutput::default(),
+            stderr: CapturedOutput::default(),
+            cached: false,
         }
     }
 
@@ -822,6 +1532,8 @@ mod tests {
                     executable: fail.to_path_buf(),
                     working_dir: dir.path().to_path_buf(),
                     env: BTreeMap::new(),
+                    data: Vec::new(),
+                    harness: None,
                 },
                 TestExecutable {
                     package: "demo".into(),
@@ -829,13 +1541,15 @@ mod tests {
                     executable: pass.to_path_buf(),
                     working_dir: dir.path().to_path_buf(),
                     env: BTreeMap::new(),
+                    data: Vec::new(),
+                    harness: None,
                 },
             ],
         };
         let mut sink = RecordingSink {
             finished: Vec::new(),
         };
-        let summary = run_tests(&plan, &mut sink).unwrap();
+        let summary = run_tests(&plan, &TestRunOptions::default(), &mut sink).unwrap();
         assert_eq!(summary.total(), 2);
         assert_eq!(summary.passed(), 1);
         assert_eq!(summary.failed(), 1);
@@ -853,6 +1567,77 @@ mod tests {
         assert_eq!(sink.finished, vec!["fail_test", "pass_test"]);
     }
 
+    #[test]
+    #[cfg(unix)]
+    fn run_tests_replays_cached_passes_and_reruns_on_input_change() {
+        let dir = TempDir::new().unwrap();
+        let exe = dir.child("cached_test");
+        // Each real run appends to `runs`, so the count tells hits
+        // from misses.
+        write_executable(
+            &exe,
+            "#!/bin/sh\necho run >> runs\ncat fixture.txt\nexit \"$(cat status)\"\n",
+        );
+        dir.child("fixture.txt").write_str("v1\n").unwrap();
+        dir.child("status").write_str("0\n").unwrap();
+        let plan = TestPlan {
+            executables: vec![TestExecutable {
+                package: "demo".into(),
+                target: "cached_test".into(),
+                executable: exe.to_path_buf(),
+                working_dir: dir.path().to_path_buf(),
+                env: BTreeMap::new(),
+                data: vec![dir.path().join("fixture.txt")],
+                harness: None,
+            }],
+        };
+        let options = TestRunOptions {
+            cache_dir: Some(dir.path().join("cache")),
+            ..TestRunOptions::default()
+        };
+        let run = || {
+            let mut sink = StreamingSink {
+                stdout: Vec::new(),
+                stderr: Vec::new(),
+            };
+            let summary = run_tests(&plan, &options, &mut sink).unwrap();
+            let runs = std::fs::read_to_string(dir.path().join("runs")).unwrap();
+            (
+                summary.results[0].clone(),
+                runs.lines().count(),
+                sink.stdout,
+            )
+        };
+
+        let (first, runs, _) = run();
+        assert!(!first.cached);
+        assert_eq!(runs, 1);
+
+        let (second, runs, streamed) = run();
+        assert!(second.cached, "an unchanged passing test is a hit");
+        assert_eq!(runs, 1);
+        assert_eq!(second.stdout.to_vec(), b"v1\n");
+        assert!(String::from_utf8(streamed).unwrap().contains("v1"));
+        assert_eq!(
+            render_result_line(&second),
+            "test demo:cached_test ... ok (cached)"
+        );
+
+        // A declared data input changing invalidates the entry.
+        dir.child("fixture.txt").write_str("v2\n").unwrap();
+        let (third, runs, _) = run();
+        assert!(!third.cached);
+        assert_eq!(runs, 2);
+
+        // Failures are never recorded, so a failing test re-runs.
+        dir.child("fixture.txt").write_str("v3\n").unwrap();
+        dir.child("status").write_str("1\n").unwrap();
+        assert!(!run().0.status.is_success());
+        let (again, runs, _) = run();
+        assert!(!again.cached);
+        assert_eq!(runs, 4);
+    }
+
     #[test]
     #[cfg(unix)]
     fn run_tests_forwards_output_before_process_exits() {
@@ -909,15 +1694,137 @@ exit 42
                 executable: script.to_path_buf(),
                 working_dir: dir.path().to_path_buf(),
                 env: BTreeMap::from([("MARKER".to_owned(), marker.path().as_os_str().to_owned())]),
+                data: Vec::new(),
+                harness: None,
             }],
         };
         let mut sink = MarkerSink {
             marker: marker.to_path_buf(),
         };
-        let summary = run_tests(&plan, &mut sink).unwrap();
+        let summary = run_tests(&plan, &TestRunOptions::default(), &mut sink).unwrap();
 
         assert!(summary.all_passed(), "{summary:?}");
-        assert_eq!(summary.results[0].stdout, b"ready\n");
+        assert_eq!(summary.results[0].stdout.to_vec(), b"ready\n");
+    }
+
+    #[test]
+    fn capture_buffer_keeps_head_and_tail_and_spools_the_complete_stream() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let path = dir.path().join("demo").join("chatty_test.stdout");
+        let mut buffer = CaptureBuffer::new(8, Some(path.clone()));
+        buffer.push(b"0123").unwrap();
+        buffer.push(b"45").unwrap();
+        // Still within the budget: nothing spooled yet.
+        assert!(!path.exists());
+        buffer.push(b"6789abcdef").unwrap();
+        buffer.push(b"gh").unwrap();
+        let output = buffer.finish().unwrap();
+
+        assert_eq!(output.head(), b"0123");
+        assert_eq!(output.tail(), b"efgh");
+        assert_eq!(output.total_len(), 18);
+        assert_eq!(output.omitted_len(), 10);
+        assert!(output.is_truncated());
+        assert_eq!(output.spool_path(), Some(path.as_path()));
+        assert_eq!(std::fs::read(&path).unwrap(), b"0123456789abcdefgh");
+    }
+
+    #[test]
+    fn capture_buffer_within_budget_is_complete_and_not_spooled() {
+        let dir = assert_fs::TempDir::new().unwrap();
+        let path = dir.path().join("quiet_test.stderr");
+        let mut buffer = CaptureBuffer::new(8, Some(path.clone()));
+        buffer.push(b"0123").unwrap();
+        buffer.push(b"4567").unwrap();
+        let output = buffer.finish().unwrap();
+
+        assert_eq!(output.to_vec(), b"01234567");
+        assert!(!output.is_truncated());
+        assert_eq!(output.spool_path(), None);
+        assert!(!path.exists());
+
+        // Without a spool directory an oversized stream simply
+        // loses its middle.
+        let mut buffer = CaptureBuffer::new(4, None);
+        buffer.push(b"0123456789").unwrap();
+        let output = buffer.finish().unwrap();
+        assert_eq!(output.to_vec(), b"0189");
+        assert_eq!(output.omitted_len(), 6);
+        assert_eq!(output.spool_path(), None);
+    }
+
+    #[test]
+    fn epilogue_replays_truncated_output_of_failed_tests() {
+        let mut buffer = CaptureBuffer::new(8, None);
+        buffer.push(b"head\nmiddle\ntail\n").unwrap();
+        let mut failed = result_for("chatty_test", TestRunStatus::Failed { code: Some(1) });
+        failed.stderr = buffer.finish().unwrap();
+        failed.stderr.spool_path = Some(PathBuf::from(
+            "build/dev/test-output/demo/chatty_test.stderr",
+        ));
+        let summary = TestSummary {
+            results: vec![failed],
+            elapsed: Duration::ZERO,
+        };
+        assert_eq!(
+            render_epilogue(&summary, 0),
+            "\nfailures:\n\n---- stderr: demo:chatty_test (truncated) ----\nhead\n... 9 bytes omitted; full output in build/dev/test-output/demo/chatty_test.stderr ...\nail\n\nfailures:\n    demo:chatty_test\n\ntest result: FAILED. 0 passed; 1 failed; 0 ignored; 0 measured; 0 filtered out; finished in 0.00s"
+        );
+    }
+
+    #[test]
+    #[cfg(unix)]
+    fn run_tests_spools_output_past_the_memory_limit() {
+        struct NullSink;
+        impl TestOutputSink for NullSink {
+            fn write_stdout(&mut self, _e: &TestExecutable, _b: &[u8]) -> io::Result<()> {
+                Ok(())
+            }
+            fn write_stderr(&mut self, _e: &TestExecutable, _b: &[u8]) -> io::Result<()> {
+                Ok(())
+            }
+        }
+
+        let dir = TempDir::new().unwrap();
+        let script = dir.child("chatty_test");
+        write_executable(
+            &script,
+            "#!/bin/sh\nprintf 'begin-0123456789-end'\nexit 3\n",
+        );
+        let spool_dir = dir.path().join("test-output");
+        let stale = spool_dir.join("demo").join("chatty_test.stderr");
+        std::fs::create_dir_all(stale.parent().unwrap()).unwrap();
+        std::fs::write(&stale, b"left over from an earlier run").unwrap();
+        let plan = TestPlan {
+            executables: vec![TestExecutable {
+                package: "demo".into(),
+                target: "chatty_test".into(),
+                executable: script.to_path_buf(),
+                working_dir: dir.path().to_path_buf(),
+                env: BTreeMap::new(),
+                data: Vec::new(),
+                harness: None,
+            }],
+        };
+        let options = TestRunOptions {
+            capture: CaptureOptions {
+                memory_limit: 10,
+                spool_dir: Some(spool_dir.clone()),
+            },
+            ..TestRunOptions::default()
+        };
+        let summary = run_tests(&plan, &options, &mut NullSink).unwrap();
+
+        let stdout = &summary.results[0].stdout;
+        assert_eq!(stdout.head(), b"begin");
+        assert_eq!(stdout.tail(), b"9-end");
+        assert_eq!(stdout.total_len(), 20);
+        let spooled = spool_dir.join("demo").join("chatty_test.stdout");
+        assert_eq!(stdout.spool_path(), Some(spooled.as_path()));
+        assert_eq!(std::fs::read(&spooled).unwrap(), b"begin-0123456789-end");
+        // The quiet stream is not spooled, and its stale file is gone.
+        assert!(summary.results[0].stderr.is_empty());
+        assert!(!stale.exists());
     }
 
     #[test]
@@ -928,12 +1835,15 @@ exit 42
             executable: PathBuf::from("/tmp/x"),
             working_dir: PathBuf::from("/tmp"),
             env: BTreeMap::new(),
+            data: Vec::new(),
+            harness: None,
         };
         let result = TestRunResult {
             executable: exe.clone(),
             status: TestRunStatus::Failed { code: Some(42) },
-            stdout: Vec::new(),
-            stderr: Vec::new(),
+            stdout: CapturedOutput::default(),
+            stderr: CapturedOutput::default(),
+            cached: false,
         };
         assert_eq!(
             render_result_line(&result),
@@ -942,8 +1852,9 @@ exit 42
         let result = TestRunResult {
             executable: exe,
             status: TestRunStatus::Passed,
-            stdout: Vec::new(),
-            stderr: Vec::new(),
+            stdout: CapturedOutput::default(),
+            stderr: CapturedOutput::default(),
+            cached: false,
         };
         assert_eq!(render_result_line(&result), "test demo:fail_test ... ok");
     }
@@ -960,6 +1871,8 @@ exit 42
             executable: PathBuf::from("/tmp/x"),
             working_dir: PathBuf::from("/tmp"),
             env: BTreeMap::new(),
+            data: Vec::new(),
+            harness: None,
         };
         sink.write_stdout(&exe, &[]).unwrap();
         sink.write_stderr(&exe, &[]).unwrap();
@@ -969,8 +1882,9 @@ exit 42
         sink.test_finished(&TestRunResult {
             executable: exe,
             status: TestRunStatus::Passed,
-            stdout: Vec::new(),
-            stderr: Vec::new(),
+            stdout: CapturedOutput::default(),
+            stderr: CapturedOutput::default(),
+            cached: false,
         })
         .unwrap();
         let out = String::from_utf8(sink.stdout).unwrap();
@@ -1,9 +1,11 @@
 //! Compiler / tool detection on top of a [`ResolvedToolchain`].
 //!
 //! Detection runs three short-lived subprocesses in the worst
-//! case (`cxx --version`, `cc --version`, `ar --version`),
-//! captures their output, and hands it to the pure parsers in
-//! `cabin_core::compiler`.  The result is a typed
+//! case (`cxx --version`, `cc --version`, `ar --version`)
+//! concurrently, captures their output, and hands it to the pure
+//! parsers in `cabin_core::compiler`.  A [`DetectionScope`] skips
+//! the C compiler and the archiver when the invocation cannot use
+//! them.  The result is a typed
 //! [`ToolchainDetectionReport`] that downstream crates consume
 //! without re-running anything.
 //!
@@ -31,7 +33,10 @@ use thiserror::Error;
 /// tests in this module can drive every detection branch without
 /// real binaries on PATH.  The default production runner is
 /// [`ProcessRunner`].
-pub trait ToolRunner {
+///
+/// Runners are `Sync` because [`detect_toolchain`] probes the tools
+/// of one toolchain concurrently through a shared reference.
+pub trait ToolRunner: Sync {
     /// Spawn `path` with `args` and capture its stdout/stderr.
     /// The runner must not hang on hostile binaries: a deadline
     /// or fast subprocess form is the implementation's
@@ -213,6 +218,28 @@ fn kind_label(kind: ToolKind) -> &'static str {
     }
 }
 
+/// Which optional tools [`detect_toolchain_scoped`] probes.  The
+/// C++ compiler is always probed: its identity picks the build
+/// dialect.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct DetectionScope {
+    /// Probe the resolved C compiler, when the toolchain has one.
+    /// Needed when a C source is compiled or a `cc` / `cc_version`
+    /// condition gates a profile layer.
+    pub c_compiler: bool,
+    /// Probe the archiver.  Needed by every invocation that can
+    /// plan an archive action; `cabin check` never does.
+    pub archiver: bool,
+}
+
+impl DetectionScope {
+    /// Probe every resolved tool.
+    pub const ALL: Self = Self {
+        c_compiler: true,
+        archiver: true,
+    };
+}
+
 /// Detect identity and capabilities for every tool in `toolchain`.
 ///
 /// `runner` is responsible for spawning each tool.  Production
@@ -231,13 +258,50 @@ pub fn detect_toolchain(
     toolchain: &ResolvedToolchain,
     runner: &dyn ToolRunner,
 ) -> Result<ToolchainDetectionReport, DetectionError> {
-    let cxx = detect_cxx(&toolchain.cxx, runner)?;
-    let cc = match toolchain.cc.as_ref() {
-        Some(tool) => Some(detect_cxx(tool, runner)?),
-        None => None,
-    };
-    let ar = detect_ar(&toolchain.ar, runner)?;
-    Ok(ToolchainDetectionReport { cxx, cc, ar })
+    detect_toolchain_scoped(toolchain, runner, DetectionScope::ALL)
+}
+
+/// [`detect_toolchain`] restricted to the tools `scope` asks for.
+///
+/// The selected probes run concurrently - the C++ compiler on the
+/// calling thread, the C compiler and archiver on scoped threads -
+/// so detection costs one `--version` round trip instead of three.
+/// Tools outside `scope` are never spawned and are `None` in the
+/// report.  Errors surface in the fixed C++ / C / archiver order
+/// regardless of which probe finished first.
+///
+/// # Errors
+/// Same as [`detect_toolchain`], for the probed tools only.
+pub fn detect_toolchain_scoped(
+    toolchain: &ResolvedToolchain,
+    runner: &dyn ToolRunner,
+    scope: DetectionScope,
+) -> Result<ToolchainDetectionReport, DetectionError> {
+    thread::scope(|threads| {
+        let cc = toolchain
+            .cc
+            .as_ref()
+            .filter(|_| scope.c_compiler)
+            .map(|tool| threads.spawn(move || detect_cxx(tool, runner)));
+        let ar = scope
+            .archiver
+            .then(|| threads.spawn(|| detect_ar(&toolchain.ar, runner)));
+        let cxx = detect_cxx(&toolchain.cxx, runner);
+        let cc = cc.map(join_probe).transpose();
+        let ar = ar.map(join_probe).transpose();
+        Ok(ToolchainDetectionReport {
+            cxx: cxx?,
+            cc: cc?,
+            ar: ar?,
+        })
+    })
+}
+
+/// Join a probe thread, re-raising its panic on the caller.
+fn join_probe<T>(handle: thread::ScopedJoinHandle<'_, T>) -> T {
+    handle
+        .join()
+        .unwrap_or_else(|payload| std::panic::resume_unwind(payload))
 }
 
 fn detect_cxx(
@@ -470,8 +534,8 @@ mod tests {
         let report = detect_toolchain(&toolchain_with(cxx, ar), &runner).unwrap();
         assert_eq!(report.cxx.identity.kind, CompilerKind::Clang);
         assert!(report.cxx.capabilities.gcc_style_flags.supported);
-        assert_eq!(report.ar.identity.kind, ArchiverKind::Ar);
-        assert!(report.ar.capabilities.ar_crs.supported);
+        assert_eq!(report.ar.as_ref().unwrap().identity.kind, ArchiverKind::Ar);
+        assert!(report.ar.as_ref().unwrap().capabilities.ar_crs.supported);
     }
 
     #[test]
@@ -508,7 +572,7 @@ mod tests {
             )
             .supported
         );
-        assert_eq!(report.ar.identity.kind, ArchiverKind::Lib);
+        assert_eq!(report.ar.as_ref().unwrap().identity.kind, ArchiverKind::Lib);
     }
 
     #[test]
@@ -566,9 +630,9 @@ mod tests {
                 0,
             );
         let report = detect_toolchain(&toolchain_with(cxx, ar), &runner).unwrap();
-        assert_eq!(report.ar.identity.kind, ArchiverKind::Lib);
+        assert_eq!(report.ar.as_ref().unwrap().identity.kind, ArchiverKind::Lib);
         // `Lib` archives with `/OUT:`, not `ar crs`.
-        assert!(!report.ar.capabilities.ar_crs.supported);
+        assert!(!report.ar.as_ref().unwrap().capabilities.ar_crs.supported);
     }
 
     #[test]
@@ -598,8 +662,8 @@ mod tests {
         assert_eq!(report.cxx.identity.kind, CompilerKind::AppleClang);
         // Name-based fallback classifies BSD `ar` as the GNU/BSD
         // family for capability purposes.
-        assert_eq!(report.ar.identity.kind, ArchiverKind::Ar);
-        assert!(report.ar.capabilities.ar_crs.supported);
+        assert_eq!(report.ar.as_ref().unwrap().identity.kind, ArchiverKind::Ar);
+        assert!(report.ar.as_ref().unwrap().capabilities.ar_crs.supported);
     }
 
     #[test]
@@ -625,8 +689,11 @@ mod tests {
                 0,
             );
         let report = detect_toolchain(&toolchain_with(cxx, ar), &runner).unwrap();
-        assert_eq!(report.ar.identity.kind, ArchiverKind::Unknown);
-        assert!(!report.ar.capabilities.ar_crs.supported);
+        assert_eq!(
+            report.ar.as_ref().unwrap().identity.kind,
+            ArchiverKind::Unknown
+        );
+        assert!(!report.ar.as_ref().unwrap().capabilities.ar_crs.supported);
     }
 
     #[test]
@@ -663,8 +730,8 @@ mod tests {
         let report = detect_toolchain(&toolchain_with(cxx, ar), &runner).unwrap();
         assert_eq!(report.cxx.identity.kind, CompilerKind::Msvc);
         assert!(!report.cxx.capabilities.gcc_style_flags.supported);
-        assert_eq!(report.ar.identity.kind, ArchiverKind::Lib);
-        assert!(!report.ar.capabilities.ar_crs.supported);
+        assert_eq!(report.ar.as_ref().unwrap().identity.kind, ArchiverKind::Lib);
+        assert!(!report.ar.as_ref().unwrap().capabilities.ar_crs.supported);
     }
 
     #[test]
@@ -696,7 +763,7 @@ mod tests {
         let report = detect_toolchain(&toolchain_with(cxx, ar), &runner).unwrap();
         assert_eq!(report.cxx.identity.kind, CompilerKind::Msvc);
         assert!(report.cxx.capabilities.msvc_style_flags.supported);
-        assert_eq!(report.ar.identity.kind, ArchiverKind::Lib);
+        assert_eq!(report.ar.as_ref().unwrap().identity.kind, ArchiverKind::Lib);
     }
 
     #[test]
@@ -730,7 +797,7 @@ mod tests {
             )
             .with("/usr/bin/ar", &["--version"], "", "boom\n", 2);
         let report = detect_toolchain(&toolchain_with(cxx, ar), &runner).unwrap();
-        assert_eq!(report.ar.identity.kind, ArchiverKind::Ar);
+        assert_eq!(report.ar.as_ref().unwrap().identity.kind, ArchiverKind::Ar);
     }
 
     #[test]
@@ -764,6 +831,44 @@ mod tests {
         assert_eq!(cc_detection.identity.kind, CompilerKind::Clang);
     }
 
+    #[test]
+    fn scoped_detection_never_spawns_unneeded_tools() {
+        // Only the C++ compiler has a fixture: probing the C
+        // compiler or the archiver would surface a fake-runner miss.
+        let toolchain = ResolvedToolchain {
+            cxx: tool(ToolKind::CxxCompiler, "/bin/clang++", "clang++"),
+            ar: tool(ToolKind::Archiver, "/bin/ar", "ar"),
+            cc: Some(tool(ToolKind::CCompiler, "/bin/clang", "clang")),
+        };
+        let runner = FakeRunner::new().with(
+            "/bin/clang++",
+            &["--version"],
+            "clang version 17.0.6\n",
+            "",
+            0,
+        );
+        let scope = DetectionScope {
+            c_compiler: false,
+            archiver: false,
+        };
+        let report = detect_toolchain_scoped(&toolchain, &runner, scope).unwrap();
+        assert_eq!(report.cxx.identity.kind, CompilerKind::Clang);
+        assert!(report.cc.is_none());
+        assert!(report.ar.is_none());
+
+        let err = detect_toolchain(&toolchain, &runner).unwrap_err();
+        assert!(
+            matches!(
+                err,
+                DetectionError::SubprocessFailed {
+                    kind: ToolKind::CCompiler,
+                    ..
+                }
+            ),
+            "the C compiler error reports before the archiver's, got {err:?}"
+        );
+    }
+
     #[test]
     fn process_runner_times_out_hanging_tool() {
         let exe = std::env::current_exe().expect("current test executable");
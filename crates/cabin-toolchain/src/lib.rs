@@ -14,8 +14,8 @@ pub mod resolve;
 pub mod wrapper;
 
 pub use detect::{
-    DetectionError as ToolchainDetectionFailure, ProcessRunner, RunError, RunOutput, ToolRunner,
-    detect_toolchain,
+    DetectionError as ToolchainDetectionFailure, DetectionScope, ProcessRunner, RunError,
+    RunOutput, ToolRunner, detect_toolchain, detect_toolchain_scoped,
 };
 pub use error::ToolchainError;
 pub use msvc::{msvc_environment, msvc_tool_path, path_is_discovered_msvc_cl};
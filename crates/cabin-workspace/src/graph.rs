@@ -354,6 +354,8 @@ mod consumer_standards_tests {
             deps: Vec::new(),
             required_features: Vec::new(),
             language,
+            data: Vec::new(),
+            harness: None,
         }
     }
 
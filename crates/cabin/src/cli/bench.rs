@@ -0,0 +1,326 @@
+//! Glue layer for `cabin bench`.
+//!
+//! `cabin bench` builds the selected `bench` targets through the
+//! same pipeline as `cabin test` - with the `release` profile
+//! unless `--profile` says otherwise - then hands the linked
+//! executables to [`cabin_bench::run_benches`], stores the run
+//! under `<build-dir>/<profile>/bench`, and compares it against a
+//! saved baseline when one is named.
+//!
+//! Benchmark execution, result parsing and the statistics live in
+//! the `cabin-bench` crate; this module only orchestrates.
+
+use std::ffi::OsString;
+use std::path::PathBuf;
+
+use anyhow::{Result, bail};
+use clap::Args;
+
+use cabin_build::{ManifestTargetSelector, select_targets_of_kind};
+use cabin_core::TargetKind;
+
+use crate::cli::build_prep::{
+    DevActivation, WorkspacePipelineArgs, plan_prepared, prepare_workspace,
+};
+use crate::cli::test::{populate_test_env_overlay, select_named_targets};
+use crate::cli::{ToolchainSelectionArgs, WorkspaceSelectionArgs};
+use crate::plural;
+
+/// Profile `cabin bench` builds with when `--profile` is absent:
+/// timing an unoptimized build measures the wrong thing.
+const DEFAULT_BENCH_PROFILE: &str = "release";
+
+/// `cabin bench` arguments.  The build flags mirror `cabin test`;
+/// the rest select, compare and forward to benchmarks.
+#[derive(Debug, Args)]
+pub(crate) struct BenchArgs {
+    /// Path to the cabin.toml manifest.
+    #[arg(long, value_name = "PATH")]
+    pub manifest_path: Option<PathBuf>,
+
+    /// Directory for build outputs and benchmark results.
+    /// Defaults to `build`.
+    #[arg(long, value_name = "PATH")]
+    pub build_dir: Option<PathBuf>,
+
+    /// Build profile.  Defaults to `release`, unlike `cabin build`
+    /// and `cabin test`.
+    #[arg(long, value_name = "NAME")]
+    pub profile: Option<String>,
+
+    /// Path to a directory containing the local JSON package
+    /// index.
+    #[arg(long, value_name = "PATH")]
+    pub index_path: Option<PathBuf>,
+
+    /// Sparse HTTP index URL.
+    #[arg(long, value_name = "URL")]
+    pub index_url: Option<String>,
+
+    /// Override the default artifact cache directory.
+    #[arg(long, value_name = "PATH")]
+    pub cache_dir: Option<PathBuf>,
+
+    /// Require an existing, current `cabin.lock`.
+    #[arg(long, conflicts_with = "frozen")]
+    pub locked: bool,
+
+    /// Like `--locked`, but also rejects state-writing side
+    /// effects.
+    #[arg(long)]
+    pub frozen: bool,
+
+    /// Forbid network access.
+    #[arg(long)]
+    pub offline: bool,
+
+    /// Enable named features for the selected packages.
+    #[arg(long, value_name = "FEATURES")]
+    pub features: Vec<String>,
+
+    /// Enable every feature declared by selected packages.
+    #[arg(long)]
+    pub all_features: bool,
+
+    /// Disable each selected package's default features.
+    #[arg(long)]
+    pub no_default_features: bool,
+
+    /// Workspace package-selection flags.
+    #[command(flatten)]
+    pub workspace_selection: WorkspaceSelectionArgs,
+
+    /// Toolchain-selection flags.
+    #[command(flatten)]
+    pub toolchain: ToolchainSelectionArgs,
+
+    /// Disable every active patch and source-replacement entry
+    /// for this invocation.
+    #[arg(long)]
+    pub no_patches: bool,
+
+    /// Run only the named `bench` target; may be repeated.
+    #[arg(long = "bench", value_name = "NAME")]
+    pub bench: Vec<String>,
+
+    /// Save this run as the named baseline.
+    #[arg(long, value_name = "NAME")]
+    pub save_baseline: Option<String>,
+
+    /// Compare this run against the named saved baseline.
+    #[arg(long, value_name = "NAME")]
+    pub baseline: Option<String>,
+
+    /// Smallest change of a benchmark's mean, in percent of the
+    /// baseline, that counts as a regression or improvement.
+    #[arg(
+        long,
+        value_name = "PERCENT",
+        default_value_t = cabin_bench::DEFAULT_NOISE_THRESHOLD,
+        value_parser = parse_noise_threshold
+    )]
+    pub noise_threshold: f64,
+
+    /// Exit non-zero when any benchmark regressed against
+    /// `--baseline`.
+    #[arg(long, requires = "baseline")]
+    pub fail_on_regression: bool,
+
+    /// Arguments forwarded to every benchmark executable (for
+    /// example `--benchmark_repetitions=10`).  Everything after
+    /// `--` is passed verbatim.
+    #[arg(trailing_var_arg = true, allow_hyphen_values = true)]
+    pub args: Vec<String>,
+}
+
+fn parse_noise_threshold(value: &str) -> Result<f64, String> {
+    match value.parse::<f64>() {
+        Ok(percent) if percent.is_finite() && percent >= 0.0 => Ok(percent),
+        _ => Err(format!("`{value}` is not a non-negative percentage")),
+    }
+}
+
+/// Run `cabin bench`: build the selected `bench` targets, run each
+/// one, print its benchmarks, and compare them against a baseline.
+pub(crate) fn bench(
+    args: &BenchArgs,
+    reporter: crate::cli::term_verbosity::Reporter,
+    color: cabin_core::ColorChoice,
+    experimental_features: &cabin_core::ExperimentalFeatures,
+) -> Result<()> {
+    let prepared = prepare_workspace(
+        &WorkspacePipelineArgs {
+            manifest_path: args.manifest_path.as_deref(),
+            offline: args.offline,
+            cache_dir: args.cache_dir.as_deref(),
+            build_dir: args.build_dir.as_deref(),
+            locked: args.locked,
+            frozen: args.frozen,
+            no_patches: args.no_patches,
+            features: &args.features,
+            all_features: args.all_features,
+            no_default_features: args.no_default_features,
+            index_path: args.index_path.as_deref(),
+            index_url: args.index_url.as_deref(),
+            profile: Some(args.profile.as_deref().unwrap_or(DEFAULT_BENCH_PROFILE)),
+            release: false,
+            workspace_selection: &args.workspace_selection,
+            toolchain: &args.toolchain,
+            dev: DevActivation::SelectedPrimaries,
+            check_only: false,
+        },
+        reporter,
+        experimental_features,
+    )?;
+
+    // Selection mirrors `cabin test`: feature-gated benches drop
+    // out of the enumeration, while a gated bench named with
+    // `--bench` stays selected so the planner names the missing
+    // features.
+    let all_selectors: Vec<ManifestTargetSelector> = select_targets_of_kind(
+        &prepared.graph,
+        Some(&prepared.resolved_selection.packages),
+        TargetKind::Bench,
+    );
+    let selectors: Vec<ManifestTargetSelector> = if args.bench.is_empty() {
+        all_selectors
+            .iter()
+            .filter(|sel| {
+                cabin_build::selector_required_features_met(
+                    sel,
+                    &prepared.graph,
+                    &prepared.enabled_features,
+                )
+            })
+            .cloned()
+            .collect()
+    } else {
+        select_named_targets(
+            &prepared.graph,
+            &prepared.resolved_selection.packages,
+            &all_selectors,
+            &args.bench,
+            "--bench",
+            TargetKind::Bench,
+        )?
+    };
+    if selectors.is_empty() {
+        if all_selectors.is_empty() {
+            bail!(
+                "no bench targets found in the selected packages; declare a target with `type = \"bench\"`"
+            );
+        }
+        bail!(
+            "every bench target in the selected packages requires features that are not enabled; enable them with `--features <name>`"
+        );
+    }
+
+    let plan_graph = plan_prepared(&prepared, Some(selectors), false, color)?;
+    crate::cli::ninja::invoke_ninja_and_report(&crate::cli::ninja::NinjaInvocationRequest {
+        build_dir: &prepared.build_dir,
+        profile: &prepared.profile,
+        plan_graph: &plan_graph,
+        check: false,
+        graph: &prepared.graph,
+        toolchain: &prepared.toolchain,
+        cxx_kind: prepared.detection_report.cxx.identity.kind,
+        feature_resolution: &prepared.feature_resolution,
+        dev_for: &prepared.dev_for,
+        ninja: &prepared.ninja,
+        jobs: None,
+        env: &prepared.prep.backend_env,
+        reporter,
+    })?;
+
+    let mut plan = cabin_test::plan_executables_of_kind(
+        &prepared.graph,
+        &plan_graph,
+        Some(&prepared.resolved_selection.packages),
+        TargetKind::Bench,
+    );
+    populate_test_env_overlay(
+        &mut plan,
+        &prepared.graph,
+        &prepared.profile,
+        &prepared.build_dir,
+    )?;
+    if plan.is_empty() {
+        bail!("no bench targets were produced by the build graph");
+    }
+
+    let bench_dir = prepared
+        .build_dir
+        .join(prepared.profile.name.as_str())
+        .join("bench");
+    // Load the baseline before running anything so a mistyped name
+    // fails fast rather than after minutes of measurement.
+    let baseline = args
+        .baseline
+        .as_deref()
+        .map(|name| cabin_bench::load_report(&cabin_bench::baseline_path(&bench_dir, name)?))
+        .transpose()?;
+
+    println!(
+        "\nrunning {} bench target{}",
+        plan.len(),
+        plural(plan.len())
+    );
+    let options = cabin_bench::BenchRunOptions {
+        args: args.args.iter().map(OsString::from).collect(),
+        output_dir: bench_dir.join("output"),
+    };
+    let report = cabin_bench::run_benches(&plan, &options, &mut std::io::stdout().lock())?;
+    cabin_bench::save_report(&bench_dir.join("latest.json"), &report)?;
+    if let Some(name) = &args.save_baseline {
+        cabin_bench::save_report(&cabin_bench::baseline_path(&bench_dir, name)?, &report)?;
+    }
+
+    println!();
+    let (mut regressed, mut improved) = (0usize, 0usize);
+    for result in &report.benchmarks {
+        let Some(comparison) = cabin_bench::compare(
+            result,
+            baseline.as_ref().map(|b| b.benchmarks.as_slice()),
+            args.noise_threshold,
+        ) else {
+            continue;
+        };
+        match comparison.verdict {
+            cabin_bench::Verdict::Regressed => regressed += 1,
+            cabin_bench::Verdict::Improved => improved += 1,
+            cabin_bench::Verdict::Unchanged | cabin_bench::Verdict::New => {}
+        }
+        println!("{}", cabin_bench::render_result_line(result, &comparison));
+    }
+    let total = report.benchmarks.len();
+    if let Some(name) = &args.baseline {
+        println!(
+            "\nbench result: {total} benchmark{}; {regressed} regressed; {improved} improved (baseline `{name}`, noise threshold {}%)",
+            plural(total),
+            args.noise_threshold
+        );
+    } else {
+        println!("\nbench result: {total} benchmark{}", plural(total));
+    }
+    if args.fail_on_regression && regressed > 0 {
+        bail!(
+            "{regressed} of {total} benchmark{} regressed against baseline",
+            plural(total)
+        );
+    }
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn noise_threshold_must_be_a_non_negative_number() {
+        assert_eq!(parse_noise_threshold("2.5"), Ok(2.5));
+        assert_eq!(parse_noise_threshold("0"), Ok(0.0));
+        assert!(parse_noise_threshold("-1").is_err());
+        assert!(parse_noise_threshold("NaN").is_err());
+        assert!(parse_noise_threshold("five").is_err());
+    }
+}
@@ -0,0 +1,270 @@
+//! Glue layer for `cabin bloat`.
+//!
+//! `cabin bloat` builds the selected `executable` targets through
+//! the same pipeline as `cabin build`, with every link rewritten by
+//! [`cabin_build::with_linker_maps`] to also write a linker map.  It
+//! then hands each map, together with the planner's
+//! [`cabin_build::BuildGraph::artifact_owners`], to
+//! [`cabin_bloat::analyze_map`], stores the result under
+//! `<build-dir>/<profile>/bloat`, and compares it against a saved
+//! baseline when one is named.
+//!
+//! Map parsing, attribution and rendering live in the
+//! `cabin-bloat` crate; this module only orchestrates.
+
+use std::path::PathBuf;
+
+use anyhow::{Result, bail};
+use clap::Args;
+
+use cabin_build::{BuildAction, Dialect, ManifestTargetSelector, select_targets_of_kind};
+use cabin_core::TargetKind;
+
+use crate::cli::build_prep::{
+    DevActivation, WorkspacePipelineArgs, plan_prepared, prepare_workspace,
+};
+use crate::cli::test::select_named_targets;
+use crate::cli::{ToolchainSelectionArgs, WorkspaceSelectionArgs};
+
+/// `cabin bloat` arguments.  The build flags mirror `cabin build`;
+/// the rest select, bound and compare the report.
+#[derive(Debug, Args)]
+pub(crate) struct BloatArgs {
+    /// Path to the cabin.toml manifest.
+    #[arg(long, value_name = "PATH")]
+    pub manifest_path: Option<PathBuf>,
+
+    /// Directory for build outputs and size reports.  Defaults to
+    /// `build`.
+    #[arg(long, value_name = "PATH")]
+    pub build_dir: Option<PathBuf>,
+
+    /// Build with optimizations.  Compatibility alias for
+    /// `--profile release`.
+    #[arg(short = 'r', long, conflicts_with = "profile")]
+    pub release: bool,
+
+    /// Build profile.  Defaults to `dev`.
+    #[arg(long, value_name = "NAME")]
+    pub profile: Option<String>,
+
+    /// Path to a directory containing the local JSON package
+    /// index.
+    #[arg(long, value_name = "PATH")]
+    pub index_path: Option<PathBuf>,
+
+    /// Sparse HTTP index URL.
+    #[arg(long, value_name = "URL")]
+    pub index_url: Option<String>,
+
+    /// Override the default artifact cache directory.
+    #[arg(long, value_name = "PATH")]
+    pub cache_dir: Option<PathBuf>,
+
+    /// Require an existing, current `cabin.lock`.
+    #[arg(long, conflicts_with = "frozen")]
+    pub locked: bool,
+
+    /// Like `--locked`, but also rejects state-writing side
+    /// effects.
+    #[arg(long)]
+    pub frozen: bool,
+
+    /// Forbid network access.
+    #[arg(long)]
+    pub offline: bool,
+
+    /// Enable named features for the selected packages.
+    #[arg(long, value_name = "FEATURES")]
+    pub features: Vec<String>,
+
+    /// Enable every feature declared by selected packages.
+    #[arg(long)]
+    pub all_features: bool,
+
+    /// Disable each selected package's default features.
+    #[arg(long)]
+    pub no_default_features: bool,
+
+    /// Workspace package-selection flags.
+    #[command(flatten)]
+    pub workspace_selection: WorkspaceSelectionArgs,
+
+    /// Toolchain-selection flags.
+    #[command(flatten)]
+    pub toolchain: ToolchainSelectionArgs,
+
+    /// Disable every active patch and source-replacement entry
+    /// for this invocation.
+    #[arg(long)]
+    pub no_patches: bool,
+
+    /// Analyze only the named `executable` target; may be repeated.
+    #[arg(long = "bin", value_name = "NAME")]
+    pub bin: Vec<String>,
+
+    /// Rows printed per table.
+    #[arg(long, value_name = "N", default_value_t = 10)]
+    pub top: usize,
+
+    /// Save this report as the named baseline.
+    #[arg(long, value_name = "NAME")]
+    pub save_baseline: Option<String>,
+
+    /// Compare this report against the named saved baseline.
+    #[arg(long, value_name = "NAME")]
+    pub baseline: Option<String>,
+}
+
+/// Run `cabin bloat`: build the selected executables with linker
+/// maps, attribute their bytes, and print (and store) the report.
+pub(crate) fn bloat(
+    args: &BloatArgs,
+    reporter: crate::cli::term_verbosity::Reporter,
+    color: cabin_core::ColorChoice,
+    experimental_features: &cabin_core::ExperimentalFeatures,
+) -> Result<()> {
+    if cfg!(target_os = "macos") {
+        bail!(
+            "`cabin bloat` reads GNU ld, gold, mold and LLD linker maps; the Apple linker's map layout is not supported"
+        );
+    }
+    let prepared = prepare_workspace(
+        &WorkspacePipelineArgs {
+            manifest_path: args.manifest_path.as_deref(),
+            offline: args.offline,
+            cache_dir: args.cache_dir.as_deref(),
+            build_dir: args.build_dir.as_deref(),
+            locked: args.locked,
+            frozen: args.frozen,
+            no_patches: args.no_patches,
+            features: &args.features,
+            all_features: args.all_features,
+            no_default_features: args.no_default_features,
+            index_path: args.index_path.as_deref(),
+            index_url: args.index_url.as_deref(),
+            profile: args.profile.as_deref(),
+            release: args.release,
+            workspace_selection: &args.workspace_selection,
+            toolchain: &args.toolchain,
+            dev: DevActivation::Disabled,
+            check_only: false,
+        },
+        reporter,
+        experimental_features,
+    )?;
+
+    let all_selectors: Vec<ManifestTargetSelector> = select_targets_of_kind(
+        &prepared.graph,
+        Some(&prepared.resolved_selection.packages),
+        TargetKind::Executable,
+    );
+    let selectors: Vec<ManifestTargetSelector> = if args.bin.is_empty() {
+        all_selectors
+            .iter()
+            .filter(|sel| {
+                cabin_build::selector_required_features_met(
+                    sel,
+                    &prepared.graph,
+                    &prepared.enabled_features,
+                )
+            })
+            .cloned()
+            .collect()
+    } else {
+        select_named_targets(
+            &prepared.graph,
+            &prepared.resolved_selection.packages,
+            &all_selectors,
+            &args.bin,
+            "--bin",
+            TargetKind::Executable,
+        )?
+    };
+    if selectors.is_empty() {
+        if all_selectors.is_empty() {
+            bail!("no executable targets found in the selected packages");
+        }
+        bail!(
+            "every executable target in the selected packages requires features that are not enabled; enable them with `--features <name>`"
+        );
+    }
+
+    let plan_graph = plan_prepared(&prepared, Some(selectors), false, color)?;
+    if plan_graph.dialect == Dialect::Msvc {
+        bail!(
+            "`cabin bloat` reads GNU ld, gold, mold and LLD linker maps; MSVC `link.exe` maps are not supported"
+        );
+    }
+    // Maps only change the link lines, so switching between
+    // `cabin bloat` and `cabin build` relinks but never recompiles.
+    let plan_graph = cabin_build::with_linker_maps(plan_graph);
+
+    let bloat_dir = prepared
+        .build_dir
+        .join(prepared.profile.name.as_str())
+        .join("bloat");
+    // Load the baseline before building so a mistyped name fails
+    // fast.
+    let baseline = args
+        .baseline
+        .as_deref()
+        .map(|name| cabin_bloat::load_report(&cabin_bloat::baseline_path(&bloat_dir, name)?))
+        .transpose()?;
+
+    crate::cli::ninja::invoke_ninja_and_report(&crate::cli::ninja::NinjaInvocationRequest {
+        build_dir: &prepared.build_dir,
+        profile: &prepared.profile,
+        plan_graph: &plan_graph,
+        check: false,
+        graph: &prepared.graph,
+        toolchain: &prepared.toolchain,
+        cxx_kind: prepared.detection_report.cxx.identity.kind,
+        feature_resolution: &prepared.feature_resolution,
+        dev_for: &prepared.dev_for,
+        ninja: &prepared.ninja,
+        jobs: None,
+        env: &prepared.prep.backend_env,
+        reporter,
+    })?;
+
+    let mut report = cabin_bloat::BloatReport::default();
+    for action in &plan_graph.actions {
+        let BuildAction::Link(link) = action else {
+            continue;
+        };
+        let (Some(map), Some(owner)) = (
+            link.map_file.as_deref(),
+            plan_graph.artifact_owners.get(&link.output),
+        ) else {
+            continue;
+        };
+        if !plan_graph.default_outputs.contains(&link.output) {
+            continue;
+        }
+        report.executables.push(cabin_bloat::analyze_map(
+            owner,
+            map,
+            &plan_graph.artifact_owners,
+        )?);
+    }
+    if report.executables.is_empty() {
+        bail!("no executable targets were produced by the build graph");
+    }
+    cabin_bloat::save_report(&bloat_dir.join("latest.json"), &report)?;
+    if let Some(name) = &args.save_baseline {
+        cabin_bloat::save_report(&cabin_bloat::baseline_path(&bloat_dir, name)?, &report)?;
+    }
+
+    for executable in &report.executables {
+        println!();
+        print!(
+            "{}",
+            cabin_bloat::render_executable(executable, baseline.as_ref(), args.top)
+        );
+    }
+    if let Some(name) = &args.baseline {
+        println!("\nbloat compared against baseline `{name}`");
+    }
+    Ok(())
+}
@@ -1,6 +1,9 @@
+use anyhow::bail;
+
 use super::{BuildArgs, Reporter, Result, profile_descriptor};
 use crate::cli::build_prep::{
-    DevActivation, WorkspacePipelineArgs, plan_prepared, prepare_workspace,
+    DevActivation, WorkspacePipelineArgs, plan_prepared, plan_prepared_profile,
+    prepare_additional_profile, prepare_workspace,
 };
 
 /// Whether [`build`] produces real artifacts (`cabin build`) or only
@@ -18,6 +21,14 @@ pub(super) fn build(
     color: cabin_core::ColorChoice,
     experimental_features: &cabin_core::ExperimentalFeatures,
 ) -> Result<()> {
+    // Repeated `--profile` flags build every named profile in one
+    // Ninja run; a name passed twice is built once.
+    let mut profiles: Vec<&str> = Vec::with_capacity(args.profile.len());
+    for name in &args.profile {
+        if !profiles.contains(&name.as_str()) {
+            profiles.push(name);
+        }
+    }
     let prepared = prepare_workspace(
         &WorkspacePipelineArgs {
             manifest_path: args.manifest_path.as_deref(),
@@ -32,16 +43,44 @@ pub(super) fn build(
             no_default_features: args.no_default_features,
             index_path: args.index_path.as_deref(),
             index_url: args.index_url.as_deref(),
-            profile: args.profile.as_deref(),
+            profile: profiles.first().copied(),
             release: args.release,
             workspace_selection: &args.workspace_selection,
             toolchain: &args.toolchain,
             dev: DevActivation::Disabled,
+            check_only: matches!(mode, BuildMode::Check),
         },
         reporter,
         experimental_features,
     )?;
-    let plan_graph = plan_prepared(&prepared, None, matches!(mode, BuildMode::Check), color)?;
+    let check = matches!(mode, BuildMode::Check);
+    if args.analyze.is_some() && profiles.len() > 1 {
+        bail!("`--analyze` takes a single `--profile`");
+    }
+    if profiles.len() > 1 {
+        return build_profiles(args, &prepared, &profiles[1..], reporter, check, color);
+    }
+    let plan_graph = plan_prepared(&prepared, None, check, color)?;
+    if let Some(format) = args.analyze {
+        let profile = prepared.profile.name.as_str();
+        return crate::cli::build_analysis::report(
+            &prepared.build_dir.join(profile),
+            profile,
+            &plan_graph,
+            format,
+        );
+    }
+    // A check skips the translation units a previous build already
+    // compiled with the same arguments and left up to date.
+    let plan_graph = if check {
+        crate::cli::check_freshness::skip_satisfied(
+            &prepared.build_dir.join(prepared.profile.name.as_str()),
+            plan_graph,
+            reporter,
+        )
+    } else {
+        plan_graph
+    };
 
     // Profile-aware Ninja root: `build/<profile>/build.ninja`
     // and `build/<profile>/compile_commands.json`.  Keeps dev /
@@ -75,6 +114,7 @@ pub(super) fn build(
             build_dir: &prepared.build_dir,
             profile: &prepared.profile,
             plan_graph: &plan_graph,
+            check,
             graph: &prepared.graph,
             toolchain: &prepared.toolchain,
             cxx_kind: prepared.detection_report.cxx.identity.kind,
@@ -82,6 +122,7 @@ pub(super) fn build(
             dev_for: &prepared.dev_for,
             ninja: &prepared.ninja,
             jobs,
+            env: &prepared.prep.backend_env,
             reporter,
         })?;
 
@@ -100,3 +141,89 @@ pub(super) fn build(
 
     Ok(())
 }
+
+/// Multi-profile tail of [`build`]: plan each profile against the one
+/// prepared workspace - loaded, resolved and detected once - and let
+/// a single Ninja process schedule every profile's actions under one
+/// `-j`.  `prepared` already carries the first profile; `rest` are
+/// the remaining names in command-line order.
+fn build_profiles(
+    args: &BuildArgs,
+    prepared: &crate::cli::build_prep::PreparedWorkspace,
+    rest: &[&str],
+    reporter: Reporter,
+    check: bool,
+    color: cabin_core::ColorChoice,
+) -> Result<()> {
+    let first = plan_prepared(prepared, None, check, color)?;
+    // Every profile plans the same targets, so the first plan's
+    // standard-compat violations stand for all of them.
+    let violations = first.standard_compat_violations.clone();
+    let mut planned = Vec::with_capacity(rest.len() + 1);
+    planned.push((prepared.profile.clone(), first));
+    for name in rest {
+        let (profile, prep) =
+            prepare_additional_profile(prepared, name, &args.toolchain, reporter)?;
+        let plan_graph = plan_prepared_profile(
+            prepared,
+            &profile,
+            &prep,
+            None,
+            Some(&violations),
+            check,
+            color,
+        )?;
+        planned.push((profile, plan_graph));
+    }
+    if check {
+        planned = planned
+            .into_iter()
+            .map(|(profile, plan_graph)| {
+                let root = prepared.build_dir.join(profile.name.as_str());
+                let plan_graph =
+                    crate::cli::check_freshness::skip_satisfied(&root, plan_graph, reporter);
+                (profile, plan_graph)
+            })
+            .collect();
+    }
+    for (profile, _) in &planned {
+        reporter.verbose(format_args!("cabin: profile = {}", profile.name.as_str()));
+    }
+    reporter.verbose(format_args!(
+        "cabin: build dir = {}",
+        prepared.build_dir.display()
+    ));
+
+    let jobs = crate::cli::config::resolve_build_jobs(args.jobs, &prepared.effective_config)?;
+    let elapsed = crate::cli::ninja::invoke_multi_profile_ninja_and_report(
+        &crate::cli::ninja::MultiProfileNinjaRequest {
+            build_dir: &prepared.build_dir,
+            profiles: &planned,
+            check,
+            graph: &prepared.graph,
+            toolchain: &prepared.toolchain,
+            cxx_kind: prepared.detection_report.cxx.identity.kind,
+            feature_resolution: &prepared.feature_resolution,
+            dev_for: &prepared.dev_for,
+            ninja: &prepared.ninja,
+            jobs,
+            env: &prepared.prep.backend_env,
+            reporter,
+        },
+    )?;
+
+    // One `Finished` line per profile, all sharing the single Ninja
+    // run's wall-clock time.
+    for (profile, _) in &planned {
+        reporter.status(
+            "Finished",
+            format_args!(
+                "`{}` profile [{}] target(s) in {:.2}s",
+                profile.name.as_str(),
+                profile_descriptor(profile),
+                elapsed.as_secs_f64(),
+            ),
+        );
+    }
+    Ok(())
+}
@@ -0,0 +1,177 @@
+//! Glue layer for `cabin build --analyze`.
+//!
+//! Plans the build like `cabin build` but, instead of running Ninja,
+//! costs every planned action with the duration the previous build
+//! recorded in `<build-dir>/<profile>/.ninja_log` and hands the graph
+//! to [`cabin_build::analyze`].  The model - total work, critical
+//! path, speedup curve - lives in `cabin-build`; this module reads
+//! the log and renders the result.
+
+use std::path::Path;
+use std::time::Duration;
+
+use anyhow::{Context, Result, bail};
+
+use cabin_build::{BuildAnalysis, BuildGraph};
+
+use super::ResolveFormat;
+
+/// How many critical-path actions the human report lists.
+const TOP_CRITICAL_ACTIONS: usize = 10;
+
+pub(super) fn report(
+    profile_build_root: &Path,
+    profile: &str,
+    plan_graph: &BuildGraph,
+    format: ResolveFormat,
+) -> Result<()> {
+    let log_path = profile_build_root.join(".ninja_log");
+    let log = cabin_ninja::NinjaLog::read(&log_path)
+        .with_context(|| format!("failed to analyze the `{profile}` profile build"))?;
+    let Some(log) = log.filter(|log| !log.is_empty()) else {
+        bail!(
+            "no recorded build history in {}; run `cabin build` for the `{profile}` profile \
+             first so `--analyze` can cost each action",
+            log_path.display()
+        );
+    };
+    let analysis = cabin_build::analyze(plan_graph, |output| log.duration(output.as_std_path()));
+    if !analysis.actions.is_empty() && analysis.estimated() == analysis.actions.len() {
+        bail!(
+            "{} records none of the planned actions; run `cabin build` for the `{profile}` \
+             profile first so `--analyze` can cost each action",
+            log_path.display()
+        );
+    }
+    match format {
+        ResolveFormat::Human => {
+            print!("{}", render_human(&analysis, profile, profile_build_root));
+            Ok(())
+        }
+        ResolveFormat::Json => crate::print_pretty_json(
+            &render_json(&analysis, profile),
+            "failed to serialize build analysis as JSON",
+        ),
+    }
+}
+
+fn render_human(analysis: &BuildAnalysis, profile: &str, profile_build_root: &Path) -> String {
+    use std::fmt::Write as _;
+
+    let mut out = String::new();
+    let _ = writeln!(
+        out,
+        "build analysis for `{profile}` profile: {} action(s), {} estimated",
+        analysis.actions.len(),
+        analysis.estimated(),
+    );
+    if analysis.actions.is_empty() {
+        return out;
+    }
+    let _ = writeln!(out, "  total work     {}", seconds(analysis.total_work));
+    let _ = writeln!(out, "  critical path  {}", seconds(analysis.critical_path));
+    let _ = writeln!(
+        out,
+        "  parallelism    {:.2}x (more jobs than this mostly wait on the critical path)",
+        analysis.parallelism()
+    );
+
+    let _ = writeln!(out, "\n  jobs  wall time  speedup");
+    let last = analysis.speedup.len().saturating_sub(1);
+    for (index, point) in analysis.speedup.iter().enumerate() {
+        // Powers of two plus the point where the curve flattens.
+        if !point.jobs.is_power_of_two() && index != last {
+            continue;
+        }
+        let _ = writeln!(
+            out,
+            "  {:>4}  {:>9}  {:>6.2}x",
+            point.jobs,
+            seconds(point.makespan),
+            point.speedup(analysis.total_work),
+        );
+    }
+
+    let mut critical: Vec<_> = analysis
+        .critical_actions
+        .iter()
+        .map(|&index| &analysis.actions[index])
+        .collect();
+    critical.sort_by(|a, b| b.duration.cmp(&a.duration));
+    let _ = writeln!(
+        out,
+        "\n  slowest actions on the critical path ({} of {}):",
+        critical.len().min(TOP_CRITICAL_ACTIONS),
+        critical.len(),
+    );
+    for action in critical.into_iter().take(TOP_CRITICAL_ACTIONS) {
+        let owner = action.owner.as_ref().map_or_else(
+            || "-".to_owned(),
+            |owner| format!("{}:{}", owner.package, owner.target),
+        );
+        let output = action
+            .output
+            .as_std_path()
+            .strip_prefix(profile_build_root)
+            .unwrap_or(action.output.as_std_path());
+        let _ = writeln!(
+            out,
+            "  {:>9}{}  {:<7}  {owner}  {}",
+            seconds(action.duration),
+            if action.estimated { "*" } else { " " },
+            action.kind,
+            output.display(),
+        );
+    }
+    if analysis.estimated() > 0 {
+        let _ = writeln!(
+            out,
+            "\n  * no recorded duration; estimated from the median of recorded actions"
+        );
+    }
+    out
+}
+
+fn render_json(analysis: &BuildAnalysis, profile: &str) -> serde_json::Value {
+    let action = |index: &usize| {
+        let action = &analysis.actions[*index];
+        serde_json::json!({
+            "kind": action.kind,
+            "output": action.output,
+            "package": action.owner.as_ref().map(|owner| owner.package.as_str()),
+            "target": action.owner.as_ref().map(|owner| owner.target.as_str()),
+            "duration_ms": millis(action.duration),
+            "estimated": action.estimated,
+        })
+    };
+    serde_json::json!({
+        "profile": profile,
+        "actions": analysis.actions.len(),
+        "estimated_actions": analysis.estimated(),
+        "total_work_ms": millis(analysis.total_work),
+        "critical_path_ms": millis(analysis.critical_path),
+        "parallelism": analysis.parallelism(),
+        "speedup": analysis
+            .speedup
+            .iter()
+            .map(|point| serde_json::json!({
+                "jobs": point.jobs,
+                "makespan_ms": millis(point.makespan),
+                "speedup": point.speedup(analysis.total_work),
+            }))
+            .collect::<Vec<_>>(),
+        "critical_path": analysis
+            .critical_actions
+            .iter()
+            .map(action)
+            .collect::<Vec<_>>(),
+    })
+}
+
+fn seconds(duration: Duration) -> String {
+    format!("{:.2}s", duration.as_secs_f64())
+}
+
+fn millis(duration: Duration) -> u64 {
+    u64::try_from(duration.as_millis()).unwrap_or(u64::MAX)
+}
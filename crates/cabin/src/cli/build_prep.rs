@@ -74,6 +74,11 @@ pub(crate) struct BuildPrep {
     pub standard_flag_conflicts: HashMap<usize, Vec<cabin_core::StandardFlagConflict>>,
     pub compiler_wrapper: Option<cabin_core::ResolvedCompilerWrapper>,
     pub toolchain_summary: cabin_core::ToolchainSummary,
+    /// Extra environment for the build backend process, inherited by
+    /// every action it spawns.  Carries the `recc` launcher's
+    /// `RECC_*` settings when `[build.remote-execution]` is
+    /// configured; empty otherwise.
+    pub backend_env: BTreeMap<String, String>,
 }
 
 /// Resolve per-package build flags and the compiler wrapper, and
@@ -109,14 +114,51 @@ pub(crate) fn resolve_build_prep(inputs: BuildConfigInputs) -> Result<BuildPrep>
         inputs.toolchain,
         compiler_wrapper.as_ref(),
     );
+    let backend_env = remote_execution_env(
+        inputs.graph,
+        inputs.effective_config,
+        compiler_wrapper.as_ref(),
+    )?;
     Ok(BuildPrep {
         build_flags,
         standard_flag_conflicts,
         compiler_wrapper,
         toolchain_summary,
+        backend_env,
     })
 }
 
+/// Launcher environment for `[build.remote-execution]`, or an empty
+/// map when remote execution is not configured.
+///
+/// Remote execution reuses the compiler-wrapper slot: compiles run
+/// through the REAPI launcher, while archive and link commands (never
+/// wrapped) stay local.  Configuring an endpoint without selecting
+/// that launcher is an error rather than a silent local build.
+fn remote_execution_env(
+    graph: &PackageGraph,
+    effective_config: &cabin_config::EffectiveConfig,
+    compiler_wrapper: Option<&cabin_core::ResolvedCompilerWrapper>,
+) -> Result<BTreeMap<String, String>> {
+    let Some(remote) = &effective_config.build.remote_execution else {
+        return Ok(BTreeMap::new());
+    };
+    let launcher = cabin_core::REMOTE_EXECUTION_LAUNCHER;
+    if compiler_wrapper.is_none_or(|wrapper| wrapper.kind.as_key() != launcher) {
+        bail!(
+            "`[build.remote-execution]` (from the {} config) runs compiles through the `{launcher}` REAPI launcher; select it with `compiler-wrapper = \"{launcher}\"` or `--compiler-wrapper {launcher}`",
+            remote.source.as_key()
+        );
+    }
+    let root = camino::Utf8Path::from_path(&graph.root_dir).ok_or_else(|| {
+        anyhow::anyhow!(
+            "remote execution needs a UTF-8 workspace root, got {}",
+            graph.root_dir.display()
+        )
+    })?;
+    Ok(remote.value.launcher_env(root))
+}
+
 /// Which packages' `[dev-dependencies]` a command activates.
 #[derive(Clone, Copy)]
 pub(crate) enum DevActivation {
@@ -151,6 +193,10 @@ pub(crate) struct WorkspacePipelineArgs<'a> {
     pub workspace_selection: &'a super::WorkspaceSelectionArgs,
     pub toolchain: &'a super::ToolchainSelectionArgs,
     pub dev: DevActivation,
+    /// `cabin check`: the plan is rewritten into a syntax-only check
+    /// with no archive or link actions, so the archiver is never
+    /// probed.
+    pub check_only: bool,
 }
 
 /// Everything the shared preamble produces that the command tails
@@ -419,14 +465,6 @@ pub(crate) fn prepare_workspace(
         &effective_config,
         &host_platform,
     )?;
-    // Detect compiler / archiver identity and validate that the
-    // backend's required capabilities (GCC-style flags, depfile
-    // emission, `-std=c++17`, ar-compatible archiving) are
-    // available before any Ninja file is written.  Fail fast and
-    // clear here rather than letting Ninja produce a confusing
-    // error from a broken command line.
-    let detection_report =
-        cabin_toolchain::detect_toolchain(&toolchain, &cabin_toolchain::ProcessRunner)?;
     // Resolve the workspace package selection up-front.  The planner
     // consumes the selected indices through `PlanRequest::selected_packages`
     // so default-target enumeration narrows to the picked packages instead
@@ -450,6 +488,28 @@ pub(crate) fn prepare_workspace(
         &language_standards,
         &dev_for,
     );
+    // Detect compiler / archiver identity and validate that the
+    // backend's required capabilities (GCC-style flags, depfile
+    // emission, `-std=c++17`, ar-compatible archiving) are
+    // available before any Ninja file is written.  Fail fast and
+    // clear here rather than letting Ninja produce a confusing
+    // error from a broken command line.  Only the tools this
+    // command can run are probed: the package-level C-source
+    // approximation is a superset of the planned C compiles, so a
+    // C++-only build never spawns the C compiler (unless a `cc`
+    // condition gates a profile layer).  Likewise the archiver is
+    // probed only when the closure declares a library target, so
+    // `cabin check` and header-only or executable-only builds never
+    // spawn it.
+    let detection_scope = cabin_toolchain::DetectionScope {
+        c_compiler: approx_standards.has_c_sources() || references_cc_condition(&graph),
+        archiver: !args.check_only && cabin_build::plans_archives(&graph, &selected_closure),
+    };
+    let detection_report = cabin_toolchain::detect_toolchain_scoped(
+        &toolchain,
+        &cabin_toolchain::ProcessRunner,
+        detection_scope,
+    )?;
     cabin_build::validate_toolchain_for_backend(&toolchain, &detection_report)?;
     let ninja = cabin_toolchain::locate_ninja()?;
 
@@ -538,6 +598,67 @@ pub(crate) fn plan_prepared(
     selected: Option<Vec<cabin_build::ManifestTargetSelector>>,
     check: bool,
     color: cabin_core::ColorChoice,
+) -> Result<cabin_build::BuildGraph> {
+    plan_prepared_profile(
+        prepared,
+        &prepared.profile,
+        &prepared.prep,
+        selected,
+        None,
+        check,
+        color,
+    )
+}
+
+/// Resolve an additional `--profile <name>` against an already
+/// prepared workspace.  Everything [`prepare_workspace`] derives
+/// before the profile choice - the loaded graph, resolution,
+/// toolchain detection, features - is profile-independent and
+/// reused; only the profile and its per-package flags are resolved
+/// here.
+pub(crate) fn prepare_additional_profile(
+    prepared: &PreparedWorkspace,
+    name: &str,
+    toolchain_args: &super::ToolchainSelectionArgs,
+    reporter: Reporter,
+) -> Result<(cabin_core::ResolvedProfile, BuildPrep)> {
+    let selection =
+        cabin_core::ProfileSelection::from_name(cabin_core::ProfileName::new(name.to_owned())?);
+    let profile = cabin_core::resolve_profile(
+        &selection,
+        &super::workspace_profile_definitions(&prepared.graph),
+    )?;
+    let manifest_compiler_wrapper = super::workspace_compiler_wrapper_settings(&prepared.graph);
+    let prep = resolve_build_prep(BuildConfigInputs {
+        graph: &prepared.graph,
+        host_platform: &cabin_core::TargetPlatform::current(),
+        toolchain: &prepared.toolchain,
+        detection: Some(&prepared.detection_report),
+        cli_compiler_wrapper: super::compiler_wrapper_override_from_args(toolchain_args)?,
+        manifest_compiler_wrapper: manifest_compiler_wrapper.as_ref(),
+        effective_config: &prepared.effective_config,
+        profile: &profile,
+        dev_for: &prepared.dev_for,
+        feature_resolution: &prepared.feature_resolution,
+        reporter,
+    })?;
+    Ok((profile, prep))
+}
+
+/// [`plan_prepared`] for an explicit `profile` / `prep` pair, so a
+/// multi-profile build can plan each profile from one prepared
+/// workspace.  The standard-compat pass reads no profile input, so
+/// `standard_compat` hands in the violations an earlier profile's
+/// plan already found instead of running the pass again; `None`
+/// runs it.
+pub(crate) fn plan_prepared_profile(
+    prepared: &PreparedWorkspace,
+    profile: &cabin_core::ResolvedProfile,
+    prep: &BuildPrep,
+    selected: Option<Vec<cabin_build::ManifestTargetSelector>>,
+    standard_compat: Option<&[cabin_build::StandardCompatViolation]>,
+    check: bool,
+    color: cabin_core::ColorChoice,
 ) -> Result<cabin_build::BuildGraph> {
     // Validation only: the planner takes no configuration input, but
     // an invalid per-package configuration selection must still fail
@@ -546,21 +667,21 @@ pub(crate) fn plan_prepared(
         &prepared.graph,
         &prepared.selection_request,
         &prepared.resolved_selection.packages,
-        &prepared.profile,
-        &prepared.prep.toolchain_summary,
-        &prepared.prep.build_flags,
+        profile,
+        &prep.toolchain_summary,
+        &prep.build_flags,
     )?;
-    let plan_graph = super::plan(&super::PlanRequest {
+    let mut plan_graph = super::plan(&super::PlanRequest {
         graph: &prepared.graph,
         toolchain: &prepared.toolchain,
-        build_flags: &prepared.prep.build_flags,
+        build_flags: &prep.build_flags,
         language_standards: &prepared.language_standards,
-        standard_flag_conflicts: &prepared.prep.standard_flag_conflicts,
+        standard_flag_conflicts: &prep.standard_flag_conflicts,
         build_dir: prepared.build_dir.clone(),
-        profile: prepared.profile.clone(),
+        profile: profile.clone(),
         selected,
         selected_packages: Some(&prepared.resolved_selection.packages),
-        compiler_wrapper: prepared.prep.compiler_wrapper.as_ref(),
+        compiler_wrapper: prep.compiler_wrapper.as_ref(),
         dialect: cabin_build::Dialect::from_compiler_kind(
             prepared.detection_report.cxx.identity.kind,
         ),
@@ -568,16 +689,23 @@ pub(crate) fn plan_prepared(
             &prepared.detection_report,
             prepared.approx_standards.has_c_sources(),
         ),
+        thin_archives: profile.thin_archives
+            && cabin_build::thin_archives_supported(&prepared.detection_report),
+        archive_response_files: cabin_build::archive_response_files(&prepared.detection_report),
+        target_arch: prepared.detection_report.cxx.identity.arch(),
         enabled_features: Some(&prepared.enabled_features),
-        standard_compat: true,
+        standard_compat: standard_compat.is_none(),
     })?;
+    if let Some(violations) = standard_compat {
+        plan_graph.standard_compat_violations = violations.to_vec();
+    }
     // `cabin check` reuses the build graph but rewrites it into a
     // syntax-only check (no codegen, no link) scoped to the selected
     // workspace packages' own translation units.
     let plan_graph = if check {
         let packages_root = prepared
             .build_dir
-            .join(prepared.profile.name.as_str())
+            .join(profile.name.as_str())
             .join("packages");
         // Fold `path_components` so the scoping roots stay
         // byte-identical to the planner's `packages/<scope>/<name>`
@@ -610,14 +738,35 @@ pub(crate) fn plan_prepared(
     // (which drops dependency compiles) and before any Ninja file is
     // written.
     cabin_build::validate_planned_standards(&plan_graph)?;
+    let requested = cabin_build::requested_standards_of(&plan_graph);
     cabin_build::validate_toolchain_standards(
         &prepared.toolchain,
         &prepared.detection_report,
-        &cabin_build::requested_standards_of(&plan_graph),
+        &requested,
+    )?;
+    cabin_build::validate_target_cpu(
+        &prepared.toolchain,
+        &prepared.detection_report,
+        &requested,
+        profile.target_cpu.as_ref(),
     )?;
     Ok(plan_graph)
 }
 
+/// Whether any package's `[target.'cfg(...)'.profile]` layer tests
+/// the C compiler (`cc` / `cc_version`).  Such a layer evaluates
+/// against the detected C compiler identity, so the C compiler must
+/// be probed even when no C source is compiled.
+pub(crate) fn references_cc_condition(graph: &PackageGraph) -> bool {
+    graph.packages.iter().any(|pkg| {
+        pkg.package.build.conditional.iter().any(|layer| {
+            layer
+                .condition
+                .references_compiler_slot(cabin_core::CompilerSlot::Cc)
+        })
+    })
+}
+
 /// Render the optimization / debuginfo descriptor that follows
 /// the profile name in the `Finished` status line, matching
 /// cargo's own banner:
@@ -842,6 +991,13 @@ pub(crate) fn resolve_per_package_build_flags(
         ),
         None => (None, None),
     };
+    // `[target.'cfg(target_feature = ...)'.profile]` layers read the
+    // features the profile's `target-cpu` implies.
+    let target_features = profile
+        .target_cpu
+        .as_ref()
+        .map(cabin_core::TargetCpu::target_features)
+        .unwrap_or_default();
     let mut out = HashMap::with_capacity(graph.packages.len());
     let mut conflicts: HashMap<usize, Vec<cabin_core::StandardFlagConflict>> = HashMap::new();
     for (idx, pkg) in graph.packages.iter().enumerate() {
@@ -862,7 +1018,8 @@ pub(crate) fn resolve_per_package_build_flags(
             host_platform,
             &package_features.enabled_features,
         )
-        .with_compilers(cc_identity, cxx_identity);
+        .with_compilers(cc_identity, cxx_identity)
+        .with_target_features(&target_features);
         let resolved = cabin_core::resolve_build_flags(
             &pkg.package.build,
             Some(profile),
@@ -954,7 +1111,7 @@ pub(crate) fn resolve_build_configurations(
             package: pkg.package.name.as_str(),
             features: &pkg.package.features,
             request: &pkg_request,
-            profile: profile.clone(),
+            profile: profile.for_package(&pkg.package.name, graph.primary_packages.contains(&idx)),
             toolchain: toolchain.clone(),
             build_flags: pkg_flags,
             language: cabin_core::LanguageStandardsSummary::from_package(&pkg.package),
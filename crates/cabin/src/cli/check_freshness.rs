@@ -0,0 +1,125 @@
+//! Glue layer letting a `cabin build` satisfy a later `cabin check`.
+//!
+//! A successful build records, in `<build-dir>/<profile>/.cabin_objects`,
+//! the [`cabin_build::compile_fingerprint`] of every object it compiled.
+//! `cabin check` then drops each syntax check whose object is recorded
+//! under the check's own fingerprint and is no older than its source,
+//! its implicit inputs, and every header Ninja's `.ninja_deps` lists for
+//! it - Ninja's own freshness rule for that object.  The build compiled
+//! exactly what the check would, so the check has nothing to add.
+//!
+//! Every other Ninja run in the profile root forgets the record before
+//! it starts and rewrites it only once Ninja succeeds, so a failed or
+//! interrupted build never vouches for an object it may have left
+//! stale.  A check run never writes an object and keeps the record.
+
+use std::collections::HashMap;
+use std::fmt::Write as _;
+use std::path::{Path, PathBuf};
+use std::time::SystemTime;
+
+use anyhow::{Context, Result};
+
+use cabin_build::{BuildGraph, compile_fingerprint};
+
+use super::term_verbosity::Reporter;
+
+/// Record file name under the profile build root.
+const RECORD_FILE: &str = ".cabin_objects";
+/// First line of the record; a record with any other header is
+/// ignored, so a format change only costs one full check.
+const RECORD_HEADER: &str = "# cabin objects v1";
+
+/// Drop the record before a build runs Ninja in `profile_build_root`.
+pub(super) fn forget(profile_build_root: &Path) -> Result<()> {
+    let path = profile_build_root.join(RECORD_FILE);
+    match std::fs::remove_file(&path) {
+        Ok(()) => Ok(()),
+        Err(err) if err.kind() == std::io::ErrorKind::NotFound => Ok(()),
+        Err(err) => Err(err).with_context(|| format!("failed to remove {}", path.display())),
+    }
+}
+
+/// Record the objects a successful Ninja run of `plan_graph` compiled.
+pub(super) fn record(profile_build_root: &Path, plan_graph: &BuildGraph) -> Result<()> {
+    let mut out = format!("{RECORD_HEADER}\n");
+    for compile in cabin_build::default_compiles(plan_graph) {
+        let _ = writeln!(
+            out,
+            "{}\t{}",
+            compile_fingerprint(plan_graph.dialect, compile),
+            compile.object,
+        );
+    }
+    let path = profile_build_root.join(RECORD_FILE);
+    cabin_fs::write_atomic(&path, out)
+        .with_context(|| format!("failed to write {}", path.display()))
+}
+
+/// Drop from `check_graph` the checks an earlier build already
+/// satisfied.  The record and `.ninja_deps` only ever remove work, so
+/// when either is missing or unreadable every check simply runs.
+pub(super) fn skip_satisfied(
+    profile_build_root: &Path,
+    check_graph: BuildGraph,
+    reporter: Reporter,
+) -> BuildGraph {
+    let Some(recorded) = read_record(&profile_build_root.join(RECORD_FILE)) else {
+        return check_graph;
+    };
+    let Ok(Some(deps_log)) = cabin_ninja::DepsLog::read(&profile_build_root.join(".ninja_deps"))
+    else {
+        return check_graph;
+    };
+    let headers = deps_log.inputs_by_output();
+    let mut mtimes: HashMap<PathBuf, Option<SystemTime>> = HashMap::new();
+    let mut mtime = |path: &Path| {
+        *mtimes
+            .entry(path.to_path_buf())
+            .or_insert_with(|| std::fs::metadata(path).and_then(|m| m.modified()).ok())
+    };
+
+    let dialect = check_graph.dialect;
+    let planned = check_graph.actions.len();
+    let graph = cabin_build::without_satisfied_checks(check_graph, |compile| {
+        let object = compile.object.as_std_path();
+        if recorded.get(object) != Some(&compile_fingerprint(dialect, compile)) {
+            return false;
+        }
+        // An object Ninja holds no header list for cannot be proven
+        // fresh against its headers.
+        let (Some(built), Some(headers)) = (mtime(object), headers.get(object)) else {
+            return false;
+        };
+        std::iter::once(compile.source.as_std_path())
+            .chain(
+                compile
+                    .implicit_inputs
+                    .iter()
+                    .map(|input| input.as_std_path()),
+            )
+            .chain(headers.iter().copied())
+            .all(|input| mtime(input).is_some_and(|modified| modified <= built))
+    });
+    let skipped = planned - graph.actions.len();
+    if skipped > 0 {
+        reporter.verbose(format_args!(
+            "cabin: {skipped} translation unit(s) already checked by an up-to-date build"
+        ));
+    }
+    graph
+}
+
+fn read_record(path: &Path) -> Option<HashMap<PathBuf, String>> {
+    let text = std::fs::read_to_string(path).ok()?;
+    let mut lines = text.lines();
+    if lines.next() != Some(RECORD_HEADER) {
+        return None;
+    }
+    Some(
+        lines
+            .filter_map(|line| line.split_once('\t'))
+            .map(|(fingerprint, object)| (PathBuf::from(object), fingerprint.to_owned()))
+            .collect(),
+    )
+}
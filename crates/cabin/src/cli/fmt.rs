@@ -21,8 +21,8 @@ use cabin_fmt::{
 use cabin_source_discovery::{SourceDiscoveryRequest, discover_sources};
 
 use crate::cli::source_tooling::{
-    absolutize, describe_packages, display_workspace_relative, nested_package_excludes,
-    package_selection_from_flags,
+    absolutize, changed_paths_from_flags, describe_packages, display_workspace_relative,
+    nested_package_excludes, package_selection_from_flags,
 };
 use crate::cli::term_verbosity::Reporter;
 use crate::plural;
@@ -78,6 +78,23 @@ pub(crate) struct FmtArgs {
     /// workspace declares no default-members.
     #[arg(long, conflicts_with_all = &["workspace", "package"])]
     pub default_members: bool,
+
+    /// Only format files with uncommitted changes: staged,
+    /// unstaged, or untracked relative to git `HEAD`.  Suited
+    /// to pre-commit hooks.
+    #[arg(long, conflicts_with = "since")]
+    pub changed: bool,
+
+    /// With `--changed`, only format files staged in the git
+    /// index; unstaged edits and untracked files are left alone.
+    #[arg(long, requires = "changed")]
+    pub cached: bool,
+
+    /// Only format files changed since the merge base of REV
+    /// and `HEAD`, plus uncommitted changes.  Suited to PR CI,
+    /// e.g. `--since origin/main`.
+    #[arg(long, value_name = "REV")]
+    pub since: Option<String>,
 }
 
 /// Entry point invoked by the top-level dispatcher.
@@ -126,9 +143,25 @@ pub(crate) fn fmt(args: &FmtArgs, reporter: Reporter) -> Result<ExitCode> {
         excluded_directories,
         respect_vcs_ignore: !args.no_ignore_vcs,
     };
+    let changed = changed_paths_from_flags(
+        &graph.root_dir,
+        args.changed,
+        args.cached,
+        args.since.as_deref(),
+    )?;
     let discovered = discover_sources(&request)
         .map_err(|err| anyhow::anyhow!("source discovery failed: {err}"))?;
-    let files: Vec<PathBuf> = discovered.into_iter().map(|f| f.absolute_path).collect();
+    // Scoping only narrows the walked set, so every exclusion and
+    // selection rule above still holds for a `--changed` run.
+    let files: Vec<PathBuf> = discovered
+        .into_iter()
+        .map(|f| f.absolute_path)
+        .filter(|path| {
+            changed
+                .as_ref()
+                .is_none_or(|changed| changed.contains(&cabin_fs::canonicalize_or_input(path)))
+        })
+        .collect();
 
     let executable = resolve_formatter_executable(|key| std::env::var_os(key));
     let mode = if args.check {
@@ -12,6 +12,8 @@ use crate::completions::CompgenArgs;
 use crate::manpages::MangenArgs;
 
 pub(crate) mod add;
+pub(crate) mod bench;
+pub(crate) mod bloat;
 pub(crate) mod build_prep;
 pub(crate) mod config;
 pub(crate) mod env_flags;
@@ -38,6 +40,8 @@ pub(crate) mod version;
 pub(crate) mod yank;
 
 mod build;
+mod build_analysis;
+mod check_freshness;
 mod clean;
 mod init;
 mod manifest_edit;
@@ -362,6 +366,18 @@ pub(crate) enum Command {
     /// environment overlay.
     #[command(visible_alias = "t")]
     Test(crate::cli::test::TestArgs),
+    /// Run the benchmarks of a local package.
+    ///
+    /// Builds the workspace's `bench` targets with the `release`
+    /// profile, runs each one, and compares the results against
+    /// a saved baseline.
+    Bench(crate::cli::bench::BenchArgs),
+    /// Attribute the size of built executables.
+    ///
+    /// Builds the selected `executable` targets with linker maps
+    /// and reports their text, data and debug bytes per package,
+    /// target and symbol, optionally against a saved baseline.
+    Bloat(crate::cli::bloat::BloatArgs),
     /// Resolve versioned dependencies.
     ///
     /// Resolves the manifest's versioned dependencies against
@@ -629,9 +645,10 @@ pub(crate) struct BuildArgs {
 
     /// Select the build profile (`dev`, `release`, or any custom
     /// profile declared in `[profile.<name>]`).  Defaults to `dev`.
-    /// Mutually exclusive with `--release`.
+    /// May be passed multiple times to build several profiles in one
+    /// Ninja run.  Mutually exclusive with `--release`.
     #[arg(long, value_name = "NAME")]
-    pub profile: Option<String>,
+    pub profile: Vec<String>,
 
     /// Path to a directory containing the local JSON package index.
     /// Required when the manifest declares any versioned dependencies
@@ -711,6 +728,20 @@ pub(crate) struct BuildArgs {
     /// value must be a positive integer; `0` is rejected.
     #[arg(short = 'j', long = "jobs", value_name = "N")]
     pub jobs: Option<cabin_core::BuildJobs>,
+
+    /// Plan the build without running it and report how far it can
+    /// parallelize: total work, critical path, the speedup curve over
+    /// job counts, and the slowest critical-path actions by package
+    /// and target.  Actions are costed from the previous build's
+    /// `.ninja_log`.  `--analyze=json` emits a JSON document.
+    #[arg(
+        long,
+        value_name = "FORMAT",
+        num_args = 0..=1,
+        require_equals = true,
+        default_missing_value = "human"
+    )]
+    pub analyze: Option<ResolveFormat>,
 }
 
 /// Toolchain-selection flag bundle shared by `cabin build` and
@@ -1178,6 +1209,14 @@ pub(crate) fn run(
             crate::cli::test::test(&args, reporter, color, &experimental_features)
                 .map(|()| ExitCode::SUCCESS)
         }
+        Command::Bench(args) => {
+            crate::cli::bench::bench(&args, reporter, color, &experimental_features)
+                .map(|()| ExitCode::SUCCESS)
+        }
+        Command::Bloat(args) => {
+            crate::cli::bloat::bloat(&args, reporter, color, &experimental_features)
+                .map(|()| ExitCode::SUCCESS)
+        }
         Command::Resolve(args) => {
             resolve(&args, reporter, &experimental_features).map(|()| ExitCode::SUCCESS)
         }
@@ -1208,7 +1247,8 @@ pub(crate) fn run(
         Command::Fmt(args) => crate::cli::fmt::fmt(&args, reporter),
         Command::Tidy(args) => crate::cli::tidy::tidy(&args, reporter),
         Command::Port(args) => {
-            crate::port_subcommand::port(&args, reporter).map(|()| ExitCode::SUCCESS)
+            crate::port_subcommand::port(&args, reporter);
+            Ok(ExitCode::SUCCESS)
         }
         Command::Compgen(args) => crate::completions::run(&args).map(|()| ExitCode::SUCCESS),
         Command::Mangen(args) => crate::manpages::run(&args).map(|()| ExitCode::SUCCESS),
@@ -15,7 +15,7 @@
 //! `cabin test` (in [`crate::cli::test`]) so each command renders
 //! Ninja output the same way.
 
-use std::collections::{BTreeSet, HashMap, HashSet};
+use std::collections::{BTreeMap, BTreeSet, HashMap, HashSet};
 
 use anyhow::Context as _;
 
@@ -104,19 +104,23 @@ pub(crate) fn discovered_msvc_install_applies(
 ///
 /// Verbose mode (`-v`) restores the full Ninja output so users
 /// who want to inspect the backend's progress have a knob.
+///
+/// `attribution_root` anchors the `/packages/<name>/` search that
+/// attributes progress lines to packages: the profile build root for
+/// one profile, the build directory when several profiles share one
+/// Ninja run.
 pub(crate) fn run_ninja(
     cmd: &mut std::process::Command,
-    profile_build_root: &std::path::Path,
+    attribution_root: &std::path::Path,
     reporter: Reporter,
     graph: &cabin_workspace::PackageGraph,
-    plan_graph: &cabin_build::BuildGraph,
+    dialect: cabin_build::Dialect,
+    planned_packages: &BTreeSet<String>,
     apply_discovered_msvc_install: bool,
 ) -> std::io::Result<NinjaRun> {
     use std::io::{BufRead, BufReader, Write as _};
     use std::process::Stdio;
 
-    let dialect = plan_graph.dialect;
-
     // Only an MSVC build graph gets the MSVC environment overlay
     // (`VSLANG`, and the auto-discovered `INCLUDE` / `LIB` / `PATH`).
     // A GNU-style toolchain on Windows must run in the environment it
@@ -155,17 +159,13 @@ pub(crate) fn run_ninja(
     let pkg_by_name: HashMap<&str, &cabin_workspace::WorkspacePackage> = graph
         .packages
         .iter()
-        .filter(|pkg| {
-            plan_graph
-                .planned_packages
-                .contains(pkg.package.name.as_str())
-        })
+        .filter(|pkg| planned_packages.contains(pkg.package.name.as_str()))
         .map(|pkg| (pkg.package.name.as_str(), pkg))
         .collect();
     let mut announced: HashSet<String> = HashSet::new();
     // Non-UTF-8 build roots fall back to the unanchored search;
     // the planner rejects non-UTF-8 paths long before Ninja runs.
-    let profile_root_str = profile_build_root.to_str();
+    let profile_root_str = attribution_root.to_str();
 
     let mut child = cmd
         .stdout(Stdio::piped())
@@ -490,6 +490,11 @@ pub(crate) struct NinjaInvocationRequest<'a> {
     /// Planned build graph to lower into `build.ninja` and
     /// `compile_commands.json`.
     pub plan_graph: &'a cabin_build::BuildGraph,
+    /// Whether `plan_graph` is a `cabin check` graph.  A check writes
+    /// no object, so it keeps the record of objects an earlier build
+    /// compiled ([`crate::cli::check_freshness`]); any other run
+    /// replaces it.
+    pub check: bool,
     /// Loaded workspace graph, used to attribute Ninja progress lines
     /// to packages and to render a link-failure hint.
     pub graph: &'a cabin_workspace::PackageGraph,
@@ -509,9 +514,41 @@ pub(crate) struct NinjaInvocationRequest<'a> {
     pub ninja: &'a std::path::Path,
     /// Parallelism for Ninja's `-j` flag, or `None` to let Ninja pick.
     pub jobs: Option<cabin_core::BuildJobs>,
+    /// Extra environment for the Ninja process
+    /// ([`crate::cli::build_prep::BuildPrep::backend_env`]).
+    pub env: &'a BTreeMap<String, String>,
+    pub reporter: Reporter,
+}
+
+/// Inputs for [`invoke_multi_profile_ninja_and_report`]: one planned
+/// graph per selected profile, built by a single Ninja process.  The
+/// remaining fields mean the same as on [`NinjaInvocationRequest`].
+pub(crate) struct MultiProfileNinjaRequest<'a> {
+    /// Resolved, absolute build directory.  Holds each profile's
+    /// `build/<profile>` root plus the combined
+    /// [`MULTI_PROFILE_NINJA_FILE`].
+    pub build_dir: &'a std::path::Path,
+    /// `(profile, planned graph)` pairs in the order the user passed
+    /// `--profile`.  All graphs share one toolchain and so one dialect.
+    pub profiles: &'a [(cabin_core::ResolvedProfile, cabin_build::BuildGraph)],
+    pub check: bool,
+    pub graph: &'a cabin_workspace::PackageGraph,
+    pub toolchain: &'a cabin_core::ResolvedToolchain,
+    pub cxx_kind: cabin_core::CompilerKind,
+    pub feature_resolution: &'a cabin_feature::FeatureResolution,
+    pub dev_for: &'a BTreeSet<String>,
+    pub ninja: &'a std::path::Path,
+    pub jobs: Option<cabin_core::BuildJobs>,
+    /// Extra environment for the Ninja process
+    /// ([`crate::cli::build_prep::BuildPrep::backend_env`]).
+    pub env: &'a BTreeMap<String, String>,
     pub reporter: Reporter,
 }
 
+/// File name of the top-level Ninja file a multi-profile build writes
+/// directly under the build directory.
+pub(crate) const MULTI_PROFILE_NINJA_FILE: &str = "multi-profile.ninja";
+
 /// Write `build.ninja` + `compile_commands.json` for the planned graph
 /// under `build/<profile>/`, invoke Ninja there, and surface a
 /// link-failure hint before bailing on a non-zero exit.  Returns the
@@ -525,7 +562,100 @@ pub(crate) struct NinjaInvocationRequest<'a> {
 pub(crate) fn invoke_ninja_and_report(
     req: &NinjaInvocationRequest<'_>,
 ) -> anyhow::Result<std::time::Duration> {
-    let profile_build_root = req.build_dir.join(req.profile.name.as_str());
+    let profile_build_root =
+        write_profile_ninja_files(req.build_dir, req.profile, req.plan_graph, req.reporter)?;
+    if !req.check {
+        super::check_freshness::forget(&profile_build_root)?;
+    }
+    let elapsed = drive_ninja(&NinjaDrive {
+        working_dir: &profile_build_root,
+        ninja_file: None,
+        attribution_root: &profile_build_root,
+        dialect: req.plan_graph.dialect,
+        planned_packages: &req.plan_graph.planned_packages,
+        graph: req.graph,
+        toolchain: req.toolchain,
+        cxx_kind: req.cxx_kind,
+        feature_resolution: req.feature_resolution,
+        dev_for: req.dev_for,
+        ninja: req.ninja,
+        jobs: req.jobs,
+        env: req.env,
+        reporter: req.reporter,
+    })?;
+    if !req.check {
+        super::check_freshness::record(&profile_build_root, req.plan_graph)?;
+    }
+    Ok(elapsed)
+}
+
+/// Multi-profile counterpart of [`invoke_ninja_and_report`].  Writes
+/// every profile's `build/<profile>/` files exactly as a single-profile
+/// build would (so a later `--profile <one>` run or an IDE reading
+/// `compile_commands.json` sees the same tree), then writes
+/// [`MULTI_PROFILE_NINJA_FILE`] subninja-ing them all and runs one
+/// Ninja over it.  Every profile's actions then compete for the same
+/// `-j` slots instead of running back to back.
+///
+/// The combined run keeps its own `.ninja_log` / `.ninja_deps` under
+/// the build directory, separate from each profile root's, so the
+/// first switch between the combined and the per-profile form
+/// re-runs actions Ninja has no log entry for.
+///
+/// # Errors
+/// Same as [`invoke_ninja_and_report`], plus a failure to write the
+/// combined file.
+pub(crate) fn invoke_multi_profile_ninja_and_report(
+    req: &MultiProfileNinjaRequest<'_>,
+) -> anyhow::Result<std::time::Duration> {
+    let Some((_, first_graph)) = req.profiles.first() else {
+        anyhow::bail!("a multi-profile build needs at least one profile");
+    };
+    let dialect = first_graph.dialect;
+    let mut profile_files = Vec::with_capacity(req.profiles.len());
+    let mut planned_packages = BTreeSet::new();
+    for (profile, plan_graph) in req.profiles {
+        let root = write_profile_ninja_files(req.build_dir, profile, plan_graph, req.reporter)?;
+        // The combined run logs header dependencies under the build
+        // directory, not the profile root, so it leaves no record
+        // behind for `cabin check`.
+        if !req.check {
+            super::check_freshness::forget(&root)?;
+        }
+        profile_files.push(root.join("build.ninja"));
+        planned_packages.extend(plan_graph.planned_packages.iter().cloned());
+    }
+    let combined = req.build_dir.join(MULTI_PROFILE_NINJA_FILE);
+    cabin_ninja::write_multi_profile_ninja(&combined, &profile_files)?;
+    req.reporter
+        .verbose(format_args!("cabin: wrote {}", combined.display()));
+    drive_ninja(&NinjaDrive {
+        working_dir: req.build_dir,
+        ninja_file: Some(MULTI_PROFILE_NINJA_FILE),
+        attribution_root: req.build_dir,
+        dialect,
+        planned_packages: &planned_packages,
+        graph: req.graph,
+        toolchain: req.toolchain,
+        cxx_kind: req.cxx_kind,
+        feature_resolution: req.feature_resolution,
+        dev_for: req.dev_for,
+        ninja: req.ninja,
+        jobs: req.jobs,
+        env: req.env,
+        reporter: req.reporter,
+    })
+}
+
+/// Create `build/<profile>/` and write its `build.ninja` +
+/// `compile_commands.json`.  Returns the profile build root.
+fn write_profile_ninja_files(
+    build_dir: &std::path::Path,
+    profile: &cabin_core::ResolvedProfile,
+    plan_graph: &cabin_build::BuildGraph,
+    reporter: Reporter,
+) -> anyhow::Result<std::path::PathBuf> {
+    let profile_build_root = build_dir.join(profile.name.as_str());
     std::fs::create_dir_all(&profile_build_root).with_context(|| {
         format!(
             "failed to create build directory {}",
@@ -534,55 +664,90 @@ pub(crate) fn invoke_ninja_and_report(
     })?;
 
     let ninja_file = profile_build_root.join("build.ninja");
-    cabin_ninja::write_build_ninja(&ninja_file, req.plan_graph, &check_stamp_runner())?;
+    cabin_ninja::write_build_ninja(&ninja_file, plan_graph, &check_stamp_runner())?;
     let ccmd_file = profile_build_root.join("compile_commands.json");
-    cabin_ninja::write_compile_commands(&ccmd_file, req.plan_graph)?;
+    cabin_ninja::write_compile_commands(&ccmd_file, plan_graph)?;
 
     // Implementation-detail status is verbose-only: under `-v` the
     // user sees which files Cabin wrote and how Ninja was invoked,
     // alongside Ninja's own raw banner.
-    req.reporter
-        .verbose(format_args!("cabin: wrote {}", ninja_file.display()));
-    req.reporter
-        .verbose(format_args!("cabin: wrote {}", ccmd_file.display()));
-    let ninja_verbose = req.reporter.verbosity().shows_verbose();
-    req.reporter.verbose(format_args!(
-        "cabin: invoking {} {}{}-C {}",
-        req.ninja.display(),
-        ninja_jobs_echo(req.jobs),
+    reporter.verbose(format_args!("cabin: wrote {}", ninja_file.display()));
+    reporter.verbose(format_args!("cabin: wrote {}", ccmd_file.display()));
+    Ok(profile_build_root)
+}
+
+/// One Ninja invocation, after its files are written.
+struct NinjaDrive<'a> {
+    /// Directory passed to Ninja's `-C`.
+    working_dir: &'a std::path::Path,
+    /// Ninja file passed to `-f`, relative to `working_dir`; `None`
+    /// uses Ninja's default `build.ninja`.
+    ninja_file: Option<&'a str>,
+    attribution_root: &'a std::path::Path,
+    dialect: cabin_build::Dialect,
+    planned_packages: &'a BTreeSet<String>,
+    graph: &'a cabin_workspace::PackageGraph,
+    toolchain: &'a cabin_core::ResolvedToolchain,
+    cxx_kind: cabin_core::CompilerKind,
+    feature_resolution: &'a cabin_feature::FeatureResolution,
+    dev_for: &'a BTreeSet<String>,
+    ninja: &'a std::path::Path,
+    jobs: Option<cabin_core::BuildJobs>,
+    env: &'a BTreeMap<String, String>,
+    reporter: Reporter,
+}
+
+/// Spawn Ninja for `drive`, tee its output, and surface a link-failure
+/// hint before bailing on a non-zero exit.
+fn drive_ninja(drive: &NinjaDrive<'_>) -> anyhow::Result<std::time::Duration> {
+    let ninja_verbose = drive.reporter.verbosity().shows_verbose();
+    drive.reporter.verbose(format_args!(
+        "cabin: invoking {} {}{}-C {}{}",
+        drive.ninja.display(),
+        ninja_jobs_echo(drive.jobs),
         ninja_verbose_echo(ninja_verbose),
-        profile_build_root.display()
+        drive.working_dir.display(),
+        drive
+            .ninja_file
+            .map(|file| format!(" -f {file}"))
+            .unwrap_or_default(),
     ));
 
-    let mut ninja_cmd = std::process::Command::new(req.ninja);
+    let mut ninja_cmd = std::process::Command::new(drive.ninja);
     // The registry credential is Cabin's input, not the build
     // backend's: scrub it so Ninja and every compile / wrapper
     // command it spawns can never read the token.
     ninja_cmd.env_remove(cabin_env::CABIN_REGISTRY_TOKEN);
-    if let Some(jobs) = req.jobs {
+    ninja_cmd.envs(drive.env);
+    if let Some(jobs) = drive.jobs {
         ninja_cmd.arg(ninja_jobs_arg(jobs));
     }
     if ninja_verbose {
         ninja_cmd.arg("-v");
     }
+    ninja_cmd.arg("-C").arg(drive.working_dir);
+    if let Some(file) = drive.ninja_file {
+        ninja_cmd.arg("-f").arg(file);
+    }
     let build_started = std::time::Instant::now();
     let run = run_ninja(
-        ninja_cmd.arg("-C").arg(&profile_build_root),
-        &profile_build_root,
-        req.reporter,
-        req.graph,
-        req.plan_graph,
-        discovered_msvc_install_applies(req.toolchain, req.cxx_kind),
+        &mut ninja_cmd,
+        drive.attribution_root,
+        drive.reporter,
+        drive.graph,
+        drive.dialect,
+        drive.planned_packages,
+        discovered_msvc_install_applies(drive.toolchain, drive.cxx_kind),
     )
-    .with_context(|| format!("failed to invoke ninja at {}", req.ninja.display()))?;
+    .with_context(|| format!("failed to invoke ninja at {}", drive.ninja.display()))?;
     if !run.status.success() {
         emit_link_diagnostic_if_applicable(
             &run,
-            req.graph,
-            &req.plan_graph.planned_packages,
-            req.feature_resolution,
-            req.dev_for,
-            req.reporter,
+            drive.graph,
+            drive.planned_packages,
+            drive.feature_resolution,
+            drive.dev_for,
+            drive.reporter,
         );
         anyhow::bail!("ninja exited with {}", run.status);
     }
@@ -22,7 +22,7 @@ use std::collections::{BTreeMap, BTreeSet};
 use std::path::{Path, PathBuf};
 
 use anyhow::{Context, Result, anyhow};
-use semver::{Version, VersionReq};
+use semver::VersionReq;
 
 use cabin_core::{DependencyKind, DependencySource, PortDepSource, TargetPlatform};
 use cabin_index_http::HttpClient;
@@ -665,8 +665,8 @@ fn build_plan_entries(
                     .first()
                     .expect("walk pushes at least one VersionReq per builtin name");
                 let Some(recipe) = cabin_port::builtin::lookup(name, primary_req) else {
-                    let available: Vec<String> = cabin_port::builtin::iter()
-                        .filter(|p| p.name == name)
+                    let available: Vec<String> = cabin_port::builtin::versions(name)
+                        .iter()
                         .map(|p| p.version.to_owned())
                         .collect();
                     return Err(if available.is_empty() {
@@ -680,16 +680,10 @@ fn build_plan_entries(
                         .into()
                     });
                 };
-                let recipe_version = Version::parse(recipe.version).with_context(|| {
-                    format!(
-                        "bundled port `{name}` version `{}` is not valid SemVer",
-                        recipe.version
-                    )
-                })?;
                 for extra in reqs.iter().skip(1) {
-                    if !extra.matches(&recipe_version) {
-                        let available: Vec<String> = cabin_port::builtin::iter()
-                            .filter(|p| p.name == name)
+                    if !extra.matches(&recipe.parsed_version) {
+                        let available: Vec<String> = cabin_port::builtin::versions(name)
+                            .iter()
                             .map(|p| p.version.to_owned())
                             .collect();
                         return Err(cabin_port::PortError::BuiltinVersionNotFound {
@@ -700,9 +694,9 @@ fn build_plan_entries(
                         .into());
                     }
                 }
-                let descriptor =
-                    cabin_port::parse_port_str(recipe.port_toml, std::path::Path::new("<builtin>"))
-                        .with_context(|| format!("parsing bundled port `{name}`"))?;
+                let descriptor = recipe
+                    .descriptor()
+                    .with_context(|| format!("parsing bundled port `{name}`"))?;
                 (descriptor, PortOrigin::Builtin(recipe.name))
             }
         };
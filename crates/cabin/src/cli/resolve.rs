@@ -429,14 +429,15 @@ fn run_resolution(request: &ResolutionRequest<'_>, reporter: Reporter) -> Result
         None => {
             bail!(crate::cli::VERSIONED_DEPS_REQUIRE_INDEX)
         }
-        Some(cabin_core::SourceLocator::IndexPath { path }) => {
-            load_local_index(path.as_std_path(), request.experimental_features)?
-        }
+        Some(cabin_core::SourceLocator::IndexPath { path }) => ResolverIndex::Local(
+            load_local_index(path.as_std_path(), request.experimental_features)?,
+        ),
         // The resolve pipeline performs no artifact downloads, so the
         // HTTP client the helper returns for connection reuse is
         // dropped here.
         Some(cabin_core::SourceLocator::IndexUrl { url }) => {
-            load_http_index(url, &root_deps, request.experimental_features, reporter)?.0
+            let (index, _) = load_http_index(url, request.experimental_features, reporter)?;
+            ResolverIndex::Http(Box::new(index))
         }
     };
 
@@ -476,7 +477,7 @@ fn run_resolution(request: &ResolutionRequest<'_>, reporter: Reporter) -> Result
     input.incompatible_standards =
         crate::cli::config::resolve_incompatible_standards(&effective_config)?;
 
-    let output = cabin_resolver::resolve(&input, &index).context("dependency resolution failed")?;
+    let (output, index) = index.resolve(&input, HeldBackReport::Compute)?;
 
     let mut new_lockfile = lockfile_from_resolution(&output, &index);
     new_lockfile.patches = active_patch_records;
@@ -920,7 +921,6 @@ pub(crate) fn run_artifact_pipeline(
     let (index, access) = load_index_for_pipeline(
         request.index_source,
         request.policy.frozen(),
-        &root_deps,
         request.experimental_features,
         request.reporter,
     )?;
@@ -972,8 +972,7 @@ pub(crate) fn run_artifact_pipeline(
     // Build/run/test/vendor consume only the resolved graph (into the
     // lockfile) and never render `held_back`, so use the lean resolve
     // that skips the second `Allow`-mode solve behind the report.
-    let output =
-        cabin_resolver::resolve_packages(&input, &index).context("dependency resolution failed")?;
+    let (output, index) = index.resolve(&input, HeldBackReport::Skip)?;
 
     let mut new_lockfile = lockfile_from_resolution(&output, &index);
     new_lockfile.patches = active_patch_records;
@@ -1033,28 +1032,77 @@ pub(crate) fn run_artifact_pipeline(
     })
 }
 
+/// The index the resolver reads: a directory loaded up front, or a
+/// sparse HTTP registry fetched package by package as the solve
+/// reaches each one.
+enum ResolverIndex {
+    Local(PackageIndex),
+    Http(Box<cabin_index_http::LazyHttpIndex>),
+}
+
+/// Whether [`ResolverIndex::resolve`] computes the standard hold-back
+/// report, which costs a second solve.
+#[derive(Clone, Copy)]
+enum HeldBackReport {
+    Compute,
+    Skip,
+}
+
+impl ResolverIndex {
+    /// Resolve `input` against this index, returning the output with
+    /// the [`PackageIndex`] the lockfile and fetch plan read
+    /// afterwards.  For the HTTP index that is every package the
+    /// solve fetched, which covers every resolved package.
+    fn resolve(
+        self,
+        input: &ResolveInput,
+        held_back: HeldBackReport,
+    ) -> Result<(ResolveOutput, PackageIndex)> {
+        fn run<S: cabin_index::IndexSource>(
+            input: &ResolveInput,
+            index: &S,
+            held_back: HeldBackReport,
+        ) -> Result<ResolveOutput> {
+            match held_back {
+                HeldBackReport::Compute => cabin_resolver::resolve(input, index),
+                HeldBackReport::Skip => cabin_resolver::resolve_packages(input, index),
+            }
+            .context("dependency resolution failed")
+        }
+        match self {
+            Self::Local(index) => Ok((run(input, &index, held_back)?, index)),
+            Self::Http(index) => {
+                let output = run(input, &*index, held_back)?;
+                Ok((output, (*index).into_package_index()))
+            }
+        }
+    }
+}
+
 /// Pick the right index source for a fetch / build run, validate
-/// CLI flag combinations, and return both the [`PackageIndex`] the
+/// CLI flag combinations, and return both the [`ResolverIndex`] the
 /// resolver consumes and a tag describing which access mode the
 /// fetch plan should use.
 fn load_index_for_pipeline(
     index_source: &cabin_core::SourceLocator,
     frozen: bool,
-    root_deps: &BTreeMap<PackageName, semver::VersionReq>,
     experimental_features: &cabin_core::ExperimentalFeatures,
     reporter: Reporter,
-) -> Result<(PackageIndex, IndexAccess)> {
+) -> Result<(ResolverIndex, IndexAccess)> {
     match index_source {
         cabin_core::SourceLocator::IndexPath { path } => Ok((
-            load_local_index(path.as_std_path(), experimental_features)?,
+            ResolverIndex::Local(load_local_index(path.as_std_path(), experimental_features)?),
             IndexAccess::Local,
         )),
         cabin_core::SourceLocator::IndexUrl { url } => {
             if frozen {
                 bail!(FROZEN_INDEX_URL_ERR);
             }
-            let (index, client) = load_http_index(url, root_deps, experimental_features, reporter)?;
-            Ok((index, IndexAccess::Http(client)))
+            let (index, client) = load_http_index(url, experimental_features, reporter)?;
+            Ok((
+                ResolverIndex::Http(Box::new(index)),
+                IndexAccess::Http(client),
+            ))
         }
     }
 }
@@ -1073,10 +1121,11 @@ fn load_local_index(
         .with_context(|| format!("failed to load index at {}", index_path.display()))
 }
 
-/// Load a [`PackageIndex`] over sparse HTTP for the given root
-/// dependencies.  Returns the client alongside the index so the
-/// fetch / build pipeline can reuse the connection for downloads;
-/// the resolve pipeline discards it.
+/// Open a sparse HTTP index for the resolver.  Only `config.json` is
+/// fetched here; package documents are fetched as the solve reaches
+/// them.  Returns the client alongside the index so the fetch / build
+/// pipeline can reuse the connection for downloads; the resolve
+/// pipeline discards it.
 ///
 /// Under `-Z remote-registry` the client carries the stored
 /// credential (env override or `credentials.toml`) for the index
@@ -1085,10 +1134,12 @@ fn load_local_index(
 /// credential) the client is tokenless, exactly as before.
 pub(crate) fn load_http_index(
     url: &str,
-    root_deps: &BTreeMap<PackageName, semver::VersionReq>,
     experimental_features: &cabin_core::ExperimentalFeatures,
     reporter: Reporter,
-) -> Result<(PackageIndex, cabin_index_http::HttpClient)> {
+) -> Result<(
+    cabin_index_http::LazyHttpIndex,
+    cabin_index_http::HttpClient,
+)> {
     let mut client = cabin_index_http::HttpClient::new();
     if let Some(auth) =
         crate::cli::login::registry_auth_for_index_url(url, experimental_features, reporter)?
@@ -1100,9 +1151,7 @@ pub(crate) fn load_http_index(
         client.clone(),
         experimental_features,
     )?;
-    let names: Vec<PackageName> = root_deps.keys().cloned().collect();
-    let index = http_index.load_package_index(&names)?;
-    Ok((index, client))
+    Ok((cabin_index_http::LazyHttpIndex::new(http_index), client))
 }
 
 /// Build a [`FetchPlan`] from a resolver output and the index it ran
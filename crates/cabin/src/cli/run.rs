@@ -154,6 +154,7 @@ pub(crate) fn run(
             workspace_selection: &args.workspace_selection,
             toolchain: &args.toolchain,
             dev: DevActivation::Disabled,
+            check_only: false,
         },
         reporter,
         experimental_features,
@@ -186,6 +187,7 @@ pub(crate) fn run(
             build_dir: &prepared.build_dir,
             profile: &prepared.profile,
             plan_graph: &plan_graph,
+            check: false,
             graph: &prepared.graph,
             toolchain: &prepared.toolchain,
             cxx_kind: prepared.detection_report.cxx.identity.kind,
@@ -193,6 +195,7 @@ pub(crate) fn run(
             dev_for: &prepared.dev_for,
             ninja: &prepared.ninja,
             jobs,
+            env: &prepared.prep.backend_env,
             reporter,
         })?;
 
@@ -519,6 +522,8 @@ mod tests {
             deps: Vec::new(),
             required_features: Vec::new(),
             language: Default::default(),
+            data: Vec::new(),
+            harness: None,
         }
     }
 
@@ -10,6 +10,8 @@
 use std::collections::BTreeSet;
 use std::path::{Path, PathBuf};
 
+use anyhow::Result;
+use cabin_source_discovery::{ChangeScope, changed_paths};
 use cabin_workspace::{PackageGraph, PackageSelection, SelectionMode};
 
 /// Translate the standard `--workspace` / `--package` /
@@ -64,6 +66,25 @@ pub(crate) fn nested_package_excludes(
     out
 }
 
+/// The git change set `--changed [--cached]` / `--since <REV>`
+/// restrict the command to, as canonical absolute paths, or `None`
+/// when neither flag was passed and every discovered file is in
+/// scope.  `root` is any directory inside the work tree.
+pub(crate) fn changed_paths_from_flags(
+    root: &Path,
+    changed: bool,
+    cached: bool,
+    since: Option<&str>,
+) -> Result<Option<BTreeSet<PathBuf>>> {
+    let scope = match (changed, since) {
+        (_, Some(rev)) => ChangeScope::Since(rev.to_owned()),
+        (true, None) if cached => ChangeScope::Staged,
+        (true, None) => ChangeScope::Uncommitted,
+        (false, None) => return Ok(None),
+    };
+    Ok(Some(changed_paths(root, &scope)?))
+}
+
 /// Render a list of package names for reporter status / verbose
 /// output.  Single-package selections emit `package `name``;
 /// multi-package selections emit `packages `a`, `b`, `c``.
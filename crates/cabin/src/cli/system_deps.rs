@@ -26,7 +26,7 @@ use anyhow::{Result, bail};
 use cabin_core::{ResolvedProfileFlags, SystemDependency, TargetPlatform, Verbosity};
 use cabin_system_deps::{
     PkgConfigError, PkgConfigTool, SystemDependencyFlags, SystemDependencyProbeRequest,
-    SystemDependencyResolution, probe_system_dependency,
+    SystemDependencyResolution, probe_system_dependencies,
 };
 use cabin_workspace::PackageGraph;
 
@@ -94,13 +94,27 @@ pub(crate) fn augment_build_flags_with_system_deps(
         return Err(err.into());
     }
 
+    // Probe the whole set concurrently, then merge in the
+    // deterministic (package index, dependency name) order so the
+    // flag append order and the first reported error never depend
+    // on which probe finished first.
+    let mut requests: Vec<SystemDependencyProbeRequest<'_>> = Vec::with_capacity(count);
+    for (pkg_idx, deps) in &active {
+        let pkg_name = graph.packages[*pkg_idx].package.name.as_str();
+        for &dep in deps {
+            requests.push(probe_request(&tool, pkg_name, dep, reporter));
+        }
+    }
+    let mut results = probe_system_dependencies(&requests).into_iter();
+
     let mut reports: BTreeMap<usize, Vec<SystemDependencyResolution>> = BTreeMap::new();
     for (pkg_idx, deps) in active {
         let pkg_name = graph.packages[pkg_idx].package.name.as_str();
         let entry = build_flags.entry(pkg_idx).or_default();
         let mut pkg_reports: Vec<SystemDependencyResolution> = Vec::with_capacity(deps.len());
         for dep in deps {
-            let resolved = probe_dep(&tool, pkg_name, dep, reporter)?;
+            let result = results.next().expect("one probe result per request");
+            let resolved = finish_probe(pkg_name, dep, result, reporter)?;
             merge_flags(entry, &resolved.flags);
             pkg_reports.push(resolved);
         }
@@ -162,14 +176,13 @@ pub(crate) fn ensure_dialect_supports_system_deps(
     Ok(())
 }
 
-fn probe_dep(
-    tool: &PkgConfigTool,
+fn probe_request<'a>(
+    tool: &'a PkgConfigTool,
     pkg_name: &str,
-    dep: &SystemDependency,
+    dep: &'a SystemDependency,
     reporter: Reporter,
-) -> Result<SystemDependencyResolution> {
-    let verbosity = reporter.verbosity();
-    if verbosity == Verbosity::VeryVerbose {
+) -> SystemDependencyProbeRequest<'a> {
+    if reporter.verbosity() == Verbosity::VeryVerbose {
         reporter.aux_very_verbose(format_args!(
             "cabin: probing `{}` for package `{}` (version = {:?})",
             dep.name.as_str(),
@@ -180,14 +193,22 @@ fn probe_dep(
     // pkg-config module names have no `/`: a scoped system-dep name
     // probes the module named by its base name; the full name stays
     // the manifest-facing identity in diagnostics above.
-    let request = SystemDependencyProbeRequest {
+    SystemDependencyProbeRequest {
         name: dep.name.base_name(),
         version_requirement: &dep.version,
         tool,
-    };
-    match probe_system_dependency(&request) {
+    }
+}
+
+fn finish_probe(
+    pkg_name: &str,
+    dep: &SystemDependency,
+    result: Result<SystemDependencyResolution, PkgConfigError>,
+    reporter: Reporter,
+) -> Result<SystemDependencyResolution> {
+    match result {
         Ok(resolved) => {
-            if verbosity.shows_verbose() {
+            if reporter.verbosity().shows_verbose() {
                 let version_suffix = match resolved.version.as_deref() {
                     Some(v) => format!(" (version {v})"),
                     None => String::new(),
@@ -12,31 +12,8 @@
 //!   a closure for env lookup so they never depend on the host
 //!   environment.
 
-use cabin_config::{
-    ConfigDiscoveryInputs, EffectiveConfig, discover_config_files, merge_loaded_files,
-};
 use cabin_core::{ColorChoice, ColorEnvError};
 
-/// Discover the user-level Cabin config (no workspace context)
-/// and return its `term.color` value if any.  Errors are
-/// swallowed: a missing or unparsable config must not block
-/// the early `render_error` path.  A subcommand that
-/// subsequently loads its own [`EffectiveConfig`] (with the
-/// proper workspace layout) will surface any parse errors
-/// through its normal error chain.
-///
-/// This is the production input for the `config` slot of
-/// [`resolve_color_choice`] before any subcommand has loaded a
-/// workspace.  It honors `CABIN_NO_CONFIG`, `CABIN_CONFIG`, and
-/// `CABIN_CONFIG_HOME` exactly as discovery does for the rest
-/// of Cabin.
-pub(crate) fn discover_early_config_color() -> Option<ColorChoice> {
-    let inputs = ConfigDiscoveryInputs::from_process(None);
-    let discovery = discover_config_files(&inputs).ok()?;
-    let effective: EffectiveConfig = merge_loaded_files(discovery.loaded_files);
-    effective.term.color.map(|c| c.choice)
-}
-
 /// Clap-facing color-choice enum.  Mirrors
 /// [`cabin_core::ColorChoice`] one-for-one.  Lives on the CLI
 /// side so we can derive [`clap::ValueEnum`] without making
@@ -77,11 +54,12 @@ impl From<CliColorChoice> for ColorChoice {
 /// `cli` and `config` are pre-typed; only the env value goes
 /// through string parsing because that is the only entry
 /// point where a free-form string can reach Cabin from the
-/// outside.
+/// outside.  `config` is only called when neither the flag nor
+/// the env var decides, so `--color` skips config discovery.
 pub(crate) fn resolve_color_choice<F>(
     cli: Option<ColorChoice>,
     env: F,
-    config: Option<ColorChoice>,
+    config: impl FnOnce() -> Option<ColorChoice>,
 ) -> Result<ColorChoice, ColorEnvError>
 where
     F: Fn(&str) -> Option<String>,
@@ -95,11 +73,11 @@ where
         // shell scripts that clear it via `CABIN_TERM_COLOR=`
         // do not see a hard error.
         if raw.is_empty() {
-            return Ok(config.unwrap_or_default());
+            return Ok(config().unwrap_or_default());
         }
         return ColorChoice::from_env_value(&raw);
     }
-    Ok(config.unwrap_or_default())
+    Ok(config().unwrap_or_default())
 }
 
 #[cfg(test)]
@@ -121,7 +99,7 @@ mod tests {
 
     #[test]
     fn defaults_to_auto_with_no_inputs() {
-        let resolved = resolve_color_choice(None, no_env, None).unwrap();
+        let resolved = resolve_color_choice(None, no_env, || None).unwrap();
         assert_eq!(resolved, ColorChoice::Auto);
     }
 
@@ -130,7 +108,7 @@ mod tests {
         let resolved = resolve_color_choice(
             Some(ColorChoice::Always),
             env_with(&[(cabin_env::CABIN_TERM_COLOR, "never")]),
-            None,
+            || None,
         )
         .unwrap();
         assert_eq!(resolved, ColorChoice::Always);
@@ -141,7 +119,7 @@ mod tests {
         let resolved = resolve_color_choice(
             Some(ColorChoice::Never),
             env_with(&[(cabin_env::CABIN_TERM_COLOR, "always")]),
-            None,
+            || None,
         )
         .unwrap();
         assert_eq!(resolved, ColorChoice::Never);
@@ -152,7 +130,7 @@ mod tests {
         let resolved = resolve_color_choice(
             None,
             env_with(&[(cabin_env::CABIN_TERM_COLOR, "always")]),
-            None,
+            || None,
         )
         .unwrap();
         assert_eq!(resolved, ColorChoice::Always);
@@ -163,7 +141,7 @@ mod tests {
         let resolved = resolve_color_choice(
             None,
             env_with(&[(cabin_env::CABIN_TERM_COLOR, "never")]),
-            None,
+            || None,
         )
         .unwrap();
         assert_eq!(resolved, ColorChoice::Never);
@@ -174,7 +152,7 @@ mod tests {
         let err = resolve_color_choice(
             None,
             env_with(&[(cabin_env::CABIN_TERM_COLOR, "sometimes")]),
-            None,
+            || None,
         )
         .unwrap_err();
         assert_eq!(
@@ -192,7 +170,7 @@ mod tests {
         let resolved = resolve_color_choice(
             Some(ColorChoice::Auto),
             env_with(&[(cabin_env::CABIN_TERM_COLOR, "sometimes")]),
-            None,
+            || None,
         )
         .unwrap();
         assert_eq!(resolved, ColorChoice::Auto);
@@ -201,14 +179,16 @@ mod tests {
     #[test]
     fn empty_env_value_is_treated_as_unset() {
         let resolved =
-            resolve_color_choice(None, env_with(&[(cabin_env::CABIN_TERM_COLOR, "")]), None)
-                .unwrap();
+            resolve_color_choice(None, env_with(&[(cabin_env::CABIN_TERM_COLOR, "")]), || {
+                None
+            })
+            .unwrap();
         assert_eq!(resolved, ColorChoice::Auto);
     }
 
     #[test]
     fn config_applies_only_when_cli_and_env_silent() {
-        let resolved = resolve_color_choice(None, no_env, Some(ColorChoice::Always)).unwrap();
+        let resolved = resolve_color_choice(None, no_env, || Some(ColorChoice::Always)).unwrap();
         assert_eq!(resolved, ColorChoice::Always);
     }
 
@@ -217,7 +197,7 @@ mod tests {
         let resolved = resolve_color_choice(
             None,
             env_with(&[(cabin_env::CABIN_TERM_COLOR, "never")]),
-            Some(ColorChoice::Always),
+            || Some(ColorChoice::Always),
         )
         .unwrap();
         assert_eq!(resolved, ColorChoice::Never);
@@ -225,9 +205,10 @@ mod tests {
 
     #[test]
     fn cli_overrides_config_too() {
-        let resolved =
-            resolve_color_choice(Some(ColorChoice::Always), no_env, Some(ColorChoice::Never))
-                .unwrap();
+        let resolved = resolve_color_choice(Some(ColorChoice::Always), no_env, || {
+            Some(ColorChoice::Never)
+        })
+        .unwrap();
         assert_eq!(resolved, ColorChoice::Always);
     }
 
@@ -236,12 +217,23 @@ mod tests {
         // An empty `CABIN_TERM_COLOR=` should not erase a
         // config-provided `term.color` - Cabin treats the
         // empty value as "unset".
-        let resolved = resolve_color_choice(
+        let resolved =
+            resolve_color_choice(None, env_with(&[(cabin_env::CABIN_TERM_COLOR, "")]), || {
+                Some(ColorChoice::Always)
+            })
+            .unwrap();
+        assert_eq!(resolved, ColorChoice::Always);
+    }
+
+    #[test]
+    fn cli_and_env_never_consult_config() {
+        let unreachable = || -> Option<ColorChoice> { panic!("config consulted") };
+        resolve_color_choice(Some(ColorChoice::Never), no_env, unreachable).unwrap();
+        resolve_color_choice(
             None,
-            env_with(&[(cabin_env::CABIN_TERM_COLOR, "")]),
-            Some(ColorChoice::Always),
+            env_with(&[(cabin_env::CABIN_TERM_COLOR, "always")]),
+            unreachable,
         )
         .unwrap();
-        assert_eq!(resolved, ColorChoice::Always);
     }
 }
@@ -27,26 +27,8 @@
 use std::fmt;
 use std::io::Write;
 
-use cabin_config::{
-    ConfigDiscoveryInputs, EffectiveConfig, discover_config_files, merge_loaded_files,
-};
 use cabin_core::{Verbosity, VerbosityEnvError};
 
-/// Discover the user-level Cabin config (no workspace context)
-/// and return an [`EffectiveConfig`] suitable for passing to
-/// [`resolve_verbosity`].  Errors are swallowed and an empty
-/// effective config is returned: a missing or unparsable
-/// config must not block the early reporter setup.  The
-/// subcommand-level dispatcher will surface any parse errors
-/// later through its normal error chain.
-pub(crate) fn discover_early_config_verbosity() -> EffectiveConfig {
-    let inputs = ConfigDiscoveryInputs::from_process(None);
-    match discover_config_files(&inputs) {
-        Ok(discovery) => merge_loaded_files(discovery.loaded_files),
-        Err(_) => EffectiveConfig::default(),
-    }
-}
-
 /// Validated verbosity inputs at the CLI boundary.  Mirrors the
 /// raw `Cli` flags one-for-one so the dispatcher can produce a
 /// single typed value without scattering `if quiet ... else if
@@ -89,10 +71,15 @@ impl CliVerbosity {
 /// [`VerbosityEnvError`].  Clap already rejects the `--quiet
 /// --verbose` combination at parse time, so a CLI-level conflict
 /// is never observed here.
+///
+/// `config` yields the config layer's level and is only called
+/// when neither the flags nor the env vars decide, so an
+/// invocation that already carries `-v` or `-q` never pays for
+/// config discovery.
 pub(crate) fn resolve_verbosity<F>(
     cli: CliVerbosity,
     env: F,
-    config: &EffectiveConfig,
+    config: impl FnOnce() -> Option<Verbosity>,
 ) -> Result<Verbosity, VerbosityEnvError>
 where
     F: Fn(&str) -> Option<String>,
@@ -119,10 +106,7 @@ where
         }
     }
 
-    if let Some(setting) = &config.term.verbosity {
-        return Ok(setting.level);
-    }
-    Ok(Verbosity::default())
+    Ok(config().unwrap_or_default())
 }
 
 fn read_bool_env<F>(env: &F, key: &'static str) -> Result<bool, VerbosityEnvError>
@@ -375,17 +359,8 @@ mod tests {
         }
     }
 
-    fn cfg() -> EffectiveConfig {
-        EffectiveConfig::default()
-    }
-
-    fn cfg_with_verbosity(level: Verbosity) -> EffectiveConfig {
-        let mut effective = EffectiveConfig::default();
-        effective.term.verbosity = Some(cabin_config::EffectiveVerbosity {
-            level,
-            source: cabin_config::ConfigSource::User,
-        });
-        effective
+    fn no_config() -> Option<Verbosity> {
+        None
     }
 
     fn cli(verbose_count: u8, quiet: bool) -> CliVerbosity {
@@ -397,40 +372,46 @@ mod tests {
 
     #[test]
     fn defaults_to_normal_with_no_inputs() {
-        let resolved = resolve_verbosity(cli(0, false), no_env, &cfg()).unwrap();
+        let resolved = resolve_verbosity(cli(0, false), no_env, no_config).unwrap();
         assert_eq!(resolved, Verbosity::Normal);
     }
 
+    #[test]
+    fn cli_and_env_never_consult_config() {
+        let unreachable = || -> Option<Verbosity> { panic!("config consulted") };
+        resolve_verbosity(cli(0, true), no_env, unreachable).unwrap();
+        resolve_verbosity(
+            cli(0, false),
+            env_with(&[(cabin_env::CABIN_TERM_VERBOSE, "1")]),
+            unreachable,
+        )
+        .unwrap();
+    }
+
     #[test]
     fn cli_verbose_count_one_yields_verbose() {
-        let resolved = resolve_verbosity(cli(1, false), no_env, &cfg()).unwrap();
+        let resolved = resolve_verbosity(cli(1, false), no_env, no_config).unwrap();
         assert_eq!(resolved, Verbosity::Verbose);
     }
 
     #[test]
     fn cli_verbose_count_two_or_more_yields_very_verbose() {
-        let resolved = resolve_verbosity(cli(2, false), no_env, &cfg()).unwrap();
+        let resolved = resolve_verbosity(cli(2, false), no_env, no_config).unwrap();
         assert_eq!(resolved, Verbosity::VeryVerbose);
-        let resolved = resolve_verbosity(cli(7, false), no_env, &cfg()).unwrap();
+        let resolved = resolve_verbosity(cli(7, false), no_env, no_config).unwrap();
         assert_eq!(resolved, Verbosity::VeryVerbose);
     }
 
     #[test]
     fn cli_quiet_overrides_config_verbose() {
-        let resolved = resolve_verbosity(
-            cli(0, true),
-            no_env,
-            &cfg_with_verbosity(Verbosity::Verbose),
-        )
-        .unwrap();
+        let resolved =
+            resolve_verbosity(cli(0, true), no_env, || Some(Verbosity::Verbose)).unwrap();
         assert_eq!(resolved, Verbosity::Quiet);
     }
 
     #[test]
     fn cli_verbose_overrides_config_quiet() {
-        let resolved =
-            resolve_verbosity(cli(1, false), no_env, &cfg_with_verbosity(Verbosity::Quiet))
-                .unwrap();
+        let resolved = resolve_verbosity(cli(1, false), no_env, || Some(Verbosity::Quiet)).unwrap();
         assert_eq!(resolved, Verbosity::Verbose);
     }
 
@@ -439,7 +420,7 @@ mod tests {
         let resolved = resolve_verbosity(
             cli(0, false),
             env_with(&[(cabin_env::CABIN_TERM_VERBOSE, "1")]),
-            &cfg(),
+            no_config,
         )
         .unwrap();
         assert_eq!(resolved, Verbosity::Verbose);
@@ -450,7 +431,7 @@ mod tests {
         let resolved = resolve_verbosity(
             cli(0, false),
             env_with(&[(cabin_env::CABIN_TERM_QUIET, "true")]),
-            &cfg(),
+            no_config,
         )
         .unwrap();
         assert_eq!(resolved, Verbosity::Quiet);
@@ -461,7 +442,7 @@ mod tests {
         let resolved = resolve_verbosity(
             cli(0, false),
             env_with(&[(cabin_env::CABIN_TERM_VERBOSE, "1")]),
-            &cfg_with_verbosity(Verbosity::Quiet),
+            || Some(Verbosity::Quiet),
         )
         .unwrap();
         assert_eq!(resolved, Verbosity::Verbose);
@@ -475,7 +456,7 @@ mod tests {
                 (cabin_env::CABIN_TERM_VERBOSE, "1"),
                 (cabin_env::CABIN_TERM_QUIET, "1"),
             ]),
-            &cfg(),
+            no_config,
         )
         .unwrap_err();
         // The error names one of the two variables; either is
@@ -491,7 +472,7 @@ mod tests {
         let err = resolve_verbosity(
             cli(0, false),
             env_with(&[(cabin_env::CABIN_TERM_VERBOSE, "loud")]),
-            &cfg(),
+            no_config,
         )
         .unwrap_err();
         assert_eq!(err.variable, cabin_env::CABIN_TERM_VERBOSE);
@@ -500,12 +481,8 @@ mod tests {
 
     #[test]
     fn config_applies_when_cli_and_env_silent() {
-        let resolved = resolve_verbosity(
-            cli(0, false),
-            no_env,
-            &cfg_with_verbosity(Verbosity::Verbose),
-        )
-        .unwrap();
+        let resolved =
+            resolve_verbosity(cli(0, false), no_env, || Some(Verbosity::Verbose)).unwrap();
         assert_eq!(resolved, Verbosity::Verbose);
     }
 
@@ -514,7 +491,7 @@ mod tests {
         let resolved = resolve_verbosity(
             cli(0, false),
             env_with(&[(cabin_env::CABIN_TERM_VERBOSE, "")]),
-            &cfg_with_verbosity(Verbosity::Quiet),
+            || Some(Verbosity::Quiet),
         )
         .unwrap();
         assert_eq!(resolved, Verbosity::Quiet);
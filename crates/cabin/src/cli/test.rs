@@ -128,6 +128,27 @@ pub(crate) struct TestArgs {
     /// declared yet.
     #[arg(long)]
     pub allow_no_tests: bool,
+
+    /// Bytes of each test's stdout / stderr kept in memory.
+    ///
+    /// Longer output is still streamed live, but only its head
+    /// and tail are retained; the complete stream is written to
+    /// `<build-dir>/<profile>/test-output/<pkg>/<target>.stdout`
+    /// (resp. `.stderr`).
+    #[arg(long, value_name = "BYTES", default_value_t = cabin_test::DEFAULT_CAPTURE_LIMIT)]
+    pub capture_limit: usize,
+
+    /// Worker processes a test binary with a declared `harness` is
+    /// split across.  Defaults to the available parallelism; `1`
+    /// runs every test executable whole.
+    #[arg(long, value_name = "N")]
+    pub test_threads: Option<std::num::NonZeroUsize>,
+
+    /// Run every test executable even when an earlier passing run
+    /// with the same binary, env and `data` inputs is cached under
+    /// `<build-dir>/<profile>/test-cache`.
+    #[arg(long)]
+    pub no_test_cache: bool,
 }
 
 /// Run `cabin test`: build the selected `test` targets,
@@ -190,6 +211,7 @@ pub(crate) fn test(
             workspace_selection: &args.workspace_selection,
             toolchain: &args.toolchain,
             dev: DevActivation::SelectedPrimaries,
+            check_only: false,
         },
         reporter,
         experimental_features,
@@ -276,6 +298,7 @@ pub(crate) fn test(
         build_dir: &prepared.build_dir,
         profile: &prepared.profile,
         plan_graph: &plan_graph,
+        check: false,
         graph: &prepared.graph,
         toolchain: &prepared.toolchain,
         cxx_kind: prepared.detection_report.cxx.identity.kind,
@@ -283,6 +306,7 @@ pub(crate) fn test(
         dev_for: &prepared.dev_for,
         ninja: &prepared.ninja,
         jobs: None,
+        env: &prepared.prep.backend_env,
         reporter,
     })?;
 
@@ -324,7 +348,21 @@ pub(crate) fn test(
         test_plan.len(),
         plural(test_plan.len())
     );
-    let summary = cabin_test::run_tests(&test_plan, &mut sink)?;
+    let profile_dir = prepared.build_dir.join(prepared.profile.name.as_str());
+    let test_output = profile_dir.join("test-output");
+    let options = cabin_test::TestRunOptions {
+        test_threads: args
+            .test_threads
+            .or_else(|| std::thread::available_parallelism().ok())
+            .map_or(1, std::num::NonZeroUsize::get),
+        case_timings: Some(test_output.join("case-timings.tsv")),
+        cache_dir: (!args.no_test_cache).then(|| profile_dir.join("test-cache")),
+        capture: cabin_test::CaptureOptions {
+            memory_limit: args.capture_limit,
+            spool_dir: Some(test_output),
+        },
+    };
+    let summary = cabin_test::run_tests(&test_plan, &options, &mut sink)?;
     let _ = writeln!(
         sink.stdout,
         "{}",
@@ -354,7 +392,28 @@ fn select_named_test_targets(
     all: &[ManifestTargetSelector],
     names: &[String],
 ) -> Result<Vec<ManifestTargetSelector>> {
-    // A `BTreeSet` dedupes repeated `--test` names and keeps the
+    select_named_targets(
+        graph,
+        selected_packages,
+        all,
+        names,
+        "--test",
+        TargetKind::Test,
+    )
+}
+
+/// [`select_named_test_targets`] for any runnable `kind`, with
+/// diagnostics naming `flag`.  `cabin bench --bench <NAME>` shares
+/// it.
+pub(crate) fn select_named_targets(
+    graph: &cabin_workspace::PackageGraph,
+    selected_packages: &[usize],
+    all: &[ManifestTargetSelector],
+    names: &[String],
+    flag: &str,
+    kind: TargetKind,
+) -> Result<Vec<ManifestTargetSelector>> {
+    // A `BTreeSet` dedupes repeated names and keeps the
     // validation order deterministic.
     let requested: BTreeSet<&str> = names.iter().map(String::as_str).collect();
     for &name in &requested {
@@ -369,13 +428,13 @@ fn select_named_test_targets(
             .flat_map(|&idx| graph.packages[idx].package.targets.iter())
             .find(|t| t.name.as_str() == name)
             .map(|t| t.kind);
-        if let Some(kind) = other_kind {
+        if let Some(other) = other_kind {
             bail!(
-                "--test `{name}` matched a target of kind `{}`; expected `test`",
-                kind.as_str()
+                "{flag} `{name}` matched a target of kind `{}`; expected `{kind}`",
+                other.as_str()
             );
         }
-        bail!("--test `{name}` was not found in the selected packages");
+        bail!("{flag} `{name}` was not found in the selected packages");
     }
     Ok(all
         .iter()
@@ -391,7 +450,7 @@ fn select_named_test_targets(
 /// intact so test executables can still find shared system
 /// tools.  The only fallible step is mapping each executable back
 /// to its workspace package.
-fn populate_test_env_overlay(
+pub(crate) fn populate_test_env_overlay(
     plan: &mut cabin_test::TestPlan,
     graph: &cabin_workspace::PackageGraph,
     profile: &cabin_core::ResolvedProfile,
@@ -459,6 +518,8 @@ mod tests {
             deps: Vec::new(),
             required_features: Vec::new(),
             language: Default::default(),
+            data: Vec::new(),
+            harness: None,
         };
         let package = Package::new(
             PackageName::new("demo").unwrap(),
@@ -501,6 +562,8 @@ mod tests {
             deps: Vec::new(),
             required_features: Vec::new(),
             language: Default::default(),
+            data: Vec::new(),
+            harness: None,
         };
         let alpha = Package::new(
             PackageName::new("alpha").unwrap(),
@@ -631,6 +694,7 @@ mod tests {
             compile_commands: Vec::new(),
             standard_violations: Vec::new(),
             standard_compat_violations: Vec::new(),
+            artifact_owners: BTreeMap::default(),
             planned_packages: BTreeSet::default(),
         };
         let mut plan = cabin_test::plan_tests(&graph, &build_graph, Some(&[0]));
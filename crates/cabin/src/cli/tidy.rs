@@ -16,7 +16,7 @@
 //! invoking Ninja: clang-tidy reads the JSON compilation database
 //! directly and a build is unnecessary for analysis.
 
-use std::collections::BTreeSet;
+use std::collections::{BTreeMap, BTreeSet};
 use std::path::{Path, PathBuf};
 use std::process::ExitCode;
 
@@ -33,8 +33,8 @@ use cabin_tidy::{
 use cabin_workspace::PackageGraph;
 
 use crate::cli::source_tooling::{
-    absolutize, describe_packages, display_workspace_relative, nested_package_excludes,
-    package_selection_from_flags,
+    absolutize, changed_paths_from_flags, describe_packages, display_workspace_relative,
+    nested_package_excludes, package_selection_from_flags,
 };
 use crate::cli::term_verbosity::Reporter;
 use crate::plural;
@@ -100,6 +100,25 @@ pub(crate) struct TidyArgs {
     /// concurrent rewrites cannot race.
     #[arg(short = 'j', long = "jobs", value_name = "N")]
     pub jobs: Option<cabin_core::BuildJobs>,
+
+    /// Only analyze sources with uncommitted changes relative to
+    /// git `HEAD`, plus sources that include a changed header
+    /// according to the last `cabin build`.  Suited to
+    /// pre-commit hooks.
+    #[arg(long, conflicts_with = "since")]
+    pub changed: bool,
+
+    /// With `--changed`, only analyze sources staged in the git
+    /// index (and sources that include a staged header).
+    #[arg(long, requires = "changed")]
+    pub cached: bool,
+
+    /// Only analyze sources changed since the merge base of REV
+    /// and `HEAD`, plus sources that include a changed header
+    /// according to the last `cabin build`.  Suited to PR CI,
+    /// e.g. `--since origin/main`.
+    #[arg(long, value_name = "REV")]
+    pub since: Option<String>,
 }
 
 /// Entry point invoked by the top-level dispatcher.
@@ -164,6 +183,14 @@ pub(crate) fn tidy(args: &TidyArgs, reporter: Reporter) -> Result<ExitCode> {
     let cwd = std::env::current_dir().context("failed to determine current directory")?;
     let absolute_excludes: Vec<PathBuf> =
         args.exclude.iter().map(|p| absolutize(&cwd, p)).collect();
+    // Ask git before planning so a mistyped `--since` revision fails
+    // fast.
+    let changed = changed_paths_from_flags(
+        &graph.root_dir,
+        args.changed,
+        args.cached,
+        args.since.as_deref(),
+    )?;
 
     let executable = resolve_tidy_executable(|key| std::env::var_os(key));
     let tidy_verbosity = match reporter.verbosity() {
@@ -231,9 +258,16 @@ pub(crate) fn tidy(args: &TidyArgs, reporter: Reporter) -> Result<ExitCode> {
     // consume. `cabin tidy` drives clang-tidy, not the compiler, so
     // detection stays fail-soft: on failure the dialect falls back to
     // the host default and compiler cfg conditions evaluate as
-    // `unknown`.
-    let detection_report =
-        cabin_toolchain::detect_toolchain(&toolchain, &cabin_toolchain::ProcessRunner).ok();
+    // `unknown`.  Tidy never archives, so the archiver is not probed.
+    let detection_report = cabin_toolchain::detect_toolchain_scoped(
+        &toolchain,
+        &cabin_toolchain::ProcessRunner,
+        cabin_toolchain::DetectionScope {
+            c_compiler: true,
+            archiver: false,
+        },
+    )
+    .ok();
     let dialect = detection_report
         .as_ref()
         .map_or_else(cabin_build::Dialect::host_default, |report| {
@@ -341,6 +375,15 @@ pub(crate) fn tidy(args: &TidyArgs, reporter: Reporter) -> Result<ExitCode> {
                 .has_c_sources(),
             )
         }),
+        // Tidy never archives; the compile database is the same either way.
+        thin_archives: false,
+        archive_response_files: cabin_build::ArchiveResponseFile::Unsupported,
+        // Without a detection report, assume the compiler targets the host.
+        target_arch: detection_report
+            .as_ref()
+            .map_or_else(cabin_core::TargetArch::host, |report| {
+                report.cxx.identity.arch()
+            }),
         enabled_features: Some(&enabled_features),
         standard_compat: false,
     })?;
@@ -395,6 +438,39 @@ pub(crate) fn tidy(args: &TidyArgs, reporter: Reporter) -> Result<ExitCode> {
         .map(|f| canonicalize_or_self(&f.absolute_path))
         .filter(|p| compile_db_files.contains(p))
         .collect();
+    let files = match &changed {
+        None => files,
+        Some(changed) => {
+            let deps_log_path = profile_build_root.join(".ninja_deps");
+            let deps_log = match cabin_ninja::DepsLog::read(&deps_log_path) {
+                Ok(Some(log)) => Some(log),
+                Ok(None) => {
+                    reporter.verbose(format_args!(
+                        "cabin: no {} yet; changed headers do not widen the tidy set",
+                        deps_log_path.display(),
+                    ));
+                    None
+                }
+                Err(err) => {
+                    reporter.verbose(format_args!(
+                        "cabin: {err}; changed headers do not widen the tidy set"
+                    ));
+                    None
+                }
+            };
+            let objects: BTreeMap<PathBuf, PathBuf> = plan_graph
+                .compile_commands
+                .iter()
+                .map(|cc| {
+                    (
+                        cabin_fs::canonicalize_or_input(cc.output.as_std_path()),
+                        cc.file.clone().into_std_path_buf(),
+                    )
+                })
+                .collect();
+            scope_to_changes(files, changed, deps_log.as_ref(), &objects)
+        }
+    };
 
     let mut selected_names: Vec<String> = resolved_selection
         .packages
@@ -507,6 +583,36 @@ fn canonicalize_or_self(path: &Path) -> PathBuf {
     std::fs::canonicalize(path).unwrap_or_else(|_| path.to_path_buf())
 }
 
+/// Narrow `files` to those `changed` names, plus those whose last
+/// recorded compile in `deps_log` read a changed path - a source is
+/// worth re-analyzing when any header it includes changed.  `objects`
+/// maps each object path to its source, since the deps log is keyed
+/// by output.  Every comparison uses [`cabin_fs::canonicalize_or_input`],
+/// the spelling [`cabin_source_discovery::changed_paths`] reports.
+fn scope_to_changes(
+    files: Vec<PathBuf>,
+    changed: &BTreeSet<PathBuf>,
+    deps_log: Option<&cabin_ninja::DepsLog>,
+    objects: &BTreeMap<PathBuf, PathBuf>,
+) -> Vec<PathBuf> {
+    let dependents: BTreeSet<PathBuf> = deps_log
+        .map(|log| {
+            log.outputs_touching(|node| changed.contains(&cabin_fs::canonicalize_or_input(node)))
+                .into_iter()
+                .filter_map(|output| objects.get(&cabin_fs::canonicalize_or_input(output)))
+                .map(cabin_fs::canonicalize_or_input)
+                .collect()
+        })
+        .unwrap_or_default();
+    files
+        .into_iter()
+        .filter(|file| {
+            let file = cabin_fs::canonicalize_or_input(file);
+            changed.contains(&file) || dependents.contains(&file)
+        })
+        .collect()
+}
+
 /// Whether the union of the selected packages contains at least
 /// one C/C++ target.  The planner's enumeration would otherwise
 /// fail with `EmptySelectedPackages` for workspaces that hold
@@ -573,6 +679,8 @@ mod tests {
             deps: Vec::new(),
             required_features: Vec::new(),
             language: Default::default(),
+            data: Vec::new(),
+            harness: None,
         };
         let package = Package::new(
             PackageName::new("demo").unwrap(),
@@ -621,6 +729,95 @@ mod tests {
         );
     }
 
+    #[test]
+    fn scope_without_deps_log_keeps_only_changed_sources() {
+        let files = vec![
+            PathBuf::from("/nonexistent/src/a.cc"),
+            PathBuf::from("/nonexistent/src/b.cc"),
+        ];
+        let changed: BTreeSet<PathBuf> = [
+            PathBuf::from("/nonexistent/src/b.cc"),
+            PathBuf::from("/nonexistent/include/util.h"),
+        ]
+        .into_iter()
+        .collect();
+        assert_eq!(
+            scope_to_changes(files, &changed, None, &BTreeMap::new()),
+            [PathBuf::from("/nonexistent/src/b.cc")]
+        );
+    }
+
+    /// Write a version-3 `.ninja_deps` log into `dir`: `nodes` as path
+    /// records, then one deps record per `(output, inputs)` pair.
+    fn write_deps_log(dir: &Path, nodes: &[&str], deps: &[(u32, &[u32])]) {
+        let mut out = b"# ninjadeps\n".to_vec();
+        out.extend(3u32.to_le_bytes());
+        for node in nodes {
+            let mut name = node.as_bytes().to_vec();
+            name.resize(name.len().div_ceil(4) * 4, 0);
+            out.extend(u32::try_from(name.len()).unwrap().to_le_bytes());
+            out.extend(name);
+        }
+        for (output, inputs) in deps {
+            let size = u32::try_from(4 * (2 + inputs.len())).unwrap();
+            out.extend((size | 0x8000_0000).to_le_bytes());
+            out.extend(output.to_le_bytes());
+            out.extend(7u32.to_le_bytes());
+            for input in *inputs {
+                out.extend(input.to_le_bytes());
+            }
+        }
+        std::fs::write(dir.join(".ninja_deps"), out).unwrap();
+    }
+
+    #[test]
+    fn scope_widens_a_changed_header_to_the_sources_that_include_it() {
+        let tmp = assert_fs::TempDir::new().unwrap();
+        let root = cabin_fs::canonicalize_or_input(tmp.path());
+        let build = root.join("build/dev");
+        std::fs::create_dir_all(&build).unwrap();
+        std::fs::create_dir_all(root.join("src")).unwrap();
+        std::fs::create_dir_all(root.join("include")).unwrap();
+        for file in ["src/a.cc", "src/b.cc", "src/c.cc", "include/util.h"] {
+            std::fs::write(root.join(file), "").unwrap();
+        }
+        let path = |rel: &str| root.join(rel).to_string_lossy().into_owned();
+        write_deps_log(
+            &build,
+            &[
+                "obj/a.o",
+                &path("src/a.cc"),
+                &path("include/util.h"),
+                "obj/b.o",
+                &path("src/b.cc"),
+            ],
+            &[(0, &[1, 2]), (3, &[4])],
+        );
+        let deps_log = cabin_ninja::DepsLog::read(&build.join(".ninja_deps"))
+            .unwrap()
+            .unwrap();
+        let objects: BTreeMap<PathBuf, PathBuf> = [
+            (build.join("obj/a.o"), root.join("src/a.cc")),
+            (build.join("obj/b.o"), root.join("src/b.cc")),
+        ]
+        .into_iter()
+        .collect();
+        let changed: BTreeSet<PathBuf> = [root.join("include/util.h"), root.join("src/c.cc")]
+            .into_iter()
+            .collect();
+        let files = vec![
+            root.join("src/a.cc"),
+            root.join("src/b.cc"),
+            root.join("src/c.cc"),
+        ];
+        // `a.cc` includes the changed header, `c.cc` changed itself,
+        // and `b.cc` neither.
+        assert_eq!(
+            scope_to_changes(files, &changed, Some(&deps_log), &objects),
+            [root.join("src/a.cc"), root.join("src/c.cc")]
+        );
+    }
+
     #[test]
     fn any_cpp_targets_still_detects_library() {
         let graph = graph_with_single_target(TargetKind::Library);
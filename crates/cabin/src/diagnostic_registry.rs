@@ -158,6 +158,8 @@ pub(crate) fn downcast_diagnostic<'a>(
             code::SOURCE_DISCOVERY_ERROR,
         ),
         (|e| e.is::<cabin_test::TestRunError>(), code::TEST_ERROR),
+        (|e| e.is::<cabin_bench::BenchRunError>(), code::BENCH_ERROR),
+        (|e| e.is::<cabin_bloat::BloatError>(), code::BLOAT_ERROR),
         (
             |e| e.is::<cabin_explain::ExplainError>(),
             code::EXPLAIN_ERROR,
@@ -0,0 +1,48 @@
+//! Pre-clap dispatch for the version queries tooling runs most.
+//!
+//! `cabin --version`, `cabin -V` and `cabin version` are answered
+//! from the argument vector alone: building the full clap command
+//! model for every subcommand costs more than the answer itself,
+//! and editor integrations and build scripts probe it constantly.
+//! Only the exact one-token spellings take this path; anything
+//! else - `cabin version -v`, `cabin -V --color never` - goes
+//! through clap and reaches the same formatter, so the output is
+//! identical either way.
+//!
+//! Verbosity still comes from the early terminal state, so
+//! `CABIN_TERM_VERBOSE` and `[term] verbose` select the verbose
+//! block here exactly as they do after a full parse.
+
+use std::ffi::OsString;
+use std::process::ExitCode;
+
+use crate::cli::version::{VersionArgs, version};
+use crate::term_setup::{EarlyTerminalState, resolve_early_terminal_state};
+
+/// `argv[1]` spellings answered without clap.
+const VERSION_SPELLINGS: [&str; 3] = ["--version", "-V", "version"];
+
+/// If this process was invoked as a bare version query, print the
+/// version and return the exit code; otherwise return `None` so
+/// normal CLI parsing proceeds. `argv` is the full process argument
+/// vector, including `argv[0]`.
+pub(crate) fn dispatch(argv: &[OsString]) -> Option<ExitCode> {
+    let [_, only] = argv else {
+        return None;
+    };
+    if !VERSION_SPELLINGS.iter().any(|spelling| only == spelling) {
+        return None;
+    }
+    let EarlyTerminalState { color, reporter } = match resolve_early_terminal_state(None, 0, false)
+    {
+        Ok(state) => state,
+        Err(exit_code) => return Some(exit_code),
+    };
+    Some(match version(VersionArgs {}, reporter.verbosity()) {
+        Ok(()) => ExitCode::SUCCESS,
+        Err(error) => {
+            crate::error_rendering::render_error(&error, color);
+            ExitCode::FAILURE
+        }
+    })
+}
@@ -31,6 +31,7 @@ mod command_list;
 mod completions;
 mod diagnostic_registry;
 mod error_rendering;
+mod fast_path;
 mod help_rendering;
 mod manpages;
 mod port_subcommand;
@@ -117,6 +118,9 @@ where
     if let Some(code) = stamp::dispatch(&arguments) {
         return code;
     }
+    if let Some(code) = fast_path::dispatch(&arguments) {
+        return code;
+    }
 
     let cmd = help_rendering::prepare_top_level_command();
     let matches = match cmd.try_get_matches_from(arguments) {
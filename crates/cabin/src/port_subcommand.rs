@@ -1,6 +1,5 @@
 //! `cabin port` - inspect the bundled foundation-port set.
 
-use anyhow::Result;
 use clap::{Args, Subcommand};
 
 use crate::cli::term_verbosity::Reporter;
@@ -17,19 +16,16 @@ pub(crate) enum PortCommand {
     List,
 }
 
-pub(crate) fn port(args: &PortArgs, _reporter: Reporter) -> Result<()> {
+pub(crate) fn port(args: &PortArgs, _reporter: Reporter) {
     match args.command {
         PortCommand::List => list_builtin_ports(),
     }
 }
 
-fn list_builtin_ports() -> Result<()> {
+fn list_builtin_ports() {
     let mut entries: Vec<_> = cabin_port::builtin::iter().collect();
     entries.sort_by_key(|p| p.name);
     for entry in entries {
-        let descriptor =
-            cabin_port::parse_port_str(entry.port_toml, std::path::Path::new("<builtin>"))?;
-        println!("{} {}", descriptor.name.as_str(), descriptor.version);
+        println!("{} {}", entry.name, entry.parsed_version);
     }
-    Ok(())
 }
@@ -14,16 +14,22 @@
 //! see them through their own loop.  The early resolve only
 //! observes the user-level config, which is the right shape
 //! when no workspace context is available yet.
+//!
+//! Every `cabin` invocation passes through here, so the config
+//! is discovered lazily ([`EarlyConfig`]): at most once, and not
+//! at all when flags or env vars already settle both choices.
 
+use std::cell::OnceCell;
 use std::process::ExitCode;
 
+use cabin_config::{
+    ConfigDiscoveryInputs, EffectiveConfig, discover_config_files, merge_loaded_files,
+};
 use cabin_core::ColorChoice;
 use termcolor::StandardStream;
 
 use crate::cli::term_color::CliColorChoice;
-use crate::cli::term_verbosity::{
-    CliVerbosity, Reporter, discover_early_config_verbosity, resolve_verbosity,
-};
+use crate::cli::term_verbosity::{CliVerbosity, Reporter, resolve_verbosity};
 use crate::error_rendering::write_plain_error;
 
 /// Resolved terminal state available before any subcommand runs.
@@ -47,6 +53,30 @@ pub(crate) fn termcolor_choice(choice: ColorChoice) -> termcolor::ColorChoice {
     }
 }
 
+/// The user-level Cabin config (no workspace context), discovered
+/// on first use and shared by the color and verbosity resolvers.
+///
+/// Discovery errors are swallowed and yield an empty config: a
+/// missing or unparsable config must not block the early
+/// `render_error` path.  A subcommand that subsequently loads
+/// its own [`EffectiveConfig`] (with the proper workspace layout)
+/// surfaces any parse errors through its normal error chain.
+/// Discovery honors `CABIN_NO_CONFIG`, `CABIN_CONFIG`, and
+/// `CABIN_CONFIG_HOME` exactly as it does for the rest of Cabin.
+#[derive(Default)]
+struct EarlyConfig(OnceCell<EffectiveConfig>);
+
+impl EarlyConfig {
+    fn get(&self) -> &EffectiveConfig {
+        self.0.get_or_init(|| {
+            let inputs = ConfigDiscoveryInputs::from_process(None);
+            discover_config_files(&inputs)
+                .map(|discovery| merge_loaded_files(discovery.loaded_files))
+                .unwrap_or_default()
+        })
+    }
+}
+
 /// Resolve the color choice and reporter the dispatcher hands
 /// to subcommands.
 ///
@@ -67,11 +97,11 @@ pub(crate) fn resolve_early_terminal_state(
     verbose_count: u8,
     quiet: bool,
 ) -> Result<EarlyTerminalState, ExitCode> {
-    let config_color = crate::cli::term_color::discover_early_config_color();
+    let early_config = EarlyConfig::default();
     let color = match crate::cli::term_color::resolve_color_choice(
         cli_color.map(Into::into),
         |key| std::env::var(key).ok(),
-        config_color,
+        || early_config.get().term.color.as_ref().map(|c| c.choice),
     ) {
         Ok(choice) => choice,
         Err(env_err) => {
@@ -87,11 +117,10 @@ pub(crate) fn resolve_early_terminal_state(
         verbose_count,
         quiet,
     };
-    let early_config_verbosity = discover_early_config_verbosity();
     let verbosity = match resolve_verbosity(
         cli_verbosity,
         |key| std::env::var(key).ok(),
-        &early_config_verbosity,
+        || early_config.get().term.verbosity.as_ref().map(|s| s.level),
     ) {
         Ok(level) => level,
         Err(env_err) => {
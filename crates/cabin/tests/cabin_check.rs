@@ -172,3 +172,43 @@ fn check_fails_on_semantic_error() {
         "failed check must not leave object files: {files:?}"
     );
 }
+
+/// Every edge `cabin check` wrote to `build.ninja` that runs the
+/// syntax-check rule.
+fn check_edges(dir: &TempDir) -> usize {
+    std::fs::read_to_string(dir.path().join("build/dev/build.ninja"))
+        .expect("build.ninja written")
+        .matches(": cxx_check ")
+        .count()
+}
+
+#[test]
+fn check_after_build_reuses_up_to_date_objects() {
+    require_cxx_build_tools();
+    let dir = copy_example("library-and-app");
+    let run = |command: &str| {
+        cabin()
+            .args([command, "--manifest-path"])
+            .arg(dir.path().join("cabin.toml"))
+            .arg("--build-dir")
+            .arg(dir.path().join("build"))
+            .assert()
+    };
+    run("build").success();
+    // The build compiled every translation unit with the arguments
+    // the check would use, so nothing is left to check.
+    run("check").success();
+    assert_eq!(check_edges(&dir), 0);
+
+    // A header newer than the objects that include it, as after an
+    // edit, sends those translation units back to the compiler.
+    let header = std::fs::File::options()
+        .write(true)
+        .open(dir.path().join("include/greet/greet.hpp"))
+        .unwrap();
+    header
+        .set_modified(std::time::SystemTime::now() + std::time::Duration::from_secs(60))
+        .unwrap();
+    run("check").success();
+    assert_eq!(check_edges(&dir), 2);
+}
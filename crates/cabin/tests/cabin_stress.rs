@@ -0,0 +1,603 @@
+//! Workspace-scale stress fixtures and the end-to-end timing harness.
+//!
+//! The CLI tests exercise correctness on tiny fixtures.  This binary
+//! generates a synthetic workspace shaped like a large real one -
+//! hundreds of members wired into deep path-dependency chains, several
+//! features per member, versioned dependencies on a local file registry
+//! written by `cabin publish`, and system dependencies answered by the
+//! fake `pkg-config` - and times Cabin on it.
+//!
+//! `cargo test --workspace --all-features` plans a smoke-scale fixture
+//! once, so the generator stays valid as Cabin changes.  The ignored
+//! test is the full-scale timing run; the fake tools live in other
+//! packages, so build them first when testing this binary alone:
+//!
+//! ```text
+//! cargo build --release -p cabinpkg-ninja -p cabinpkg-system-deps --all-features --bins
+//! cargo test --release -p cabinpkg --test cabin_stress -- --ignored --nocapture
+//! ```
+//!
+//! The timing run reports the median, min and max wall time of each
+//! phase over `CABIN_STRESS_RUNS` runs (default 5), each after one
+//! untimed warmup run:
+//!
+//! - `build-noop`: `cabin build --workspace` with nothing to do, driven
+//!   through the fake `ninja` so only Cabin's own loading, resolution
+//!   and planning is measured;
+//! - `metadata`: `cabin metadata` over the whole workspace;
+//! - `test`: `cabin test --workspace` on an up-to-date tree with the
+//!   real toolchain, including running the test at the end of each
+//!   chain.
+//!
+//! A phase fails the run when its median exceeds its budget, which
+//! `CABIN_STRESS_BUDGET_MS_<PHASE>` overrides (`BUILD_NOOP`, `METADATA`,
+//! `TEST`).  `CABIN_STRESS_REPORT=<path>` writes the results as JSON;
+//! passing that file back as `CABIN_STRESS_BASELINE=<path>` also fails
+//! any phase slower than the baseline's median times
+//! `CABIN_STRESS_TOLERANCE` (default 1.25).  `CABIN_STRESS_MEMBERS`
+//! and `CABIN_STRESS_CHAIN` resize the workspace.
+
+use std::fmt::Write as _;
+use std::fs;
+use std::path::{Path, PathBuf};
+use std::time::{Duration, Instant};
+
+use assert_cmd::Command;
+use assert_fs::TempDir;
+
+mod common;
+use common::*;
+
+/// Budgets for the default full-scale shape under a release build on a
+/// CI runner, generous enough to absorb runner noise: they catch a
+/// phase going quadratic, not a few percent.
+const BUDGETS: &[(&str, Duration)] = &[
+    ("build-noop", Duration::from_secs(3)),
+    ("metadata", Duration::from_secs(3)),
+    ("test", Duration::from_secs(10)),
+];
+
+/// Dimensions of a generated stress workspace.
+#[derive(Clone, Copy, Debug)]
+struct StressShape {
+    /// Workspace members.
+    members: usize,
+    /// Members per path-dependency chain.  Each member depends on the
+    /// one before it, so this is also the depth of the deepest chain.
+    chain: usize,
+    /// Features every member declares, each gating a define.
+    features: usize,
+    /// Packages in the local file registry, each published at two
+    /// versions.
+    registry_packages: usize,
+    /// `pkg-config` modules spread over the members.
+    system_deps: usize,
+}
+
+impl StressShape {
+    /// Small enough to generate and plan on every `cargo test`.
+    fn smoke() -> Self {
+        Self {
+            members: 12,
+            chain: 4,
+            features: 3,
+            registry_packages: 3,
+            system_deps: host_system_deps(2),
+        }
+    }
+
+    /// The timing run's shape.
+    fn full() -> Self {
+        Self {
+            members: env_usize("CABIN_STRESS_MEMBERS", 300),
+            chain: env_usize("CABIN_STRESS_CHAIN", 50),
+            features: 8,
+            registry_packages: 16,
+            system_deps: host_system_deps(4),
+        }
+    }
+
+    fn is_chain_end(self, member: usize) -> bool {
+        member % self.chain == self.chain - 1 || member == self.members - 1
+    }
+}
+
+/// Cabin refuses `system = true` dependencies under the default
+/// Windows toolchain (MSVC), so Windows fixtures declare none.
+fn host_system_deps(count: usize) -> usize {
+    if cfg!(windows) { 0 } else { count }
+}
+
+fn member_name(member: usize) -> String {
+    format!("m{member:04}")
+}
+
+fn registry_name(package: usize) -> String {
+    format!("r{package:02}")
+}
+
+fn system_name(module: usize) -> String {
+    format!("stress-sys{module}")
+}
+
+/// Write `body` to `path`, creating parent directories.
+fn write(path: &Path, body: &str) {
+    if let Some(parent) = path.parent() {
+        fs::create_dir_all(parent).unwrap();
+    }
+    fs::write(path, body).unwrap_or_else(|err| panic!("failed to write {}: {err}", path.display()));
+}
+
+/// A generated workspace plus the registry and `pkg-config` fixtures
+/// it resolves against, all under one temp dir.
+struct StressWorkspace {
+    dir: TempDir,
+    shape: StressShape,
+}
+
+impl StressWorkspace {
+    fn generate(shape: StressShape) -> Self {
+        assert!(
+            shape.members > 0 && shape.chain > 0 && shape.features > 0,
+            "a stress workspace needs members, chains and features: {shape:?}"
+        );
+        let dir = TempDir::new().expect("temp dir");
+        let ws = Self { dir, shape };
+        for package in 0..shape.registry_packages {
+            ws.publish_registry_package(package);
+        }
+        for module in 0..shape.system_deps {
+            write(
+                &ws.pkg_config_fixtures()
+                    .join(format!("{}.json", system_name(module))),
+                &format!(
+                    "{{\"version\": \"1.0.0\", \"cflags\": \"-DSTRESS_SYS{module}=1\", \"libs\": \"\"}}\n"
+                ),
+            );
+        }
+        let mut members = String::new();
+        for member in 0..shape.members {
+            ws.write_member(member);
+            let _ = writeln!(members, "  \"members/{}\",", member_name(member));
+        }
+        write(
+            &ws.manifest(),
+            &format!("[workspace]\nmembers = [\n{members}]\n"),
+        );
+        // The workspace config points every command - `cabin metadata`
+        // takes no `--index-path` - at the local registry.  Relative
+        // paths resolve against `.cabin/`.
+        write(
+            &ws.root().join(".cabin/config.toml"),
+            "[registry]\nindex-path = \"../../registry\"\n",
+        );
+        fs::create_dir_all(ws.config_home()).unwrap();
+        ws
+    }
+
+    fn root(&self) -> PathBuf {
+        self.dir.path().join("ws")
+    }
+
+    fn manifest(&self) -> PathBuf {
+        self.root().join("cabin.toml")
+    }
+
+    fn pkg_config_fixtures(&self) -> PathBuf {
+        self.dir.path().join("pkg-config")
+    }
+
+    /// Empty user-config home, so only the workspace config applies.
+    fn config_home(&self) -> PathBuf {
+        self.dir.path().join("config-home")
+    }
+
+    /// Publish `stress/rNN` at 1.0.0 and 1.1.0, so every registry
+    /// dependency has a version to choose between.
+    fn publish_registry_package(&self, package: usize) {
+        let name = registry_name(package);
+        let src = self.dir.path().join("registry-src").join(&name);
+        write(
+            &src.join(format!("include/{name}.h")),
+            &format!("#pragma once\nint {name}_value();\n"),
+        );
+        write(
+            &src.join(format!("src/{name}.cc")),
+            &format!("#include \"{name}.h\"\nint {name}_value() {{ return 1; }}\n"),
+        );
+        for version in ["1.0.0", "1.1.0"] {
+            write(
+                &src.join("cabin.toml"),
+                &format!(
+                    "[package]\nname = \"stress/{name}\"\nversion = \"{version}\"\ncxx-standard = \"c++17\"\n\n\
+                     [target.{name}]\ntype = \"library\"\nsources = [\"src/{name}.cc\"]\ninclude-dirs = [\"include\"]\n"
+                ),
+            );
+            cabin()
+                .args(["publish", "--manifest-path"])
+                .arg(src.join("cabin.toml"))
+                .arg("--registry-dir")
+                .arg(self.dir.path().join("registry"))
+                .assert()
+                .success();
+        }
+    }
+
+    /// Member `i` depends on member `i - 1` unless it starts a chain,
+    /// asking for that member's last (non-default) feature, plus one
+    /// registry package and, for every third member, one system
+    /// dependency.  The member ending each chain declares a test.
+    fn write_member(&self, member: usize) {
+        let shape = self.shape;
+        let name = member_name(member);
+        let dir = self.root().join("members").join(&name);
+        let prev = (!member.is_multiple_of(shape.chain)).then(|| member_name(member - 1));
+        let registry =
+            (shape.registry_packages > 0).then(|| registry_name(member % shape.registry_packages));
+        let system = (shape.system_deps > 0 && member.is_multiple_of(3))
+            .then(|| system_name(member % shape.system_deps));
+
+        let mut manifest = format!(
+            "[package]\nname = \"{name}\"\nversion = \"0.1.0\"\ncxx-standard = \"c++17\"\n\n\
+             [features]\ndefault = [\"f0\"]\n"
+        );
+        for feature in 0..shape.features {
+            let _ = writeln!(manifest, "f{feature} = []");
+        }
+        manifest.push_str("\n[dependencies]\n");
+        let mut deps = Vec::new();
+        if let Some(prev) = &prev {
+            let _ = writeln!(
+                manifest,
+                "{prev} = {{ path = \"../{prev}\", features = [\"f{}\"] }}",
+                shape.features - 1
+            );
+            deps.push(format!("\"{prev}\""));
+        }
+        if let Some(registry) = &registry {
+            let _ = writeln!(manifest, "\"stress/{registry}\" = \"^1\"");
+            deps.push(format!("\"stress/{registry}\""));
+        }
+        if let Some(system) = &system {
+            let _ = writeln!(
+                manifest,
+                "{system} = {{ version = \">=1\", system = true }}"
+            );
+        }
+        let _ = write!(
+            manifest,
+            "\n[target.{name}]\ntype = \"library\"\nsources = [\"src/{name}.cc\"]\n\
+             include-dirs = [\"include\"]\ndeps = [{}]\n",
+            deps.join(", ")
+        );
+        for feature in 0..shape.features {
+            let _ = write!(
+                manifest,
+                "\n[target.'cfg(feature = \"f{feature}\")'.profile]\ndefines = [\"{}_F{feature}\"]\n",
+                name.to_uppercase()
+            );
+        }
+
+        let mut source = format!("#include \"{name}.h\"\n");
+        let mut value = String::from("1");
+        for dep in prev.iter().chain(&registry) {
+            let _ = writeln!(source, "#include \"{dep}.h\"");
+            let _ = write!(value, " + {dep}_value()");
+        }
+        let _ = writeln!(source, "int {name}_value() {{ return {value}; }}");
+        write(
+            &dir.join(format!("include/{name}.h")),
+            &format!("#pragma once\nint {name}_value();\n"),
+        );
+        write(&dir.join(format!("src/{name}.cc")), &source);
+
+        if shape.is_chain_end(member) {
+            let _ = write!(
+                manifest,
+                "\n[target.{name}_test]\ntype = \"test\"\nsources = [\"tests/{name}_test.cc\"]\n\
+                 deps = [\"{name}\"]\n"
+            );
+            write(
+                &dir.join(format!("tests/{name}_test.cc")),
+                &format!(
+                    "#include \"{name}.h\"\nint main() {{ return {name}_value() > 0 ? 0 : 1; }}\n"
+                ),
+            );
+        }
+        write(&dir.join("cabin.toml"), &manifest);
+    }
+
+    /// A `cabin` command run from the workspace root with config
+    /// discovery on and the fake `pkg-config` answering system
+    /// dependencies.
+    fn cabin(&self) -> Command {
+        let mut cmd = cabin();
+        cmd.current_dir(self.root())
+            .env_remove("CABIN_NO_CONFIG")
+            .env("CABIN_CONFIG_HOME", self.config_home())
+            .env(
+                "CABIN_PKG_CONFIG",
+                workspace_test_bin("cabin-system-deps-fake-pkg-config"),
+            )
+            .env("CABIN_FAKE_PKG_CONFIG_FIXTURES", self.pkg_config_fixtures());
+        cmd
+    }
+
+    /// [`Self::cabin`] with the fake `ninja` standing in for the build
+    /// backend.
+    fn cabin_with_fake_ninja(&self) -> Command {
+        let mut cmd = self.cabin();
+        cmd.env("NINJA", workspace_test_bin("cabin-ninja-fake-ninja"));
+        cmd
+    }
+}
+
+#[test]
+fn stress_fixture_plans_at_smoke_scale() {
+    let shape = StressShape::smoke();
+    let ws = StressWorkspace::generate(shape);
+    let record = ws.dir.path().join("ninja.log");
+
+    for _ in 0..2 {
+        ws.cabin_with_fake_ninja()
+            .env("CABIN_FAKE_NINJA_RECORD", &record)
+            .args(["build", "--workspace"])
+            .assert()
+            .success();
+    }
+    let invocations = fs::read_to_string(&record).unwrap_or_default();
+    assert_eq!(
+        invocations.lines().count(),
+        2,
+        "each build should hand the plan to ninja once:\n{invocations}"
+    );
+
+    let ninja = fs::read_to_string(ws.root().join("build/dev/build.ninja")).unwrap();
+    for member in 0..shape.members {
+        let name = member_name(member);
+        assert!(
+            ninja.contains(&format!("{name}.cc")),
+            "build.ninja should compile `{name}`:\n{ninja}"
+        );
+        // Every member keeps its default feature; only members with a
+        // dependent get the feature the dependent's edge asks for.
+        let upper = name.to_uppercase();
+        assert!(ninja.contains(&format!("{upper}_F0")), "{ninja}");
+        let last = format!("{upper}_F{}", shape.features - 1);
+        assert_eq!(
+            ninja.contains(&last),
+            !shape.is_chain_end(member),
+            "`{last}` should be defined exactly when `{name}` has a dependent:\n{ninja}"
+        );
+    }
+    for package in 0..shape.registry_packages {
+        let name = registry_name(package);
+        assert!(
+            ninja.contains(&format!("{name}.cc")),
+            "build.ninja should compile registry package `{name}`:\n{ninja}"
+        );
+    }
+    for module in 0..shape.system_deps {
+        assert!(
+            ninja.contains(&format!("STRESS_SYS{module}")),
+            "pkg-config cflags for `{}` should reach the compile:\n{ninja}",
+            system_name(module)
+        );
+    }
+
+    let output = ws
+        .cabin()
+        .args(["metadata", "--manifest-path"])
+        .arg(ws.manifest())
+        .assert()
+        .success()
+        .get_output()
+        .clone();
+    let metadata: serde_json::Value = serde_json::from_slice(&output.stdout).unwrap();
+    let packages = metadata["packages"]
+        .as_array()
+        .expect("packages must be array");
+    for member in 0..shape.members {
+        let name = member_name(member);
+        assert!(
+            packages
+                .iter()
+                .any(|package| package["name"] == name.as_str()),
+            "metadata should list member `{name}`: {metadata}"
+        );
+    }
+}
+
+/// Wall-time samples of one phase.
+struct Phase {
+    name: &'static str,
+    samples: Vec<Duration>,
+}
+
+impl Phase {
+    fn median(&self) -> Duration {
+        let mut sorted = self.samples.clone();
+        sorted.sort();
+        sorted[sorted.len() / 2]
+    }
+
+    fn min(&self) -> Duration {
+        self.samples.iter().copied().min().unwrap_or_default()
+    }
+
+    fn max(&self) -> Duration {
+        self.samples.iter().copied().max().unwrap_or_default()
+    }
+}
+
+/// Run `command()` once untimed, then `runs` more times timed.  The
+/// warmup pays for the first resolve and, for `test`, the first
+/// compile, so every timed run measures the steady state.
+fn time_phase(name: &'static str, runs: usize, command: impl Fn() -> Command) -> Phase {
+    command().assert().success();
+    let samples = (0..runs.max(1))
+        .map(|_| {
+            let mut cmd = command();
+            let start = Instant::now();
+            cmd.assert().success();
+            start.elapsed()
+        })
+        .collect();
+    Phase { name, samples }
+}
+
+fn millis(duration: Duration) -> f64 {
+    duration.as_secs_f64() * 1000.0
+}
+
+fn env_usize(key: &str, default: usize) -> usize {
+    std::env::var(key).map_or(default, |value| {
+        value
+            .parse()
+            .unwrap_or_else(|_| panic!("{key} must be a non-negative integer, got `{value}`"))
+    })
+}
+
+fn env_f64(key: &str, default: f64) -> f64 {
+    std::env::var(key).map_or(default, |value| {
+        value
+            .parse()
+            .unwrap_or_else(|_| panic!("{key} must be a number, got `{value}`"))
+    })
+}
+
+/// The budget for `phase`: `CABIN_STRESS_BUDGET_MS_<PHASE>`, else the
+/// built-in default.
+fn budget(phase: &str) -> Duration {
+    let key = format!(
+        "CABIN_STRESS_BUDGET_MS_{}",
+        phase.to_uppercase().replace('-', "_")
+    );
+    let default = BUDGETS
+        .iter()
+        .find(|(name, _)| *name == phase)
+        .map_or(Duration::MAX, |(_, budget)| *budget);
+    std::env::var(&key).map_or(default, |value| {
+        Duration::from_millis(
+            value
+                .parse()
+                .unwrap_or_else(|_| panic!("{key} must be milliseconds, got `{value}`")),
+        )
+    })
+}
+
+fn report_json(shape: StressShape, phases: &[Phase]) -> serde_json::Value {
+    serde_json::json!({
+        "shape": {
+            "members": shape.members,
+            "chain": shape.chain,
+            "features": shape.features,
+            "registry_packages": shape.registry_packages,
+            "system_deps": shape.system_deps,
+        },
+        "phases": phases
+            .iter()
+            .map(|phase| (phase.name.to_owned(), serde_json::json!({
+                "median_ms": millis(phase.median()),
+                "min_ms": millis(phase.min()),
+                "max_ms": millis(phase.max()),
+                "runs": phase.samples.len(),
+            })))
+            .collect::<serde_json::Map<_, _>>(),
+    })
+}
+
+#[test]
+#[ignore = "workspace-scale timing run; see the module docs for how to run it"]
+fn stress_timing() {
+    require_cxx_build_tools();
+    let shape = StressShape::full();
+    let runs = env_usize("CABIN_STRESS_RUNS", 5);
+    let started = Instant::now();
+    let ws = StressWorkspace::generate(shape);
+    println!(
+        "generated {} members ({}-deep chains, {} features each), {} registry packages and {} \
+         system deps in {:.2}s",
+        shape.members,
+        shape.chain,
+        shape.features,
+        shape.registry_packages,
+        shape.system_deps,
+        started.elapsed().as_secs_f64()
+    );
+
+    // `build-noop` runs first: its warmup resolves the registry
+    // dependencies and writes the lockfile the later phases reuse.
+    let phases = [
+        time_phase("build-noop", runs, || {
+            let mut cmd = ws.cabin_with_fake_ninja();
+            cmd.args(["build", "--workspace"]);
+            cmd
+        }),
+        time_phase("metadata", runs, || {
+            let mut cmd = ws.cabin();
+            cmd.args(["metadata", "--manifest-path"]).arg(ws.manifest());
+            cmd
+        }),
+        time_phase("test", runs, || {
+            let mut cmd = ws.cabin();
+            cmd.args(["test", "--workspace"]);
+            cmd
+        }),
+    ];
+
+    let baseline = std::env::var_os("CABIN_STRESS_BASELINE").map(|path| {
+        let body = fs::read_to_string(&path)
+            .unwrap_or_else(|err| panic!("failed to read CABIN_STRESS_BASELINE: {err}"));
+        serde_json::from_str::<serde_json::Value>(&body)
+            .unwrap_or_else(|err| panic!("CABIN_STRESS_BASELINE is not a stress report: {err}"))
+    });
+    let tolerance = env_f64("CABIN_STRESS_TOLERANCE", 1.25);
+    let mut failures = Vec::new();
+    for phase in &phases {
+        let median = millis(phase.median());
+        let budget = budget(phase.name);
+        let mut line = format!(
+            "{:<12} {median:>9.1} ms   [min {:>8.1}, max {:>8.1}]  ({} runs)",
+            phase.name,
+            millis(phase.min()),
+            millis(phase.max()),
+            phase.samples.len(),
+        );
+        if phase.median() > budget {
+            failures.push(format!(
+                "`{}` took {median:.1} ms, over its {:.0} ms budget",
+                phase.name,
+                millis(budget)
+            ));
+        }
+        if let Some(before) = baseline
+            .as_ref()
+            .and_then(|baseline| baseline["phases"][phase.name]["median_ms"].as_f64())
+        {
+            let _ = write!(
+                line,
+                "  baseline {before:.1} ms ({:+.1}%)",
+                (median / before - 1.0) * 100.0
+            );
+            if median > before * tolerance {
+                failures.push(format!(
+                    "`{}` took {median:.1} ms, over {tolerance}x its {before:.1} ms baseline",
+                    phase.name
+                ));
+            }
+        }
+        println!("{line}");
+    }
+
+    if let Some(path) = std::env::var_os("CABIN_STRESS_REPORT") {
+        let body = serde_json::to_string_pretty(&report_json(shape, &phases)).unwrap();
+        fs::write(&path, body + "\n")
+            .unwrap_or_else(|err| panic!("failed to write CABIN_STRESS_REPORT: {err}"));
+    }
+    assert!(
+        failures.is_empty(),
+        "stress timing regressed:\n  {}",
+        failures.join("\n  ")
+    );
+}
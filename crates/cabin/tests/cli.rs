@@ -188,24 +188,6 @@ fn require_external_tool(name: &str) {
     );
 }
 
-fn workspace_test_bin(name: &str) -> PathBuf {
-    let test_exe = std::env::current_exe().expect("current_exe");
-    let mut dir = test_exe
-        .parent()
-        .expect("test exe should live in a directory")
-        .to_path_buf();
-    if dir.file_name().and_then(|n| n.to_str()) == Some("deps") {
-        dir.pop();
-    }
-    let candidate = dir.join(format!("{name}{}", std::env::consts::EXE_SUFFIX));
-    assert!(
-        candidate.is_file(),
-        "expected test helper binary at {}; build the workspace tests with the matching fake-tool feature enabled",
-        candidate.display()
-    );
-    candidate
-}
-
 /// Write a fake tool that, when invoked with any args,
 /// prints `stdout` and `stderr` and exits with `status`.  The
 /// shell wrapper is used because the CLI invokes
@@ -2572,6 +2554,12 @@ mod patches;
 #[path = "cli/test_targets.rs"]
 mod test_targets;
 
+#[path = "cli/bench_targets.rs"]
+mod bench_targets;
+
+#[path = "cli/bloat_command.rs"]
+mod bloat_command;
+
 #[path = "cli/c_language.rs"]
 mod c_language;
 
@@ -0,0 +1,115 @@
+use super::*;
+
+/// A `bench` target that reports its samples in the line format.
+/// The sample value comes from `timing.txt` in the package root,
+/// so a test can make the "same" benchmark slower between runs.
+fn line_format_bench_project() -> TempDir {
+    let dir = TempDir::new().unwrap();
+    dir.child("cabin.toml")
+        .write_str(
+            r#"[package]
+name = "demo"
+version = "0.1.0"
+cxx-standard = "c++17"
+
+[target.micro]
+type = "bench"
+sources = ["benches/micro.cc"]
+"#,
+        )
+        .unwrap();
+    dir.child("benches/micro.cc")
+        .write_str(
+            r#"#include <cstdio>
+
+int main() {
+  double nanos = 0;
+  std::FILE* f = std::fopen("timing.txt", "r");
+  if (f == nullptr || std::fscanf(f, "%lf", &nanos) != 1) return 1;
+  std::fclose(f);
+  for (int i = 0; i < 3; ++i) std::printf("cabin-bench lookup %f\n", nanos);
+  return 0;
+}
+"#,
+        )
+        .unwrap();
+    dir.child("timing.txt").write_str("100\n").unwrap();
+    dir
+}
+
+fn cabin_bench(dir: &TempDir) -> Command {
+    let mut cmd = cabin();
+    cmd.args(["bench", "--manifest-path"])
+        .arg(dir.path().join("cabin.toml"))
+        .arg("--build-dir")
+        .arg(dir.path().join("build"));
+    cmd
+}
+
+#[test]
+fn cabin_bench_saves_baselines_and_flags_regressions() {
+    require_cxx_build_tools();
+    let dir = line_format_bench_project();
+
+    let assertion = cabin_bench(&dir)
+        .args(["--save-baseline", "before"])
+        .assert()
+        .success();
+    let stdout = String::from_utf8_lossy(&assertion.get_output().stdout);
+    assert!(
+        stdout.contains("bench demo:micro lookup ... 100.00 ns/iter (± 0.00 ns, 3 samples)"),
+        "expected the benchmark line, got stdout: {stdout}"
+    );
+    assert!(dir.path().join("build/release/bench/latest.json").is_file());
+    assert!(
+        dir.path()
+            .join("build/release/bench/baselines/before.json")
+            .is_file()
+    );
+
+    dir.child("timing.txt").write_str("150\n").unwrap();
+    let assertion = cabin_bench(&dir)
+        .args(["--baseline", "before", "--fail-on-regression"])
+        .assert()
+        .failure();
+    let stdout = String::from_utf8_lossy(&assertion.get_output().stdout);
+    assert!(
+        stdout.contains("[+50.00%, regressed]"),
+        "expected a regression verdict, got stdout: {stdout}"
+    );
+    assert!(
+        stdout.contains("1 benchmark; 1 regressed; 0 improved"),
+        "expected the comparison summary, got stdout: {stdout}"
+    );
+
+    // Within the noise threshold, the same comparison passes.
+    cabin_bench(&dir)
+        .args(["--baseline", "before", "--fail-on-regression"])
+        .args(["--noise-threshold", "60"])
+        .assert()
+        .success();
+}
+
+#[test]
+fn cabin_bench_rejects_unknown_baseline_before_running() {
+    require_cxx_build_tools();
+    let dir = line_format_bench_project();
+    cabin_bench(&dir)
+        .args(["--baseline", "missing"])
+        .assert()
+        .failure()
+        .stderr(predicate::str::contains("missing.json"))
+        .stdout(predicate::str::contains("running").not());
+}
+
+#[test]
+fn cabin_bench_errors_without_bench_targets() {
+    let dir = TempDir::new().unwrap();
+    dir.child("cabin.toml")
+        .write_str("[package]\nname = \"demo\"\nversion = \"0.1.0\"\n")
+        .unwrap();
+    cabin_bench(&dir)
+        .assert()
+        .failure()
+        .stderr(predicate::str::contains("no bench targets found"));
+}
@@ -0,0 +1,141 @@
+use super::*;
+
+/// An executable linking a same-package library, so the report has
+/// two planned targets to attribute bytes to.
+fn bloat_project() -> TempDir {
+    let dir = TempDir::new().unwrap();
+    dir.child("cabin.toml")
+        .write_str(
+            r#"[package]
+name = "demo"
+version = "0.1.0"
+cxx-standard = "c++17"
+
+[target.greet]
+type = "library"
+sources = ["src/greet.cc"]
+include-dirs = ["include"]
+
+[target.app]
+type = "executable"
+sources = ["src/main.cc"]
+deps = ["greet"]
+"#,
+        )
+        .unwrap();
+    dir.child("include/greet.h")
+        .write_str("#pragma once\nint greet_value(int seed);\n")
+        .unwrap();
+    dir.child("src/greet.cc")
+        .write_str(
+            "#include \"greet.h\"\n\
+             int greet_value(int seed) { return seed * 3 + 1; }\n",
+        )
+        .unwrap();
+    dir.child("src/main.cc")
+        .write_str(
+            "#include \"greet.h\"\n\
+             int main(int argc, char**) { return greet_value(argc) == 4 ? 0 : 1; }\n",
+        )
+        .unwrap();
+    dir
+}
+
+fn cabin_bloat(dir: &TempDir) -> Command {
+    let mut cmd = cabin();
+    cmd.args(["bloat", "--manifest-path"])
+        .arg(dir.path().join("cabin.toml"))
+        .arg("--build-dir")
+        .arg(dir.path().join("build"));
+    cmd
+}
+
+#[cfg(target_os = "linux")]
+#[test]
+fn cabin_bloat_attributes_bytes_to_targets_and_diffs_baselines() {
+    require_cxx_build_tools();
+    let dir = bloat_project();
+
+    let assertion = cabin_bloat(&dir)
+        .args(["--save-baseline", "before"])
+        .assert()
+        .success();
+    let stdout = String::from_utf8_lossy(&assertion.get_output().stdout);
+    assert!(
+        stdout.contains("bloat demo:app: text "),
+        "expected the executable header, got stdout: {stdout}"
+    );
+    for row in ["  demo:app\n", "  demo:greet\n", "  [external]"] {
+        assert!(
+            stdout.contains(row),
+            "expected a `{row}` row, got stdout: {stdout}"
+        );
+    }
+    assert!(dir.path().join("build/dev/bloat/latest.json").is_file());
+    assert!(
+        dir.path()
+            .join("build/dev/bloat/baselines/before.json")
+            .is_file()
+    );
+
+    // An unchanged rebuild diffs clean.
+    let assertion = cabin_bloat(&dir)
+        .args(["--baseline", "before"])
+        .assert()
+        .success();
+    let stdout = String::from_utf8_lossy(&assertion.get_output().stdout);
+    assert!(
+        stdout.contains("text ") && stdout.contains("(+0 B)"),
+        "expected zero deltas, got stdout: {stdout}"
+    );
+    assert!(
+        stdout.contains("no changes"),
+        "expected unchanged tables, got stdout: {stdout}"
+    );
+
+    // Growing the library shows up against its target.
+    dir.child("src/greet.cc")
+        .write_str(
+            "#include \"greet.h\"\n\
+             static const char table[4096] = {1};\n\
+             int greet_value(int seed) { return seed * 3 + 1 + table[seed & 7] - 1; }\n",
+        )
+        .unwrap();
+    let assertion = cabin_bloat(&dir)
+        .args(["--baseline", "before"])
+        .assert()
+        .success();
+    let stdout = String::from_utf8_lossy(&assertion.get_output().stdout);
+    let targets = stdout.split("  target\n").nth(1).unwrap_or_default();
+    let first = targets.lines().next().unwrap_or_default();
+    assert!(
+        first.ends_with("  demo:greet") && first.contains("+4."),
+        "expected demo:greet to lead the target diff, got stdout: {stdout}"
+    );
+}
+
+#[cfg(target_os = "linux")]
+#[test]
+fn cabin_bloat_rejects_unknown_baseline_before_building() {
+    require_cxx_build_tools();
+    let dir = bloat_project();
+    cabin_bloat(&dir)
+        .args(["--baseline", "missing"])
+        .assert()
+        .failure()
+        .stderr(predicate::str::contains("missing.json"));
+    assert!(!dir.path().join("build/dev/bloat/latest.json").exists());
+}
+
+#[cfg(not(target_os = "macos"))]
+#[test]
+fn cabin_bloat_errors_without_executable_targets() {
+    let dir = TempDir::new().unwrap();
+    dir.child("cabin.toml")
+        .write_str("[package]\nname = \"demo\"\nversion = \"0.1.0\"\n")
+        .unwrap();
+    cabin_bloat(&dir)
+        .assert()
+        .failure()
+        .stderr(predicate::str::contains("no executable targets found"));
+}
@@ -1,7 +1,8 @@
 //! End-to-end coverage for the compiler-cache wrapper feature
-//! (`ccache` / `sccache`).  Each test stages a fake wrapper +
-//! compiler / archiver, points the CLI at them, and inspects
-//! either the metadata JSON or a stub `cabin build` invocation.
+//! (`ccache` / `sccache`, and the `recc` launcher integration).
+//! Each test stages a fake wrapper + compiler / archiver, points the
+//! CLI at them, and inspects either the metadata JSON or a stub
+//! `cabin build` invocation.
 
 // This module's tests drive Unix-only shell-script fakes.
 #[cfg(unix)]
@@ -414,3 +415,123 @@ compiler-wrapper = "ccache"
         "expected member-rejection error, got: {stderr}"
     );
 }
+
+/// Stage a `recc` stand-in in `bin`: it answers `--version`, appends
+/// the launcher settings it sees and its argv to `log`, then runs the
+/// wrapped compiler so the build still produces real objects.
+#[cfg(unix)]
+fn fake_recc(bin: &Path, log: &Path) -> PathBuf {
+    use std::os::unix::fs::PermissionsExt;
+    let path = bin.join("recc");
+    let script = format!(
+        "#!/bin/sh\n\
+         if [ \"$1\" = --version ]; then echo 'recc 1.2.0'; exit 0; fi\n\
+         printf '%s|%s|%s\\n' \"$RECC_SERVER\" \"$RECC_INSTANCE\" \"$*\" >> '{}'\n\
+         exec \"$@\"\n",
+        log.display()
+    );
+    fs::write(&path, script).unwrap();
+    fs::set_permissions(&path, fs::Permissions::from_mode(0o755)).unwrap();
+    path
+}
+
+#[cfg(unix)]
+#[test]
+fn recc_launcher_env_reaches_compiles_and_never_archives_or_links() {
+    require_cxx_build_tools();
+    let dir = TempDir::new().unwrap();
+    dir.child("cabin.toml")
+        .write_str(
+            r#"[package]
+name = "demo"
+version = "0.1.0"
+cxx-standard = "c++17"
+
+[target.core]
+type = "library"
+sources = ["src/core.cc"]
+
+[target.app]
+type = "executable"
+sources = ["src/main.cc"]
+deps = ["core"]
+
+[target.core_test]
+type = "test"
+sources = ["tests/core_test.cc"]
+deps = ["core"]
+
+[target.micro]
+type = "bench"
+sources = ["benches/micro.cc"]
+deps = ["core"]
+"#,
+        )
+        .unwrap();
+    dir.child("src/core.cc")
+        .write_str("int core() { return 0; }\n")
+        .unwrap();
+    dir.child("src/main.cc")
+        .write_str("int core();\nint main() { return core(); }\n")
+        .unwrap();
+    dir.child("tests/core_test.cc")
+        .write_str("int core();\nint main() { return core(); }\n")
+        .unwrap();
+    dir.child("benches/micro.cc")
+        .write_str(
+            "#include <cstdio>\nint core();\n\
+             int main() { std::printf(\"cabin-bench core %d\\n\", 10 + core()); }\n",
+        )
+        .unwrap();
+    let config = dir.child("remote.toml");
+    config
+        .write_str(
+            r#"[build]
+compiler-wrapper = "recc"
+
+[build.remote-execution]
+endpoint = "grpc://farm.example:8980"
+instance = "main"
+"#,
+        )
+        .unwrap();
+    let bin = TempDir::new().unwrap();
+    let log = bin.path().join("recc.log");
+    fake_recc(bin.path(), &log);
+    let path = std::env::join_paths(
+        std::iter::once(bin.path().to_path_buf())
+            .chain(std::env::split_paths(&std::env::var_os("PATH").unwrap())),
+    )
+    .unwrap();
+
+    // A separate build directory per command, so each one compiles
+    // from scratch instead of finding the previous command's objects.
+    for command in ["build", "test", "run", "bench", "bloat"] {
+        let _ = fs::remove_file(&log);
+        cabin()
+            .arg(command)
+            .arg("--manifest-path")
+            .arg(dir.path().join("cabin.toml"))
+            .arg("--build-dir")
+            .arg(dir.path().join(format!("build-{command}")))
+            .env_remove("CABIN_NO_CONFIG")
+            .env("CABIN_CONFIG", config.path())
+            .env("PATH", &path)
+            .assert()
+            .success();
+        let lines = fs::read_to_string(&log)
+            .unwrap_or_else(|_| panic!("`cabin {command}` never ran a compile through recc"));
+        for line in lines.lines() {
+            let mut fields = line.splitn(3, '|');
+            assert_eq!(fields.next(), Some("grpc://farm.example:8980"), "{line}");
+            assert_eq!(fields.next(), Some("main"), "{line}");
+            let argv = fields.next().unwrap();
+            // Only compiles are wrapped: an archive or link step
+            // reaching the launcher would log an argv without `-c`.
+            assert!(
+                argv.split(' ').any(|arg| arg == "-c"),
+                "`cabin {command}` sent a non-compile step through recc: {argv}"
+            );
+        }
+    }
+}
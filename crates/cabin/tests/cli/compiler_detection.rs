@@ -67,12 +67,16 @@ version = "0.1.0"
 cxx-standard = "c++17"
 
 [target.demo]
-type = "executable"
-sources = ["src/main.cc"]
+type = "library"
+sources = ["src/demo.cc"]
 "#,
         )
         .unwrap();
-    dir.child("src/main.cc").write_str(HELLO_MAIN_CC).unwrap();
+    // A library target keeps the archiver in the detection scope, so
+    // the MSVC compiler is checked against the GNU `ar` beside it.
+    dir.child("src/demo.cc")
+        .write_str("int demo() { return 0; }\n")
+        .unwrap();
     let bin = TempDir::new().unwrap();
     let cxx = fake_tool_with_output(
         bin.path(),
@@ -268,6 +272,14 @@ version = "0.1.0"
         "supported": true,
         "source": "version"
       },
+      "ar_response_file": {
+        "supported": true,
+        "source": "version"
+      },
+      "ar_thin": {
+        "supported": true,
+        "source": "version"
+      },
       "static_library_output": {
         "supported": true,
         "source": "version"
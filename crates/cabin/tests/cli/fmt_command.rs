@@ -40,7 +40,15 @@ fn top_level_help_lists_fmt() {
 fn fmt_help_documents_documented_flags() {
     let assertion = cabin().args(["fmt", "--help"]).assert().success();
     let stdout = String::from_utf8_lossy(&assertion.get_output().stdout).to_string();
-    for snippet in ["--check", "--build-dir", "--exclude", "--no-ignore-vcs"] {
+    for snippet in [
+        "--check",
+        "--build-dir",
+        "--exclude",
+        "--no-ignore-vcs",
+        "--changed",
+        "--cached",
+        "--since",
+    ] {
         assert!(
             stdout.contains(snippet),
             "`cabin fmt --help` should mention {snippet}: {stdout}"
@@ -464,3 +472,116 @@ version = "0.1.0"
     assert!(read(&dir.path().join("outer/src/main.cc")).contains(MARKER));
     assert!(!read(&dir.path().join("outer/nested/src/main.cc")).contains(MARKER));
 }
+
+/// Run `git` in `dir` with a throwaway identity, failing the test
+/// on a non-zero exit.
+fn git(dir: &Path, args: &[&str]) {
+    let status = std::process::Command::new("git")
+        .args([
+            "-c",
+            "user.name=cabin",
+            "-c",
+            "user.email=cabin@example.invalid",
+            "-c",
+            "commit.gpgsign=false",
+        ])
+        .args(args)
+        .current_dir(dir)
+        .status()
+        .expect("spawn git");
+    assert!(status.success(), "git {args:?} failed");
+}
+
+#[test]
+fn changed_formats_only_uncommitted_files() {
+    let dir = TempDir::new().unwrap();
+    dir.child("cabin.toml").write_str(VALID_MANIFEST).unwrap();
+    dir.child("src/main.cc")
+        .write_str("int main() {}\n")
+        .unwrap();
+    dir.child("src/edited.cc")
+        .write_str("int edited() {}\n")
+        .unwrap();
+    git(dir.path(), &["init", "-q"]);
+    git(dir.path(), &["add", "-A"]);
+    git(dir.path(), &["commit", "-q", "-m", "init"]);
+    dir.child("src/edited.cc")
+        .write_str("int edited() { return 1; }\n")
+        .unwrap();
+    dir.child("src/added.cc")
+        .write_str("int added() {}\n")
+        .unwrap();
+
+    cabin_with_fake_formatter()
+        .current_dir(dir.path())
+        .args(["fmt", "--changed"])
+        .assert()
+        .success()
+        .stdout(predicate::str::contains("Formatted 2 files"));
+
+    assert!(!read(&dir.path().join("src/main.cc")).contains(MARKER));
+    assert!(read(&dir.path().join("src/edited.cc")).contains(MARKER));
+    assert!(read(&dir.path().join("src/added.cc")).contains(MARKER));
+}
+
+#[test]
+fn changed_cached_formats_only_staged_files() {
+    let dir = TempDir::new().unwrap();
+    dir.child("cabin.toml").write_str(VALID_MANIFEST).unwrap();
+    dir.child("src/main.cc")
+        .write_str("int main() {}\n")
+        .unwrap();
+    dir.child("src/staged.cc")
+        .write_str("int staged() {}\n")
+        .unwrap();
+    git(dir.path(), &["init", "-q"]);
+    git(dir.path(), &["add", "-A"]);
+    git(dir.path(), &["commit", "-q", "-m", "init"]);
+    dir.child("src/staged.cc")
+        .write_str("int staged() { return 1; }\n")
+        .unwrap();
+    git(dir.path(), &["add", "src/staged.cc"]);
+    dir.child("src/main.cc")
+        .write_str("int main() { return 0; }\n")
+        .unwrap();
+    dir.child("src/untracked.cc")
+        .write_str("int untracked() {}\n")
+        .unwrap();
+
+    cabin_with_fake_formatter()
+        .current_dir(dir.path())
+        .args(["fmt", "--changed", "--cached"])
+        .assert()
+        .success()
+        .stdout(predicate::str::contains("Formatted 1 file"));
+
+    assert!(read(&dir.path().join("src/staged.cc")).contains(MARKER));
+    assert!(!read(&dir.path().join("src/main.cc")).contains(MARKER));
+    assert!(!read(&dir.path().join("src/untracked.cc")).contains(MARKER));
+}
+
+#[test]
+fn cached_requires_changed() {
+    cabin()
+        .args(["fmt", "--cached"])
+        .assert()
+        .failure()
+        .stderr(predicate::str::contains("--changed"));
+}
+
+#[test]
+fn since_unknown_revision_is_an_error() {
+    let dir = TempDir::new().unwrap();
+    write_minimal_project(dir.path());
+    git(dir.path(), &["init", "-q"]);
+    git(dir.path(), &["add", "-A"]);
+    git(dir.path(), &["commit", "-q", "-m", "init"]);
+
+    cabin_with_fake_formatter()
+        .current_dir(dir.path())
+        .args(["fmt", "--check", "--since", "no-such-rev"])
+        .assert()
+        .failure()
+        .stderr(predicate::str::contains("git merge-base"));
+    assert!(!read(&dir.path().join("src/main.cc")).contains(MARKER));
+}
@@ -695,11 +695,7 @@ zlib = { port = true, version = "^1.3" }
     // The bundled recipe is what discovery would resolve this to.
     let entry = cabin_port::builtin::lookup("zlib", &semver::VersionReq::parse("^1.3").unwrap())
         .expect("bundled zlib");
-    let descriptor = cabin_port::parse_port_str(
-        entry.port_toml,
-        std::path::Path::new("<builtin:zlib>/port.toml"),
-    )
-    .unwrap();
+    let descriptor = entry.descriptor().unwrap();
     assert_eq!(descriptor.name.as_str(), "zlib");
     assert_eq!(descriptor.version.to_string(), "1.3.1");
 }
@@ -166,6 +166,116 @@ fn build_without_jobs_does_not_pass_dash_j() {
     }
 }
 
+#[test]
+fn build_analyze_without_history_fails_without_building() {
+    let dir = TempDir::new().unwrap();
+    let record = dir.path().join("ninja.log");
+    write_minimal_project(dir.path());
+    let assertion = cabin_with_fake_ninja(&record)
+        .current_dir(dir.path())
+        .args(["build", "--analyze"])
+        .assert()
+        .failure();
+    let stderr = String::from_utf8_lossy(&assertion.get_output().stderr).to_string();
+    assert!(
+        stderr.contains(".ninja_log") && stderr.contains("run `cabin build`"),
+        "diagnostic should point at the missing build history:\n{stderr}"
+    );
+    assert!(
+        read_ninja_argvs(&record).is_empty(),
+        "`--analyze` must not invoke ninja"
+    );
+}
+
+#[test]
+fn build_analyze_json_costs_the_plan_with_the_recorded_history() {
+    use std::fmt::Write as _;
+
+    let dir = TempDir::new().unwrap();
+    let record = dir.path().join("ninja.log");
+    assert_fs::fixture::ChildPath::new(dir.path().join("cabin.toml"))
+        .write_str(&VALID_C_MANIFEST.replace(
+            r#"sources = ["src/main.cc"]"#,
+            r#"sources = ["src/main.cc", "src/extra.cc"]"#,
+        ))
+        .unwrap();
+    assert_fs::fixture::ChildPath::new(dir.path().join("src/main.cc"))
+        .write_str(HELLO_MAIN_CC)
+        .unwrap();
+    assert_fs::fixture::ChildPath::new(dir.path().join("src/extra.cc"))
+        .write_str("int extra() { return 1; }\n")
+        .unwrap();
+    // Two compiles (400ms, 300ms) feeding a 100ms link, relative to
+    // the profile build directory as Ninja records them.  Both
+    // dialects' artifact names are seeded so the fixture holds
+    // whichever compiler the host detects.
+    let obj = "packages/hello/obj/hello/src";
+    let mut log = String::from("# ninja log v6\n");
+    for ext in ["o", "obj"] {
+        writeln!(log, "0\t400\t1\t{obj}/main.cc.{ext}\t1").unwrap();
+        writeln!(log, "0\t300\t1\t{obj}/extra.cc.{ext}\t2").unwrap();
+    }
+    for exe in ["hello", "hello.exe"] {
+        writeln!(log, "400\t500\t1\tpackages/hello/{exe}\t3").unwrap();
+    }
+    assert_fs::fixture::ChildPath::new(dir.path().join("build/dev/.ninja_log"))
+        .write_str(&log)
+        .unwrap();
+
+    let assertion = cabin_with_fake_ninja(&record)
+        .current_dir(dir.path())
+        .args(["build", "--analyze=json"])
+        .assert()
+        .success();
+    assert!(
+        read_ninja_argvs(&record).is_empty(),
+        "`--analyze` must not invoke ninja"
+    );
+    let report: serde_json::Value = serde_json::from_slice(&assertion.get_output().stdout).unwrap();
+    assert_eq!(report["profile"], "dev");
+    assert_eq!(report["actions"], 3);
+    assert_eq!(report["estimated_actions"], 0);
+    assert_eq!(report["total_work_ms"], 800);
+    assert_eq!(report["critical_path_ms"], 500);
+
+    // One job runs everything back to back; a second runs the short
+    // compile beside the long one and reaches the critical path.
+    let speedup = report["speedup"].as_array().unwrap();
+    let points: Vec<(u64, u64)> = speedup
+        .iter()
+        .map(|p| {
+            (
+                p["jobs"].as_u64().unwrap(),
+                p["makespan_ms"].as_u64().unwrap(),
+            )
+        })
+        .collect();
+    assert_eq!(points, [(1, 800), (2, 500)]);
+    assert!((speedup[1]["speedup"].as_f64().unwrap() - 1.6).abs() < 1e-9);
+
+    // The critical path is the long compile, then the link, both
+    // attributed to the `hello` target of the `hello` package.
+    let critical = report["critical_path"].as_array().unwrap();
+    let kinds: Vec<&str> = critical
+        .iter()
+        .map(|a| a["kind"].as_str().unwrap())
+        .collect();
+    assert_eq!(kinds, ["compile", "link"]);
+    assert!(
+        Path::new(critical[0]["output"].as_str().unwrap())
+            .file_name()
+            .is_some_and(|name| name.to_string_lossy().starts_with("main.cc.")),
+        "{critical:?}"
+    );
+    assert_eq!(critical[0]["duration_ms"], 400);
+    assert_eq!(critical[1]["duration_ms"], 100);
+    for action in critical {
+        assert_eq!(action["package"], "hello");
+        assert_eq!(action["target"], "hello");
+        assert_eq!(action["estimated"], false);
+    }
+}
+
 #[test]
 fn test_rejects_jobs_flag() {
     // `cabin test` does not accept `--jobs` (or `-j`): the
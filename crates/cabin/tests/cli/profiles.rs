@@ -307,6 +307,81 @@ sources = ["src/main.cc"]
     );
 }
 
+#[test]
+fn repeated_profile_flags_share_one_ninja_run() {
+    require_cxx_build_tools();
+    let dir = TempDir::new().unwrap();
+    dir.child("cabin.toml")
+        .write_str(
+            r#"[package]
+name = "hello"
+version = "0.1.0"
+cxx-standard = "c++17"
+
+[target.hello]
+type = "executable"
+sources = ["src/main.cc"]
+"#,
+        )
+        .unwrap();
+    dir.child("src/main.cc").write_str(HELLO_MAIN_CC).unwrap();
+    let build_dir = dir.path().join("build");
+    let record = dir.path().join("ninja-record.txt");
+
+    cabin()
+        .current_dir(dir.path())
+        .env("NINJA", workspace_test_bin("cabin-ninja-fake-ninja"))
+        .env("CABIN_FAKE_NINJA_RECORD", &record)
+        .args([
+            "build",
+            "--profile",
+            "dev",
+            "--profile",
+            "release",
+            "--profile",
+            "dev",
+            "--build-dir",
+        ])
+        .arg(&build_dir)
+        .assert()
+        .success();
+
+    // One Ninja process over the combined file, not one per profile.
+    let invocations: Vec<String> = fs::read_to_string(&record)
+        .unwrap()
+        .lines()
+        .map(|line| line.replace('\u{001f}', " "))
+        .collect();
+    assert_eq!(invocations.len(), 1, "{invocations:?}");
+    assert!(
+        invocations[0].ends_with(&format!(
+            "-C {} -f multi-profile.ninja",
+            build_dir.display()
+        )),
+        "{invocations:?}"
+    );
+
+    // Each profile keeps its own root; the duplicate `dev` is planned once.
+    let combined = fs::read_to_string(build_dir.join("multi-profile.ninja")).unwrap();
+    let subninjas: Vec<&str> = combined
+        .lines()
+        .filter(|line| line.starts_with("subninja "))
+        .collect();
+    assert_eq!(subninjas.len(), 2, "{combined}");
+    assert!(subninjas[0].ends_with("build.ninja") && subninjas[0].contains("dev"));
+    assert!(subninjas[1].contains("release"));
+    let dev_ninja = fs::read_to_string(build_dir.join("dev/build.ninja")).unwrap();
+    let release_ninja = fs::read_to_string(build_dir.join("release/build.ninja")).unwrap();
+    assert!(
+        !dev_ninja.contains(host_define_ndebug_flag()),
+        "{dev_ninja}"
+    );
+    assert!(
+        release_ninja.contains(host_define_ndebug_flag()),
+        "{release_ninja}"
+    );
+}
+
 #[test]
 fn custom_profile_uses_its_own_output_directory() {
     require_cxx_build_tools();
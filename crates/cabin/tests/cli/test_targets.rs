@@ -570,6 +570,116 @@ fn cabin_test_exits_non_zero_on_failure() {
     );
 }
 
+/// A `test` target whose binary lists its cases with `--list` and
+/// runs a comma-separated selection with `--run=<cases>`; `gamma`
+/// fails.  Run whole, it prints `ran whole` and passes.
+fn custom_harness_project() -> TempDir {
+    let dir = TempDir::new().unwrap();
+    dir.child("cabin.toml")
+        .write_str(
+            r#"[package]
+name = "demo"
+version = "0.1.0"
+cxx-standard = "c++17"
+
+[target.cases_test]
+type = "test"
+sources = ["tests/cases.cc"]
+harness = { list = ["--list"], filter = "--run={}" }
+"#,
+        )
+        .unwrap();
+    dir.child("tests/cases.cc")
+        .write_str(
+            r#"#include <cstdio>
+#include <cstring>
+#include <string>
+
+int main(int argc, char** argv) {
+  const char* cases[] = {"alpha", "beta", "gamma", "delta"};
+  if (argc > 1 && std::strcmp(argv[1], "--list") == 0) {
+    for (const char* c : cases) std::printf("%s\n", c);
+    return 0;
+  }
+  if (argc > 1 && std::strncmp(argv[1], "--run=", 6) == 0) {
+    std::string selected = std::string(",") + (argv[1] + 6) + ",";
+    int status = 0;
+    for (const char* c : cases) {
+      if (selected.find(std::string(",") + c + ",") == std::string::npos) continue;
+      std::printf("ran %s\n", c);
+      if (std::strcmp(c, "gamma") == 0) status = 3;
+    }
+    return status;
+  }
+  std::printf("ran whole\n");
+  return 0;
+}
+"#,
+        )
+        .unwrap();
+    dir
+}
+
+#[test]
+fn cabin_test_splits_harnessed_binary_into_filtered_batches() {
+    require_cxx_build_tools();
+    let dir = custom_harness_project();
+    let assertion = cabin()
+        .args(["test", "--test-threads", "2", "--manifest-path"])
+        .arg(dir.path().join("cabin.toml"))
+        .arg("--build-dir")
+        .arg(dir.path().join("build"))
+        .assert()
+        .failure();
+    let stdout = String::from_utf8_lossy(&assertion.get_output().stdout);
+    for case in ["alpha", "beta", "gamma", "delta"] {
+        assert_eq!(
+            stdout.matches(&format!("ran {case}\n")).count(),
+            1,
+            "each case runs in exactly one batch, got stdout: {stdout}"
+        );
+    }
+    assert!(!stdout.contains("ran whole"), "got stdout: {stdout}");
+    // The batches merge back into one result for the executable.
+    assert!(
+        stdout.contains("test demo:cases_test ... FAILED (exit 3)"),
+        "got stdout: {stdout}"
+    );
+    assert!(
+        stdout.contains("test result: FAILED. 0 passed; 1 failed"),
+        "got stdout: {stdout}"
+    );
+    let timings =
+        std::fs::read_to_string(dir.path().join("build/dev/test-output/case-timings.tsv")).unwrap();
+    assert_eq!(
+        timings
+            .lines()
+            .filter(|l| l.starts_with("demo:cases_test\t"))
+            .count(),
+        4,
+        "every case gets a recorded duration, got: {timings}"
+    );
+}
+
+#[test]
+fn cabin_test_single_test_thread_runs_harnessed_binary_whole() {
+    require_cxx_build_tools();
+    let dir = custom_harness_project();
+    let assertion = cabin()
+        .args(["test", "--test-threads", "1", "--manifest-path"])
+        .arg(dir.path().join("cabin.toml"))
+        .arg("--build-dir")
+        .arg(dir.path().join("build"))
+        .assert()
+        .success();
+    let stdout = String::from_utf8_lossy(&assertion.get_output().stdout);
+    assert!(stdout.contains("ran whole"), "got stdout: {stdout}");
+    assert!(
+        stdout.contains("test demo:cases_test ... ok"),
+        "got stdout: {stdout}"
+    );
+}
+
 #[test]
 fn cabin_test_no_targets_errors_by_default() {
     let dir = TempDir::new().unwrap();
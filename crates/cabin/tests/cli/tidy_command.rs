@@ -88,6 +88,8 @@ fn tidy_help_documents_documented_flags() {
         "--build-dir",
         "--exclude",
         "--no-ignore-vcs",
+        "--changed",
+        "--since",
     ] {
         assert!(
             stdout.contains(snippet),
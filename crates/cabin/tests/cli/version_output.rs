@@ -141,6 +141,31 @@ fn version_quiet_does_not_suppress_output() {
     assert_eq!(stdout_leading, format!("cabin {CABIN_VERSION}\n"));
 }
 
+#[test]
+fn bare_version_queries_honor_env_verbosity() {
+    // `cabin --version`, `-V` and `version` are answered before clap
+    // parses anything; the env layer must still select the verbose
+    // block, and a malformed value must still be rejected.
+    for spelling in ["--version", "-V", "version"] {
+        let assertion = cabin()
+            .env(cabin_env::CABIN_TERM_VERBOSE, "1")
+            .arg(spelling)
+            .assert()
+            .success();
+        let stdout = String::from_utf8_lossy(&assertion.get_output().stdout).to_string();
+        assert!(
+            stdout.contains(format!("\nrelease: {CABIN_VERSION}\n").as_str()),
+            "`cabin {spelling}` ignored CABIN_TERM_VERBOSE: {stdout}"
+        );
+        cabin()
+            .env(cabin_env::CABIN_TERM_VERBOSE, "loud")
+            .arg(spelling)
+            .assert()
+            .failure()
+            .stderr(predicate::str::contains(cabin_env::CABIN_TERM_VERBOSE));
+    }
+}
+
 #[test]
 fn version_verbose_never_leaks_local_filesystem_paths() {
     let stdout = run_version(&["version", "-v"]);
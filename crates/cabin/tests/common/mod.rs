@@ -226,6 +226,27 @@ pub fn cabin() -> Command {
     cmd
 }
 
+/// Path of a helper binary Cargo built next to the test executable,
+/// such as `cabin-ninja-fake-ninja`.  The fake tools are gated on
+/// test-only features the `cabin` dev-dependencies enable.
+pub fn workspace_test_bin(name: &str) -> std::path::PathBuf {
+    let test_exe = std::env::current_exe().expect("current_exe");
+    let mut dir = test_exe
+        .parent()
+        .expect("test exe should live in a directory")
+        .to_path_buf();
+    if dir.file_name().and_then(|n| n.to_str()) == Some("deps") {
+        dir.pop();
+    }
+    let candidate = dir.join(format!("{name}{}", std::env::consts::EXE_SUFFIX));
+    assert!(
+        candidate.is_file(),
+        "expected test helper binary at {}; build the workspace tests with the matching fake-tool feature enabled",
+        candidate.display()
+    );
+    candidate
+}
+
 /// Pin `CABIN_CACHE_HOME` to a deterministic temp path.  Tests
 /// routinely strip `HOME` for config isolation, which would
 /// otherwise leave the user-global cache fallback
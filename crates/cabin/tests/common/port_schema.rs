@@ -10,7 +10,7 @@
 //! checking the schema invariants all ports share, and the
 //! bundled-recipe lookup.
 
-use std::path::{Path, PathBuf};
+use std::path::PathBuf;
 
 /// Load `crates/cabin-port/ports/<name>/<version>/port.toml` and
 /// assert the schema fields every foundation port shares: the
@@ -62,17 +62,15 @@ pub fn assert_tar_gz_source(descriptor: &cabin_port::PortDescriptor, expected_st
 
 /// Assert `name` is bundled in the builtin port registry at
 /// exactly `version` (looked up through `req`) and that the
-/// embedded `port.toml` parses back to the same identity.
+/// pre-parsed recipe validates back to the same identity.
 pub fn assert_builtin_port_bundled_and_parses(name: &str, req: &str, version: &str) {
     let entry = cabin_port::builtin::lookup(name, &semver::VersionReq::parse(req).unwrap())
         .unwrap_or_else(|| panic!("{name} should be bundled"));
     assert_eq!(entry.name, name);
     assert_eq!(entry.version, version);
-    let descriptor = cabin_port::parse_port_str(
-        entry.port_toml,
-        Path::new(&format!("<builtin:{name}>/port.toml")),
-    )
-    .unwrap_or_else(|err| panic!("embedded {name} port.toml should parse: {err:?}"));
+    let descriptor = entry
+        .descriptor()
+        .unwrap_or_else(|err| panic!("bundled {name} recipe should validate: {err:?}"));
     assert_eq!(descriptor.name.as_str(), name);
     assert_eq!(descriptor.version.to_string(), version);
 }
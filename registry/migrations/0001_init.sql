@@ -110,9 +110,10 @@ CREATE TABLE versions (
     verification_reason TEXT,
     verified_at TEXT,
     -- Cumulative download counter for the artifact read plane
-    -- (docs/architecture.md, "Download counts"): one approximate,
-    -- monotonically increasing total per version, incremented
-    -- best-effort after a verified download's body is served.
+    -- (docs/architecture.md, "Download counts"): the compacted base of
+    -- one approximate, monotonically increasing total per version.
+    -- Served downloads land in `download_shards` first; every read
+    -- sums this column and the version's shard rows.
     downloads INTEGER NOT NULL DEFAULT 0,
     PRIMARY KEY (scope, name, version),
     FOREIGN KEY (scope, name) REFERENCES packages (scope, name)
@@ -123,6 +124,23 @@ CREATE INDEX versions_published_by ON versions (published_by);
 CREATE INDEX versions_checksum ON versions (checksum);
 CREATE INDEX versions_verification ON versions (verification);
 
+-- Sharded download increments (docs/architecture.md, "Download
+-- counts"): each batched flush upserts its per-version count onto one
+-- of a few shard rows picked at random (src/telemetry.rs), so isolates
+-- flushing the same popular version do not all rewrite one row. Reads
+-- add SUM(count) to `versions.downloads`; the breaker cron's
+-- compaction pass moves shard counts into that column and deletes
+-- drained rows. Only verified versions ever gain a row.
+CREATE TABLE download_shards (
+    scope TEXT NOT NULL,
+    name TEXT NOT NULL,
+    version TEXT NOT NULL,
+    shard INTEGER NOT NULL,
+    count INTEGER NOT NULL,
+    PRIMARY KEY (scope, name, version, shard),
+    FOREIGN KEY (scope, name, version) REFERENCES versions (scope, name, version)
+);
+
 -- The verified-artifact backup queue (see docs/runbook.md, "Disaster
 -- recovery"). The verdict batch that marks a version verified enqueues
 -- its blob here in the same transaction; the drain (verdict waitUntil
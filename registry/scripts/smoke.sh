@@ -217,6 +217,7 @@ if [[ -n "$token" ]]; then
       VALUES ('smoke', 1, 'smoke', '${hash}', 'publish,yank', '1970-01-01T00:00:00Z');
     INSERT OR REPLACE INTO tokens (id, user_id, name, token_hash, scopes, created_at)
       VALUES ('smoke-verify', 1, 'smoke-verify', '${verify_hash}', 'verify', '1970-01-01T00:00:00Z');
+    DELETE FROM download_shards WHERE scope = 'smoke';
     DELETE FROM versions WHERE scope = 'smoke';
     DELETE FROM packages WHERE scope = 'smoke';
     DELETE FROM scope_members WHERE scope_name IN
@@ -1126,7 +1127,10 @@ await_row_downloads() {
   local expected="$1" row_downloads=""
   for _ in $(seq 1 20); do
     row_downloads="$(wrangler d1 execute DB --local --json --command \
-      "SELECT downloads FROM versions
+      "SELECT downloads + (SELECT COALESCE(SUM(d.count), 0) FROM download_shards d
+         WHERE d.scope = versions.scope AND d.name = versions.name
+           AND d.version = versions.version) AS downloads
+       FROM versions
        WHERE scope = 'smoke' AND name = 'withdep' AND version = '0.2.0'" |
       node -e '
         const out = JSON.parse(require("fs").readFileSync(0, "utf8"));
@@ -1262,7 +1266,10 @@ archive_size="$(wc -c <"$fixture_archive" | tr -d ' ')"
 # The version row's download counter, for the never-counted assertion.
 row_downloads() {
   wrangler d1 execute DB --local --json --command \
-    "SELECT downloads FROM versions
+    "SELECT downloads + (SELECT COALESCE(SUM(d.count), 0) FROM download_shards d
+       WHERE d.scope = versions.scope AND d.name = versions.name
+         AND d.version = versions.version) AS downloads
+     FROM versions
      WHERE scope = 'smoke' AND name = 'withdep' AND version = '0.2.0'" |
     node -e '
       const out = JSON.parse(require("fs").readFileSync(0, "utf8"));
@@ -101,6 +101,41 @@ pub fn package_json(name: &str, rows: &[VersionRow]) -> Result<String, String> {
     .expect("package document serializes"))
 }
 
+/// Whether a read-route request's `Accept-Encoding` admits gzip for the
+/// JSON documents above. Package documents with long version histories
+/// compress by an order of magnitude, and the Cabin client advertises
+/// exactly `gzip` on its metadata reads. A coding (or `*`) listed with
+/// `q=0` is an explicit refusal (RFC 9110 section 12.5.3); an absent
+/// header admits nothing, so older clients keep receiving identity
+/// bodies.
+pub fn accepts_gzip(accept_encoding: Option<&str>) -> bool {
+    let Some(header) = accept_encoding else {
+        return false;
+    };
+    let mut gzip = None;
+    let mut wildcard = None;
+    for item in header.split(',') {
+        let mut parts = item.split(';');
+        let coding = parts.next().unwrap_or_default().trim();
+        let weight = parts
+            .filter_map(|param| {
+                let (key, value) = param.split_once('=')?;
+                key.trim()
+                    .eq_ignore_ascii_case("q")
+                    .then(|| value.trim().parse::<f32>().ok())
+                    .flatten()
+            })
+            .next()
+            .unwrap_or(1.0);
+        if coding.eq_ignore_ascii_case("gzip") || coding.eq_ignore_ascii_case("x-gzip") {
+            gzip = Some(weight > 0.0);
+        } else if coding == "*" {
+            wildcard = Some(weight > 0.0);
+        }
+    }
+    gzip.or(wildcard).unwrap_or(false)
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -187,6 +222,28 @@ mod tests {
         assert!(positions.windows(2).all(|w| w[0] < w[1]), "body: {body}");
     }
 
+    #[test]
+    fn accepts_gzip_follows_the_accept_encoding_header() {
+        for (header, expected) in [
+            (None, false),
+            (Some(""), false),
+            (Some("gzip"), true),
+            (Some("GZIP"), true),
+            (Some("br, gzip;q=0.5"), true),
+            (Some("x-gzip"), true),
+            (Some("*"), true),
+            (Some("identity"), false),
+            (Some("br"), false),
+            // An explicit refusal wins over the wildcard either way round.
+            (Some("gzip;q=0"), false),
+            (Some("*, gzip;q=0"), false),
+            (Some("gzip;q=0, *"), false),
+            (Some("*;q=0"), false),
+        ] {
+            assert_eq!(accepts_gzip(header), expected, "header: {header:?}");
+        }
+    }
+
     #[test]
     fn package_json_rejects_non_object_metadata() {
         let err = package_json("fmtlib/fmt", &[row("1.0.0", "[1,2]", false)]).unwrap_err();
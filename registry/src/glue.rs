@@ -235,7 +235,21 @@ async fn handle_registry(
         } else {
             match route {
                 Route::Config => json_response(&documents::config_json(&web_origin(env)?))?,
-                Route::Package { scope, name } => package_response(&db, scope, name).await?,
+                Route::Package { scope, name } => {
+                    let accept_encoding = req.headers().get("accept-encoding")?;
+                    let mut response = package_response(&db, scope, name).await?;
+                    // Declaring the coding is all it takes: with the
+                    // default `encodeBody: "automatic"` the Workers runtime
+                    // gzips the body on the way out. Only successful
+                    // documents are compressed; refusals stay identity.
+                    if response.status_code() == 200
+                        && documents::accepts_gzip(accept_encoding.as_deref())
+                    {
+                        response.headers_mut().set("content-encoding", "gzip")?;
+                    }
+                    response.headers_mut().set("vary", "accept-encoding")?;
+                    response
+                }
                 Route::Artifact {
                     scope,
                     name,
@@ -1475,11 +1489,13 @@ fn count_download(env: &Env, ctx: &Context, scope: &str, name: &str, version: &s
         let statements: Vec<_> = batch
             .iter()
             .filter_map(|((scope, name, version), count)| {
-                db.prepare(sql::ADD_VERSION_DOWNLOADS)
+                let shard = telemetry::shard_for(worker::js_sys::Math::random());
+                db.prepare(sql::ADD_SHARD_DOWNLOADS)
                     .bind(&[
                         scope.as_str().into(),
                         name.as_str().into(),
                         version.as_str().into(),
+                        js_int(shard),
                         js_int(i64::from(*count)),
                     ])
                     .ok()
@@ -1497,6 +1513,104 @@ fn count_download(env: &Env, ctx: &Context, scope: &str, name: &str, version: &s
     });
 }
 
+#[derive(Deserialize)]
+struct DownloadShardRecord {
+    scope: String,
+    name: String,
+    version: String,
+    shard: i64,
+    count: i64,
+}
+
+/// One download-shard compaction page (`docs/architecture.md`,
+/// "Download counts"), run by every breaker cron pass: read the first
+/// [`telemetry::COMPACTION_PAGE_ROWS`] shard rows, then - in one batch,
+/// so the summed read never changes - credit each version's base
+/// column with what was read, debit exactly that from each shard, and
+/// delete the shards that drained. Best-effort like the counter
+/// itself: any failure is logged and leaves the shards for the next
+/// pass, and the pass is skipped while the breaker blocks writes.
+async fn compact_download_shards(env: &Env, db: &D1Database) {
+    match service_mode(env, db).await {
+        Ok(mode) if mode < breaker::Mode::WritesBlocked => {}
+        _ => return,
+    }
+    let rows: Vec<DownloadShardRecord> = match db
+        .prepare(sql::DOWNLOAD_SHARD_PAGE)
+        .bind(&[js_int(telemetry::COMPACTION_PAGE_ROWS)])
+    {
+        Ok(statement) => match statement.all().await.and_then(|result| result.results()) {
+            Ok(rows) => rows,
+            Err(err) => {
+                console_error!("download compaction: shard page read failed: {err}");
+                return;
+            }
+        },
+        Err(err) => {
+            console_error!("download compaction: shard page failed to bind: {err}");
+            return;
+        }
+    };
+    let rows: Vec<telemetry::ShardRow> = rows
+        .into_iter()
+        .map(|row| telemetry::ShardRow {
+            scope: row.scope,
+            name: row.name,
+            version: row.version,
+            shard: row.shard,
+            count: row.count,
+        })
+        .collect();
+    let plan = telemetry::plan_compaction(&rows);
+    if plan.is_empty() {
+        return;
+    }
+    let statements = match compaction_batch(db, &plan) {
+        Ok(statements) => statements,
+        Err(err) => {
+            console_error!("download compaction: batch failed to bind: {err}");
+            return;
+        }
+    };
+    if let Err(err) = db.batch(statements).await {
+        console_error!(
+            "download compaction of {} shard rows failed: {err}",
+            plan.debits.len()
+        );
+    }
+}
+
+/// The compaction batch for one plan: every credit, then each shard's
+/// debit followed by its drained-row delete.
+fn compaction_batch(
+    db: &D1Database,
+    plan: &telemetry::Compaction,
+) -> worker::Result<Vec<worker::D1PreparedStatement>> {
+    use worker::wasm_bindgen::JsValue;
+    let mut statements = Vec::with_capacity(plan.credits.len() + 2 * plan.debits.len());
+    for credit in &plan.credits {
+        statements.push(db.prepare(sql::CREDIT_VERSION_DOWNLOADS).bind(&[
+            credit.scope.as_str().into(),
+            credit.name.as_str().into(),
+            credit.version.as_str().into(),
+            js_int(credit.count),
+        ])?);
+    }
+    for debit in &plan.debits {
+        let key: [JsValue; 4] = [
+            debit.scope.as_str().into(),
+            debit.name.as_str().into(),
+            debit.version.as_str().into(),
+            js_int(debit.shard),
+        ];
+        let mut debit_binds = key.to_vec();
+        debit_binds.push(js_int(debit.count));
+        statements.push(db.prepare(sql::DEBIT_DOWNLOAD_SHARD).bind(&debit_binds)?);
+        statements.push(db.prepare(sql::DELETE_DRAINED_DOWNLOAD_SHARD).bind(&key)?);
+    }
+    Ok(statements)
+}
+
 /// Reads `meta.registry_generation`; best-effort (the header is a debug
 /// aid, not part of the client contract).
 async fn registry_generation(db: &D1Database) -> Option<String> {
@@ -2370,7 +2484,8 @@ const BREAKER_CRON: &str = "*/15 * * * *";
 /// budgets, persist the resulting service mode - failed analytics
 /// queries leave their metric unset, which can escalate but never
 /// unblock writes, [`breaker::next_mode`]), then the governor
-/// reconciliation pass and a backup-queue drain. Any other trigger -
+/// reconciliation pass, a download-shard compaction page, and a
+/// backup-queue drain. Any other trigger -
 /// the nightly `0 3 * * *`, or a temporary schedule added for an ops
 /// rehearsal - runs the D1 dump job, so exercising the backup path
 /// never needs a recompile.
@@ -2381,7 +2496,10 @@ pub async fn scheduled(event: ScheduledEvent, env: Env, _ctx: ScheduleContext) {
             console_error!("budget evaluation failed; keeping the last service mode: {err}");
         }
         match env.d1("DB") {
-            Ok(db) => reconcile_governor(&env, &db).await,
+            Ok(db) => {
+                reconcile_governor(&env, &db).await;
+                compact_download_shards(&env, &db).await;
+            }
             Err(err) => console_error!("governor reconciliation: no DB binding: {err}"),
         }
         crate::backup_glue::drain_backup_queue(&env).await;
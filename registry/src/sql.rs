@@ -285,7 +285,10 @@ statements! {
     /// the verified corpus per call - accepted at current scale; the
     /// breaker's `d1_rows_read_day` budget is the tripwire.
     SEARCH_VERIFIED_VERSIONS =
-        "SELECT scope, name, version, yanked, published_at, downloads \
+        "SELECT scope, name, version, yanked, published_at, \
+         downloads + (SELECT COALESCE(SUM(d.count), 0) FROM download_shards d \
+          WHERE d.scope = versions.scope AND d.name = versions.name \
+          AND d.version = versions.version) AS downloads \
          FROM versions WHERE verification = 'verified' \
          AND instr(scope || '/' || name, ?1) > 0";
 
@@ -294,7 +297,10 @@ statements! {
     /// Verified-only like [`VERIFIED_VERSIONS_BY_PACKAGE`], so a
     /// package with none is a missing package by construction.
     VERIFIED_VERSION_DETAILS =
-        "SELECT version, metadata_json, yanked, published_at, downloads \
+        "SELECT version, metadata_json, yanked, published_at, \
+         downloads + (SELECT COALESCE(SUM(d.count), 0) FROM download_shards d \
+          WHERE d.scope = versions.scope AND d.name = versions.name \
+          AND d.version = versions.version) AS downloads \
          FROM versions WHERE scope = ?1 AND name = ?2 AND verification = 'verified'";
 
     /// Whether the package is visible at all (>= 1 verified version):
@@ -325,7 +331,9 @@ statements! {
     /// download count (the dashboard's per-package figures).
     LIST_USER_PACKAGES =
         "SELECT v.scope, v.name, v.version, v.verification, v.yanked, v.published_at, \
-         v.downloads \
+         v.downloads + (SELECT COALESCE(SUM(d.count), 0) FROM download_shards d \
+          WHERE d.scope = v.scope AND d.name = v.name \
+          AND d.version = v.version) AS downloads \
          FROM packages p JOIN versions v ON v.scope = p.scope AND v.name = p.name \
          WHERE p.created_by = ?1 \
          ORDER BY v.scope, v.name, v.published_at DESC, v.version";
@@ -538,27 +546,61 @@ statements! {
          AND verification = 'verified'";
 
     /// The public stats totals: verified packages, verified versions,
-    /// and served downloads. `scope || '/' || name` is unambiguous -
-    /// `/` is in neither grammar - and a registry with no verified
-    /// versions answers all zeros.
+    /// and served downloads - each version's compacted base plus its
+    /// shard rows, like every download read. `scope || '/' || name` is
+    /// unambiguous - `/` is in neither grammar - and a registry with no
+    /// verified versions answers all zeros.
     REGISTRY_STATS =
         "SELECT COUNT(DISTINCT scope || '/' || name) AS packages, \
          COUNT(*) AS versions, \
-         COALESCE(SUM(downloads), 0) AS downloads \
+         COALESCE(SUM(downloads + \
+             (SELECT COALESCE(SUM(d.count), 0) FROM download_shards d \
+              WHERE d.scope = versions.scope AND d.name = versions.name \
+              AND d.version = versions.version)), 0) AS downloads \
          FROM versions WHERE verification = 'verified'";
 
     /// Applies one flush of the batched download telemetry
     /// (`src/telemetry.rs`): the buffered per-version count lands in
-    /// one statement per version instead of one write per download.
+    /// one statement per version instead of one write per download,
+    /// upserted onto shard `?4` (picked at random by the glue) so
+    /// concurrent flushes of one version spread over several rows.
     /// The `verification` guard keeps the counter honest inside the
     /// statement itself: only verified rows ever count, so the
     /// verifier's pending fetches (readable with the `verify` scope)
     /// and any racing lifecycle change can never increment. Yanked
     /// versions keep counting - they stay downloadable on purpose.
-    ADD_VERSION_DOWNLOADS =
+    ADD_SHARD_DOWNLOADS =
+        "INSERT INTO download_shards (scope, name, version, shard, count) \
+         SELECT ?1, ?2, ?3, ?4, ?5 WHERE EXISTS \
+         (SELECT 1 FROM versions WHERE scope = ?1 AND name = ?2 AND version = ?3 \
+          AND verification = 'verified') \
+         ON CONFLICT (scope, name, version, shard) \
+         DO UPDATE SET count = count + excluded.count";
+
+    /// The download compaction's page (`telemetry::plan_compaction`):
+    /// the first `?1` nonempty shard rows in key order. Compacted rows
+    /// are deleted, so the next pass starts where this one stopped.
+    DOWNLOAD_SHARD_PAGE =
+        "SELECT scope, name, version, shard, count FROM download_shards \
+         WHERE count > 0 ORDER BY scope, name, version, shard LIMIT ?1";
+
+    /// Folds compacted shard counts into a version's base column, in
+    /// the same batch as the matching [`DEBIT_DOWNLOAD_SHARD`]s.
+    CREDIT_VERSION_DOWNLOADS =
         "UPDATE versions SET downloads = downloads + ?4 \
-         WHERE scope = ?1 AND name = ?2 AND version = ?3 \
-         AND verification = 'verified'";
+         WHERE scope = ?1 AND name = ?2 AND version = ?3";
+
+    /// Subtracts exactly what the page read from one shard: a flush
+    /// that landed since keeps its increment on the row.
+    DEBIT_DOWNLOAD_SHARD =
+        "UPDATE download_shards SET count = count - ?5 \
+         WHERE scope = ?1 AND name = ?2 AND version = ?3 AND shard = ?4";
+
+    /// Deletes one shard the batch drained; a shard that gained counts
+    /// since the page read stays for the next pass.
+    DELETE_DRAINED_DOWNLOAD_SHARD =
+        "DELETE FROM download_shards \
+         WHERE scope = ?1 AND name = ?2 AND version = ?3 AND shard = ?4 AND count = 0";
 
     /// Live (non-rejected) references to one blob, for reclaim.
     COUNT_LIVE_BLOB_REFERENCES =
@@ -2,10 +2,17 @@
 //! "Download counts"): pure and host-testable. The wasm glue buffers
 //! per-version download counts in isolate memory and flushes them to D1
 //! in one batch when this policy says so, replacing the old
-//! one-D1-write-per-download pattern. Telemetry is approximate by
+//! one-D1-write-per-download pattern. Each flushed count lands on one
+//! of [`DOWNLOAD_SHARDS`] shard rows per version, picked at random, so
+//! isolates flushing the same popular version spread over several rows
+//! instead of serializing on one; reads sum the compacted base column
+//! and the shards, and the cron's compaction pass ([`plan_compaction`])
+//! folds shards back into the base. Telemetry is approximate by
 //! contract - an isolate that dies with a non-empty buffer loses those
 //! counts - and never part of the hard accounting ledger.
 
+use std::collections::BTreeMap;
+
 /// Flush once this many distinct versions have pending counts, so one
 /// D1 batch stays small.
 pub const FLUSH_MAX_PENDING: usize = 50;
@@ -23,10 +30,174 @@ pub fn should_flush(pending_versions: usize, elapsed_ms: f64, interval_ms: f64)
     pending_versions > 0 && (pending_versions >= FLUSH_MAX_PENDING || elapsed_ms >= interval_ms)
 }
 
+/// Shard rows per version. Small on purpose: every read sums them
+/// (until compaction folds them away), and a handful already spreads
+/// the write traffic of a version hot enough to be flushed by several
+/// isolates at once.
+pub const DOWNLOAD_SHARDS: i64 = 8;
+
+/// The shard a flushed count lands on, from a uniform draw in `[0, 1)`
+/// (the glue's `Math.random()`; the choice needs spread, not secrecy).
+/// Out-of-range draws clamp into range rather than naming a shard that
+/// does not exist.
+pub fn shard_for(unit: f64) -> i64 {
+    // The product is within [0, DOWNLOAD_SHARDS] after the clamp.
+    #[allow(clippy::cast_possible_truncation, clippy::cast_precision_loss)]
+    let shard = (unit.clamp(0.0, 1.0) * DOWNLOAD_SHARDS as f64) as i64;
+    shard.min(DOWNLOAD_SHARDS - 1)
+}
+
+/// Shard rows one compaction pass folds: one page per cron pass keeps
+/// the batch far below D1's per-invocation statement cap. Compaction is
+/// a read-cost optimization, not a correctness step - the shard table
+/// is bounded at [`DOWNLOAD_SHARDS`] rows per downloaded version with
+/// or without it - so a slow drain is harmless.
+pub const COMPACTION_PAGE_ROWS: i64 = 10;
+
+/// One `download_shards` row as the compaction page reads it.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ShardRow {
+    pub scope: String,
+    pub name: String,
+    pub version: String,
+    pub shard: i64,
+    pub count: i64,
+}
+
+/// Adds `count` to one version's compacted base column.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct VersionCredit {
+    pub scope: String,
+    pub name: String,
+    pub version: String,
+    pub count: i64,
+}
+
+/// Subtracts `count` - exactly what the page read - from one shard row.
+/// A subtraction, never a reset: a flush that lands between the page
+/// read and the compaction batch keeps its increment on the shard.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ShardDebit {
+    pub scope: String,
+    pub name: String,
+    pub version: String,
+    pub shard: i64,
+    pub count: i64,
+}
+
+/// One compaction batch: every debit's count is credited to its
+/// version exactly once, so the summed read (base plus shards) is the
+/// same before and after the batch commits.
+#[derive(Debug, Default, PartialEq, Eq)]
+pub struct Compaction {
+    pub credits: Vec<VersionCredit>,
+    pub debits: Vec<ShardDebit>,
+}
+
+impl Compaction {
+    pub fn is_empty(&self) -> bool {
+        self.debits.is_empty()
+    }
+}
+
+/// Plans one compaction batch from a page of shard rows: one debit per
+/// positive row and one credit per version, summed across its shards,
+/// in `(scope, name, version)` order. Rows with a zero or negative
+/// count (an already-drained shard, or corruption) are skipped - the
+/// batch never moves a count it cannot account for.
+pub fn plan_compaction(rows: &[ShardRow]) -> Compaction {
+    let mut totals: BTreeMap<(&str, &str, &str), i64> = BTreeMap::new();
+    let mut debits = Vec::new();
+    for row in rows.iter().filter(|row| row.count > 0) {
+        let total = totals
+            .entry((row.scope.as_str(), row.name.as_str(), row.version.as_str()))
+            .or_insert(0);
+        *total = total.saturating_add(row.count);
+        debits.push(ShardDebit {
+            scope: row.scope.clone(),
+            name: row.name.clone(),
+            version: row.version.clone(),
+            shard: row.shard,
+            count: row.count,
+        });
+    }
+    let credits = totals
+        .into_iter()
+        .map(|((scope, name, version), count)| VersionCredit {
+            scope: scope.to_owned(),
+            name: name.to_owned(),
+            version: version.to_owned(),
+            count,
+        })
+        .collect();
+    Compaction { credits, debits }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
 
+    fn row(scope: &str, version: &str, shard: i64, count: i64) -> ShardRow {
+        ShardRow {
+            scope: scope.to_owned(),
+            name: "pkg".to_owned(),
+            version: version.to_owned(),
+            shard,
+            count,
+        }
+    }
+
+    #[test]
+    fn shards_cover_the_range_and_clamp() {
+        assert_eq!(shard_for(0.0), 0);
+        assert_eq!(shard_for(0.999_999), DOWNLOAD_SHARDS - 1);
+        assert_eq!(shard_for(1.0), DOWNLOAD_SHARDS - 1);
+        assert_eq!(shard_for(-0.5), 0);
+        assert_eq!(shard_for(f64::NAN), 0);
+        let seen: std::collections::HashSet<i64> = (0..100)
+            .map(|step| shard_for(f64::from(step) / 100.0))
+            .collect();
+        assert_eq!(seen.len(), usize::try_from(DOWNLOAD_SHARDS).unwrap());
+    }
+
+    #[test]
+    fn compaction_sums_shards_per_version() {
+        let plan = plan_compaction(&[
+            row("beta", "1.0.0", 3, 4),
+            row("alpha", "1.0.0", 0, 2),
+            row("alpha", "1.0.0", 5, 3),
+            row("alpha", "2.0.0", 1, 1),
+        ]);
+        let credits: Vec<(&str, &str, i64)> = plan
+            .credits
+            .iter()
+            .map(|credit| (credit.scope.as_str(), credit.version.as_str(), credit.count))
+            .collect();
+        assert_eq!(
+            credits,
+            [
+                ("alpha", "1.0.0", 5),
+                ("alpha", "2.0.0", 1),
+                ("beta", "1.0.0", 4)
+            ]
+        );
+        assert_eq!(plan.debits.len(), 4);
+        let debited: i64 = plan.debits.iter().map(|debit| debit.count).sum();
+        let credited: i64 = plan.credits.iter().map(|credit| credit.count).sum();
+        assert_eq!(
+            debited, credited,
+            "compaction must not change the summed total"
+        );
+    }
+
+    #[test]
+    fn compaction_skips_drained_and_corrupt_rows() {
+        let plan = plan_compaction(&[row("alpha", "1.0.0", 0, 0), row("alpha", "1.0.0", 1, -2)]);
+        assert!(plan.is_empty());
+        assert!(plan.credits.is_empty());
+        assert!(plan_compaction(&[]).is_empty());
+    }
+
     #[test]
     fn empty_buffers_never_flush() {
         assert!(!should_flush(0, 0.0, FLUSH_INTERVAL_MS));
@@ -0,0 +1,1599 @@
+//! Host-side load harness for the registry's read and write planes:
+//! replays synthetic traffic - package resolves, artifact fetches,
+//! publishes, verifier passes, and source-viewer reads - against a
+//! local stand-in for the Cloudflare bindings and reports per-route
+//! latency percentiles and billed-operation counts, so a publish burst
+//! or a cold-cache download storm can be studied without a deploy.
+//!
+//! The stand-ins: D1 is `rusqlite` over the real migrated schema (the
+//! `tests/sql_validation.rs` recipe), R2 is a directory of blob files
+//! under cargo's per-crate `target/tmp`, the governor Durable Object is
+//! a second in-memory database driven through [`governor::decide`],
+//! and the edge cache is an in-memory map keyed by checksum. Each route
+//! replays the statement sequence of its `src/glue.rs` /
+//! `src/web_glue.rs` handler through the same `sql::` consts and the
+//! same pure modules (`documents`, `verify`, `quota`, `governor`,
+//! `source`, `telemetry`), so a statement that loses its index or a
+//! handler that grows a billable call moves the numbers here. Keep the
+//! sequences in step with the glue when a handler changes.
+//!
+//! What is billed and how it is counted:
+//!
+//! - D1 rows read: rows returned plus `SQLite`'s full-scan steps. A
+//!   lower bound on D1's rows-scanned metric, but one that jumps the
+//!   moment a point lookup degrades into a scan.
+//! - D1 rows written: changed rows per executed statement.
+//! - R2 Class A (puts) and Class B (gets, ranged gets, heads).
+//! - Governor decisions, and edge-cache hits (free by construction).
+//!
+//! `billed_operations_stay_within_budget` runs a small scenario on
+//! every `cargo test` and pins the per-route billing shape;
+//! `load_report` is the full-scale replay (thousands of requests) and
+//! prints the report:
+//!
+//! ```text
+//! cargo test --test load_harness -- --ignored --nocapture
+//! ```
+#![cfg(not(target_arch = "wasm32"))]
+
+use std::collections::{BTreeMap, HashMap, HashSet};
+use std::fs;
+use std::io::{Read, Seek, SeekFrom};
+use std::path::{Path, PathBuf};
+use std::time::{Duration, Instant};
+
+use cabin_registry_worker::auth::{self, AuthContext, Scope};
+use cabin_registry_worker::governor::{
+    self, Commit, Consume, Decision, Limits, OpPool, Refusal, Reserve, StoragePool, Store,
+};
+use cabin_registry_worker::{breaker, documents, quota, source, sql, telemetry, verify};
+use rusqlite::types::Value as SqlValue;
+use sha2::{Digest, Sha256};
+
+/// The synthetic clock's UTC day; runs must fit inside it.
+const BASE_DAY: &str = "2026-07-22";
+const DAY_MS: u32 = 86_400_000;
+
+/// The glue's isolate-memory service-mode TTL.
+const SERVICE_MODE_TTL_MS: u32 = 60_000;
+
+/// The source viewer's first read: the end-of-central-directory tail.
+const SOURCE_RANGE: &str = "bytes=-4096";
+
+// ---------------------------------------------------------------------
+// Billing meter
+// ---------------------------------------------------------------------
+
+/// Billed operations, accumulated registry-wide and diffed per request.
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+struct Ops {
+    d1_statements: u64,
+    d1_rows_read: u64,
+    d1_rows_written: u64,
+    r2_class_a: u64,
+    r2_class_b: u64,
+    governor_decisions: u64,
+    cache_hits: u64,
+}
+
+impl Ops {
+    fn since(self, earlier: Ops) -> Ops {
+        Ops {
+            d1_statements: self.d1_statements - earlier.d1_statements,
+            d1_rows_read: self.d1_rows_read - earlier.d1_rows_read,
+            d1_rows_written: self.d1_rows_written - earlier.d1_rows_written,
+            r2_class_a: self.r2_class_a - earlier.r2_class_a,
+            r2_class_b: self.r2_class_b - earlier.r2_class_b,
+            governor_decisions: self.governor_decisions - earlier.governor_decisions,
+            cache_hits: self.cache_hits - earlier.cache_hits,
+        }
+    }
+
+    fn accumulate(&mut self, other: Ops) {
+        self.d1_statements += other.d1_statements;
+        self.d1_rows_read += other.d1_rows_read;
+        self.d1_rows_written += other.d1_rows_written;
+        self.r2_class_a += other.r2_class_a;
+        self.r2_class_b += other.r2_class_b;
+        self.governor_decisions += other.governor_decisions;
+        self.cache_hits += other.cache_hits;
+    }
+}
+
+// ---------------------------------------------------------------------
+// D1 stand-in
+// ---------------------------------------------------------------------
+
+/// One result row, keyed by column name like D1's JSON rows.
+struct Row(Vec<(String, SqlValue)>);
+
+impl Row {
+    fn value(&self, column: &str) -> &SqlValue {
+        self.0
+            .iter()
+            .find(|(name, _)| name == column)
+            .map_or_else(|| panic!("no column {column}"), |(_, value)| value)
+    }
+
+    fn text(&self, column: &str) -> String {
+        match self.value(column) {
+            SqlValue::Text(text) => text.clone(),
+            other => panic!("column {column} is not text: {other:?}"),
+        }
+    }
+
+    fn opt_text(&self, column: &str) -> Option<String> {
+        match self.value(column) {
+            SqlValue::Null => None,
+            _ => Some(self.text(column)),
+        }
+    }
+
+    fn int(&self, column: &str) -> i64 {
+        match self.value(column) {
+            SqlValue::Integer(int) => *int,
+            other => panic!("column {column} is not an integer: {other:?}"),
+        }
+    }
+
+    #[allow(clippy::cast_precision_loss)] // bucket token counts are tiny
+    fn opt_real(&self, column: &str) -> Option<f64> {
+        match self.value(column) {
+            SqlValue::Real(real) => Some(*real),
+            SqlValue::Integer(int) => Some(*int as f64),
+            _ => None,
+        }
+    }
+}
+
+/// An in-memory database with every migration applied, oldest first,
+/// foreign keys enforced as on D1.
+fn migrated_connection() -> rusqlite::Connection {
+    let conn = rusqlite::Connection::open_in_memory().expect("open in-memory sqlite");
+    conn.pragma_update(None, "foreign_keys", true)
+        .expect("enable foreign_keys");
+    let dir = Path::new(env!("CARGO_MANIFEST_DIR")).join("migrations");
+    let mut migrations: Vec<_> = fs::read_dir(&dir)
+        .expect("read migrations/")
+        .map(|entry| entry.expect("read migrations/ entry").path())
+        .filter(|path| path.extension().is_some_and(|ext| ext == "sql"))
+        .collect();
+    migrations.sort();
+    for path in migrations {
+        let statements = fs::read_to_string(&path).expect("read migration");
+        conn.execute_batch(&statements)
+            .unwrap_or_else(|err| panic!("{} failed to apply: {err}", path.display()));
+    }
+    conn
+}
+
+/// Runs one query through the statement cache, metering returned rows
+/// plus full-scan steps.
+fn query(conn: &rusqlite::Connection, ops: &mut Ops, sql: &str, params: &[SqlValue]) -> Vec<Row> {
+    let mut statement = conn.prepare_cached(sql).expect("statement prepares");
+    let names: Vec<String> = statement
+        .column_names()
+        .into_iter()
+        .map(str::to_owned)
+        .collect();
+    let mut out = Vec::new();
+    {
+        let mut rows = statement
+            .query(rusqlite::params_from_iter(params))
+            .expect("query runs");
+        while let Some(row) = rows.next().expect("row steps") {
+            let values = names
+                .iter()
+                .enumerate()
+                .map(|(index, name)| (name.clone(), row.get(index).expect("column reads")))
+                .collect();
+            out.push(Row(values));
+        }
+    }
+    let scanned = statement.reset_status(rusqlite::StatementStatus::FullscanStep);
+    ops.d1_statements += 1;
+    ops.d1_rows_read += out.len() as u64 + u64::try_from(scanned).unwrap_or(0);
+    out
+}
+
+/// Executes one statement, metering its changed rows (and any scan it
+/// needed to find them).
+fn execute(conn: &rusqlite::Connection, ops: &mut Ops, sql: &str, params: &[SqlValue]) -> usize {
+    let mut statement = conn.prepare_cached(sql).expect("statement prepares");
+    let changed = statement
+        .execute(rusqlite::params_from_iter(params))
+        .expect("statement runs");
+    let scanned = statement.reset_status(rusqlite::StatementStatus::FullscanStep);
+    ops.d1_statements += 1;
+    ops.d1_rows_written += changed as u64;
+    ops.d1_rows_read += u64::try_from(scanned).unwrap_or(0);
+    changed
+}
+
+fn text(value: &str) -> SqlValue {
+    SqlValue::Text(value.to_owned())
+}
+
+// ---------------------------------------------------------------------
+// R2 and governor stand-ins
+// ---------------------------------------------------------------------
+
+/// R2 as a directory: one file per object key. Metering happens in the
+/// [`Registry`] wrappers, so seeding writes stay unbilled.
+struct Blobs {
+    root: PathBuf,
+}
+
+impl Blobs {
+    fn fresh(name: &str) -> Blobs {
+        let root = Path::new(env!("CARGO_TARGET_TMPDIR")).join(name);
+        let _ = fs::remove_dir_all(&root);
+        fs::create_dir_all(&root).expect("create the blob root");
+        Blobs { root }
+    }
+
+    fn put(&self, key: &str, bytes: &[u8]) {
+        let path = self.root.join(key);
+        fs::create_dir_all(path.parent().expect("keys have a parent"))
+            .expect("create the key's directory");
+        fs::write(path, bytes).expect("write the blob");
+    }
+
+    fn head(&self, key: &str) -> Option<u64> {
+        fs::metadata(self.root.join(key))
+            .ok()
+            .map(|meta| meta.len())
+    }
+
+    fn get(&self, key: &str) -> Option<Vec<u8>> {
+        fs::read(self.root.join(key)).ok()
+    }
+
+    fn get_range(&self, key: &str, offset: u64, length: u64) -> Option<Vec<u8>> {
+        let mut file = fs::File::open(self.root.join(key)).ok()?;
+        file.seek(SeekFrom::Start(offset)).ok()?;
+        let mut bytes = Vec::new();
+        file.take(length).read_to_end(&mut bytes).ok()?;
+        Some(bytes)
+    }
+}
+
+/// The governor Durable Object's `SQLite`, as the engine's host tests
+/// drive it.
+struct DurableObject(rusqlite::Connection);
+
+impl DurableObject {
+    fn new() -> DurableObject {
+        let conn = rusqlite::Connection::open_in_memory().expect("in-memory sqlite");
+        for statement in governor::SCHEMA {
+            conn.execute(statement, []).expect("schema applies");
+        }
+        DurableObject(conn)
+    }
+}
+
+fn bindings(params: &[governor::Value]) -> Vec<SqlValue> {
+    params
+        .iter()
+        .map(|value| match value {
+            governor::Value::Text(text) => SqlValue::Text(text.clone()),
+            governor::Value::Int(int) => SqlValue::Integer(*int),
+        })
+        .collect()
+}
+
+impl Store for DurableObject {
+    fn exec(&mut self, sql: &str, params: &[governor::Value]) -> Result<usize, String> {
+        self.0
+            .prepare_cached(sql)
+            .and_then(|mut statement| {
+                statement.execute(rusqlite::params_from_iter(bindings(params)))
+            })
+            .map_err(|err| err.to_string())
+    }
+
+    fn rows(
+        &mut self,
+        sql: &str,
+        params: &[governor::Value],
+    ) -> Result<Vec<serde_json::Value>, String> {
+        let mut unmetered = Ops::default();
+        Ok(query(&self.0, &mut unmetered, sql, &bindings(params))
+            .into_iter()
+            .map(|row| {
+                serde_json::Value::Object(
+                    row.0
+                        .into_iter()
+                        .map(|(name, value)| {
+                            let json = match value {
+                                SqlValue::Integer(int) => serde_json::json!(int),
+                                SqlValue::Real(real) => serde_json::json!(real),
+                                SqlValue::Text(text) => serde_json::json!(text),
+                                _ => serde_json::Value::Null,
+                            };
+                            (name, json)
+                        })
+                        .collect(),
+                )
+            })
+            .collect())
+    }
+}
+
+// ---------------------------------------------------------------------
+// The registry under load
+// ---------------------------------------------------------------------
+
+/// Every stand-in binding plus the isolate-memory state the glue keeps
+/// across requests (service-mode cache, download buffer, edge cache).
+struct Registry {
+    db: rusqlite::Connection,
+    blobs: Blobs,
+    durable_object: DurableObject,
+    limits: Limits,
+    ops: Ops,
+    now_ms: u32,
+    edge_cache: HashMap<String, Vec<u8>>,
+    mode_cache: Option<(breaker::Mode, u32)>,
+    pending_downloads: HashMap<(String, String, String), u32>,
+    last_flush_ms: u32,
+    flush_due: bool,
+    download_flushes: u64,
+}
+
+/// The `429`/`503` split of a governor refusal.
+fn refusal_status(refusal: Option<&Refusal>) -> u16 {
+    match refusal {
+        Some(Refusal::PrincipalExhausted { .. }) => 429,
+        _ => breaker::OVER_BUDGET_STATUS,
+    }
+}
+
+fn consume_one(pool: OpPool) -> Decision {
+    Decision {
+        consume: vec![Consume {
+            pool,
+            n: 1,
+            principal: None,
+            principal_cap: None,
+        }],
+        ..Decision::default()
+    }
+}
+
+fn blob_key(checksum: &str) -> String {
+    format!("blobs/sha256/{checksum}")
+}
+
+impl Registry {
+    fn new(name: &str) -> Registry {
+        Registry {
+            db: migrated_connection(),
+            blobs: Blobs::fresh(name),
+            durable_object: DurableObject::new(),
+            limits: Limits::default(),
+            ops: Ops::default(),
+            now_ms: 0,
+            edge_cache: HashMap::new(),
+            mode_cache: None,
+            pending_downloads: HashMap::new(),
+            last_flush_ms: 0,
+            flush_due: false,
+            download_flushes: 0,
+        }
+    }
+
+    fn now_iso(&self) -> String {
+        assert!(
+            self.now_ms < DAY_MS,
+            "the synthetic clock ran past one UTC day"
+        );
+        let ms = self.now_ms;
+        format!(
+            "{BASE_DAY}T{:02}:{:02}:{:02}.{:03}Z",
+            ms / 3_600_000,
+            ms / 60_000 % 60,
+            ms / 1000 % 60,
+            ms % 1000
+        )
+    }
+
+    fn query(&mut self, sql: &str, params: &[SqlValue]) -> Vec<Row> {
+        query(&self.db, &mut self.ops, sql, params)
+    }
+
+    fn first(&mut self, sql: &str, params: &[SqlValue]) -> Option<Row> {
+        self.query(sql, params).into_iter().next()
+    }
+
+    fn execute(&mut self, sql: &str, params: &[SqlValue]) -> usize {
+        execute(&self.db, &mut self.ops, sql, params)
+    }
+
+    /// A D1 batch: one transaction, changed rows per statement.
+    fn batch(&mut self, statements: &[(&str, Vec<SqlValue>)]) -> Vec<usize> {
+        let tx = self.db.unchecked_transaction().expect("begin the batch");
+        let changed = statements
+            .iter()
+            .map(|(sql, params)| execute(&tx, &mut self.ops, sql, params))
+            .collect();
+        tx.commit().expect("commit the batch");
+        changed
+    }
+
+    fn decide(&mut self, decision: &Decision) -> Result<(), Option<Refusal>> {
+        self.ops.governor_decisions += 1;
+        let now = self.now_iso();
+        match governor::decide(&mut self.durable_object, &self.limits, &now, decision) {
+            Ok(outcome) if outcome.ok => Ok(()),
+            Ok(outcome) => Err(outcome.refusal),
+            Err(_) => Err(None),
+        }
+    }
+
+    fn r2_put(&mut self, key: &str, bytes: &[u8]) {
+        self.ops.r2_class_a += 1;
+        self.blobs.put(key, bytes);
+    }
+
+    fn r2_head(&mut self, key: &str) -> Option<u64> {
+        self.ops.r2_class_b += 1;
+        self.blobs.head(key)
+    }
+
+    fn r2_get(&mut self, key: &str) -> Option<Vec<u8>> {
+        self.ops.r2_class_b += 1;
+        self.blobs.get(key)
+    }
+
+    fn r2_get_range(&mut self, key: &str, offset: u64, length: u64) -> Option<Vec<u8>> {
+        self.ops.r2_class_b += 1;
+        self.blobs.get_range(key, offset, length)
+    }
+
+    // -- shared request plumbing ------------------------------------
+
+    /// `glue::authenticate`: the token lookup plus the best-effort
+    /// `last_used_at` touch.
+    fn authenticate(&mut self, token: &str) -> Option<AuthContext> {
+        let row = self.first(sql::AUTH_TOKEN_LOOKUP, &[text(&auth::token_hash(token))])?;
+        let token_id = row.text("id");
+        let now = self.now_iso();
+        self.execute(sql::TOUCH_TOKEN_LAST_USED, &[text(&now), text(&token_id)]);
+        Some(AuthContext {
+            user_id: row.int("user_id"),
+            scopes: auth::parse_scopes(&row.text("scopes")),
+            quota_class: row.text("quota_class"),
+            bucket: bucket_from_row(&row),
+            token_id,
+        })
+    }
+
+    /// `glue::service_mode`: the isolate-memory cache over one `meta`
+    /// point read.
+    fn service_mode(&mut self) -> breaker::Mode {
+        if let Some((mode, expires_at)) = self.mode_cache
+            && self.now_ms < expires_at
+        {
+            return mode;
+        }
+        let mode = self
+            .first(sql::META_VALUE, &[text("service_mode")])
+            .and_then(|row| breaker::Mode::parse(&row.text("value")))
+            .unwrap_or(breaker::Mode::WritesBlocked);
+        self.mode_cache = Some((mode, self.now_ms + SERVICE_MODE_TTL_MS));
+        mode
+    }
+
+    /// The generation debug header every authenticated response carries.
+    fn stamp_generation(&mut self) {
+        self.first(sql::REGISTRY_GENERATION, &[]);
+    }
+
+    // -- routes -----------------------------------------------------
+
+    /// `GET /packages/<scope>/<name>.json`.
+    fn resolve(&mut self, token: &str, scope: &str, name: &str) -> u16 {
+        let Some(_auth) = self.authenticate(token) else {
+            return 401;
+        };
+        let status = if breaker::read_gate_refuses(Some(self.service_mode()), false) {
+            breaker::OVER_BUDGET_STATUS
+        } else {
+            let rows: Vec<documents::VersionRow> = self
+                .query(
+                    sql::VERIFIED_VERSIONS_BY_PACKAGE,
+                    &[text(scope), text(name)],
+                )
+                .into_iter()
+                .map(|row| documents::VersionRow {
+                    version: row.text("version"),
+                    metadata_json: row.text("metadata_json"),
+                    yanked: row.int("yanked") != 0,
+                })
+                .collect();
+            if rows.is_empty() {
+                404
+            } else {
+                documents::package_json(&format!("{scope}/{name}"), &rows)
+                    .expect("stored metadata composes");
+                200
+            }
+        };
+        self.stamp_generation();
+        status
+    }
+
+    /// `GET /artifacts/<scope>/<name>/<version>/...`.
+    fn artifact(&mut self, token: &str, scope: &str, name: &str, version: &str) -> u16 {
+        let Some(auth) = self.authenticate(token) else {
+            return 401;
+        };
+        let verify_exempt = auth.scopes.contains(&Scope::Verify);
+        let status = if breaker::read_gate_refuses(Some(self.service_mode()), verify_exempt) {
+            breaker::OVER_BUDGET_STATUS
+        } else {
+            self.artifact_body(&auth, scope, name, version)
+        };
+        self.stamp_generation();
+        status
+    }
+
+    fn artifact_body(&mut self, auth: &AuthContext, scope: &str, name: &str, version: &str) -> u16 {
+        let Some(row) = self.first(
+            sql::ARTIFACT_BY_PACKAGE_VERSION,
+            &[text(scope), text(name), text(version)],
+        ) else {
+            return 404;
+        };
+        let checksum = row.text("checksum");
+        let status = verify::Status::parse(&row.text("verification"));
+        let has_verify_scope = auth.scopes.contains(&Scope::Verify);
+        if !status.is_some_and(|status| verify::artifact_readable(status, has_verify_scope)) {
+            return 404;
+        }
+        let key = blob_key(&checksum);
+        if status == Some(verify::Status::Verified) {
+            if self.edge_cache.contains_key(&checksum) {
+                self.ops.cache_hits += 1;
+            } else {
+                let quotas = quota::quotas_for_class(&auth.quota_class);
+                let decision = Decision {
+                    consume: vec![Consume {
+                        pool: OpPool::BOrdinary,
+                        n: 1,
+                        principal: Some(auth.user_id.to_string()),
+                        principal_cap: Some(quotas.artifact_reads_per_day),
+                    }],
+                    ..Decision::default()
+                };
+                if let Err(refusal) = self.decide(&decision) {
+                    return refusal_status(refusal.as_ref());
+                }
+                let Some(bytes) = self.r2_get(&key) else {
+                    return 500;
+                };
+                self.edge_cache.insert(checksum, bytes);
+            }
+            self.count_download(scope, name, version);
+            return 200;
+        }
+        // The verifier's pending fetch: never cached, its own pool.
+        if let Err(refusal) = self.decide(&consume_one(OpPool::BVerifier)) {
+            return refusal_status(refusal.as_ref());
+        }
+        if self.r2_get(&key).is_none() {
+            return 500;
+        }
+        200
+    }
+
+    /// `glue::count_download`: buffer, and mark a flush due under the
+    /// telemetry policy. The flush itself runs after the response
+    /// ([`Registry::run_deferred`]), like the glue's `wait_until`.
+    fn count_download(&mut self, scope: &str, name: &str, version: &str) {
+        *self
+            .pending_downloads
+            .entry((scope.to_owned(), name.to_owned(), version.to_owned()))
+            .or_insert(0) += 1;
+        if telemetry::should_flush(
+            self.pending_downloads.len(),
+            f64::from(self.now_ms - self.last_flush_ms),
+            telemetry::FLUSH_INTERVAL_MS,
+        ) {
+            self.last_flush_ms = self.now_ms;
+            self.flush_due = true;
+        }
+    }
+
+    /// Off-response-path work: the download-count flush.
+    fn run_deferred(&mut self) {
+        if std::mem::take(&mut self.flush_due) {
+            self.flush_downloads();
+        }
+    }
+
+    fn flush_downloads(&mut self) {
+        if self.service_mode() >= breaker::Mode::WritesBlocked {
+            return;
+        }
+        // The glue draws the shard at random per isolate flush; rotating
+        // keeps the replay deterministic while still spreading rows.
+        let shard = i64::try_from(self.download_flushes).unwrap() % telemetry::DOWNLOAD_SHARDS;
+        let statements: Vec<(&str, Vec<SqlValue>)> = self
+            .pending_downloads
+            .drain()
+            .map(|((scope, name, version), count)| {
+                (
+                    sql::ADD_SHARD_DOWNLOADS,
+                    vec![
+                        SqlValue::Text(scope),
+                        SqlValue::Text(name),
+                        SqlValue::Text(version),
+                        SqlValue::Integer(shard),
+                        SqlValue::Integer(i64::from(count)),
+                    ],
+                )
+            })
+            .collect();
+        if !statements.is_empty() {
+            self.download_flushes += 1;
+            self.batch(&statements);
+        }
+    }
+
+    /// `glue::compact_download_shards`: one cron page folded into the
+    /// base column.
+    fn compact_downloads(&mut self) {
+        if self.service_mode() >= breaker::Mode::WritesBlocked {
+            return;
+        }
+        let page: Vec<telemetry::ShardRow> = self
+            .query(
+                sql::DOWNLOAD_SHARD_PAGE,
+                &[SqlValue::Integer(telemetry::COMPACTION_PAGE_ROWS)],
+            )
+            .into_iter()
+            .map(|row| telemetry::ShardRow {
+                scope: row.text("scope"),
+                name: row.text("name"),
+                version: row.text("version"),
+                shard: row.int("shard"),
+                count: row.int("count"),
+            })
+            .collect();
+        let plan = telemetry::plan_compaction(&page);
+        let mut statements: Vec<(&str, Vec<SqlValue>)> = plan
+            .credits
+            .iter()
+            .map(|credit| {
+                (
+                    sql::CREDIT_VERSION_DOWNLOADS,
+                    vec![
+                        text(&credit.scope),
+                        text(&credit.name),
+                        text(&credit.version),
+                        SqlValue::Integer(credit.count),
+                    ],
+                )
+            })
+            .collect();
+        for debit in &plan.debits {
+            let key = vec![
+                text(&debit.scope),
+                text(&debit.name),
+                text(&debit.version),
+                SqlValue::Integer(debit.shard),
+            ];
+            let mut debit_binds = key.clone();
+            debit_binds.push(SqlValue::Integer(debit.count));
+            statements.push((sql::DEBIT_DOWNLOAD_SHARD, debit_binds));
+            statements.push((sql::DELETE_DRAINED_DOWNLOAD_SHARD, key));
+        }
+        if !statements.is_empty() {
+            self.batch(&statements);
+        }
+    }
+
+    /// `PUT /api/v1/packages/<scope>/<name>/<version>`, from the point
+    /// the body is buffered and validated (frame decoding and the zip
+    /// sanity check are pure CPU, covered by `tests/publish_validation.rs`).
+    fn publish(
+        &mut self,
+        token: &str,
+        scope: &str,
+        name: &str,
+        version: &str,
+        archive: &[u8],
+    ) -> u16 {
+        let Some(auth) = self.authenticate(token) else {
+            return 401;
+        };
+        let status = self.publish_body(&auth, scope, name, version, archive);
+        self.stamp_generation();
+        status
+    }
+
+    #[allow(clippy::too_many_lines)] // one handler's statement sequence, in order
+    fn publish_body(
+        &mut self,
+        auth: &AuthContext,
+        scope: &str,
+        name: &str,
+        version: &str,
+        archive: &[u8],
+    ) -> u16 {
+        if self.service_mode() >= breaker::Mode::WritesBlocked {
+            return breaker::OVER_BUDGET_STATUS;
+        }
+        if !auth.scopes.contains(&Scope::Publish) {
+            return 403;
+        }
+        let quotas = quota::quotas_for_class(&auth.quota_class);
+        if !self.take_publish_token(auth, &quotas) {
+            return 429;
+        }
+        let member = self
+            .first(
+                sql::SCOPE_MEMBERSHIP,
+                &[text(scope), SqlValue::Integer(auth.user_id)],
+            )
+            .is_some_and(|row| row.int("n") > 0);
+        if !member {
+            return 403;
+        }
+
+        let checksum = auth::hex(&Sha256::digest(archive));
+        let metadata = metadata_json(scope, name, version, &checksum);
+        if let Some(existing) = self.first(
+            sql::EXISTING_VERSION,
+            &[text(scope), text(name), text(version)],
+        ) {
+            return if existing.text("metadata_json") == metadata {
+                200
+            } else {
+                409
+            };
+        }
+        let archive_bytes = archive.len() as u64;
+        if quota::check_archive_size(archive_bytes, &quotas).is_err() {
+            return 413;
+        }
+        let now = self.now_iso();
+        let day_prefix = quota::utc_day_prefix(&now).expect("ISO clock").to_owned();
+        let user = SqlValue::Integer(auth.user_id);
+        let stored = self.first(sql::USER_STORED_BYTES, &[user.clone()]);
+        let packages = self.first(sql::USER_PACKAGE_COUNTS, &[user.clone(), text(&day_prefix)]);
+        let versions_today = self.first(
+            sql::COUNT_PACKAGE_VERSIONS_SINCE,
+            &[text(scope), text(name), text(&day_prefix)],
+        );
+        let exists = self.first(sql::PACKAGE_EXISTS, &[text(scope), text(name)]);
+        let twin = self.first(sql::TWIN_PACKAGE_EXISTS, &[text(scope), text(name)]);
+        let count = |row: Option<Row>, column: &str| {
+            row.map_or(0, |row| u64::try_from(row.int(column)).unwrap_or(0))
+        };
+        let packages = packages.expect("aggregate row");
+        let counts = quota::PublishCounts {
+            user_stored_bytes: count(stored, "stored_bytes"),
+            user_package_count: u64::try_from(packages.int("package_count")).unwrap_or(0),
+            user_new_packages_today: u64::try_from(packages.int("new_today")).unwrap_or(0),
+            package_versions_today: count(versions_today, "n"),
+            package_exists: count(exists, "n") > 0,
+        };
+        if !counts.package_exists && count(twin, "n") > 0 {
+            return 400;
+        }
+        if quota::check_publish(archive_bytes, &counts, &quotas).is_err() {
+            return 403;
+        }
+
+        // `glue::persist_new_version`.
+        let key = blob_key(&checksum);
+        if let Err(refusal) = self.decide(&consume_one(OpPool::BPublish)) {
+            return refusal_status(refusal.as_ref());
+        }
+        if self.r2_head(&key).is_none() {
+            let admit = Decision {
+                reserve: vec![Reserve {
+                    pool: StoragePool::Primary,
+                    key: key.clone(),
+                    bytes: archive_bytes,
+                }],
+                ..consume_one(OpPool::APublish)
+            };
+            if let Err(refusal) = self.decide(&admit) {
+                return refusal_status(refusal.as_ref());
+            }
+            self.r2_put(&key, archive);
+        }
+        let size = SqlValue::Integer(i64::try_from(archive_bytes).expect("small archive"));
+        let changed = self.batch(&[
+            (
+                sql::INSERT_PACKAGE,
+                vec![text(scope), text(name), text(&now), user.clone()],
+            ),
+            (
+                sql::INSERT_VERSION,
+                vec![
+                    text(scope),
+                    text(name),
+                    text(version),
+                    text(&checksum),
+                    text(&metadata),
+                    text(&now),
+                    size.clone(),
+                    user,
+                ],
+            ),
+            (
+                sql::COUNT_STORED_BYTES_ON_PUBLISH,
+                vec![
+                    text(&checksum),
+                    size.clone(),
+                    text(&checksum),
+                    size,
+                    text(scope),
+                    text(name),
+                    text(version),
+                ],
+            ),
+        ]);
+        if changed[1] == 0 {
+            return 400;
+        }
+        let settle = Decision {
+            commit: vec![Commit {
+                pool: StoragePool::Primary,
+                key: key.clone(),
+                bytes: archive_bytes,
+            }],
+            ..Decision::default()
+        };
+        let _ = self.decide(&settle);
+        // `glue::heal_blob_if_reclaimed`: one more governed head.
+        if self.decide(&consume_one(OpPool::BPublish)).is_ok() {
+            self.r2_head(&key);
+        }
+        201
+    }
+
+    /// `glue::publish_rate_limit`: the CAS'd token-bucket take.
+    fn take_publish_token(&mut self, auth: &AuthContext, quotas: &quota::ClassQuotas) -> bool {
+        #[allow(clippy::cast_possible_truncation, clippy::cast_sign_loss)] // small quota constant
+        let attempts = quotas.publish_burst.ceil() as usize + 1;
+        let mut bucket = auth.bucket;
+        for _ in 0..attempts {
+            let outcome = quota::take_publish_token(bucket, f64::from(self.now_ms), quotas);
+            if !outcome.allowed {
+                return false;
+            }
+            let (prev_tokens, prev_updated_at) = match bucket {
+                Some(prev) => (
+                    SqlValue::Real(prev.tokens),
+                    SqlValue::Text(prev.updated_at_ms.to_string()),
+                ),
+                None => (SqlValue::Null, SqlValue::Null),
+            };
+            let swapped = self.execute(
+                sql::CAS_TOKEN_BUCKET,
+                &[
+                    SqlValue::Real(outcome.bucket.tokens),
+                    SqlValue::Text(outcome.bucket.updated_at_ms.to_string()),
+                    text(&auth.token_id),
+                    prev_tokens,
+                    prev_updated_at,
+                ],
+            );
+            if swapped > 0 {
+                return true;
+            }
+            bucket = self
+                .first(sql::TOKEN_BUCKET, &[text(&auth.token_id)])
+                .and_then(|row| bucket_from_row(&row));
+        }
+        false
+    }
+
+    /// One verifier pass over the oldest pending version: the admin
+    /// listing, the pending-artifact fetch, and a `verified` verdict.
+    /// `204` when nothing is pending.
+    fn verify_next(&mut self, token: &str) -> u16 {
+        let Some(auth) = self.authenticate(token) else {
+            return 401;
+        };
+        if !auth.scopes.contains(&Scope::Verify) {
+            return 403;
+        }
+        let pending = self.query(
+            sql::VERSIONS_BY_VERIFICATION_STATUS,
+            &[text(verify::Status::Pending.as_str())],
+        );
+        self.stamp_generation();
+        let Some(next) = pending.into_iter().next() else {
+            return 204;
+        };
+        let (scope, name, version) = (next.text("scope"), next.text("name"), next.text("version"));
+        let fetched = self.artifact(token, &scope, &name, &version);
+        if fetched != 200 {
+            return fetched;
+        }
+
+        let Some(_auth) = self.authenticate(token) else {
+            return 401;
+        };
+        let status = self.apply_verified_verdict(&scope, &name, &version);
+        self.stamp_generation();
+        status
+    }
+
+    /// `glue::verdict_response` / `apply_verdict` for `verified`.
+    fn apply_verified_verdict(&mut self, scope: &str, name: &str, version: &str) -> u16 {
+        let Some(target) = self.first(
+            sql::VERDICT_TARGET,
+            &[text(scope), text(name), text(version)],
+        ) else {
+            return 404;
+        };
+        let current = verify::Status::parse(&target.text("verification")).expect("valid status");
+        match verify::transition(current, verify::Verdict::Verified) {
+            verify::Transition::Apply => {}
+            verify::Transition::NoOp => return 200,
+            verify::Transition::Conflict(_) => return 409,
+        }
+        let now = self.now_iso();
+        let checksum = target.text("checksum");
+        let published_at = target.text("published_at");
+        let changed = self.batch(&[
+            (
+                sql::MARK_VERSION_VERIFIED,
+                vec![
+                    text(&now),
+                    text(scope),
+                    text(name),
+                    text(version),
+                    text(&checksum),
+                    text(&published_at),
+                ],
+            ),
+            (
+                sql::ENQUEUE_VERIFIED_BACKUP,
+                vec![
+                    text(scope),
+                    text(name),
+                    text(version),
+                    text(&checksum),
+                    text(&published_at),
+                    text(&now),
+                ],
+            ),
+        ]);
+        if changed[0] == 0 { 409 } else { 200 }
+    }
+
+    /// `GET /api/v1/user/source/<scope>/<name>/<version>` on the website
+    /// origin: a session read, so the caller resolves by identity.
+    fn source(&mut self, account_id: &str, scope: &str, name: &str, version: &str) -> u16 {
+        let Some(user) = self.first(sql::USER_BY_IDENTITY, &[text("github"), text(account_id)])
+        else {
+            return 401;
+        };
+        let range = match source::parse_range(Some(SOURCE_RANGE)) {
+            Ok(range) => range,
+            Err(refusal) => return refusal.status,
+        };
+        let Some(row) = self.first(
+            sql::SOURCE_VERSION_LOOKUP,
+            &[text(scope), text(name), text(version)],
+        ) else {
+            return 404;
+        };
+        let size = u64::try_from(row.int("archive_size")).unwrap_or(0);
+        let Some(resolved) = source::resolve_range(range, size) else {
+            return 416;
+        };
+        let quotas = quota::quotas_for_class(&user.text("quota_class"));
+        let decision = Decision {
+            consume: vec![Consume {
+                pool: OpPool::BSource,
+                n: 1,
+                principal: Some(user.int("user_id").to_string()),
+                principal_cap: Some(quotas.source_reads_per_day),
+            }],
+            ..Decision::default()
+        };
+        if let Err(refusal) = self.decide(&decision) {
+            return refusal_status(refusal.as_ref());
+        }
+        let key = blob_key(&row.text("checksum"));
+        if self
+            .r2_get_range(&key, resolved.offset, resolved.length)
+            .is_none()
+        {
+            return 500;
+        }
+        206
+    }
+}
+
+/// `glue::bucket_from_columns`.
+fn bucket_from_row(row: &Row) -> Option<quota::Bucket> {
+    let tokens = row.opt_real("rl_tokens")?;
+    let updated_at_ms = row.opt_text("rl_updated_at")?.parse::<f64>().ok()?;
+    Some(quota::Bucket {
+        tokens,
+        updated_at_ms,
+    })
+}
+
+/// The canonical per-version entry a publish stores verbatim.
+fn metadata_json(scope: &str, name: &str, version: &str, checksum: &str) -> String {
+    serde_json::json!({
+        "schema": 1,
+        "name": format!("{scope}/{name}"),
+        "version": version,
+        "checksum": format!("sha256:{checksum}"),
+        "dependencies": {},
+    })
+    .to_string()
+}
+
+// ---------------------------------------------------------------------
+// Synthetic traffic
+// ---------------------------------------------------------------------
+
+/// xorshift64*: deterministic, dependency-free, good enough for traffic.
+struct Rng(u64);
+
+impl Rng {
+    fn next(&mut self) -> u64 {
+        self.0 ^= self.0 >> 12;
+        self.0 ^= self.0 << 25;
+        self.0 ^= self.0 >> 27;
+        self.0.wrapping_mul(0x2545_f491_4f6c_dd1d)
+    }
+
+    #[allow(clippy::cast_possible_truncation)] // the result is below `n`
+    fn below(&mut self, n: usize) -> usize {
+        (self.next() % n as u64) as usize
+    }
+
+    /// Popularity skew: low indices are hit far more often, the way a
+    /// few packages dominate real download traffic.
+    fn skewed(&mut self, n: usize) -> usize {
+        let ceiling = self.below(n) + 1;
+        self.below(ceiling)
+    }
+
+    fn bytes(&mut self, len: usize) -> Vec<u8> {
+        (0..len).map(|_| self.next().to_le_bytes()[0]).collect()
+    }
+}
+
+/// The shape of one replay. Seeded packages are all verified; every
+/// publisher owns one scope, readers hold read-only tokens plus a
+/// session identity, and one verifier drains what the burst publishes.
+#[derive(Debug, Clone, Copy)]
+struct Scenario {
+    scopes: usize,
+    packages_per_scope: usize,
+    versions_per_package: usize,
+    readers: usize,
+    resolves: usize,
+    artifact_fetches: usize,
+    publishes: usize,
+    verifier_passes: usize,
+    source_reads: usize,
+    /// Synthetic time between requests.
+    step_ms: u32,
+    /// Share of publishes that create a new package, in percent.
+    new_package_percent: usize,
+    seed: u64,
+}
+
+#[derive(Debug, Clone, Copy)]
+enum Request {
+    Resolve { reader: usize },
+    Artifact { reader: usize },
+    Publish { publisher: usize },
+    Verify,
+    Source { reader: usize },
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord)]
+enum Route {
+    Resolve,
+    Artifact,
+    Publish,
+    Verify,
+    Source,
+}
+
+impl Route {
+    fn as_str(self) -> &'static str {
+        match self {
+            Route::Resolve => "resolve",
+            Route::Artifact => "artifact",
+            Route::Publish => "publish",
+            Route::Verify => "verify",
+            Route::Source => "source",
+        }
+    }
+}
+
+fn scope_name(index: usize) -> String {
+    format!("load{index}")
+}
+
+fn seeded_package(index: usize) -> String {
+    format!("pkg{index}")
+}
+
+fn seeded_version(index: usize) -> String {
+    format!("1.{index}.0")
+}
+
+fn publisher_token(index: usize) -> String {
+    format!("load-publisher-{index}")
+}
+
+fn reader_token(index: usize) -> String {
+    format!("load-reader-{index}")
+}
+
+fn reader_account(index: usize) -> String {
+    (900_000 + index).to_string()
+}
+
+const VERIFIER_TOKEN: &str = "load-verifier";
+
+/// Seeds users, scopes, tokens, identities, and the verified corpus
+/// with its blobs. Unmetered: the meter starts at zero afterwards.
+fn seed(registry: &mut Registry, scenario: &Scenario, rng: &mut Rng) {
+    let now = registry.now_iso();
+    let conn = &registry.db;
+    let mut user_id = 0_i64;
+    let mut add_user = |token: &str, scopes: &str| {
+        user_id += 1;
+        conn.execute(
+            "INSERT INTO users (id, created_at) VALUES (?1, ?2)",
+            rusqlite::params![user_id, now],
+        )
+        .expect("seed user");
+        conn.execute(
+            "INSERT INTO tokens (id, user_id, name, token_hash, scopes, created_at) \
+             VALUES (?1, ?2, 'load', ?3, ?4, ?5)",
+            rusqlite::params![
+                format!("tok-{user_id}"),
+                user_id,
+                auth::token_hash(token),
+                scopes,
+                now
+            ],
+        )
+        .expect("seed token");
+        user_id
+    };
+
+    for scope_index in 0..scenario.scopes {
+        let user = add_user(&publisher_token(scope_index), "publish");
+        let scope = scope_name(scope_index);
+        conn.execute(
+            "INSERT INTO scopes (name, proof_provider, proof_account_id, claimed_at) \
+             VALUES (?1, 'github', ?2, ?3)",
+            rusqlite::params![scope, user.to_string(), now],
+        )
+        .expect("seed scope");
+        conn.execute(
+            "INSERT INTO scope_members (scope_name, user_id, role) VALUES (?1, ?2, 'owner')",
+            rusqlite::params![scope, user],
+        )
+        .expect("seed owner");
+        for package_index in 0..scenario.packages_per_scope {
+            let name = seeded_package(package_index);
+            conn.execute(
+                "INSERT INTO packages (scope, name, created_at, created_by) \
+                 VALUES (?1, ?2, '2026-01-01T00:00:00.000Z', ?3)",
+                rusqlite::params![scope, name, user],
+            )
+            .expect("seed package");
+            for version_index in 0..scenario.versions_per_package {
+                let version = seeded_version(version_index);
+                let len = 1024 + rng.below(7 * 1024);
+                let archive = rng.bytes(len);
+                let checksum = auth::hex(&Sha256::digest(&archive));
+                registry.blobs.put(&blob_key(&checksum), &archive);
+                conn.execute(
+                    "INSERT INTO versions (scope, name, version, checksum, metadata_json, \
+                     published_at, archive_size, published_by, verification, verified_at) \
+                     VALUES (?1, ?2, ?3, ?4, ?5, '2026-01-01T00:00:00.000Z', ?6, ?7, \
+                     'verified', '2026-01-01T00:00:00.000Z')",
+                    rusqlite::params![
+                        scope,
+                        name,
+                        version,
+                        checksum,
+                        metadata_json(&scope, &name, &version, &checksum),
+                        archive.len(),
+                        user
+                    ],
+                )
+                .expect("seed version");
+            }
+        }
+    }
+    for reader in 0..scenario.readers {
+        let user = add_user(&reader_token(reader), "");
+        conn.execute(
+            "INSERT INTO identities (provider, provider_account_id, login_snapshot, user_id) \
+             VALUES ('github', ?1, ?2, ?3)",
+            rusqlite::params![reader_account(reader), format!("reader{reader}"), user],
+        )
+        .expect("seed identity");
+    }
+    add_user(VERIFIER_TOKEN, "verify");
+}
+
+/// The shuffled request mix.
+fn traffic(scenario: &Scenario, rng: &mut Rng) -> Vec<Request> {
+    let mut requests = Vec::new();
+    for _ in 0..scenario.resolves {
+        requests.push(Request::Resolve {
+            reader: rng.below(scenario.readers),
+        });
+    }
+    for _ in 0..scenario.artifact_fetches {
+        requests.push(Request::Artifact {
+            reader: rng.below(scenario.readers),
+        });
+    }
+    for _ in 0..scenario.publishes {
+        requests.push(Request::Publish {
+            publisher: rng.below(scenario.scopes),
+        });
+    }
+    requests.extend(std::iter::repeat_n(
+        Request::Verify,
+        scenario.verifier_passes,
+    ));
+    for _ in 0..scenario.source_reads {
+        requests.push(Request::Source {
+            reader: rng.below(scenario.readers),
+        });
+    }
+    for index in (1..requests.len()).rev() {
+        requests.swap(index, rng.below(index + 1));
+    }
+    requests
+}
+
+// ---------------------------------------------------------------------
+// Replay and report
+// ---------------------------------------------------------------------
+
+#[derive(Debug, Default)]
+struct RouteStats {
+    latencies: Vec<Duration>,
+    statuses: BTreeMap<u16, u64>,
+    ops: Ops,
+}
+
+impl RouteStats {
+    fn requests(&self) -> u64 {
+        self.statuses.values().sum()
+    }
+
+    fn count(&self, status: u16) -> u64 {
+        self.statuses.get(&status).copied().unwrap_or(0)
+    }
+
+    /// Nearest-rank percentile.
+    fn percentile(&self, percent: usize) -> Duration {
+        let mut sorted = self.latencies.clone();
+        sorted.sort_unstable();
+        let rank = (percent * sorted.len()).div_ceil(100).max(1);
+        sorted.get(rank - 1).copied().unwrap_or_default()
+    }
+}
+
+#[derive(Debug)]
+struct Report {
+    routes: BTreeMap<Route, RouteStats>,
+    /// Distinct verified checksums the artifact route served.
+    distinct_artifacts: usize,
+    /// Download-count batches flushed, the final drain included.
+    download_flushes: u64,
+    /// Total downloads `REGISTRY_STATS` reports after the final flush.
+    counted_downloads: i64,
+    /// Synthetic time the replay spanned.
+    elapsed_ms: u64,
+}
+
+impl Report {
+    fn route(&self, route: Route) -> &RouteStats {
+        self.routes.get(&route).expect("route replayed")
+    }
+
+    fn render(&self) -> String {
+        let mut out = format!(
+            "{:<9} {:>6} {:>9} {:>9} {:>9} {:>9}  {:>7} {:>8} {:>8} {:>6} {:>6} {:>6} {:>6}  statuses\n",
+            "route",
+            "reqs",
+            "p50",
+            "p95",
+            "p99",
+            "max",
+            "d1 stmt",
+            "d1 read",
+            "d1 write",
+            "r2 A",
+            "r2 B",
+            "gov",
+            "cache",
+        );
+        for (route, stats) in &self.routes {
+            let statuses: Vec<String> = stats
+                .statuses
+                .iter()
+                .map(|(status, count)| format!("{status}x{count}"))
+                .collect();
+            out.push_str(&format!(
+                "{:<9} {:>6} {:>9.2?} {:>9.2?} {:>9.2?} {:>9.2?}  {:>7} {:>8} {:>8} {:>6} {:>6} {:>6} {:>6}  {}\n",
+                route.as_str(),
+                stats.requests(),
+                stats.percentile(50),
+                stats.percentile(95),
+                stats.percentile(99),
+                stats.percentile(100),
+                stats.ops.d1_statements,
+                stats.ops.d1_rows_read,
+                stats.ops.d1_rows_written,
+                stats.ops.r2_class_a,
+                stats.ops.r2_class_b,
+                stats.ops.governor_decisions,
+                stats.ops.cache_hits,
+                statuses.join(" "),
+            ));
+        }
+        out
+    }
+}
+
+#[allow(clippy::too_many_lines)]
+fn replay(name: &str, scenario: &Scenario) -> Report {
+    let mut rng = Rng(scenario.seed | 1);
+    let mut registry = Registry::new(name);
+    seed(&mut registry, scenario, &mut rng);
+    let requests = traffic(scenario, &mut rng);
+    let total_ms = u64::from(scenario.step_ms) * requests.len() as u64;
+    assert!(
+        total_ms < u64::from(DAY_MS),
+        "scenario must fit one UTC day"
+    );
+
+    // Next free minor per (scope, package) and next new-package index
+    // per publisher: every publish targets a genuinely new version.
+    let mut next_minor: HashMap<(usize, String), usize> = HashMap::new();
+    let mut next_new_package = vec![0_usize; scenario.scopes];
+    let mut served: HashSet<(usize, usize, usize)> = HashSet::new();
+    let mut routes: BTreeMap<Route, RouteStats> = BTreeMap::new();
+
+    for request in requests {
+        registry.now_ms += scenario.step_ms;
+        let before = registry.ops;
+        let start = Instant::now();
+        let (route, status) = match request {
+            Request::Resolve { reader } => {
+                let scope = scope_name(rng.skewed(scenario.scopes));
+                let name = seeded_package(rng.skewed(scenario.packages_per_scope));
+                let status = registry.resolve(&reader_token(reader), &scope, &name);
+                (Route::Resolve, status)
+            }
+            Request::Artifact { reader } => {
+                let target = (
+                    rng.skewed(scenario.scopes),
+                    rng.skewed(scenario.packages_per_scope),
+                    rng.below(scenario.versions_per_package),
+                );
+                let status = registry.artifact(
+                    &reader_token(reader),
+                    &scope_name(target.0),
+                    &seeded_package(target.1),
+                    &seeded_version(target.2),
+                );
+                if status == 200 {
+                    served.insert(target);
+                }
+                (Route::Artifact, status)
+            }
+            Request::Publish { publisher } => {
+                let name = if rng.below(100) < scenario.new_package_percent {
+                    next_new_package[publisher] += 1;
+                    format!("new{}", next_new_package[publisher])
+                } else {
+                    seeded_package(rng.skewed(scenario.packages_per_scope))
+                };
+                let minor = next_minor.entry((publisher, name.clone())).or_insert(
+                    if name.starts_with("new") {
+                        0
+                    } else {
+                        scenario.versions_per_package
+                    },
+                );
+                let version = seeded_version(*minor);
+                *minor += 1;
+                let len = 1024 + rng.below(7 * 1024);
+                let archive = rng.bytes(len);
+                let status = registry.publish(
+                    &publisher_token(publisher),
+                    &scope_name(publisher),
+                    &name,
+                    &version,
+                    &archive,
+                );
+                (Route::Publish, status)
+            }
+            Request::Verify => (Route::Verify, registry.verify_next(VERIFIER_TOKEN)),
+            Request::Source { reader } => {
+                let status = registry.source(
+                    &reader_account(reader),
+                    &scope_name(rng.skewed(scenario.scopes)),
+                    &seeded_package(rng.skewed(scenario.packages_per_scope)),
+                    &seeded_version(rng.below(scenario.versions_per_package)),
+                );
+                (Route::Source, status)
+            }
+        };
+        let elapsed = start.elapsed();
+        // Deferred work is billed to the request that triggered it but
+        // stays out of its latency, as `wait_until` keeps it off the
+        // response path.
+        registry.run_deferred();
+        let stats = routes.entry(route).or_default();
+        stats.latencies.push(elapsed);
+        *stats.statuses.entry(status).or_insert(0) += 1;
+        stats.ops.accumulate(registry.ops.since(before));
+    }
+
+    // Drain the download buffer (the glue would lose it with the
+    // isolate) so the counted total is checkable against what was served,
+    // then run one cron compaction: summed reads must not move.
+    registry.flush_downloads();
+    registry.compact_downloads();
+    let counted_downloads = query(&registry.db, &mut Ops::default(), sql::REGISTRY_STATS, &[])
+        .into_iter()
+        .next()
+        .expect("stats row")
+        .int("downloads");
+    Report {
+        routes,
+        distinct_artifacts: served.len(),
+        download_flushes: registry.download_flushes,
+        counted_downloads,
+        elapsed_ms: total_ms,
+    }
+}
+
+// ---------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------
+
+const SMALL: Scenario = Scenario {
+    scopes: 4,
+    packages_per_scope: 5,
+    versions_per_package: 6,
+    readers: 4,
+    resolves: 300,
+    artifact_fetches: 300,
+    publishes: 40,
+    verifier_passes: 40,
+    source_reads: 60,
+    step_ms: 100,
+    new_package_percent: 20,
+    seed: 0x0cab_1a0d,
+};
+
+/// Pins the billing shape of every route on a small replay. These are
+/// the numbers that move when a statement loses its index, a handler
+/// grows a billable call, or the edge cache or download batching stops
+/// doing its job; latency is reported, never asserted (CI timing noise).
+#[test]
+fn billed_operations_stay_within_budget() {
+    let report = replay("load-harness-small", &SMALL);
+    let versions_per_package = SMALL.versions_per_package as u64;
+
+    // Resolves: D1 only, point lookups - auth, touch, the document's
+    // rows, the generation stamp, and the odd mode refresh.
+    let resolve = report.route(Route::Resolve);
+    assert_eq!(resolve.count(200), resolve.requests());
+    assert_eq!(resolve.ops.r2_class_a + resolve.ops.r2_class_b, 0);
+    assert_eq!(resolve.ops.governor_decisions, 0);
+    assert!(resolve.ops.d1_statements <= 5 * resolve.requests());
+    assert!(
+        resolve.ops.d1_rows_read <= (versions_per_package + 5) * resolve.requests(),
+        "resolve rows read {} exceed the point-lookup budget",
+        resolve.ops.d1_rows_read
+    );
+
+    // Artifact fetches: one charged R2 read per distinct blob, every
+    // other verified fetch an edge-cache hit; download counts batched.
+    let artifact = report.route(Route::Artifact);
+    let served = artifact.count(200);
+    assert_eq!(served, artifact.requests());
+    assert_eq!(artifact.ops.r2_class_b, report.distinct_artifacts as u64);
+    assert_eq!(artifact.ops.governor_decisions, artifact.ops.r2_class_b);
+    assert_eq!(artifact.ops.cache_hits + artifact.ops.r2_class_b, served);
+    assert_eq!(artifact.ops.r2_class_a, 0);
+    // Every fetch touches its token row; the rest is download counting,
+    // flushed on the telemetry policy's size or time trigger only (plus
+    // the final drain), never once per download.
+    assert!(artifact.ops.d1_rows_written - artifact.requests() <= served);
+    #[allow(clippy::cast_possible_truncation, clippy::cast_sign_loss)] // a whole-second constant
+    let interval_ms = telemetry::FLUSH_INTERVAL_MS as u64;
+    let flush_budget =
+        report.elapsed_ms / interval_ms + served / telemetry::FLUSH_MAX_PENDING as u64 + 1;
+    assert!(
+        report.download_flushes <= flush_budget,
+        "{} download flushes for {served} downloads",
+        report.download_flushes
+    );
+    assert!(artifact.ops.d1_rows_read <= 8 * artifact.requests());
+    assert_eq!(report.counted_downloads, i64::try_from(served).unwrap());
+
+    // Publishes: at most one Class A put per accepted publish, and a
+    // refused publish (rate limit, quota) never reaches R2.
+    let publish = report.route(Route::Publish);
+    let accepted = publish.count(201);
+    assert!(
+        accepted > 0,
+        "the burst accepted nothing: {:?}",
+        publish.statuses
+    );
+    assert!(publish.count(429) > 0, "the burst never hit the rate limit");
+    assert!(publish.ops.r2_class_a <= accepted);
+    assert_eq!(publish.ops.r2_class_b, 2 * accepted);
+    assert!(publish.ops.governor_decisions <= 4 * accepted);
+
+    // Verifier passes: one pending fetch per verdict, from its own pool.
+    let verify = report.route(Route::Verify);
+    assert!(verify.count(200) <= accepted);
+    assert_eq!(verify.count(200) + verify.count(204), verify.requests());
+    assert_eq!(verify.ops.r2_class_b, verify.count(200));
+    assert_eq!(verify.ops.governor_decisions, verify.count(200));
+    assert_eq!(verify.ops.cache_hits, 0);
+
+    // Source reads: every one is a governed, uncached ranged read.
+    let source = report.route(Route::Source);
+    assert_eq!(source.count(206), source.requests());
+    assert_eq!(source.ops.r2_class_b, source.requests());
+    assert_eq!(source.ops.governor_decisions, source.requests());
+}
+
+/// The full-scale replay: a cold edge cache under thousands of skewed
+/// downloads and resolves, and a publish burst far past the token
+/// buckets. Prints the report; run it before deploying a handler or
+/// schema change and compare against the previous run.
+#[test]
+#[ignore = "full-scale replay; run with --ignored --nocapture"]
+fn load_report() {
+    let scenario = Scenario {
+        scopes: 20,
+        packages_per_scope: 25,
+        versions_per_package: 12,
+        readers: 16,
+        resolves: 5_000,
+        artifact_fetches: 5_000,
+        publishes: 1_000,
+        verifier_passes: 300,
+        source_reads: 1_000,
+        step_ms: 20,
+        new_package_percent: 20,
+        seed: 0x00c0_ffee,
+    };
+    let report = replay("load-harness-full", &scenario);
+    println!("{}", report.render());
+    assert_eq!(
+        report.counted_downloads,
+        i64::try_from(report.route(Route::Artifact).count(200)).unwrap()
+    );
+}
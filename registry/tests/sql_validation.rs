@@ -14,7 +14,7 @@
 use std::fs;
 use std::path::Path;
 
-use cabin_registry_worker::sql;
+use cabin_registry_worker::{sql, telemetry};
 
 /// Statements `rusqlite` cannot prepare because they need a D1-only
 /// construct. Deliberately empty - D1 speaks `SQLite`'s dialect for
@@ -594,6 +594,19 @@ fn scoped_statements_never_cross_scopes() {
     assert_eq!(stored, "10", "the right-scope refund fires exactly once");
 }
 
+/// A version's served downloads as every read computes them: the
+/// compacted base column plus its shard rows.
+fn summed_downloads(conn: &rusqlite::Connection, scope: &str) -> i64 {
+    conn.query_row(
+        "SELECT v.downloads + (SELECT COALESCE(SUM(d.count), 0) FROM download_shards d \
+         WHERE d.scope = v.scope AND d.name = v.name AND d.version = v.version) \
+         FROM versions v WHERE v.scope = ?1 AND v.name = 'pkg'",
+        [scope],
+        |row| row.get(0),
+    )
+    .expect("summed downloads")
+}
+
 /// The download counter's guard lives inside the statement: `prepare`
 /// cannot check that only verified rows count or that the increment
 /// stays within its scope, so both are executed here.
@@ -602,22 +615,15 @@ fn download_counting_is_verified_only_and_scope_isolated() {
     let conn = migrated_connection();
     seed_scope_collision(&conn);
 
-    let downloads = |scope: &str| -> i64 {
-        conn.query_row(
-            "SELECT downloads FROM versions WHERE scope = ?1 AND name = 'pkg'",
-            [scope],
-            |row| row.get(0),
-        )
-        .expect("downloads column")
-    };
+    let downloads = |scope: &str| summed_downloads(&conn, scope);
 
     // A batched flush of two downloads counts; the identical
     // (name, version) under the other scope - pending there - stays
     // untouched.
     let changed = conn
         .execute(
-            sql::ADD_VERSION_DOWNLOADS,
-            rusqlite::params!["alpha", "pkg", "1.0.0", 2],
+            sql::ADD_SHARD_DOWNLOADS,
+            rusqlite::params!["alpha", "pkg", "1.0.0", 0, 2],
         )
         .expect("add verified downloads");
     assert_eq!(changed, 1);
@@ -629,8 +635,8 @@ fn download_counting_is_verified_only_and_scope_isolated() {
     for (scope, name, version) in [("beta", "pkg", "1.0.0"), ("ghost", "pkg", "1.0.0")] {
         let changed = conn
             .execute(
-                sql::ADD_VERSION_DOWNLOADS,
-                rusqlite::params![scope, name, version, 1],
+                sql::ADD_SHARD_DOWNLOADS,
+                rusqlite::params![scope, name, version, 0, 1],
             )
             .expect("guarded increment");
         assert_eq!(changed, 0, "scope: {scope}");
@@ -644,13 +650,104 @@ fn download_counting_is_verified_only_and_scope_isolated() {
     )
     .expect("yank alpha");
     conn.execute(
-        sql::ADD_VERSION_DOWNLOADS,
-        rusqlite::params!["alpha", "pkg", "1.0.0", 1],
+        sql::ADD_SHARD_DOWNLOADS,
+        rusqlite::params!["alpha", "pkg", "1.0.0", 0, 1],
     )
     .expect("increment yanked download");
     assert_eq!(downloads("alpha"), 3);
 }
 
+/// Flushes spread over shard rows and the compaction batch folds them
+/// back into the base column without changing the summed total - even
+/// when a flush lands between the page read and the batch, which the
+/// debit (never a reset) must leave on its shard.
+#[test]
+fn download_shards_compact_without_changing_totals() {
+    let conn = migrated_connection();
+    seed_scope_collision(&conn);
+    for (shard, count) in [(0, 2), (3, 4), (3, 1), (7, 5)] {
+        conn.execute(
+            sql::ADD_SHARD_DOWNLOADS,
+            rusqlite::params!["alpha", "pkg", "1.0.0", shard, count],
+        )
+        .expect("add shard downloads");
+    }
+    let shard_rows = |conn: &rusqlite::Connection| -> i64 {
+        conn.query_row("SELECT COUNT(*) FROM download_shards", [], |row| row.get(0))
+            .expect("shard row count")
+    };
+    assert_eq!(shard_rows(&conn), 3, "upserts merge onto their shard");
+    assert_eq!(summed_downloads(&conn, "alpha"), 12);
+
+    let page: Vec<telemetry::ShardRow> = conn
+        .prepare(sql::DOWNLOAD_SHARD_PAGE)
+        .expect("prepare the page")
+        .query_map([telemetry::COMPACTION_PAGE_ROWS], |row| {
+            Ok(telemetry::ShardRow {
+                scope: row.get(0)?,
+                name: row.get(1)?,
+                version: row.get(2)?,
+                shard: row.get(3)?,
+                count: row.get(4)?,
+            })
+        })
+        .expect("read the page")
+        .collect::<Result<_, _>>()
+        .expect("page rows");
+    assert_eq!(page.len(), 3);
+    let plan = telemetry::plan_compaction(&page);
+
+    // A concurrent flush onto shard 3 after the page was read.
+    conn.execute(
+        sql::ADD_SHARD_DOWNLOADS,
+        rusqlite::params!["alpha", "pkg", "1.0.0", 3, 6],
+    )
+    .expect("racing flush");
+
+    let tx = conn.unchecked_transaction().expect("begin the batch");
+    for credit in &plan.credits {
+        tx.execute(
+            sql::CREDIT_VERSION_DOWNLOADS,
+            rusqlite::params![credit.scope, credit.name, credit.version, credit.count],
+        )
+        .expect("credit the base");
+    }
+    for debit in &plan.debits {
+        tx.execute(
+            sql::DEBIT_DOWNLOAD_SHARD,
+            rusqlite::params![
+                debit.scope,
+                debit.name,
+                debit.version,
+                debit.shard,
+                debit.count
+            ],
+        )
+        .expect("debit the shard");
+        tx.execute(
+            sql::DELETE_DRAINED_DOWNLOAD_SHARD,
+            rusqlite::params![debit.scope, debit.name, debit.version, debit.shard],
+        )
+        .expect("delete a drained shard");
+    }
+    tx.commit().expect("commit the batch");
+
+    assert_eq!(
+        summed_downloads(&conn, "alpha"),
+        18,
+        "12 compacted + 6 racing"
+    );
+    let base: i64 = conn
+        .query_row(
+            "SELECT downloads FROM versions WHERE scope = 'alpha' AND name = 'pkg'",
+            [],
+            |row| row.get(0),
+        )
+        .expect("base column");
+    assert_eq!(base, 12);
+    assert_eq!(shard_rows(&conn), 1, "only the raced shard survives");
+}
+
 /// Seeds one user plus the packages and versions the search and
 /// reverse-dependency statements walk: a target package with two
 /// verified versions, a pending-only lookalike, an underscore/plain
@@ -866,8 +963,8 @@ fn registry_stats_totals_are_verified_only_and_name_distinct() {
     )
     .expect("seed verified versions and a pending counter");
     conn.execute(
-        sql::ADD_VERSION_DOWNLOADS,
-        rusqlite::params!["alpha", "pkg", "1.0.0", 2],
+        sql::ADD_SHARD_DOWNLOADS,
+        rusqlite::params!["alpha", "pkg", "1.0.0", 5, 2],
     )
     .expect("add verified downloads");
 
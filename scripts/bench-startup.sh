@@ -0,0 +1,74 @@
+#!/usr/bin/env bash
+#
+# Startup-latency benchmark for the commands tooling invokes most often.
+# Builds the release binary, then times each command hyperfine-style:
+# warmup runs first, then timed runs, reporting mean ± stddev, min and max
+# wall time in milliseconds.
+#
+#   scripts/bench-startup.sh              10 runs per command after 3 warmups
+#   scripts/bench-startup.sh --runs 50    more runs for a tighter estimate
+#   CABIN=path/to/cabin scripts/bench-startup.sh   time an existing binary
+#
+# Config discovery is part of what is measured, so the developer's own
+# ~/.config/cabin is masked with an empty CABIN_CONFIG_HOME to keep runs
+# comparable across machines.
+
+set -euo pipefail
+
+cd "$(git -C "$(dirname -- "${BASH_SOURCE[0]}")" rev-parse --show-toplevel)"
+
+runs=10
+warmup=3
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    --runs) runs="$2"; shift 2 ;;
+    --warmup) warmup="$2"; shift 2 ;;
+    *) echo "usage: scripts/bench-startup.sh [--runs N] [--warmup N]" >&2; exit 2 ;;
+  esac
+done
+
+if [[ -z "${CABIN:-}" ]]; then
+  cargo build --release --quiet --bin cabin
+  CABIN="$PWD/target/release/cabin"
+fi
+
+config_home="$(mktemp -d)"
+trap 'rm -rf "$config_home"' EXIT
+export CABIN_CONFIG_HOME="$config_home"
+unset CABIN_CONFIG CABIN_NO_CONFIG CABIN_TERM_COLOR CABIN_TERM_VERBOSE CABIN_TERM_QUIET
+
+bench() {
+  local label="$1"
+  shift
+  local i start end
+  for ((i = 0; i < warmup; i++)); do
+    "$@" >/dev/null 2>&1 || { echo "$label: command failed: $*" >&2; exit 1; }
+  done
+  local samples=()
+  for ((i = 0; i < runs; i++)); do
+    # Bash's EPOCHREALTIME (5.0+) is the realtime clock in microseconds.
+    # Expanding it inline, not through a command substitution, keeps a
+    # subshell fork out of the timed region.
+    start="${EPOCHREALTIME/[.,]/}"
+    "$@" >/dev/null 2>&1
+    end="${EPOCHREALTIME/[.,]/}"
+    samples+=("$(((end - start) * 1000))")
+  done
+  printf '%s\n' "${samples[@]}" | awk -v label="$label" '
+    { x = $1 / 1e6; sum += x; sq += x * x; if (NR == 1 || x < min) min = x; if (x > max) max = x }
+    END {
+      mean = sum / NR
+      var = sq / NR - mean * mean
+      if (var < 0) var = 0
+      printf "%-28s %8.2f ms ± %6.2f   [min %7.2f, max %7.2f]  (%d runs)\n",
+        label, mean, sqrt(var), min, max, NR
+    }'
+}
+
+manifest="examples/hello-c/cabin.toml"
+echo "binary: $CABIN"
+bench "cabin --version" "$CABIN" --version
+bench "cabin version -v" "$CABIN" version -v
+bench "cabin --help" "$CABIN" --help
+bench "cabin metadata" "$CABIN" metadata --manifest-path "$manifest"
+bench "cabin compgen bash" "$CABIN" compgen bash